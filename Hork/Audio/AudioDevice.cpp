@@ -57,19 +57,19 @@ AudioDevice::AudioDevice()
     int numdrivers = SDL_GetNumAudioDrivers();
     if (numdrivers > 0)
     {
-        LOG("Available audio drivers:\n");
+        LOG(LogChannel::Audio, "Available audio drivers:\n");
         for (int i = 0; i < numdrivers; i++)
-            LOG("\t{}\n", SDL_GetAudioDriver(i));
+            LOG(LogChannel::Audio, "\t{}\n", SDL_GetAudioDriver(i));
     }
 
     int numdevs = 0;
     if (SDL_AudioDeviceID *devices = SDL_GetAudioPlaybackDevices(&numdevs))
     {
-        LOG("Available audio devices:\n");
+        LOG(LogChannel::Audio, "Available audio devices:\n");
         for (int i = 0; i < numdevs; ++i)
         {
             SDL_AudioDeviceID instanceID = devices[i];
-            LOG("\t{}\n", SDL_GetAudioDeviceName(instanceID));
+            LOG(LogChannel::Audio, "\t{}\n", SDL_GetAudioDeviceName(instanceID));
         }
         SDL_free(devices);
     }
@@ -133,7 +133,37 @@ AudioDevice::AudioDevice()
 
     m_SampleRate = spec.freq;
     m_Channels = spec.channels;
-    m_Samples = Math::ToGreaterPowerOfTwo(sampleFrames * spec.channels * 10);
+
+    CreateTransferBuffer(sampleFrames * 10);
+
+    SDL_ResumeAudioDevice(m_DeviceID);
+
+    const char* audioDriver = SDL_GetCurrentAudioDriver();
+    const char* audioDevice = SDL_GetAudioDeviceName(m_DeviceID);
+
+    LOG(LogChannel::Audio, "Initialized audio : {} Hz, {} samples, {} channels\n", m_SampleRate, sampleFrames, m_Channels);
+    LOG(LogChannel::Audio, "Using audio driver: {}\n", audioDriver ? audioDriver : "Unknown");
+    LOG(LogChannel::Audio, "Using playback device: {}\n", audioDevice ? audioDevice : "Unknown");
+    LOG(LogChannel::Audio, "Audio buffer size: {} bytes\n", m_TransferBufferSizeInBytes);
+}
+
+AudioDevice::AudioDevice(AudioOfflineDesc const& desc)
+{
+    m_AudioStream = nullptr;
+    m_DeviceID = 0;
+    m_TransferFormat = desc.Format;
+    m_SampleRate = desc.SampleRate;
+    m_Channels = Math::Clamp(desc.NumChannels, 1, 2);
+
+    CreateTransferBuffer(desc.BufferSizeInFrames);
+
+    LOG(LogChannel::Audio, "Initialized offline audio : {} Hz, {} channels\n", m_SampleRate, m_Channels);
+    LOG(LogChannel::Audio, "Audio buffer size: {} bytes\n", m_TransferBufferSizeInBytes);
+}
+
+void AudioDevice::CreateTransferBuffer(int sampleFrames)
+{
+    m_Samples = Math::ToGreaterPowerOfTwo(sampleFrames * m_Channels);
     m_NumFrames = m_Samples >> (m_Channels - 1);
     m_TransferBufferSizeInBytes = m_Samples * (m_TransferFormat == AudioTransferFormat::FLOAT32 ? sizeof(float) : sizeof(int16_t));
     m_TransferBuffer = (uint8_t*)Core::GetHeapAllocator<HEAP_AUDIO_DATA>().Alloc(m_TransferBufferSizeInBytes);
@@ -141,27 +171,24 @@ AudioDevice::AudioDevice()
     m_TransferOffset = 0;
     m_PrevTransferOffset = 0;
     m_BufferWraps = 0;
-
-    SDL_ResumeAudioDevice(m_DeviceID);
-
-    const char* audioDriver = SDL_GetCurrentAudioDriver();
-    const char* audioDevice = SDL_GetAudioDeviceName(m_DeviceID);
-
-    LOG("Initialized audio : {} Hz, {} samples, {} channels\n", m_SampleRate, sampleFrames, m_Channels);
-    LOG("Using audio driver: {}\n", audioDriver ? audioDriver : "Unknown");
-    LOG("Using playback device: {}\n", audioDevice ? audioDevice : "Unknown");
-    LOG("Audio buffer size: {} bytes\n", m_TransferBufferSizeInBytes);
 }
 
 AudioDevice::~AudioDevice()
 {
-    SDL_DestroyAudioStream((SDL_AudioStream*)m_AudioStream);
+    if (m_AudioStream)
+        SDL_DestroyAudioStream((SDL_AudioStream*)m_AudioStream);
 
     Core::GetHeapAllocator<HEAP_AUDIO_DATA>().Free(m_TransferBuffer);
 }
 
 void AudioDevice::SetMixerCallback(std::function<void(uint8_t* transferBuffer, int transferBufferSizeInFrames, int FrameNum, int MinFramesToRender)> MixerCallback)
 {
+    if (IsOffline())
+    {
+        m_MixerCallback = MixerCallback;
+        return;
+    }
+
     SDL_LockAudioStream((SDL_AudioStream*)m_AudioStream);
 
     m_MixerCallback = MixerCallback;
@@ -223,7 +250,8 @@ void AudioDevice::RenderAudio(uint8_t* stream, int streamLength)
 
 uint8_t* AudioDevice::MapTransferBuffer(int64_t* frameNum)
 {
-    SDL_LockAudioStream((SDL_AudioStream*)m_AudioStream);
+    if (m_AudioStream)
+        SDL_LockAudioStream((SDL_AudioStream*)m_AudioStream);
 
     if (frameNum)
     {
@@ -241,17 +269,20 @@ uint8_t* AudioDevice::MapTransferBuffer(int64_t* frameNum)
 
 void AudioDevice::UnmapTransferBuffer()
 {
-    SDL_UnlockAudioStream((SDL_AudioStream*)m_AudioStream);
+    if (m_AudioStream)
+        SDL_UnlockAudioStream((SDL_AudioStream*)m_AudioStream);
 }
 
 void AudioDevice::BlockSound()
 {
-    SDL_PauseAudioDevice(m_DeviceID);
+    if (m_DeviceID)
+        SDL_PauseAudioDevice(m_DeviceID);
 }
 
 void AudioDevice::UnblockSound()
 {
-    SDL_ResumeAudioDevice(m_DeviceID);
+    if (m_DeviceID)
+        SDL_ResumeAudioDevice(m_DeviceID);
 }
 
 void AudioDevice::ClearBuffer()
@@ -263,6 +294,9 @@ void AudioDevice::ClearBuffer()
 
 Ref<AudioStream> AudioDevice::CreateStream(AudioStreamDesc const& desc)
 {
+    if (IsOffline())
+        return {};
+
     const SDL_AudioSpec spec = {desc.Format == AudioTransferFormat::FLOAT32 ? SDL_AUDIO_F32 : SDL_AUDIO_S16, desc.NumChannels, desc.SampleRate};
     SDL_AudioStream *stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, NULL, NULL);
     if (!stream)
@@ -273,4 +307,24 @@ Ref<AudioStream> AudioDevice::CreateStream(AudioStreamDesc const& desc)
     return result;
 }
 
+void AudioDevice::RenderOffline(uint8_t* pFrames, int FrameCount)
+{
+    HK_ASSERT(IsOffline());
+
+    int frameSize = m_Channels * (m_TransferFormat == AudioTransferFormat::FLOAT32 ? sizeof(float) : sizeof(int16_t));
+
+    // Play no more than a half of the transfer buffer at once, so the mixer can render ahead
+    int maxFrames = m_NumFrames / 2;
+
+    while (FrameCount > 0)
+    {
+        int count = Math::Min(FrameCount, maxFrames);
+
+        RenderAudio(pFrames, count * frameSize);
+
+        pFrames += count * frameSize;
+        FrameCount -= count;
+    }
+}
+
 HK_NAMESPACE_END
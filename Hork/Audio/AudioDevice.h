@@ -49,12 +49,25 @@ struct AudioStreamDesc
     int                 SampleRate;
 };
 
+/// Offline device has no sound hardware. Its clock is advanced only by RenderOffline.
+struct AudioOfflineDesc
+{
+    AudioTransferFormat Format = AudioTransferFormat::FLOAT32;
+    int                 NumChannels = 2;
+    int                 SampleRate = 48000;
+    int                 BufferSizeInFrames = 8192;
+};
+
 class AudioDevice final : public RefCounted
 {
 public:
                         AudioDevice();
+                        AudioDevice(AudioOfflineDesc const& desc);
                         ~AudioDevice();
 
+    /// Device without sound hardware
+    bool                IsOffline() const { return m_AudioStream == nullptr; }
+
     /// Playback frequency
     int                 GetSampleRate() const { return m_SampleRate; }
 
@@ -91,7 +104,12 @@ public:
 
     Ref<AudioStream>    CreateStream(AudioStreamDesc const& desc);
 
+    /// Offline device only. Plays frames from the transfer buffer like the sound hardware would do and advances the clock.
+    /// The frames are copied to pFrames in transfer format. Mixer callback is called in async mode.
+    void                RenderOffline(uint8_t* pFrames, int FrameCount);
+
 private:
+    void                CreateTransferBuffer(int sampleFrames);
     void                RenderAudio(uint8_t* pStream, int StreamLength);
 
     // Internal audio stream
@@ -0,0 +1,299 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "AudioMix.h"
+
+#include <Hork/Core/BaseMath.h>
+#include <Hork/Core/Memory.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace AudioMix
+{
+
+namespace
+{
+    // Same scale as the integer samples had in the legacy mixer: 8-bit samples are expanded to 16 bits by multiplying by 255.
+    const float Int16ToFloat = 1.0f / 32767;
+    const float UInt8ToFloat = 255.0f / 32767;
+
+    HK_FORCEINLINE __m128i ExpandInt16(__m128i v, bool hi)
+    {
+        // Sign extend 16-bit words to 32 bits
+        return _mm_srai_epi32(hi ? _mm_unpackhi_epi16(v, v) : _mm_unpacklo_epi16(v, v), 16);
+    }
+
+    HK_FORCEINLINE float RampGain(Gain const& gain, int channel, int frame)
+    {
+        if (frame >= gain.RampFrames)
+            return gain.To[channel];
+        return gain.From[channel] + (gain.To[channel] - gain.From[channel]) * (frame + 1) / gain.RampFrames;
+    }
+
+    HK_FORCEINLINE __m128 Clamp(__m128 v)
+    {
+        return _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    }
+}
+
+void ConvertToF32(void const* inSamples, int sampleBits, int sampleCount, float* outSamples)
+{
+    int i = 0;
+
+    if (sampleBits == 8)
+    {
+        uint8_t const* samples = static_cast<uint8_t const*>(inSamples);
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi16(128);
+        const __m128 scale = _mm_set1_ps(UInt8ToFloat);
+
+        for (; i + 16 <= sampleCount; i += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(samples + i));
+            __m128i w0 = _mm_sub_epi16(_mm_unpacklo_epi8(v, zero), bias);
+            __m128i w1 = _mm_sub_epi16(_mm_unpackhi_epi8(v, zero), bias);
+
+            _mm_storeu_ps(outSamples + i, _mm_mul_ps(_mm_cvtepi32_ps(ExpandInt16(w0, false)), scale));
+            _mm_storeu_ps(outSamples + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(ExpandInt16(w0, true)), scale));
+            _mm_storeu_ps(outSamples + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(ExpandInt16(w1, false)), scale));
+            _mm_storeu_ps(outSamples + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(ExpandInt16(w1, true)), scale));
+        }
+
+        for (; i < sampleCount; i++)
+            outSamples[i] = (int(samples[i]) - 128) * UInt8ToFloat;
+        return;
+    }
+
+    if (sampleBits == 16)
+    {
+        int16_t const* samples = static_cast<int16_t const*>(inSamples);
+
+        const __m128 scale = _mm_set1_ps(Int16ToFloat);
+
+        for (; i + 8 <= sampleCount; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(samples + i));
+
+            _mm_storeu_ps(outSamples + i, _mm_mul_ps(_mm_cvtepi32_ps(ExpandInt16(v, false)), scale));
+            _mm_storeu_ps(outSamples + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(ExpandInt16(v, true)), scale));
+        }
+
+        for (; i < sampleCount; i++)
+            outSamples[i] = samples[i] * Int16ToFloat;
+        return;
+    }
+
+    HK_ASSERT(sampleBits == 32);
+    Core::Memcpy(outSamples, inSamples, sampleCount * sizeof(float));
+}
+
+void DownmixStereo(float const* inFrames, int frameCount, float* outFrames)
+{
+    int i = 0;
+
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for (; i + 4 <= frameCount; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(inFrames + i * 2);
+        __m128 b = _mm_loadu_ps(inFrames + i * 2 + 4);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+        _mm_storeu_ps(outFrames + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+
+    for (; i < frameCount; i++)
+        outFrames[i] = (inFrames[i * 2] + inFrames[i * 2 + 1]) * 0.5f;
+}
+
+void MixMono(float const* inFrames, int frameCount, Gain const& gain, float* bus)
+{
+    int i = 0;
+
+    // Ramped part, two frames per iteration
+    int rampFrames = Math::Min(gain.RampFrames, frameCount);
+    if (rampFrames > 0)
+    {
+        float deltaL = (gain.To[0] - gain.From[0]) / gain.RampFrames;
+        float deltaR = (gain.To[1] - gain.From[1]) / gain.RampFrames;
+
+        __m128 g = _mm_setr_ps(gain.From[0] + deltaL, gain.From[1] + deltaR, gain.From[0] + deltaL * 2, gain.From[1] + deltaR * 2);
+        __m128 step = _mm_setr_ps(deltaL * 2, deltaR * 2, deltaL * 2, deltaR * 2);
+
+        for (; i + 2 <= rampFrames; i += 2)
+        {
+            __m128 s = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<double const*>(inFrames + i)));
+            s = _mm_unpacklo_ps(s, s);
+
+            _mm_storeu_ps(bus + i * 2, _mm_add_ps(_mm_loadu_ps(bus + i * 2), _mm_mul_ps(s, g)));
+            g = _mm_add_ps(g, step);
+        }
+    }
+
+    for (; i < rampFrames; i++)
+    {
+        bus[i * 2] += inFrames[i] * RampGain(gain, 0, i);
+        bus[i * 2 + 1] += inFrames[i] * RampGain(gain, 1, i);
+    }
+
+    // Constant gain, four frames per iteration
+    const __m128 g = _mm_setr_ps(gain.To[0], gain.To[1], gain.To[0], gain.To[1]);
+
+    for (; i + 4 <= frameCount; i += 4)
+    {
+        __m128 s = _mm_loadu_ps(inFrames + i);
+        __m128 lo = _mm_unpacklo_ps(s, s);
+        __m128 hi = _mm_unpackhi_ps(s, s);
+
+        _mm_storeu_ps(bus + i * 2, _mm_add_ps(_mm_loadu_ps(bus + i * 2), _mm_mul_ps(lo, g)));
+        _mm_storeu_ps(bus + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(bus + i * 2 + 4), _mm_mul_ps(hi, g)));
+    }
+
+    for (; i < frameCount; i++)
+    {
+        bus[i * 2] += inFrames[i] * gain.To[0];
+        bus[i * 2 + 1] += inFrames[i] * gain.To[1];
+    }
+}
+
+void MixStereo(float const* inFrames, int frameCount, Gain const& gain, float* bus)
+{
+    int i = 0;
+
+    // Ramped part, two frames per iteration
+    int rampFrames = Math::Min(gain.RampFrames, frameCount);
+    if (rampFrames > 0)
+    {
+        float deltaL = (gain.To[0] - gain.From[0]) / gain.RampFrames;
+        float deltaR = (gain.To[1] - gain.From[1]) / gain.RampFrames;
+
+        __m128 g = _mm_setr_ps(gain.From[0] + deltaL, gain.From[1] + deltaR, gain.From[0] + deltaL * 2, gain.From[1] + deltaR * 2);
+        __m128 step = _mm_setr_ps(deltaL * 2, deltaR * 2, deltaL * 2, deltaR * 2);
+
+        for (; i + 2 <= rampFrames; i += 2)
+        {
+            _mm_storeu_ps(bus + i * 2, _mm_add_ps(_mm_loadu_ps(bus + i * 2), _mm_mul_ps(_mm_loadu_ps(inFrames + i * 2), g)));
+            g = _mm_add_ps(g, step);
+        }
+    }
+
+    for (; i < rampFrames; i++)
+    {
+        bus[i * 2] += inFrames[i * 2] * RampGain(gain, 0, i);
+        bus[i * 2 + 1] += inFrames[i * 2 + 1] * RampGain(gain, 1, i);
+    }
+
+    // Constant gain, four frames per iteration
+    const __m128 g = _mm_setr_ps(gain.To[0], gain.To[1], gain.To[0], gain.To[1]);
+
+    for (; i + 4 <= frameCount; i += 4)
+    {
+        _mm_storeu_ps(bus + i * 2, _mm_add_ps(_mm_loadu_ps(bus + i * 2), _mm_mul_ps(_mm_loadu_ps(inFrames + i * 2), g)));
+        _mm_storeu_ps(bus + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(bus + i * 2 + 4), _mm_mul_ps(_mm_loadu_ps(inFrames + i * 2 + 4), g)));
+    }
+
+    for (; i < frameCount; i++)
+    {
+        bus[i * 2] += inFrames[i * 2] * gain.To[0];
+        bus[i * 2 + 1] += inFrames[i * 2 + 1] * gain.To[1];
+    }
+}
+
+void WriteFloat32(float const* bus, int frameCount, int channels, float* outSamples)
+{
+    int i = 0;
+
+    if (channels == 1)
+    {
+        for (; i + 4 <= frameCount; i += 4)
+        {
+            __m128 a = _mm_loadu_ps(bus + i * 2);
+            __m128 b = _mm_loadu_ps(bus + i * 2 + 4);
+
+            _mm_storeu_ps(outSamples + i, Clamp(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))));
+        }
+
+        for (; i < frameCount; i++)
+            outSamples[i] = Math::Clamp(bus[i * 2], -1.0f, 1.0f);
+        return;
+    }
+
+    int sampleCount = frameCount * 2;
+    for (; i + 4 <= sampleCount; i += 4)
+        _mm_storeu_ps(outSamples + i, Clamp(_mm_loadu_ps(bus + i)));
+
+    for (; i < sampleCount; i++)
+        outSamples[i] = Math::Clamp(bus[i], -1.0f, 1.0f);
+}
+
+void WriteInt16(float const* bus, int frameCount, int channels, int16_t* outSamples)
+{
+    int i = 0;
+
+    const __m128 scale = _mm_set1_ps(32767.0f);
+
+    if (channels == 1)
+    {
+        for (; i + 8 <= frameCount; i += 8)
+        {
+            __m128 a = _mm_loadu_ps(bus + i * 2);
+            __m128 b = _mm_loadu_ps(bus + i * 2 + 4);
+            __m128 c = _mm_loadu_ps(bus + i * 2 + 8);
+            __m128 d = _mm_loadu_ps(bus + i * 2 + 12);
+
+            __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(Clamp(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), scale));
+            __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(Clamp(_mm_shuffle_ps(c, d, _MM_SHUFFLE(2, 0, 2, 0))), scale));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outSamples + i), _mm_packs_epi32(lo, hi));
+        }
+
+        for (; i < frameCount; i++)
+            outSamples[i] = int16_t(Math::Round(Math::Clamp(bus[i * 2], -1.0f, 1.0f) * 32767.0f));
+        return;
+    }
+
+    int sampleCount = frameCount * 2;
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(Clamp(_mm_loadu_ps(bus + i)), scale));
+        __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(Clamp(_mm_loadu_ps(bus + i + 4)), scale));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outSamples + i), _mm_packs_epi32(lo, hi));
+    }
+
+    for (; i < sampleCount; i++)
+        outSamples[i] = int16_t(Math::Round(Math::Clamp(bus[i], -1.0f, 1.0f) * 32767.0f));
+}
+
+}
+
+HK_NAMESPACE_END
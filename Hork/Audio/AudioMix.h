@@ -0,0 +1,67 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/Core/BaseTypes.h>
+
+HK_NAMESPACE_BEGIN
+
+/// Float32 mixing kernels. The bus is stereo interleaved, samples are in [-1, 1] range.
+namespace AudioMix
+{
+
+/// Per-channel gain with a linear ramp from From to To over the first RampFrames frames.
+struct Gain
+{
+    float   From[2] = {};
+    float   To[2] = {};
+    int     RampFrames = 0;
+};
+
+/// Convert PCM samples to float. 8-bit samples are unsigned, 16-bit samples are signed, 32-bit samples are float.
+void    ConvertToF32(void const* inSamples, int sampleBits, int sampleCount, float* outSamples);
+
+/// Average stereo frames to mono. Can be done in place.
+void    DownmixStereo(float const* inFrames, int frameCount, float* outFrames);
+
+/// Pan mono frames and add them to the bus
+void    MixMono(float const* inFrames, int frameCount, Gain const& gain, float* bus);
+
+/// Add stereo frames to the bus
+void    MixStereo(float const* inFrames, int frameCount, Gain const& gain, float* bus);
+
+/// Clamp the bus and write it to the transfer buffer. Mono output takes the left channel.
+void    WriteFloat32(float const* bus, int frameCount, int channels, float* outSamples);
+void    WriteInt16(float const* bus, int frameCount, int channels, int16_t* outSamples);
+
+}
+
+HK_NAMESPACE_END
@@ -31,16 +31,20 @@ SOFTWARE.
 #include "AudioMixer.h"
 #include "HRTF.h"
 #include "Freeverb.h"
-#include "AudioDecoder.h"
+#include "AudioStreamer.h"
 
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/IntrusiveLinkedListMacro.h>
+#include <Hork/Core/AsyncJobManager.h>
 
 HK_NAMESPACE_BEGIN
 
 ConsoleVar Snd_MixAhead("Snd_MixAhead"_s, "0.1"_s);
 ConsoleVar Snd_VolumeRampSize("Snd_VolumeRampSize"_s, "16"_s);
 ConsoleVar Snd_HRTF("Snd_HRTF"_s, "1"_s);
+ConsoleVar Snd_StreamThreads("Snd_StreamThreads"_s, "2"_s, 0, "Number of threads decoding streamed tracks ahead of the playback"_s);
+ConsoleVar Snd_Reverb("Snd_Reverb"_s, "0"_s, 0, "Apply reverb to the mixed audio"_s);
+ConsoleVar Snd_HRTFJobs("Snd_HRTFJobs"_s, "1"_s, 0, "Number of parallel jobs for HRTF spatialization. 0 or 1 - spatialize on the mixer thread. Ignored by the async mixer"_s);
 
 #if 0
 ConsoleVar Rev_RoomSize("Rev_RoomSize"s, "0.5"_s);
@@ -50,41 +54,12 @@ ConsoleVar Rev_Dry("Rev_Dry"_s, "1"_s);
 ConsoleVar Rev_Width("Rev_Width"_s, "1"_s);
 #endif
 
-namespace
-{
-    // u8 to s32 sample convertion
-    struct SampleLookup8BitTable
-    {
-        int Data[32][256];
-
-        int16_t ToShort[256];
-
-        SampleLookup8BitTable()
-        {
-            for (int v = 0; v < 32; v++)
-            {
-                int vol = v * 8 * 256;
-                for (int s = 0; s < 256; s++)
-                {
-                    Data[v][(s + 128) & 0xff] = ((s < 128) ? s : s - 256) * vol;
-                }
-            }
-
-            for (int s = 0; s < 256; s++)
-            {
-                ToShort[(s + 128) & 0xff] = ((s < 128) ? s : s - 256) * 255;
-            }
-        }
-    };
-
-    const SampleLookup8BitTable SampleLookup8Bit;
-}
-
-AudioMixer::AudioMixer(AudioDevice* device) :
-    m_Device(device), m_DeviceRawPtr(device), m_IsAsync(false), m_RenderFrame(0)
+AudioMixer::AudioMixer(AudioDevice* device, AsyncJobList* jobList) :
+    m_Device(device), m_DeviceRawPtr(device), m_IsAsync(false), m_RenderFrame(0), m_JobList(jobList)
 {
     m_Hrtf = MakeUnique<AudioHRTF>(m_DeviceRawPtr->GetSampleRate());
     m_ReverbFilter = MakeUnique<Freeverb>(m_DeviceRawPtr->GetSampleRate());
+    m_Streamer = MakeUnique<AudioStreamer>(Snd_StreamThreads.GetInteger());
 
     m_Tracks = nullptr;
     m_TracksTail = nullptr;
@@ -93,12 +68,18 @@ AudioMixer::AudioMixer(AudioDevice* device) :
 
     m_TotalTracks.StoreRelaxed(0);
     m_NumActiveTracks.StoreRelaxed(0);
+    m_NumStreamUnderruns.StoreRelaxed(0);
+
+    if (m_JobList)
+        m_JobList->SetMaxParallelJobs(m_MaxHRTFJobs);
 }
 
 AudioMixer::~AudioMixer()
 {
     StopAsync();
 
+    m_Streamer.Reset();
+
     // Add pendings (if any)
     AddPendingTracks();
 
@@ -113,6 +94,11 @@ AudioMixer::~AudioMixer()
     AudioTrack::sFreePool();
 }
 
+int AudioMixer::GetNumStreams() const
+{
+    return m_Streamer->GetNumStreams();
+}
+
 void AudioMixer::StartAsync()
 {
     m_IsAsync = true;
@@ -142,7 +128,7 @@ void AudioMixer::SubmitTracks(AudioMixerSubmitQueue& submitQueue)
 
         track->Volume[0] = track->Volume_LOCK[0];
         track->Volume[1] = track->Volume_LOCK[1];
-        track->bVirtual = track->Volume[0] == 0 && track->Volume[1] == 0;
+        track->bVirtual = (track->Volume[0] == 0 && track->Volume[1] == 0) || track->bCulled_LOCK;
         track->LocalDir = track->LocalDir_LOCK;
     }
 
@@ -166,9 +152,13 @@ void AudioMixer::AddPendingTracks()
     int count = 0;
     for (AudioTrack* track = submittedTracks; track; track = track->Next)
     {
-        if (track->pDecoder && !track->bVirtual)
+        if (track->pStream)
         {
-            track->pDecoder->SeekToFrame(track->PlaybackPos.Load());
+            if (m_Streamer)
+                m_Streamer->AddStream(track->pStream);
+
+            if (!track->bVirtual)
+                track->pStream->SeekToFrame(track->PlaybackPos.Load());
         }
         count++;
     }
@@ -179,6 +169,8 @@ void AudioMixer::AddPendingTracks()
 void AudioMixer::RejectTrack(AudioTrack* track)
 {
     INTRUSIVE_REMOVE(track, Next, Prev, m_Tracks, m_TracksTail);
+    if (track->pStream)
+        m_Streamer->RemoveStream(track->pStream);
     track->RemoveRef();
     m_TotalTracks.Decrement();
 }
@@ -187,7 +179,7 @@ void AudioMixer::Update()
 {
     if (m_IsAsync)
     {
-        LOG("AudioMixer::Update: mixer is running in async thread\n");
+        LOG(LogChannel::Audio, "AudioMixer::Update: mixer is running in async thread\n");
         return;
     }
 
@@ -197,7 +189,7 @@ void AudioMixer::Update()
 
     if (m_RenderFrame < frameNum)
     {
-        LOG("AudioMixer::Update: Missing frames {}\n", frameNum - m_RenderFrame);
+        LOG(LogChannel::Audio, "AudioMixer::Update: Missing frames {}\n", frameNum - m_RenderFrame);
 
         m_RenderFrame = frameNum;
     }
@@ -278,7 +270,7 @@ void AudioMixer::RenderTracks(int64_t endFrame)
 
         int frameCount = end - m_RenderFrame;
 
-        Core::ZeroMem(m_RenderBuffer, frameCount * sizeof(SamplePair));
+        Core::ZeroMem(m_RenderBuffer, frameCount * 2 * sizeof(float));
 
         AudioTrack* next;
         for (AudioTrack* track = m_Tracks; track; track = next)
@@ -293,11 +285,14 @@ void AudioMixer::RenderTracks(int64_t endFrame)
             }
 
             bool bSeek = false;
+            bool bCulled;
 
             {
                 SpinLockGuard guard(track->Lock);
-                m_NewVol[0] = track->bPaused_LOCK ? 0 : track->Volume_LOCK[0];
-                m_NewVol[1] = track->bPaused_LOCK ? 0 : track->Volume_LOCK[1];
+                // Culled tracks are faded out and then virtualized
+                bCulled = track->bCulled_LOCK;
+                m_NewVol[0] = track->bPaused_LOCK || bCulled ? 0 : track->Volume_LOCK[0];
+                m_NewVol[1] = track->bPaused_LOCK || bCulled ? 0 : track->Volume_LOCK[1];
                 m_NewDir = track->LocalDir_LOCK;
                 m_SpatializedTrack = track->bSpatializedStereo_LOCK;
                 m_TrackPaused = track->bPaused_LOCK;
@@ -310,9 +305,9 @@ void AudioMixer::RenderTracks(int64_t endFrame)
                 }
             }
 
-            if (bSeek && !track->bVirtual && track->pDecoder)
+            if (bSeek && !track->bVirtual && track->pStream)
             {
-                track->pDecoder->SeekToFrame(m_PlaybackPos);
+                track->pStream->SeekToFrame(m_PlaybackPos);
             }
 
             if (m_NewVol[0] == 0 && m_NewVol[1] == 0 && track->Volume[0] == 0 && track->Volume[1] == 0)
@@ -320,7 +315,7 @@ void AudioMixer::RenderTracks(int64_t endFrame)
                 if (!track->bVirtual)
                 {
                     bool bLooped = track->GetLoopStart() >= 0;
-                    if (track->bVirtualizeWhenSilent || bLooped || m_TrackPaused)
+                    if (track->bVirtualizeWhenSilent || bLooped || m_TrackPaused || bCulled)
                     {
                         track->bVirtual = true;
                     }
@@ -337,9 +332,9 @@ void AudioMixer::RenderTracks(int64_t endFrame)
                 // Devirtualize
                 if (track->bVirtual)
                 {
-                    if (track->pDecoder)
+                    if (track->pStream)
                     {
-                        track->pDecoder->SeekToFrame(m_PlaybackPos);
+                        track->pStream->SeekToFrame(m_PlaybackPos);
                     }
                     track->bVirtual = false;
                 }
@@ -357,13 +352,21 @@ void AudioMixer::RenderTracks(int64_t endFrame)
                 continue;
             }
 
+            if (track->pStream && !track->bVirtual && !track->pStream->IsReady())
+            {
+                // The playback starts when the first frames are decoded
+                track->PlaybackEnd = 0;
+                track->PlaybackPos.Store(m_PlaybackPos);
+                continue;
+            }
+
             // Playing is just started or unpaused
             if (track->PlaybackEnd == 0)
             {
                 track->PlaybackEnd = m_RenderFrame + (track->FrameCount - m_PlaybackPos);
             }
 
-            if (track->pDecoder)
+            if (track->pStream)
             {
                 RenderStream(track, end);
             }
@@ -375,91 +378,47 @@ void AudioMixer::RenderTracks(int64_t endFrame)
             track->PlaybackPos.Store(m_PlaybackPos);
         }
 
-        WriteToTransferBuffer((int const*)m_RenderBuffer, end);
+        RenderDeferredHRTF();
+
+        if (Snd_Reverb)
+        {
+            // Dry signal is kept in the bus, the reverberation is added on top of it
+            m_ReverbFilter->ProcessMix(m_RenderBuffer, m_RenderBuffer + 1, m_RenderBuffer, m_RenderBuffer + 1, frameCount, 2);
+        }
+
+        WriteToTransferBuffer(m_RenderBuffer, end);
         m_RenderFrame = end;
     }
 
     m_NumActiveTracks.Store(numActiveTracks);
+
+    // Refill the consumed frames
+    m_Streamer->Notify();
 }
 
 namespace
 {
     void ConvertFramesToMonoF32(const void* inFrames, int frameCount, int sampleBits, int channels, float* outFrames)
     {
-        if (sampleBits == 8)
+        // Mono
+        if (channels == 1)
         {
-            // Lookup at max volume
-            int const*  lookup     = SampleLookup8Bit.Data[31];
-            const float intToFloat = 1.0f / 256 / 32767;
-
-            uint8_t const* frames = (uint8_t const*)inFrames;
-
-            // Mono
-            if (channels == 1)
-            {
-                for (int i = 0; i < frameCount; i++)
-                {
-                    outFrames[i] = lookup[frames[i]] * intToFloat;
-                }
-                return;
-            }
-
-            // Combine stereo channels
-            for (int i = 0; i < frameCount; i++)
-            {
-                outFrames[i] = (lookup[frames[0]] + lookup[frames[1]]) * (intToFloat * 0.5f); // average
-                frames += 2;
-            }
+            AudioMix::ConvertToF32(inFrames, sampleBits, frameCount, outFrames);
             return;
         }
 
-        if (sampleBits == 16)
-        {
-            const float intToFloat = 1.0f / 32767;
-
-            int16_t const* frames = (int16_t const*)inFrames;
-
-            // Mono
-            if (channels == 1)
-            {
-                for (int i = 0; i < frameCount; i++)
-                {
-                    outFrames[i] = frames[i] * intToFloat;
-                }
-                return;
-            }
+        // Combine stereo channels
+        const int ChunkFrames = 512;
 
-            // Combine stereo channels
-            for (int i = 0; i < frameCount; i++)
-            {
-                outFrames[i] = ((int)frames[0] + (int)frames[1]) * (intToFloat * 0.5f); // average
-                frames += 2;
-            }
-            return;
-        }
+        alignas(16) float stereoFrames[ChunkFrames * 2];
 
-        if (sampleBits == 32)
+        int stride = sampleBits / 8 * 2;
+        for (int i = 0; i < frameCount; i += ChunkFrames)
         {
-            float const* frames = (float const*)inFrames;
-
-            // Mono
-            if (channels == 1)
-            {
-                Core::Memcpy(outFrames, inFrames, frameCount * sizeof(float));
-                return;
-            }
-
-            // Combine stereo channels
-            for (int i = 0; i < frameCount; i++)
-            {
-                outFrames[i] = (frames[0] + frames[1]) * 0.5f; // average
-                frames += 2;
-            }
-            return;
+            int count = Math::Min(ChunkFrames, frameCount - i);
+            AudioMix::ConvertToF32((const uint8_t*)inFrames + i * stride, sampleBits, count * 2, stereoFrames);
+            AudioMix::DownmixStereo(stereoFrames, count, outFrames + i);
         }
-
-        // Should never happen, but just in case...
-        HK_ASSERT(0);
     }
 }
 
@@ -572,15 +531,15 @@ void AudioMixer::RenderTrack(AudioTrack* track, int64_t endFrame)
                 {
                     void const* frames = pRawSamples + m_PlaybackPos * stride;
 
-                    SamplePair* buffer = &m_RenderBuffer[frameNum - m_RenderFrame];
+                    float* bus = m_RenderBuffer + (frameNum - m_RenderFrame) * 2;
 
                     if (Snd_HRTF && track->bSpatializedStereo_LOCK)
                     {
-                        RenderFramesHRTF(track, framesToRender, buffer);
+                        RenderFramesHRTF(track, framesToRender, bus);
                     }
                     else
                     {
-                        RenderFrames(track, frames, framesToRender, buffer);
+                        RenderFrames(track, frames, framesToRender, bus);
                     }
 
                     track->Volume[0] = m_NewVol[0];
@@ -641,15 +600,22 @@ void AudioMixer::RenderStream(AudioTrack* track, int64_t endFrame)
                 framesToRender = clipFrameCount - m_PlaybackPos;
             }
 
-            if (!track->bVirtual)
+            if (!track->bVirtual && framesToRender > 0)
             {
                 m_TempFrames.ResizeInvalidate(framesToRender * stride);
 
-                framesToRender = track->pDecoder->ReadFrames(m_TempFrames.ToPtr(), framesToRender, framesToRender * stride);
+                int framesRead = track->pStream->ReadFrames(m_TempFrames.ToPtr(), framesToRender);
+
+                if (framesRead < framesToRender && !track->pStream->IsEnded())
+                {
+                    // Decoding is behind the playback. Skip the missing frames to stay in sync.
+                    track->pStream->SkipFrames(framesToRender - framesRead);
+                    m_NumStreamUnderruns.Increment();
+                }
 
-                if (framesToRender > 0)
+                if (framesRead > 0)
                 {
-                    RenderFrames(track, m_TempFrames.ToPtr(), framesToRender, &m_RenderBuffer[frameNum - m_RenderFrame]);
+                    RenderFrames(track, m_TempFrames.ToPtr(), framesRead, m_RenderBuffer + (frameNum - m_RenderFrame) * 2);
 
                     track->Volume[0] = m_NewVol[0];
                     track->Volume[1] = m_NewVol[1];
@@ -665,10 +631,7 @@ void AudioMixer::RenderStream(AudioTrack* track, int64_t endFrame)
         {
             if (track->GetLoopStart() >= 0)
             {
-                if (!track->bVirtual)
-                {
-                    track->pDecoder->SeekToFrame(track->GetLoopStart());
-                }
+                // The stream is decoded from the loop start ahead of the playback, so there is no seek
                 m_PlaybackPos = track->GetLoopStart();
                 track->PlaybackEnd = frameNum + (clipFrameCount - m_PlaybackPos);
                 track->LoopsCount++;
@@ -682,38 +645,22 @@ void AudioMixer::RenderStream(AudioTrack* track, int64_t endFrame)
     }
 }
 
-void AudioMixer::MakeVolumeRamp(const int curVol[2], const int newVol[2], int frameCount, int scale)
+AudioMix::Gain AudioMixer::MakeGain(const int curVol[2], const int newVol[2], int frameCount, float scale) const
 {
-    if (curVol[0] == newVol[0] && curVol[1] == newVol[1])
-    {
-        m_VolumeRampSize = 0;
-        return;
-    }
-
-    m_VolumeRampSize = Math::Min3((int)HK_ARRAY_SIZE(m_VolumeRampL), frameCount, Snd_VolumeRampSize.GetInteger());
-    if (m_VolumeRampSize < 0)
-    {
-        m_VolumeRampSize = 0;
-        return;
-    }
+    AudioMix::Gain gain;
 
-    float increment0 = (float)(newVol[0] - curVol[0]) / (m_VolumeRampSize * scale);
-    float increment1 = (float)(newVol[1] - curVol[1]) / (m_VolumeRampSize * scale);
+    gain.From[0] = curVol[0] * scale;
+    gain.From[1] = curVol[1] * scale;
+    gain.To[0] = newVol[0] * scale;
+    gain.To[1] = newVol[1] * scale;
 
-    float lvolf = (float)curVol[0] / scale;
-    float rvolf = (float)curVol[1] / scale;
-
-    for (int i = 0; i < m_VolumeRampSize; i++)
-    {
-        lvolf += increment0;
-        rvolf += increment1;
+    if (curVol[0] != newVol[0] || curVol[1] != newVol[1])
+        gain.RampFrames = Math::Max(0, Math::Min(frameCount, Snd_VolumeRampSize.GetInteger()));
 
-        m_VolumeRampL[i] = lvolf;
-        m_VolumeRampR[i] = rvolf;
-    }
+    return gain;
 }
 
-void AudioMixer::RenderFramesHRTF(AudioTrack* track, int frameCount, SamplePair* buffer)
+void AudioMixer::RenderFramesHRTF(AudioTrack* track, int frameCount, float* bus)
 {
     int total = frameCount;
 
@@ -727,390 +674,144 @@ void AudioMixer::RenderFramesHRTF(AudioTrack* track, int frameCount, SamplePair*
 
     int historyExtraFrames = m_Hrtf->GetFrameCount() - 1;
 
+    // The filter output is scaled by the filter size. Only the first channel volume is used for spatialized tracks.
+    const int curVol[2] = {track->Volume[0], track->Volume[0]};
+    const int newVol[2] = {m_NewVol[0], m_NewVol[0]};
+    const float gainScale = 1.0f / (m_Hrtf->GetFilterSize() * 32767.0f);
+
+    // The async mixer runs on the audio device thread and must not wait for the shared job workers
+    if (m_JobList && !m_IsAsync && Snd_HRTFJobs.GetInteger() > 1)
+    {
+        // Read the frames now, convolution is done later by the jobs
+        HRTFVoice& voice = m_HRTFVoices.Add();
+        voice.CurDir = track->LocalDir;
+        voice.NewDir = m_NewDir;
+        voice.Gain = MakeGain(curVol, newVol, frameCount, gainScale);
+        voice.FrameCount = frameCount;
+        voice.BlockFrames = total;
+        voice.BusOffset = (bus - m_RenderBuffer) / 2;
+        voice.InputOffset = m_HRTFInput.Size();
+        voice.OutputOffset = m_HRTFOutput.Size();
+
+        m_HRTFInput.Resize(voice.InputOffset + total + historyExtraFrames);
+        m_HRTFOutput.Resize(voice.OutputOffset + total * 2);
+
+        ReadFramesF32(track, total, historyExtraFrames, m_HRTFInput.ToPtr() + voice.InputOffset);
+
+        track->LocalDir = AudioHRTF::sGetResultDir(track->LocalDir, m_NewDir);
+        return;
+    }
+
     // Read frames from current playback position and convert to f32 format
-    m_FramesF32.ResizeInvalidate((total + historyExtraFrames) * sizeof(float));
+    m_FramesF32.ResizeInvalidate(total + historyExtraFrames);
     ReadFramesF32(track, total, historyExtraFrames, m_FramesF32.ToPtr());
 
     // Reallocate (if need) container for filtered samples
-    m_StreamF32.ResizeInvalidate(sizeof(SamplePair) * total);
+    m_StreamF32.ResizeInvalidate(total * 2);
 
     // Apply HRTF filter
     Float3 dir;
-    m_Hrtf->ApplyHRTF(track->LocalDir, m_NewDir, m_FramesF32.ToPtr(), total, (float*)m_StreamF32.ToPtr(), dir);
+    m_Hrtf->ApplyHRTF(track->LocalDir, m_NewDir, m_FramesF32.ToPtr(), total, m_StreamF32.ToPtr(), dir);
     track->LocalDir = dir;
 
-    // Make volume ramp
-    m_VolumeRampSize = 0;
-    if (track->Volume[0] != m_NewVol[0] || track->Volume[1] != m_NewVol[1])
-    {
-        m_VolumeRampSize = Math::Min3((int)HK_ARRAY_SIZE(m_VolumeRampL), frameCount, Snd_VolumeRampSize.GetInteger());
-        if (m_VolumeRampSize > 0)
-        {
-            float scale = 256.0f / m_Hrtf->GetFilterSize();
-            float increment0 = (float)(m_NewVol[0] - track->Volume[0]) / m_VolumeRampSize * scale;
-            float lvolf = (float)track->Volume[0] * scale;
-            for (int i = 0; i < m_VolumeRampSize; i++)
-            {
-                lvolf += increment0;
-                m_VolumeRampL[i] = lvolf;
-            }
-        }
-    }
-
-    SamplePair* pStreamF32 = m_StreamF32.ToPtr();
-
-#if 0
-    // Adjust volume
-    float vol = float( 65536 / 256 ) * m_NewVol[0] / m_Hrtf->GetFilterSize();
-    for ( int i = 0; i < m_VolumeRampSize; i++ ) {
-        pStreamF32[i].Chanf[0] = pStreamF32[i].Chanf[0] * m_VolumeRampL[i];
-        pStreamF32[i].Chanf[1] = pStreamF32[i].Chanf[1] * m_VolumeRampL[i];
-    }
-    for ( int i = m_VolumeRampSize ; i < frameCount; i++ ) {
-        pStreamF32[i].Chanf[0] = pStreamF32[i].Chanf[0] * vol;
-        pStreamF32[i].Chanf[1] = pStreamF32[i].Chanf[1] * vol;
-    }
-
-    float * out = (float *)malloc( frameCount * 2 * sizeof( float ) );
-
-    ReverbFilter->ProcessReplace( &pStreamF32[0].Chanf[0], &pStreamF32[0].Chanf[1], &out[0], &out[1], frameCount, 2 );
-
-    // Mix with output stream
-    for ( int i = 0 ; i < frameCount; i++ ) {
-        buffer[i].Chan[0] += out[i*2] ;
-        buffer[i].Chan[1] += out[i*2+1];
-    }
-
-    free( out );
-#else
     // Mix with output stream
-    float vol = float(65536 / 256) * m_NewVol[0] / m_Hrtf->GetFilterSize();
-    for (int i = 0; i < m_VolumeRampSize; i++)
-    {
-        buffer[i].Chan[0] += pStreamF32[i].Chanf[0] * m_VolumeRampL[i];
-        buffer[i].Chan[1] += pStreamF32[i].Chanf[1] * m_VolumeRampL[i];
-    }
-    for (int i = m_VolumeRampSize; i < frameCount; i++)
-    {
-        buffer[i].Chan[0] += pStreamF32[i].Chanf[0] * vol;
-        buffer[i].Chan[1] += pStreamF32[i].Chanf[1] * vol;
-    }
-#endif
+    AudioMix::MixStereo(m_StreamF32.ToPtr(), frameCount, MakeGain(curVol, newVol, frameCount, gainScale), bus);
 }
 
-void AudioMixer::RenderFrames(AudioTrack* track, const void* inFrames, int frameCount, SamplePair* buffer)
+void AudioMixer::sProcessHRTFJob(void* data)
 {
-    int sampleBits = track->SampleBits;
-    int channels = track->Channels;
+    HRTFJob* job = static_cast<HRTFJob*>(data);
+    AudioMixer* mixer = job->Mixer;
 
-    // Render 8bit audio
-    if (sampleBits == 8)
+    for (int i = job->First; i < mixer->m_HRTFVoices.Size(); i += job->Stride)
     {
-        uint8_t const* frames = (uint8_t const*)inFrames;
-
-#if 0
-        int lvol = Math::Min( m_NewVol[0] / 256, 255 );
-        int rvol = Math::Min( m_NewVol[1] / 256, 255 );
-
-        int const * ls = SampleLookup8Bit.Data[lvol >> 3];
-        int const * rs = SampleLookup8Bit.Data[rvol >> 3];
-
-        // Mono
-        if ( channels == 1 ) {
-            MakeVolumeRamp( track->Volume, m_NewVol, frameCount, 256 );
-
-            for ( int i = 0; i < m_VolumeRampSize; i++ ) {
-                buffer[i].Chan[0] += ls[frames[i]]*m_VolumeRampL[i];
-                buffer[i].Chan[1] += rs[frames[i]]*m_VolumeRampR[i];
-            }
-
-            for ( int i = m_VolumeRampSize ; i < frameCount; i++ ) {
-                buffer[i].Chan[0] += ls[frames[i]];
-                buffer[i].Chan[1] += rs[frames[i]];
-            }
-            return;
-        }
-#else
-        int lvol = m_NewVol[0];
-        int rvol = m_NewVol[1];
-
-        // Mono
-        if (channels == 1)
-        {
-            lvol /= 256;
-            rvol /= 256;
+        HRTFVoice const& voice = mixer->m_HRTFVoices[i];
 
-            MakeVolumeRamp(track->Volume, m_NewVol, frameCount, 256);
-
-            for (int i = 0; i < m_VolumeRampSize; i++)
-            {
-                buffer[i].Chan[0] += SampleLookup8Bit.ToShort[frames[i]] * m_VolumeRampL[i];
-                buffer[i].Chan[1] += SampleLookup8Bit.ToShort[frames[i]] * m_VolumeRampR[i];
-            }
-
-            for (int i = m_VolumeRampSize; i < frameCount; i++)
-            {
-                buffer[i].Chan[0] += SampleLookup8Bit.ToShort[frames[i]] * lvol;
-                buffer[i].Chan[1] += SampleLookup8Bit.ToShort[frames[i]] * rvol;
-            }
-            return;
-        }
-#endif
-
-        // Spatialized stereo
-        if (m_SpatializedTrack)
-        {
-            // Combine stereo channels
-
-#if 0
-
-            MakeVolumeRamp( track->Volume, m_NewVol, frameCount, 512 );
-
-            for ( int i = 0; i < m_VolumeRampSize; i++ ) {
-                buffer[i].Chan[0] += ( ls[frames[0]] + ls[frames[1]] ) * m_VolumeRampL[i];
-                buffer[i].Chan[1] += ( rs[frames[0]] + rs[frames[1]] ) * m_VolumeRampR[i];
-
-                frames += 2;
-            }
-
-            for ( int i = m_VolumeRampSize ; i < frameCount; i++ ) {
-                buffer[i].Chan[0] += ( ls[frames[0]] + ls[frames[1]] ) / 2;
-                buffer[i].Chan[1] += ( rs[frames[0]] + rs[frames[1]] ) / 2;
-
-                frames += 2;
-            }
-
-#else
-
-            lvol /= 512;
-            rvol /= 512;
-
-            MakeVolumeRamp(track->Volume, m_NewVol, frameCount, 512);
-
-            for (int i = 0; i < m_VolumeRampSize; i++)
-            {
-                buffer[i].Chan[0] += (SampleLookup8Bit.ToShort[frames[0]] + SampleLookup8Bit.ToShort[frames[1]]) * m_VolumeRampL[i];
-                buffer[i].Chan[1] += (SampleLookup8Bit.ToShort[frames[0]] + SampleLookup8Bit.ToShort[frames[1]]) * m_VolumeRampR[i];
-
-                frames += 2;
-            }
-
-            for (int i = m_VolumeRampSize; i < frameCount; i++)
-            {
-                buffer[i].Chan[0] += (SampleLookup8Bit.ToShort[frames[0]] + SampleLookup8Bit.ToShort[frames[1]]) * lvol;
-                buffer[i].Chan[1] += (SampleLookup8Bit.ToShort[frames[0]] + SampleLookup8Bit.ToShort[frames[1]]) * rvol;
-
-                frames += 2;
-            }
-#endif
-
-            return;
-        }
-
-        // Background music/etc
-#if 0
-        MakeVolumeRamp( track->Volume, m_NewVol, frameCount, 256 );
-        for ( int i = 0; i < m_VolumeRampSize; i++ ) {
-            buffer[i].Chan[0] += ls[frames[0]] * m_VolumeRampL[i];
-            buffer[i].Chan[1] += rs[frames[1]] * m_VolumeRampR[i];
-
-            frames += 2;
-        }
-        for ( int i = m_VolumeRampSize ; i < frameCount; i++ ) {
-            buffer[i].Chan[0] += ls[frames[0]];
-            buffer[i].Chan[1] += rs[frames[1]];
-
-            frames += 2;
-        }
-#else
-        lvol /= 256;
-        rvol /= 256;
-
-        MakeVolumeRamp(track->Volume, m_NewVol, frameCount, 256);
-        for (int i = 0; i < m_VolumeRampSize; i++)
-        {
-            buffer[i].Chan[0] += SampleLookup8Bit.ToShort[frames[0]] * m_VolumeRampL[i];
-            buffer[i].Chan[1] += SampleLookup8Bit.ToShort[frames[1]] * m_VolumeRampR[i];
-
-            frames += 2;
-        }
-        for (int i = m_VolumeRampSize; i < frameCount; i++)
-        {
-            buffer[i].Chan[0] += SampleLookup8Bit.ToShort[frames[0]] * lvol;
-            buffer[i].Chan[1] += SampleLookup8Bit.ToShort[frames[1]] * rvol;
-
-            frames += 2;
-        }
-#endif
-        return;
+        Float3 dir;
+        mixer->m_Hrtf->ApplyHRTF(*job->Workspace, voice.CurDir, voice.NewDir,
+                                 mixer->m_HRTFInput.ToPtr() + voice.InputOffset, voice.BlockFrames,
+                                 mixer->m_HRTFOutput.ToPtr() + voice.OutputOffset, dir);
     }
+}
 
-    // Render 16bit audio
-    if (sampleBits == 16)
-    {
-        int lvol = m_NewVol[0];
-        int rvol = m_NewVol[1];
-
-        int16_t const* frames = (int16_t const*)inFrames;
-
-        // Mono
-        if (channels == 1)
-        {
-            lvol /= 256;
-            rvol /= 256;
-
-            MakeVolumeRamp(track->Volume, m_NewVol, frameCount, 256);
-
-            for (int i = 0; i < m_VolumeRampSize; i++)
-            {
-                buffer[i].Chan[0] += frames[i] * m_VolumeRampL[i];
-                buffer[i].Chan[1] += frames[i] * m_VolumeRampR[i];
-            }
-
-            for (int i = m_VolumeRampSize; i < frameCount; i++)
-            {
-                buffer[i].Chan[0] += frames[i] * lvol;
-                buffer[i].Chan[1] += frames[i] * rvol;
-            }
-            return;
-        }
-
-        // Spatialized stereo
-        if (m_SpatializedTrack)
-        {
-            // Combine stereo channels
-
-            // Downscale the volume twice
-            lvol /= 512;
-            rvol /= 512;
-
-            MakeVolumeRamp(track->Volume, m_NewVol, frameCount, 512);
-
-            for (int i = 0; i < m_VolumeRampSize; i++)
-            {
-                buffer[i].Chan[0] += ((int)frames[0] + (int)frames[1]) * m_VolumeRampL[i];
-                buffer[i].Chan[1] += ((int)frames[0] + (int)frames[1]) * m_VolumeRampR[i];
-
-                frames += 2;
-            }
+void AudioMixer::RenderDeferredHRTF()
+{
+    if (m_HRTFVoices.IsEmpty())
+        return;
 
-            for (int i = m_VolumeRampSize; i < frameCount; i++)
-            {
-                buffer[i].Chan[0] += ((int)frames[0] + (int)frames[1]) * lvol;
-                buffer[i].Chan[1] += ((int)frames[0] + (int)frames[1]) * rvol;
+    int numJobs = Math::Min(Math::Clamp(Snd_HRTFJobs.GetInteger(), 1, m_MaxHRTFJobs), int(m_HRTFVoices.Size()));
 
-                frames += 2;
-            }
+    while (m_HRTFWorkspaces.Size() < numJobs)
+        m_HRTFWorkspaces.Add(MakeUnique<HRTFWorkspace>(m_Hrtf->GetFilterSize()));
 
-            return;
-        }
+    // Voices are interleaved between the jobs, so each job gets a similar amount of work
+    m_HRTFJobs.ResizeInvalidate(numJobs);
+    for (int i = 0; i < numJobs; i++)
+    {
+        HRTFJob& job = m_HRTFJobs[i];
+        job.Mixer = this;
+        job.Workspace = m_HRTFWorkspaces[i].RawPtr();
+        job.First = i;
+        job.Stride = numJobs;
 
-        // Background music/etc
-        lvol /= 256;
-        rvol /= 256;
-        MakeVolumeRamp(track->Volume, m_NewVol, frameCount, 256);
-        for (int i = 0; i < m_VolumeRampSize; i++)
-        {
-            buffer[i].Chan[0] += frames[0] * m_VolumeRampL[i];
-            buffer[i].Chan[1] += frames[1] * m_VolumeRampR[i];
+        m_JobList->AddJob(sProcessHRTFJob, &job);
+    }
 
-            frames += 2;
-        }
-        for (int i = m_VolumeRampSize; i < frameCount; i++)
-        {
-            buffer[i].Chan[0] += frames[0] * lvol;
-            buffer[i].Chan[1] += frames[1] * rvol;
+    m_JobList->SubmitAndWait();
 
-            frames += 2;
-        }
-        return;
-    }
+    // Reduce to the bus in submission order
+    for (HRTFVoice const& voice : m_HRTFVoices)
+        AudioMix::MixStereo(m_HRTFOutput.ToPtr() + voice.OutputOffset, voice.FrameCount, voice.Gain, m_RenderBuffer + voice.BusOffset * 2);
 
-    // TODO: Add code pass for 32F ?
+    m_HRTFVoices.Clear();
+    m_HRTFInput.Clear();
+    m_HRTFOutput.Clear();
 }
 
-namespace
+void AudioMixer::RenderFrames(AudioTrack* track, const void* inFrames, int frameCount, float* bus)
 {
+    int sampleBits = track->SampleBits;
+    int channels = track->Channels;
 
-    void WriteSamples_FLOAT32(int const* in, float* out, int count)
-    {
-        const float scale = 1.0f / 256 / 32767;
-
-        __m128 minVal = _mm_set_ss(-1.0f);
-        __m128 maxVal = _mm_set_ss(1.0f);
-
-        for (int i = 0; i < count; i += 2)
-        {
-            float val1 = static_cast<float>(in[i]) * scale;
-            float val2 = static_cast<float>(in[i + 1]) * scale;
+    // Volume 65535 is the unit gain
+    AudioMix::Gain gain = MakeGain(track->Volume, m_NewVol, frameCount, 1.0f / 65536);
 
-            _mm_store_ss(&out[i], _mm_min_ss(_mm_max_ss(_mm_set_ss(val1), minVal), maxVal));
-            _mm_store_ss(&out[i + 1], _mm_min_ss(_mm_max_ss(_mm_set_ss(val2), minVal), maxVal));
-        }
+    float* frames;
+    if (sampleBits == 32 && !(channels == 2 && m_SpatializedTrack))
+    {
+        frames = (float*)inFrames;
     }
-
-    void WriteSamples_FLOAT32_Mono(int const* in, float* out, int count)
+    else
     {
-        const float scale = 1.0f / 256 / 32767;
-
-        __m128 minVal = _mm_set_ss(-1.0f);
-        __m128 maxVal = _mm_set_ss(1.0f);
-
-        while (count--)
-        {
-            float val = static_cast<float>(*in) * scale;
-
-            _mm_store_ss(out, _mm_min_ss(_mm_max_ss(_mm_set_ss(val), minVal), maxVal));
-
-            out++;
-            in += 2;
-        }
+        m_MixFrames.ResizeInvalidate(frameCount * channels);
+        frames = m_MixFrames.ToPtr();
+        AudioMix::ConvertToF32(inFrames, sampleBits, frameCount * channels, frames);
     }
 
-    void WriteSamples_INT16_Mono(int const* in, short* out, int count)
+    // Mono
+    if (channels == 1)
     {
-        int v;
-
-        while (count--)
-        {
-            v = *in / 256;
-            if (v > 32767)
-                v = 32767;
-            else if (v < -32768)
-                v = -32768;
-            *out++ = v;
-            in += 2;
-        }
+        AudioMix::MixMono(frames, frameCount, gain, bus);
+        return;
     }
 
-    void WriteSamples_INT16(int const* in, short* out, int count)
+    // Spatialized stereo
+    if (m_SpatializedTrack)
     {
-        int v;
-
-        for (int i = 0; i < count; i += 2)
-        {
-            v = in[i] / 256;
-            if (v > 32767)
-                out[i] = 32767;
-            else if (v < -32768)
-                out[i] = -32768;
-            else
-                out[i] = v;
-
-            v = in[i + 1] / 256;
-            if (v > 32767)
-                out[i + 1] = 32767;
-            else if (v < -32768)
-                out[i + 1] = -32768;
-            else
-                out[i + 1] = v;
-        }
+        // Combine stereo channels
+        AudioMix::DownmixStereo(frames, frameCount, frames);
+        AudioMix::MixMono(frames, frameCount, gain, bus);
+        return;
     }
+
+    // Background music/etc
+    AudioMix::MixStereo(frames, frameCount, gain, bus);
 }
 
-void AudioMixer::WriteToTransferBuffer(int const* samples, int64_t endFrame)
+void AudioMixer::WriteToTransferBuffer(float const* bus, int64_t endFrame)
 {
     int64_t wrapMask = m_DeviceRawPtr->GetTransferBufferSizeInFrames() - 1;
+    int channels = m_DeviceRawPtr->GetChannels();
 
     for (int64_t frameNum = m_RenderFrame; frameNum < endFrame;)
     {
@@ -1122,27 +823,12 @@ void AudioMixer::WriteToTransferBuffer(int const* samples, int64_t endFrame)
 
         frameNum += frameCount;
 
-        if (m_DeviceRawPtr->GetChannels() == 1)
-        {
-            if (m_DeviceRawPtr->GetTransferFormat() == AudioTransferFormat::FLOAT32)
-                WriteSamples_FLOAT32_Mono(samples, (float*)m_TransferBuffer + frameOffset, frameCount);
-            else
-                WriteSamples_INT16_Mono(samples, (int16_t*)m_TransferBuffer + frameOffset, frameCount);
-
-            samples += frameCount << 1;
-        }
+        if (m_DeviceRawPtr->GetTransferFormat() == AudioTransferFormat::FLOAT32)
+            AudioMix::WriteFloat32(bus, frameCount, channels, (float*)m_TransferBuffer + frameOffset * channels);
         else
-        {
-            frameOffset <<= 1;
-            frameCount <<= 1;
+            AudioMix::WriteInt16(bus, frameCount, channels, (int16_t*)m_TransferBuffer + frameOffset * channels);
 
-            if (m_DeviceRawPtr->GetTransferFormat() == AudioTransferFormat::FLOAT32)
-                WriteSamples_FLOAT32(samples, (float*)m_TransferBuffer + frameOffset, frameCount);
-            else
-                WriteSamples_INT16(samples, (int16_t*)m_TransferBuffer + frameOffset, frameCount);
-
-            samples += frameCount;
-        }
+        bus += frameCount * 2;
     }
 }
 
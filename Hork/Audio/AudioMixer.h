@@ -32,12 +32,16 @@ SOFTWARE.
 
 #include "AudioDevice.h"
 #include "AudioTrack.h"
+#include "AudioMix.h"
 
 #include <Hork/Core/Containers/ArrayView.h>
 #include <Hork/Core/ConsoleVar.h>
 
 HK_NAMESPACE_BEGIN
 
+class AsyncJobList;
+class HRTFWorkspace;
+
 class AudioMixerSubmitQueue final : public Noncopyable
 {
 public:
@@ -75,7 +79,9 @@ private:
 class AudioMixer final : public Noncopyable
 {
 public:
-                        AudioMixer(AudioDevice* device);
+    /// The job list is used to spatialize tracks in parallel (see Snd_HRTFJobs) when the mixer is updated
+    /// from the main thread. The async mixer never waits for the jobs.
+                        AudioMixer(AudioDevice* device, AsyncJobList* jobList = nullptr);
                         ~AudioMixer();
 
     /// Add tracks to mixer thread
@@ -90,6 +96,12 @@ public:
     /// Get total count of tracks
     int                 GetTotalTracks() const { return m_TotalTracks.Load(); }
 
+    /// Get count of tracks decoded by the streamer
+    int                 GetNumStreams() const;
+
+    /// Get number of times the streamed tracks ran out of decoded frames
+    int                 GetNumStreamUnderruns() const { return m_NumStreamUnderruns.Load(); }
+
     /// Start async mixing
     void                StartAsync();
 
@@ -102,15 +114,6 @@ public:
     bool                IsAsync() const { return m_IsAsync; }
 
 private:
-    struct SamplePair
-    {
-        union
-        {
-            int32_t Chan[2];
-            float   Chanf[2];
-        };
-    };
-
     void                UpdateAsync(uint8_t* transferBuffer, int transferBufferSizeInFrames, int frameNum, int minFramesToRender);
 
     // This fuction adds pending tracks to list
@@ -119,17 +122,22 @@ private:
     void                RenderTracks(int64_t endFrame);
     void                RenderTrack(AudioTrack* track, int64_t endFrame);
     void                RenderStream(AudioTrack* track, int64_t endFrame);
-    void                RenderFramesHRTF(AudioTrack* track, int frameCount, SamplePair* buffer);
-    void                RenderFrames(AudioTrack* track, const void* frames, int frameCount, SamplePair* buffer);
-    void                WriteToTransferBuffer(int const* samples, int64_t endFrame);
-    void                MakeVolumeRamp(const int curVol[2], const int newVol[2], int frameCount, int scale);
+    void                RenderFramesHRTF(AudioTrack* track, int frameCount, float* bus);
+    void                RenderDeferredHRTF();
+    void                RenderFrames(AudioTrack* track, const void* frames, int frameCount, float* bus);
+    void                WriteToTransferBuffer(float const* bus, int64_t endFrame);
+    AudioMix::Gain      MakeGain(const int curVol[2], const int newVol[2], int frameCount, float scale) const;
     void                ReadFramesF32(AudioTrack* track, int framesToRead, int historyExtraFrames, float* frames);
 
+    static void         sProcessHRTFJob(void* data);
+
     UniqueRef<class AudioHRTF> m_Hrtf;
     UniqueRef<class Freeverb>  m_ReverbFilter;
+    UniqueRef<class AudioStreamer> m_Streamer;
 
-    alignas(16) SamplePair  m_RenderBuffer[2048];
-    static constexpr int    m_RenderBufferSize = HK_ARRAY_SIZE(m_RenderBuffer);
+    /// Stereo interleaved float bus
+    static constexpr int    m_RenderBufferSize = 2048;
+    alignas(16) float       m_RenderBuffer[m_RenderBufferSize * 2];
 
     Ref<AudioDevice>        m_Device;
     AudioDevice*            m_DeviceRawPtr;
@@ -138,6 +146,7 @@ private:
     int64_t                 m_RenderFrame;
     AtomicInt               m_NumActiveTracks;
     AtomicInt               m_TotalTracks;
+    AtomicInt               m_NumStreamUnderruns;
 
     AudioTrack*             m_Tracks;
     AudioTrack*             m_TracksTail;
@@ -152,15 +161,44 @@ private:
     bool                    m_SpatializedTrack;
     bool                    m_TrackPaused;
     int                     m_PlaybackPos;
-    int                     m_VolumeRampL[1024];
-    int                     m_VolumeRampR[1024];
-    int                     m_VolumeRampSize;
 
     Vector<uint8_t>         m_TempFrames;
     Vector<float>           m_FramesF32;
-    Vector<SamplePair>      m_StreamF32;
+    Vector<float>           m_StreamF32;
+    Vector<float>           m_MixFrames;
+
+    // Spatialized tracks deferred to the job list
+    struct HRTFVoice
+    {
+        Float3              CurDir;
+        Float3              NewDir;
+        AudioMix::Gain      Gain;
+        int                 FrameCount;
+        int                 BlockFrames;
+        int                 BusOffset;
+        size_t              InputOffset;
+        size_t              OutputOffset;
+    };
+
+    struct HRTFJob
+    {
+        AudioMixer*         Mixer;
+        HRTFWorkspace*      Workspace;
+        int                 First;
+        int                 Stride;
+    };
+
+    static constexpr int    m_MaxHRTFJobs = 16;
+    AsyncJobList*           m_JobList;
+    Vector<HRTFVoice>       m_HRTFVoices;
+    Vector<float>           m_HRTFInput;
+    Vector<float>           m_HRTFOutput;
+    Vector<HRTFJob>         m_HRTFJobs;
+    Vector<UniqueRef<HRTFWorkspace>> m_HRTFWorkspaces;
 };
 
 extern ConsoleVar Snd_HRTF;
+extern ConsoleVar Snd_HRTFJobs;
+extern ConsoleVar Snd_Reverb;
 
 HK_NAMESPACE_END
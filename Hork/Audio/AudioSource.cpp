@@ -91,7 +91,7 @@ bool DecodeAudio(IBinaryStreamReadInterface& inStream, AudioResample const& inRe
     ma_result result = ma_decoder_init(Read, Seek, &inStream, &config, &decoder);
     if (result != MA_SUCCESS)
     {
-        LOG("DecodeAudio: failed to load {}\n", inStream.GetName());
+        LOG(LogChannel::Audio, "DecodeAudio: failed to load {}\n", inStream.GetName());
         return false;
     }
 
@@ -160,7 +160,7 @@ bool ReadAudioInfo(IBinaryStreamReadInterface& inStream, AudioResample const& in
     ma_result result = ma_decoder_init(Read, Seek, &inStream, &config, &decoder);
     if (result != MA_SUCCESS)
     {
-        LOG("ReadAudioInfo: failed to load {}\n", inStream.GetName());
+        LOG(LogChannel::Audio, "ReadAudioInfo: failed to load {}\n", inStream.GetName());
         return false;
     }
 
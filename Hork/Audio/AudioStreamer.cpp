@@ -0,0 +1,314 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "AudioStreamer.h"
+
+#include <Hork/Core/ConsoleVar.h>
+#include <Hork/Core/Profiler.h>
+
+HK_NAMESPACE_BEGIN
+
+ConsoleVar Snd_StreamAhead("Snd_StreamAhead"_s, "250"_s, 0, "Length of decoded audio buffered ahead of the playback for streamed tracks (in milliseconds)"_s);
+
+namespace
+{
+    // Frames decoded by a thread at once
+    constexpr int DecodeChunkFrames = 4096;
+
+    // Idle streamer threads check the streams with this interval if they are not notified
+    constexpr int IdleTimeoutMs = 10;
+}
+
+AudioStreamBuffer::AudioStreamBuffer(AudioSource* inSource, int inLoopStart) :
+    m_Decoder(MakeRef<AudioDecoder>(inSource)),
+    m_Stride(inSource->GetSampleStride()),
+    m_LoopStart(inLoopStart)
+{
+    int frames = Math::Max(1, Snd_StreamAhead.GetInteger()) * inSource->GetSampleRate() / 1000;
+
+    // Capacity must be a power of two to wrap positions by mask
+    m_Capacity = Math::ToGreaterPowerOfTwo(Math::Max(frames, DecodeChunkFrames));
+    m_Frames.ResizeInvalidate(m_Capacity * m_Stride);
+}
+
+void AudioStreamBuffer::SeekToFrame(int inFrameNum)
+{
+    {
+        SpinLockGuard guard(m_Lock);
+        m_SeekFrame = inFrameNum;
+        m_Generation++;
+        m_ReadPos = 0;
+        m_WritePos = 0;
+        m_IsReady = false;
+        m_IsEnded = false;
+    }
+    m_SkipFrames = 0;
+}
+
+int AudioStreamBuffer::ReadFrames(void* outFrames, int inFrameCount)
+{
+    uint32_t readPos;
+    int bufferedFrames;
+    {
+        SpinLockGuard guard(m_Lock);
+        readPos = m_ReadPos;
+        bufferedFrames = m_WritePos - m_ReadPos;
+    }
+
+    // Drop the frames that should have been played during underrun
+    int skip = Math::Min(m_SkipFrames, bufferedFrames);
+    m_SkipFrames -= skip;
+    readPos += skip;
+    bufferedFrames -= skip;
+
+    int frameCount = Math::Min(inFrameCount, bufferedFrames);
+
+    uint32_t offset = readPos & (m_Capacity - 1);
+    int count = Math::Min<int>(frameCount, m_Capacity - offset);
+
+    Core::Memcpy(outFrames, m_Frames.ToPtr() + offset * m_Stride, count * m_Stride);
+    if (count < frameCount)
+        Core::Memcpy((uint8_t*)outFrames + count * m_Stride, m_Frames.ToPtr(), (frameCount - count) * m_Stride);
+
+    {
+        SpinLockGuard guard(m_Lock);
+        m_ReadPos = readPos + frameCount;
+    }
+    return frameCount;
+}
+
+void AudioStreamBuffer::SkipFrames(int inFrameCount)
+{
+    m_SkipFrames += inFrameCount;
+    m_NumUnderruns.Increment();
+}
+
+bool AudioStreamBuffer::IsReady() const
+{
+    SpinLockGuard guard(m_Lock);
+    return m_IsReady;
+}
+
+bool AudioStreamBuffer::IsEnded() const
+{
+    SpinLockGuard guard(m_Lock);
+    return m_IsEnded;
+}
+
+int AudioStreamBuffer::GetBufferedFrames() const
+{
+    SpinLockGuard guard(m_Lock);
+    return m_WritePos - m_ReadPos;
+}
+
+int AudioStreamBuffer::GetFreeFrames() const
+{
+    return m_Capacity - (m_WritePos - m_ReadPos);
+}
+
+int AudioStreamBuffer::Decode(int inMaxFrames)
+{
+    int seekFrame;
+    int generation;
+    uint32_t writePos;
+    int framesToDecode;
+    {
+        SpinLockGuard guard(m_Lock);
+        seekFrame = m_SeekFrame;
+        m_SeekFrame = -1;
+        generation = m_Generation;
+        writePos = m_WritePos;
+        framesToDecode = Math::Min(GetFreeFrames(), inMaxFrames);
+    }
+
+    if (seekFrame >= 0)
+    {
+        m_Decoder->SeekToFrame(seekFrame);
+        m_DecoderEnded = false;
+    }
+
+    int decoded = 0;
+    bool bLooped = false;
+    while (!m_DecoderEnded && decoded < framesToDecode)
+    {
+        uint32_t offset = (writePos + decoded) & (m_Capacity - 1);
+        int count = Math::Min<int>(framesToDecode - decoded, m_Capacity - offset);
+
+        int framesRead = m_Decoder->ReadFrames(m_Frames.ToPtr() + offset * m_Stride, count, count * m_Stride);
+        decoded += framesRead;
+
+        if (framesRead > 0)
+            bLooped = false;
+
+        if (framesRead < count)
+        {
+            // Continue from the loop start without waiting for the mixer. Stop if the loop is empty.
+            if (m_LoopStart >= 0 && !bLooped)
+            {
+                m_Decoder->SeekToFrame(m_LoopStart);
+                bLooped = true;
+            }
+            else
+            {
+                m_DecoderEnded = true;
+            }
+        }
+    }
+
+    {
+        SpinLockGuard guard(m_Lock);
+
+        // The frames are dropped if the stream was seeked while decoding
+        if (generation == m_Generation)
+        {
+            m_WritePos = writePos + decoded;
+            m_IsEnded = m_DecoderEnded;
+            m_IsReady = true;
+        }
+    }
+    return decoded;
+}
+
+AudioStreamer::AudioStreamer(int inNumThreads)
+{
+    m_NumThreads = Math::Clamp(inNumThreads, 1, MAX_THREADS);
+
+    for (int i = 0; i < m_NumThreads; i++)
+    {
+        m_Threads[i] = Thread(
+            [this](int threadId)
+            {
+                _HK_PROFILER_THREAD("Audio Streamer");
+                ThreadRoutine(threadId);
+            },
+            i);
+    }
+}
+
+AudioStreamer::~AudioStreamer()
+{
+    m_IsTerminated.Store(true);
+    Notify();
+
+    for (int i = 0; i < m_NumThreads; i++)
+        m_Threads[i].Join();
+}
+
+void AudioStreamer::AddStream(AudioStreamBuffer* inStream)
+{
+    {
+        MutexGuard guard(m_Lock);
+        m_Streams.Add(Ref<AudioStreamBuffer>(inStream));
+        m_NumStreams.Store(m_Streams.Size());
+    }
+    Notify();
+}
+
+void AudioStreamer::RemoveStream(AudioStreamBuffer* inStream)
+{
+    MutexGuard guard(m_Lock);
+    for (int i = 0; i < m_Streams.Size(); i++)
+    {
+        if (m_Streams[i] == inStream)
+        {
+            m_Streams.RemoveUnsorted(i);
+            break;
+        }
+    }
+    m_NumStreams.Store(m_Streams.Size());
+}
+
+void AudioStreamer::Notify()
+{
+    for (int i = 0; i < m_NumThreads; i++)
+        m_Events[i].Signal();
+}
+
+Ref<AudioStreamBuffer> AudioStreamer::AcquireStream()
+{
+    MutexGuard guard(m_Lock);
+
+    AudioStreamBuffer* best = nullptr;
+    float bestFill = 1.0f;
+
+    for (auto& stream : m_Streams)
+    {
+        if (stream->m_IsDecoding.Load())
+            continue;
+
+        float fill;
+        {
+            SpinLockGuard streamGuard(stream->m_Lock);
+
+            if (stream->m_SeekFrame >= 0)
+            {
+                // Seeked streams are waiting to start the playback
+                fill = -1.0f;
+            }
+            else
+            {
+                int freeFrames = stream->GetFreeFrames();
+                if (stream->m_IsEnded || freeFrames < Math::Min(DecodeChunkFrames, stream->m_Capacity / 4))
+                    continue;
+                fill = 1.0f - float(freeFrames) / stream->m_Capacity;
+            }
+        }
+
+        if (!best || fill < bestFill)
+        {
+            best = stream.RawPtr();
+            bestFill = fill;
+        }
+    }
+
+    if (best)
+        best->m_IsDecoding.Store(true);
+
+    return Ref<AudioStreamBuffer>(best);
+}
+
+void AudioStreamer::ThreadRoutine(int inThreadId)
+{
+    while (!m_IsTerminated.Load())
+    {
+        Ref<AudioStreamBuffer> stream = AcquireStream();
+        if (!stream)
+        {
+            bool timedOut;
+            m_Events[inThreadId].WaitTimeout(IdleTimeoutMs, timedOut);
+            continue;
+        }
+
+        stream->Decode(DecodeChunkFrames);
+        stream->m_IsDecoding.Store(false);
+    }
+}
+
+HK_NAMESPACE_END
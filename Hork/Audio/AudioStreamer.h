@@ -0,0 +1,144 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "AudioDecoder.h"
+
+#include <Hork/Core/Thread.h>
+#include <Hork/Core/Containers/Vector.h>
+
+HK_NAMESPACE_BEGIN
+
+/// Ring buffer of decoded frames for an encoded track. Filled ahead of the playback position by AudioStreamer,
+/// so the mixer only copies frames from memory.
+class AudioStreamBuffer final : public InterlockedRef
+{
+public:
+                        AudioStreamBuffer(AudioSource* inSource, int inLoopStart);
+
+    /// Restarts decoding from the frame and drops buffered frames. Called by mixer thread.
+    void                SeekToFrame(int inFrameNum);
+
+    /// Reads buffered frames. Returns less frames than requested on underrun or at the end of the stream.
+    /// Called by mixer thread.
+    int                 ReadFrames(void* outFrames, int inFrameCount);
+
+    /// Skips frames that are not decoded yet to keep the stream in sync with the playback position after underrun.
+    /// Called by mixer thread.
+    void                SkipFrames(int inFrameCount);
+
+    /// The first frames after seek are decoded
+    bool                IsReady() const;
+
+    /// All frames of the stream are decoded
+    bool                IsEnded() const;
+
+    /// Number of decoded frames ready to read
+    int                 GetBufferedFrames() const;
+
+    /// Ring buffer size in frames
+    int                 GetCapacity() const { return m_Capacity; }
+
+    /// Number of underruns of the stream
+    int                 GetNumUnderruns() const { return m_NumUnderruns.Load(); }
+
+private:
+    friend class AudioStreamer;
+
+    // Decodes frames to the ring buffer. Called by one streamer thread at a time.
+    int                 Decode(int inMaxFrames);
+
+    // Free space in the ring buffer in frames
+    int                 GetFreeFrames() const;
+
+    Ref<AudioDecoder>   m_Decoder;
+    Vector<uint8_t>     m_Frames;
+    int                 m_Capacity;
+    int                 m_Stride;
+    int                 m_LoopStart;
+
+    // Protects the positions and seek requests
+    mutable SpinLock    m_Lock;
+    uint32_t            m_ReadPos = 0;
+    uint32_t            m_WritePos = 0;
+    int                 m_SeekFrame = -1;
+    int                 m_Generation = 0;
+    bool                m_IsReady = false;
+    bool                m_IsEnded = true;
+
+    // Used only by mixer thread
+    int                 m_SkipFrames = 0;
+
+    // Used only by streamer thread that owns the stream
+    bool                m_DecoderEnded = true;
+
+    // Stream is decoded by one of the streamer threads
+    AtomicBool          m_IsDecoding{false};
+
+    AtomicInt           m_NumUnderruns{0};
+};
+
+/// Background service that keeps ring buffers of the streamed tracks filled ahead of the playback.
+/// Number of threads is the budget of concurrent decodes, the most starved streams are decoded first.
+class AudioStreamer final : public Noncopyable
+{
+public:
+    static constexpr int MAX_THREADS = 4;
+
+                        AudioStreamer(int inNumThreads);
+                        ~AudioStreamer();
+
+    /// Called by mixer thread
+    void                AddStream(AudioStreamBuffer* inStream);
+
+    /// Called by mixer thread
+    void                RemoveStream(AudioStreamBuffer* inStream);
+
+    /// Wakes up decoding threads. Called after the streams are read or seeked.
+    void                Notify();
+
+    int                 GetNumStreams() const { return m_NumStreams.Load(); }
+
+private:
+    void                ThreadRoutine(int inThreadId);
+    Ref<AudioStreamBuffer> AcquireStream();
+
+    Mutex               m_Lock;
+    Vector<Ref<AudioStreamBuffer>> m_Streams;
+    AtomicInt           m_NumStreams{0};
+
+    Thread              m_Threads[MAX_THREADS];
+    SyncEvent           m_Events[MAX_THREADS];
+    int                 m_NumThreads;
+    AtomicBool          m_IsTerminated{false};
+};
+
+HK_NAMESPACE_END
@@ -40,7 +40,7 @@ AudioTrack::AudioTrack(AudioSource* inSource, int inStartFrame, int inLoopStart,
 {
     pSource = inSource;
     if (inSource->IsEncoded())
-        pDecoder = MakeRef<AudioDecoder>(inSource);
+        pStream = MakeRef<AudioStreamBuffer>(inSource, inLoopStart);
 
     FrameCount = inSource->GetFrameCount();
     Channels = inSource->GetChannels();
@@ -59,6 +59,8 @@ AudioTrack::AudioTrack(AudioSource* inSource, int inStartFrame, int inLoopStart,
     bVirtual = false;
     bPaused_LOCK = false;
     bSpatializedStereo_LOCK = false;
+    bCulled_LOCK = false;
+    VoiceAge = 0;
     Next = nullptr;
     Prev = nullptr;
 }
@@ -73,6 +75,12 @@ void AudioTrack::SetPlaybackParameters(const int inVolume[2], Float3 const& inLo
     bPaused_LOCK = inPaused;
 }
 
+void AudioTrack::SetCulled(bool inCulled)
+{
+    SpinLockGuard guard(Lock);
+    bCulled_LOCK = inCulled;
+}
+
 void AudioTrack::SetPlaybackPosition(int inPosition)
 {
     SpinLockGuard guard(Lock);
@@ -30,7 +30,7 @@ SOFTWARE.
 
 #pragma once
 
-#include "AudioDecoder.h"
+#include "AudioStreamer.h"
 
 #include <Hork/Math/VectorMath.h>
 #include <Hork/Core/Allocators/PoolAllocator.h>
@@ -48,8 +48,8 @@ struct AudioTrack final : public Noncopyable
     /// Audio source. Read only
     Ref<AudioSource> pSource;
 
-    /// Interface for audio decoding. Read only
-    Ref<AudioDecoder> pDecoder;
+    /// Frames of encoded audio decoded ahead of the playback. Read only
+    Ref<AudioStreamBuffer> pStream;
 
     /// Playback position in frames.
     /// Read only for main thread. Modified by mixer thread.
@@ -98,6 +98,13 @@ struct AudioTrack final : public Noncopyable
     /// If track is has stereo samples, it will be combined to mono and spatialized for 3D
     bool bSpatializedStereo_LOCK : 1;
 
+    /// The track is over the real voice budget. The mixer fades it out and keeps it virtual.
+    bool bCulled_LOCK;
+
+    /// Number of voice manager updates the track has been playing for.
+    /// Only used by main thread (RW).
+    uint32_t VoiceAge;
+
     /// The stop signal. It's setted by mixer thread. If it's true, main thread should reject to use this track and remove it.
     AtomicBool Stopped;
 
@@ -163,6 +170,9 @@ public:
     /// Update parameters. Called from main thread.
     void SetPlaybackParameters(const int inVolume[2], Float3 const& inLocalDir, bool inSpatializedStereo, bool inPaused);
 
+    /// Cull the track by the voice budget or bring it back. Called from main thread.
+    void SetCulled(bool inCulled);
+
     /// Change playback position. Called from main thread.
     void SetPlaybackPosition(int inPosition);
 
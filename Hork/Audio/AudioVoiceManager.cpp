@@ -0,0 +1,103 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "AudioVoiceManager.h"
+
+HK_NAMESPACE_BEGIN
+
+ConsoleVar Snd_MaxVoices("Snd_MaxVoices"_s, "0"_s, 0, "Maximum number of mixed tracks. Other tracks are virtualized. 0 - unlimited"_s);
+
+namespace
+{
+    // Real voices keep playing until other voices are noticeably louder
+    constexpr float RealVoiceBias = 1.25f;
+}
+
+void AudioVoiceManager::Clear()
+{
+    m_Voices.Clear();
+}
+
+void AudioVoiceManager::AddVoice(AudioTrack* track, uint8_t priority, const int volume[2])
+{
+    int maxVolume = Math::Max(volume[0], volume[1]);
+
+    // Silent tracks are virtualized or stopped by the mixer and don't take a voice
+    if (maxVolume <= 0)
+    {
+        track->VoiceAge = 0;
+        if (track->bCulled_LOCK)
+            track->SetCulled(false);
+        return;
+    }
+
+    Voice& voice = m_Voices.EmplaceBack();
+    voice.Track = track;
+    voice.Audibility = maxVolume * (1.0f / 65535.0f);
+    if (!track->bCulled_LOCK && track->VoiceAge > 0)
+        voice.Audibility *= RealVoiceBias;
+    voice.Age = track->VoiceAge++;
+    voice.Priority = priority;
+}
+
+void AudioVoiceManager::Update()
+{
+    int budget = Snd_MaxVoices.GetInteger();
+    if (budget <= 0)
+        budget = m_Voices.Size();
+
+    if (budget < m_Voices.Size())
+    {
+        std::sort(m_Voices.Begin(), m_Voices.End(), [](Voice const& a, Voice const& b)
+        {
+            if (a.Priority != b.Priority)
+                return a.Priority > b.Priority;
+            if (a.Audibility != b.Audibility)
+                return a.Audibility > b.Audibility;
+            return a.Age > b.Age;
+        });
+    }
+    else
+        budget = m_Voices.Size();
+
+    // The track flag is only written from the main thread, so it can be read without lock
+    for (int i = 0; i < m_Voices.Size(); i++)
+    {
+        AudioTrack* track = m_Voices[i].Track;
+        bool culled = i >= budget;
+        if (track->bCulled_LOCK != culled)
+            track->SetCulled(culled);
+    }
+
+    m_NumRealVoices = budget;
+    m_NumVirtualVoices = m_Voices.Size() - budget;
+}
+
+HK_NAMESPACE_END
@@ -0,0 +1,78 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "AudioTrack.h"
+
+#include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/ConsoleVar.h>
+
+HK_NAMESPACE_BEGIN
+
+/// Limits the number of tracks that are really decoded and mixed. Audible tracks are collected every frame,
+/// ranked by priority, audibility and age, and the tracks below the budget are culled: the mixer fades them out
+/// and keeps them virtual, so their playback position is still advanced and they come back in sync.
+/// The application owns one manager for all worlds, so the budget is global.
+class AudioVoiceManager final : public Noncopyable
+{
+public:
+    /// Begin collecting voices for the frame
+    void                Clear();
+
+    /// Add playing track. Volume is the spatialized volume passed to the track in range [0, 65535].
+    void                AddVoice(AudioTrack* track, uint8_t priority, const int volume[2]);
+
+    /// Rank collected voices and cull the voices over the budget
+    void                Update();
+
+    /// Number of voices that are mixed
+    int                 GetNumRealVoices() const { return m_NumRealVoices; }
+
+    /// Number of voices culled by the budget
+    int                 GetNumVirtualVoices() const { return m_NumVirtualVoices; }
+
+private:
+    struct Voice
+    {
+        AudioTrack*     Track;
+        float           Audibility;
+        uint32_t        Age;
+        uint8_t         Priority;
+    };
+
+    Vector<Voice>       m_Voices;
+    int                 m_NumRealVoices = 0;
+    int                 m_NumVirtualVoices = 0;
+};
+
+extern ConsoleVar Snd_MaxVoices;
+
+HK_NAMESPACE_END
@@ -118,8 +118,7 @@ AudioHRTF::AudioHRTF(int SampleRate)
 #ifdef FILTER_SIZE_POW2
         m_FilterSize = Math::ToGreaterPowerOfTwo(m_FilterSize);
 #endif
-        m_ForwardFFT = mufft_create_plan_1d_c2c(m_FilterSize, MUFFT_FORWARD, 0);
-        m_InverseFFT = mufft_create_plan_1d_c2c(m_FilterSize, MUFFT_INVERSE, 0);
+        m_Workspace = MakeUnique<HRTFWorkspace>(m_FilterSize);
 
         m_hrtfL.Resize(vertexCount * m_FilterSize);
         m_hrtfR.Resize(vertexCount * m_FilterSize);
@@ -160,8 +159,7 @@ AudioHRTF::AudioHRTF(int SampleRate)
 #ifdef FILTER_SIZE_POW2
         m_FilterSize = Math::ToGreaterPowerOfTwo(m_FilterSize);
 #endif
-        m_ForwardFFT = mufft_create_plan_1d_c2c(m_FilterSize, MUFFT_FORWARD, 0);
-        m_InverseFFT = mufft_create_plan_1d_c2c(m_FilterSize, MUFFT_INVERSE, 0);
+        m_Workspace = MakeUnique<HRTFWorkspace>(m_FilterSize);
 
         m_hrtfL.Resize(vertexCount * m_FilterSize);
         m_hrtfR.Resize(vertexCount * m_FilterSize);
@@ -203,20 +201,32 @@ AudioHRTF::AudioHRTF(int SampleRate)
         ma_resampler_uninit(&resampler);
     }
 
-    m_pFramesSourceFFT = (Complex*)mufft_calloc(m_FilterSize * sizeof(Complex));
-    m_pFramesFreqFFT = (Complex*)mufft_alloc(m_FilterSize * sizeof(Complex));
-    m_pFramesFreqLeftFFT = (Complex*)mufft_alloc(m_FilterSize * sizeof(Complex));
-    m_pFramesFreqRightFFT = (Complex*)mufft_alloc(m_FilterSize * sizeof(Complex));
-    m_pFramesTimeLeftFFT = (Complex*)mufft_alloc(m_FilterSize * sizeof(Complex));
-    m_pFramesTimeRightFFT = (Complex*)mufft_alloc(m_FilterSize * sizeof(Complex));
+    CreateLookup();
+}
+
+AudioHRTF::~AudioHRTF()
+{
+}
+
+HRTFWorkspace::HRTFWorkspace(int FilterSize)
+{
+    m_ForwardFFT = mufft_create_plan_1d_c2c(FilterSize, MUFFT_FORWARD, 0);
+    m_InverseFFT = mufft_create_plan_1d_c2c(FilterSize, MUFFT_INVERSE, 0);
+
+    m_pFramesSourceFFT = (Complex*)mufft_calloc(FilterSize * sizeof(Complex));
+    m_pFramesFreqFFT = (Complex*)mufft_alloc(FilterSize * sizeof(Complex));
+    m_pFramesFreqLeftFFT = (Complex*)mufft_alloc(FilterSize * sizeof(Complex));
+    m_pFramesFreqRightFFT = (Complex*)mufft_alloc(FilterSize * sizeof(Complex));
+    m_pFramesTimeLeftFFT = (Complex*)mufft_alloc(FilterSize * sizeof(Complex));
+    m_pFramesTimeRightFFT = (Complex*)mufft_alloc(FilterSize * sizeof(Complex));
 
     for (int i = 0; i < 4; i++)
     {
-        m_pHRTFs[i] = (Complex*)mufft_alloc(sizeof(Complex) * m_FilterSize);
+        m_pHRTFs[i] = (Complex*)mufft_alloc(sizeof(Complex) * FilterSize);
     }
 }
 
-AudioHRTF::~AudioHRTF()
+HRTFWorkspace::~HRTFWorkspace()
 {
     for (int i = 0; i < 4; i++)
     {
@@ -234,14 +244,14 @@ AudioHRTF::~AudioHRTF()
     mufft_free_plan_1d((mufft_plan_1d*)m_InverseFFT);
 }
 
-void AudioHRTF::FFT(Complex const* pIn, Complex* pOut)
+void AudioHRTF::sFFT(HRTFWorkspace& Workspace, Complex const* pIn, Complex* pOut)
 {
-    mufft_execute_plan_1d((mufft_plan_1d*)m_ForwardFFT, pOut, pIn);
+    mufft_execute_plan_1d((mufft_plan_1d*)Workspace.m_ForwardFFT, pOut, pIn);
 }
 
-void AudioHRTF::IFFT(Complex const* pIn, Complex* pOut)
+void AudioHRTF::sIFFT(HRTFWorkspace& Workspace, Complex const* pIn, Complex* pOut)
 {
-    mufft_execute_plan_1d((mufft_plan_1d*)m_InverseFFT, pOut, pIn);
+    mufft_execute_plan_1d((mufft_plan_1d*)Workspace.m_InverseFFT, pOut, pIn);
 }
 
 void AudioHRTF::GenerateHRTF(const float* pFrames, int InFrameCount, Complex* pHRTF)
@@ -263,7 +273,7 @@ void AudioHRTF::GenerateHRTF(const float* pFrames, int InFrameCount, Complex* pH
         hrirComplex[i].I = 0;
     }
 
-    FFT(hrirComplex, temp);
+    sFFT(*m_Workspace, hrirComplex, temp);
 
     Core::Memcpy(pHRTF, temp, sizeof(Complex) * m_FilterSize);
 
@@ -271,54 +281,170 @@ void AudioHRTF::GenerateHRTF(const float* pFrames, int InFrameCount, Complex* pH
     mufft_free(hrirComplex);
 }
 
-void AudioHRTF::SampleHRTF(Float3 const& Dir, Complex* pLeftHRTF, Complex* pRightHRTF) const
+namespace
 {
-    // TODO: optimize: create sphere with regular grid. Find sphere segment by azimuth and pitch. Perform raycast between two triangles of the segment.
+    // Cube face coordinates. Face 2*axis is the positive axis direction, face 2*axis+1 is the negative one.
+    HK_FORCEINLINE Float3 CubeFacePoint(int face, float u, float v)
+    {
+        int axis = face >> 1;
+        Float3 p;
+        p[axis] = (face & 1) ? -1.0f : 1.0f;
+        p[(axis + 1) % 3] = u;
+        p[(axis + 2) % 3] = v;
+        return p;
+    }
 
-    float d, u, v;
+    HK_FORCEINLINE float AngleBetween(Float3 const& a, Float3 const& b)
+    {
+        return std::acos(Math::Clamp(Math::Dot(a, b), -1.0f, 1.0f));
+    }
+}
 
-    for (int i = 0; i < m_Indices.Size(); i += 3)
+void AudioHRTF::CreateLookup()
+{
+    const int numTriangles = m_Indices.Size() / 3;
+    const int numCells = 6 * LookupResolution * LookupResolution;
+
+    // Bounding cone of each triangle
+    Vector<Float3> coneAxis;
+    Vector<float> coneAngle;
+    coneAxis.ResizeInvalidate(numTriangles);
+    coneAngle.ResizeInvalidate(numTriangles);
+    for (int t = 0; t < numTriangles; t++)
     {
-        uint32_t index0 = m_Indices[i + 0];
-        uint32_t index1 = m_Indices[i + 1];
-        uint32_t index2 = m_Indices[i + 2];
+        Float3 a = m_Vertices[m_Indices[t * 3 + 0]].Normalized();
+        Float3 b = m_Vertices[m_Indices[t * 3 + 1]].Normalized();
+        Float3 c = m_Vertices[m_Indices[t * 3 + 2]].Normalized();
+
+        coneAxis[t] = (a + b + c).Normalized();
+        coneAngle[t] = Math::Max(AngleBetween(coneAxis[t], a), Math::Max(AngleBetween(coneAxis[t], b), AngleBetween(coneAxis[t], c)));
+    }
 
-        Float3 const& a = m_Vertices[index0];
-        Float3 const& b = m_Vertices[index1];
-        Float3 const& c = m_Vertices[index2];
+    m_LookupOffsets.ResizeInvalidate(numCells + 1);
+    m_LookupTriangles.Clear();
 
-        if (BvRayIntersectTriangle(Float3(0.0f), Dir, a, b, c, d, u, v))
+    const float cellSize = 2.0f / LookupResolution;
+    const float epsilon = 0.01f;
+
+    for (int face = 0, cell = 0; face < 6; face++)
+    {
+        for (int y = 0; y < LookupResolution; y++)
         {
-            float w = 1.0f - u - v;
+            for (int x = 0; x < LookupResolution; x++, cell++)
+            {
+                float u0 = -1.0f + x * cellSize;
+                float v0 = -1.0f + y * cellSize;
+
+                Float3 center = CubeFacePoint(face, u0 + cellSize * 0.5f, v0 + cellSize * 0.5f).Normalized();
+
+                float cellAngle = 0;
+                for (int corner = 0; corner < 4; corner++)
+                {
+                    Float3 p = CubeFacePoint(face, u0 + (corner & 1) * cellSize, v0 + (corner >> 1) * cellSize).Normalized();
+                    cellAngle = Math::Max(cellAngle, AngleBetween(center, p));
+                }
+
+                // A direction from the cell can hit the triangle only if their bounding cones intersect
+                m_LookupOffsets[cell] = m_LookupTriangles.Size();
+                for (int t = 0; t < numTriangles; t++)
+                {
+                    if (AngleBetween(center, coneAxis[t]) <= cellAngle + coneAngle[t] + epsilon)
+                        m_LookupTriangles.Add(t * 3);
+                }
+            }
+        }
+    }
+    m_LookupOffsets[numCells] = m_LookupTriangles.Size();
+}
 
-            if (w < 0.0f) w = 0.0f; // fix rounding issues
+int AudioHRTF::FindTriangle(Float3 const& Dir, float& U, float& V) const
+{
+    Float3 absDir = Dir.Abs();
+    int axis = absDir.X >= absDir.Y ? (absDir.X >= absDir.Z ? 0 : 2) : (absDir.Y >= absDir.Z ? 1 : 2);
+    if (absDir[axis] == 0.0f)
+        return -1;
 
-            Complex const* a_left = m_hrtfL.ToPtr() + index0 * m_FilterSize;
-            Complex const* a_right = m_hrtfR.ToPtr() + index0 * m_FilterSize;
+    int face = axis * 2 + (Dir[axis] < 0.0f ? 1 : 0);
+    float scale = 0.5f * LookupResolution / absDir[axis];
 
-            Complex const* b_left = m_hrtfL.ToPtr() + index1 * m_FilterSize;
-            Complex const* b_right = m_hrtfR.ToPtr() + index1 * m_FilterSize;
+    int x = Math::Clamp(int((Dir[(axis + 1) % 3] + absDir[axis]) * scale), 0, LookupResolution - 1);
+    int y = Math::Clamp(int((Dir[(axis + 2) % 3] + absDir[axis]) * scale), 0, LookupResolution - 1);
+    int cell = (face * LookupResolution + y) * LookupResolution + x;
 
-            Complex const* c_left = m_hrtfL.ToPtr() + index2 * m_FilterSize;
-            Complex const* c_right = m_hrtfR.ToPtr() + index2 * m_FilterSize;
+    float d;
+    for (uint32_t n = m_LookupOffsets[cell], end = m_LookupOffsets[cell + 1]; n < end; n++)
+    {
+        uint32_t i = m_LookupTriangles[n];
+        if (BvRayIntersectTriangle(Float3(0.0f), Dir, m_Vertices[m_Indices[i]], m_Vertices[m_Indices[i + 1]], m_Vertices[m_Indices[i + 2]], d, U, V))
+            return i;
+    }
 
-            for (int n = 0; n < m_FilterSize; n++)
-            {
-                pLeftHRTF[n].R = a_left[n].R * u + b_left[n].R * v + c_left[n].R * w;
-                pLeftHRTF[n].I = a_left[n].I * u + b_left[n].I * v + c_left[n].I * w;
-                pRightHRTF[n].R = a_right[n].R * u + b_right[n].R * v + c_right[n].R * w;
-                pRightHRTF[n].I = a_right[n].I * u + b_right[n].I * v + c_right[n].I * w;
-            }
+    // Directions exactly on the triangle edges may be missed by all candidates due to rounding
+    return FindTriangleBruteForce(Dir, U, V);
+}
 
-            return;
-        }
+int AudioHRTF::FindTriangleBruteForce(Float3 const& Dir, float& U, float& V) const
+{
+    float d;
+    for (int i = 0; i < m_Indices.Size(); i += 3)
+    {
+        if (BvRayIntersectTriangle(Float3(0.0f), Dir, m_Vertices[m_Indices[i]], m_Vertices[m_Indices[i + 1]], m_Vertices[m_Indices[i + 2]], d, U, V))
+            return i;
     }
+    return -1;
+}
+
+void AudioHRTF::SampleHRTF(Float3 const& Dir, Complex* pLeftHRTF, Complex* pRightHRTF) const
+{
+    float u, v;
+
+    int i = FindTriangle(Dir, u, v);
+    if (i < 0)
+    {
+        Core::ZeroMem(pLeftHRTF, m_FilterSize * sizeof(Complex));
+        Core::ZeroMem(pRightHRTF, m_FilterSize * sizeof(Complex));
+        return;
+    }
+
+    uint32_t index0 = m_Indices[i + 0];
+    uint32_t index1 = m_Indices[i + 1];
+    uint32_t index2 = m_Indices[i + 2];
+
+    float w = 1.0f - u - v;
 
-    Core::ZeroMem(pLeftHRTF, m_FilterSize * sizeof(Complex));
-    Core::ZeroMem(pRightHRTF, m_FilterSize * sizeof(Complex));
+    if (w < 0.0f) w = 0.0f; // fix rounding issues
+
+    Complex const* a_left = m_hrtfL.ToPtr() + index0 * m_FilterSize;
+    Complex const* a_right = m_hrtfR.ToPtr() + index0 * m_FilterSize;
+
+    Complex const* b_left = m_hrtfL.ToPtr() + index1 * m_FilterSize;
+    Complex const* b_right = m_hrtfR.ToPtr() + index1 * m_FilterSize;
+
+    Complex const* c_left = m_hrtfL.ToPtr() + index2 * m_FilterSize;
+    Complex const* c_right = m_hrtfR.ToPtr() + index2 * m_FilterSize;
+
+    for (int n = 0; n < m_FilterSize; n++)
+    {
+        pLeftHRTF[n].R = a_left[n].R * u + b_left[n].R * v + c_left[n].R * w;
+        pLeftHRTF[n].I = a_left[n].I * u + b_left[n].I * v + c_left[n].I * w;
+        pRightHRTF[n].R = a_right[n].R * u + b_right[n].R * v + c_right[n].R * w;
+        pRightHRTF[n].I = a_right[n].I * u + b_right[n].I * v + c_right[n].I * w;
+    }
 }
 
 void AudioHRTF::ApplyHRTF(Float3 const& CurDir, Float3 const& NewDir, const float* pFrames, int InFrameCount, float* pStream, Float3& Dir)
+{
+    ApplyHRTF(*m_Workspace, CurDir, NewDir, pFrames, InFrameCount, pStream, Dir);
+}
+
+Float3 AudioHRTF::sGetResultDir(Float3 const& CurDir, Float3 const& NewDir)
+{
+    // The last block of ApplyHRTF is interpolated to the normalized new direction
+    bool bNoLerp = CurDir.LengthSqr() < 0.1f || !Snd_LerpHRTF;
+    return bNoLerp ? NewDir : NewDir.Normalized();
+}
+
+void AudioHRTF::ApplyHRTF(HRTFWorkspace& Workspace, Float3 const& CurDir, Float3 const& NewDir, const float* pFrames, int InFrameCount, float* pStream, Float3& Dir) const
 {
     HK_ASSERT(InFrameCount > 0);
     HK_ASSERT((InFrameCount % HRTF_BLOCK_LENGTH) == 0);
@@ -327,14 +453,21 @@ void AudioHRTF::ApplyHRTF(Float3 const& CurDir, Float3 const& NewDir, const floa
     const int hrtfLen = m_FrameCount - 1;
 
     Complex* filterL[2] = {
-        m_pHRTFs[0],
-        m_pHRTFs[1]};
+        Workspace.m_pHRTFs[0],
+        Workspace.m_pHRTFs[1]};
     Complex* filterR[2] = {
-        m_pHRTFs[2],
-        m_pHRTFs[3]};
+        Workspace.m_pHRTFs[2],
+        Workspace.m_pHRTFs[3]};
+
+    Complex* pFramesSourceFFT = Workspace.m_pFramesSourceFFT;
+    Complex* pFramesFreqFFT = Workspace.m_pFramesFreqFFT;
+    Complex* pFramesFreqLeftFFT = Workspace.m_pFramesFreqLeftFFT;
+    Complex* pFramesFreqRightFFT = Workspace.m_pFramesFreqRightFFT;
+    Complex* pFramesTimeLeftFFT = Workspace.m_pFramesTimeLeftFFT;
+    Complex* pFramesTimeRightFFT = Workspace.m_pFramesTimeRightFFT;
 
-    Complex* pFramesLeft = m_pFramesTimeLeftFFT + hrtfLen;
-    Complex* pFramesRight = m_pFramesTimeRightFFT + hrtfLen;
+    Complex* pFramesLeft = pFramesTimeLeftFFT + hrtfLen;
+    Complex* pFramesRight = pFramesTimeRightFFT + hrtfLen;
 
     int curIndex = 1;
     int newIndex = 0;
@@ -349,34 +482,34 @@ void AudioHRTF::ApplyHRTF(Float3 const& CurDir, Float3 const& NewDir, const floa
 
     for (int blockNum = 0; blockNum < numBlocks; blockNum++)
     {
-        // Copy frames to m_pFramesSourceFFT
+        // Copy frames to pFramesSourceFFT
         int n = 0, frameNum = 0;
         while (n < hrtfLen)
         {
             // Restore previous frames from channel
-            m_pFramesSourceFFT[n].R = history[n];
+            pFramesSourceFFT[n].R = history[n];
             n++;
         }
         while (frameNum < HRTF_BLOCK_LENGTH)
         {
-            m_pFramesSourceFFT[n].R = frames[frameNum];
+            pFramesSourceFFT[n].R = frames[frameNum];
             frameNum++;
             n++;
         }
 
         // Perform FFT on source frames
-        FFT(m_pFramesSourceFFT, m_pFramesFreqFFT);
+        sFFT(Workspace, pFramesSourceFFT, pFramesFreqFFT);
 
         // Apply HRTF
         for (n = 0; n < m_FilterSize; n++)
         {
-            m_pFramesFreqLeftFFT[n] = m_pFramesFreqFFT[n] * filterL[curIndex][n];
-            m_pFramesFreqRightFFT[n] = m_pFramesFreqFFT[n] * filterR[curIndex][n];
+            pFramesFreqLeftFFT[n] = pFramesFreqFFT[n] * filterL[curIndex][n];
+            pFramesFreqRightFFT[n] = pFramesFreqFFT[n] * filterR[curIndex][n];
         }
 
         // Perform inverse FFT to convert result in time domain
-        IFFT(m_pFramesFreqLeftFFT, m_pFramesTimeLeftFFT);
-        IFFT(m_pFramesFreqRightFFT, m_pFramesTimeRightFFT);
+        sIFFT(Workspace, pFramesFreqLeftFFT, pFramesTimeLeftFFT);
+        sIFFT(Workspace, pFramesFreqRightFFT, pFramesTimeRightFFT);
 
         float* blockStart = pStream;
 
@@ -398,13 +531,13 @@ void AudioHRTF::ApplyHRTF(Float3 const& CurDir, Float3 const& NewDir, const floa
             // Apply HRTF
             for (n = 0; n < m_FilterSize; n++)
             {
-                m_pFramesFreqLeftFFT[n] = m_pFramesFreqFFT[n] * filterL[newIndex][n];
-                m_pFramesFreqRightFFT[n] = m_pFramesFreqFFT[n] * filterR[newIndex][n];
+                pFramesFreqLeftFFT[n] = pFramesFreqFFT[n] * filterL[newIndex][n];
+                pFramesFreqRightFFT[n] = pFramesFreqFFT[n] * filterR[newIndex][n];
             }
 
             // Perform inverse FFT to convert result in time domain
-            IFFT(m_pFramesFreqLeftFFT, m_pFramesTimeLeftFFT);
-            IFFT(m_pFramesFreqRightFFT, m_pFramesTimeRightFFT);
+            sIFFT(Workspace, pFramesFreqLeftFFT, pFramesTimeLeftFFT);
+            sIFFT(Workspace, pFramesFreqRightFFT, pFramesTimeRightFFT);
 
             pStream = blockStart;
 
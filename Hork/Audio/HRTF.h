@@ -33,11 +33,42 @@ SOFTWARE.
 #include <Hork/Math/VectorMath.h>
 #include <Hork/Math/Complex.h>
 #include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/Ref.h>
 
 HK_NAMESPACE_BEGIN
 
 constexpr int HRTF_BLOCK_LENGTH = 128; // Keep it to a power of two
 
+/// FFT plans and scratch buffers used by AudioHRTF::ApplyHRTF. The FFT plans keep internal state,
+/// so each thread that applies HRTF must have its own workspace.
+class HRTFWorkspace final : public Noncopyable
+{
+public:
+    HRTFWorkspace(int FilterSize);
+    ~HRTFWorkspace();
+
+private:
+    friend class AudioHRTF;
+
+    void* m_ForwardFFT = nullptr;
+    void* m_InverseFFT = nullptr;
+
+    // Storage for processing frames, time domain
+    Complex* m_pFramesSourceFFT = nullptr;
+    // Processing frames, freq domain
+    Complex* m_pFramesFreqFFT = nullptr;
+    // Frames for left ear, freq domain
+    Complex* m_pFramesFreqLeftFFT = nullptr;
+    // Frames for right ear, freq domain
+    Complex* m_pFramesFreqRightFFT = nullptr;
+    // Frames for left ear, time domain
+    Complex* m_pFramesTimeLeftFFT = nullptr;
+    // Frames for right ear, time domain
+    Complex* m_pFramesTimeRightFFT = nullptr;
+
+    Complex* m_pHRTFs[4] = {nullptr, nullptr, nullptr, nullptr};
+};
+
 class AudioHRTF final : public Noncopyable
 {
 public:
@@ -47,10 +78,23 @@ public:
     /// Gets a bilinearly interpolated HRTF
     void SampleHRTF(Float3 const& Dir, Complex* pLeftHRTF, Complex* pRightHRTF) const;
 
+    /// Finds the sphere triangle hit by the direction using the direction lookup.
+    /// Returns offset of the triangle in the index buffer or -1.
+    int FindTriangle(Float3 const& Dir, float& U, float& V) const;
+
+    /// Same as FindTriangle, but tests every triangle of the sphere.
+    int FindTriangleBruteForce(Float3 const& Dir, float& U, float& V) const;
+
     /// Applies HRTF to input frames. Frames must also contain GetFrameCount()-1 of the previous frames.
     /// FrameCount must be multiples of HRTF_BLOCK_LENGTH
     void ApplyHRTF(Float3 const& CurDir, Float3 const& NewDir, const float* pFrames, int FrameCount, float* pStream, Float3& Dir);
 
+    /// Thread-safe version of ApplyHRTF. The workspace must not be used by other threads at the same time.
+    void ApplyHRTF(HRTFWorkspace& Workspace, Float3 const& CurDir, Float3 const& NewDir, const float* pFrames, int FrameCount, float* pStream, Float3& Dir) const;
+
+    /// Direction returned by ApplyHRTF. Allows to get it before the filter is applied.
+    static Float3 sGetResultDir(Float3 const& CurDir, Float3 const& NewDir);
+
     /// Sphere geometry vertics
     Vector<Float3> const& GetVertices() const { return m_Vertices; }
 
@@ -73,11 +117,14 @@ public:
 private:
     void GenerateHRTF(const float* pFrames, int InFrameCount, Complex* pHRTF);
 
+    // Build cube map of candidate triangles for direction lookup
+    void CreateLookup();
+
     // Fast fourier transform (forward)
-    void FFT(Complex const* pIn, Complex* pOut);
+    static void sFFT(HRTFWorkspace& Workspace, Complex const* pIn, Complex* pOut);
 
     // Fast fourier transform (inverse)
-    void IFFT(Complex const* pIn, Complex* pOut);
+    static void sIFFT(HRTFWorkspace& Workspace, Complex const* pIn, Complex* pOut);
 
     // Length of Head-Related Impulse Response (HRIR)
     int m_FrameCount = 0;
@@ -90,23 +137,13 @@ private:
     Vector<Complex> m_hrtfL;
     Vector<Complex> m_hrtfR;
 
-    void* m_ForwardFFT = nullptr;
-    void* m_InverseFFT = nullptr;
-
-    // Storage for processing frames, time domain
-    Complex* m_pFramesSourceFFT = nullptr;
-    // Processing frames, freq domain
-    Complex* m_pFramesFreqFFT = nullptr;
-    // Frames for left ear, freq domain
-    Complex* m_pFramesFreqLeftFFT = nullptr;
-    // Frames for right ear, freq domain
-    Complex* m_pFramesFreqRightFFT = nullptr;
-    // Frames for left ear, time domain
-    Complex* m_pFramesTimeLeftFFT = nullptr;
-    // Frames for right ear, time domain
-    Complex* m_pFramesTimeRightFFT = nullptr;
+    // Cube map of the directions. Each cell references the triangles that may be hit by directions from the cell.
+    static constexpr int LookupResolution = 16;
+    Vector<uint32_t> m_LookupOffsets;
+    Vector<uint32_t> m_LookupTriangles;
 
-    Complex* m_pHRTFs[4] = {nullptr, nullptr, nullptr, nullptr};
+    // Workspace for the single threaded ApplyHRTF
+    UniqueRef<HRTFWorkspace> m_Workspace;
 };
 
 HK_NAMESPACE_END
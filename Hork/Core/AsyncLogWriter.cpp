@@ -0,0 +1,260 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "AsyncLogWriter.h"
+#include "Platform.h"
+#include "Memory.h"
+#include "String.h"
+
+HK_NAMESPACE_BEGIN
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+    Stop();
+}
+
+void AsyncLogWriter::Start(ILogOutput* output)
+{
+    HK_ASSERT(output);
+
+    Stop();
+
+    m_Slots = static_cast<Slot*>(Core::GetHeapAllocator<HEAP_MISC>().Alloc(sizeof(Slot) * NUM_SLOTS, alignof(Slot)));
+    for (uint32_t i = 0; i < NUM_SLOTS; ++i)
+        new (&m_Slots[i]) Slot;
+    for (uint32_t i = 0; i < NUM_SLOTS; ++i)
+        m_Slots[i].Sequence.StoreRelaxed(i);
+
+    m_Head.StoreRelaxed(0);
+    m_Tail.StoreRelaxed(0);
+    m_bStop.StoreRelaxed(false);
+
+    m_Message.Reserve(SLOT_DATA_SIZE * 4);
+
+    m_Output = output;
+
+    m_WriterThread.Start([this]() { WriterThreadRoutine(); });
+
+    m_Producers.Store(0);
+}
+
+void AsyncLogWriter::Stop()
+{
+    if (!m_Output)
+        return;
+
+    // Reject new messages and wait for the threads that are already inside Push or Flush
+    m_Producers.FetchOr(STOPPED_BIT);
+    while (m_Producers.Load() != STOPPED_BIT)
+        Thread::sWaitMicroseconds(10);
+
+    m_bStop.Store(true);
+    m_EventNotify.Signal();
+    m_WriterThread.Join();
+
+    // Catch messages pushed after the last drain of the writer thread
+    Drain();
+
+    m_Output = nullptr;
+
+    for (uint32_t i = 0; i < NUM_SLOTS; ++i)
+        m_Slots[i].~Slot();
+    Core::GetHeapAllocator<HEAP_MISC>().Free(m_Slots);
+    m_Slots = nullptr;
+
+    m_Message.Free();
+}
+
+bool AsyncLogWriter::AcquireRing()
+{
+    if (m_Producers.FetchAdd(1) & STOPPED_BIT)
+    {
+        m_Producers.FetchSub(1);
+        return false;
+    }
+    return true;
+}
+
+void AsyncLogWriter::ReleaseRing()
+{
+    m_Producers.FetchSub(1);
+}
+
+bool AsyncLogWriter::AcceptByRate(LogLevel level)
+{
+    if (level >= LogLevel::Error)
+        return true;
+
+    int rateLimit = m_RateLimit.LoadRelaxed();
+    if (rateLimit <= 0)
+        return true;
+
+    int64_t window = Core::SysMilliseconds() / 1000;
+    int64_t current = m_RateWindow.LoadRelaxed();
+    if (current != window && m_RateWindow.CompareExchangeStrong(current, window))
+        m_RateCount.StoreRelaxed(0);
+
+    return m_RateCount.Increment() <= rateLimit;
+}
+
+bool AsyncLogWriter::Push(uint32_t flags, LogLevel level, const char* message)
+{
+    if (!AcquireRing())
+        return false;
+
+    bool result = PushToRing(flags, level, message);
+
+    ReleaseRing();
+    return result;
+}
+
+bool AsyncLogWriter::PushToRing(uint32_t flags, LogLevel level, const char* message)
+{
+    if (!AcceptByRate(level))
+    {
+        m_NumSuppressed.Increment();
+        return false;
+    }
+
+    size_t length = strlen(message);
+    uint64_t numSlots = length > 0 ? (length + SLOT_DATA_SIZE - 1) / SLOT_DATA_SIZE : 1;
+
+    // Reserve consecutive slots. Slots below the tail are already released by the writer,
+    // so a successful reservation never waits for the consumer.
+    uint64_t head = m_Head.LoadRelaxed();
+    do
+    {
+        if (head + numSlots - m_Tail.Load() > NUM_SLOTS)
+        {
+            m_NumDropped.Increment();
+            if (level >= LogLevel::Error)
+                m_EventNotify.Signal();
+            return false;
+        }
+    } while (!m_Head.CompareExchangeWeak(head, head + numSlots));
+
+    for (uint64_t ticket = head; ticket < head + numSlots; ++ticket)
+    {
+        Slot& slot = m_Slots[ticket % NUM_SLOTS];
+        HK_ASSERT(slot.Sequence.Load() == ticket);
+
+        size_t chunkSize = std::min<size_t>(length, SLOT_DATA_SIZE);
+
+        slot.Flags  = flags;
+        slot.Level  = static_cast<uint8_t>(level);
+        slot.Length = static_cast<uint16_t>(chunkSize);
+        slot.bLast  = ticket + 1 == head + numSlots;
+        Core::Memcpy(slot.Data, message, chunkSize);
+
+        message += chunkSize;
+        length -= chunkSize;
+
+        slot.Sequence.Store(ticket + 1);
+    }
+
+    // Errors go to the outlets as soon as possible, everything else waits for the writer period
+    // unless the ring is getting full.
+    if (level >= LogLevel::Error || head + numSlots - m_Tail.LoadRelaxed() > NUM_SLOTS / 4)
+        m_EventNotify.Signal();
+
+    return true;
+}
+
+void AsyncLogWriter::Flush()
+{
+    if (!AcquireRing())
+        return;
+
+    Drain();
+
+    ReleaseRing();
+}
+
+void AsyncLogWriter::WriterThreadRoutine()
+{
+    while (!m_bStop.Load())
+    {
+        bool timedOut;
+        m_EventNotify.WaitTimeout(WRITER_PERIOD_MS, timedOut);
+
+        Drain();
+    }
+}
+
+void AsyncLogWriter::Drain()
+{
+    MutexGuard lock(m_DrainLock);
+
+    bool bWritten = false;
+    uint64_t tail = m_Tail.LoadRelaxed();
+    for (;;)
+    {
+        Slot& slot = m_Slots[tail % NUM_SLOTS];
+        if (slot.Sequence.Load() != tail + 1)
+            break;
+
+        size_t offset = m_Message.Size();
+        m_Message.Resize(offset + slot.Length);
+        Core::Memcpy(m_Message.ToPtr() + offset, slot.Data, slot.Length);
+
+        uint32_t flags = slot.Flags;
+        LogLevel level = static_cast<LogLevel>(slot.Level);
+        bool bLast = slot.bLast != 0;
+
+        slot.Sequence.Store(tail + NUM_SLOTS);
+        m_Tail.Store(++tail);
+
+        if (bLast)
+        {
+            m_Message.Add('\0');
+            m_Output->WriteMessage(flags, level, m_Message.ToPtr());
+            m_Message.Clear();
+            bWritten = true;
+        }
+    }
+
+    int64_t numDropped = m_NumDropped.LoadRelaxed();
+    int64_t numSuppressed = m_NumSuppressed.LoadRelaxed();
+    if (numDropped != m_ReportedDropped || numSuppressed != m_ReportedSuppressed)
+    {
+        char report[128];
+        Core::Sprintf(report, sizeof(report), "Log: %lld messages dropped, %lld messages suppressed by rate limit\n",
+            (long long)(numDropped - m_ReportedDropped), (long long)(numSuppressed - m_ReportedSuppressed));
+        m_Output->WriteMessage(~0u, LogLevel::Warning, report);
+        m_ReportedDropped = numDropped;
+        m_ReportedSuppressed = numSuppressed;
+        bWritten = true;
+    }
+
+    if (bWritten)
+        m_Output->FlushOutput();
+}
+
+HK_NAMESPACE_END
@@ -0,0 +1,152 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "Thread.h"
+#include "Logger.h"
+#include "Containers/Vector.h"
+
+HK_NAMESPACE_BEGIN
+
+/// Receives messages drained by AsyncLogWriter. Called from the writer thread only.
+class ILogOutput
+{
+public:
+    virtual ~ILogOutput() = default;
+
+    /// Write single message. Flags are the message outlets the message was pushed with.
+    virtual void WriteMessage(uint32_t flags, LogLevel level, const char* message) = 0;
+
+    /// Called once after a batch of messages was written.
+    virtual void FlushOutput() = 0;
+};
+
+/**
+
+AsyncLogWriter
+
+Multi-producer lock-free message ring drained by a background writer thread.
+Producers never wait for I/O: when the ring is full or the burst budget
+is exhausted the message is dropped and counted, and the writer reports
+the number of lost messages on the next drain.
+
+*/
+class AsyncLogWriter final : public Noncopyable
+{
+public:
+    /// Ring capacity in slots. Long messages occupy several consecutive slots.
+    static constexpr uint32_t NUM_SLOTS = 4096;
+
+    /// Payload bytes per slot
+    static constexpr uint32_t SLOT_DATA_SIZE = 240;
+
+    /// Writer thread wakes up at least this often
+    static constexpr int WRITER_PERIOD_MS = 10;
+
+    AsyncLogWriter() = default;
+    ~AsyncLogWriter();
+
+    /// Allocate the ring and start the writer thread.
+    void Start(ILogOutput* output);
+
+    /// Write all pending messages and stop the writer thread.
+    void Stop();
+
+    bool IsRunning() const { return !(m_Producers.LoadRelaxed() & STOPPED_BIT); }
+
+    /// Push the message to the ring. Returns false if the message was dropped or the writer is stopped.
+    bool Push(uint32_t flags, LogLevel level, const char* message);
+
+    /// Write all pending messages on the calling thread.
+    void Flush();
+
+    /// Max number of messages per second below LogLevel::Error. Zero means unlimited.
+    void SetRateLimit(int messagesPerSecond) { m_RateLimit.StoreRelaxed(messagesPerSecond); }
+
+    int GetRateLimit() const { return m_RateLimit.LoadRelaxed(); }
+
+    /// Total number of messages that did not fit into the ring
+    int64_t GetNumDroppedMessages() const { return m_NumDropped.LoadRelaxed(); }
+
+    /// Total number of messages rejected by the rate limiter
+    int64_t GetNumSuppressedMessages() const { return m_NumSuppressed.LoadRelaxed(); }
+
+private:
+    struct alignas(64) Slot
+    {
+        /// Equals to ticket + 1 when the slot is published, ticket + NUM_SLOTS when it is free again
+        Atomic<uint64_t> Sequence;
+        uint32_t         Flags;
+        uint16_t         Length;
+        uint8_t          Level;
+        /// Last chunk of the message
+        uint8_t          bLast;
+        char             Data[SLOT_DATA_SIZE];
+    };
+
+    /// Set in m_Producers while the ring is not accepting messages
+    static constexpr int32_t STOPPED_BIT = HK_BIT(30);
+
+    /// Register the calling thread as a user of the ring. Fails when the writer is stopped.
+    bool AcquireRing();
+    void ReleaseRing();
+
+    bool PushToRing(uint32_t flags, LogLevel level, const char* message);
+    bool AcceptByRate(LogLevel level);
+    void WriterThreadRoutine();
+    void Drain();
+
+    ILogOutput*      m_Output{};
+    Slot*            m_Slots{};
+    Thread           m_WriterThread;
+    SyncEvent        m_EventNotify;
+    AtomicBool       m_bStop{false};
+    /// Number of threads inside Push or Flush, plus STOPPED_BIT. Stop waits for it to drop to zero
+    /// before the ring is freed.
+    AtomicInt        m_Producers{STOPPED_BIT};
+
+    alignas(64) Atomic<uint64_t> m_Head{0};
+    alignas(64) Atomic<uint64_t> m_Tail{0};
+
+    alignas(64) AtomicLong m_RateWindow{0};
+    AtomicInt        m_RateCount{0};
+    AtomicInt        m_RateLimit{0};
+    AtomicLong       m_NumDropped{0};
+    AtomicLong       m_NumSuppressed{0};
+
+    // Consumer side, guarded by m_DrainLock
+    Mutex            m_DrainLock;
+    Vector<char>     m_Message;
+    int64_t          m_ReportedDropped{0};
+    int64_t          m_ReportedSuppressed{0};
+};
+
+HK_NAMESPACE_END
@@ -50,7 +50,7 @@ public:
 
     virtual size_t GetOffset() const = 0;
 
-    virtual bool SeekSet(int32_t offset) = 0;
+    virtual bool SeekSet(int64_t offset) = 0;
 
     virtual bool SeekCur(int32_t offset) = 0;
 
@@ -103,6 +103,7 @@ public:
         m_Bits = std::move(rhs.m_Bits);
         m_NumBits = rhs.m_NumBits;
         rhs.m_NumBits = 0;
+        return *this;
     }
 
     void Resize(size_t numBits)
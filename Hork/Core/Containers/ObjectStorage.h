@@ -53,7 +53,9 @@ public:
                     ObjectStorage& operator=(ObjectStorage& rhs) = delete;
                     ObjectStorage& operator=(ObjectStorage&& rhs) noexcept;
 
-    Handle32<T>     CreateObject(T*& newObject);
+    /// Construct a new object in place. Arguments are forwarded to the object constructor.
+    template <typename... Args>
+    Handle32<T>     CreateObject(T*& newObject, Args&&... args);
 
     template <typename HandleFetcher>
     void            DestroyObject(HandleFetcher const& fetcher, Handle32<T> handle);
@@ -75,6 +77,9 @@ public:
 
     uint32_t        GetPageCount() const;
 
+    /// Allocate pages and handle slots up front so the next objects are created without reallocation.
+    void            Reserve(uint32_t capacity);
+
     static constexpr size_t sGetPageSize() { return PageSize; }
 
     template <typename Visitor>
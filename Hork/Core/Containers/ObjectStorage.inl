@@ -67,7 +67,8 @@ HK_FORCEINLINE ObjectStorage<T, PageSize, StorageType, Heap>& ObjectStorage<T, P
 }
 
 template <typename T, uint32_t PageSize, ObjectStorageType StorageType, MEMORY_HEAP Heap>
-HK_INLINE Handle32<T> ObjectStorage<T, PageSize, StorageType, Heap>::CreateObject(T*& newObject)
+template <typename... Args>
+HK_INLINE Handle32<T> ObjectStorage<T, PageSize, StorageType, Heap>::CreateObject(T*& newObject, Args&&... args)
 {
     static_assert(sizeof(T) >= sizeof(m_FreeListHead), "The size of the object must be greater than or equal to sizeof(uint32_t)");
 
@@ -95,7 +96,7 @@ HK_INLINE Handle32<T> ObjectStorage<T, PageSize, StorageType, Heap>::CreateObjec
 
         ++m_Size;
 
-        newObject = new (address) T();
+        newObject = new (address) T(std::forward<Args>(args)...);
 
         HK_ASSERT(m_RandomAccess[freeHandleID] == nullptr);
         m_RandomAccess[freeHandleID] = newObject;
@@ -108,7 +109,7 @@ HK_INLINE Handle32<T> ObjectStorage<T, PageSize, StorageType, Heap>::CreateObjec
         CoreApplication::sTerminateWithError("ObjectStorage::Create: Too many objects allocated\n");
 
     m_Data.Grow(m_Size + 1);
-    newObject = new (m_Data.GetAddress(m_Size++)) T();
+    newObject = new (m_Data.GetAddress(m_Size++)) T(std::forward<Args>(args)...);
 
     m_RandomAccess.Add(newObject);
 
@@ -256,6 +257,16 @@ HK_FORCEINLINE uint32_t ObjectStorage<T, PageSize, StorageType, Heap>::GetPageCo
     return m_Data.GetPageCount();
 }
 
+template <typename T, uint32_t PageSize, ObjectStorageType StorageType, MEMORY_HEAP Heap>
+HK_INLINE void ObjectStorage<T, PageSize, StorageType, Heap>::Reserve(uint32_t capacity)
+{
+    if (capacity == 0)
+        return;
+
+    m_Data.Grow(capacity);
+    m_RandomAccess.Reserve(capacity);
+}
+
 template <typename T, uint32_t PageSize, ObjectStorageType StorageType, MEMORY_HEAP Heap>
 template <typename Visitor, bool IsConst>
 HK_FORCEINLINE void ObjectStorage<T, PageSize, StorageType, Heap>::_Iterate(Visitor& visitor)
@@ -55,6 +55,9 @@ HK_NAMESPACE_BEGIN
 extern "C" const size_t   EmbeddedResources_Size;
 extern "C" const uint64_t EmbeddedResources_Data[];
 
+/// Max log messages per second below LogLevel::Error, can be overridden with -logRateLimit
+constexpr int DefaultLogRateLimit = 2000;
+
 namespace
 {
 
@@ -535,6 +538,53 @@ CoreApplication::CoreApplication(ArgumentPack const& args) :
         Core::SetEnableConsoleOutput(true);
     }
 
+    int n = m_Arguments.Find("-logLevel");
+    if (n != -1 && n + 1 < m_Arguments.Count())
+    {
+        StringView level = m_Arguments.At(n + 1);
+        if (!level.Icmp("debug"))
+            Core::SetLogLevel(LogLevel::Debug);
+        else if (!level.Icmp("info"))
+            Core::SetLogLevel(LogLevel::Info);
+        else if (!level.Icmp("warning"))
+            Core::SetLogLevel(LogLevel::Warning);
+        else if (!level.Icmp("error"))
+            Core::SetLogLevel(LogLevel::Error);
+        else if (!level.Icmp("critical"))
+            Core::SetLogLevel(LogLevel::Critical);
+    }
+
+    // Comma separated list of the channels to mute, e.g. -logMute audio,physics
+    n = m_Arguments.Find("-logMute");
+    if (n != -1 && n + 1 < m_Arguments.Count())
+    {
+        StringView list = m_Arguments.At(n + 1);
+        while (!list.IsEmpty())
+        {
+            auto comma = list.FindCharacter(',');
+            StringView name = comma == Core::NPOS ? list : list.GetSubstring(0, comma);
+            list = comma == Core::NPOS ? StringView() : list.TruncateHead(comma + 1);
+
+            for (int i = 0; i < static_cast<int>(LogChannel::Count); ++i)
+            {
+                if (!name.Icmp(Core::GetLogChannelName(static_cast<LogChannel>(i))))
+                    Core::SetLogChannelEnabled(static_cast<LogChannel>(i), false);
+            }
+        }
+    }
+
+    m_LogWriter.SetRateLimit(DefaultLogRateLimit);
+    n = m_Arguments.Find("-logRateLimit");
+    if (n != -1 && n + 1 < m_Arguments.Count())
+    {
+        m_LogWriter.SetRateLimit(std::max(0, atoi(m_Arguments.At(n + 1))));
+    }
+
+    if (!m_Arguments.Has("-syncLog"))
+    {
+        m_LogWriter.Start(&m_LogOutput);
+    }
+
     if (!m_Arguments.Has("-allowMultipleInstances"))
     {
         switch (m_ProcessAttribute)
@@ -563,7 +613,7 @@ CoreApplication::CoreApplication(ArgumentPack const& args) :
     size_t ProcessWorkingSetSizeMin = 192ull << 20;
     size_t ProcessWorkingSetSizeMax = 1024ull << 20;
 
-    int n = m_Arguments.Find("-ProcessWorkingSetSize");
+    n = m_Arguments.Find("-ProcessWorkingSetSize");
     if (n != -1 && (n + 2) < m_Arguments.Count())
     {
         ProcessWorkingSetSizeMin = std::max(0, atoi(m_Arguments.At(n + 1)));
@@ -701,6 +751,8 @@ void CoreApplication::Cleanup()
 
     ConsoleVar::sFreeVariables();
 
+    m_LogWriter.Stop();
+
     if (m_LogFile)
     {
         fclose(m_LogFile);
@@ -741,25 +793,55 @@ void CoreApplication::Cleanup()
 #endif
 }
 
-void CoreApplication::_WriteMessage(MessageFlags flags, const char* message)
+void CoreApplication::_WriteMessage(MessageFlags flags, const char* message, LogLevel level)
+{
+    // The engine console is an in-memory buffer, keep it in call order with the caller.
+    if (flags & MSG_CON)
+        m_ConsoleBuffer.Print(message);
+
+    MessageFlags outletFlags = flags & (MSG_DEBUG | MSG_SYSCON | MSG_LOG);
+    if (!outletFlags)
+        return;
+
+    // If the writer was stopped while pushing, the message goes to the outlets directly
+    if (m_LogWriter.IsRunning() && (m_LogWriter.Push(outletFlags, level, message) || m_LogWriter.IsRunning()))
+    {
+        // Make sure critical messages reach the outlets before the application goes down
+        if (level == LogLevel::Critical)
+            m_LogWriter.Flush();
+        return;
+    }
+
+    MutexGuard lock(m_LogWriterSync);
+    _WriteMessageToOutlets(outletFlags, message);
+    if (m_LogFile)
+        fflush(m_LogFile);
+}
+
+void CoreApplication::_WriteMessageToOutlets(MessageFlags flags, const char* message)
 {
     if (flags & MSG_DEBUG)
         Core::WriteDebugString(message);
     if (flags & MSG_SYSCON)
         Core::WriteConsoleString(message);
-    if (flags & MSG_CON)
-        m_ConsoleBuffer.Print(message);
     if (flags & MSG_LOG)
     {
         if (m_LogFile)
-        {
-            MutexGuard lock(m_LogWriterSync);
-            fprintf(m_LogFile, "%s", message);
-            fflush(m_LogFile);
-        }
+            fputs(message, m_LogFile);
     }
 }
 
+void CoreApplication::LogOutput::WriteMessage(uint32_t flags, LogLevel level, const char* message)
+{
+    m_App->_WriteMessageToOutlets(static_cast<MessageFlags>(flags), message);
+}
+
+void CoreApplication::LogOutput::FlushOutput()
+{
+    if (m_App->m_LogFile)
+        fflush(m_App->m_LogFile);
+}
+
 void CoreApplication::sSetClipboard(StringView text)
 {
     if (text.IsNullTerminated())
@@ -827,6 +909,8 @@ void DisplayCriticalMessage(const char* message)
 
 void CoreApplication::_TerminateWithError(const char* message)
 {
+    m_LogWriter.Flush();
+
     DisplayCriticalMessage(message);
 
     Cleanup();
@@ -847,8 +931,9 @@ void AssertFunction(const char* file, int line, const char* function, const char
 
     bRecursive = true;
 
-    // LOG is thread-safe function so we don't need to wrap it by a critical section
-    LOG("===== Assertion failed =====\n"
+    // CRITICAL is thread-safe function so we don't need to wrap it by a critical section.
+    // It also flushes the log before the debugger trap.
+    CRITICAL("===== Assertion failed =====\n"
         "At file {}, line {}\n"
         "Function: {}\n"
         "Assertion: {}\n"
@@ -33,6 +33,7 @@ SOFTWARE.
 #include "String.h"
 #include "IO.h"
 #include "ConsoleBuffer.h"
+#include "AsyncLogWriter.h"
 
 HK_NAMESPACE_BEGIN
 
@@ -130,9 +131,20 @@ public:
         return s_Instance->m_ConsoleBuffer;
     }
 
-    static void sWriteMessage(MessageFlags flags, const char* message)
+    static void sWriteMessage(MessageFlags flags, const char* message, LogLevel level = LogLevel::Info)
     {
-        s_Instance->_WriteMessage(flags, message);
+        s_Instance->_WriteMessage(flags, message, level);
+    }
+
+    /// Write all pending log messages to the outlets
+    static void sFlushLog()
+    {
+        s_Instance->m_LogWriter.Flush();
+    }
+
+    static AsyncLogWriter& sGetLogWriter()
+    {
+        return s_Instance->m_LogWriter;
     }
 
     static void sSetClipboard(StringView text);
@@ -151,7 +163,8 @@ public:
     }
 
 private:
-    void _WriteMessage(MessageFlags flags, const char* message);
+    void _WriteMessage(MessageFlags flags, const char* message, LogLevel level);
+    void _WriteMessageToOutlets(MessageFlags flags, const char* message);
     void _TerminateWithError(const char* message);
 
     void Cleanup();
@@ -174,6 +187,23 @@ private:
     int                  m_ProcessAttribute{};
     FILE*                m_LogFile{};
     Mutex                m_LogWriterSync;
+
+    class LogOutput final : public ILogOutput
+    {
+    public:
+        LogOutput(CoreApplication* app) :
+            m_App(app)
+        {}
+
+        void WriteMessage(uint32_t flags, LogLevel level, const char* message) override;
+        void FlushOutput() override;
+
+    private:
+        CoreApplication* m_App;
+    };
+
+    LogOutput            m_LogOutput{this};
+    AsyncLogWriter       m_LogWriter;
     char*                m_Clipboard{};
     ConsoleBuffer        m_ConsoleBuffer;
     Archive              m_EmbeddedArchive;
@@ -40,6 +40,8 @@ SOFTWARE.
 #ifdef HK_OS_LINUX
 #    include <dirent.h>
 #    include <sys/stat.h> // _mkdir
+#    include <sys/mman.h> // mmap
+#    include <fcntl.h>    // open
 #    include <unistd.h>   // access
 #endif
 
@@ -77,6 +79,25 @@ FILE* OpenFile(const char* fileName, const char* Mode)
 #endif
     return f;
 }
+
+// Files can be larger than 2 GB, long is 32-bit on Windows
+int SeekFile(FILE* f, int64_t offset, int origin)
+{
+#if defined(_MSC_VER)
+    return _fseeki64(f, offset, origin);
+#else
+    return fseeko(f, offset, origin);
+#endif
+}
+
+int64_t TellFile(FILE* f)
+{
+#if defined(_MSC_VER)
+    return _ftelli64(f);
+#else
+    return ftello(f);
+#endif
+}
 }
 
 HK_NAMESPACE_BEGIN
@@ -301,7 +322,7 @@ char* File::Gets(char* str, size_t sizeInBytes)
     {
         str = fgets(str, sizeInBytes, m_Handle);
 
-        m_RWOffset = ftell(m_Handle);
+        m_RWOffset = TellFile(m_Handle);
     }
     else
     {
@@ -351,12 +372,12 @@ size_t File::GetOffset() const
 
 #define HasFileSize() (m_FileSize != ~0ull)
 
-bool File::SeekSet(int32_t offset)
+bool File::SeekSet(int64_t offset)
 {
     if (!IsOpened())
         return false;
 
-    m_RWOffset = std::max(int32_t{0}, offset);
+    m_RWOffset = std::max(int64_t{0}, offset);
 
     if (IsFileSystem())
     {
@@ -366,9 +387,9 @@ bool File::SeekSet(int32_t offset)
                 m_RWOffset = m_FileSize;
         }
 
-        bool r = fseek(m_Handle, m_RWOffset, SEEK_SET) == 0;
+        bool r = SeekFile(m_Handle, m_RWOffset, SEEK_SET) == 0;
         if (!r)
-            m_RWOffset = ftell(m_Handle);
+            m_RWOffset = TellFile(m_Handle);
 
         return r;
     }
@@ -394,7 +415,7 @@ bool File::SeekCur(int32_t offset)
             // Rewind
             m_RWOffset = 0;
 
-            r = fseek(m_Handle, 0, SEEK_SET) == 0;
+            r = SeekFile(m_Handle, 0, SEEK_SET) == 0;
         }
         else
         {
@@ -408,12 +429,12 @@ bool File::SeekCur(int32_t offset)
 
             m_RWOffset += offset;
 
-            r = fseek(m_Handle, offset, SEEK_CUR) == 0;
+            r = SeekFile(m_Handle, offset, SEEK_CUR) == 0;
         }
 
         if (!r)
         {
-            m_RWOffset = ftell(m_Handle);
+            m_RWOffset = TellFile(m_Handle);
         }
 
         return r;
@@ -448,7 +469,7 @@ bool File::SeekEnd(int32_t offset)
         {
             offset = 0;
 
-            r = fseek(m_Handle, 0, SEEK_END) == 0;
+            r = SeekFile(m_Handle, 0, SEEK_END) == 0;
 
             if (r && HasFileSize())
             {
@@ -456,7 +477,7 @@ bool File::SeekEnd(int32_t offset)
             }
             else
             {
-                m_RWOffset = ftell(m_Handle);
+                m_RWOffset = TellFile(m_Handle);
                 if (r)
                     m_FileSize = m_RWOffset;
             }
@@ -468,16 +489,16 @@ bool File::SeekEnd(int32_t offset)
         {
             // Rewind
             m_RWOffset = 0;
-            r          = fseek(m_Handle, 0, SEEK_SET) == 0;
+            r          = SeekFile(m_Handle, 0, SEEK_SET) == 0;
 
             if (!r)
-                m_RWOffset = ftell(m_Handle);
+                m_RWOffset = TellFile(m_Handle);
 
             return r;
         }
 
-        r          = fseek(m_Handle, offset, SEEK_END) == 0;
-        m_RWOffset = ftell(m_Handle);
+        r          = SeekFile(m_Handle, offset, SEEK_END) == 0;
+        m_RWOffset = TellFile(m_Handle);
 
         return r;
     }
@@ -502,9 +523,9 @@ size_t File::SizeInBytes() const
     {
         if (!HasFileSize())
         {
-            fseek(m_Handle, 0, SEEK_END);
-            m_FileSize = ftell(m_Handle);
-            fseek(m_Handle, m_RWOffset, SEEK_SET);
+            SeekFile(m_Handle, 0, SEEK_END);
+            m_FileSize = TellFile(m_Handle);
+            SeekFile(m_Handle, m_RWOffset, SEEK_SET);
         }
     }
     return m_FileSize;
@@ -627,6 +648,128 @@ void* File::GetHeapPtr()
     return m_pHeapPtr;
 }
 
+MappedFile::MappedFile(MappedFile&& rhs) noexcept :
+    m_Data(rhs.m_Data),
+    m_Size(rhs.m_Size),
+    m_Mapping(rhs.m_Mapping)
+{
+    rhs.m_Data = nullptr;
+    rhs.m_Size = 0;
+    rhs.m_Mapping = nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    Close();
+
+    std::swap(m_Data, rhs.m_Data);
+    std::swap(m_Size, rhs.m_Size);
+    std::swap(m_Mapping, rhs.m_Mapping);
+
+    return *this;
+}
+
+MappedFile MappedFile::sOpen(StringView fileName)
+{
+    String name = PathUtils::sFixPath(fileName);
+
+    MappedFile f;
+
+#ifdef HK_OS_WIN32
+    int n = MultiByteToWideChar(CP_UTF8, 0, name.CStr(), -1, NULL, 0);
+    if (0 == n)
+        return {};
+
+    wchar_t* wFilename = (wchar_t*)HkStackAlloc(n * sizeof(wchar_t));
+
+    MultiByteToWideChar(CP_UTF8, 0, name.CStr(), -1, wFilename, n);
+
+    HANDLE file = CreateFileW(wFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LOG("Couldn't open {}\n", name);
+        return {};
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return {};
+    }
+
+    // The mapping keeps the file open
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        LOG("Couldn't map {}\n", name);
+        return {};
+    }
+
+    f.m_Data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!f.m_Data)
+    {
+        LOG("Couldn't map {}\n", name);
+        CloseHandle(mapping);
+        return {};
+    }
+
+    f.m_Size = fileSize.QuadPart;
+    f.m_Mapping = mapping;
+#else
+    int file = open(name.CStr(), O_RDONLY);
+    if (file == -1)
+    {
+        LOG("Couldn't open {}\n", name);
+        return {};
+    }
+
+    struct stat st;
+    if (fstat(file, &st) != 0 || st.st_size == 0)
+    {
+        close(file);
+        return {};
+    }
+
+    // The mapping keeps the file open
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        LOG("Couldn't map {}\n", name);
+        return {};
+    }
+
+    f.m_Data = data;
+    f.m_Size = st.st_size;
+#endif
+
+    return f;
+}
+
+void MappedFile::Close()
+{
+    if (!m_Data)
+        return;
+
+#ifdef HK_OS_WIN32
+    UnmapViewOfFile(m_Data);
+    CloseHandle(m_Mapping);
+#else
+    munmap(m_Data, m_Size);
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Mapping = nullptr;
+}
+
 Archive::Archive(Archive&& rhs) noexcept :
     m_Handle(rhs.m_Handle)
 {
@@ -924,6 +1067,30 @@ void RemoveFile(StringView fileName)
 #endif
 }
 
+bool RenameFile(StringView oldFileName, StringView newFileName)
+{
+    String oldName = PathUtils::sFixPath(oldFileName);
+    String newName = PathUtils::sFixPath(newFileName);
+#if defined HK_OS_LINUX
+    return ::rename(oldName.CStr(), newName.CStr()) == 0;
+#elif defined HK_OS_WIN32
+    int n = MultiByteToWideChar(CP_UTF8, 0, oldName.CStr(), -1, NULL, 0);
+    int m = MultiByteToWideChar(CP_UTF8, 0, newName.CStr(), -1, NULL, 0);
+    if (0 == n || 0 == m)
+        return false;
+
+    wchar_t* wOldName = (wchar_t*)HkStackAlloc(n * sizeof(wchar_t));
+    wchar_t* wNewName = (wchar_t*)HkStackAlloc(m * sizeof(wchar_t));
+
+    MultiByteToWideChar(CP_UTF8, 0, oldName.CStr(), -1, wOldName, n);
+    MultiByteToWideChar(CP_UTF8, 0, newName.CStr(), -1, wNewName, m);
+
+    return ::MoveFileEx(wOldName, wNewName, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    static_assert(0, "TODO: Implement RenameFile for current build settings");
+#endif
+}
+
 #ifdef HK_OS_LINUX
 void TraverseDirectory(StringView path, bool recursive, STraverseDirectoryCB callback)
 {
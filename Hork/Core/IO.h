@@ -186,7 +186,7 @@ public:
 
     size_t                      GetOffset() const override;
 
-    bool                        SeekSet(int32_t offset) override;
+    bool                        SeekSet(int64_t offset) override;
 
     bool                        SeekCur(int32_t offset) override;
     bool                        SeekEnd(int32_t offset) override;
@@ -225,6 +225,44 @@ private:
     bool                        m_IsMemoryBufferOwner{true};
 };
 
+/**
+
+MappedFile
+
+Read-only memory mapping of a file
+
+*/
+class MappedFile final : public Noncopyable
+{
+public:
+                                MappedFile() = default;
+                                ~MappedFile();
+
+                                MappedFile(MappedFile&& rhs) noexcept;
+
+    MappedFile&                 operator=(MappedFile&& rhs) noexcept;
+
+                                operator bool() const { return IsOpened(); }
+
+    /// Map file from specified path. Empty files can't be mapped.
+    static MappedFile           sOpen(StringView fileName);
+
+    /// Unmap file
+    void                        Close();
+
+    bool                        IsOpened() const { return m_Data != nullptr; }
+
+    /// Get mapped file content
+    const void*                 GetData() const { return m_Data; }
+
+    size_t                      GetSize() const { return m_Size; }
+
+private:
+    void*                       m_Data{};
+    size_t                      m_Size{};
+    void*                       m_Mapping{};
+};
+
 namespace Core
 {
 
@@ -237,6 +275,9 @@ bool IsFileExists(StringView fileName);
 /// Remove file from disk
 void RemoveFile(StringView fileName);
 
+/// Rename file. The destination file is replaced if it exists.
+bool RenameFile(StringView oldFileName, StringView newFileName);
+
 using STraverseDirectoryCB = std::function<void(StringView fileName, bool isDirectory)>;
 /// Traverse the directory
 void TraverseDirectory(StringView path, bool recursive, STraverseDirectoryCB callback);
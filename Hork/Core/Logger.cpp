@@ -32,9 +32,122 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+namespace
+{
+
+constexpr int NumLogLevels = static_cast<int>(LogLevel::Critical) + 1;
+
+Atomic<uint32_t> LogOutlets[NumLogLevels] = {
+    Atomic<uint32_t>(MSG_ALL),
+    Atomic<uint32_t>(MSG_ALL),
+    Atomic<uint32_t>(MSG_ALL),
+    Atomic<uint32_t>(MSG_ALL),
+    Atomic<uint32_t>(MSG_ALL)};
+
+Atomic<uint32_t> LogThreshold(static_cast<uint32_t>(LogLevel::Debug));
+
+Mutex LogConfigSync;
+
+const char* LogChannelNames[] = {
+    "General",
+    "Core",
+    "Audio",
+    "Render",
+    "Physics",
+    "Navigation",
+    "Resources",
+    "World"};
+
+static_assert(HK_ARRAY_SIZE(LogChannelNames) == static_cast<int>(LogChannel::Count), "Update channel names");
+
+void UpdateLogLevelMask()
+{
+    uint32_t mask = 0;
+    for (int level = LogThreshold.LoadRelaxed(); level < NumLogLevels; ++level)
+    {
+        if (LogOutlets[level].LoadRelaxed())
+            mask |= 1u << level;
+    }
+    Core::Internal::LogLevelMask.Store(mask);
+}
+
+} // namespace
+
+namespace Core
+{
+
+namespace Internal
+{
+Atomic<uint32_t> LogLevelMask(~0u);
+Atomic<uint32_t> LogChannelMask(~0u);
+}
+
+void SetLogLevel(LogLevel level)
+{
+    MutexGuard lock(LogConfigSync);
+    LogThreshold.StoreRelaxed(static_cast<uint32_t>(level));
+    UpdateLogLevelMask();
+}
+
+LogLevel GetLogLevel()
+{
+    return static_cast<LogLevel>(LogThreshold.LoadRelaxed());
+}
+
+void SetLogOutlets(LogLevel level, uint32_t outlets)
+{
+    MutexGuard lock(LogConfigSync);
+    LogOutlets[static_cast<int>(level)].StoreRelaxed(outlets);
+    UpdateLogLevelMask();
+}
+
+uint32_t GetLogOutlets(LogLevel level)
+{
+    return LogOutlets[static_cast<int>(level)].LoadRelaxed();
+}
+
+void SetLogChannelEnabled(LogChannel channel, bool enabled)
+{
+    MutexGuard lock(LogConfigSync);
+    uint32_t mask = Internal::LogChannelMask.LoadRelaxed();
+    if (enabled)
+        mask |= 1u << static_cast<uint32_t>(channel);
+    else
+        mask &= ~(1u << static_cast<uint32_t>(channel));
+    Internal::LogChannelMask.Store(mask);
+}
+
+bool IsLogChannelEnabled(LogChannel channel)
+{
+    return (Internal::LogChannelMask.LoadRelaxed() & (1u << static_cast<uint32_t>(channel))) != 0;
+}
+
+const char* GetLogChannelName(LogChannel channel)
+{
+    return LogChannelNames[static_cast<int>(channel)];
+}
+
+void WriteLog(LogChannel channel, LogLevel level, const char* message)
+{
+    if (!IsLogEnabled(channel, level))
+        return;
+
+    CoreApplication::sWriteMessage(static_cast<MessageFlags>(LogOutlets[static_cast<int>(level)].LoadRelaxed()), message, level);
+}
+
+void WriteLog(LogLevel level, const char* message)
+{
+    if (!IsLogLevelEnabled(level))
+        return;
+
+    CoreApplication::sWriteMessage(static_cast<MessageFlags>(LogOutlets[static_cast<int>(level)].LoadRelaxed()), message, level);
+}
+
+} // namespace Core
+
 void LOG(const char* message)
 {
-    CoreApplication::sWriteMessage(MSG_ALL, message);
+    Core::WriteLog(LogLevel::Info, message);
 }
 
 HK_NAMESPACE_END
@@ -31,60 +31,169 @@ SOFTWARE.
 #pragma once
 
 #include "Format.h"
+#include "Atomic.h"
 
 HK_NAMESPACE_BEGIN
 
-void LOG(const char* message);
+enum class LogLevel : uint8_t
+{
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Critical
+};
+
+/// Subsystem that produced the message
+enum class LogChannel : uint8_t
+{
+    General,
+    Core,
+    Audio,
+    Render,
+    Physics,
+    Navigation,
+    Resources,
+    World,
+
+    Count
+};
+
+namespace Core
+{
+
+namespace Internal
+{
+/// Bit per LogLevel. The bit is set when the level passes the threshold and has at least one outlet.
+extern Atomic<uint32_t> LogLevelMask;
+
+/// Bit per LogChannel. The bit is set when the channel is enabled.
+extern Atomic<uint32_t> LogChannelMask;
+}
+
+/// Messages below the level are discarded before formatting.
+void SetLogLevel(LogLevel level);
+
+LogLevel GetLogLevel();
+
+/// Set message outlets (MessageFlags) for the level. Zero outlets disable the level.
+void SetLogOutlets(LogLevel level, uint32_t outlets);
+
+uint32_t GetLogOutlets(LogLevel level);
+
+/// Messages of the disabled channel are discarded before formatting. Critical messages are never filtered by channel.
+void SetLogChannelEnabled(LogChannel channel, bool enabled);
+
+bool IsLogChannelEnabled(LogChannel channel);
+
+const char* GetLogChannelName(LogChannel channel);
+
+HK_FORCEINLINE bool IsLogLevelEnabled(LogLevel level)
+{
+    return (Internal::LogLevelMask.LoadRelaxed() & (1u << static_cast<uint32_t>(level))) != 0;
+}
+
+HK_FORCEINLINE bool IsLogEnabled(LogChannel channel, LogLevel level)
+{
+    return IsLogLevelEnabled(level) &&
+        (level == LogLevel::Critical || (Internal::LogChannelMask.LoadRelaxed() & (1u << static_cast<uint32_t>(channel))) != 0);
+}
+
+void WriteLog(LogLevel level, const char* message);
+
+void WriteLog(LogChannel channel, LogLevel level, const char* message);
 
 template <typename... T>
-HK_FORCEINLINE void LOG(fmt::format_string<T...> format, T&&... args)
+HK_FORCEINLINE void WriteLog(LogLevel level, fmt::format_string<T...> format, T&&... args)
 {
+    if (!IsLogLevelEnabled(level))
+        return;
+
     fmt::memory_buffer buffer;
     fmt::detail::vformat_to(buffer, fmt::string_view(format), fmt::make_format_args(args...));
     buffer.push_back('\0');
 
-    LOG(buffer.data());
+    WriteLog(level, buffer.data());
 }
 
 template <typename... T>
-HK_FORCEINLINE void CRITICAL(fmt::format_string<T...> format, T&&... args)
+HK_FORCEINLINE void WriteLog(LogChannel channel, LogLevel level, fmt::format_string<T...> format, T&&... args)
 {
+    if (!IsLogEnabled(channel, level))
+        return;
+
     fmt::memory_buffer buffer;
     fmt::detail::vformat_to(buffer, fmt::string_view(format), fmt::make_format_args(args...));
     buffer.push_back('\0');
 
-    LOG(buffer.data());
+    WriteLog(level, buffer.data());
 }
 
+} // namespace Core
+
+void LOG(const char* message);
+
 template <typename... T>
-HK_FORCEINLINE void ERROR(fmt::format_string<T...> format, T&&... args)
+HK_FORCEINLINE void LOG(fmt::format_string<T...> format, T&&... args)
 {
-    fmt::memory_buffer buffer;
-    fmt::detail::vformat_to(buffer, fmt::string_view(format), fmt::make_format_args(args...));
-    buffer.push_back('\0');
+    Core::WriteLog(LogLevel::Info, format, std::forward<T>(args)...);
+}
 
-    LOG(buffer.data());
+template <typename... T>
+HK_FORCEINLINE void CRITICAL(fmt::format_string<T...> format, T&&... args)
+{
+    Core::WriteLog(LogLevel::Critical, format, std::forward<T>(args)...);
 }
 
 template <typename... T>
-HK_FORCEINLINE void WARNING(fmt::format_string<T...> format, T&&... args)
+HK_FORCEINLINE void ERROR(fmt::format_string<T...> format, T&&... args)
 {
-    fmt::memory_buffer buffer;
-    fmt::detail::vformat_to(buffer, fmt::string_view(format), fmt::make_format_args(args...));
-    buffer.push_back('\0');
+    Core::WriteLog(LogLevel::Error, format, std::forward<T>(args)...);
+}
 
-    LOG(buffer.data());
+template <typename... T>
+HK_FORCEINLINE void WARNING(fmt::format_string<T...> format, T&&... args)
+{
+    Core::WriteLog(LogLevel::Warning, format, std::forward<T>(args)...);
 }
 
 template <typename... T>
 HK_FORCEINLINE void DEBUG(fmt::format_string<T...> format, T&&... args)
 {
 #ifdef HK_DEBUG
-    fmt::memory_buffer buffer;
-    fmt::detail::vformat_to(buffer, fmt::string_view(format), fmt::make_format_args(args...));
-    buffer.push_back('\0');
+    Core::WriteLog(LogLevel::Debug, format, std::forward<T>(args)...);
+#endif
+}
+
+template <typename... T>
+HK_FORCEINLINE void LOG(LogChannel channel, fmt::format_string<T...> format, T&&... args)
+{
+    Core::WriteLog(channel, LogLevel::Info, format, std::forward<T>(args)...);
+}
+
+template <typename... T>
+HK_FORCEINLINE void CRITICAL(LogChannel channel, fmt::format_string<T...> format, T&&... args)
+{
+    Core::WriteLog(channel, LogLevel::Critical, format, std::forward<T>(args)...);
+}
+
+template <typename... T>
+HK_FORCEINLINE void ERROR(LogChannel channel, fmt::format_string<T...> format, T&&... args)
+{
+    Core::WriteLog(channel, LogLevel::Error, format, std::forward<T>(args)...);
+}
 
-    LOG(buffer.data());
+template <typename... T>
+HK_FORCEINLINE void WARNING(LogChannel channel, fmt::format_string<T...> format, T&&... args)
+{
+    Core::WriteLog(channel, LogLevel::Warning, format, std::forward<T>(args)...);
+}
+
+template <typename... T>
+HK_FORCEINLINE void DEBUG(LogChannel channel, fmt::format_string<T...> format, T&&... args)
+{
+#ifdef HK_DEBUG
+    Core::WriteLog(channel, LogLevel::Debug, format, std::forward<T>(args)...);
 #endif
 }
 
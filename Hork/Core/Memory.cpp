@@ -31,6 +31,7 @@ SOFTWARE.
 #include "Memory.h"
 #include "Platform.h"
 #include "CoreApplication.h"
+#include "WindowsDefs.h"
 
 #include <malloc.h>
 #include <memory.h>
@@ -38,6 +39,10 @@ SOFTWARE.
 #include <immintrin.h>
 #include <mimalloc/mimalloc.h>
 
+#if defined HK_OS_LINUX && !defined HK_OS_ANDROID
+#    include <execinfo.h> // backtrace
+#endif
+
 #define USE_MIMALLOC
 
 HK_NAMESPACE_BEGIN
@@ -266,6 +271,130 @@ void _MemsetSSE(byte* dst, int _val, size_t sizeInBytes)
 
 } // namespace Core
 
+namespace
+{
+
+AtomicInt MemoryFrameNum;
+
+AtomicInt ThreadShardCounter;
+thread_local uint32_t ThreadShard = ~0u;
+
+HK_FORCEINLINE uint32_t GetThreadShard()
+{
+    if (HK_UNLIKELY(ThreadShard == ~0u))
+        ThreadShard = uint32_t(ThreadShardCounter.FetchIncrement()) % MemoryHeap::MaxStatShards;
+    return ThreadShard;
+}
+
+// Bounded multi-producer ring. The slot sequence tells whether the slot is free for the writer at the
+// given position or holds a record for the reader.
+constexpr size_t TrackerRingSize = 2048;
+
+struct TrackerSlot
+{
+    Atomic<size_t>      Sequence;
+    MemoryTrackerRecord Record;
+};
+
+// Enabled bit and the number of writers inside TrackAllocation. Kept in one atomic so that sEnable can wait
+// for the writers of the previous session before resetting the ring.
+constexpr int32_t TRACKER_ENABLED_BIT = HK_BIT(30);
+
+TrackerSlot     TrackerRing[TrackerRingSize];
+Atomic<size_t>  TrackerWritePos;
+size_t          TrackerReadPos;
+Atomic<size_t>  TrackerDropped;
+AtomicInt       TrackerState;
+bool            TrackerCaptureCallstack;
+uint32_t        TrackerSampleInterval = 1;
+
+thread_local uint32_t TrackerSampleCounter;
+thread_local bool     TrackerRecursive;
+
+uint32_t CaptureCallstack(void** frames, uint32_t maxDepth)
+{
+#if defined HK_OS_WIN32
+    return CaptureStackBackTrace(2, maxDepth, frames, nullptr);
+#elif defined HK_OS_LINUX && !defined HK_OS_ANDROID
+    return std::max(0, backtrace(frames, maxDepth));
+#else
+    return 0;
+#endif
+}
+
+void TrackAllocation(MEMORY_HEAP heap, size_t sizeInBytes)
+{
+    if (++TrackerSampleCounter < TrackerSampleInterval || TrackerRecursive)
+        return;
+    TrackerSampleCounter = 0;
+
+    // The tracker can be disabled since the check in CountAlloc
+    if (!(TrackerState.FetchIncrement() & TRACKER_ENABLED_BIT))
+    {
+        TrackerState.Decrement();
+        return;
+    }
+
+    // Callstack capture may allocate on first use
+    TrackerRecursive = true;
+
+    size_t pos = TrackerWritePos.LoadRelaxed();
+    TrackerSlot* slot;
+    for (;;)
+    {
+        slot = &TrackerRing[pos % TrackerRingSize];
+
+        intptr_t diff = intptr_t(slot->Sequence.Load()) - intptr_t(pos);
+        if (diff == 0)
+        {
+            if (TrackerWritePos.CompareExchangeWeak(pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Ring is full
+            TrackerDropped.Increment();
+            TrackerRecursive = false;
+            TrackerState.Decrement();
+            return;
+        }
+        else
+        {
+            pos = TrackerWritePos.LoadRelaxed();
+        }
+    }
+
+    MemoryTrackerRecord& record = slot->Record;
+    record.Size = sizeInBytes;
+    record.Heap = heap;
+    record.FrameNum = MemoryFrameNum.LoadRelaxed();
+    record.CallstackDepth = TrackerCaptureCallstack ? CaptureCallstack(record.Callstack, MemoryTrackerRecord::MaxCallstackDepth) : 0;
+
+    slot->Sequence.Store(pos + 1);
+
+    TrackerRecursive = false;
+    TrackerState.Decrement();
+}
+
+} // namespace
+
+HK_FORCEINLINE void MemoryHeap::CountAlloc(size_t sizeInBytes)
+{
+    StatShard& shard = m_Shards[GetThreadShard()];
+    shard.MemoryAllocated.Add(sizeInBytes);
+    shard.TotalAllocs.Increment();
+
+    if (HK_UNLIKELY(TrackerState.LoadRelaxed() & TRACKER_ENABLED_BIT))
+        TrackAllocation(MEMORY_HEAP(this - Core::MemoryHeaps), sizeInBytes);
+}
+
+HK_FORCEINLINE void MemoryHeap::CountFree(size_t sizeInBytes)
+{
+    StatShard& shard = m_Shards[GetThreadShard()];
+    shard.MemoryAllocated.Sub(sizeInBytes);
+    shard.TotalFrees.Increment();
+}
+
 #ifndef USE_MIMALLOC
 
 struct HeapChunk
@@ -311,9 +440,7 @@ void* MemoryHeap::_Alloc(size_t sizeInBytes, size_t alignment, MALLOC_FLAGS flag
     if (flags & MALLOC_ZERO)
         Core::ZeroMem(aligned, sizeInBytes);
 
-    m_PeakAllocated.Store(std::max(m_PeakAllocated.Load(), m_MemoryAllocated.Add(sizeInBytes)));
-    m_MemoryAllocs.Increment();
-    m_PerFrameAllocs.Increment();
+    CountAlloc(sizeInBytes);
 
     return aligned;
 }
@@ -323,9 +450,7 @@ void MemoryHeap::Free(void* ptr)
     if (!ptr)
         return;
 
-    m_MemoryAllocated.Sub((((HeapChunk*)ptr) - 1)->Size);
-    m_MemoryAllocs.Decrement();
-    m_PerFrameFrees.Increment();
+    CountFree((((HeapChunk*)ptr) - 1)->Size);
 
     free((byte*)ptr - (((HeapChunk*)ptr) - 1)->Offset);
 }
@@ -351,11 +476,9 @@ void* MemoryHeap::_Realloc(void* ptr, size_t sizeInBytes, size_t alignment, MALL
             Core::Memcpy(NewPtr, ptr, OldSize);
     }
 
-    m_MemoryAllocated.Sub((((HeapChunk*)ptr) - 1)->Size);
+    CountFree((((HeapChunk*)ptr) - 1)->Size);
 
     free((byte*)ptr - (((HeapChunk*)ptr) - 1)->Offset);
-    m_PerFrameFrees.Increment();
-    m_MemoryAllocs.Decrement();
 
     return NewPtr;
 }
@@ -382,9 +505,7 @@ void* MemoryHeap::_Alloc(size_t sizeInBytes, size_t alignment, MALLOC_FLAGS flag
         return nullptr;
     HK_ASSERT(sizeInBytes <= mi_malloc_size(ptr));
     sizeInBytes = mi_malloc_size(ptr);
-    m_PeakAllocated.Store(std::max(m_PeakAllocated.Load(), m_MemoryAllocated.Add(sizeInBytes)));
-    m_MemoryAllocs.Increment();
-    m_PerFrameAllocs.Increment();
+    CountAlloc(sizeInBytes);
 
     return ptr;
 }
@@ -394,9 +515,7 @@ void MemoryHeap::Free(void* ptr)
     if (!ptr)
         return;
 
-    m_MemoryAllocated.Sub(mi_malloc_size(ptr));
-    m_MemoryAllocs.Decrement();
-    m_PerFrameFrees.Increment();
+    CountFree(mi_malloc_size(ptr));
     mi_free(ptr);
 }
 
@@ -416,22 +535,16 @@ void* MemoryHeap::_Realloc(void* ptr, size_t sizeInBytes, size_t alignment, MALL
         return _Alloc(sizeInBytes, alignment, flags);
     }
 
-    m_MemoryAllocated.Sub(mi_malloc_size(ptr));
+    CountFree(mi_malloc_size(ptr));
 
     ptr = alignment == 0 ? mi_realloc(ptr, sizeInBytes) : mi_realloc_aligned(ptr, sizeInBytes, alignment);
     if (HK_LIKELY(ptr))
     {
         HK_ASSERT(sizeInBytes <= mi_malloc_size(ptr));
         sizeInBytes = mi_malloc_size(ptr);
-        m_PeakAllocated.Store(std::max(m_PeakAllocated.Load(), m_MemoryAllocated.Add(sizeInBytes)));
-
-        m_PerFrameAllocs.Increment();
-        m_MemoryAllocs.Increment();
+        CountAlloc(sizeInBytes);
     }
 
-    m_PerFrameFrees.Increment();
-    m_MemoryAllocs.Decrement();
-
     return ptr;
 }
 
@@ -480,13 +593,30 @@ MemoryStat MemoryHeap::sMemoryGetStat()
 
 MemoryStat MemoryHeap::GetStat()
 {
+    int64_t memoryAllocated = 0;
+    int64_t totalAllocs = 0;
+    int64_t totalFrees = 0;
+
+    for (StatShard const& shard : m_Shards)
+    {
+        memoryAllocated += shard.MemoryAllocated.LoadRelaxed();
+        totalAllocs += shard.TotalAllocs.LoadRelaxed();
+        totalFrees += shard.TotalFrees.LoadRelaxed();
+    }
+
+    // Shards are read one by one while other threads allocate, so the sum may be slightly off
+    memoryAllocated = std::max<int64_t>(memoryAllocated, 0);
+
+    int64_t peakAllocated = std::max(m_PeakAllocated.LoadRelaxed(), memoryAllocated);
+    m_PeakAllocated.StoreRelaxed(peakAllocated);
+
     MemoryStat stat;
 
-    stat.FrameAllocs     = m_PerFrameAllocs.Load();
-    stat.FrameFrees      = m_PerFrameFrees.Load();
-    stat.MemoryAllocated = m_MemoryAllocated.Load();
-    stat.MemoryAllocs    = m_MemoryAllocs.Load();
-    stat.MemoryPeakAlloc = m_PeakAllocated.Load();
+    stat.FrameAllocs     = totalAllocs - m_FrameStartAllocs.LoadRelaxed();
+    stat.FrameFrees      = totalFrees - m_FrameStartFrees.LoadRelaxed();
+    stat.MemoryAllocated = memoryAllocated;
+    stat.MemoryAllocs    = std::max<int64_t>(totalAllocs - totalFrees, 0);
+    stat.MemoryPeakAlloc = peakAllocated;
     return stat;
 }
 
@@ -495,15 +625,86 @@ void MemoryHeap::sMemoryNewFrame()
     using namespace Core;
     for (int n = 0; n < HEAP_MAX; n++)
     {
-        MemoryHeaps[n].m_PerFrameAllocs.Store(0);
-        MemoryHeaps[n].m_PerFrameFrees.Store(0);
+        MemoryHeap& heap = MemoryHeaps[n];
+
+        // Totals only grow, so frame counts are the difference with the totals at the frame start.
+        // This way the shards are written by the allocating threads only.
+        int64_t totalAllocs = 0;
+        int64_t totalFrees = 0;
+        int64_t memoryAllocated = 0;
+        for (StatShard const& shard : heap.m_Shards)
+        {
+            totalAllocs += shard.TotalAllocs.LoadRelaxed();
+            totalFrees += shard.TotalFrees.LoadRelaxed();
+            memoryAllocated += shard.MemoryAllocated.LoadRelaxed();
+        }
+
+        heap.m_FrameStartAllocs.StoreRelaxed(totalAllocs);
+        heap.m_FrameStartFrees.StoreRelaxed(totalFrees);
+        heap.m_PeakAllocated.StoreRelaxed(std::max(heap.m_PeakAllocated.LoadRelaxed(), memoryAllocated));
     }
+
+    MemoryFrameNum.Increment();
 }
 
 void MemoryHeap::sMemoryCleanup()
 {
 }
 
+void MemoryTracker::sEnable(uint32_t sampleInterval, bool captureCallstack)
+{
+    if (TrackerState.Load() & TRACKER_ENABLED_BIT)
+        return;
+
+    // Writers of the previous session can still be filling the slots
+    while (TrackerState.Load() != 0)
+        Thread::sWaitMicroseconds(10);
+
+    // Writers that start now see the tracker disabled and leave the ring untouched
+    for (size_t i = 0; i < TrackerRingSize; i++)
+        TrackerRing[i].Sequence.StoreRelaxed(i);
+    TrackerWritePos.StoreRelaxed(0);
+    TrackerReadPos = 0;
+    TrackerDropped.StoreRelaxed(0);
+
+    TrackerSampleInterval = std::max(1u, sampleInterval);
+    TrackerCaptureCallstack = captureCallstack;
+
+    TrackerState.FetchOr(TRACKER_ENABLED_BIT);
+}
+
+void MemoryTracker::sDisable()
+{
+    TrackerState.And(~TRACKER_ENABLED_BIT);
+}
+
+bool MemoryTracker::sIsEnabled()
+{
+    return !!(TrackerState.Load() & TRACKER_ENABLED_BIT);
+}
+
+size_t MemoryTracker::sRead(MemoryTrackerRecord* records, size_t maxRecords)
+{
+    size_t count = 0;
+    while (count < maxRecords)
+    {
+        TrackerSlot& slot = TrackerRing[TrackerReadPos % TrackerRingSize];
+        if (slot.Sequence.Load() != TrackerReadPos + 1)
+            break;
+
+        records[count++] = slot.Record;
+
+        slot.Sequence.Store(TrackerReadPos + TrackerRingSize);
+        TrackerReadPos++;
+    }
+    return count;
+}
+
+size_t MemoryTracker::sGetDroppedCount()
+{
+    return TrackerDropped.LoadRelaxed();
+}
+
 HK_NAMESPACE_END
 
 
@@ -75,6 +75,9 @@ struct MemoryStat
 
 struct MemoryHeap
 {
+    /// Threads are spread over the shards. Threads beyond the limit share shards.
+    static constexpr uint32_t MaxStatShards = 32;
+
     static void       sMemoryNewFrame();
     static void       sMemoryCleanup();
     static MemoryStat sMemoryGetStat();
@@ -83,17 +86,58 @@ struct MemoryHeap
     void*      Realloc(void* ptr, size_t sizeInBytes, size_t alignment = 16, MALLOC_FLAGS flags = MALLOC_FLAGS_DEFAULT);
     void       Free(void* ptr);
     size_t     GetSize(void* ptr);
+
+    /// Sum the per-thread counters. Peak is sampled here and on every new frame.
     MemoryStat GetStat();
 
 private:
     void* _Alloc(size_t sizeInBytes, size_t alignment, MALLOC_FLAGS flags);
     void* _Realloc(void* ptr, size_t sizeInBytes, size_t alignment, MALLOC_FLAGS flags);
 
-    AtomicLong m_MemoryAllocated{};
-    AtomicLong m_MemoryAllocs{};
+    void  CountAlloc(size_t sizeInBytes);
+    void  CountFree(size_t sizeInBytes);
+
+    /// Counters updated by the allocating threads. Each shard has its own cache line, so threads
+    /// do not contend on the counters. Frees may come from any thread, so a shard may go negative.
+    struct alignas(64) StatShard
+    {
+        AtomicLong MemoryAllocated{};
+        AtomicLong TotalAllocs{};
+        AtomicLong TotalFrees{};
+    };
+
+    StatShard  m_Shards[MaxStatShards];
     AtomicLong m_PeakAllocated{};
-    AtomicLong m_PerFrameAllocs{};
-    AtomicLong m_PerFrameFrees{};
+    AtomicLong m_FrameStartAllocs{};
+    AtomicLong m_FrameStartFrees{};
+};
+
+struct MemoryTrackerRecord
+{
+    static constexpr uint32_t MaxCallstackDepth = 16;
+
+    size_t      Size;
+    MEMORY_HEAP Heap;
+    uint32_t    FrameNum;
+    uint32_t    CallstackDepth;
+    void*       Callstack[MaxCallstackDepth];
+};
+
+/// Opt-in allocation tracker. Sampled allocations are recorded to a lock-free ring which is drained by
+/// a single reader, e.g. once per frame. Use it to find allocations on hot paths.
+struct MemoryTracker
+{
+    /// Record every Nth allocation of each thread. Waits for the allocations still being recorded by the previous session.
+    /// Must not be called concurrently with itself or sRead.
+    static void   sEnable(uint32_t sampleInterval = 1, bool captureCallstack = true);
+    static void   sDisable();
+    static bool   sIsEnabled();
+
+    /// Move recorded allocations to the buffer. Returns the number of records.
+    static size_t sRead(MemoryTrackerRecord* records, size_t maxRecords);
+
+    /// Number of records lost because the ring was full
+    static size_t sGetDroppedCount();
 };
 
 namespace Core
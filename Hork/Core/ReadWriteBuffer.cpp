@@ -255,9 +255,9 @@ size_t ReadWriteBuffer::GetOffset() const
     return m_RWOffset;
 }
 
-bool ReadWriteBuffer::SeekSet(int32_t offset)
+bool ReadWriteBuffer::SeekSet(int64_t offset)
 {
-    m_RWOffset = std::max(int32_t{0}, offset);
+    m_RWOffset = std::max(int64_t{0}, offset);
     if (m_RWOffset > m_Size)
         m_RWOffset = m_Size;
     return true;
@@ -79,7 +79,7 @@ public:
 
     size_t          GetOffset() const override;
 
-    bool            SeekSet(int32_t offset) override;
+    bool            SeekSet(int64_t offset) override;
 
     bool            SeekCur(int32_t offset) override;
 
@@ -30,10 +30,29 @@ SOFTWARE.
 
 layout( binding = 1, std140 ) uniform UniformBuffer1
 {
-    mat4 TransformMatrix; // From object space to world space // TODO float3x4
+    mat4 DrawCallTransformMatrix; // From object space to world space // TODO float3x4
     vec4 uaddr_0;
     vec4 uaddr_1;
     vec4 uaddr_2;
     vec4 uaddr_3;
-    uvec4 CascadeMask;
+    uint CascadeMask;
+    uint InstancedDraw;
+    uint UniformBuffer1_Pad0;
+    uint UniformBuffer1_Pad1;
 };
+
+#ifdef VERTEX_SHADER
+
+// Per-instance transforms of a batched draw call. Used when InstancedDraw is set.
+layout( binding = 8, std430 ) readonly buffer InstanceTransformBuffer
+{
+    mat4 InstanceTransforms[];
+};
+
+#define TransformMatrix ( InstancedDraw != 0 ? InstanceTransforms[gl_InstanceID] : DrawCallTransformMatrix )
+
+#else
+
+#define TransformMatrix DrawCallTransformMatrix
+
+#endif
@@ -30,11 +30,11 @@ SOFTWARE.
 
 layout( binding = 1, std140 ) uniform DrawCall
 {
-    mat4 TransformMatrix; // Instance MVP
-    mat4 TransformMatrixP; // Instance MVP from previous frame
-    vec4 ModelNormalToViewSpace0;
-    vec4 ModelNormalToViewSpace1;
-    vec4 ModelNormalToViewSpace2;
+    mat4 DrawCallTransformMatrix; // Instance MVP
+    mat4 DrawCallTransformMatrixP; // Instance MVP from previous frame
+    vec4 DrawCallModelNormalToViewSpace0;
+    vec4 DrawCallModelNormalToViewSpace1;
+    vec4 DrawCallModelNormalToViewSpace2;
     vec4 LightmapOffset;
     vec4 uaddr_0;
     vec4 uaddr_1;
@@ -43,7 +43,40 @@ layout( binding = 1, std140 ) uniform DrawCall
     vec2 VTOffset;
     vec2 VTScale;
     uint VTUnit;
-    uint DrawCall_Pad0;
+    uint InstancedDraw;
     uint DrawCall_Pad1;
     uint DrawCall_Pad2;
 };
+
+#ifdef VERTEX_SHADER
+
+struct InstanceTransform
+{
+    mat4 TransformMatrix;
+    mat4 TransformMatrixP;
+    vec4 ModelNormalToViewSpace0;
+    vec4 ModelNormalToViewSpace1;
+    vec4 ModelNormalToViewSpace2;
+};
+
+// Per-instance transforms of a batched draw call. Used when InstancedDraw is set.
+layout( binding = 8, std430 ) readonly buffer InstanceTransformBuffer
+{
+    InstanceTransform InstanceTransforms[];
+};
+
+#define TransformMatrix         ( InstancedDraw != 0 ? InstanceTransforms[gl_InstanceID].TransformMatrix : DrawCallTransformMatrix )
+#define TransformMatrixP        ( InstancedDraw != 0 ? InstanceTransforms[gl_InstanceID].TransformMatrixP : DrawCallTransformMatrixP )
+#define ModelNormalToViewSpace0 ( InstancedDraw != 0 ? InstanceTransforms[gl_InstanceID].ModelNormalToViewSpace0 : DrawCallModelNormalToViewSpace0 )
+#define ModelNormalToViewSpace1 ( InstancedDraw != 0 ? InstanceTransforms[gl_InstanceID].ModelNormalToViewSpace1 : DrawCallModelNormalToViewSpace1 )
+#define ModelNormalToViewSpace2 ( InstancedDraw != 0 ? InstanceTransforms[gl_InstanceID].ModelNormalToViewSpace2 : DrawCallModelNormalToViewSpace2 )
+
+#else
+
+#define TransformMatrix         DrawCallTransformMatrix
+#define TransformMatrixP        DrawCallTransformMatrixP
+#define ModelNormalToViewSpace0 DrawCallModelNormalToViewSpace0
+#define ModelNormalToViewSpace1 DrawCallModelNormalToViewSpace1
+#define ModelNormalToViewSpace2 DrawCallModelNormalToViewSpace2
+
+#endif
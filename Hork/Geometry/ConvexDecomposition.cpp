@@ -31,6 +31,11 @@ SOFTWARE.
 #include "ConvexDecomposition.h"
 
 #include <Hork/Core/Logger.h>
+#include <Hork/Core/HashFunc.h>
+#include <Hork/Core/AsyncJobManager.h>
+#include <Hork/Core/IO.h>
+#include <Hork/Core/Thread.h>
+#include <Hork/Core/Containers/Hash.h>
 
 #include <HACD/hacdHACD.h>
 
@@ -70,6 +75,24 @@ bool AreVerticesBehindPlane(PlaneF const& plane, Float3 const* vertices, int ver
 
 } // namespace
 
+void ConvexHullDesc::Read(IBinaryStreamReadInterface& stream)
+{
+    FirstVertex = stream.ReadInt32();
+    VertexCount = stream.ReadInt32();
+    FirstIndex = stream.ReadInt32();
+    IndexCount = stream.ReadInt32();
+    stream.ReadObject(Centroid);
+}
+
+void ConvexHullDesc::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteInt32(FirstVertex);
+    stream.WriteInt32(VertexCount);
+    stream.WriteInt32(FirstIndex);
+    stream.WriteInt32(IndexCount);
+    stream.WriteObject(Centroid);
+}
+
 namespace Geometry
 {
 
@@ -322,15 +345,19 @@ bool PerformConvexDecomposition(Float3 const* vertices,
     return !outHulls.IsEmpty();
 }
 
-bool PerformConvexDecompositionVHACD(Float3 const* vertices,
-                                     int vertexCount,
-                                     int vertexStride,
-                                     unsigned int const* indices,
-                                     int indexCount,
-                                     Vector<Float3>& outVertices,
-                                     Vector<unsigned int>& outIndices,
-                                     Vector<ConvexHullDesc>& outHulls,
-                                     Float3& centerOfMass)
+namespace
+{
+
+bool DecomposeVHACD(Float3 const* vertices,
+                    int vertexCount,
+                    int vertexStride,
+                    unsigned int const* indices,
+                    int indexCount,
+                    Vector<Float3>& outVertices,
+                    Vector<unsigned int>& outIndices,
+                    Vector<ConvexHullDesc>& outHulls,
+                    Float3& centerOfMass,
+                    bool isBatch)
 {
     class Callback : public VHACD::IVHACD::IUserCallback
     {
@@ -358,7 +385,7 @@ bool PerformConvexDecompositionVHACD(Float3 const* vertices,
     VHACD::IVHACD* vhacd = VHACD::CreateVHACD();
 
     VHACD::IVHACD::Parameters params;
-    params.m_callback = &callback;                   // Optional user provided callback interface for progress
+    params.m_callback = isBatch ? nullptr : &callback; // Optional user provided callback interface for progress
     params.m_logger = &logger;                       // Optional user provided callback interface for log messages
     params.m_taskRunner = nullptr;                   // Optional user provided interface for creating tasks
     params.m_maxConvexHulls = 64;                    // The maximum number of convex hulls to produce
@@ -368,7 +395,7 @@ bool PerformConvexDecompositionVHACD(Float3 const* vertices,
     params.m_shrinkWrap = true;                      // Whether or not to shrinkwrap the voxel positions to the source mesh on output
     params.m_fillMode = VHACD::FillMode::FLOOD_FILL; // How to fill the interior of the voxelized mesh //FLOOD_FILL SURFACE_ONLY RAYCAST_FILL
     params.m_maxNumVerticesPerCH = 64;               // The maximum number of vertices allowed in any output convex hull
-    params.m_asyncACD = true;                        // Whether or not to run asynchronously, taking advantage of additonal cores
+    params.m_asyncACD = !isBatch;                    // Whether or not to run asynchronously, taking advantage of additonal cores. Batches on job lists are already parallel.
     params.m_minEdgeLength = 2;                      // Once a voxel patch has an edge length of less than 4 on all 3 sides, we don't keep recursing
     params.m_findBestPlane = false;                  // Whether or not to attempt to split planes along the best location. Experimental feature. False by default.
 
@@ -458,6 +485,269 @@ bool PerformConvexDecompositionVHACD(Float3 const* vertices,
     return !outHulls.IsEmpty();
 }
 
+} // namespace
+
+bool PerformConvexDecompositionVHACD(Float3 const* vertices,
+                                     int vertexCount,
+                                     int vertexStride,
+                                     unsigned int const* indices,
+                                     int indexCount,
+                                     Vector<Float3>& outVertices,
+                                     Vector<unsigned int>& outIndices,
+                                     Vector<ConvexHullDesc>& outHulls,
+                                     Float3& centerOfMass)
+{
+    return DecomposeVHACD(vertices, vertexCount, vertexStride, indices, indexCount, outVertices, outIndices, outHulls, centerOfMass, false);
+}
+
+namespace
+{
+
+// Increment when the decomposition parameters are changed to invalidate the cache
+constexpr uint32_t HullCacheVersion = 1;
+constexpr uint32_t HullCacheMagic = 'H' | ('k' << 8) | ('C' << 16) | ('D' << 24);
+
+uint64_t CalcSourceHash(ConvexDecompositionSource const& source, ConvexDecompositionMethod method)
+{
+    Vector<Float3> positions(source.VertexCount);
+    byte const* srcVertices = (byte const*)source.Vertices;
+    for (int i = 0; i < source.VertexCount; i++)
+    {
+        positions[i] = *(Float3 const*)srcVertices;
+        srcVertices += source.VertexStride;
+    }
+
+    uint32_t seed = HullCacheVersion | (uint32_t(method) << 16);
+
+    uint32_t lo = HashTraits::Murmur3Hash((const char*)positions.ToPtr(), positions.Size() * sizeof(Float3), seed);
+    lo = HashTraits::Murmur3Hash((const char*)source.Indices, source.IndexCount * sizeof(unsigned int), lo);
+
+    uint32_t hi = HashTraits::Murmur3Hash((const char*)source.Indices, source.IndexCount * sizeof(unsigned int), ~seed);
+    hi = HashTraits::Murmur3Hash((const char*)positions.ToPtr(), positions.Size() * sizeof(Float3), hi);
+
+    return (uint64_t(hi) << 32) | lo;
+}
+
+/// Read array with the element count checked against the rest of the file, so a truncated file doesn't cause a huge allocation
+template <typename T>
+bool ReadHullCacheArray(File& file, T& array, size_t elementSize)
+{
+    if (file.SizeInBytes() - file.GetOffset() < sizeof(uint32_t))
+        return false;
+
+    uint32_t size = file.ReadUInt32();
+    if (size > (file.SizeInBytes() - file.GetOffset()) / elementSize)
+        return false;
+
+    file.SeekCur(-int32_t(sizeof(uint32_t)));
+    file.ReadArray(array);
+    return true;
+}
+
+bool ReadHullCache(StringView fileName, ConvexDecompositionSource const& source, ConvexDecompositionResult& result)
+{
+    if (!Core::IsFileExists(fileName))
+        return false;
+
+    File file = File::sOpenRead(fileName);
+    if (!file)
+        return false;
+
+    if (file.ReadUInt32() != HullCacheMagic || file.ReadUInt32() != HullCacheVersion)
+        return false;
+
+    // Guard against hash collisions
+    if (file.ReadUInt32() != uint32_t(source.VertexCount) || file.ReadUInt32() != uint32_t(source.IndexCount))
+        return false;
+
+    if (!ReadHullCacheArray(file, result.Vertices, sizeof(Float3)) ||
+        !ReadHullCacheArray(file, result.Indices, sizeof(unsigned int)) ||
+        !ReadHullCacheArray(file, result.Hulls, sizeof(int) * 4 + sizeof(Float3)) ||
+        file.SizeInBytes() - file.GetOffset() < sizeof(Float3))
+    {
+        LOG("PerformConvexDecompositionBatch: Truncated hull cache {}\n", fileName);
+        return false;
+    }
+    file.ReadObject(result.CenterOfMass);
+
+    int vertexCount = result.Vertices.Size();
+    int indexCount = result.Indices.Size();
+    for (ConvexHullDesc const& hull : result.Hulls)
+    {
+        if (hull.FirstVertex < 0 || hull.VertexCount < 0 || hull.FirstVertex > vertexCount - hull.VertexCount ||
+            hull.FirstIndex < 0 || hull.IndexCount < 0 || hull.FirstIndex > indexCount - hull.IndexCount)
+        {
+            LOG("PerformConvexDecompositionBatch: Corrupted hull cache {}\n", fileName);
+            return false;
+        }
+
+        // Hull indices are relative to the first vertex of the hull
+        unsigned int const* hullIndices = result.Indices.ToPtr() + hull.FirstIndex;
+        for (int i = 0; i < hull.IndexCount; i++)
+        {
+            if (hullIndices[i] >= uint32_t(hull.VertexCount))
+            {
+                LOG("PerformConvexDecompositionBatch: Corrupted hull cache {}\n", fileName);
+                return false;
+            }
+        }
+    }
+
+    return !result.Hulls.IsEmpty();
+}
+
+void WriteHullCache(StringView fileName, ConvexDecompositionSource const& source, ConvexDecompositionResult const& result)
+{
+    // Write to a temporary file and move it in place, so readers never see a partially written cache
+    String tempFileName;
+    tempFileName = HK_FORMAT("{}.{}.tmp", fileName, Thread::sThisThreadId());
+
+    File file = File::sOpenWrite(tempFileName);
+    if (!file)
+    {
+        LOG("PerformConvexDecompositionBatch: Failed to write hull cache {}\n", fileName);
+        return;
+    }
+
+    file.WriteUInt32(HullCacheMagic);
+    file.WriteUInt32(HullCacheVersion);
+    file.WriteUInt32(source.VertexCount);
+    file.WriteUInt32(source.IndexCount);
+    file.WriteArray(result.Vertices);
+    file.WriteArray(result.Indices);
+    file.WriteArray(result.Hulls);
+    file.WriteObject(result.CenterOfMass);
+    file.Close();
+
+    if (!Core::RenameFile(tempFileName, fileName))
+    {
+        LOG("PerformConvexDecompositionBatch: Failed to write hull cache {}\n", fileName);
+        Core::RemoveFile(tempFileName);
+    }
+}
+
+struct DecompositionBatch
+{
+    ArrayView<ConvexDecompositionSource>    Sources;
+    ConvexDecompositionResult*              Results;
+    ConvexDecompositionBatchSettings const* Settings;
+    Vector<uint64_t>                        Keys;
+    /// Sources to decompose. Sources with the same key are decomposed only once.
+    Vector<int>                             UniqueSources;
+    AtomicInt                               NextSource{0};
+};
+
+void DecomposeSource(ConvexDecompositionSource const& source, uint64_t key, ConvexDecompositionResult& result, ConvexDecompositionBatchSettings const& settings)
+{
+    String cacheFileName;
+    if (!settings.CacheDirectory.IsEmpty())
+    {
+        cacheFileName = HK_FORMAT("{}/{:016x}.hulls", settings.CacheDirectory, key);
+
+        if (ReadHullCache(cacheFileName, source, result))
+        {
+            result.IsCached = true;
+            return;
+        }
+    }
+
+    result.IsCached = false;
+    result.CenterOfMass.Clear();
+
+    if (settings.Method == ConvexDecompositionMethod::HACD)
+    {
+        PerformConvexDecomposition(source.Vertices, source.VertexCount, source.VertexStride, source.Indices, source.IndexCount,
+                                   result.Vertices, result.Indices, result.Hulls);
+    }
+    else
+    {
+        DecomposeVHACD(source.Vertices, source.VertexCount, source.VertexStride, source.Indices, source.IndexCount,
+                       result.Vertices, result.Indices, result.Hulls, result.CenterOfMass, settings.JobList != nullptr);
+    }
+
+    if (!cacheFileName.IsEmpty() && !result.Hulls.IsEmpty())
+        WriteHullCache(cacheFileName, source, result);
+}
+
+void DecompositionJob(void* data)
+{
+    DecompositionBatch* batch = (DecompositionBatch*)data;
+
+    // Meshes are fetched one by one, so the workers stay busy when decomposition times differ a lot
+    int next;
+    while ((next = batch->NextSource.Increment() - 1) < (int)batch->UniqueSources.Size())
+    {
+        int index = batch->UniqueSources[next];
+        DecomposeSource(batch->Sources[index], batch->Keys[index], batch->Results[index], *batch->Settings);
+    }
+}
+
+} // namespace
+
+int PerformConvexDecompositionBatch(ArrayView<ConvexDecompositionSource> sources,
+                                    Vector<ConvexDecompositionResult>& outResults,
+                                    ConvexDecompositionBatchSettings const& settings)
+{
+    outResults.Clear();
+    outResults.Resize(sources.Size());
+
+    if (!settings.CacheDirectory.IsEmpty())
+        Core::CreateDirectory(settings.CacheDirectory, false);
+
+    DecompositionBatch batch;
+    batch.Sources = sources;
+    batch.Results = outResults.ToPtr();
+    batch.Settings = &settings;
+
+    // Identical meshes are decomposed once. This also keeps the jobs from writing the same cache file.
+    Vector<int> sourceRemap(sources.Size());
+    HashMap<uint64_t, int> keyToSource;
+    batch.Keys.Resize(sources.Size());
+    for (int i = 0; i < (int)sources.Size(); i++)
+    {
+        batch.Keys[i] = CalcSourceHash(sources[i], settings.Method);
+
+        auto it = keyToSource.Find(batch.Keys[i]);
+        if (it != keyToSource.End() &&
+            sources[it->second].VertexCount == sources[i].VertexCount &&
+            sources[it->second].IndexCount == sources[i].IndexCount)
+        {
+            sourceRemap[i] = it->second;
+            continue;
+        }
+
+        keyToSource[batch.Keys[i]] = i;
+        sourceRemap[i] = i;
+        batch.UniqueSources.Add(i);
+    }
+
+    if (settings.JobList)
+    {
+        int jobCount = Math::Min<int>(batch.UniqueSources.Size(), AsyncJobManager::MAX_WORKER_THREADS);
+        for (int i = 0; i < jobCount; i++)
+            settings.JobList->AddJob(DecompositionJob, &batch);
+        settings.JobList->SubmitAndWait();
+    }
+    else
+    {
+        DecompositionJob(&batch);
+    }
+
+    for (int i = 0; i < (int)sources.Size(); i++)
+    {
+        if (sourceRemap[i] != i)
+            outResults[i] = outResults[sourceRemap[i]];
+    }
+
+    int numDecomposed = 0;
+    for (ConvexDecompositionResult const& result : outResults)
+    {
+        if (!result.Hulls.IsEmpty())
+            numDecomposed++;
+    }
+    return numDecomposed;
+}
+
 } // namespace Geometry
 
 HK_NAMESPACE_END
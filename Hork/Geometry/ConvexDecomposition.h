@@ -31,10 +31,13 @@ SOFTWARE.
 #pragma once
 
 #include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/Containers/ArrayView.h>
 #include <Hork/Math/Plane.h>
 
 HK_NAMESPACE_BEGIN
 
+class AsyncJobList;
+
 struct ConvexHullDesc
 {
     int    FirstVertex;
@@ -42,6 +45,47 @@ struct ConvexHullDesc
     int    FirstIndex;
     int    IndexCount;
     Float3 Centroid;
+
+    void Read(IBinaryStreamReadInterface& stream);
+    void Write(IBinaryStreamWriteInterface& stream) const;
+};
+
+enum class ConvexDecompositionMethod : uint8_t
+{
+    HACD,
+    VHACD
+};
+
+/// Source mesh for batch decomposition. The data must stay valid until the batch is done.
+struct ConvexDecompositionSource
+{
+    Float3 const*       Vertices = nullptr;
+    int                 VertexCount = 0;
+    int                 VertexStride = sizeof(Float3);
+    unsigned int const* Indices = nullptr;
+    int                 IndexCount = 0;
+};
+
+struct ConvexDecompositionResult
+{
+    Vector<Float3>          Vertices;
+    Vector<unsigned int>    Indices;
+    Vector<ConvexHullDesc>  Hulls;
+    Float3                  CenterOfMass;
+    /// Hulls were read from the cache
+    bool                    IsCached = false;
+};
+
+struct ConvexDecompositionBatchSettings
+{
+    ConvexDecompositionMethod Method = ConvexDecompositionMethod::VHACD;
+
+    /// Decompose meshes as independent jobs of the list. Meshes are decomposed on the calling thread if not specified.
+    AsyncJobList*           JobList = nullptr;
+
+    /// Directory of the hull cache. Hulls of the meshes with the same content are read from the cache
+    /// instead of decomposition. The cache is not used if the directory is empty.
+    StringView              CacheDirectory;
 };
 
 namespace Geometry
@@ -68,6 +112,11 @@ bool PerformConvexDecompositionVHACD(Float3 const* vertices,
                                      Vector<ConvexHullDesc>& outHulls,
                                      Float3& centerOfMass);
 
+/// Decompose many meshes at once. Returns the number of meshes that have at least one hull.
+int PerformConvexDecompositionBatch(ArrayView<ConvexDecompositionSource> sources,
+                                    Vector<ConvexDecompositionResult>& outResults,
+                                    ConvexDecompositionBatchSettings const& settings);
+
 void ConvexHullPlanesFromVertices(Float3 const* vertices, int vertexCount, Vector<PlaneF>& planes);
 
 void ConvexHullVerticesFromPlanes(PlaneF const* planes, int planeCount, Vector<Float3>& vertices);
@@ -0,0 +1,409 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "MeshOptimizer.h"
+
+#include <Hork/Core/BaseMath.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace Geometry
+{
+
+namespace
+{
+
+constexpr uint32_t MaxVertexCacheSize = 64;
+constexpr uint32_t MaxValence = 32;
+
+// Forsyth's scoring parameters
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+struct VertexScoreTable
+{
+    float CacheScore[MaxVertexCacheSize + 3];
+    float ValenceScore[MaxValence + 1];
+
+    VertexScoreTable(uint32_t cacheSize)
+    {
+        for (uint32_t i = 0; i < HK_ARRAY_SIZE(CacheScore); ++i)
+        {
+            if (i < 3)
+                CacheScore[i] = LastTriangleScore;
+            else if (i < cacheSize)
+                CacheScore[i] = Math::Pow(1.0f - float(i - 3) / float(cacheSize - 3), CacheDecayPower);
+            else
+                CacheScore[i] = 0.0f;
+        }
+
+        ValenceScore[0] = 0.0f;
+        for (uint32_t i = 1; i <= MaxValence; ++i)
+            ValenceScore[i] = ValenceBoostScale * Math::Pow(float(i), -ValenceBoostPower);
+    }
+
+    float Get(int cachePosition, uint32_t remainingValence) const
+    {
+        // No triangles left to emit
+        if (remainingValence == 0)
+            return -1.0f;
+
+        float score = cachePosition >= 0 ? CacheScore[cachePosition] : 0.0f;
+        return score + ValenceScore[Math::Min(remainingValence, MaxValence)];
+    }
+};
+
+} // namespace
+
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+    const uint32_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || vertexCount == 0)
+        return;
+
+    cacheSize = Math::Clamp<uint32_t>(cacheSize, 4, MaxVertexCacheSize);
+
+    VertexScoreTable scoreTable(cacheSize);
+
+    // Build vertex to triangle adjacency. The remaining valence is also the size of the adjacency list,
+    // emitted triangles are removed from the lists.
+    Vector<uint32_t> valence(vertexCount, 0);
+    for (uint32_t i = 0; i < triangleCount * 3; ++i)
+    {
+        HK_ASSERT(indices[i] < vertexCount);
+        valence[indices[i]]++;
+    }
+
+    Vector<uint32_t> adjacencyOffset(vertexCount);
+    uint32_t offset = 0;
+    for (size_t v = 0; v < vertexCount; ++v)
+    {
+        adjacencyOffset[v] = offset;
+        offset += valence[v];
+    }
+
+    Vector<uint32_t> adjacency(offset);
+    Vector<uint32_t> fill(vertexCount, 0);
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t v = indices[t * 3 + k];
+            adjacency[adjacencyOffset[v] + fill[v]++] = t;
+        }
+    }
+
+    Vector<int> cachePosition(vertexCount, -1);
+    Vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = scoreTable.Get(-1, valence[v]);
+
+    Vector<float> triangleScore(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    Vector<uint8_t> emitted(triangleCount, 0);
+    Vector<uint32_t> output(triangleCount * 3);
+
+    uint32_t cache[MaxVertexCacheSize + 3];
+    uint32_t cacheCount = 0;
+
+    uint32_t inputCursor = 0;
+    uint32_t bestTriangle = ~0u;
+
+    for (uint32_t outputTriangle = 0; outputTriangle < triangleCount; ++outputTriangle)
+    {
+        // Nothing adjacent to the cache: continue with the next triangle in input order
+        if (bestTriangle == ~0u)
+        {
+            while (emitted[inputCursor])
+                ++inputCursor;
+            bestTriangle = inputCursor;
+        }
+
+        uint32_t const* triangle = &indices[bestTriangle * 3];
+
+        output[outputTriangle * 3 + 0] = triangle[0];
+        output[outputTriangle * 3 + 1] = triangle[1];
+        output[outputTriangle * 3 + 2] = triangle[2];
+
+        emitted[bestTriangle] = 1;
+
+        // Remove the triangle from the adjacency of its vertices
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t v = triangle[k];
+            uint32_t* list = &adjacency[adjacencyOffset[v]];
+            uint32_t count = valence[v];
+            for (uint32_t j = 0; j < count; ++j)
+            {
+                if (list[j] == bestTriangle)
+                {
+                    list[j] = list[count - 1];
+                    valence[v]--;
+                    break;
+                }
+            }
+        }
+
+        // Move triangle vertices to the front of the LRU cache
+        uint32_t newCache[MaxVertexCacheSize + 3];
+        uint32_t newCacheCount = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            uint32_t v = triangle[k];
+            if (k > 0 && (v == triangle[0] || (k == 2 && v == triangle[1])))
+                continue;
+            newCache[newCacheCount++] = v;
+        }
+        for (uint32_t i = 0; i < cacheCount; ++i)
+        {
+            uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                newCache[newCacheCount++] = v;
+        }
+
+        // Update scores of the vertices that were touched, including ones that were pushed out of the cache
+        for (uint32_t i = 0; i < newCacheCount; ++i)
+        {
+            uint32_t v = newCache[i];
+
+            cachePosition[v] = i < cacheSize ? int(i) : -1;
+
+            float score = scoreTable.Get(cachePosition[v], valence[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+
+            uint32_t const* list = &adjacency[adjacencyOffset[v]];
+            for (uint32_t j = 0, count = valence[v]; j < count; ++j)
+                triangleScore[list[j]] += delta;
+        }
+
+        cacheCount = Math::Min(newCacheCount, cacheSize);
+        Core::Memcpy(cache, newCache, cacheCount * sizeof(cache[0]));
+
+        // Pick the best triangle among those adjacent to the cache
+        bestTriangle = ~0u;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < cacheCount; ++i)
+        {
+            uint32_t v = cache[i];
+            uint32_t const* list = &adjacency[adjacencyOffset[v]];
+            for (uint32_t j = 0, count = valence[v]; j < count; ++j)
+            {
+                if (triangleScore[list[j]] > bestScore)
+                {
+                    bestScore = triangleScore[list[j]];
+                    bestTriangle = list[j];
+                }
+            }
+        }
+    }
+
+    Core::Memcpy(indices, output.ToPtr(), output.Size() * sizeof(uint32_t));
+}
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, Float3 const* positions, size_t vertexCount, uint32_t cacheSize, float threshold)
+{
+    const uint32_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || vertexCount == 0)
+        return;
+
+    const float meshACMR = CalcACMR(indices, triangleCount * 3, vertexCount, cacheSize);
+
+    // Split the triangle list into clusters. Triangles that miss the whole cache start a new cluster (hard boundary),
+    // triangles that miss two vertices start a new cluster only if the current one keeps cache efficiency
+    // close to the mesh average (soft boundary).
+    Vector<uint32_t> clusters;
+    {
+        Vector<uint32_t> timestamp(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        uint32_t clusterMisses = 0;
+        uint32_t clusterTriangles = 0;
+
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            uint32_t misses = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t v = indices[t * 3 + k];
+                if (time - timestamp[v] > cacheSize)
+                {
+                    timestamp[v] = time++;
+                    misses++;
+                }
+            }
+
+            bool split = false;
+            if (clusterTriangles == 0)
+                split = true;
+            else if (misses == 3)
+                split = true;
+            else if (misses == 2 && float(clusterMisses) / float(clusterTriangles) <= meshACMR * threshold)
+                split = true;
+
+            if (split)
+            {
+                clusters.Add(t);
+                clusterMisses = 0;
+                clusterTriangles = 0;
+            }
+
+            clusterMisses += misses;
+            clusterTriangles++;
+        }
+    }
+
+    const uint32_t clusterCount = clusters.Size();
+    if (clusterCount < 2)
+        return;
+
+    struct ClusterSortKey
+    {
+        float    Key;
+        uint32_t Cluster;
+    };
+
+    Float3 meshCentroid;
+    float meshArea = 0;
+
+    Vector<Float3> clusterCentroid(clusterCount);
+    Vector<Float3> clusterNormal(clusterCount);
+
+    for (uint32_t c = 0; c < clusterCount; ++c)
+    {
+        uint32_t first = clusters[c];
+        uint32_t last = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+
+        Float3 centroid;
+        Float3 normal;
+        float area = 0;
+
+        for (uint32_t t = first; t < last; ++t)
+        {
+            Float3 const& p0 = positions[indices[t * 3 + 0]];
+            Float3 const& p1 = positions[indices[t * 3 + 1]];
+            Float3 const& p2 = positions[indices[t * 3 + 2]];
+
+            Float3 n = Math::Cross(p1 - p0, p2 - p0);
+            float triangleArea = n.Length();
+
+            centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal += n;
+            area += triangleArea;
+        }
+
+        meshCentroid += centroid;
+        meshArea += area;
+
+        clusterCentroid[c] = area > 0.0f ? centroid / area : positions[indices[first * 3]];
+        clusterNormal[c] = Math::Dot(normal, normal) > 0.0f ? normal.Normalized() : Float3(0.0f);
+    }
+
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // Clusters facing away from the mesh center are likely to occlude others, draw them first
+    Vector<ClusterSortKey> sortKeys(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; ++c)
+    {
+        sortKeys[c].Key = Math::Dot(clusterCentroid[c] - meshCentroid, clusterNormal[c]);
+        sortKeys[c].Cluster = c;
+    }
+
+    std::stable_sort(sortKeys.Begin(), sortKeys.End(), [](ClusterSortKey const& a, ClusterSortKey const& b)
+        {
+            return a.Key > b.Key;
+        });
+
+    Vector<uint32_t> output(triangleCount * 3);
+    uint32_t outputOffset = 0;
+    for (ClusterSortKey const& sortKey : sortKeys)
+    {
+        uint32_t c = sortKey.Cluster;
+        uint32_t first = clusters[c];
+        uint32_t last = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+        uint32_t count = (last - first) * 3;
+
+        Core::Memcpy(&output[outputOffset], &indices[first * 3], count * sizeof(uint32_t));
+        outputOffset += count;
+    }
+
+    Core::Memcpy(indices, output.ToPtr(), output.Size() * sizeof(uint32_t));
+}
+
+uint32_t OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount, Vector<uint32_t>& remap)
+{
+    remap.Clear();
+    remap.Resize(vertexCount, ~0u);
+
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        uint32_t v = indices[i];
+        HK_ASSERT(v < vertexCount);
+
+        if (remap[v] == ~0u)
+            remap[v] = nextVertex++;
+
+        indices[i] = remap[v];
+    }
+    return nextVertex;
+}
+
+float CalcACMR(uint32_t const* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return 0.0f;
+
+    // FIFO cache simulation: a vertex is in the cache if fewer than cacheSize misses happened since it was loaded
+    Vector<uint32_t> timestamp(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        uint32_t v = indices[i];
+        if (time - timestamp[v] > cacheSize)
+        {
+            timestamp[v] = time++;
+            misses++;
+        }
+    }
+
+    return float(misses) / float(triangleCount);
+}
+
+} // namespace Geometry
+
+HK_NAMESPACE_END
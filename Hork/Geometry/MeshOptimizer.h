@@ -0,0 +1,76 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/Core/Containers/Vector.h>
+#include <Hork/Math/VectorMath.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace Geometry
+{
+
+/// Reorder triangles to reduce post-transform vertex cache misses (Forsyth's linear-speed optimization).
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 32);
+
+/// Split a cache-optimized triangle list into clusters at cache boundaries and sort them front-to-back
+/// by their outward facing, reducing overdraw (Tipsify/Sander et al.). Run after OptimizeVertexCache.
+/// Clusters are only broken where the cluster's ACMR is below the threshold (1.05 keeps ~5% of cache efficiency).
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, Float3 const* positions, size_t vertexCount, uint32_t cacheSize = 16, float threshold = 1.05f);
+
+/// Build a vertex remap table in first-use order of the index buffer to make vertex fetch sequential.
+/// Unreferenced vertices are mapped to ~0u. Indices are rewritten in place. Returns the number of used vertices.
+uint32_t OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount, Vector<uint32_t>& remap);
+
+/// Apply remap table produced by OptimizeVertexFetch to a vertex attribute stream.
+template <typename T, typename Allocator>
+void RemapVertexStream(Vector<T, Allocator>& stream, Vector<uint32_t> const& remap, uint32_t newVertexCount)
+{
+    if (stream.IsEmpty())
+        return;
+
+    HK_ASSERT(stream.Size() == remap.Size());
+
+    Vector<T, Allocator> remapped(newVertexCount);
+    for (uint32_t n = 0, count = remap.Size(); n < count; ++n)
+    {
+        if (remap[n] != ~0u)
+            remapped[remap[n]] = stream[n];
+    }
+    stream = std::move(remapped);
+}
+
+/// Average cache miss ratio (transformed vertices per triangle) for a FIFO cache of given size.
+float CalcACMR(uint32_t const* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+} // namespace Geometry
+
+HK_NAMESPACE_END
@@ -0,0 +1,439 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "MeshSimplifier.h"
+
+#include <Hork/Core/Containers/Vector.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace Geometry
+{
+
+namespace
+{
+
+struct Quadric
+{
+    double A00 = 0, A01 = 0, A02 = 0, A03 = 0;
+    double A11 = 0, A12 = 0, A13 = 0;
+    double A22 = 0, A23 = 0;
+    double A33 = 0;
+    double Weight = 0;
+
+    void AddPlane(double a, double b, double c, double d, double weight)
+    {
+        A00 += weight * a * a;
+        A01 += weight * a * b;
+        A02 += weight * a * c;
+        A03 += weight * a * d;
+        A11 += weight * b * b;
+        A12 += weight * b * c;
+        A13 += weight * b * d;
+        A22 += weight * c * c;
+        A23 += weight * c * d;
+        A33 += weight * d * d;
+        Weight += weight;
+    }
+
+    void operator+=(Quadric const& rhs)
+    {
+        A00 += rhs.A00;
+        A01 += rhs.A01;
+        A02 += rhs.A02;
+        A03 += rhs.A03;
+        A11 += rhs.A11;
+        A12 += rhs.A12;
+        A13 += rhs.A13;
+        A22 += rhs.A22;
+        A23 += rhs.A23;
+        A33 += rhs.A33;
+        Weight += rhs.Weight;
+    }
+
+    /// Area-weighted squared distance from the point to the accumulated planes
+    double Evaluate(Float3 const& p) const
+    {
+        double x = p.X, y = p.Y, z = p.Z;
+        double error = A00 * x * x + 2 * A01 * x * y + 2 * A02 * x * z + 2 * A03 * x +
+                       A11 * y * y + 2 * A12 * y * z + 2 * A13 * y +
+                       A22 * z * z + 2 * A23 * z +
+                       A33;
+        return Weight > 0 ? Math::Max(error, 0.0) / Weight : 0.0;
+    }
+};
+
+struct EdgeCollapse
+{
+    uint32_t From;
+    uint32_t To;
+    float    Error;
+};
+
+HK_FORCEINLINE bool IsCollapseFlipsTriangles(uint32_t from, uint32_t to, Float3 const* positions, uint32_t const* indices, uint32_t const* adjacency, uint32_t adjacencyCount)
+{
+    Float3 const& target = positions[to];
+
+    for (uint32_t i = 0; i < adjacencyCount; ++i)
+    {
+        uint32_t const* triangle = &indices[adjacency[i] * 3];
+
+        // Triangles that share the edge are removed by the collapse
+        if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            continue;
+
+        Float3 p0 = positions[triangle[0]];
+        Float3 p1 = positions[triangle[1]];
+        Float3 p2 = positions[triangle[2]];
+
+        Float3 n0 = Math::Cross(p1 - p0, p2 - p0);
+
+        if (triangle[0] == from)
+            p0 = target;
+        else if (triangle[1] == from)
+            p1 = target;
+        else
+            p2 = target;
+
+        Float3 n1 = Math::Cross(p1 - p0, p2 - p0);
+
+        if (Math::Dot(n0, n1) <= 1e-2f * n0.Length() * n1.Length())
+            return true;
+    }
+    return false;
+}
+
+HK_FORCEINLINE bool IsEdgeExists(uint32_t from, uint32_t to, uint32_t const* indices, uint32_t const* adjacency, uint32_t adjacencyCount)
+{
+    for (uint32_t i = 0; i < adjacencyCount; ++i)
+    {
+        uint32_t const* triangle = &indices[adjacency[i] * 3];
+        if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            return true;
+    }
+    return false;
+}
+
+HK_FORCEINLINE void TouchTriangles(Vector<uint8_t>& touched, uint32_t const* indices, uint32_t const* adjacency, uint32_t adjacencyCount)
+{
+    for (uint32_t i = 0; i < adjacencyCount; ++i)
+    {
+        uint32_t const* triangle = &indices[adjacency[i] * 3];
+        touched[triangle[0]] = 1;
+        touched[triangle[1]] = 1;
+        touched[triangle[2]] = 1;
+    }
+}
+
+constexpr uint32_t InvalidVertex = ~0u;
+
+} // namespace
+
+size_t SimplifyMesh(uint32_t* outIndices, uint32_t const* indices, size_t indexCount, Float3 const* positions, size_t vertexCount, size_t targetIndexCount, float maxError, float* outError)
+{
+    indexCount -= indexCount % 3;
+
+    if (outIndices != indices)
+        Core::Memcpy(outIndices, indices, indexCount * sizeof(uint32_t));
+
+    if (outError)
+        *outError = 0;
+
+    if (indexCount <= targetIndexCount || vertexCount == 0)
+        return indexCount;
+
+    // Vertices that share position with other vertices lie on attribute seams. A seam vertex with a single
+    // pair may be collapsed along the seam together with its pair, seam vertices shared by more than two
+    // vertices are locked.
+    Vector<uint32_t> positionRemap(vertexCount);
+    Vector<uint32_t> seamPair(vertexCount, InvalidVertex);
+    Vector<uint8_t> locked(vertexCount, 0);
+    {
+        Vector<uint32_t> order(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            order[v] = v;
+
+        std::sort(order.Begin(), order.End(), [positions](uint32_t a, uint32_t b)
+            {
+                Float3 const& pa = positions[a];
+                Float3 const& pb = positions[b];
+                if (pa.X != pb.X) return pa.X < pb.X;
+                if (pa.Y != pb.Y) return pa.Y < pb.Y;
+                return pa.Z < pb.Z;
+            });
+
+        for (size_t i = 0; i < vertexCount;)
+        {
+            size_t j = i + 1;
+            while (j < vertexCount && positions[order[j]] == positions[order[i]])
+                ++j;
+
+            for (size_t k = i; k < j; ++k)
+            {
+                positionRemap[order[k]] = order[i];
+                if (j - i > 2)
+                    locked[order[k]] = 1;
+            }
+            if (j - i == 2)
+            {
+                seamPair[order[i]] = order[i + 1];
+                seamPair[order[i + 1]] = order[i];
+            }
+            i = j;
+        }
+    }
+
+    // Edges that belong to a single triangle (in position space) form open borders
+    {
+        Vector<uint64_t> edges;
+        edges.Reserve(indexCount);
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                uint64_t a = positionRemap[indices[i + k]];
+                uint64_t b = positionRemap[indices[i + (k + 1) % 3]];
+                edges.Add(a < b ? (a << 32) | b : (b << 32) | a);
+            }
+        }
+
+        std::sort(edges.Begin(), edges.End());
+
+        for (size_t i = 0; i < edges.Size();)
+        {
+            size_t j = i + 1;
+            while (j < edges.Size() && edges[j] == edges[i])
+                ++j;
+
+            if (j - i == 1)
+            {
+                uint32_t a = uint32_t(edges[i] >> 32);
+                uint32_t b = uint32_t(edges[i] & 0xffffffff);
+                locked[a] = 1;
+                locked[b] = 1;
+            }
+            i = j;
+        }
+
+        // Propagate to all vertices at the same position
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            locked[v] |= locked[positionRemap[v]];
+    }
+
+    Vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < indexCount; i += 3)
+    {
+        Float3 const& p0 = positions[indices[i + 0]];
+        Float3 const& p1 = positions[indices[i + 1]];
+        Float3 const& p2 = positions[indices[i + 2]];
+
+        Float3 normal = Math::Cross(p1 - p0, p2 - p0);
+        float area = normal.Length();
+        if (area <= 0.0f)
+            continue;
+
+        normal /= area;
+
+        Quadric q;
+        q.AddPlane(normal.X, normal.Y, normal.Z, -Math::Dot(normal, p0), area);
+
+        quadrics[indices[i + 0]] += q;
+        quadrics[indices[i + 1]] += q;
+        quadrics[indices[i + 2]] += q;
+    }
+
+    const double maxErrorSqr = double(maxError) * maxError;
+    double resultError = 0;
+
+    Vector<uint32_t> adjacencyOffset(vertexCount + 1);
+    Vector<uint32_t> adjacency;
+    Vector<EdgeCollapse> collapses;
+    Vector<uint32_t> remap(vertexCount);
+    Vector<uint8_t> touched(vertexCount);
+
+    const int MaxPasses = 100;
+    for (int pass = 0; pass < MaxPasses && indexCount > targetIndexCount; ++pass)
+    {
+        const uint32_t triangleCount = indexCount / 3;
+
+        // Vertex to triangle adjacency
+        adjacencyOffset.ZeroMem();
+        for (size_t i = 0; i < indexCount; ++i)
+            adjacencyOffset[outIndices[i] + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v)
+            adjacencyOffset[v + 1] += adjacencyOffset[v];
+
+        adjacency.Resize(indexCount);
+        for (uint32_t t = 0; t < triangleCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                adjacency[adjacencyOffset[outIndices[t * 3 + k]]++] = t;
+        }
+        // Restore offsets shifted by the fill
+        for (size_t v = vertexCount; v > 0; --v)
+            adjacencyOffset[v] = adjacencyOffset[v - 1];
+        adjacencyOffset[0] = 0;
+
+        // Gather candidate collapses
+        collapses.Clear();
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                uint32_t a = outIndices[i + k];
+                uint32_t b = outIndices[i + (k + 1) % 3];
+
+                Quadric q = quadrics[a];
+                q += quadrics[b];
+
+                // Seam vertices can only move along the seam, the error includes the other side of the seam
+                if (seamPair[a] != InvalidVertex || seamPair[b] != InvalidVertex)
+                {
+                    if (seamPair[a] == InvalidVertex || seamPair[b] == InvalidVertex)
+                    {
+                        // Interior vertex can be collapsed to the seam, but not vice versa
+                        if (seamPair[a] == InvalidVertex && !locked[a])
+                            collapses.Add({a, b, float(q.Evaluate(positions[b]))});
+                        if (seamPair[b] == InvalidVertex && !locked[b])
+                            collapses.Add({b, a, float(q.Evaluate(positions[a]))});
+                        continue;
+                    }
+
+                    q += quadrics[seamPair[a]];
+                    q += quadrics[seamPair[b]];
+                }
+
+                if (!locked[a])
+                    collapses.Add({a, b, float(q.Evaluate(positions[b]))});
+                if (!locked[b])
+                    collapses.Add({b, a, float(q.Evaluate(positions[a]))});
+            }
+        }
+
+        if (collapses.IsEmpty())
+            break;
+
+        std::sort(collapses.Begin(), collapses.End(), [](EdgeCollapse const& a, EdgeCollapse const& b)
+            {
+                return a.Error < b.Error;
+            });
+
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            remap[v] = v;
+        touched.ZeroMem();
+
+        // Each collapse removes two triangles of a manifold edge
+        const size_t triangleGoal = (indexCount - targetIndexCount) / 3;
+        size_t removedTriangles = 0;
+        size_t numCollapses = 0;
+
+        for (EdgeCollapse const& collapse : collapses)
+        {
+            if (collapse.Error > maxErrorSqr)
+                break;
+
+            if (touched[collapse.From] || touched[collapse.To])
+                continue;
+
+            uint32_t const* fromAdjacency = &adjacency[adjacencyOffset[collapse.From]];
+            uint32_t fromAdjacencyCount = adjacencyOffset[collapse.From + 1] - adjacencyOffset[collapse.From];
+
+            if (IsCollapseFlipsTriangles(collapse.From, collapse.To, positions, outIndices, fromAdjacency, fromAdjacencyCount))
+                continue;
+
+            // The pair of a seam vertex must be collapsed along the same edge on the other side of the seam
+            uint32_t pairFrom = seamPair[collapse.From];
+            uint32_t pairTo = seamPair[collapse.To];
+            uint32_t const* pairAdjacency = nullptr;
+            uint32_t pairAdjacencyCount = 0;
+            if (pairFrom != InvalidVertex && pairTo != InvalidVertex)
+            {
+                if (pairFrom == collapse.To || touched[pairFrom] || touched[pairTo])
+                    continue;
+
+                pairAdjacency = &adjacency[adjacencyOffset[pairFrom]];
+                pairAdjacencyCount = adjacencyOffset[pairFrom + 1] - adjacencyOffset[pairFrom];
+
+                if (!IsEdgeExists(pairFrom, pairTo, outIndices, pairAdjacency, pairAdjacencyCount))
+                    continue;
+
+                if (IsCollapseFlipsTriangles(pairFrom, pairTo, positions, outIndices, pairAdjacency, pairAdjacencyCount))
+                    continue;
+
+                remap[pairFrom] = pairTo;
+                quadrics[pairTo] += quadrics[pairFrom];
+                TouchTriangles(touched, outIndices, pairAdjacency, pairAdjacencyCount);
+                removedTriangles += 2;
+            }
+
+            remap[collapse.From] = collapse.To;
+            quadrics[collapse.To] += quadrics[collapse.From];
+
+            // Neighbors are used by the flip test, keep them in place until the next pass
+            TouchTriangles(touched, outIndices, fromAdjacency, fromAdjacencyCount);
+
+            resultError = Math::Max(resultError, double(collapse.Error));
+            numCollapses++;
+
+            removedTriangles += 2;
+            if (removedTriangles >= triangleGoal)
+                break;
+        }
+
+        if (numCollapses == 0)
+            break;
+
+        // Apply collapses and drop degenerate triangles
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            uint32_t a = remap[outIndices[i + 0]];
+            uint32_t b = remap[outIndices[i + 1]];
+            uint32_t c = remap[outIndices[i + 2]];
+
+            if (a == b || b == c || c == a)
+                continue;
+
+            outIndices[writeIndex++] = a;
+            outIndices[writeIndex++] = b;
+            outIndices[writeIndex++] = c;
+        }
+        indexCount = writeIndex;
+    }
+
+    if (outError)
+        *outError = float(Math::Sqrt(resultError));
+
+    return indexCount;
+}
+
+} // namespace Geometry
+
+HK_NAMESPACE_END
@@ -0,0 +1,49 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/Math/VectorMath.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace Geometry
+{
+
+/// Simplify a triangle list with quadric error metric edge collapses (Garland-Heckbert). Vertices are neither
+/// moved nor created: the result references a subset of the source vertices, so it can share the vertex buffer.
+/// Border vertices are preserved. Attribute seam vertices are collapsed only along the seam, together with the
+/// vertices on the other side of the seam. outIndices must have room for indexCount indices and may point to the source indices.
+/// Returns the number of output indices; outError receives the largest collapse error in mesh units relative to the input.
+size_t SimplifyMesh(uint32_t* outIndices, uint32_t const* indices, size_t indexCount, Float3 const* positions, size_t vertexCount, size_t targetIndexCount, float maxError, float* outError = nullptr);
+
+} // namespace Geometry
+
+HK_NAMESPACE_END
@@ -33,6 +33,7 @@ SOFTWARE.
 #include <Hork/Core/CoreApplication.h>
 
 #include <Hork/Core/Logger.h>
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/Core/Color.h>
 
 #define STBIR_MALLOC(sz, context) Hk::Core::GetHeapAllocator<Hk::HEAP_TEMP>().Alloc(sz)
@@ -803,16 +804,63 @@ bool ImageStorage::GenerateMipmaps(uint32_t SliceIndex, ImageMipmapConfig const&
     return true;
 }
 
-bool ImageStorage::GenerateMipmaps(ImageMipmapConfig const& MipmapConfig)
+namespace
+{
+
+struct SliceMipmapJob
+{
+    ImageStorage*            Storage;
+    ImageMipmapConfig const* MipmapConfig;
+    uint32_t                 SliceIndex;
+    bool                     bSucceeded;
+};
+
+void GenerateSliceMipmapsJob(void* data)
+{
+    SliceMipmapJob& job = *static_cast<SliceMipmapJob*>(data);
+
+    job.bSucceeded = job.Storage->GenerateMipmaps(job.SliceIndex, *job.MipmapConfig);
+}
+
+} // namespace
+
+bool ImageStorage::GenerateMipmaps(ImageMipmapConfig const& MipmapConfig, AsyncJobList* JobList)
 {
     if (m_Desc.Type == TEXTURE_3D)
         return GenerateMipmaps3D(MipmapConfig);
 
     // TODO: Generate correct mipmaps for Cubemaps.
 
+    if (!JobList || m_Desc.SliceCount == 1 || m_Desc.NumMipmaps <= 1)
+    {
+        for (uint32_t slice = 0; slice < m_Desc.SliceCount; ++slice)
+        {
+            if (!GenerateMipmaps(slice, MipmapConfig))
+                return false;
+        }
+        return true;
+    }
+
+    // Each mip level is resampled from the previous one, so the chain of a slice stays serial and slices run in parallel.
+    Vector<SliceMipmapJob> jobs(m_Desc.SliceCount);
     for (uint32_t slice = 0; slice < m_Desc.SliceCount; ++slice)
     {
-        if (!GenerateMipmaps(slice, MipmapConfig))
+        jobs[slice].Storage      = this;
+        jobs[slice].MipmapConfig = &MipmapConfig;
+        jobs[slice].SliceIndex   = slice;
+        jobs[slice].bSucceeded   = false;
+    }
+
+    if (JobList->GetMaxParallelJobs() < (int)jobs.Size())
+        JobList->SetMaxParallelJobs(jobs.Size());
+
+    for (SliceMipmapJob& job : jobs)
+        JobList->AddJob(GenerateSliceMipmapsJob, &job);
+    JobList->SubmitAndWait();
+
+    for (SliceMipmapJob const& job : jobs)
+    {
+        if (!job.bSucceeded)
             return false;
     }
     return true;
@@ -863,7 +911,7 @@ void ImageStorage::Read(IBinaryStreamReadInterface& stream)
     stream.Read(m_Data.GetData(), sizeInBytes);
 }
 
-ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags, IMAGE_IMPORT_FLAGS ImportFlags)
+ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags, IMAGE_IMPORT_FLAGS ImportFlags, ImageCookSettings const* pCookSettings)
 {
     if (!rawImage)
         return {};
@@ -1232,8 +1280,10 @@ ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMip
         }
     }
 
+    AsyncJobList* jobList = pCookSettings ? pCookSettings->JobList : nullptr;
+
     if (pMipmapConfig)
-        uncompressedImage.GenerateMipmaps(*pMipmapConfig);
+        uncompressedImage.GenerateMipmaps(*pMipmapConfig, jobList);
 
     if (!(ImportFlags & IMAGE_IMPORT_USE_COMPRESSION))
         return uncompressedImage;
@@ -1243,6 +1293,10 @@ ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMip
 
     ImageStorage compressedImage(desc);
 
+    TextureBlockCompression::BlockCompressionBatch batch;
+    if (pCookSettings)
+        batch.BC7 = pCookSettings->BC7;
+
     for (uint32_t level = 0; level < desc.NumMipmaps; ++level)
     {
         ImageSubresource src = uncompressedImage.GetSubresource({0, level});
@@ -1254,41 +1308,123 @@ ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMip
         {
             case TEXTURE_FORMAT_BC1_UNORM:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_RGBA8_UNORM || uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_BGRA8_UNORM);
-                TextureBlockCompression::CompressBC1(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;
             case TEXTURE_FORMAT_BC1_UNORM_SRGB:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_SRGBA8_UNORM || uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_SBGRA8_UNORM);
-                TextureBlockCompression::CompressBC1(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;
             case TEXTURE_FORMAT_BC3_UNORM:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_RGBA8_UNORM || uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_BGRA8_UNORM);
-                TextureBlockCompression::CompressBC3(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;
             case TEXTURE_FORMAT_BC3_UNORM_SRGB:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_SRGBA8_UNORM || uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_SBGRA8_UNORM);
-                TextureBlockCompression::CompressBC3(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;
             case TEXTURE_FORMAT_BC4_UNORM:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_R8_UNORM);                
-                TextureBlockCompression::CompressBC4(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;
             case TEXTURE_FORMAT_BC5_UNORM:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_RG8_UNORM);                
-                TextureBlockCompression::CompressBC5(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;            
             case TEXTURE_FORMAT_BC6H_UFLOAT:
                 HK_ASSERT(uncompressedImage.GetDesc().Format == TEXTURE_FORMAT_RGBA32_FLOAT);
-                TextureBlockCompression::CompressBC6h(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight(), false);
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
                 break;
             default:
                 HK_ASSERT(0); // Never happen
         }
     }
 
+    batch.Compress(jobList);
+
     return compressedImage;
 }
 
-ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags, TEXTURE_FORMAT Format)
+namespace
+{
+
+struct MipChainResampleParams
+{
+    int              NumChannels;
+    size_t           BytesPerPixel;
+    int              AlphaChannel;
+    int              Flags;
+    stbir_datatype   DataType;
+    stbir_colorspace ColorSpace;
+};
+
+/// Resample the uncompressed mip chain of the single slice storage and compress all levels as one batch.
+void CompressMipChain(ImageStorage& storage, void const* pSource, MipChainResampleParams const& resample, ImageMipmapConfig const* pMipmapConfig, ImageCookSettings const* pCookSettings)
+{
+    ImageStorageDesc const& desc = storage.GetDesc();
+
+    TextureBlockCompression::BlockCompressionBatch batch;
+    if (pCookSettings)
+        batch.BC7 = pCookSettings->BC7;
+
+    ImageSubresource subresource = storage.GetSubresource({0, 0});
+
+    batch.Add(desc.Format, pSource, subresource.GetData(), subresource.GetWidth(), subresource.GetHeight());
+
+    // Uncompressed levels must stay alive until the batch is compressed
+    HeapBlob mipChain;
+
+    if (pMipmapConfig && desc.NumMipmaps > 1)
+    {
+        size_t mipChainSize = 0;
+        for (uint32_t i = 1; i < desc.NumMipmaps; ++i)
+        {
+            subresource = storage.GetSubresource({0, i});
+            mipChainSize += size_t(subresource.GetWidth()) * subresource.GetHeight() * resample.BytesPerPixel;
+        }
+        mipChain.Reset(mipChainSize);
+
+        IMAGE_RESAMPLE_EDGE_MODE resampleMode   = pMipmapConfig->EdgeMode;
+        IMAGE_RESAMPLE_FILTER    resampleFilter = pMipmapConfig->Filter;
+
+        uint32_t curWidth  = storage.GetDesc().Width;
+        uint32_t curHeight = storage.GetDesc().Height;
+
+        void const* data = pSource;
+        uint8_t*    mip  = static_cast<uint8_t*>(mipChain.GetData());
+
+        for (uint32_t i = 1; i < desc.NumMipmaps; ++i)
+        {
+            subresource = storage.GetSubresource({0, i});
+
+            uint32_t mipWidth  = subresource.GetWidth();
+            uint32_t mipHeight = subresource.GetHeight();
+
+            stbir_resize(data, curWidth, curHeight, curWidth * resample.BytesPerPixel,
+                         mip, mipWidth, mipHeight, mipWidth * resample.BytesPerPixel,
+                         resample.DataType,
+                         resample.NumChannels,
+                         resample.AlphaChannel,
+                         resample.Flags,
+                         (stbir_edge)resampleMode, (stbir_edge)resampleMode,
+                         (stbir_filter)resampleFilter, (stbir_filter)resampleFilter,
+                         resample.ColorSpace,
+                         NULL);
+
+            batch.Add(desc.Format, mip, subresource.GetData(), mipWidth, mipHeight);
+
+            curWidth  = mipWidth;
+            curHeight = mipHeight;
+            data      = mip;
+            mip += size_t(mipWidth) * mipHeight * resample.BytesPerPixel;
+        }
+    }
+
+    batch.Compress(pCookSettings ? pCookSettings->JobList : nullptr);
+}
+
+} // namespace
+
+ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags, TEXTURE_FORMAT Format, ImageCookSettings const* pCookSettings)
 {
     using namespace TextureBlockCompression;
 
@@ -1302,7 +1438,7 @@ ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig c
             if (!rawImage)
                 return {};
 
-            return CreateImage(rawImage, pMipmapConfig, Flags, IMAGE_IMPORT_FLAGS_DEFAULT);
+            return CreateImage(rawImage, pMipmapConfig, Flags, IMAGE_IMPORT_FLAGS_DEFAULT, pCookSettings);
         }
         case TEXTURE_FORMAT_R8_UINT:
         case TEXTURE_FORMAT_R8_SINT:
@@ -1709,99 +1845,16 @@ ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig c
 
             ImageStorage storage(desc);
 
-            ImageSubresourceDesc subres;
-            subres.SliceIndex  = 0;
-            subres.MipmapIndex = 0;
+            MipChainResampleParams resample;
+            resample.NumChannels   = bpp;
+            resample.BytesPerPixel = bpp;
+            resample.AlphaChannel  = ((Flags & IMAGE_STORAGE_NO_ALPHA) || !info.bHasAlpha) ? STBIR_ALPHA_CHANNEL_NONE : resample.NumChannels - 1;
+            resample.Flags         = resample.AlphaChannel != STBIR_ALPHA_CHANNEL_NONE && (Flags & IMAGE_STORAGE_ALPHA_PREMULTIPLIED) ? STBIR_FLAG_ALPHA_PREMULTIPLIED : 0;
+            resample.DataType      = STBIR_TYPE_UINT8;
+            resample.ColorSpace    = info.bSRGB ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
 
-            ImageSubresource subresource = storage.GetSubresource(subres);
-
-            void (*CompressionRoutine)(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height);
-            switch (Format)
-            {
-                case TEXTURE_FORMAT_BC1_UNORM:
-                case TEXTURE_FORMAT_BC1_UNORM_SRGB:
-                    CompressionRoutine = CompressBC1;
-                    break;
-                case TEXTURE_FORMAT_BC2_UNORM:
-                case TEXTURE_FORMAT_BC2_UNORM_SRGB:
-                    CompressionRoutine = CompressBC2;
-                    break;
-                case TEXTURE_FORMAT_BC3_UNORM:
-                case TEXTURE_FORMAT_BC3_UNORM_SRGB:
-                    CompressionRoutine = CompressBC3;
-                    break;
-                case TEXTURE_FORMAT_BC4_UNORM:
-                case TEXTURE_FORMAT_BC4_SNORM:
-                    CompressionRoutine = CompressBC4;
-                    break;
-                case TEXTURE_FORMAT_BC5_UNORM:
-                case TEXTURE_FORMAT_BC5_SNORM:
-                    CompressionRoutine = CompressBC5;
-                    break;
-                case TEXTURE_FORMAT_BC7_UNORM:
-                case TEXTURE_FORMAT_BC7_UNORM_SRGB:
-                    CompressionRoutine = CompressBC7;
-                    break;
-                default:
-                    HK_ASSERT(0);
-
-                    // Keep compiler happy
-                    CompressionRoutine = nullptr;
-                    break;
-            }
-
-            CompressionRoutine(rawImage.GetData(), subresource.GetData(), subresource.GetWidth(), subresource.GetHeight());
-
-            if (pMipmapConfig)
-            {
-                uint32_t curWidth  = subresource.GetWidth();
-                uint32_t curHeight = subresource.GetHeight();
-
-                HeapBlob blob(std::max<uint32_t>(info.BlockSize, curWidth >> 1) * std::max<uint32_t>(info.BlockSize, curHeight >> 1) * bpp);
-
-                void* data = rawImage.GetData();
-                void* temp = blob.GetData();
-
-                IMAGE_RESAMPLE_EDGE_MODE resampleMode   = pMipmapConfig->EdgeMode;
-                IMAGE_RESAMPLE_FILTER    resampleFilter = pMipmapConfig->Filter;
-
-                int numChannels        = bpp;
-                int alphaChannel       = ((Flags & IMAGE_STORAGE_NO_ALPHA) || !info.bHasAlpha) ? STBIR_ALPHA_CHANNEL_NONE : numChannels - 1;
-                int stbir_resize_flags = alphaChannel != STBIR_ALPHA_CHANNEL_NONE && (Flags & IMAGE_STORAGE_ALPHA_PREMULTIPLIED) ? STBIR_FLAG_ALPHA_PREMULTIPLIED : 0;
-
-                stbir_datatype   datatype   = STBIR_TYPE_UINT8;
-                stbir_colorspace colorspace = Format == TEXTURE_FORMAT_BC1_UNORM_SRGB ||
-                    Format == TEXTURE_FORMAT_BC2_UNORM_SRGB ||
-                    Format == TEXTURE_FORMAT_BC3_UNORM_SRGB ||
-                    Format == TEXTURE_FORMAT_BC7_UNORM_SRGB ? STBIR_COLORSPACE_SRGB : STBIR_COLORSPACE_LINEAR;
-
-                for (uint32_t i = 1; i < desc.NumMipmaps; ++i)
-                {
-                    subres.MipmapIndex = i;
-
-                    subresource = storage.GetSubresource(subres);
-
-                    uint32_t mipWidth  = subresource.GetWidth();
-                    uint32_t mipHeight = subresource.GetHeight();
-
-                    stbir_resize(data, curWidth, curHeight, curWidth * bpp,
-                                 temp, mipWidth, mipHeight, mipWidth * bpp,
-                                 datatype,
-                                 numChannels,
-                                 alphaChannel,
-                                 stbir_resize_flags,
-                                 (stbir_edge)resampleMode, (stbir_edge)resampleMode,
-                                 (stbir_filter)resampleFilter, (stbir_filter)resampleFilter,
-                                 colorspace,
-                                 NULL);
+            CompressMipChain(storage, rawImage.GetData(), resample, pMipmapConfig, pCookSettings);
 
-                    curWidth  = mipWidth;
-                    curHeight = mipHeight;
-                    Core::Swap(data, temp);
-
-                    CompressionRoutine(data, subresource.GetData(), mipWidth, mipHeight);
-                }
-            }
             return storage;
         }
         case TEXTURE_FORMAT_BC6H_UFLOAT:
@@ -1840,64 +1893,16 @@ ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig c
 
             ImageStorage storage(desc);
 
-            ImageSubresourceDesc subres;
-            subres.SliceIndex  = 0;
-            subres.MipmapIndex = 0;
-
-            ImageSubresource subresource = storage.GetSubresource(subres);
-
-            bool bSigned = (Format == TEXTURE_FORMAT_BC6H_SFLOAT);
-            CompressBC6h(rawImage.GetData(), subresource.GetData(), subresource.GetWidth(), subresource.GetHeight(), bSigned);
-
-            if (pMipmapConfig)
-            {
-                uint32_t bpp = 4 * sizeof(float);
-
-                uint32_t curWidth  = subresource.GetWidth();
-                uint32_t curHeight = subresource.GetHeight();
-
-                HeapBlob blob(std::max<uint32_t>(info.BlockSize, curWidth >> 1) * std::max<uint32_t>(info.BlockSize, curHeight >> 1) * bpp);
+            MipChainResampleParams resample;
+            resample.NumChannels   = 4;
+            resample.BytesPerPixel = 4 * sizeof(float);
+            resample.AlphaChannel  = STBIR_ALPHA_CHANNEL_NONE;
+            resample.Flags         = 0;
+            resample.DataType      = STBIR_TYPE_FLOAT;
+            resample.ColorSpace    = STBIR_COLORSPACE_LINEAR;
 
-                void* data = rawImage.GetData();
-                void* temp = blob.GetData();
+            CompressMipChain(storage, rawImage.GetData(), resample, pMipmapConfig, pCookSettings);
 
-                IMAGE_RESAMPLE_EDGE_MODE resampleMode   = pMipmapConfig->EdgeMode;
-                IMAGE_RESAMPLE_FILTER    resampleFilter = pMipmapConfig->Filter;
-
-                const int numChannels        = 4;
-                const int alphaChannel       = STBIR_ALPHA_CHANNEL_NONE;
-                const int stbir_resize_flags = 0;
-
-                const stbir_datatype   datatype   = STBIR_TYPE_FLOAT;
-                const stbir_colorspace colorspace = STBIR_COLORSPACE_LINEAR;
-
-                for (uint32_t i = 1; i < desc.NumMipmaps; ++i)
-                {
-                    subres.MipmapIndex = i;
-
-                    subresource = storage.GetSubresource(subres);
-
-                    uint32_t mipWidth  = subresource.GetWidth();
-                    uint32_t mipHeight = subresource.GetHeight();
-
-                    stbir_resize(data, curWidth, curHeight, curWidth * bpp,
-                                 temp, mipWidth, mipHeight, mipWidth * bpp,
-                                 datatype,
-                                 numChannels,
-                                 alphaChannel,
-                                 stbir_resize_flags,
-                                 (stbir_edge)resampleMode, (stbir_edge)resampleMode,
-                                 (stbir_filter)resampleFilter, (stbir_filter)resampleFilter,
-                                 colorspace,
-                                 NULL);
-
-                    curWidth  = mipWidth;
-                    curHeight = mipHeight;
-                    Core::Swap(data, temp);
-
-                    CompressBC6h(data, subresource.GetData(), mipWidth, mipHeight, bSigned);
-                }
-            }
             return storage;
         }
         default:
@@ -1907,12 +1912,12 @@ ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig c
     return {};
 }
 
-ImageStorage CreateImage(StringView FileName, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags, TEXTURE_FORMAT Format)
+ImageStorage CreateImage(StringView FileName, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags, TEXTURE_FORMAT Format, ImageCookSettings const* pCookSettings)
 {
     auto stream = File::sOpenRead(FileName);
     if (!stream)
         return {};
-    return CreateImage(stream, pMipmapConfig, Flags, Format);
+    return CreateImage(stream, pMipmapConfig, Flags, Format, pCookSettings);
 }
 
 ImageStorage LoadSkyboxImages(SkyboxImportSettings const& Settings)
@@ -2010,6 +2015,8 @@ ImageStorage LoadSkyboxImages(SkyboxImportSettings const& Settings)
 
     ImageStorage storage(desc);
 
+    TextureBlockCompression::BlockCompressionBatch batch;
+
     ImageSubresourceDesc subres;
     subres.MipmapIndex = 0;
     for (uint32_t i = 0; i < 6; i++)
@@ -2028,16 +2035,16 @@ ImageStorage LoadSkyboxImages(SkyboxImportSettings const& Settings)
                 Decoder_R11G11B10F().Encode(subresource.GetData(), rawImage[i].GetData(), subresource.GetWidth(), subresource.GetHeight());
                 break;
             case SKYBOX_IMPORT_TEXTURE_FORMAT_BC1_UNORM_SRGB:
-                TextureBlockCompression::CompressBC1(rawImage[i].GetData(), subresource.GetData(), subresource.GetWidth(), subresource.GetHeight());
-                break;
             case SKYBOX_IMPORT_TEXTURE_FORMAT_BC6H_UFLOAT:
-                TextureBlockCompression::CompressBC6h(rawImage[i].GetData(), subresource.GetData(), subresource.GetWidth(), subresource.GetHeight(), false);
+                batch.Add(desc.Format, rawImage[i].GetData(), subresource.GetData(), subresource.GetWidth(), subresource.GetHeight());
                 break;
             default:
                 HK_ASSERT(0);
         }
     }
 
+    batch.Compress(Settings.JobList);
+
     return storage;
 }
 
@@ -37,6 +37,8 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+class AsyncJobList;
+
 enum TEXTURE_TYPE : uint8_t
 {
     TEXTURE_1D,
@@ -370,6 +372,38 @@ struct ImageMipmapConfig
     IMAGE_RESAMPLE_FILTER_3D Filter3D = IMAGE_RESAMPLE_FILTER_3D_AVERAGE;
 };
 
+/// BC7 encoder settings
+struct BC7CompressionSettings
+{
+    /// Encoder quality level [0..4]
+    uint32_t Level = 4;
+
+    /// Use perceptual error metric. Recommended for sRGB color textures.
+    bool bPerceptual = false;
+
+    /// Rate-distortion optimization. Trades quality for block data that packs better with lossless compressors.
+    /// Zero disables RDO, useful values are in range [0.1..10].
+    float RDOLambda = 0;
+
+    /// Number of previously encoded blocks searched for matches
+    uint32_t RDOLookbackWindow = 256;
+
+    /// Error scale applied to smooth blocks to avoid RDO artifacts on gradients
+    float RDOSmoothBlockMaxMSEScale = 10.0f;
+
+    /// Blocks with channel standard deviation below this value are treated as smooth
+    float RDOMaxSmoothBlockStdDev = 18.0f;
+};
+
+/// Texture cooking settings
+struct ImageCookSettings
+{
+    /// Mip chains and block compression run as jobs of the list. Everything runs on the calling thread if not specified.
+    AsyncJobList* JobList = nullptr;
+
+    BC7CompressionSettings BC7;
+};
+
 IMAGE_RESAMPLE_EDGE_MODE GetResampleEdgeMode(StringView name);
 IMAGE_RESAMPLE_FILTER GetResampleFilter(StringView name);
 IMAGE_RESAMPLE_FILTER_3D GetResampleFilter3D(StringView name);
@@ -464,7 +498,8 @@ public:
     IMAGE_DATA_TYPE GetDataType() const;
 
     bool GenerateMipmaps(uint32_t SliceIndex, ImageMipmapConfig const& MipmapConfig);
-    bool GenerateMipmaps(ImageMipmapConfig const& MipmapConfig);
+    /// Generate mipmaps for all slices. Each slice is processed as a separate job if the job list is specified.
+    bool GenerateMipmaps(ImageMipmapConfig const& MipmapConfig, AsyncJobList* JobList = nullptr);
 
     void Write(IBinaryStreamWriteInterface& stream) const;
     void Read(IBinaryStreamReadInterface& stream);
@@ -554,13 +589,13 @@ enum IMAGE_IMPORT_FLAGS
 HK_FLAG_ENUM_OPERATORS(IMAGE_IMPORT_FLAGS)
 
 /// Create image storage from raw image
-ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags = IMAGE_STORAGE_FLAGS_DEFAULT, IMAGE_IMPORT_FLAGS ImportFlags = IMAGE_IMPORT_FLAGS_DEFAULT);
+ImageStorage CreateImage(RawImage const& rawImage, ImageMipmapConfig const* pMipmapConfig, IMAGE_STORAGE_FLAGS Flags = IMAGE_STORAGE_FLAGS_DEFAULT, IMAGE_IMPORT_FLAGS ImportFlags = IMAGE_IMPORT_FLAGS_DEFAULT, ImageCookSettings const* pCookSettings = nullptr);
 
 /// Create image storage from file
-ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig const* pMipmapConfig = nullptr, IMAGE_STORAGE_FLAGS Flags = IMAGE_STORAGE_FLAGS_DEFAULT, TEXTURE_FORMAT Format = TEXTURE_FORMAT_UNDEFINED);
+ImageStorage CreateImage(IBinaryStreamReadInterface& Stream, ImageMipmapConfig const* pMipmapConfig = nullptr, IMAGE_STORAGE_FLAGS Flags = IMAGE_STORAGE_FLAGS_DEFAULT, TEXTURE_FORMAT Format = TEXTURE_FORMAT_UNDEFINED, ImageCookSettings const* pCookSettings = nullptr);
 
 /// Create image storage from file
-ImageStorage CreateImage(StringView FileName, ImageMipmapConfig const* pMipmapConfig = nullptr, IMAGE_STORAGE_FLAGS Flags = IMAGE_STORAGE_FLAGS_DEFAULT, TEXTURE_FORMAT Format = TEXTURE_FORMAT_UNDEFINED);
+ImageStorage CreateImage(StringView FileName, ImageMipmapConfig const* pMipmapConfig = nullptr, IMAGE_STORAGE_FLAGS Flags = IMAGE_STORAGE_FLAGS_DEFAULT, TEXTURE_FORMAT Format = TEXTURE_FORMAT_UNDEFINED, ImageCookSettings const* pCookSettings = nullptr);
 
 ImageStorage CreateNormalMap(IBinaryStreamReadInterface& Stream, NORMAL_MAP_PACK Pack, bool bUseCompression, bool bMipmapped, bool bConvertFromDirectXNormalMap, IMAGE_RESAMPLE_EDGE_MODE ResampleEdgeMode);
 ImageStorage CreateNormalMap(StringView FileName, NORMAL_MAP_PACK Pack, bool bUseCompression, bool bMipmapped, bool bConvertFromDirectXNormalMap, IMAGE_RESAMPLE_EDGE_MODE ResampleEdgeMode);
@@ -620,6 +655,9 @@ struct SkyboxImportSettings
 
     float HDRIScale{1};
     float HDRIPow{1};
+
+    /// Compress faces as jobs of the list
+    AsyncJobList* JobList{};
 };
 
 ImageStorage LoadSkyboxImages(SkyboxImportSettings const& Settings);
@@ -29,11 +29,12 @@ SOFTWARE.
 */
 
 #include "ImageEncoders.h"
-#include <Hork/Core/ScopedTimer.h>
+#include <Hork/Core/AsyncJobManager.h>
 
 #include <bc7enc_rdo/rgbcx.h>
 #include <bc7enc_rdo/bc7decomp.h>
 #include <bc7enc_rdo/bc7enc.h>
+#include <bc7enc_rdo/ert.h>
 #include <bcdec/bcdec.h>
 
 #ifdef HK_DEBUG
@@ -211,26 +212,27 @@ void Encode_BC7(void const* pSrc, void* pDest, uint32_t Level)
     bc7enc_compress_block(pDest, pSrc, &compressionParams.bc7_params[Level]);
 }
 
-// Input RGBA8 image, output BC1 compressed image
-void CompressBC1(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+namespace
 {
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4 * 4];
-    const uint32_t blockWidth       = 4;
-    const uint32_t bpp              = 4;
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 8;
-    uint32_t       numBlocksX       = Width / blockWidth;
-    uint32_t       numBlocksY       = Height / blockWidth;
-    size_t         rowStride        = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
+
+template <typename EncodeBlock>
+void EncodeBlockRows(uint8_t const* src, uint8_t* dst, uint32_t width, uint32_t firstBlockRow, uint32_t numBlockRows, uint32_t bpp, size_t blockSizeInBytes, EncodeBlock encodeBlock)
+{
+    alignas(16) uint8_t block[4 * 4 * 4 * sizeof(float)];
+    const uint32_t      blockWidth     = 4;
+    const uint32_t      blockRowStride = blockWidth * bpp;
+    const uint32_t      numBlocksX     = width / blockWidth;
+    const size_t        rowStride      = size_t(width) * bpp;
+
+    dst += size_t(firstBlockRow) * numBlocksX * blockSizeInBytes;
+
+    for (uint32_t by = firstBlockRow; by < firstBlockRow + numBlockRows; by++)
     {
-        uint32_t pixY = by * blockWidth;
+        uint8_t const* row = src + size_t(by) * blockWidth * rowStride;
 
         for (uint32_t bx = 0; bx < numBlocksX; bx++)
         {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
+            uint8_t const* p = row + bx * blockRowStride;
 
             memcpy(block + blockRowStride * 0, p, blockRowStride);
             p += rowStride;
@@ -240,320 +242,297 @@ void CompressBC1(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
             p += rowStride;
             memcpy(block + blockRowStride * 3, p, blockRowStride);
 
-            TextureBlockCompression::Encode_BC1(block, dst, 5 /*TextureBlockCompression::BC1_ENCODE_MAX_LEVEL*/, false, false);
+            encodeBlock(block, dst);
 
             dst += blockSizeInBytes;
         }
     }
 }
 
-// Input RGBA8 image, output BC2 compressed image
-void CompressBC2(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+bool UnpackBC7(void const* pBlock, ert::color_rgba* pPixels, uint32_t blockIndex, void* pUserData)
 {
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4 * 4];
-    const uint32_t blockWidth       = 4;
-    const uint32_t bpp              = 4;
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 16;
-    uint32_t       numBlocksX       = Width / blockWidth;
-    uint32_t       numBlocksY       = Height / blockWidth;
-    size_t         rowStride        = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
-    {
-        uint32_t pixY = by * blockWidth;
+    return bc7decomp::unpack_bc7(pBlock, reinterpret_cast<bc7decomp::color_rgba*>(pPixels));
+}
 
-        for (uint32_t bx = 0; bx < numBlocksX; bx++)
-        {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
+} // namespace
 
-            memcpy(block + blockRowStride * 0, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 1, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 2, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 3, p, blockRowStride);
+void BlockCompressionBatch::Add(TEXTURE_FORMAT Format, void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+{
+    HK_ASSERT(IsCompressedFormat(Format));
+    HK_ASSERT((Width % 4) == 0 && (Height % 4) == 0);
 
-            TextureBlockCompression::Encode_BC2(block, dst, 5 /*TextureBlockCompression::BC2_ENCODE_MAX_LEVEL*/);
+    uint32_t imageIndex = m_Images.Size();
 
-            dst += blockSizeInBytes;
-        }
+    Image& image = m_Images.EmplaceBack();
+    image.Format = Format;
+    image.pSrc   = pSrc;
+    image.pDest  = pDest;
+    image.Width  = Width;
+    image.Height = Height;
+
+    // Keep jobs large enough to hide scheduling overhead
+    const uint32_t MinBlocksPerJob = 1024;
+
+    uint32_t numBlocksX  = Math::Max(1u, Width / 4);
+    uint32_t numBlocksY  = Height / 4;
+    uint32_t rowsPerJob  = Math::Max(1u, MinBlocksPerJob / numBlocksX);
+
+    for (uint32_t row = 0; row < numBlocksY; row += rowsPerJob)
+    {
+        Job& job = m_Jobs.EmplaceBack();
+        job.Batch         = this;
+        job.ImageIndex    = imageIndex;
+        job.FirstBlockRow = row;
+        job.NumBlockRows  = Math::Min(rowsPerJob, numBlocksY - row);
     }
 }
 
-// Input RGBA8 image, output BC3 compressed image
-void CompressBC3(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+void BlockCompressionBatch::Compress(AsyncJobList* JobList)
 {
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4 * 4];
-    const uint32_t blockWidth       = 4;
-    const uint32_t bpp              = 4;
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 16;
-    uint32_t       numBlocksX       = Width / blockWidth;
-    uint32_t       numBlocksY       = Height / blockWidth;
-    size_t         rowStride        = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
-    {
-        uint32_t pixY = by * blockWidth;
+    RunJobs(JobList, sEncodeJob);
 
-        for (uint32_t bx = 0; bx < numBlocksX; bx++)
+    // Entropy reduction searches previously encoded blocks of the whole image, so it runs as one job per image
+    // after all blocks are encoded.
+    m_Jobs.Clear();
+    if (BC7.RDOLambda > 0)
+    {
+        for (uint32_t imageIndex = 0; imageIndex < m_Images.Size(); imageIndex++)
         {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
-
-            memcpy(block + blockRowStride * 0, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 1, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 2, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 3, p, blockRowStride);
-
-            TextureBlockCompression::Encode_BC3(block, dst, 5 /*TextureBlockCompression::BC3_ENCODE_MAX_LEVEL*/, true);
-
-            dst += blockSizeInBytes;
+            Image const& image = m_Images[imageIndex];
+            if (image.Format != TEXTURE_FORMAT_BC7_UNORM && image.Format != TEXTURE_FORMAT_BC7_UNORM_SRGB)
+                continue;
+
+            Job& job = m_Jobs.EmplaceBack();
+            job.Batch         = this;
+            job.ImageIndex    = imageIndex;
+            job.FirstBlockRow = 0;
+            job.NumBlockRows  = image.Height / 4;
         }
+
+        RunJobs(JobList, sReduceEntropyJob);
     }
+
+    Clear();
 }
 
-// Input R8 image, output BC4 compressed image
-void CompressBC4(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+void BlockCompressionBatch::Clear()
 {
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4];
-    const uint32_t blockWidth       = 4;
-    const uint32_t bpp              = 1;
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 8;
-    uint32_t       numBlocksX       = Width / blockWidth;
-    uint32_t       numBlocksY       = Height / blockWidth;
-    size_t         rowStride        = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
-    {
-        uint32_t pixY = by * blockWidth;
+    m_Images.Clear();
+    m_Jobs.Clear();
+}
 
-        for (uint32_t bx = 0; bx < numBlocksX; bx++)
-        {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
+void BlockCompressionBatch::RunJobs(AsyncJobList* JobList, void (*callback)(void*))
+{
+    if (m_Jobs.IsEmpty())
+        return;
 
-            memcpy(block + blockRowStride * 0, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 1, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 2, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 3, p, blockRowStride);
+    for (Job& job : m_Jobs)
+        job.Batch = this;
 
-            TextureBlockCompression::Encode_BC4(block, dst, true);
+    if (JobList)
+    {
+        if (JobList->GetMaxParallelJobs() < (int)m_Jobs.Size())
+            JobList->SetMaxParallelJobs(m_Jobs.Size());
 
-            dst += blockSizeInBytes;
-        }
+        for (Job& job : m_Jobs)
+            JobList->AddJob(callback, &job);
+        JobList->SubmitAndWait();
+    }
+    else
+    {
+        for (Job& job : m_Jobs)
+            callback(&job);
     }
 }
 
-// Input RG8 image, output BC5 compressed image
-void CompressBC5(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+void BlockCompressionBatch::sEncodeJob(void* data)
 {
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4 * 2];
-    const uint32_t blockWidth       = 4;
-    const uint32_t bpp              = 2;
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 16;
-    uint32_t       numBlocksX       = Width / blockWidth;
-    uint32_t       numBlocksY       = Height / blockWidth;
-    size_t         rowStride        = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
-    {
-        uint32_t pixY = by * blockWidth;
+    Job const&   job   = *static_cast<Job const*>(data);
+    Image const& image = job.Batch->m_Images[job.ImageIndex];
 
-        for (uint32_t bx = 0; bx < numBlocksX; bx++)
-        {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
+    uint8_t const* src = static_cast<uint8_t const*>(image.pSrc);
+    uint8_t*       dst = static_cast<uint8_t*>(image.pDest);
 
-            memcpy(block + blockRowStride * 0, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 1, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 2, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 3, p, blockRowStride);
-
-            TextureBlockCompression::Encode_BC5(block, dst, true);
-
-            dst += blockSizeInBytes;
+    switch (image.Format)
+    {
+        case TEXTURE_FORMAT_BC1_UNORM:
+        case TEXTURE_FORMAT_BC1_UNORM_SRGB:
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 4, 8,
+                            [](void const* block, void* dest)
+                            {
+                                Encode_BC1(block, dest, 5 /*BC1_ENCODE_MAX_LEVEL*/, false, false);
+                            });
+            break;
+        case TEXTURE_FORMAT_BC2_UNORM:
+        case TEXTURE_FORMAT_BC2_UNORM_SRGB:
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 4, 16,
+                            [](void const* block, void* dest)
+                            {
+                                Encode_BC2(block, dest, 5 /*BC2_ENCODE_MAX_LEVEL*/);
+                            });
+            break;
+        case TEXTURE_FORMAT_BC3_UNORM:
+        case TEXTURE_FORMAT_BC3_UNORM_SRGB:
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 4, 16,
+                            [](void const* block, void* dest)
+                            {
+                                Encode_BC3(block, dest, 5 /*BC3_ENCODE_MAX_LEVEL*/, true);
+                            });
+            break;
+        case TEXTURE_FORMAT_BC4_UNORM:
+        case TEXTURE_FORMAT_BC4_SNORM:
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 1, 8,
+                            [](void const* block, void* dest)
+                            {
+                                Encode_BC4(block, dest, true);
+                            });
+            break;
+        case TEXTURE_FORMAT_BC5_UNORM:
+        case TEXTURE_FORMAT_BC5_SNORM:
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 2, 16,
+                            [](void const* block, void* dest)
+                            {
+                                Encode_BC5(block, dest, true);
+                            });
+            break;
+        case TEXTURE_FORMAT_BC6H_UFLOAT:
+        case TEXTURE_FORMAT_BC6H_SFLOAT: {
+            bool bSigned = image.Format == TEXTURE_FORMAT_BC6H_SFLOAT;
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 4 * sizeof(float), 16,
+                            [bSigned](void const* block, void* dest)
+                            {
+                                Encode_BC6h_f32(block, dest, bSigned);
+                            });
+            break;
         }
+        case TEXTURE_FORMAT_BC7_UNORM:
+        case TEXTURE_FORMAT_BC7_UNORM_SRGB: {
+            BC7CompressionSettings const& settings = job.Batch->BC7;
+
+            bc7enc_compress_block_params params = compressionParams.bc7_params[Math::Min(settings.Level, BC7_ENCODE_MAX_LEVEL)];
+            if (settings.bPerceptual)
+                bc7enc_compress_block_params_init_perceptual_weights(&params);
+
+            EncodeBlockRows(src, dst, image.Width, job.FirstBlockRow, job.NumBlockRows, 4, 16,
+                            [&params](void const* block, void* dest)
+                            {
+                                bc7enc_compress_block(dest, block, &params);
+                            });
+            break;
+        }
+        default:
+            HK_ASSERT(0);
     }
 }
 
-// Input RGBA32_FLOAT image, output BC6 compressed image
-void CompressBC6h(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height, bool bSigned)
+void BlockCompressionBatch::sReduceEntropyJob(void* data)
 {
-    ScopedTimer timer("CompressBC6h");
+    Job const&                    job      = *static_cast<Job const*>(data);
+    Image const&                  image    = job.Batch->m_Images[job.ImageIndex];
+    BC7CompressionSettings const& settings = job.Batch->BC7;
 
-    //uint8_t const* src = (uint8_t const*)pSrc;
-    //uint8_t*       dst = (uint8_t*)pDest;
-    //uint8_t        block[4 * 4 * 4 * sizeof(float)];
-    const uint32_t blockWidth = 4;
-    const uint32_t bpp        = 4 * sizeof(float);
-    //const uint32_t blockRowStride   = blockWidth * bpp;
-    //const size_t   blockSizeInBytes = 16;
-    uint32_t numBlocksX = Width / blockWidth;
-    uint32_t numBlocksY = Height / blockWidth;
-    size_t   rowStride  = Width * bpp;
+    const uint32_t numBlocksX = image.Width / 4;
+    const uint32_t numBlocksY = image.Height / 4;
+    const uint32_t numBlocks  = numBlocksX * numBlocksY;
+    const size_t   rowStride  = size_t(image.Width) * 4;
 
-    const int num_threads = 16;
+    if (!numBlocks)
+        return;
 
-    Thread threads[num_threads];
+    Vector<ert::color_rgba> blockPixels(size_t(numBlocks) * 16);
+    std::vector<float>      blockMSEScales(numBlocks);
 
-    struct ThreadData
-    {
-        uint32_t    firstBlock;
-        uint32_t    numBlocks;
-        uint32_t    numBlocksX;
-        uint32_t    numBlocksY;
-        size_t      rowStride;
-        void const* pSrc;
-        void*       pDest;
-        bool        bSigned;
-    };
-
-    uint32_t numBlocks       = numBlocksX * numBlocksY;
-    uint32_t blocksPerThread = numBlocks / num_threads;
-    uint32_t firstBlock      = 0;
+    uint8_t const* src = static_cast<uint8_t const*>(image.pSrc);
 
-    AtomicInt counter{};
-
-    ThreadData data[num_threads];
-    for (int i = 0; i < num_threads; i++)
+    for (uint32_t by = 0; by < numBlocksY; by++)
     {
-        data[i].firstBlock = firstBlock;
-        data[i].numBlocks  = blocksPerThread;
-        data[i].numBlocksX = numBlocksX;
-        data[i].numBlocksY = numBlocksY;
-        data[i].rowStride  = rowStride;
-        data[i].pSrc       = pSrc;
-        data[i].pDest      = pDest;
-        data[i].bSigned    = bSigned;
-        firstBlock += blocksPerThread;
-
-        threads[i] = Thread(
-            [](ThreadData& data, uint32_t numBlocks, AtomicInt& counter)
-            {
-                uint8_t block[4 * 4 * 4 * sizeof(float)];
+        for (uint32_t bx = 0; bx < numBlocksX; bx++)
+        {
+            uint32_t         blockIndex = by * numBlocksX + bx;
+            ert::color_rgba* pixels     = &blockPixels[size_t(blockIndex) * 16];
 
-                const uint32_t blockWidth       = 4;
-                const uint32_t bpp              = 4 * sizeof(float);
-                const uint32_t blockRowStride   = blockWidth * bpp;
-                const size_t   blockSizeInBytes = 16;
+            uint8_t const* p = src + size_t(by) * 4 * rowStride + bx * 16;
+            for (int y = 0; y < 4; y++, p += rowStride)
+                memcpy(&pixels[y * 4], p, 16);
 
-                for (uint32_t blockIndex = 0; blockIndex < data.numBlocks; blockIndex++)
+            // Smooth blocks show RDO artifacts first, so their error is scaled up
+            float maxStdDev = 0;
+            for (int c = 0; c < 4; c++)
+            {
+                float mean = 0, sqMean = 0;
+                for (int i = 0; i < 16; i++)
                 {
-                    uint32_t i = blockIndex + data.firstBlock;
-
-                    uint32_t bx = i % data.numBlocksX;
-                    uint32_t by = i / data.numBlocksX;
-
-                    uint8_t*       dst = (uint8_t*)data.pDest + i * blockSizeInBytes;
-                    uint8_t const* p   = (uint8_t const*)data.pSrc + by * blockWidth * data.rowStride + bx * (blockWidth * bpp);
-
-                    memcpy(block + blockRowStride * 0, p, blockRowStride);
-                    p += data.rowStride;
-                    memcpy(block + blockRowStride * 1, p, blockRowStride);
-                    p += data.rowStride;
-                    memcpy(block + blockRowStride * 2, p, blockRowStride);
-                    p += data.rowStride;
-                    memcpy(block + blockRowStride * 3, p, blockRowStride);
-
-                    TextureBlockCompression::Encode_BC6h_f32(block, dst, data.bSigned);
-
-                    int n = counter.Increment();
-                    if (!(n % 512))
-                        LOG("Blocks processed {} from {}\n", n, numBlocks);
+                    float v = pixels[i].m_c[c];
+                    mean += v;
+                    sqMean += v * v;
                 }
-            },
-            std::ref(data[i]), numBlocks, std::ref(counter));
-    }
+                mean /= 16;
+                sqMean /= 16;
+                maxStdDev = Math::Max(maxStdDev, Math::Sqrt(Math::Max(0.0f, sqMean - mean * mean)));
+            }
 
-    for (int i = 0; i < num_threads; i++)
-    {
-        threads[i].Join();
+            float yl = Math::Saturate(maxStdDev / settings.RDOMaxSmoothBlockStdDev);
+            blockMSEScales[blockIndex] = Math::Lerp(settings.RDOSmoothBlockMaxMSEScale, 1.0f, yl * yl);
+        }
     }
 
-    #if 0
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4 * 4 * sizeof(float)];
-    const uint32_t blockWidth = 4;
-    const uint32_t bpp        = 4 * sizeof(float);
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 16;
-    uint32_t numBlocksX = Width / blockWidth;
-    uint32_t numBlocksY = Height / blockWidth;
-    size_t   rowStride  = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
-    {
-        uint32_t pixY = by * blockWidth;
-
-        for (uint32_t bx = 0; bx < numBlocksX; bx++)
-        {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
+    ert::reduce_entropy_params params;
+    params.m_lambda                     = settings.RDOLambda;
+    params.m_lookback_window_size       = settings.RDOLookbackWindow;
+    params.m_smooth_block_max_mse_scale = settings.RDOSmoothBlockMaxMSEScale;
+    params.m_try_two_matches            = true;
 
-            memcpy(block + blockRowStride * 0, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 1, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 2, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 3, p, blockRowStride);
+    uint32_t totalModified = 0;
+    ert::reduce_entropy(image.pDest, numBlocks, 16, 16, 4, 4, 4, blockPixels.ToPtr(), params, totalModified, UnpackBC7, nullptr, &blockMSEScales);
+}
 
-            TextureBlockCompression::Encode_BC6h_f32(block, dst, bSigned);
+void CompressBC1(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+{
+    BlockCompressionBatch batch;
+    batch.Add(TEXTURE_FORMAT_BC1_UNORM, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
+}
 
-            dst += blockSizeInBytes;
-        }
-    }
-    #endif
+void CompressBC2(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+{
+    BlockCompressionBatch batch;
+    batch.Add(TEXTURE_FORMAT_BC2_UNORM, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
 }
 
-// Input RGBA8 image, output BC7 compressed image
-void CompressBC7(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+void CompressBC3(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
 {
-    uint8_t const* src = (uint8_t const*)pSrc;
-    uint8_t*       dst = (uint8_t*)pDest;
-    uint8_t        block[4 * 4 * 4];
-    const uint32_t blockWidth       = 4;
-    const uint32_t bpp              = 4;
-    const uint32_t blockRowStride   = blockWidth * bpp;
-    const size_t   blockSizeInBytes = 16;
-    uint32_t       numBlocksX       = Width / blockWidth;
-    uint32_t       numBlocksY       = Height / blockWidth;
-    size_t         rowStride        = Width * bpp;
-    for (uint32_t by = 0; by < numBlocksY; by++)
-    {
-        uint32_t pixY = by * blockWidth;
+    BlockCompressionBatch batch;
+    batch.Add(TEXTURE_FORMAT_BC3_UNORM, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
+}
 
-        for (uint32_t bx = 0; bx < numBlocksX; bx++)
-        {
-            uint8_t const* p = src + pixY * rowStride + bx * (blockWidth * bpp);
+void CompressBC4(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+{
+    BlockCompressionBatch batch;
+    batch.Add(TEXTURE_FORMAT_BC4_UNORM, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
+}
 
-            memcpy(block + blockRowStride * 0, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 1, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 2, p, blockRowStride);
-            p += rowStride;
-            memcpy(block + blockRowStride * 3, p, blockRowStride);
+void CompressBC5(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+{
+    BlockCompressionBatch batch;
+    batch.Add(TEXTURE_FORMAT_BC5_UNORM, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
+}
 
-            TextureBlockCompression::Encode_BC7(block, dst, BC7_ENCODE_MAX_LEVEL);
+void CompressBC6h(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height, bool bSigned)
+{
+    BlockCompressionBatch batch;
+    batch.Add(bSigned ? TEXTURE_FORMAT_BC6H_SFLOAT : TEXTURE_FORMAT_BC6H_UFLOAT, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
+}
 
-            dst += blockSizeInBytes;
-        }
-    }
+void CompressBC7(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height)
+{
+    BlockCompressionBatch batch;
+    batch.Add(TEXTURE_FORMAT_BC7_UNORM, pSrc, pDest, Width, Height);
+    batch.Compress(nullptr);
 }
 
 #if 0
@@ -63,6 +63,8 @@ void Encode_BC6h_f16(void const* pSrc, void* pDest, bool bSigned);
 void Encode_BC6h_f32(void const* pSrc, void* pDest, bool bSigned);
 void Encode_BC7(void const* pSrc, void* pDest, uint32_t Level);
 
+// Single image compression on the calling thread. Use BlockCompressionBatch to spread the work across worker threads.
+
 // Input RGBA8 image, output BC1 compressed image
 void CompressBC1(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height);
 
@@ -84,6 +86,51 @@ void CompressBC6h(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height
 // Input RGBA8 image, output BC7 compressed image
 void CompressBC7(void const* pSrc, void* pDest, uint32_t Width, uint32_t Height);
 
+/// Collects images (mip levels, slices or whole textures) and compresses them as independent jobs.
+/// Each image is split into ranges of block rows, so even a single large level is spread across all workers.
+/// Source data: RGBA8 for BC1/BC2/BC3/BC7, R8 for BC4, RG8 for BC5, RGBA32_FLOAT for BC6H.
+class BlockCompressionBatch
+{
+public:
+    /// Encoder settings for BC7 images of the batch
+    BC7CompressionSettings BC7;
+
+    /// Add image to the batch. Width and height must be multiple of block size.
+    /// Source and destination memory must stay valid until Compress returns.
+    void Add(TEXTURE_FORMAT Format, void const* pSrc, void* pDest, uint32_t Width, uint32_t Height);
+
+    /// Compress all images. Runs on the job list workers if the list is specified.
+    void Compress(AsyncJobList* JobList);
+
+    void Clear();
+
+private:
+    struct Image
+    {
+        TEXTURE_FORMAT Format;
+        void const*    pSrc;
+        void*          pDest;
+        uint32_t       Width;
+        uint32_t       Height;
+    };
+
+    struct Job
+    {
+        BlockCompressionBatch* Batch;
+        uint32_t               ImageIndex;
+        uint32_t               FirstBlockRow;
+        uint32_t               NumBlockRows;
+    };
+
+    static void sEncodeJob(void* data);
+    static void sReduceEntropyJob(void* data);
+
+    void RunJobs(AsyncJobList* JobList, void (*callback)(void*));
+
+    Vector<Image> m_Images;
+    Vector<Job>   m_Jobs;
+};
+
 } // namespace TextureBlockCompression
 
 HK_FORCEINLINE uint16_t pack_r4g4b4a4(uint8_t const* pixel)
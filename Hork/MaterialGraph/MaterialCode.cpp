@@ -34,6 +34,7 @@ SOFTWARE.
 #include <Hork/ShaderUtils/ShaderCompiler.h>
 #include <Hork/Renderer/VertexAttribs.h>
 #include <Hork/Core/ConsoleVar.h>
+#include <Hork/Core/AsyncJobManager.h>
 
 HK_NAMESPACE_BEGIN
 
@@ -78,6 +79,13 @@ namespace
         }
     }
 
+    void AddInstanceTransformBinding(Vector<BufferInfo>& bufferBindings)
+    {
+        while (bufferBindings.Size() < INSTANCE_TRANSFORM_BUFFER_SLOT)
+            bufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // unused
+        bufferBindings.EmplaceBack(BUFFER_BIND_STORAGE); // instance transforms
+    }
+
     RHI::BLENDING_PRESET GetBlendingPreset(BLENDING_MODE _Blending)
     {
         switch (_Blending)
@@ -227,6 +235,76 @@ struct MaterialCommonProperties
     String Code;
 };
 
+/// Shader stages of all material passes. Stages are collected while the passes are set up and
+/// compiled afterwards, each stage as an independent job.
+class ShaderCompileBatch
+{
+public:
+    void AddShader(RHI::SHADER_TYPE shaderType, ShaderCompiler::SourceList const& sources, HeapBlob& result)
+    {
+        Job& job = m_Jobs.EmplaceBack();
+        job.ShaderType = shaderType;
+        job.Sources = sources;
+        job.Result = &result;
+    }
+
+    void AddVertexShader(ArrayView<VertexAttribInfo> vertexAttribs, ShaderCompiler::SourceList const& sources, HeapBlob& result)
+    {
+        Job& job = m_Jobs.EmplaceBack();
+        job.ShaderType = RHI::VERTEX_SHADER;
+        job.VertexAttribs = vertexAttribs;
+        job.bVertexAttribs = true;
+        job.Sources = sources;
+        job.Result = &result;
+    }
+
+    /// Compile all stages. Runs on the job list workers if the list is specified.
+    bool Compile(AsyncJobList* jobList)
+    {
+        if (jobList)
+        {
+            for (Job& job : m_Jobs)
+                jobList->AddJob(sCompileJob, &job);
+            jobList->SubmitAndWait();
+        }
+        else
+        {
+            for (Job& job : m_Jobs)
+                sCompileJob(&job);
+        }
+
+        for (Job const& job : m_Jobs)
+        {
+            if (!job.bSucceeded)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    struct Job
+    {
+        RHI::SHADER_TYPE            ShaderType;
+        ArrayView<VertexAttribInfo> VertexAttribs;
+        bool                        bVertexAttribs{};
+        bool                        bSucceeded{};
+        ShaderCompiler::SourceList  Sources;
+        HeapBlob*                   Result;
+    };
+
+    static void sCompileJob(void* data)
+    {
+        Job& job = *static_cast<Job*>(data);
+        if (job.bVertexAttribs)
+            job.bSucceeded = ShaderCompiler::sCreateSpirV_VertexShader(job.VertexAttribs, job.Sources, *job.Result);
+        else
+            job.bSucceeded = ShaderCompiler::sCreateSpirV(job.ShaderType, job.Sources, *job.Result);
+    }
+
+    // Job addresses must be stable while the batch is compiled: the batch is filled completely before that.
+    Vector<Job> m_Jobs;
+};
+
 struct MaterialPassTranslator
 {
     HeapBlob VertexShader_Static;
@@ -249,16 +327,36 @@ private:
         GeometryShader.Reset();
     }
 
+    bool CompileShader(RHI::SHADER_TYPE shaderType, ShaderCompiler::SourceList const& sources, HeapBlob& result)
+    {
+        if (Batch)
+        {
+            Batch->AddShader(shaderType, sources, result);
+            return true;
+        }
+        return ShaderCompiler::sCreateSpirV(shaderType, sources, result);
+    }
+
+    bool CompileVertexShader(ArrayView<VertexAttribInfo> vertexAttribs, ShaderCompiler::SourceList const& sources, HeapBlob& result)
+    {
+        if (Batch)
+        {
+            Batch->AddVertexShader(vertexAttribs, sources, result);
+            return true;
+        }
+        return ShaderCompiler::sCreateSpirV_VertexShader(vertexAttribs, sources, result);
+    }
+
     bool CreateVertexShaders(ShaderCompiler::SourceList const& sources)
     {
-        if (!ShaderCompiler::sCreateSpirV_VertexShader(g_VertexAttribsStatic, sources, VertexShader_Static))
+        if (!CompileVertexShader(g_VertexAttribsStatic, sources, VertexShader_Static))
             return false;
 
         ShaderCompiler::SourceList _sources;
         _sources.Add("#define SKINNED_MESH\n");
         _sources.Add(sources);
 
-        if (!ShaderCompiler::sCreateSpirV_VertexShader(g_VertexAttribsSkinned, _sources, VertexShader_Skinned))
+        if (!CompileVertexShader(g_VertexAttribsSkinned, _sources, VertexShader_Skinned))
             return false;
 
         return true;
@@ -266,10 +364,10 @@ private:
 
     bool CreateTessShaders(ShaderCompiler::SourceList const& sources)
     {
-        if (!ShaderCompiler::sCreateSpirV(RHI::TESS_CONTROL_SHADER, sources, TessControlShader))
+        if (!CompileShader(RHI::TESS_CONTROL_SHADER, sources, TessControlShader))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::TESS_EVALUATION_SHADER, sources, TessEvalShader))
+        if (!CompileShader(RHI::TESS_EVALUATION_SHADER, sources, TessEvalShader))
             return false;
 
         return true;
@@ -288,6 +386,9 @@ private:
 public:
     bool IsDebugMode = false;
 
+    /// Defer compilation of the stages to the batch. Stages are compiled immediately if not set.
+    ShaderCompileBatch* Batch = nullptr;
+
     bool CreateDepth(MaterialCommonProperties const& properties)
     {
         Clear();
@@ -308,7 +409,7 @@ public:
 
         if (properties.AlphaMasking)
         {
-            if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+            if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
                 return false;
         }
 
@@ -334,7 +435,7 @@ public:
                 return false;
         }
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         return true;
@@ -352,14 +453,14 @@ public:
         if (!CreateVertexShaders(sources))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::GEOMETRY_SHADER, sources, GeometryShader))
+        if (!CompileShader(RHI::GEOMETRY_SHADER, sources, GeometryShader))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         sources.InsertAt(0, "#define SKINNED_MESH\n");
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader2))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader2))
             return false;
 
         if (properties.Tessellation)
@@ -383,10 +484,10 @@ public:
         if (!CreateVertexShaders(sources))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::GEOMETRY_SHADER, sources, GeometryShader))
+        if (!CompileShader(RHI::GEOMETRY_SHADER, sources, GeometryShader))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         return true;
@@ -404,7 +505,7 @@ public:
         if (!CreateVertexShaders(sources))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         if (properties.Tessellation)
@@ -426,10 +527,10 @@ public:
         sources.Add("#define USE_LIGHTMAP\n");
         sources.Add(properties.Code.CStr());
 
-        if (!ShaderCompiler::sCreateSpirV_VertexShader(g_VertexAttribsStaticLightmap, sources, VertexShader_Static))
+        if (!CompileVertexShader(g_VertexAttribsStaticLightmap, sources, VertexShader_Static))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         if (properties.Tessellation)
@@ -451,10 +552,10 @@ public:
         sources.Add("#define USE_VERTEX_LIGHT\n");
         sources.Add(properties.Code.CStr());
 
-        if (!ShaderCompiler::sCreateSpirV_VertexShader(g_VertexAttribsStaticVertexLight, sources, VertexShader_Static))
+        if (!CompileVertexShader(g_VertexAttribsStaticVertexLight, sources, VertexShader_Static))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         if (properties.Tessellation)
@@ -478,7 +579,7 @@ public:
         if (!CreateVertexShaders(sources))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::GEOMETRY_SHADER, sources, GeometryShader))
+        if (!CompileShader(RHI::GEOMETRY_SHADER, sources, GeometryShader))
             return false;
 
         if (properties.TessellationShadowMap)
@@ -494,7 +595,7 @@ public:
 #endif
         if (properties.ShadowMasking || bVSM)
         {
-            if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+            if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
                 return false;
         }
 
@@ -519,7 +620,7 @@ public:
                 return false;
         }
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         return true;
@@ -537,7 +638,7 @@ public:
         if (!CreateVertexShaders(sources))
             return false;
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         return true;
@@ -561,7 +662,7 @@ public:
                 return false;
         }
 
-        if (!ShaderCompiler::sCreateSpirV(RHI::FRAGMENT_SHADER, sources, FragmentShader))
+        if (!CompileShader(RHI::FRAGMENT_SHADER, sources, FragmentShader))
             return false;
 
         return true;
@@ -594,11 +695,54 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
 
     if (Type == MATERIAL_TYPE_PBR || Type == MATERIAL_TYPE_BASELIGHT || Type == MATERIAL_TYPE_UNLIT)
     {
+        ShaderCompileBatch batch;
+
+        MaterialPassTranslator depthTranslator;
+        MaterialPassTranslator depthVelocityTranslator;
+        MaterialPassTranslator lightTranslator;
+        MaterialPassTranslator shadowMapTranslator;
+        MaterialPassTranslator omniShadowMapTranslator;
+        MaterialPassTranslator feedbackTranslator;
+        MaterialPassTranslator outlineTranslator;
+        MaterialPassTranslator wireframeTranslator;
+        MaterialPassTranslator normalsTranslator;
+        MaterialPassTranslator lightmapTranslator;
+        MaterialPassTranslator vertexLightTranslator;
+
+        for (MaterialPassTranslator* translator : {&depthTranslator,
+                                                    &depthVelocityTranslator,
+                                                    &lightTranslator,
+                                                    &shadowMapTranslator,
+                                                    &omniShadowMapTranslator,
+                                                    &feedbackTranslator,
+                                                    &outlineTranslator,
+                                                    &wireframeTranslator,
+                                                    &normalsTranslator,
+                                                    &lightmapTranslator,
+                                                    &vertexLightTranslator})
+        {
+            translator->IsDebugMode = params.IsDebugMode;
+            translator->Batch = &batch;
+        }
+
+        if (!depthTranslator.CreateDepth(properties) ||
+            !depthVelocityTranslator.CreateDepthVelocity(properties) ||
+            !lightTranslator.CreateLight(properties) ||
+            !shadowMapTranslator.CreateShadowMap(properties) ||
+            !omniShadowMapTranslator.CreateOmniShadowMap(properties) ||
+            !feedbackTranslator.CreateFeedback(properties) ||
+            !outlineTranslator.CreateOutline(properties) ||
+            !wireframeTranslator.CreateWireframe(properties) ||
+            !normalsTranslator.CreateNormals(properties) ||
+            !lightmapTranslator.CreateLightmap(properties) ||
+            !vertexLightTranslator.CreateVertexLight(properties))
+            return {};
+
+        if (!batch.Compile(params.JobList))
+            return {};
+
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateDepth(properties))
-                return {};
+            MaterialPassTranslator& translator = depthTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -622,6 +766,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
                 pass.Topology = properties.Tessellation ? PRIMITIVE_PATCHES_3 : PRIMITIVE_TRIANGLES;
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // view constants
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // drawcall constants
+                AddInstanceTransformBinding(pass.BufferBindings);
                 pass.RenderTargets.EmplaceBack().ColorWriteMask = COLOR_WRITE_DISABLED;
                 AddSamplers(pass.Samplers, ArrayView<TextureSampler>(Samplers.ToPtr(), DepthPassTextureCount));
             }
@@ -648,10 +793,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateDepthVelocity(properties))
-                return {};
+            MaterialPassTranslator& translator = depthVelocityTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -711,10 +853,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateLight(properties))
-                return {};
+            MaterialPassTranslator& translator = lightTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -746,6 +885,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // light buffer
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // IBL buffer
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // VT buffer
+                AddInstanceTransformBinding(pass.BufferBindings);
                 if (IsTranslucent)
                     pass.RenderTargets.EmplaceBack().SetBlendingPreset(GetBlendingPreset(Blending));
                 AddSamplers(pass.Samplers, ArrayView<TextureSampler>(Samplers.ToPtr(), LightPassTextureCount));
@@ -823,10 +963,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateShadowMap(properties))
-                return {};
+            MaterialPassTranslator& translator = shadowMapTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -861,6 +998,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // drawcall constants
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // skeleton
                 pass.BufferBindings.EmplaceBack(BUFFER_BIND_CONSTANT); // shadow cascade
+                AddInstanceTransformBinding(pass.BufferBindings);
 #if defined SHADOWMAP_VSM
                 pass.RenderTarget.EmplaceBack().SetBlendingPreset(BLENDING_NO_BLEND);
 #endif
@@ -900,10 +1038,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateOmniShadowMap(properties))
-                return {};
+            MaterialPassTranslator& translator = omniShadowMapTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -955,10 +1090,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateFeedback(properties))
-                return {};
+            MaterialPassTranslator& translator = feedbackTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -1020,10 +1152,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateOutline(properties))
-                return {};
+            MaterialPassTranslator& translator = outlineTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -1075,10 +1204,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateWireframe(properties))
-                return {};
+            MaterialPassTranslator& translator = wireframeTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -1133,10 +1259,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateNormals(properties))
-                return {};
+            MaterialPassTranslator& translator = normalsTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t vertexShaderSkinned = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Skinned));
@@ -1190,10 +1313,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateLightmap(properties))
-                return {};
+            MaterialPassTranslator& translator = lightmapTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t fragmentShader      = binary->AddShader(FRAGMENT_SHADER, std::move(translator.FragmentShader));
@@ -1253,10 +1373,7 @@ UniqueRef<MaterialBinary> MaterialCode::Translate(TranslationParams const& param
         }
 
         {
-            MaterialPassTranslator translator;
-            translator.IsDebugMode = params.IsDebugMode;
-            if (!translator.CreateVertexLight(properties))
-                return {};
+            MaterialPassTranslator& translator = vertexLightTranslator;
 
             uint32_t vertexShaderStatic  = binary->AddShader(VERTEX_SHADER, std::move(translator.VertexShader_Static));
             uint32_t fragmentShader      = binary->AddShader(FRAGMENT_SHADER, std::move(translator.FragmentShader));
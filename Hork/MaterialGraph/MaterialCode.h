@@ -36,6 +36,7 @@ SOFTWARE.
 HK_NAMESPACE_BEGIN
 
 class MaterialBinary;
+class AsyncJobList;
 
 class MaterialCode
 {
@@ -107,6 +108,10 @@ public:
     struct TranslationParams
     {
         bool IsDebugMode = false;
+
+        /// Compile shader stages as independent jobs of the list. Stages are compiled on the calling
+        /// thread if not specified.
+        AsyncJobList* JobList = nullptr;
     };
 
     /// Translate source code to SpirV
@@ -352,6 +352,17 @@ Ref<RHI::IPipeline> CreateTerrainMaterialWireframe(RHI::IDevice* device)
     return pipeline;
 }
 
+namespace
+{
+
+    bool HasInstanceTransformBuffer(MaterialBinary::MaterialPassData const& pass)
+    {
+        return pass.BufferBindings.Size() > INSTANCE_TRANSFORM_BUFFER_SLOT &&
+            pass.BufferBindings[INSTANCE_TRANSFORM_BUFFER_SLOT].BufferBinding == RHI::BUFFER_BIND_STORAGE;
+    }
+
+}
+
 Ref<MaterialGPU> CompileMaterial(RHI::IDevice* device, MaterialBinary const& binary)
 {
     Vector<Ref<RHI::IShaderModule>> compiledShaders;
@@ -373,11 +384,25 @@ Ref<MaterialGPU> CompileMaterial(RHI::IDevice* device, MaterialBinary const& bin
     materialGPU->NormalsPassTextureCount = binary.NormalsPassTextureCount;
     materialGPU->ShadowMapPassTextureCount = binary.ShadowMapPassTextureCount;
 
+    // Materials compiled before instance batching was introduced have no instance transform buffer
+    int instancedPassCount = 0;
+    bool supportsInstancing = true;
+
     for (MaterialBinary::MaterialPassData const& pass : binary.Passes)
     {
         if (!(materialGPU->Passes[pass.Type] = CreateMaterialPass(device, pass, compiledShaders)))
             return {};
+
+        if (pass.Type == MaterialPass::DepthPass || pass.Type == MaterialPass::LightPass || pass.Type == MaterialPass::ShadowMapPass)
+        {
+            if (HasInstanceTransformBuffer(pass))
+                instancedPassCount++;
+            else
+                supportsInstancing = false;
+        }
     }
+
+    materialGPU->SupportsInstancing = supportsInstancing && instancedPassCount > 0;
     return materialGPU;
 }
 
@@ -445,6 +445,7 @@ StreamedMemoryGPU::StreamedMemoryGPU(RHI::IDevice* pDevice) :
     m_VertexBufferAlignment = 32; // TODO: Get from driver!!!
     m_IndexBufferAlignment = 16;  // TODO: Get from driver!!!
     m_ConstantBufferAlignment = pDevice->GetDeviceCaps(RHI::DEVICE_CAPS_CONSTANT_BUFFER_OFFSET_ALIGNMENT);
+    m_StorageBufferAlignment = pDevice->GetDeviceCaps(RHI::DEVICE_CAPS_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT);
 }
 
 StreamedMemoryGPU::~StreamedMemoryGPU()
@@ -483,6 +484,11 @@ size_t StreamedMemoryGPU::AllocateConstant(size_t _SizeInBytes, const void* _Dat
     return Allocate(_SizeInBytes, m_ConstantBufferAlignment, _Data);
 }
 
+size_t StreamedMemoryGPU::AllocateStorage(size_t _SizeInBytes, const void* _Data)
+{
+    return Allocate(_SizeInBytes, m_StorageBufferAlignment, _Data);
+}
+
 size_t StreamedMemoryGPU::AllocateWithCustomAlignment(size_t _SizeInBytes, int _Alignment, const void* _Data)
 {
     return Allocate(_SizeInBytes, _Alignment, _Data);
@@ -199,6 +199,9 @@ public:
     /// Allocate constant data. Return stream handle. Stream handle is actual during current frame.
     size_t AllocateConstant(size_t _SizeInBytes, const void* _Data = nullptr);
 
+    /// Allocate shader storage data. Return stream handle. Stream handle is actual during current frame.
+    size_t AllocateStorage(size_t _SizeInBytes, const void* _Data = nullptr);
+
     /// Allocate data with custum alignment. Return stream handle. Stream handle is actual during current frame.
     size_t AllocateWithCustomAlignment(size_t _SizeInBytes, int _Alignment, const void* _Data = nullptr);
 
@@ -261,6 +264,7 @@ private:
     int                       m_VertexBufferAlignment;
     int                       m_IndexBufferAlignment;
     int                       m_ConstantBufferAlignment;
+    int                       m_StorageBufferAlignment;
 };
 
 HK_NAMESPACE_END
@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include "Common/Device.h"
 #include "OpenGL45/DeviceGLImpl.h"
+#include "Null/DeviceNullImpl.h"
 
 HK_NAMESPACE_BEGIN
 
@@ -42,6 +43,10 @@ void CreateLogicalDevice(const char* Api, Ref<IDevice>* ppDevice)
     {
         *ppDevice = MakeRef<DeviceGLImpl>();
     }
+    else if (!Core::Stricmp(Api, "Null"))
+    {
+        *ppDevice = MakeRef<DeviceNullImpl>();
+    }
     else
     {
         *ppDevice = nullptr;
@@ -0,0 +1,160 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "BufferNullImpl.h"
+#include "DeviceNullImpl.h"
+#include "ImmediateContextNullImpl.h"
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+BufferNullImpl::BufferNullImpl(DeviceNullImpl* pDevice, BufferDesc const& Desc, const void* SysMem) :
+    IBuffer(pDevice, Desc)
+{
+    HK_ASSERT(Desc.SizeInBytes > 0);
+
+    Storage.Reset(Desc.SizeInBytes, SysMem);
+    if (SysMem)
+        pDevice->GetContextNull()->RecordUpload(this, Desc.SizeInBytes);
+    else
+        Storage.ZeroMem();
+
+    pDevice->BufferMemoryAllocated += Desc.SizeInBytes;
+
+    SetHandle(this);
+}
+
+BufferNullImpl::~BufferNullImpl()
+{
+    static_cast<DeviceNullImpl*>(GetDevice())->BufferMemoryAllocated -= Desc.SizeInBytes;
+}
+
+bool BufferNullImpl::CreateView(BufferViewDesc const& BufferViewDesc, Ref<IBufferView>* ppBufferView)
+{
+    *ppBufferView = MakeRef<BufferViewNullImpl>(BufferViewDesc, this);
+    return true;
+}
+
+bool BufferNullImpl::Orphan()
+{
+    if (GetDesc().bImmutableStorage)
+    {
+        LOG("Buffer::Orphan: expected mutable buffer\n");
+        return false;
+    }
+    return true;
+}
+
+void BufferNullImpl::Invalidate()
+{
+}
+
+void BufferNullImpl::InvalidateRange(size_t RangeOffset, size_t RangeSize)
+{
+}
+
+void BufferNullImpl::FlushMappedRange(size_t RangeOffset, size_t RangeSize)
+{
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordUpload(this, RangeSize);
+}
+
+void BufferNullImpl::Read(void* pSysMem)
+{
+    ReadRange(0, Desc.SizeInBytes, pSysMem);
+}
+
+void BufferNullImpl::ReadRange(size_t ByteOffset, size_t SizeInBytes, void* pSysMem)
+{
+    HK_ASSERT(ByteOffset + SizeInBytes <= Desc.SizeInBytes);
+
+    Core::Memcpy(pSysMem, GetStorage() + ByteOffset, SizeInBytes);
+
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordReadback(this, SizeInBytes);
+}
+
+void BufferNullImpl::Write(const void* pSysMem)
+{
+    WriteRange(0, Desc.SizeInBytes, pSysMem);
+}
+
+void BufferNullImpl::WriteRange(size_t ByteOffset, size_t SizeInBytes, const void* pSysMem)
+{
+    HK_ASSERT(ByteOffset + SizeInBytes <= Desc.SizeInBytes);
+
+    Core::Memcpy(GetStorage() + ByteOffset, pSysMem, SizeInBytes);
+
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordUpload(this, SizeInBytes);
+}
+
+BufferViewNullImpl::BufferViewNullImpl(BufferViewDesc const& Desc, BufferNullImpl* pBuffer) :
+    IBufferView(pBuffer->GetDevice(), Desc), pBuffer(pBuffer)
+{
+    if (Desc.SizeInBytes == 0)
+    {
+        this->Desc.Offset      = 0;
+        this->Desc.SizeInBytes = pBuffer->GetDesc().SizeInBytes;
+    }
+
+    if (this->Desc.Offset + this->Desc.SizeInBytes > pBuffer->GetDesc().SizeInBytes)
+    {
+        LOG("BufferViewNullImpl::ctor: invalid buffer range\n");
+        return;
+    }
+
+    SetHandle(this);
+}
+
+void BufferViewNullImpl::SetRange(size_t Offset, size_t SizeInBytes)
+{
+    if (Offset + SizeInBytes > pBuffer->GetDesc().SizeInBytes)
+    {
+        LOG("BufferViewNullImpl::SetRange: invalid buffer range\n");
+        return;
+    }
+
+    Desc.Offset      = Offset;
+    Desc.SizeInBytes = SizeInBytes;
+}
+
+size_t BufferViewNullImpl::GetBufferOffset(uint16_t MipLevel) const
+{
+    return Desc.Offset;
+}
+
+size_t BufferViewNullImpl::GetBufferSizeInBytes(uint16_t MipLevel) const
+{
+    return Desc.SizeInBytes;
+}
+
+} // namespace RHI
+
+HK_NAMESPACE_END
@@ -0,0 +1,251 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "DeviceNullImpl.h"
+#include "ImmediateContextNullImpl.h"
+#include "BufferNullImpl.h"
+#include "TextureNullImpl.h"
+#include "PipelineNullImpl.h"
+#include "SwapChainNullImpl.h"
+
+#include <Hork/Core/Logger.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+static void* Allocate(size_t _BytesCount)
+{
+    return Core::GetHeapAllocator<HEAP_RHI>().Alloc(_BytesCount);
+}
+
+static void Deallocate(void* _Bytes)
+{
+    Core::GetHeapAllocator<HEAP_RHI>().Free(_Bytes);
+}
+
+static constexpr AllocatorCallback DefaultAllocator = { Allocate, Deallocate };
+
+/// Sparse texture page size in bytes
+static constexpr int SPARSE_PAGE_SIZE_NULL = 65536;
+
+DeviceNullImpl::DeviceNullImpl()
+{
+    LOG("Initializing null render device...\n");
+
+    GraphicsVendor = VENDOR_UNKNOWN;
+
+    FeatureSupport[FEATURE_HALF_FLOAT_VERTEX]  = true;
+    FeatureSupport[FEATURE_HALF_FLOAT_PIXEL]   = true;
+    FeatureSupport[FEATURE_TEXTURE_ANISOTROPY] = true;
+    FeatureSupport[FEATURE_SPARSE_TEXTURES]    = true;
+    FeatureSupport[FEATURE_SWAP_CONTROL]       = true;
+    FeatureSupport[FEATURE_SPIR_V]             = true;
+
+    // Typical desktop limits so the frontend takes the same code paths as on real hardware
+    DeviceCaps[DEVICE_CAPS_BUFFER_VIEW_MAX_SIZE]                   = 128 << 20;
+    DeviceCaps[DEVICE_CAPS_BUFFER_VIEW_OFFSET_ALIGNMENT]           = 256;
+    DeviceCaps[DEVICE_CAPS_CONSTANT_BUFFER_OFFSET_ALIGNMENT]       = 256;
+    DeviceCaps[DEVICE_CAPS_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT] = 256;
+    DeviceCaps[DEVICE_CAPS_MAX_TEXTURE_SIZE]                       = 16384;
+    DeviceCaps[DEVICE_CAPS_MAX_TEXTURE_LAYERS]                     = 2048;
+    DeviceCaps[DEVICE_CAPS_MAX_SPARSE_TEXTURE_LAYERS]              = 2048;
+    DeviceCaps[DEVICE_CAPS_MAX_TEXTURE_ANISOTROPY]                 = 16;
+    DeviceCaps[DEVICE_CAPS_MAX_PATCH_VERTICES]                     = 32;
+    DeviceCaps[DEVICE_CAPS_MAX_VERTEX_BUFFER_SLOTS]                = MAX_VERTEX_BUFFER_SLOTS;
+    DeviceCaps[DEVICE_CAPS_MAX_VERTEX_ATTRIB_STRIDE]               = 2048;
+    DeviceCaps[DEVICE_CAPS_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET]      = 2047;
+    DeviceCaps[DEVICE_CAPS_MAX_CONSTANT_BUFFER_BINDINGS]           = MAX_BUFFER_SLOTS;
+    DeviceCaps[DEVICE_CAPS_MAX_SHADER_STORAGE_BUFFER_BINDINGS]     = MAX_BUFFER_SLOTS;
+    DeviceCaps[DEVICE_CAPS_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS]     = 8;
+    DeviceCaps[DEVICE_CAPS_MAX_TRANSFORM_FEEDBACK_BUFFERS]         = 4;
+    DeviceCaps[DEVICE_CAPS_CONSTANT_BUFFER_MAX_BLOCK_SIZE]         = 65536;
+
+    Allocator = DefaultAllocator;
+
+    pImmediateContext = new ImmediateContextNullImpl(this);
+}
+
+DeviceNullImpl::~DeviceNullImpl()
+{
+    pImmediateContext->RemoveRef();
+}
+
+IImmediateContext* DeviceNullImpl::GetImmediateContext()
+{
+    return pImmediateContext;
+}
+
+void DeviceNullImpl::GetOrCreateMainWindow(WindowSettings const& windowSettings, Ref<IGenericWindow>* ppWindow)
+{
+    if (pMainWindow.IsExpired())
+    {
+        *ppWindow = MakeRef<GenericWindowNullImpl>(this, windowSettings);
+        pMainWindow = *ppWindow;
+    }
+    else
+    {
+        *ppWindow = pMainWindow;
+    }
+}
+
+void DeviceNullImpl::CreateGenericWindow(WindowSettings const& windowSettings, Ref<IGenericWindow>* ppWindow)
+{
+    *ppWindow = MakeRef<GenericWindowNullImpl>(this, windowSettings);
+}
+
+void DeviceNullImpl::CreateSwapChain(IGenericWindow* pWindow, Ref<ISwapChain>* ppSwapChain)
+{
+    *ppSwapChain = MakeRef<SwapChainNullImpl>(this, static_cast<GenericWindowNullImpl*>(pWindow));
+}
+
+void DeviceNullImpl::CreatePipeline(PipelineDesc const& Desc, Ref<IPipeline>* ppPipeline)
+{
+    *ppPipeline = MakeRef<PipelineNullImpl>(this, Desc);
+}
+
+void DeviceNullImpl::CreateShaderFromBinary(ShaderBinaryData const* BinaryData, Ref<IShaderModule>* ppShaderModule)
+{
+    *ppShaderModule = MakeRef<ShaderModuleNullImpl>(this, BinaryData->ShaderType);
+}
+
+void DeviceNullImpl::CreateShaderFromCode(SHADER_TYPE ShaderType, unsigned int NumSources, const char* const* Sources, Ref<IShaderModule>* ppShaderModule)
+{
+    *ppShaderModule = MakeRef<ShaderModuleNullImpl>(this, ShaderType);
+}
+
+void DeviceNullImpl::CreateBuffer(BufferDesc const& Desc, const void* SysMem, Ref<IBuffer>* ppBuffer)
+{
+    *ppBuffer = MakeRef<BufferNullImpl>(this, Desc, SysMem);
+}
+
+void DeviceNullImpl::CreateTexture(TextureDesc const& Desc, Ref<ITexture>* ppTexture)
+{
+    *ppTexture = MakeRef<TextureNullImpl>(this, Desc);
+}
+
+void DeviceNullImpl::CreateSparseTexture(SparseTextureDesc const& Desc, Ref<ISparseTexture>* ppTexture)
+{
+    *ppTexture = MakeRef<SparseTextureNullImpl>(this, Desc);
+}
+
+void DeviceNullImpl::CreateTransformFeedback(TransformFeedbackDesc const& Desc, Ref<ITransformFeedback>* ppTransformFeedback)
+{
+    *ppTransformFeedback = MakeRef<TransformFeedbackNullImpl>(this);
+}
+
+void DeviceNullImpl::CreateQueryPool(QueryPoolDesc const& Desc, Ref<IQueryPool>* ppQueryPool)
+{
+    *ppQueryPool = MakeRef<QueryPoolNullImpl>(this, Desc);
+}
+
+void DeviceNullImpl::CreateResourceTable(Ref<IResourceTable>* ppResourceTable)
+{
+    *ppResourceTable = MakeRef<ResourceTableNullImpl>(this);
+}
+
+bool DeviceNullImpl::CreateShaderBinaryData(SHADER_TYPE        ShaderType,
+                                            unsigned int       NumSources,
+                                            const char* const* Sources,
+                                            ShaderBinaryData*  BinaryData)
+{
+    LOG("DeviceNullImpl::CreateShaderBinaryData: program binaries are not supported\n");
+    return false;
+}
+
+void DeviceNullImpl::DestroyShaderBinaryData(ShaderBinaryData* BinaryData)
+{
+}
+
+int32_t DeviceNullImpl::GetGPUMemoryTotalAvailable()
+{
+    return 0;
+}
+
+int32_t DeviceNullImpl::GetGPUMemoryCurrentAvailable()
+{
+    return 0;
+}
+
+bool DeviceNullImpl::EnumerateSparseTexturePageSize(SPARSE_TEXTURE_TYPE Type, TEXTURE_FORMAT Format, int* NumPageSizes, int* PageSizesX, int* PageSizesY, int* PageSizesZ)
+{
+    HK_ASSERT(NumPageSizes != nullptr);
+
+    // A single page size per format: the largest block-aligned rectangle that fits into the page
+    TextureFormatInfo const& info = GetTextureFormatInfo(Format);
+
+    int blockCountLog2 = Math::Log2((uint32_t)(SPARSE_PAGE_SIZE_NULL / info.BytesPerBlock));
+
+    *NumPageSizes = 1;
+
+    if (PageSizesX)
+        PageSizesX[0] = (1 << ((blockCountLog2 + 1) / 2)) * info.BlockSize;
+
+    if (PageSizesY)
+        PageSizesY[0] = (1 << (blockCountLog2 / 2)) * info.BlockSize;
+
+    if (PageSizesZ)
+        PageSizesZ[0] = 1;
+
+    return true;
+}
+
+bool DeviceNullImpl::ChooseAppropriateSparseTexturePageSize(SPARSE_TEXTURE_TYPE Type, TEXTURE_FORMAT Format, int Width, int Height, int Depth, int* PageSizeIndex, int* PageSizeX, int* PageSizeY, int* PageSizeZ)
+{
+    HK_ASSERT(PageSizeIndex != nullptr);
+
+    int numPageSizes, pageSizeX, pageSizeY, pageSizeZ;
+    EnumerateSparseTexturePageSize(Type, Format, &numPageSizes, &pageSizeX, &pageSizeY, &pageSizeZ);
+
+    bool bAppropriate = (Width % pageSizeX) == 0 && (Height % pageSizeY) == 0;
+
+    *PageSizeIndex = bAppropriate ? 0 : -1;
+
+    if (PageSizeX)
+        *PageSizeX = bAppropriate ? pageSizeX : 0;
+
+    if (PageSizeY)
+        *PageSizeY = bAppropriate ? pageSizeY : 0;
+
+    if (PageSizeZ)
+        *PageSizeZ = bAppropriate ? pageSizeZ : 0;
+
+    return bAppropriate;
+}
+
+AllocatorCallback const& DeviceNullImpl::GetAllocator() const
+{
+    return Allocator;
+}
+
+} // namespace RHI
+
+HK_NAMESPACE_END
@@ -0,0 +1,110 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/RHI/Common/Device.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+class ImmediateContextNullImpl;
+
+/// Device without GPU. Objects keep CPU-side storage and the immediate context records the commands
+/// it receives, so the renderer frontend can be profiled and tested on machines without a graphics driver.
+class DeviceNullImpl final : public IDevice
+{
+public:
+    DeviceNullImpl();
+    ~DeviceNullImpl();
+
+    IImmediateContext* GetImmediateContext() override;
+
+    void GetOrCreateMainWindow(WindowSettings const& windowSettings, Ref<IGenericWindow>* ppWindow) override;
+
+    void CreateGenericWindow(WindowSettings const& windowSettings, Ref<IGenericWindow>* ppWindow) override;
+
+    void CreateSwapChain(IGenericWindow* pWindow, Ref<ISwapChain>* ppSwapChain) override;
+
+    void CreatePipeline(PipelineDesc const& Desc, Ref<IPipeline>* ppPipeline) override;
+
+    void CreateShaderFromBinary(ShaderBinaryData const* BinaryData, Ref<IShaderModule>* ppShaderModule) override;
+    void CreateShaderFromCode(SHADER_TYPE ShaderType, unsigned int NumSources, const char* const* Sources, Ref<IShaderModule>* ppShaderModule) override;
+
+    void CreateBuffer(BufferDesc const& Desc, const void* SysMem, Ref<IBuffer>* ppBuffer) override;
+
+    void CreateTexture(TextureDesc const& Desc, Ref<ITexture>* ppTexture) override;
+
+    void CreateSparseTexture(SparseTextureDesc const& Desc, Ref<ISparseTexture>* ppTexture) override;
+
+    void CreateTransformFeedback(TransformFeedbackDesc const& Desc, Ref<ITransformFeedback>* ppTransformFeedback) override;
+
+    void CreateQueryPool(QueryPoolDesc const& Desc, Ref<IQueryPool>* ppQueryPool) override;
+
+    void CreateResourceTable(Ref<IResourceTable>* ppResourceTable) override;
+
+    bool CreateShaderBinaryData(SHADER_TYPE        ShaderType,
+                                unsigned int       NumSources,
+                                const char* const* Sources,
+                                ShaderBinaryData*  BinaryData) override;
+
+    void DestroyShaderBinaryData(ShaderBinaryData* BinaryData) override;
+
+    int32_t GetGPUMemoryTotalAvailable() override;
+    int32_t GetGPUMemoryCurrentAvailable() override;
+
+    bool EnumerateSparseTexturePageSize(SPARSE_TEXTURE_TYPE Type, TEXTURE_FORMAT Format, int* NumPageSizes, int* PageSizesX, int* PageSizesY, int* PageSizesZ) override;
+
+    bool ChooseAppropriateSparseTexturePageSize(SPARSE_TEXTURE_TYPE Type, TEXTURE_FORMAT Format, int Width, int Height, int Depth, int* PageSizeIndex, int* PageSizeX = nullptr, int* PageSizeY = nullptr, int* PageSizeZ = nullptr) override;
+
+    AllocatorCallback const& GetAllocator() const override;
+
+    //
+    // Local
+    //
+
+    ImmediateContextNullImpl* GetContextNull() { return pImmediateContext; }
+
+    size_t BufferMemoryAllocated{};
+    size_t TextureMemoryAllocated{};
+
+private:
+    AllocatorCallback Allocator;
+
+    ImmediateContextNullImpl* pImmediateContext{};
+
+    WeakRef<IGenericWindow> pMainWindow;
+};
+
+} // namespace RHI
+
+HK_NAMESPACE_END
@@ -0,0 +1,1067 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ImmediateContextNullImpl.h"
+#include "DeviceNullImpl.h"
+#include "BufferNullImpl.h"
+#include "PipelineNullImpl.h"
+
+#include <Hork/RHI/Common/FrameGraph.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+namespace
+{
+
+uint32_t CountPrimitives(PRIMITIVE_TOPOLOGY Topology, uint32_t VertexCount)
+{
+    switch (Topology)
+    {
+        case PRIMITIVE_POINTS:
+            return VertexCount;
+        case PRIMITIVE_LINES:
+            return VertexCount / 2;
+        case PRIMITIVE_LINE_STRIP:
+            return VertexCount > 1 ? VertexCount - 1 : 0;
+        case PRIMITIVE_LINE_LOOP:
+            return VertexCount > 1 ? VertexCount : 0;
+        case PRIMITIVE_TRIANGLES:
+            return VertexCount / 3;
+        case PRIMITIVE_TRIANGLE_STRIP:
+        case PRIMITIVE_TRIANGLE_FAN:
+            return VertexCount > 2 ? VertexCount - 2 : 0;
+        case PRIMITIVE_LINES_ADJ:
+            return VertexCount / 4;
+        case PRIMITIVE_LINE_STRIP_ADJ:
+            return VertexCount > 3 ? VertexCount - 3 : 0;
+        case PRIMITIVE_TRIANGLES_ADJ:
+            return VertexCount / 6;
+        case PRIMITIVE_TRIANGLE_STRIP_ADJ:
+            return VertexCount >= 6 ? (VertexCount - 4) / 2 : 0;
+        default:
+            if (Topology >= PRIMITIVE_PATCHES_1)
+                return VertexCount / (Topology - PRIMITIVE_PATCHES_1 + 1);
+            return 0;
+    }
+}
+
+template <typename T>
+T const* GetIndirectCommand(IBuffer* pBuffer, size_t ByteOffset)
+{
+    if (!pBuffer || ByteOffset + sizeof(T) > pBuffer->GetDesc().SizeInBytes)
+        return nullptr;
+    return reinterpret_cast<T const*>(static_cast<BufferNullImpl*>(pBuffer)->GetStorage() + ByteOffset);
+}
+
+uint32_t ClampToUInt32(size_t Value)
+{
+    return (uint32_t)Math::Min<size_t>(Value, 0xffffffff);
+}
+
+} // namespace
+
+ResourceTableNullImpl::ResourceTableNullImpl(DeviceNullImpl* pDevice, bool bIsRoot) :
+    IResourceTable(pDevice, bIsRoot)
+{
+    SetHandle(this);
+}
+
+void ResourceTableNullImpl::BindTexture(unsigned int Slot, ITextureView* pShaderResourceView)
+{
+    HK_ASSERT(Slot < MAX_SAMPLER_SLOTS);
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordResourceBind(this, Slot, pShaderResourceView);
+}
+
+void ResourceTableNullImpl::BindTexture(unsigned int Slot, IBufferView* pShaderResourceView)
+{
+    HK_ASSERT(Slot < MAX_SAMPLER_SLOTS);
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordResourceBind(this, Slot, pShaderResourceView);
+}
+
+void ResourceTableNullImpl::BindImage(unsigned int Slot, ITextureView* pUnorderedAccessView)
+{
+    HK_ASSERT(Slot < MAX_IMAGE_SLOTS);
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordResourceBind(this, Slot, pUnorderedAccessView);
+}
+
+void ResourceTableNullImpl::BindBuffer(int Slot, IBuffer const* pBuffer, size_t Offset, size_t Size)
+{
+    HK_ASSERT(Slot < MAX_BUFFER_SLOTS);
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordResourceBind(this, Slot, const_cast<IBuffer*>(pBuffer));
+}
+
+ImmediateContextNullImpl::ImmediateContextNullImpl(DeviceNullImpl* pDevice) :
+    IImmediateContext(pDevice)
+{
+    RootResourceTable = MakeRef<ResourceTableNullImpl>(pDevice, true);
+    CurrentResourceTable = RootResourceTable->GetUID();
+
+    SetHandle(this);
+}
+
+ImmediateContextNullImpl::~ImmediateContextNullImpl()
+{
+}
+
+void ImmediateContextNullImpl::ResetStats()
+{
+    Stats = {};
+}
+
+void ImmediateContextNullImpl::Record(NULL_COMMAND_TYPE Type, uint32_t Object, uint32_t Arg0, uint32_t Arg1, uint8_t Slot)
+{
+    Stats.Commands++;
+
+    if (bRecordCommands)
+    {
+        NullCommand& command = Commands.Add();
+        command.Type   = Type;
+        command.Slot   = Slot;
+        command.Pad    = 0;
+        command.Object = Object;
+        command.Arg0   = Arg0;
+        command.Arg1   = Arg1;
+    }
+}
+
+void ImmediateContextNullImpl::RecordDraw(NULL_COMMAND_TYPE Type, uint32_t VertexCount, uint32_t InstanceCount)
+{
+    Stats.DrawCalls++;
+    Stats.Instances += InstanceCount;
+    Stats.Primitives += (uint64_t)CountPrimitives(CurrentTopology, VertexCount) * InstanceCount;
+
+    Record(Type, CurrentPipeline, VertexCount, InstanceCount);
+}
+
+void ImmediateContextNullImpl::RecordUpload(IDeviceObject* pObject, size_t SizeInBytes)
+{
+    Stats.UploadedBytes += SizeInBytes;
+
+    Record(NULL_CMD_UPLOAD, pObject->GetUID(), ClampToUInt32(SizeInBytes));
+}
+
+void ImmediateContextNullImpl::RecordReadback(IDeviceObject* pObject, size_t SizeInBytes)
+{
+    Stats.ReadbackBytes += SizeInBytes;
+
+    Record(NULL_CMD_READBACK, pObject->GetUID(), ClampToUInt32(SizeInBytes));
+}
+
+void ImmediateContextNullImpl::RecordResourceBind(IResourceTable* pResourceTable, unsigned int Slot, IDeviceObject* pObject)
+{
+    Stats.ResourceBinds++;
+
+    Record(NULL_CMD_BIND_RESOURCE_TABLE, pResourceTable->GetUID(), pObject ? pObject->GetUID() : 0, 0, Slot);
+}
+
+void ImmediateContextNullImpl::RecordPresent(ISwapChain* pSwapChain)
+{
+    Stats.Frames++;
+
+    Record(NULL_CMD_PRESENT, pSwapChain->GetUID());
+}
+
+void ImmediateContextNullImpl::ExecuteFrameGraph(FrameGraph* pFrameGraph)
+{
+    auto& acquiredResources = pFrameGraph->GetAcquiredResources();
+    auto& releasedResources = pFrameGraph->GetReleasedResources();
+
+    FGRenderTargetCache* pRenderTargetCache = pFrameGraph->GetRenderTargetCache();
+
+    for (FrameGraph::TimelineStep const& step : pFrameGraph->GetTimeline())
+    {
+        // Acquire resources for the render pass
+        for (int i = 0; i < step.NumAcquiredResources; i++)
+        {
+            FGResourceProxyBase* resourceProxy = acquiredResources[step.FirstAcquiredResource + i];
+            if (resourceProxy->IsTransient())
+            {
+                switch (resourceProxy->GetProxyType())
+                {
+                    case DEVICE_OBJECT_TYPE_TEXTURE:
+                        resourceProxy->SetDeviceObject(pRenderTargetCache->Acquire(static_cast<FGTextureProxy*>(resourceProxy)->GetResourceDesc()));
+                        break;
+                    default:
+                        HK_ASSERT(0);
+                }
+            }
+        }
+
+        switch (step.RenderTask->GetProxyType())
+        {
+            case FG_RENDER_TASK_PROXY_TYPE_RENDER_PASS:
+                ExecuteRenderPass(static_cast<RenderPass*>(step.RenderTask));
+                break;
+            case FG_RENDER_TASK_PROXY_TYPE_CUSTOM:
+                ExecuteCustomTask(static_cast<FGCustomTask*>(step.RenderTask));
+                break;
+            default:
+                HK_ASSERT(0);
+                break;
+        }
+
+        // Release resources that are not needed after the current render pass
+        for (int i = 0; i < step.NumReleasedResources; i++)
+        {
+            FGResourceProxyBase* resourceProxy = releasedResources[step.FirstReleasedResource + i];
+            if (resourceProxy->IsTransient() && resourceProxy->GetDeviceObject())
+            {
+                switch (resourceProxy->GetProxyType())
+                {
+                    case DEVICE_OBJECT_TYPE_TEXTURE:
+                        pRenderTargetCache->Release(static_cast<ITexture*>(resourceProxy->GetDeviceObject()));
+                        break;
+                    default:
+                        HK_ASSERT(0);
+                }
+            }
+        }
+    }
+
+    BindResourceTable(nullptr);
+}
+
+void ImmediateContextNullImpl::ExecuteRenderPass(RenderPass* pRenderPass)
+{
+    Rect2D renderArea;
+    if (pRenderPass->IsRenderAreaSpecified())
+    {
+        renderArea = pRenderPass->GetRenderArea();
+    }
+    else
+    {
+        auto& colorAttachments = pRenderPass->GetColorAttachments();
+
+        TextureAttachment const* attachment = nullptr;
+        if (!colorAttachments.IsEmpty())
+            attachment = &colorAttachments[0];
+        else if (pRenderPass->HasDepthStencilAttachment())
+            attachment = &pRenderPass->GetDepthStencilAttachment();
+
+        if (attachment)
+        {
+            ITexture* texture = const_cast<TextureAttachment*>(attachment)->GetTexture();
+
+            renderArea.Width  = Math::Max(1u, texture->GetWidth() >> attachment->MipLevel);
+            renderArea.Height = Math::Max(1u, texture->GetHeight() >> attachment->MipLevel);
+        }
+    }
+
+    Stats.RenderPasses++;
+
+    Record(NULL_CMD_BEGIN_RENDER_PASS, 0, renderArea.Width, renderArea.Height, pRenderPass->GetColorAttachments().Size());
+
+    Viewport vp;
+    vp.X        = renderArea.X;
+    vp.Y        = renderArea.Y;
+    vp.Width    = renderArea.Width;
+    vp.Height   = renderArea.Height;
+    vp.MinDepth = 0;
+    vp.MaxDepth = 1;
+    SetViewport(vp);
+
+    FGCommandBuffer     commandBuffer;
+    FGRenderPassContext renderPassContext;
+
+    renderPassContext.pRenderPass       = pRenderPass;
+    renderPassContext.SubpassIndex      = 0;
+    renderPassContext.RenderArea        = renderArea;
+    renderPassContext.pImmediateContext = this;
+    for (FGSubpassInfo const& Subpass : pRenderPass->GetSubpasses())
+    {
+        Subpass.Function(renderPassContext, commandBuffer);
+        renderPassContext.SubpassIndex++;
+    }
+
+    Record(NULL_CMD_END_RENDER_PASS);
+}
+
+void ImmediateContextNullImpl::ExecuteCustomTask(FGCustomTask* pCustomTask)
+{
+    Record(NULL_CMD_CUSTOM_TASK);
+
+    FGCustomTaskContext taskContext;
+    taskContext.pImmediateContext = this;
+    pCustomTask->Function(taskContext);
+}
+
+void ImmediateContextNullImpl::BindPipeline(IPipeline* pPipeline)
+{
+    HK_ASSERT(pPipeline != nullptr);
+
+    Stats.PipelineBinds++;
+
+    if (CurrentPipeline == pPipeline->GetUID())
+    {
+        Stats.RedundantBinds++;
+    }
+    else
+    {
+        CurrentPipeline = pPipeline->GetUID();
+        CurrentTopology = static_cast<PipelineNullImpl*>(pPipeline)->GetTopology();
+    }
+
+    Record(NULL_CMD_BIND_PIPELINE, CurrentPipeline);
+}
+
+void ImmediateContextNullImpl::BindVertexBuffer(unsigned int InputSlot, IBuffer const* pVertexBuffer, unsigned int Offset)
+{
+    HK_ASSERT(InputSlot < MAX_VERTEX_BUFFER_SLOTS);
+
+    uint32_t uid = pVertexBuffer ? pVertexBuffer->GetUID() : 0;
+
+    Stats.VertexBufferBinds++;
+
+    if (CurrentVertexBuffers[InputSlot] == uid && CurrentVertexBufferOffsets[InputSlot] == Offset)
+    {
+        Stats.RedundantBinds++;
+    }
+    else
+    {
+        CurrentVertexBuffers[InputSlot]       = uid;
+        CurrentVertexBufferOffsets[InputSlot] = Offset;
+    }
+
+    Record(NULL_CMD_BIND_VERTEX_BUFFER, uid, Offset, 0, InputSlot);
+}
+
+void ImmediateContextNullImpl::BindVertexBuffers(unsigned int StartSlot, unsigned int NumBuffers, IBuffer* const* ppVertexBuffers, uint32_t const* pOffsets)
+{
+    HK_ASSERT(StartSlot + NumBuffers <= MAX_VERTEX_BUFFER_SLOTS);
+
+    for (unsigned int i = 0; i < NumBuffers; ++i)
+    {
+        BindVertexBuffer(StartSlot + i, ppVertexBuffers ? ppVertexBuffers[i] : nullptr, pOffsets ? pOffsets[i] : 0);
+    }
+}
+
+void ImmediateContextNullImpl::BindIndexBuffer(IBuffer const* pIndexBuffer, INDEX_TYPE Type, unsigned int Offset)
+{
+    uint32_t uid = pIndexBuffer ? pIndexBuffer->GetUID() : 0;
+
+    Stats.IndexBufferBinds++;
+
+    if (CurrentIndexBuffer == uid && CurrentIndexBufferOffset == Offset && CurrentIndexType == Type)
+    {
+        Stats.RedundantBinds++;
+    }
+    else
+    {
+        CurrentIndexBuffer       = uid;
+        CurrentIndexBufferOffset = Offset;
+        CurrentIndexType         = Type;
+    }
+
+    Record(NULL_CMD_BIND_INDEX_BUFFER, uid, Offset, Type);
+}
+
+IResourceTable* ImmediateContextNullImpl::GetRootResourceTable()
+{
+    return RootResourceTable;
+}
+
+void ImmediateContextNullImpl::BindResourceTable(IResourceTable* pResourceTable)
+{
+    if (!pResourceTable)
+        pResourceTable = RootResourceTable;
+
+    Stats.ResourceTableBinds++;
+
+    if (CurrentResourceTable == pResourceTable->GetUID())
+        Stats.RedundantBinds++;
+    else
+        CurrentResourceTable = pResourceTable->GetUID();
+
+    Record(NULL_CMD_BIND_RESOURCE_TABLE, CurrentResourceTable);
+}
+
+void ImmediateContextNullImpl::SetViewport(Viewport const& Viewport)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_VIEWPORT, 0, (uint32_t)Viewport.Width, (uint32_t)Viewport.Height);
+}
+
+void ImmediateContextNullImpl::SetViewportArray(uint32_t NumViewports, Viewport const* pViewports)
+{
+    SetViewportArray(0, NumViewports, pViewports);
+}
+
+void ImmediateContextNullImpl::SetViewportArray(uint32_t FirstIndex, uint32_t NumViewports, Viewport const* pViewports)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_VIEWPORT, 0, FirstIndex, NumViewports);
+}
+
+void ImmediateContextNullImpl::SetViewportIndexed(uint32_t Index, Viewport const& Viewport)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_VIEWPORT, 0, (uint32_t)Viewport.Width, (uint32_t)Viewport.Height, Index);
+}
+
+void ImmediateContextNullImpl::SetScissor(Rect2D const& Scissor)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_SCISSOR, 0, Scissor.Width, Scissor.Height);
+}
+
+void ImmediateContextNullImpl::SetScissorArray(uint32_t NumScissors, Rect2D const* pScissors)
+{
+    SetScissorArray(0, NumScissors, pScissors);
+}
+
+void ImmediateContextNullImpl::SetScissorArray(uint32_t FirstIndex, uint32_t NumScissors, Rect2D const* pScissors)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_SCISSOR, 0, FirstIndex, NumScissors);
+}
+
+void ImmediateContextNullImpl::SetScissorIndexed(uint32_t Index, Rect2D const& Scissor)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_SCISSOR, 0, Scissor.Width, Scissor.Height, Index);
+}
+
+void ImmediateContextNullImpl::BindTransformFeedback(ITransformFeedback* pTransformFeedback)
+{
+    Record(NULL_CMD_TRANSFORM_FEEDBACK, pTransformFeedback ? pTransformFeedback->GetUID() : 0);
+}
+
+void ImmediateContextNullImpl::BeginTransformFeedback(PRIMITIVE_TOPOLOGY OutputPrimitive)
+{
+    Record(NULL_CMD_TRANSFORM_FEEDBACK, 0, 1, OutputPrimitive);
+}
+
+void ImmediateContextNullImpl::ResumeTransformFeedback()
+{
+    Record(NULL_CMD_TRANSFORM_FEEDBACK, 0, 2);
+}
+
+void ImmediateContextNullImpl::PauseTransformFeedback()
+{
+    Record(NULL_CMD_TRANSFORM_FEEDBACK, 0, 3);
+}
+
+void ImmediateContextNullImpl::EndTransformFeedback()
+{
+    Record(NULL_CMD_TRANSFORM_FEEDBACK, 0, 4);
+}
+
+void ImmediateContextNullImpl::Draw(DrawCmd const* pCmd)
+{
+    RecordDraw(NULL_CMD_DRAW, pCmd->VertexCountPerInstance, pCmd->InstanceCount);
+}
+
+void ImmediateContextNullImpl::Draw(DrawIndexedCmd const* pCmd)
+{
+    RecordDraw(NULL_CMD_DRAW_INDEXED, pCmd->IndexCountPerInstance, pCmd->InstanceCount);
+}
+
+void ImmediateContextNullImpl::Draw(ITransformFeedback* pTransformFeedback, unsigned int InstanceCount, unsigned int StreamIndex)
+{
+    // The number of captured vertices is unknown
+    RecordDraw(NULL_CMD_DRAW, 0, InstanceCount);
+}
+
+void ImmediateContextNullImpl::DrawIndirect(IBuffer* pDrawIndirectBuffer, unsigned int AlignedByteOffset)
+{
+    DrawIndirectCmd const* cmd = GetIndirectCommand<DrawIndirectCmd>(pDrawIndirectBuffer, AlignedByteOffset);
+
+    RecordDraw(NULL_CMD_DRAW_INDIRECT, cmd ? cmd->VertexCountPerInstance : 0, cmd ? cmd->InstanceCount : 0);
+}
+
+void ImmediateContextNullImpl::DrawIndexedIndirect(IBuffer* pDrawIndirectBuffer, unsigned int AlignedByteOffset)
+{
+    DrawIndexedIndirectCmd const* cmd = GetIndirectCommand<DrawIndexedIndirectCmd>(pDrawIndirectBuffer, AlignedByteOffset);
+
+    RecordDraw(NULL_CMD_DRAW_INDIRECT, cmd ? cmd->IndexCountPerInstance : 0, cmd ? cmd->InstanceCount : 0);
+}
+
+void ImmediateContextNullImpl::MultiDraw(unsigned int DrawCount, const unsigned int* VertexCount, const unsigned int* StartVertexLocations)
+{
+    uint64_t primitives = 0;
+    for (unsigned int i = 0; i < DrawCount; ++i)
+        primitives += CountPrimitives(CurrentTopology, VertexCount[i]);
+
+    Stats.DrawCalls++;
+    Stats.Instances += DrawCount;
+    Stats.Primitives += primitives;
+
+    Record(NULL_CMD_MULTI_DRAW, CurrentPipeline, DrawCount, ClampToUInt32(primitives));
+}
+
+void ImmediateContextNullImpl::MultiDraw(unsigned int DrawCount, const unsigned int* IndexCount, const void* const* IndexByteOffsets, const int* BaseVertexLocations)
+{
+    MultiDraw(DrawCount, IndexCount, static_cast<const unsigned int*>(nullptr));
+}
+
+void ImmediateContextNullImpl::MultiDrawIndirect(unsigned int DrawCount, IBuffer* pDrawIndirectBuffer, unsigned int AlignedByteOffset, unsigned int Stride)
+{
+    if (!Stride)
+        Stride = sizeof(DrawIndirectCmd);
+
+    uint64_t primitives = 0;
+    uint64_t instances  = 0;
+    for (unsigned int i = 0; i < DrawCount; ++i)
+    {
+        if (DrawIndirectCmd const* cmd = GetIndirectCommand<DrawIndirectCmd>(pDrawIndirectBuffer, AlignedByteOffset + (size_t)i * Stride))
+        {
+            primitives += (uint64_t)CountPrimitives(CurrentTopology, cmd->VertexCountPerInstance) * cmd->InstanceCount;
+            instances  += cmd->InstanceCount;
+        }
+    }
+
+    Stats.DrawCalls++;
+    Stats.Instances += instances;
+    Stats.Primitives += primitives;
+
+    Record(NULL_CMD_MULTI_DRAW, CurrentPipeline, DrawCount, ClampToUInt32(primitives));
+}
+
+void ImmediateContextNullImpl::MultiDrawIndexedIndirect(unsigned int DrawCount, IBuffer* pDrawIndirectBuffer, unsigned int AlignedByteOffset, unsigned int Stride)
+{
+    if (!Stride)
+        Stride = sizeof(DrawIndexedIndirectCmd);
+
+    uint64_t primitives = 0;
+    uint64_t instances  = 0;
+    for (unsigned int i = 0; i < DrawCount; ++i)
+    {
+        if (DrawIndexedIndirectCmd const* cmd = GetIndirectCommand<DrawIndexedIndirectCmd>(pDrawIndirectBuffer, AlignedByteOffset + (size_t)i * Stride))
+        {
+            primitives += (uint64_t)CountPrimitives(CurrentTopology, cmd->IndexCountPerInstance) * cmd->InstanceCount;
+            instances  += cmd->InstanceCount;
+        }
+    }
+
+    Stats.DrawCalls++;
+    Stats.Instances += instances;
+    Stats.Primitives += primitives;
+
+    Record(NULL_CMD_MULTI_DRAW, CurrentPipeline, DrawCount, ClampToUInt32(primitives));
+}
+
+void ImmediateContextNullImpl::DispatchCompute(unsigned int ThreadGroupCountX, unsigned int ThreadGroupCountY, unsigned int ThreadGroupCountZ)
+{
+    Stats.Dispatches++;
+
+    Record(NULL_CMD_DISPATCH, CurrentPipeline, ThreadGroupCountX * ThreadGroupCountY * ThreadGroupCountZ);
+}
+
+void ImmediateContextNullImpl::DispatchCompute(DispatchIndirectCmd const* pCmd)
+{
+    DispatchCompute(pCmd->ThreadGroupCountX, pCmd->ThreadGroupCountY, pCmd->ThreadGroupCountZ);
+}
+
+void ImmediateContextNullImpl::DispatchComputeIndirect(IBuffer* pDispatchIndirectBuffer, unsigned int AlignedByteOffset)
+{
+    if (DispatchIndirectCmd const* cmd = GetIndirectCommand<DispatchIndirectCmd>(pDispatchIndirectBuffer, AlignedByteOffset))
+        DispatchCompute(cmd);
+    else
+        DispatchCompute(0, 0, 0);
+}
+
+void ImmediateContextNullImpl::BeginQuery(IQueryPool* QueryPool, uint32_t QueryID, uint32_t StreamIndex)
+{
+    Record(NULL_CMD_QUERY, QueryPool->GetUID(), QueryID, 1);
+}
+
+void ImmediateContextNullImpl::EndQuery(IQueryPool* QueryPool, uint32_t StreamIndex)
+{
+    Record(NULL_CMD_QUERY, QueryPool->GetUID(), 0, 2);
+}
+
+void ImmediateContextNullImpl::RecordTimeStamp(IQueryPool* QueryPool, uint32_t QueryID)
+{
+    Record(NULL_CMD_QUERY, QueryPool->GetUID(), QueryID, 3);
+}
+
+void ImmediateContextNullImpl::CopyQueryPoolResultsAvailable(IQueryPool* QueryPool,
+                                                             uint32_t    FirstQuery,
+                                                             uint32_t    QueryCount,
+                                                             IBuffer*    pDstBuffer,
+                                                             size_t      DstOffst,
+                                                             size_t      DstStride,
+                                                             bool        QueryResult64Bit)
+{
+    Record(NULL_CMD_QUERY, QueryPool->GetUID(), FirstQuery, QueryCount);
+}
+
+void ImmediateContextNullImpl::CopyQueryPoolResults(IQueryPool*        QueryPool,
+                                                    uint32_t           FirstQuery,
+                                                    uint32_t           QueryCount,
+                                                    IBuffer*           pDstBuffer,
+                                                    size_t             DstOffst,
+                                                    size_t             DstStride,
+                                                    QUERY_RESULT_FLAGS Flags)
+{
+    Record(NULL_CMD_QUERY, QueryPool->GetUID(), FirstQuery, QueryCount);
+}
+
+void ImmediateContextNullImpl::BeginConditionalRender(IQueryPool* QueryPool, uint32_t QueryID, CONDITIONAL_RENDER_MODE Mode)
+{
+    Record(NULL_CMD_CONDITIONAL_RENDER, QueryPool->GetUID(), QueryID, Mode);
+}
+
+void ImmediateContextNullImpl::EndConditionalRender()
+{
+    Record(NULL_CMD_CONDITIONAL_RENDER);
+}
+
+SyncObject ImmediateContextNullImpl::FenceSync()
+{
+    Record(NULL_CMD_SYNC);
+
+    // Any non-null value. The commands are complete as soon as they are issued.
+    return reinterpret_cast<SyncObject>(++SyncCounter);
+}
+
+void ImmediateContextNullImpl::RemoveSync(SyncObject Sync)
+{
+}
+
+CLIENT_WAIT_STATUS ImmediateContextNullImpl::ClientWait(SyncObject Sync, uint64_t TimeOutNanoseconds)
+{
+    return CLIENT_WAIT_ALREADY_SIGNALED;
+}
+
+void ImmediateContextNullImpl::ServerWait(SyncObject Sync)
+{
+}
+
+bool ImmediateContextNullImpl::IsSignaled(SyncObject Sync)
+{
+    return true;
+}
+
+void ImmediateContextNullImpl::Flush()
+{
+    Record(NULL_CMD_SYNC);
+}
+
+void ImmediateContextNullImpl::Barrier(int BarrierBits)
+{
+    Record(NULL_CMD_BARRIER, 0, BarrierBits);
+}
+
+void ImmediateContextNullImpl::BarrierByRegion(int BarrierBits)
+{
+    Record(NULL_CMD_BARRIER, 0, BarrierBits);
+}
+
+void ImmediateContextNullImpl::TextureBarrier()
+{
+    Record(NULL_CMD_BARRIER);
+}
+
+void ImmediateContextNullImpl::DynamicState_BlendingColor(const float ConstantColor[4])
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_DYNAMIC_STATE, 0, 0);
+}
+
+void ImmediateContextNullImpl::DynamicState_SampleMask(const uint32_t SampleMask[4])
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_DYNAMIC_STATE, 0, 1, SampleMask ? SampleMask[0] : 0xffffffff);
+}
+
+void ImmediateContextNullImpl::DynamicState_StencilRef(uint32_t StencilRef)
+{
+    Stats.StateChanges++;
+
+    Record(NULL_CMD_SET_DYNAMIC_STATE, 0, 2, StencilRef);
+}
+
+void ImmediateContextNullImpl::CopyBuffer(IBuffer* pSrcBuffer, IBuffer* pDstBuffer)
+{
+    BufferCopy range;
+    range.SrcOffset   = 0;
+    range.DstOffset   = 0;
+    range.SizeInBytes = Math::Min(pSrcBuffer->GetDesc().SizeInBytes, pDstBuffer->GetDesc().SizeInBytes);
+
+    CopyBufferRange(pSrcBuffer, pDstBuffer, 1, &range);
+}
+
+void ImmediateContextNullImpl::CopyBufferRange(IBuffer* pSrcBuffer, IBuffer* pDstBuffer, uint32_t NumRanges, BufferCopy const* Ranges)
+{
+    uint8_t const* src = static_cast<BufferNullImpl*>(pSrcBuffer)->GetStorage();
+    uint8_t*       dst = static_cast<BufferNullImpl*>(pDstBuffer)->GetStorage();
+
+    size_t copiedBytes = 0;
+    for (BufferCopy const* range = Ranges; range < &Ranges[NumRanges]; range++)
+    {
+        HK_ASSERT(range->SrcOffset + range->SizeInBytes <= pSrcBuffer->GetDesc().SizeInBytes);
+        HK_ASSERT(range->DstOffset + range->SizeInBytes <= pDstBuffer->GetDesc().SizeInBytes);
+
+        std::memmove(dst + range->DstOffset, src + range->SrcOffset, range->SizeInBytes);
+        copiedBytes += range->SizeInBytes;
+    }
+
+    Stats.CopiedBytes += copiedBytes;
+
+    Record(NULL_CMD_COPY, pDstBuffer->GetUID(), pSrcBuffer->GetUID(), ClampToUInt32(copiedBytes));
+}
+
+bool ImmediateContextNullImpl::CopyBufferToTexture(IBuffer const*     pSrcBuffer,
+                                                   ITexture*          pDstTexture,
+                                                   TextureRect const& Rectangle,
+                                                   DATA_FORMAT        Format,
+                                                   size_t             CompressedDataSizeInBytes,
+                                                   size_t             SourceByteOffset,
+                                                   unsigned int       Alignment)
+{
+    Record(NULL_CMD_COPY, pDstTexture->GetUID(), pSrcBuffer->GetUID());
+    return true;
+}
+
+void ImmediateContextNullImpl::CopyTextureToBuffer(ITexture const*    pSrcTexture,
+                                                   IBuffer*           pDstBuffer,
+                                                   TextureRect const& Rectangle,
+                                                   DATA_FORMAT        Format,
+                                                   size_t             SizeInBytes,
+                                                   size_t             DstByteOffset,
+                                                   unsigned int       Alignment)
+{
+    HK_ASSERT(DstByteOffset + SizeInBytes <= pDstBuffer->GetDesc().SizeInBytes);
+
+    // Textures have no storage
+    Core::ZeroMem(static_cast<BufferNullImpl*>(pDstBuffer)->GetStorage() + DstByteOffset, SizeInBytes);
+
+    Record(NULL_CMD_COPY, pDstBuffer->GetUID(), pSrcTexture->GetUID(), ClampToUInt32(SizeInBytes));
+}
+
+void ImmediateContextNullImpl::CopyTextureRect(ITexture const*    pSrcTexture,
+                                               ITexture*          pDstTexture,
+                                               uint32_t           NumCopies,
+                                               TextureCopy const* Copies)
+{
+    Record(NULL_CMD_COPY, pDstTexture->GetUID(), pSrcTexture->GetUID());
+}
+
+void ImmediateContextNullImpl::FillBuffer(IBuffer* pBuffer, size_t Offset, size_t SizeInBytes, BUFFER_VIEW_PIXEL_FORMAT InternalFormat, const ClearValue* ClearValue)
+{
+    HK_ASSERT(Offset + SizeInBytes <= pBuffer->GetDesc().SizeInBytes);
+
+    uint8_t* dst = static_cast<BufferNullImpl*>(pBuffer)->GetStorage() + Offset;
+
+    if (!ClearValue)
+    {
+        Core::ZeroMem(dst, SizeInBytes);
+        return;
+    }
+
+    // The clear value is expected in the internal format, no conversion is performed
+    size_t elementSize = Math::Min<size_t>(GetTextureFormatInfo((TEXTURE_FORMAT)InternalFormat).BytesPerBlock, sizeof(*ClearValue));
+    for (size_t i = 0; i + elementSize <= SizeInBytes; i += elementSize)
+        Core::Memcpy(dst + i, ClearValue, elementSize);
+}
+
+void ImmediateContextNullImpl::ClearBuffer(IBuffer* pBuffer, BUFFER_VIEW_PIXEL_FORMAT InternalFormat, DATA_FORMAT Format, const ClearValue* ClearValue)
+{
+    FillBuffer(pBuffer, 0, pBuffer->GetDesc().SizeInBytes, InternalFormat, ClearValue);
+
+    Record(NULL_CMD_CLEAR, pBuffer->GetUID(), ClampToUInt32(pBuffer->GetDesc().SizeInBytes));
+}
+
+void ImmediateContextNullImpl::ClearBufferRange(IBuffer* pBuffer, BUFFER_VIEW_PIXEL_FORMAT InternalFormat, uint32_t NumRanges, BufferClear const* Ranges, DATA_FORMAT Format, const ClearValue* ClearValue)
+{
+    size_t clearedBytes = 0;
+    for (BufferClear const* range = Ranges; range < &Ranges[NumRanges]; range++)
+    {
+        FillBuffer(pBuffer, range->Offset, range->SizeInBytes, InternalFormat, ClearValue);
+        clearedBytes += range->SizeInBytes;
+    }
+
+    Record(NULL_CMD_CLEAR, pBuffer->GetUID(), ClampToUInt32(clearedBytes));
+}
+
+void ImmediateContextNullImpl::ClearTexture(ITexture* pTexture, uint16_t MipLevel, DATA_FORMAT Format, const ClearValue* ClearValue)
+{
+    Record(NULL_CMD_CLEAR, pTexture->GetUID(), 0, MipLevel);
+}
+
+void ImmediateContextNullImpl::ClearTextureRect(ITexture*          pTexture,
+                                                uint32_t           NumRectangles,
+                                                TextureRect const* Rectangles,
+                                                DATA_FORMAT        Format,
+                                                const ClearValue*  ClearValue)
+{
+    Record(NULL_CMD_CLEAR, pTexture->GetUID(), 0, NumRectangles);
+}
+
+void ImmediateContextNullImpl::ReadTexture(ITexture*    pTexture,
+                                           uint16_t     MipLevel,
+                                           size_t       SizeInBytes,
+                                           unsigned int Alignment,
+                                           void*        pSysMem)
+{
+    pTexture->Read(MipLevel, SizeInBytes, Alignment, pSysMem);
+}
+
+void ImmediateContextNullImpl::ReadTextureRect(ITexture*          pTexture,
+                                               TextureRect const& Rectangle,
+                                               size_t             SizeInBytes,
+                                               unsigned int       Alignment,
+                                               void*              pSysMem)
+{
+    pTexture->ReadRect(Rectangle, SizeInBytes, Alignment, pSysMem);
+}
+
+bool ImmediateContextNullImpl::WriteTexture(ITexture*    pTexture,
+                                            uint16_t     MipLevel,
+                                            size_t       SizeInBytes,
+                                            unsigned int Alignment,
+                                            const void*  pSysMem)
+{
+    return pTexture->Write(MipLevel, SizeInBytes, Alignment, pSysMem);
+}
+
+bool ImmediateContextNullImpl::WriteTextureRect(ITexture*          pTexture,
+                                                TextureRect const& Rectangle,
+                                                size_t             SizeInBytes,
+                                                unsigned int       Alignment,
+                                                const void*        pSysMem,
+                                                size_t             RowPitch,
+                                                size_t             DepthPitch)
+{
+    return pTexture->WriteRect(Rectangle, SizeInBytes, Alignment, pSysMem, RowPitch, DepthPitch);
+}
+
+void ImmediateContextNullImpl::ReadBufferRange(IBuffer* pBuffer, size_t ByteOffset, size_t SizeInBytes, void* pSysMem)
+{
+    pBuffer->ReadRange(ByteOffset, SizeInBytes, pSysMem);
+}
+
+void ImmediateContextNullImpl::WriteBufferRange(IBuffer* pBuffer, size_t ByteOffset, size_t SizeInBytes, const void* pSysMem)
+{
+    pBuffer->WriteRange(ByteOffset, SizeInBytes, pSysMem);
+}
+
+void* ImmediateContextNullImpl::MapBufferRange(IBuffer*        pBuffer,
+                                               size_t          RangeOffset,
+                                               size_t          RangeSize,
+                                               MAP_TRANSFER    ClientServerTransfer,
+                                               MAP_INVALIDATE  Invalidate,
+                                               MAP_PERSISTENCE Persistence,
+                                               bool            FlushExplicit,
+                                               bool            Unsynchronized)
+{
+    if (RangeOffset + RangeSize > pBuffer->GetDesc().SizeInBytes)
+    {
+        LOG("ImmediateContextNullImpl::MapBufferRange: invalid buffer range\n");
+        return nullptr;
+    }
+
+    Record(NULL_CMD_MAP, pBuffer->GetUID(), ClampToUInt32(RangeSize), ClientServerTransfer);
+
+    // Explicitly flushed ranges are counted by FlushMappedRange. Writes to persistent mappings without flush are not visible.
+    if (ClientServerTransfer != MAP_TRANSFER_READ && Persistence == MAP_NON_PERSISTENT && !FlushExplicit)
+        RecordUpload(pBuffer, RangeSize);
+
+    return static_cast<BufferNullImpl*>(pBuffer)->GetStorage() + RangeOffset;
+}
+
+void* ImmediateContextNullImpl::MapBuffer(IBuffer*        pBuffer,
+                                          MAP_TRANSFER    ClientServerTransfer,
+                                          MAP_INVALIDATE  Invalidate,
+                                          MAP_PERSISTENCE Persistence,
+                                          bool            FlushExplicit,
+                                          bool            Unsynchronized)
+{
+    return MapBufferRange(pBuffer, 0, pBuffer->GetDesc().SizeInBytes, ClientServerTransfer, Invalidate, Persistence, FlushExplicit, Unsynchronized);
+}
+
+void ImmediateContextNullImpl::UnmapBuffer(IBuffer* pBuffer)
+{
+}
+
+void ImmediateContextNullImpl::SparseTextureCommitPage(ISparseTexture* pTexture,
+                                                       int             MipLevel,
+                                                       int             PageX,
+                                                       int             PageY,
+                                                       int             PageZ,
+                                                       DATA_FORMAT     Format,
+                                                       size_t          SizeInBytes,
+                                                       unsigned int    Alignment,
+                                                       const void*     pSysMem)
+{
+    Stats.UploadedBytes += SizeInBytes;
+
+    Record(NULL_CMD_SPARSE_COMMIT, pTexture->GetUID(), ClampToUInt32(SizeInBytes), 1);
+}
+
+void ImmediateContextNullImpl::SparseTextureCommitRect(ISparseTexture*    pTexture,
+                                                       TextureRect const& Rectangle,
+                                                       DATA_FORMAT        Format,
+                                                       size_t             SizeInBytes,
+                                                       unsigned int       Alignment,
+                                                       const void*        pSysMem)
+{
+    Stats.UploadedBytes += SizeInBytes;
+
+    Record(NULL_CMD_SPARSE_COMMIT, pTexture->GetUID(), ClampToUInt32(SizeInBytes), 1);
+}
+
+void ImmediateContextNullImpl::SparseTextureUncommitPage(ISparseTexture* pTexture, int MipLevel, int PageX, int PageY, int PageZ)
+{
+    Record(NULL_CMD_SPARSE_COMMIT, pTexture->GetUID(), 0, 0);
+}
+
+void ImmediateContextNullImpl::SparseTextureUncommitRect(ISparseTexture* pTexture, TextureRect const& Rectangle)
+{
+    Record(NULL_CMD_SPARSE_COMMIT, pTexture->GetUID(), 0, 0);
+}
+
+void ImmediateContextNullImpl::GetQueryPoolResults(IQueryPool*        QueryPool,
+                                                   uint32_t           FirstQuery,
+                                                   uint32_t           QueryCount,
+                                                   size_t             DataSize,
+                                                   void*              pSysMem,
+                                                   size_t             DstStride,
+                                                   QUERY_RESULT_FLAGS Flags)
+{
+    Core::ZeroMem(pSysMem, DataSize);
+}
+
+void ImmediateContextNullImpl::GenerateTextureMipLevels(ITexture* pTexture)
+{
+    Record(NULL_CMD_GENERATE_MIPS, pTexture->GetUID());
+}
+
+bool ImmediateContextNullImpl::CopyFramebufferToTexture(FGRenderPassContext& RenderPassContext,
+                                                        ITexture*            pDstTexture,
+                                                        int                  ColorAttachment,
+                                                        TextureOffset const& Offset,
+                                                        Rect2D const&        SrcRect,
+                                                        unsigned int         Alignment)
+{
+    Record(NULL_CMD_COPY, pDstTexture->GetUID(), 0, 0, ColorAttachment);
+    return true;
+}
+
+void ImmediateContextNullImpl::CopyColorAttachmentToBuffer(FGRenderPassContext& RenderPassContext,
+                                                           IBuffer*             pDstBuffer,
+                                                           int                  SubpassAttachmentRef,
+                                                           Rect2D const&        SrcRect,
+                                                           FRAMEBUFFER_CHANNEL  FramebufferChannel,
+                                                           FRAMEBUFFER_OUTPUT   FramebufferOutput,
+                                                           COLOR_CLAMP          ColorClamp,
+                                                           size_t               SizeInBytes,
+                                                           size_t               DstByteOffset,
+                                                           unsigned int         Alignment)
+{
+    HK_ASSERT(DstByteOffset + SizeInBytes <= pDstBuffer->GetDesc().SizeInBytes);
+
+    Core::ZeroMem(static_cast<BufferNullImpl*>(pDstBuffer)->GetStorage() + DstByteOffset, SizeInBytes);
+
+    Record(NULL_CMD_COPY, pDstBuffer->GetUID(), 0, ClampToUInt32(SizeInBytes), SubpassAttachmentRef);
+}
+
+void ImmediateContextNullImpl::CopyDepthAttachmentToBuffer(FGRenderPassContext& RenderPassContext,
+                                                           IBuffer*             pDstBuffer,
+                                                           Rect2D const&        SrcRect,
+                                                           size_t               SizeInBytes,
+                                                           size_t               DstByteOffset,
+                                                           unsigned int         Alignment)
+{
+    HK_ASSERT(DstByteOffset + SizeInBytes <= pDstBuffer->GetDesc().SizeInBytes);
+
+    Core::ZeroMem(static_cast<BufferNullImpl*>(pDstBuffer)->GetStorage() + DstByteOffset, SizeInBytes);
+
+    Record(NULL_CMD_COPY, pDstBuffer->GetUID(), 0, ClampToUInt32(SizeInBytes));
+}
+
+bool ImmediateContextNullImpl::BlitFramebuffer(FGRenderPassContext&  RenderPassContext,
+                                               int                   ColorAttachment,
+                                               uint32_t              NumRectangles,
+                                               BlitRectangle const*  Rectangles,
+                                               FRAMEBUFFER_BLIT_MASK Mask,
+                                               bool                  LinearFilter)
+{
+    Record(NULL_CMD_COPY, 0, NumRectangles, Mask, ColorAttachment);
+    return true;
+}
+
+void ImmediateContextNullImpl::ClearAttachments(FGRenderPassContext&          RenderPassContext,
+                                                unsigned int*                 ColorAttachments,
+                                                unsigned int                  NumColorAttachments,
+                                                ClearColorValue const*        ColorClearValues,
+                                                ClearDepthStencilValue const* DepthStencilClearValue,
+                                                Rect2D const*                 Rect)
+{
+    Record(NULL_CMD_CLEAR, 0, NumColorAttachments, DepthStencilClearValue != nullptr);
+}
+
+bool ImmediateContextNullImpl::ReadFramebufferAttachment(FGRenderPassContext& RenderPassContext,
+                                                         int                  ColorAttachment,
+                                                         Rect2D const&        SrcRect,
+                                                         FRAMEBUFFER_CHANNEL  FramebufferChannel,
+                                                         FRAMEBUFFER_OUTPUT   FramebufferOutput,
+                                                         COLOR_CLAMP          ColorClamp,
+                                                         size_t               SizeInBytes,
+                                                         unsigned int         Alignment,
+                                                         void*                pSysMem)
+{
+    Core::ZeroMem(pSysMem, SizeInBytes);
+
+    Stats.ReadbackBytes += SizeInBytes;
+
+    Record(NULL_CMD_READBACK, 0, ClampToUInt32(SizeInBytes), 0, ColorAttachment);
+    return true;
+}
+
+bool ImmediateContextNullImpl::ReadFramebufferDepthStencilAttachment(FGRenderPassContext& RenderPassContext,
+                                                                     Rect2D const&        SrcRect,
+                                                                     size_t               SizeInBytes,
+                                                                     unsigned int         Alignment,
+                                                                     void*                pSysMem)
+{
+    Core::ZeroMem(pSysMem, SizeInBytes);
+
+    Stats.ReadbackBytes += SizeInBytes;
+
+    Record(NULL_CMD_READBACK, 0, ClampToUInt32(SizeInBytes));
+    return true;
+}
+
+} // namespace RHI
+
+HK_NAMESPACE_END
@@ -0,0 +1,96 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/RHI/Common/Pipeline.h>
+#include <Hork/RHI/Common/ShaderModule.h>
+#include <Hork/RHI/Common/TransformFeedback.h>
+#include <Hork/RHI/Common/Query.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+class PipelineNullImpl final : public IPipeline
+{
+public:
+    PipelineNullImpl(IDevice* pDevice, PipelineDesc const& Desc) :
+        IPipeline(pDevice), Topology(Desc.IA.Topology), bCompute(Desc.pCS != nullptr)
+    {
+        SetHandle(this);
+    }
+
+    PRIMITIVE_TOPOLOGY GetTopology() const { return Topology; }
+
+    bool IsCompute() const { return bCompute; }
+
+private:
+    PRIMITIVE_TOPOLOGY Topology;
+    bool               bCompute;
+};
+
+class ShaderModuleNullImpl final : public IShaderModule
+{
+public:
+    ShaderModuleNullImpl(IDevice* pDevice, SHADER_TYPE ShaderType) :
+        IShaderModule(pDevice)
+    {
+        Type = ShaderType;
+        SetHandle(this);
+    }
+};
+
+class TransformFeedbackNullImpl final : public ITransformFeedback
+{
+public:
+    TransformFeedbackNullImpl(IDevice* pDevice) :
+        ITransformFeedback(pDevice)
+    {
+        SetHandle(this);
+    }
+};
+
+class QueryPoolNullImpl final : public IQueryPool
+{
+public:
+    QueryPoolNullImpl(IDevice* pDevice, QueryPoolDesc const& Desc) :
+        IQueryPool(pDevice)
+    {
+        QueryType = Desc.QueryType;
+        PoolSize  = Desc.PoolSize;
+        SetHandle(this);
+    }
+};
+
+} // namespace RHI
+
+HK_NAMESPACE_END
@@ -0,0 +1,116 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "SwapChainNullImpl.h"
+#include "DeviceNullImpl.h"
+#include "ImmediateContextNullImpl.h"
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+GenericWindowNullImpl::GenericWindowNullImpl(DeviceNullImpl* pDevice, WindowSettings const& windowSettings) :
+    IGenericWindow(pDevice)
+{
+    m_Width             = Math::Max(1, windowSettings.Width);
+    m_Height            = Math::Max(1, windowSettings.Height);
+    m_FramebufferWidth  = m_Width;
+    m_FramebufferHeight = m_Height;
+    m_WindowedX         = windowSettings.WindowedX;
+    m_WindowedY         = windowSettings.WindowedY;
+    m_X                 = m_WindowedX;
+    m_Y                 = m_WindowedY;
+    m_WindowMode        = windowSettings.Mode;
+    m_FullscreenMode    = windowSettings.Mode != WindowMode::Windowed;
+
+    if (windowSettings.RefreshRate > 0)
+        m_RefreshRate = windowSettings.RefreshRate;
+}
+
+SwapChainNullImpl::SwapChainNullImpl(DeviceNullImpl* pDevice, GenericWindowNullImpl* pWindow) :
+    ISwapChain(pDevice), pWindow(pWindow)
+{
+    Width  = pWindow->GetFramebufferWidth();
+    Height = pWindow->GetFramebufferHeight();
+
+    CreateBuffers();
+
+    pWindow->SetSwapChain(this);
+
+    SetHandle(this);
+}
+
+void SwapChainNullImpl::CreateBuffers()
+{
+    TextureDesc textureDesc;
+    textureDesc.SetResolution(TextureResolution2D(Width, Height));
+    textureDesc.SetBindFlags(BIND_RENDER_TARGET);
+    textureDesc.SetFormat(TEXTURE_FORMAT_RGBA8_UNORM);
+
+    BackBuffer = MakeRef<TextureNullImpl>(static_cast<DeviceNullImpl*>(GetDevice()), textureDesc);
+
+    textureDesc.SetBindFlags(BIND_DEPTH_STENCIL);
+    textureDesc.SetFormat(TEXTURE_FORMAT_D32);
+
+    DepthBuffer = MakeRef<TextureNullImpl>(static_cast<DeviceNullImpl*>(GetDevice()), textureDesc);
+}
+
+void SwapChainNullImpl::Present(int SwapInterval)
+{
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordPresent(this);
+}
+
+void SwapChainNullImpl::Resize(int InWidth, int InHeight)
+{
+    if (Width == InWidth && Height == InHeight)
+    {
+        return;
+    }
+
+    Width  = InWidth;
+    Height = InHeight;
+
+    CreateBuffers();
+}
+
+ITexture* SwapChainNullImpl::GetBackBuffer()
+{
+    return BackBuffer;
+}
+
+ITexture* SwapChainNullImpl::GetDepthBuffer()
+{
+    return DepthBuffer;
+}
+
+} // namespace RHI
+
+HK_NAMESPACE_END
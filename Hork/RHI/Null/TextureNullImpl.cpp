@@ -0,0 +1,265 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "TextureNullImpl.h"
+#include "DeviceNullImpl.h"
+#include "ImmediateContextNullImpl.h"
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+
+namespace
+{
+
+TextureResolution GetMipResolution(TextureDesc const& Desc, uint16_t MipLevel)
+{
+    TextureResolution resolution;
+    resolution.Width = Math::Max(1u, Desc.Resolution.Width >> MipLevel);
+
+    switch (Desc.Type)
+    {
+        case TEXTURE_1D:
+        case TEXTURE_1D_ARRAY:
+            resolution.Height = 1;
+            break;
+        case TEXTURE_CUBE:
+        case TEXTURE_CUBE_ARRAY:
+            resolution.Height = resolution.Width;
+            break;
+        default:
+            resolution.Height = Math::Max(1u, Desc.Resolution.Height >> MipLevel);
+            break;
+    }
+
+    switch (Desc.Type)
+    {
+        case TEXTURE_1D:
+        case TEXTURE_2D:
+            resolution.SliceCount = 1;
+            break;
+        case TEXTURE_3D:
+            resolution.SliceCount = Math::Max(1u, Desc.Resolution.SliceCount >> MipLevel);
+            break;
+        case TEXTURE_CUBE:
+            resolution.SliceCount = 6;
+            break;
+        default:
+            resolution.SliceCount = Desc.Resolution.SliceCount;
+            break;
+    }
+
+    return resolution;
+}
+
+size_t CalcImageSize(TEXTURE_FORMAT Format, TextureResolution const& Resolution)
+{
+    TextureFormatInfo const& info = GetTextureFormatInfo(Format);
+
+    size_t blocksX = (Resolution.Width + info.BlockSize - 1) / info.BlockSize;
+    size_t blocksY = (Resolution.Height + info.BlockSize - 1) / info.BlockSize;
+
+    return blocksX * blocksY * Resolution.SliceCount * info.BytesPerBlock;
+}
+
+} // namespace
+
+TextureViewNullImpl::TextureViewNullImpl(TextureViewDesc const& TextureViewDesc, ITexture* pTexture) :
+    ITextureView(TextureViewDesc, pTexture)
+{
+    SetHandle(this);
+}
+
+TextureNullImpl::TextureNullImpl(DeviceNullImpl* pDevice, TextureDesc const& TextureDesc) :
+    ITexture(pDevice, TextureDesc)
+{
+    bCompressed = IsCompressedFormat(TextureDesc.Format);
+
+    for (uint16_t mip = 0; mip < TextureDesc.NumMipLevels; ++mip)
+        SizeInBytes += CalcImageSize(TextureDesc.Format, GetMipResolution(TextureDesc, mip));
+    SizeInBytes *= TextureDesc.Multisample.NumSamples;
+
+    pDevice->TextureMemoryAllocated += SizeInBytes;
+
+    SetHandle(this);
+
+    CreateDefaultViews();
+}
+
+TextureNullImpl::~TextureNullImpl()
+{
+    // It is important to destroy views before a texture
+    Views.Clear();
+
+    static_cast<DeviceNullImpl*>(GetDevice())->TextureMemoryAllocated -= SizeInBytes;
+}
+
+void TextureNullImpl::CreateDefaultViews()
+{
+    TextureViewDesc viewDesc;
+    viewDesc.Type          = GetDesc().Type;
+    viewDesc.Format        = GetDesc().Format;
+    viewDesc.FirstMipLevel = 0;
+    viewDesc.FirstSlice    = 0;
+    viewDesc.NumSlices     = GetSliceCount();
+
+    if (IsDepthStencilFormat(GetDesc().Format))
+    {
+        if (GetDesc().BindFlags & BIND_DEPTH_STENCIL)
+        {
+            viewDesc.ViewType     = TEXTURE_VIEW_DEPTH_STENCIL;
+            viewDesc.NumMipLevels = 1;
+            pDepthStencilView     = GetTextureView(viewDesc);
+        }
+    }
+    else
+    {
+        if (GetDesc().BindFlags & BIND_RENDER_TARGET)
+        {
+            viewDesc.ViewType     = TEXTURE_VIEW_RENDER_TARGET;
+            viewDesc.NumMipLevels = 1;
+            pRenderTargetView     = GetTextureView(viewDesc);
+        }
+    }
+
+    if (GetDesc().BindFlags & BIND_SHADER_RESOURCE)
+    {
+        viewDesc.ViewType     = TEXTURE_VIEW_SHADER_RESOURCE;
+        viewDesc.NumMipLevels = Desc.NumMipLevels;
+        pShaderResourceView   = GetTextureView(viewDesc);
+    }
+
+    if (GetDesc().BindFlags & BIND_UNORDERED_ACCESS)
+    {
+        viewDesc.ViewType     = TEXTURE_VIEW_UNORDERED_ACCESS;
+        viewDesc.NumMipLevels = Desc.NumMipLevels;
+        pUnorderedAccesView   = GetTextureView(viewDesc);
+    }
+}
+
+ITextureView* TextureNullImpl::GetTextureView(TextureViewDesc const& TextureViewDesc)
+{
+    auto it = Views.Find(TextureViewDesc);
+    if (it == Views.End())
+    {
+        Ref<TextureViewNullImpl> textureView = MakeRef<TextureViewNullImpl>(TextureViewDesc, this);
+        Views[TextureViewDesc] = textureView;
+        return textureView;
+    }
+    return it->second;
+}
+
+void TextureNullImpl::MakeBindlessSamplerResident(BindlessHandle Handle, bool bResident)
+{
+}
+
+bool TextureNullImpl::IsBindlessSamplerResident(BindlessHandle Handle)
+{
+    return false;
+}
+
+BindlessHandle TextureNullImpl::GetBindlessSampler(SamplerDesc const& SamplerDesc)
+{
+    LOG("TextureNullImpl::GetBindlessSampler: FEATURE_BINDLESS_TEXTURE is not supported\n");
+    return 0;
+}
+
+void TextureNullImpl::GetMipLevelInfo(uint16_t MipLevel, TextureMipLevelInfo* pInfo) const
+{
+    *pInfo = TextureMipLevelInfo{};
+
+    pInfo->Resoultion  = GetMipResolution(Desc, MipLevel);
+    pInfo->bCompressed = bCompressed;
+
+    if (bCompressed)
+        pInfo->CompressedDataSizeInBytes = CalcImageSize(Desc.Format, pInfo->Resoultion);
+}
+
+void TextureNullImpl::Invalidate(uint16_t MipLevel)
+{
+}
+
+void TextureNullImpl::InvalidateRect(uint32_t NumRectangles, TextureRect const* Rectangles)
+{
+}
+
+void TextureNullImpl::Read(uint16_t MipLevel, size_t SizeInBytes, unsigned int Alignment, void* pSysMem)
+{
+    Core::ZeroMem(pSysMem, SizeInBytes);
+
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordReadback(this, SizeInBytes);
+}
+
+void TextureNullImpl::ReadRect(TextureRect const& Rectangle, size_t SizeInBytes, unsigned int Alignment, void* pSysMem)
+{
+    Core::ZeroMem(pSysMem, SizeInBytes);
+
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordReadback(this, SizeInBytes);
+}
+
+bool TextureNullImpl::Write(uint16_t MipLevel, size_t SizeInBytes, unsigned int Alignment, const void* pSysMem)
+{
+    if (MipLevel >= Desc.NumMipLevels)
+    {
+        LOG("TextureNullImpl::Write: invalid mip level\n");
+        return false;
+    }
+
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordUpload(this, SizeInBytes);
+    return true;
+}
+
+bool TextureNullImpl::WriteRect(TextureRect const& Rectangle, size_t SizeInBytes, unsigned int Alignment, const void* pSysMem, size_t RowPitch, size_t DepthPitch)
+{
+    if (Rectangle.Offset.MipLevel >= Desc.NumMipLevels)
+    {
+        LOG("TextureNullImpl::WriteRect: invalid mip level\n");
+        return false;
+    }
+
+    static_cast<DeviceNullImpl*>(GetDevice())->GetContextNull()->RecordUpload(this, SizeInBytes);
+    return true;
+}
+
+SparseTextureNullImpl::SparseTextureNullImpl(DeviceNullImpl* pDevice, SparseTextureDesc const& Desc) :
+    ISparseTexture(pDevice, Desc)
+{
+    bCompressed = IsCompressedFormat(Desc.Format);
+
+    int pageSizeIndex;
+    pDevice->ChooseAppropriateSparseTexturePageSize(Desc.Type, Desc.Format, Desc.Resolution.Width, Desc.Resolution.Height, Desc.Resolution.SliceCount, &pageSizeIndex, &PageSizeX, &PageSizeY, &PageSizeZ);
+
+    SetHandle(this);
+}
+
+} // namespace RHI
+
+HK_NAMESPACE_END
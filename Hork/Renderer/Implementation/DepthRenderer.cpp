@@ -136,6 +136,12 @@ void AddDepthPass( FrameGraph & FrameGraph, FGTextureProxy ** ppDepthTexture, FG
             for ( int i = 0 ; i < GRenderView->InstanceCount ; i++ ) {
                 RenderInstance const * instance = GFrameData->Instances[GRenderView->FirstInstance + i];
 
+                // Drawn by a preceding batch
+                if (instance->BatchInstanceCount == 0)
+                {
+                    continue;
+                }
+
                 if (!BindMaterialDepthPass(immediateCtx, instance))
                 {
                     continue;
@@ -144,8 +150,13 @@ void AddDepthPass( FrameGraph & FrameGraph, FGTextureProxy ** ppDepthTexture, FG
                 BindTextures( instance->MaterialInstance, instance->Material->DepthPassTextureCount );
                 BindSkeleton( instance->SkeletonOffset, instance->SkeletonSize );
                 BindSkeletonMotionBlur( instance->SkeletonOffsetMB, instance->SkeletonSize );
-                BindInstanceConstants( instance );
+                if ( instance->BatchInstanceCount > 1 ) {
+                    BindInstanceBatch( instance );
+                } else {
+                    BindInstanceConstants( instance );
+                }
 
+                drawCmd.InstanceCount = instance->BatchInstanceCount;
                 drawCmd.IndexCountPerInstance = instance->IndexCount;
                 drawCmd.StartIndexLocation = instance->StartIndexLocation;
                 drawCmd.BaseVertexLocation = instance->BaseVertexLocation;
@@ -191,6 +202,12 @@ void AddDepthPass( FrameGraph & FrameGraph, FGTextureProxy ** ppDepthTexture, FG
             for ( int i = 0 ; i < GRenderView->InstanceCount ; i++ ) {
                 RenderInstance const * instance = GFrameData->Instances[GRenderView->FirstInstance + i];
 
+                // Drawn by a preceding batch
+                if (instance->BatchInstanceCount == 0)
+                {
+                    continue;
+                }
+
                 if (!BindMaterialDepthPass(immediateCtx, instance))
                 {
                     continue;
@@ -198,8 +215,13 @@ void AddDepthPass( FrameGraph & FrameGraph, FGTextureProxy ** ppDepthTexture, FG
 
                 BindTextures( instance->MaterialInstance, instance->Material->DepthPassTextureCount );
                 BindSkeleton( instance->SkeletonOffset, instance->SkeletonSize );
-                BindInstanceConstants( instance );
+                if ( instance->BatchInstanceCount > 1 ) {
+                    BindInstanceBatch( instance );
+                } else {
+                    BindInstanceConstants( instance );
+                }
 
+                drawCmd.InstanceCount = instance->BatchInstanceCount;
                 drawCmd.IndexCountPerInstance = instance->IndexCount;
                 drawCmd.StartIndexLocation = instance->StartIndexLocation;
                 drawCmd.BaseVertexLocation = instance->BaseVertexLocation;
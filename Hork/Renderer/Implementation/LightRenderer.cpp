@@ -416,6 +416,12 @@ void LightRenderer::AddPass(FrameGraph&     FrameGraph,
                               {
                                   RenderInstance const* instance = GFrameData->Instances[GRenderView->FirstInstance + i];
 
+                                  // Drawn by a preceding batch
+                                  if (instance->BatchInstanceCount == 0)
+                                  {
+                                      continue;
+                                  }
+
                                   if (!BindMaterialLightPass(immediateCtx, instance))
                                   {
                                       continue;
@@ -423,8 +429,12 @@ void LightRenderer::AddPass(FrameGraph&     FrameGraph,
 
                                   BindTextures(instance->MaterialInstance, instance->Material->LightPassTextureCount);
                                   BindSkeleton(instance->SkeletonOffset, instance->SkeletonSize);
-                                  BindInstanceConstants(instance);
+                                  if (instance->BatchInstanceCount > 1)
+                                      BindInstanceBatch(instance);
+                                  else
+                                      BindInstanceConstants(instance);
 
+                                  drawCmd.InstanceCount         = instance->BatchInstanceCount;
                                   drawCmd.IndexCountPerInstance = instance->IndexCount;
                                   drawCmd.StartIndexLocation    = instance->StartIndexLocation;
                                   drawCmd.BaseVertexLocation    = instance->BaseVertexLocation;
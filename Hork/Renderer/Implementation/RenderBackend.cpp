@@ -66,7 +66,7 @@ ConsoleVar r_ShowGPUTime("r_ShowGPUTime"_s, "0"_s);
 
 void TestVT();
 
-RenderBackend::RenderBackend(RHI::IDevice* device)
+RenderBackend::RenderBackend(RHI::IDevice* device, AsyncJobList* jobList)
 {
     LOG("Initializing render backend...\n");
 
@@ -123,7 +123,7 @@ RenderBackend::RenderBackend(RHI::IDevice* device)
     GClusterLookup->SetDebugName("Cluster Lookup");
 
 
-    m_FeedbackAnalyzerVT = MakeRef<VirtualTextureFeedbackAnalyzer>(GDevice);
+    m_FeedbackAnalyzerVT = MakeRef<VirtualTextureFeedbackAnalyzer>(GDevice, jobList);
     GFeedbackAnalyzerVT = m_FeedbackAnalyzerVT;
 
     {
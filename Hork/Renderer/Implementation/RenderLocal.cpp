@@ -173,9 +173,32 @@ void BindInstanceConstants(RenderInstance const* Instance)
     pConstantBuf->VTScale  = Float2(1.0f); //Instance->VTScale;
     pConstantBuf->VTUnit   = 0;            //Instance->VTUnit;
 
+    pConstantBuf->InstancedDraw = 0;
+
     rtbl->BindBuffer(1, GCircularBuffer->GetBuffer(), offset, sizeof(InstanceConstantBuffer));
 }
 
+void BindInstanceBatch(RenderInstance const* Instance)
+{
+    size_t offset = GCircularBuffer->Allocate(sizeof(InstanceConstantBuffer));
+
+    InstanceConstantBuffer* pConstantBuf = reinterpret_cast<InstanceConstantBuffer*>(GCircularBuffer->GetMappedMemory() + offset);
+
+    // Transforms are fetched from the instance buffer
+    Core::Memcpy(&pConstantBuf->LightmapOffset, &Instance->LightmapOffset, sizeof(pConstantBuf->LightmapOffset));
+    Core::Memcpy(&pConstantBuf->uaddr_0, Instance->MaterialInstance->UniformVectors, sizeof(Float4) * Instance->MaterialInstance->NumUniformVectors);
+
+    // TODO:
+    pConstantBuf->VTOffset = Float2(0.0f); //Instance->VTOffset;
+    pConstantBuf->VTScale  = Float2(1.0f); //Instance->VTScale;
+    pConstantBuf->VTUnit   = 0;            //Instance->VTUnit;
+
+    pConstantBuf->InstancedDraw = 1;
+
+    rtbl->BindBuffer(1, GCircularBuffer->GetBuffer(), offset, sizeof(InstanceConstantBuffer));
+    rtbl->BindBuffer(INSTANCE_TRANSFORM_BUFFER_SLOT, GStreamBuffer, Instance->BatchStreamHandle, sizeof(InstanceTransform) * Instance->BatchInstanceCount);
+}
+
 void BindInstanceConstantsFB(RenderInstance const* Instance)
 {
     size_t offset = GCircularBuffer->Allocate(sizeof(FeedbackConstantBuffer));
@@ -206,6 +229,7 @@ void BindShadowInstanceConstants(ShadowRenderInstance const* Instance)
     }
 
     pConstantBuf->CascadeMask = Instance->CascadeMask;
+    pConstantBuf->InstancedDraw = 0;
 
     rtbl->BindBuffer(1, GCircularBuffer->GetBuffer(), offset, sizeof(ShadowInstanceConstantBuffer));
 }
@@ -230,8 +254,27 @@ void BindShadowInstanceConstants(ShadowRenderInstance const* Instance, int FaceI
     }
 
     pConstantBuf->CascadeMask = Instance->CascadeMask;
+    pConstantBuf->InstancedDraw = 0;
+
+    rtbl->BindBuffer(1, GCircularBuffer->GetBuffer(), offset, sizeof(ShadowInstanceConstantBuffer));
+}
+
+void BindShadowInstanceBatch(ShadowRenderInstance const* Instance)
+{
+    size_t offset = GCircularBuffer->Allocate(sizeof(ShadowInstanceConstantBuffer));
+
+    ShadowInstanceConstantBuffer* pConstantBuf = reinterpret_cast<ShadowInstanceConstantBuffer*>(GCircularBuffer->GetMappedMemory() + offset);
+
+    if (Instance->MaterialInstance)
+    {
+        Core::Memcpy(&pConstantBuf->uaddr_0, Instance->MaterialInstance->UniformVectors, sizeof(Float4) * Instance->MaterialInstance->NumUniformVectors);
+    }
+
+    pConstantBuf->CascadeMask = Instance->CascadeMask;
+    pConstantBuf->InstancedDraw = 1;
 
     rtbl->BindBuffer(1, GCircularBuffer->GetBuffer(), offset, sizeof(ShadowInstanceConstantBuffer));
+    rtbl->BindBuffer(INSTANCE_TRANSFORM_BUFFER_SLOT, GStreamBuffer, Instance->BatchStreamHandle, sizeof(Float4x4) * Instance->BatchInstanceCount);
 }
 
 void* MapDrawCallConstants(size_t SizeInBytes)
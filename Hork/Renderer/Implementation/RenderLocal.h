@@ -134,7 +134,7 @@ struct InstanceConstantBuffer
     Float2   VTOffset;
     Float2   VTScale;
     uint32_t VTUnit;
-    uint32_t Pad0;
+    uint32_t InstancedDraw; // Read transforms from INSTANCE_TRANSFORM_BUFFER_SLOT
     uint32_t Pad1;
     uint32_t Pad2;
 };
@@ -159,7 +159,8 @@ struct ShadowInstanceConstantBuffer
     Float4   uaddr_2;
     Float4   uaddr_3;
     uint32_t CascadeMask;
-    uint32_t Pad[3];
+    uint32_t InstancedDraw; // Read transforms from INSTANCE_TRANSFORM_BUFFER_SLOT
+    uint32_t Pad[2];
 };
 
 struct TerrainInstanceConstantBuffer
@@ -264,11 +265,17 @@ void BindTextures(MaterialFrameData* Instance, int MaxTextures);
 
 void BindInstanceConstants(RenderInstance const* Instance);
 
+/// Bind constants and per-instance transforms of a batched draw call
+void BindInstanceBatch(RenderInstance const* Instance);
+
 void BindInstanceConstantsFB(RenderInstance const* Instance);
 
 void BindShadowInstanceConstants(ShadowRenderInstance const* Instance);
 void BindShadowInstanceConstants(ShadowRenderInstance const* Instance, int FaceIndex, Float3 const& LightPosition);
 
+/// Bind constants and per-instance transforms of a batched shadow caster draw call
+void BindShadowInstanceBatch(ShadowRenderInstance const* Instance);
+
 void* MapDrawCallConstants(size_t SizeInBytes);
 
 template <typename T>
@@ -389,14 +389,24 @@ void ShadowMapRenderer::AddPass(FrameGraph& FrameGraph, DirectionalLightInstance
                         {
                             ShadowRenderInstance const* instance = GFrameData->ShadowInstances[shadowMap->FirstShadowInstance + i];
 
+                            // Drawn by a preceding batch
+                            if (instance->BatchInstanceCount == 0)
+                            {
+                                continue;
+                            }
+
                             if (!BindMaterialShadowMap(immediateCtx, instance))
                             {
                                 continue;
                             }
 
                             BindSkeleton(instance->SkeletonOffset, instance->SkeletonSize);
-                            BindShadowInstanceConstants(instance);
+                            if (instance->BatchInstanceCount > 1)
+                                BindShadowInstanceBatch(instance);
+                            else
+                                BindShadowInstanceConstants(instance);
 
+                            drawCmd.InstanceCount         = instance->BatchInstanceCount;
                             drawCmd.IndexCountPerInstance = instance->IndexCount;
                             drawCmd.StartIndexLocation    = instance->StartIndexLocation;
                             drawCmd.BaseVertexLocation    = instance->BaseVertexLocation;
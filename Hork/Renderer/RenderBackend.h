@@ -41,11 +41,14 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+class AsyncJobList;
+
 // NOTE: The rendering backend should be used as a singleton object. (This should be fixed later)
 class RenderBackend final : public Noncopyable
 {
 public:
-                                RenderBackend(RHI::IDevice* device);
+    /// Virtual texture feedback is decoded by the jobs of the list if specified
+                                RenderBackend(RHI::IDevice* device, AsyncJobList* jobList = nullptr);
                                 ~RenderBackend();
 
     void                        RenderFrame(StreamedMemoryGPU* streamedMemory, RHI::ITexture* backBuffer, RenderFrameData const* frameData, CanvasDrawData const* canvasData);
@@ -48,6 +48,9 @@ constexpr int MAX_MATERIAL_TEXTURES = 11; // Reserved texture slots for AOLookup
 constexpr int MAX_MATERIAL_UNIFORMS        = 16;
 constexpr int MAX_MATERIAL_UNIFORM_VECTORS = 16 >> 2;
 
+/// Shader storage buffer slot with per-instance transforms of batched draw calls
+constexpr int INSTANCE_TRANSFORM_BUFFER_SLOT = 8;
+
 /// Frustum width
 constexpr int MAX_FRUSTUM_CLUSTERS_X = 16;
 
@@ -287,6 +290,8 @@ public:
     int                         WireframePassTextureCount{};
     int                         NormalsPassTextureCount{};
     int                         ShadowMapPassTextureCount{};
+    /// Depth, light and shadowmap passes read instance transforms from INSTANCE_TRANSFORM_BUFFER_SLOT
+    bool                        SupportsInstancing{};
     Ref<RHI::IPipeline>         Passes[MaterialPass::MAX];
 };
 
@@ -552,6 +557,11 @@ struct RenderInstance
 
     bool                bPerObjectMotionBlur;
 
+    /// Number of instances drawn with this instance. Zero if the instance is drawn by a preceding batch.
+    uint32_t            BatchInstanceCount;
+    /// Per-instance transforms of the batch (InstanceTransform array)
+    size_t              BatchStreamHandle;
+
     uint64_t            SortKey;
 
     uint8_t             GetRenderingPriority() const { return (SortKey >> 56) & 0xf0; }
@@ -560,12 +570,22 @@ struct RenderInstance
 
     void                GenerateSortKey(uint8_t Priority, uint64_t Mesh)
     {
-        // NOTE: 8 bits are still unused. We can use it in future.
-        SortKey = ((uint64_t)(Priority) << 56u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)Material) & 0xffffu) << 40u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)MaterialInstance) & 0xffffu) << 24u) | ((uint64_t)(HashTraits::Murmur3Hash64(Mesh) & 0xffffu) << 8u);
+        // NOTE: Lower 8 bits keep instances of the same surface together, so they can be batched
+        uint64_t surface = ((uint64_t)(uint32_t)BaseVertexLocation << 32u) | StartIndexLocation;
+        SortKey = ((uint64_t)(Priority) << 56u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)Material) & 0xffffu) << 40u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)MaterialInstance) & 0xffffu) << 24u) | ((uint64_t)(HashTraits::Murmur3Hash64(Mesh) & 0xffffu) << 8u) | (HashTraits::Murmur3Hash64(surface) & 0xffu);
     }
 };
 
 
+/** Per-instance data of batched draw calls. Matches InstanceTransform in instance_uniforms.glsl */
+struct InstanceTransform
+{
+    Float4x4            TransformMatrix;
+    Float4x4            TransformMatrixP;
+    Float3x4            ModelNormalToViewSpace;
+};
+
+
 /**
 
 Shadowmap render instance
@@ -588,12 +608,15 @@ struct ShadowRenderInstance
     unsigned int        StartIndexLocation;
     int                 BaseVertexLocation;
     uint16_t            CascadeMask; // Cascade mask for directional lights or face index for point/spot lights
+    uint32_t            BatchInstanceCount; // Zero if the instance is drawn by a preceding batch
+    size_t              BatchStreamHandle; // Per-instance transforms of the batch (Float4x4 array)
     uint64_t            SortKey;
 
     void                GenerateSortKey(uint8_t Priority, uint64_t Mesh)
     {
-        // NOTE: 8 bits are still unused. We can use it in future.
-        SortKey = ((uint64_t)(Priority) << 56u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)Material) & 0xffffu) << 40u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)MaterialInstance) & 0xffffu) << 24u) | ((uint64_t)(HashTraits::Murmur3Hash64(Mesh) & 0xffffu) << 8u);
+        // NOTE: Lower 8 bits keep instances of the same surface together, so they can be batched
+        uint64_t surface = ((uint64_t)(uint32_t)BaseVertexLocation << 32u) | StartIndexLocation;
+        SortKey = ((uint64_t)(Priority) << 56u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)Material) & 0xffffu) << 40u) | ((uint64_t)(HashTraits::Murmur3Hash64((uint64_t)MaterialInstance) & 0xffffu) << 24u) | ((uint64_t)(HashTraits::Murmur3Hash64(Mesh) & 0xffffu) << 8u) | (HashTraits::Murmur3Hash64(surface) & 0xffu);
     }
 };
 
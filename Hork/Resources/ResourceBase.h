@@ -43,7 +43,7 @@ enum RESOURCE_TYPE : uint8_t
     RESOURCE_NODE_MOTION,     // todo
     RESOURCE_TEXTURE,//ok
     RESOURCE_MATERIAL,//ok
-    RESOURCE_COLLISION,// todo
+    RESOURCE_COLLISION,//ok
     RESOURCE_SOUND,//ok
     RESOURCE_TERRAIN,// ok
     RESOURCE_VIRTUAL_TEXTURE,// todo
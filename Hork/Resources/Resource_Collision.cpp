@@ -0,0 +1,347 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Resource_Collision.h"
+#include "Resource_Mesh.h"
+
+#include <Hork/Core/Logger.h>
+#include <Hork/Geometry/ConvexDecomposition.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/StreamIn.h>
+#include <Jolt/Core/StreamOut.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+    class JoltStreamIn final : public JPH::StreamIn
+    {
+    public:
+        explicit JoltStreamIn(IBinaryStreamReadInterface& stream) :
+            m_Stream(stream)
+        {}
+
+        void ReadBytes(void* outData, size_t inNumBytes) override
+        {
+            if (m_Stream.Read(outData, inNumBytes) != inNumBytes)
+                m_Failed = true;
+        }
+
+        bool IsEOF() const override
+        {
+            return m_Stream.IsEOF();
+        }
+
+        bool IsFailed() const override
+        {
+            return m_Failed;
+        }
+
+    private:
+        IBinaryStreamReadInterface& m_Stream;
+        bool m_Failed = false;
+    };
+
+    class JoltStreamOut final : public JPH::StreamOut
+    {
+    public:
+        explicit JoltStreamOut(IBinaryStreamWriteInterface& stream) :
+            m_Stream(stream)
+        {}
+
+        void WriteBytes(const void* inData, size_t inNumBytes) override
+        {
+            if (m_Stream.Write(inData, inNumBytes) != inNumBytes)
+                m_Failed = true;
+        }
+
+        bool IsFailed() const override
+        {
+            return m_Failed;
+        }
+
+    private:
+        IBinaryStreamWriteInterface& m_Stream;
+        bool m_Failed = false;
+    };
+}
+
+CollisionResource::~CollisionResource()
+{
+    Clear();
+}
+
+void CollisionResource::Clear()
+{
+    for (JPH::Shape* shape : m_Shapes)
+        shape->Release();
+
+    m_Shapes.Clear();
+    m_Parts.Clear();
+}
+
+UniqueRef<CollisionResource> CollisionResource::sLoad(IBinaryStreamReadInterface& stream)
+{
+    UniqueRef<CollisionResource> resource = MakeUnique<CollisionResource>();
+    if (!resource->Read(stream))
+        return {};
+    return resource;
+}
+
+bool CollisionResource::Read(IBinaryStreamReadInterface& stream)
+{
+    Clear();
+
+    uint32_t fileMagic = stream.ReadUInt32();
+
+    if (fileMagic != MakeResourceMagic(Type, Version))
+    {
+        LOG("Unexpected file format\n");
+        return false;
+    }
+
+    uint32_t partCount = stream.ReadUInt32();
+
+    JoltStreamIn joltStream(stream);
+    JPH::Shape::IDToShapeMap shapeMap;
+    JPH::Shape::IDToMaterialMap materialMap;
+
+    for (uint32_t i = 0; i < partCount; ++i)
+    {
+        Part part;
+        stream.ReadObject(part.OffsetPosition);
+        stream.ReadObject(part.OffsetRotation);
+        part.IsConvex = stream.ReadBool();
+
+        // Parts may share sub shapes, so the maps are kept for the whole resource
+        JPH::Shape::ShapeResult result = JPH::Shape::sRestoreWithChildren(joltStream, shapeMap, materialMap);
+        if (result.HasError() || joltStream.IsFailed())
+        {
+            LOG("CollisionResource::Read: Failed to restore shape: {}\n", result.HasError() ? result.GetError().c_str() : "unexpected end of file");
+            Clear();
+            return false;
+        }
+
+        AddPart(part, result.Get());
+    }
+
+    return true;
+}
+
+void CollisionResource::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteUInt32(MakeResourceMagic(Type, Version));
+    stream.WriteUInt32(m_Parts.Size());
+
+    JoltStreamOut joltStream(stream);
+    JPH::Shape::ShapeToIDMap shapeMap;
+    JPH::Shape::MaterialToIDMap materialMap;
+
+    for (int i = 0; i < m_Parts.Size(); ++i)
+    {
+        Part const& part = m_Parts[i];
+        stream.WriteObject(part.OffsetPosition);
+        stream.WriteObject(part.OffsetRotation);
+        stream.WriteBool(part.IsConvex);
+
+        m_Shapes[i]->SaveWithChildren(joltStream, shapeMap, materialMap);
+    }
+}
+
+void CollisionResource::AddPart(Part const& part, JPH::Shape* shape)
+{
+    HK_ASSERT(shape);
+
+    shape->AddRef();
+
+    m_Parts.Add(part);
+    m_Shapes.Add(shape);
+}
+
+UniqueRef<CollisionResource> CollisionResourceBuilder::Build(MeshResource const& mesh)
+{
+    // Surface indices are relative to the surface base vertex
+    Vector<unsigned int> indices(mesh.GetIndexCount());
+    for (int surfaceIndex = 0; surfaceIndex < mesh.GetSurfaceCount(); ++surfaceIndex)
+    {
+        MeshSurface const& surface = mesh.GetSurfaces()[surfaceIndex];
+        unsigned int const* surfaceIndices = mesh.GetIndices() + surface.FirstIndex;
+        for (uint32_t i = 0; i < surface.IndexCount; ++i)
+            indices[surface.FirstIndex + i] = surface.BaseVertex + surfaceIndices[i];
+    }
+
+    return Build(&mesh.GetVertices()->Position, mesh.GetVertexCount(), sizeof(MeshVertex), indices.ToPtr(), indices.Size());
+}
+
+namespace
+{
+    JPH::Shape* CreateConvexHullShape(Float3 const* vertices, int vertexCount, int vertexStride)
+    {
+        if (vertexCount < 4)
+            return nullptr;
+
+        JPH::ConvexHullShapeSettings settings;
+        settings.mMaxConvexRadius = JPH::cDefaultConvexRadius;
+        settings.mPoints.resize(vertexCount);
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            Float3 const& v = *(Float3 const*)((uint8_t const*)vertices + i * vertexStride);
+            settings.mPoints[i] = JPH::Vec3(v.X, v.Y, v.Z);
+        }
+
+        JPH::Shape::ShapeResult result = settings.Create();
+        if (result.HasError())
+        {
+            LOG("CollisionResourceBuilder: Failed to create convex hull: {}\n", result.GetError().c_str());
+            return nullptr;
+        }
+
+        // Keep the shape alive after the settings are destroyed
+        JPH::Shape* shape = result.Get();
+        shape->AddRef();
+        return shape;
+    }
+
+    JPH::Shape* CreateMeshShape(Float3 const* vertices, int vertexCount, int vertexStride, unsigned int const* indices, int indexCount)
+    {
+        int triangleCount = indexCount / 3;
+        if (triangleCount == 0)
+            return nullptr;
+
+        JPH::MeshShapeSettings settings;
+        settings.mTriangleVertices.resize(vertexCount);
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            Float3 const& v = *(Float3 const*)((uint8_t const*)vertices + i * vertexStride);
+            settings.mTriangleVertices[i] = JPH::Float3(v.X, v.Y, v.Z);
+        }
+
+        settings.mIndexedTriangles.resize(triangleCount);
+        for (int i = 0; i < triangleCount; ++i)
+        {
+            settings.mIndexedTriangles[i].mIdx[0] = indices[i * 3 + 0];
+            settings.mIndexedTriangles[i].mIdx[1] = indices[i * 3 + 1];
+            settings.mIndexedTriangles[i].mIdx[2] = indices[i * 3 + 2];
+        }
+
+        settings.Sanitize();
+
+        JPH::Shape::ShapeResult result = settings.Create();
+        if (result.HasError())
+        {
+            LOG("CollisionResourceBuilder: Failed to create triangle mesh: {}\n", result.GetError().c_str());
+            return nullptr;
+        }
+
+        JPH::Shape* shape = result.Get();
+        shape->AddRef();
+        return shape;
+    }
+}
+
+UniqueRef<CollisionResource> CollisionResourceBuilder::Build(Float3 const* vertices, int vertexCount, int vertexStride, unsigned int const* indices, int indexCount)
+{
+    if (vertexStride <= 0)
+    {
+        LOG("CollisionResourceBuilder: invalid VertexStride\n");
+        return {};
+    }
+
+    UniqueRef<CollisionResource> resource = MakeUnique<CollisionResource>();
+
+    CollisionResource::Part part;
+
+    switch (Mode)
+    {
+        case CollisionCookMode::TriangleSoup:
+        {
+            if (JPH::Shape* shape = CreateMeshShape(vertices, vertexCount, vertexStride, indices, indexCount))
+            {
+                part.IsConvex = false;
+                resource->AddPart(part, shape);
+                shape->Release();
+            }
+            break;
+        }
+        case CollisionCookMode::ConvexHull:
+        {
+            if (JPH::Shape* shape = CreateConvexHullShape(vertices, vertexCount, vertexStride))
+            {
+                part.IsConvex = true;
+                resource->AddPart(part, shape);
+                shape->Release();
+            }
+            break;
+        }
+        case CollisionCookMode::ConvexDecomposition:
+        case CollisionCookMode::ConvexDecompositionVHACD:
+        {
+            ConvexDecompositionSource source;
+            source.Vertices = vertices;
+            source.VertexCount = vertexCount;
+            source.VertexStride = vertexStride;
+            source.Indices = indices;
+            source.IndexCount = indexCount;
+
+            ConvexDecompositionBatchSettings settings;
+            settings.Method = Mode == CollisionCookMode::ConvexDecomposition ? ConvexDecompositionMethod::HACD : ConvexDecompositionMethod::VHACD;
+            settings.CacheDirectory = HullCacheDirectory;
+
+            Vector<ConvexDecompositionResult> decomposition;
+            Geometry::PerformConvexDecompositionBatch({&source, 1}, decomposition, settings);
+
+            Vector<Float3> const& hullVertices = decomposition[0].Vertices;
+            for (ConvexHullDesc const& hull : decomposition[0].Hulls)
+            {
+                if (JPH::Shape* shape = CreateConvexHullShape(hullVertices.ToPtr() + hull.FirstVertex, hull.VertexCount, sizeof(Float3)))
+                {
+                    part.OffsetPosition = hull.Centroid;
+                    part.IsConvex = true;
+                    resource->AddPart(part, shape);
+                    shape->Release();
+                }
+            }
+            break;
+        }
+    }
+
+    if (resource->GetPartCount() == 0)
+    {
+        LOG("CollisionResourceBuilder: Failed to build collision\n");
+        return {};
+    }
+
+    return resource;
+}
+
+HK_NAMESPACE_END
@@ -0,0 +1,117 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "ResourceHandle.h"
+#include "ResourceBase.h"
+
+#include <Hork/Core/BinaryStream.h>
+#include <Hork/Core/Containers/Vector.h>
+#include <Hork/Math/Quat.h>
+
+namespace JPH
+{
+    class Shape;
+}
+
+HK_NAMESPACE_BEGIN
+
+class MeshResource;
+
+/// Collision shapes cooked from a mesh. Shapes are stored in Jolt binary format and restored on load,
+/// so the colliders don't build hulls or mesh trees at runtime. All colliders created from the resource
+/// share the same shapes, scaling is applied per body.
+class CollisionResource : public ResourceBase
+{
+public:
+    static const uint8_t        Type = RESOURCE_COLLISION;
+    static const uint8_t        Version = 1;
+
+    struct Part
+    {
+        Float3                  OffsetPosition;
+        Quat                    OffsetRotation = Quat::sIdentity();
+        bool                    IsConvex = false;
+    };
+
+                                CollisionResource() = default;
+                                ~CollisionResource();
+
+    static UniqueRef<CollisionResource> sLoad(IBinaryStreamReadInterface& stream);
+
+    bool                        Read(IBinaryStreamReadInterface& stream);
+    void                        Write(IBinaryStreamWriteInterface& stream) const;
+
+    /// Add cooked shape. The resource holds a reference to the shape.
+    void                        AddPart(Part const& part, JPH::Shape* shape);
+
+    int                         GetPartCount() const { return m_Parts.Size(); }
+    Part const&                 GetPart(int index) const { return m_Parts[index]; }
+
+    /// Shared Jolt shape of the part
+    JPH::Shape*                 GetShape(int index) const { return m_Shapes[index]; }
+
+private:
+    void                        Clear();
+
+    Vector<Part>                m_Parts;
+    Vector<JPH::Shape*>         m_Shapes;
+};
+
+using CollisionHandle = ResourceHandle<CollisionResource>;
+
+enum class CollisionCookMode : uint8_t
+{
+    /// Static triangle mesh. Can be used only by static bodies.
+    TriangleSoup,
+    /// Single convex hull of all vertices
+    ConvexHull,
+    /// Convex decomposition with HACD
+    ConvexDecomposition,
+    /// Convex decomposition with V-HACD
+    ConvexDecompositionVHACD
+};
+
+/// Offline cook step for collision shapes. Jolt types must be registered before building.
+class CollisionResourceBuilder
+{
+public:
+    CollisionCookMode           Mode = CollisionCookMode::TriangleSoup;
+
+    /// Directory of the convex decomposition cache. See ConvexDecompositionBatchSettings.
+    StringView                  HullCacheDirectory;
+
+    UniqueRef<CollisionResource> Build(MeshResource const& mesh);
+
+    UniqueRef<CollisionResource> Build(Float3 const* vertices, int vertexCount, int vertexStride, unsigned int const* indices, int indexCount);
+};
+
+HK_NAMESPACE_END
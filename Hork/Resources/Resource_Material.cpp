@@ -114,7 +114,7 @@ uint32_t MaterialResource::GetUniformVectorCount() const
     return m_Binary->UniformVectorCount;
 }
 
-UniqueRef<MaterialResource> MaterialResourceBuilder::Build(MaterialGraph& graph, bool debugMode)
+UniqueRef<MaterialResource> MaterialResourceBuilder::Build(MaterialGraph& graph, bool debugMode, AsyncJobList* jobList)
 {
     auto materialCode = graph.Build();
     if (!materialCode)
@@ -122,6 +122,7 @@ UniqueRef<MaterialResource> MaterialResourceBuilder::Build(MaterialGraph& graph,
 
     MaterialCode::TranslationParams translationParams;
     translationParams.IsDebugMode = debugMode;
+    translationParams.JobList = jobList;
 
     auto material = MakeUnique<MaterialResource>();
     material->m_Binary = materialCode->Translate(translationParams);
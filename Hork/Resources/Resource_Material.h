@@ -71,7 +71,8 @@ using MaterialHandle = ResourceHandle<MaterialResource>;
 class MaterialResourceBuilder
 {
 public:
-    UniqueRef<MaterialResource> Build(class MaterialGraph& graph, bool debugMode);
+    /// Shader stages are compiled as independent jobs of the job list if it is specified.
+    UniqueRef<MaterialResource> Build(class MaterialGraph& graph, bool debugMode, class AsyncJobList* jobList = nullptr);
 };
 
 HK_NAMESPACE_END
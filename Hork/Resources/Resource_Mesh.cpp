@@ -34,6 +34,8 @@ SOFTWARE.
 #include <Hork/Core/ReadWriteBuffer.h>
 #include <Hork/Geometry/BV/BvIntersect.h>
 #include <Hork/Geometry/TangentSpace.h>
+#include <Hork/Geometry/MeshOptimizer.h>
+#include <Hork/Geometry/MeshSimplifier.h>
 
 #include <ozz/animation/runtime/animation.h>
 #include <ozz/animation/runtime/skeleton.h>
@@ -166,6 +168,32 @@ namespace
     }
 }
 
+void MeshSurfaceLod::Read(IBinaryStreamReadInterface& stream)
+{
+    FirstIndex = stream.ReadUInt32();
+    IndexCount = stream.ReadUInt32();
+    Error = stream.ReadFloat();
+}
+
+void MeshSurfaceLod::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteUInt32(FirstIndex);
+    stream.WriteUInt32(IndexCount);
+    stream.WriteFloat(Error);
+}
+
+MeshSurfaceLod const* MeshSurface::SelectLod(float maxError) const
+{
+    MeshSurfaceLod const* lod = nullptr;
+    for (MeshSurfaceLod const& surfaceLod : Lods)
+    {
+        if (surfaceLod.Error > maxError)
+            break;
+        lod = &surfaceLod;
+    }
+    return lod;
+}
+
 void MeshSurface::Read(IBinaryStreamReadInterface& stream)
 {
     BaseVertex = stream.ReadUInt32();
@@ -218,7 +246,10 @@ bool MeshResource::Read(IBinaryStreamReadInterface& stream)
 
     uint32_t fileMagic = stream.ReadUInt32();
 
-    if (fileMagic != MakeResourceMagic(Type, Version))
+    // Version 2 is the same format without surface LODs
+    const uint8_t LegacyVersion = 2;
+
+    if (fileMagic != MakeResourceMagic(Type, Version) && fileMagic != MakeResourceMagic(Type, LegacyVersion))
     {
         LOG("Unexpected file format\n");
         return false;
@@ -242,6 +273,12 @@ bool MeshResource::Read(IBinaryStreamReadInterface& stream)
     stream.ReadArray(m_LightmapUVs);
     stream.ReadArray(m_Indices);
     stream.ReadArray(m_Surfaces);
+
+    if (fileMagic == MakeResourceMagic(Type, Version))
+    {
+        for (MeshSurface& surface : m_Surfaces)
+            stream.ReadArray(surface.Lods);
+    }
       
     return true;
 }
@@ -268,6 +305,9 @@ void MeshResource::Write(IBinaryStreamWriteInterface& stream) const
     stream.WriteArray(m_LightmapUVs);
     stream.WriteArray(m_Indices);
     stream.WriteArray(m_Surfaces);
+
+    for (MeshSurface const& surface : m_Surfaces)
+        stream.WriteArray(surface.Lods);
 }
 
 void* MeshResource::sGetVertexMemory(void* _This)
@@ -877,6 +917,49 @@ namespace
 
         return ozzSkeleton;
     }
+
+    void OptimizeSurface(RawMesh::Surface& surface, MeshOptimizationFlags flags, float overdrawThreshold)
+    {
+        uint32_t* indices = surface.Indices.ToPtr();
+        size_t indexCount = surface.Indices.Size();
+        size_t vertexCount = surface.Positions.Size();
+
+        if (indexCount < 6 || vertexCount == 0)
+            return;
+
+        if (!!(flags & MeshOptimizationFlags::VertexCache))
+        {
+            Geometry::OptimizeVertexCache(indices, indexCount, vertexCount);
+
+            if (!!(flags & MeshOptimizationFlags::Overdraw))
+                Geometry::OptimizeOverdraw(indices, indexCount, surface.Positions.ToPtr(), vertexCount, 16, overdrawThreshold);
+        }
+
+        if (!!(flags & MeshOptimizationFlags::VertexFetch))
+        {
+            // Incomplete channels are padded the same way the builder does, normals and tangents are recalculated
+            if (!surface.TexCoords.IsEmpty())
+                surface.TexCoords.Resize(vertexCount, Float2(0.0f));
+            if (!surface.TexCoords2.IsEmpty())
+                surface.TexCoords2.Resize(vertexCount, Float2(0.0f));
+            if (!surface.SkinVerts.IsEmpty())
+                surface.SkinVerts.Resize(vertexCount, SkinVertex{});
+            if (surface.Normals.Size() != vertexCount)
+                surface.Normals.Clear();
+            if (surface.Tangents.Size() != vertexCount)
+                surface.Tangents.Clear();
+
+            Vector<uint32_t> remap;
+            uint32_t newVertexCount = Geometry::OptimizeVertexFetch(indices, indexCount, vertexCount, remap);
+
+            Geometry::RemapVertexStream(surface.Positions, remap, newVertexCount);
+            Geometry::RemapVertexStream(surface.TexCoords, remap, newVertexCount);
+            Geometry::RemapVertexStream(surface.TexCoords2, remap, newVertexCount);
+            Geometry::RemapVertexStream(surface.Normals, remap, newVertexCount);
+            Geometry::RemapVertexStream(surface.Tangents, remap, newVertexCount);
+            Geometry::RemapVertexStream(surface.SkinVerts, remap, newVertexCount);
+        }
+    }
 }
 
 UniqueRef<MeshResource> MeshResourceBuilder::Build(RawMesh const& rawMesh)
@@ -894,7 +977,23 @@ UniqueRef<MeshResource> MeshResourceBuilder::Build(RawMesh const& rawMesh)
     auto& m_Indices = resource->m_Indices;
     auto& m_BoundingBox = resource->m_BoundingBox;
 
-    m_Surfaces.Reserve(rawMesh.Surfaces.Size());
+    // Optimized surfaces are built from copies, the source mesh stays untouched
+    Vector<UniqueRef<RawMesh::Surface>> optimizedSurfaces;
+    Vector<RawMesh::Surface const*> surfaces;
+    surfaces.Reserve(rawMesh.Surfaces.Size());
+    for (auto& surface : rawMesh.Surfaces)
+    {
+        if (Optimization != MeshOptimizationFlags::None)
+        {
+            auto& optimized = optimizedSurfaces.EmplaceBack(MakeUnique<RawMesh::Surface>(*surface));
+            OptimizeSurface(*optimized, Optimization, OverdrawThreshold);
+            surfaces.Add(optimized.RawPtr());
+        }
+        else
+            surfaces.Add(surface.RawPtr());
+    }
+
+    m_Surfaces.Reserve(surfaces.Size());
     m_Skeleton = ConvertSkeletonToOzz(&rawMesh.Skeleton);
 
     m_Skins.Resize(rawMesh.Skins.Size());
@@ -929,7 +1028,7 @@ UniqueRef<MeshResource> MeshResourceBuilder::Build(RawMesh const& rawMesh)
     size_t vertexCount = 0;
     size_t indexCount = 0;
     bool hasSkinning = false;
-    for (auto& surface : rawMesh.Surfaces)
+    for (auto* surface : surfaces)
     {
         auto firstVertex = vertexCount;
         auto firstIndex = indexCount;
@@ -965,7 +1064,7 @@ UniqueRef<MeshResource> MeshResourceBuilder::Build(RawMesh const& rawMesh)
     if (hasSkinning)
         m_SkinBuffer.Resize(vertexCount);
 
-    for (auto& surface : rawMesh.Surfaces)
+    for (auto* surface : surfaces)
     {
         auto firstVertex = m_Vertices.Size();
 
@@ -1042,6 +1141,53 @@ UniqueRef<MeshResource> MeshResourceBuilder::Build(RawMesh const& rawMesh)
         }
     }
 
+    // Simplified LODs are appended after the surfaces and share the surface vertices
+    if (LodCount > 0)
+    {
+        Vector<uint32_t> lodIndices;
+        for (uint32_t surfaceIndex = 0; surfaceIndex < surfaces.Size(); ++surfaceIndex)
+        {
+            auto* surface = surfaces[surfaceIndex];
+            auto& dst = m_Surfaces[surfaceIndex];
+
+            size_t sourceIndexCount = surface->Indices.Size();
+            if (sourceIndexCount < 3 * 64 || dst.BoundingBox.IsEmpty())
+                continue;
+
+            float maxError = dst.BoundingBox.Radius() * LodMaxError;
+
+            lodIndices.Resize(sourceIndexCount);
+
+            // Every LOD is simplified from the source surface, so the LOD error is measured against the source
+            size_t indexCount = sourceIndexCount;
+            float targetRatio = 1.0f;
+            for (uint32_t lodIndex = 0; lodIndex < LodCount; ++lodIndex)
+            {
+                targetRatio *= LodReduction;
+                size_t targetIndexCount = size_t(sourceIndexCount * targetRatio) / 3 * 3;
+
+                float error;
+                size_t lodIndexCount = Geometry::SimplifyMesh(lodIndices.ToPtr(), surface->Indices.ToPtr(), sourceIndexCount, surface->Positions.ToPtr(), surface->Positions.Size(), targetIndexCount, maxError, &error);
+
+                // Stop if the simplifier can't make meaningful progress
+                if (lodIndexCount == 0 || lodIndexCount > indexCount * 9 / 10)
+                    break;
+
+                indexCount = lodIndexCount;
+
+                if (!!(Optimization & MeshOptimizationFlags::VertexCache))
+                    Geometry::OptimizeVertexCache(lodIndices.ToPtr(), indexCount, surface->Positions.Size());
+
+                auto& lod = dst.Lods.EmplaceBack();
+                lod.FirstIndex = m_Indices.Size();
+                lod.IndexCount = indexCount;
+                lod.Error = dst.Lods.Size() > 1 ? Math::Max(error, dst.Lods[dst.Lods.Size() - 2].Error) : error;
+
+                m_Indices.Add(lodIndices.ToPtr(), lodIndices.ToPtr() + indexCount);
+            }
+        }
+    }
+
     m_BoundingBox = rawMesh.CalcBoundingBox();
 
     return resource;
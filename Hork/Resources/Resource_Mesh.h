@@ -61,6 +61,17 @@ struct TriangleHitResult
     //Material* MaterialInstance;
 };
 
+struct MeshSurfaceLod
+{
+    uint32_t            FirstIndex = 0;
+    uint32_t            IndexCount = 0;
+    /// Geometric error of the simplified surface, in mesh units
+    float               Error = 0;
+
+    void                Read(IBinaryStreamReadInterface& stream);
+    void                Write(IBinaryStreamWriteInterface& stream) const;
+};
+
 struct MeshSurface
 {
     uint32_t            BaseVertex = 0;
@@ -72,6 +83,11 @@ struct MeshSurface
     SimdFloat4x4        InverseTransform = SimdFloat4x4::identity();
     BvAxisAlignedBox    BoundingBox = BvAxisAlignedBox::sEmpty();
     BvhTree             Bvh;
+    /// Simplified versions of the surface ordered from detailed to coarse. LOD indices reference the surface vertices.
+    Vector<MeshSurfaceLod> Lods;
+
+    /// Select the coarsest LOD whose error does not exceed maxError. Returns null for the full detail surface.
+    MeshSurfaceLod const* SelectLod(float maxError) const;
 
     void                Read(IBinaryStreamReadInterface& stream);
     void                Write(IBinaryStreamWriteInterface& stream) const;
@@ -109,7 +125,7 @@ class MeshResource : public ResourceBase
 {
 public:
     static const uint8_t        Type = RESOURCE_MESH;
-    static const uint8_t        Version = 2;
+    static const uint8_t        Version = 3;
 
     using VertexBuffer =        VertexBufferCPU<MeshVertex>;
     using UvBuffer =            VertexBufferCPU<MeshVertexUV>;
@@ -216,9 +232,38 @@ private:
 
 using MeshHandle = ResourceHandle<MeshResource>;
 
+enum class MeshOptimizationFlags : uint32_t
+{
+    None = 0,
+    /// Reorder triangles for post-transform vertex cache
+    VertexCache = 1,
+    /// Reorder triangle clusters to reduce overdraw. Requires VertexCache.
+    Overdraw = 2,
+    /// Reorder vertices in the order of first use by the index buffer
+    VertexFetch = 4,
+    All = VertexCache | Overdraw | VertexFetch
+};
+
+HK_FLAG_ENUM_OPERATORS(MeshOptimizationFlags)
+
 class MeshResourceBuilder
 {
 public:
+    /// Per-surface optimizations applied before the surfaces are written to the mesh buffers
+    MeshOptimizationFlags       Optimization = MeshOptimizationFlags::None;
+
+    /// How much the overdraw optimization can degrade vertex cache efficiency (1.05 = up to 5%)
+    float                       OverdrawThreshold = 1.05f;
+
+    /// Number of simplified LODs generated per surface
+    uint32_t                    LodCount = 0;
+
+    /// Triangle count ratio between successive LODs
+    float                       LodReduction = 0.5f;
+
+    /// Maximum simplification error relative to the surface bounding sphere radius
+    float                       LodMaxError = 0.25f;
+
     UniqueRef<MeshResource>     Build(RawMesh const& rawMesh);
 };
 
@@ -76,8 +76,45 @@ void DownsampleHeightMap(int inSourceResolution, const float* inSourceMap, float
     }
 }
 
+namespace
+{
+
+/// Quantized sample value of a hole
+constexpr uint16_t TERRAIN_HOLE_UINT16 = 0xffff;
+
+void DecodeSamples(TerrainTileFormat format, void const* tileData, float heightMin, float heightScale, size_t first, int count, float* outSamples)
+{
+    if (format == TerrainTileFormat::Float32)
+    {
+        Core::Memcpy(outSamples, static_cast<float const*>(tileData) + first, count * sizeof(float));
+        return;
+    }
+
+    uint16_t const* samples = static_cast<uint16_t const*>(tileData) + first;
+    for (int i = 0; i < count; i++)
+        outSamples[i] = samples[i] == TERRAIN_HOLE_UINT16 ? FLT_MAX : heightMin + samples[i] * heightScale;
+}
+
+void GetHeightRange(float const* samples, size_t count, float& outMin, float& outMax)
+{
+    outMin = std::numeric_limits<float>::max();
+    outMax = -std::numeric_limits<float>::max();
+    for (size_t i = 0; i < count; i++)
+    {
+        float h = samples[i];
+        if (h != FLT_MAX)
+        {
+            outMin = Math::Min(h, outMin);
+            outMax = Math::Max(h, outMax);
+        }
+    }
+}
+
+}
+
 TerrainResource::~TerrainResource()
 {
+    DetachStreamer();
 }
 
 UniqueRef<TerrainResource> TerrainResource::sLoad(IBinaryStreamReadInterface& stream)
@@ -88,35 +125,259 @@ UniqueRef<TerrainResource> TerrainResource::sLoad(IBinaryStreamReadInterface& st
     return resource;
 }
 
+UniqueRef<TerrainResource> TerrainResource::sLoad(File&& file, TerrainStreamer& streamer)
+{
+    UniqueRef<TerrainResource> resource = MakeUnique<TerrainResource>();
+    if (!resource->ReadHeader(file))
+        return {};
+
+    // Lods that fit a single tile are small and always resident, so the readers have something to fall back to
+    for (int i = 0; i < resource->m_NumLods; i++)
+    {
+        Lod& lod = resource->m_Lods[i];
+        if (lod.Tiles.Size() != 1)
+            continue;
+
+        Tile& tile = lod.Tiles[0];
+        if (!resource->ReadTile(file, tile.FileOffset, resource->GetTileSizeInBytes(i), tile.Data))
+        {
+            LOG("Failed to read terrain tile\n");
+            return {};
+        }
+    }
+
+    resource->m_TileFile = std::move(file);
+    resource->m_Streamer = &streamer;
+    streamer.Register(resource.RawPtr());
+    return resource;
+}
+
 bool TerrainResource::Read(IBinaryStreamReadInterface& stream)
 {
-    //uint32_t fileMagic = stream.ReadUInt32();
+    if (!ReadHeader(stream))
+        return false;
+
+    size_t totalMemoryAllocated{};
+    for (int i = 0; i < m_NumLods; i++)
+    {
+        size_t tileSizeInBytes = GetTileSizeInBytes(i);
+        for (Tile& tile : m_Lods[i].Tiles)
+        {
+            if (!ReadTile(stream, tile.FileOffset, tileSizeInBytes, tile.Data))
+            {
+                LOG("Failed to read terrain tile\n");
+                return false;
+            }
+            totalMemoryAllocated += tileSizeInBytes;
+        }
+    }
+
+    LOG("Terrain height field memory usage: {} KB\n", totalMemoryAllocated >> 10);
+    return true;
+}
+
+bool TerrainResource::ReadHeader(IBinaryStreamReadInterface& stream)
+{
+    uint32_t fileMagic = stream.ReadUInt32();
 
-    //if (fileMagic != MakeResourceMagic(Type, Version))
-    //{
-    //    LOG("Unexpected file format\n");
-    //    return false;
-    //}
+    if (fileMagic != MakeResourceMagic(Type, Version))
+    {
+        LOG("Unexpected file format\n");
+        return false;
+    }
+
+    uint32_t resolution = stream.ReadUInt32();
+    uint32_t tileSize = stream.ReadUInt32();
+    uint8_t format = stream.ReadUInt8();
+    float minHeight = stream.ReadFloat();
+    float maxHeight = stream.ReadFloat();
 
-    // TODO: read heightmap
+    if (resolution < 2 || !IsPowerOfTwo(resolution) || tileSize == 0 || !IsPowerOfTwo(tileSize) || format > uint8_t(TerrainTileFormat::UInt16))
+    {
+        LOG("Invalid terrain header\n");
+        return false;
+    }
 
-    #if 0
-    Allocate(1024, stream.AsBlob().GetData());
-    #endif
+    m_TileFormat = TerrainTileFormat(format);
 
-    Allocate(1024);
+    AllocateLods(resolution, tileSize);
+    UpdateBounds(minHeight, maxHeight);
 
+    for (int i = 0; i < m_NumLods; i++)
+    {
+        for (Tile& tile : m_Lods[i].Tiles)
+        {
+            tile.FileOffset = stream.ReadUInt64();
+            tile.HeightMin = stream.ReadFloat();
+            tile.HeightScale = stream.ReadFloat();
+        }
+    }
     return true;
 }
 
+bool TerrainResource::ReadTile(IBinaryStreamReadInterface& stream, uint64_t fileOffset, size_t sizeInBytes, HeapBlob& outData) const
+{
+    if (!stream.SeekSet(int64_t(fileOffset)))
+        return false;
+
+    outData.Reset(sizeInBytes);
+    if (stream.Read(outData.GetData(), sizeInBytes) != sizeInBytes)
+    {
+        outData.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool TerrainResource::LoadTile(int lod, Tile& tile) const
+{
+    {
+        MutexGuard lock(m_TileMutex);
+        if (tile.Data)
+            return true;
+    }
+
+    // The file is read outside of the tile lock so the readers are not blocked by IO
+    HeapBlob data;
+    {
+        MutexGuard fileLock(m_FileMutex);
+        if (!m_TileFile || !ReadTile(m_TileFile, tile.FileOffset, GetTileSizeInBytes(lod), data))
+            return false;
+    }
+
+    MutexGuard lock(m_TileMutex);
+
+    // Can be loaded by another thread meanwhile
+    if (!tile.Data)
+    {
+        m_StreamedMemory += data.Size();
+        m_StreamedTiles.Add(&tile);
+        m_Lods[lod].Version++;
+        tile.Data = std::move(data);
+    }
+    return true;
+}
+
+void TerrainResource::LoadQueuedTile(int lod, Tile& tile) const
+{
+    // Tiles evicted after loading can be queued again
+    {
+        MutexGuard lock(m_TileMutex);
+        tile.bQueued = false;
+    }
+
+    if (!LoadTile(lod, tile))
+        LOG("Failed to read terrain tile\n");
+}
+
+uint32_t TerrainResource::GetStreamerFrame() const
+{
+    return m_Streamer ? m_Streamer->GetFrame() : 0;
+}
+
+void TerrainResource::DetachStreamer()
+{
+    if (m_Streamer)
+    {
+        m_Streamer->Unregister(this);
+        m_Streamer = nullptr;
+    }
+}
+
+void TerrainResource::Write(IBinaryStreamWriteInterface& stream, TerrainTileFormat format) const
+{
+    HK_ASSERT(!IsStreamed());
+
+    const size_t tileEntrySize = sizeof(uint64_t) + sizeof(float) * 2;
+    const size_t bytesPerSample = format == TerrainTileFormat::Float32 ? sizeof(float) : sizeof(uint16_t);
+
+    size_t numTiles = 0;
+    for (Lod const& lod : m_Lods)
+        numTiles += lod.Tiles.Size();
+
+    stream.WriteUInt32(MakeResourceMagic(Type, Version));
+    stream.WriteUInt32(m_Resolution);
+    stream.WriteUInt32(m_TileSize);
+    stream.WriteUInt8(uint8_t(format));
+    stream.WriteFloat(m_BoundingBox.Mins.Y);
+    stream.WriteFloat(m_BoundingBox.Maxs.Y);
+
+    Vector<float> samples;
+
+    // Tile table
+    uint64_t offset = stream.GetOffset() + numTiles * tileEntrySize;
+    for (int i = 0; i < m_NumLods; i++)
+    {
+        Lod const& lod = m_Lods[i];
+        uint32_t sampleCount = 1u << (lod.TileShift * 2);
+
+        samples.Resize(sampleCount);
+
+        for (Tile const& tile : lod.Tiles)
+        {
+            float heightMin = 0;
+            float heightScale = 0;
+
+            if (format == TerrainTileFormat::UInt16)
+            {
+                float heightMax;
+                DecodeSamples(m_TileFormat, tile.Data.GetData(), tile.HeightMin, tile.HeightScale, 0, sampleCount, samples.ToPtr());
+                GetHeightRange(samples.ToPtr(), sampleCount, heightMin, heightMax);
+                if (heightMin > heightMax)
+                    heightMin = heightMax = 0;
+                heightScale = (heightMax - heightMin) / (TERRAIN_HOLE_UINT16 - 1);
+            }
+
+            stream.WriteUInt64(offset);
+            stream.WriteFloat(heightMin);
+            stream.WriteFloat(heightScale);
+
+            offset += sampleCount * bytesPerSample;
+        }
+    }
+
+    // Tile data
+    Vector<uint16_t> quantized;
+    for (int i = 0; i < m_NumLods; i++)
+    {
+        Lod const& lod = m_Lods[i];
+        uint32_t sampleCount = 1u << (lod.TileShift * 2);
+
+        samples.Resize(sampleCount);
+        quantized.Resize(sampleCount);
+
+        for (Tile const& tile : lod.Tiles)
+        {
+            DecodeSamples(m_TileFormat, tile.Data.GetData(), tile.HeightMin, tile.HeightScale, 0, sampleCount, samples.ToPtr());
+
+            if (format == TerrainTileFormat::Float32)
+            {
+                stream.Write(samples.ToPtr(), sampleCount * sizeof(float));
+                continue;
+            }
+
+            float heightMin, heightMax;
+            GetHeightRange(samples.ToPtr(), sampleCount, heightMin, heightMax);
+
+            float invScale = heightMax > heightMin ? (TERRAIN_HOLE_UINT16 - 1) / (heightMax - heightMin) : 0.0f;
+            for (uint32_t n = 0; n < sampleCount; n++)
+            {
+                float h = samples[n];
+                quantized[n] = h == FLT_MAX ? TERRAIN_HOLE_UINT16 : uint16_t(Math::Min((h - heightMin) * invScale + 0.5f, float(TERRAIN_HOLE_UINT16 - 1)));
+            }
+
+            stream.Write(quantized.ToPtr(), sampleCount * sizeof(uint16_t));
+        }
+    }
+}
+
 void TerrainResource::Upload(RHI::IDevice* device)
 {}
 
-void TerrainResource::Allocate(uint32_t resolution, float const* data)
+void TerrainResource::AllocateLods(uint32_t resolution, uint32_t tileSize)
 {
-    HK_ASSERT(IsPowerOfTwo(resolution));
-
     m_Resolution = resolution;
+    m_TileSize = tileSize;
 
     // Calc clipping region
     int halfResolutionX = m_Resolution >> 1;
@@ -134,43 +395,87 @@ void TerrainResource::Allocate(uint32_t resolution, float const* data)
     m_BoundingBox.Maxs.Y = 0;
     m_BoundingBox.Maxs.Z = m_ClipMax.Y;
 
-    // Allocate memory for terrain lods
-    size_t totalMemoryAllocated{};
+    m_StreamedTiles.Clear();
+    m_StreamedMemory = 0;
+
     m_NumLods = Math::Log2(m_Resolution) + 1;
+    m_Lods.Clear();
     m_Lods.Resize(m_NumLods);
     for (int i = 0; i < m_NumLods; i++)
     {
-        int sz = 1 << (m_NumLods - i - 1);
-        size_t size = sz * sz * sizeof(float);
-        if (i == 0)
-            m_Lods[i].Reset(size, data);
-        else
-            m_Lods[i].Reset(size);
-        if (data == nullptr)
-            m_Lods[i].ZeroMem();
-        totalMemoryAllocated += size;
+        Lod& lod = m_Lods[i];
+        lod.Resolution = 1 << (m_NumLods - i - 1);
+        lod.TileShift = Math::Log2(Math::Min(m_TileSize, lod.Resolution));
+        lod.NumTilesX = lod.Resolution >> lod.TileShift;
+        lod.Tiles.Resize(lod.NumTilesX * lod.NumTilesX);
     }
+}
 
-    if (data)
+void TerrainResource::UpdateBounds(float minHeight, float maxHeight)
+{
+    // Update vertical bounds
+    m_BoundingBox.Mins.Y = minHeight;
+    m_BoundingBox.Maxs.Y = maxHeight;
+}
+
+size_t TerrainResource::GetTileSizeInBytes(int lod) const
+{
+    size_t sampleCount = size_t(1) << (m_Lods[lod].TileShift * 2);
+    return sampleCount * (m_TileFormat == TerrainTileFormat::Float32 ? sizeof(float) : sizeof(uint16_t));
+}
+
+void TerrainResource::Allocate(uint32_t resolution, float const* data)
+{
+    HK_ASSERT(IsPowerOfTwo(resolution));
+
+    DetachStreamer();
+    m_TileFile.Close();
+    m_TileFormat = TerrainTileFormat::Float32;
+
+    AllocateLods(resolution, DefaultTileSize);
+
+    // Generate lods and split them to tiles
+    HeapBlob lodData(size_t(resolution) * resolution * sizeof(float), data);
+    HeapBlob coarserLodData;
+    if (data == nullptr)
+        lodData.ZeroMem();
+
+    size_t totalMemoryAllocated{};
+    for (int i = 0; i < m_NumLods; i++)
     {
-        GenerateLods();
+        Lod& lod = m_Lods[i];
+
+        if (i > 0)
+        {
+            coarserLodData.Reset(size_t(lod.Resolution) * lod.Resolution * sizeof(float));
+            DownsampleHeightMap(lod.Resolution << 1, (const float*)lodData.GetData(), (float*)coarserLodData.GetData());
+            lodData = std::move(coarserLodData);
+        }
 
-        float minHeight = std::numeric_limits<float>::max();
-        float maxHeight = -std::numeric_limits<float>::max();
-        for (int y = 0; y < m_Resolution; y++)
-            for (int x = 0; x < m_Resolution; x++)
+        const float* src = (const float*)lodData.GetData();
+        uint32_t tileSize = 1u << lod.TileShift;
+
+        for (uint32_t tileY = 0; tileY < lod.NumTilesX; tileY++)
+        {
+            for (uint32_t tileX = 0; tileX < lod.NumTilesX; tileX++)
             {
-                float h = data[y * m_Resolution + x];
-                if (h != FLT_MAX)
-                {
-                    minHeight = Math::Min(h, minHeight);
-                    maxHeight = Math::Max(h, maxHeight);
-                }
+                Tile& tile = lod.Tiles[tileY * lod.NumTilesX + tileX];
+                tile.Data.Reset(tileSize * tileSize * sizeof(float));
+
+                float* dst = (float*)tile.Data.GetData();
+                for (uint32_t y = 0; y < tileSize; y++)
+                    Core::Memcpy(dst + y * tileSize, src + (tileY * tileSize + y) * lod.Resolution + tileX * tileSize, tileSize * sizeof(float));
+
+                totalMemoryAllocated += tile.Data.Size();
             }
+        }
+    }
 
-        // Update vertical bounds
-        m_BoundingBox.Mins.Y = minHeight;
-        m_BoundingBox.Maxs.Y = maxHeight;
+    if (data)
+    {
+        float minHeight, maxHeight;
+        GetHeightRange(data, size_t(resolution) * resolution, minHeight, maxHeight);
+        UpdateBounds(minHeight, maxHeight);
     }
 
     LOG("Terrain height field memory usage: {} KB\n", totalMemoryAllocated >> 10);
@@ -182,10 +487,229 @@ bool TerrainResource::WriteData(uint32_t locationX, uint32_t locationY, uint32_t
     return true;
 }
 
-void TerrainResource::GenerateLods(/* TODO: Add region */)
+TerrainResource::Tile& TerrainResource::RequestTileLocked(int lod, uint32_t tileX, uint32_t tileY) const
+{
+    Lod& lodRef = m_Lods[lod];
+    Tile& tile = lodRef.Tiles[tileY * lodRef.NumTilesX + tileX];
+
+    tile.LastUsed = GetStreamerFrame();
+
+    if (!tile.Data && !tile.bQueued && m_Streamer)
+    {
+        tile.bQueued = true;
+        m_Streamer->Enqueue(this, lod, &tile);
+    }
+    return tile;
+}
+
+TerrainResource::Tile const* TerrainResource::AcquireTileLocked(int lod, uint32_t tileX, uint32_t tileY, int& outLod) const
+{
+    Tile& tile = RequestTileLocked(lod, tileX, tileY);
+    if (tile.Data)
+    {
+        tile.PinCount++;
+        outLod = lod;
+        return &tile;
+    }
+
+    // Fall back to the coarser lods until the tile arrives. The coarser tile always covers the whole tile area.
+    uint32_t sampleX = tileX << m_Lods[lod].TileShift;
+    uint32_t sampleY = tileY << m_Lods[lod].TileShift;
+    for (int coarser = lod + 1; coarser < m_NumLods; coarser++)
+    {
+        Lod& lodRef = m_Lods[coarser];
+        int shift = coarser - lod + lodRef.TileShift;
+
+        Tile& coarserTile = lodRef.Tiles[(sampleY >> shift) * lodRef.NumTilesX + (sampleX >> shift)];
+        if (coarserTile.Data)
+        {
+            coarserTile.LastUsed = GetStreamerFrame();
+            coarserTile.PinCount++;
+            outLod = coarser;
+            return &coarserTile;
+        }
+    }
+    return nullptr;
+}
+
+void TerrainResource::ReadRow(int lod, int x, int y, int count, float* outSamples) const
+{
+    if (count <= 0)
+        return;
+
+    if (lod < 0 || lod >= m_NumLods)
+    {
+        for (int i = 0; i < count; i++)
+            outSamples[i] = 0.0f;
+        return;
+    }
+
+    Lod const& lodRef = m_Lods[lod];
+    int resolution = lodRef.Resolution;
+
+    // Whole row is outside the lod
+    if (x + count <= 0 || x >= resolution)
+    {
+        float h;
+        ReadRow(lod, Math::Clamp(x, 0, resolution - 1), y, 1, &h);
+        for (int i = 0; i < count; i++)
+            outSamples[i] = h;
+        return;
+    }
+
+    y = Math::Clamp(y, 0, resolution - 1);
+
+    int spanBegin = Math::Max(x, 0);
+    int spanEnd = Math::Min(x + count, resolution);
+
+    uint32_t tileSize = 1u << lodRef.TileShift;
+    uint32_t tileY = y >> lodRef.TileShift;
+
+    struct TileSpan
+    {
+        Tile const* Source;
+        int         SourceLod;
+        int         Begin;
+        int         Count;
+    };
+    TileSpan spans[8];
+
+    for (int s = spanBegin; s < spanEnd;)
+    {
+        // Pin the tiles under the lock and decode them without it
+        int numSpans = 0;
+        {
+            MutexGuard lock(m_TileMutex);
+
+            for (; s < spanEnd && numSpans < int(HK_ARRAY_SIZE(spans)); numSpans++)
+            {
+                TileSpan& span = spans[numSpans];
+                span.Source = AcquireTileLocked(lod, s >> lodRef.TileShift, tileY, span.SourceLod);
+                span.Begin = s;
+                span.Count = Math::Min<int>(tileSize - (s & (tileSize - 1)), spanEnd - s);
+                s += span.Count;
+            }
+        }
+
+        for (int n = 0; n < numSpans; n++)
+        {
+            TileSpan const& span = spans[n];
+
+            float* dst = outSamples + (span.Begin - x);
+            if (!span.Source)
+            {
+                for (int i = 0; i < span.Count; i++)
+                    dst[i] = 0.0f;
+                continue;
+            }
+
+            Lod const& sourceLod = m_Lods[span.SourceLod];
+            int shift = span.SourceLod - lod;
+            uint32_t sourceTileMask = (1u << sourceLod.TileShift) - 1;
+            size_t sourceRow = ((y >> shift) & sourceTileMask) << sourceLod.TileShift;
+
+            if (shift == 0)
+            {
+                DecodeSamples(m_TileFormat, span.Source->Data.GetData(), span.Source->HeightMin, span.Source->HeightScale, sourceRow + (span.Begin & sourceTileMask), span.Count, dst);
+            }
+            else
+            {
+                for (int i = 0; i < span.Count; i++)
+                    DecodeSamples(m_TileFormat, span.Source->Data.GetData(), span.Source->HeightMin, span.Source->HeightScale, sourceRow + (((span.Begin + i) >> shift) & sourceTileMask), 1, dst + i);
+            }
+        }
+
+        MutexGuard lock(m_TileMutex);
+        for (int n = 0; n < numSpans; n++)
+        {
+            if (Tile* tile = const_cast<Tile*>(spans[n].Source))
+                tile->PinCount--;
+        }
+    }
+
+    // Clamp to the border
+    for (int i = 0; i < spanBegin - x; i++)
+        outSamples[i] = outSamples[spanBegin - x];
+    for (int i = spanEnd - x; i < count; i++)
+        outSamples[i] = outSamples[spanEnd - x - 1];
+}
+
+void TerrainResource::ReadRowResident(int lod, int x, int y, int count, float* outSamples) const
+{
+    // Tiles loaded on this thread are marked as used, so they are not evicted before they are read
+    if (IsStreamed() && count > 0)
+        LoadTiles(lod, x, y, x + count - 1, y);
+
+    ReadRow(lod, x, y, count, outSamples);
+}
+
+void TerrainResource::RequestTiles(int lod, int minX, int minY, int maxX, int maxY) const
+{
+    if (lod < 0 || lod >= m_NumLods)
+        return;
+
+    Lod const& lodRef = m_Lods[lod];
+    int resolution = lodRef.Resolution;
+
+    uint32_t minTileX = Math::Clamp(minX, 0, resolution - 1) >> lodRef.TileShift;
+    uint32_t minTileY = Math::Clamp(minY, 0, resolution - 1) >> lodRef.TileShift;
+    uint32_t maxTileX = Math::Clamp(maxX, 0, resolution - 1) >> lodRef.TileShift;
+    uint32_t maxTileY = Math::Clamp(maxY, 0, resolution - 1) >> lodRef.TileShift;
+
+    MutexGuard lock(m_TileMutex);
+
+    for (uint32_t tileY = minTileY; tileY <= maxTileY; tileY++)
+        for (uint32_t tileX = minTileX; tileX <= maxTileX; tileX++)
+            RequestTileLocked(lod, tileX, tileY);
+}
+
+void TerrainResource::LoadTiles(int lod, int minX, int minY, int maxX, int maxY) const
+{
+    if (lod < 0 || lod >= m_NumLods)
+        return;
+
+    Lod& lodRef = m_Lods[lod];
+    int resolution = lodRef.Resolution;
+
+    uint32_t minTileX = Math::Clamp(minX, 0, resolution - 1) >> lodRef.TileShift;
+    uint32_t minTileY = Math::Clamp(minY, 0, resolution - 1) >> lodRef.TileShift;
+    uint32_t maxTileX = Math::Clamp(maxX, 0, resolution - 1) >> lodRef.TileShift;
+    uint32_t maxTileY = Math::Clamp(maxY, 0, resolution - 1) >> lodRef.TileShift;
+
+    for (uint32_t tileY = minTileY; tileY <= maxTileY; tileY++)
+    {
+        for (uint32_t tileX = minTileX; tileX <= maxTileX; tileX++)
+        {
+            Tile& tile = lodRef.Tiles[tileY * lodRef.NumTilesX + tileX];
+            {
+                MutexGuard lock(m_TileMutex);
+                tile.LastUsed = GetStreamerFrame();
+            }
+
+            if (!LoadTile(lod, tile))
+                LOG("Failed to read terrain tile\n");
+        }
+    }
+}
+
+uint32_t TerrainResource::GetLodVersion(int lod) const
+{
+    if (lod < 0 || lod >= m_NumLods)
+        return 0;
+
+    MutexGuard lock(m_TileMutex);
+    return m_Lods[lod].Version;
+}
+
+size_t TerrainResource::GetResidentMemory() const
 {
-    for (int i = 1; i < m_NumLods; i++)
-        DownsampleHeightMap(1 << (m_NumLods - i), (const float*)m_Lods[i - 1].GetData(), (float*)m_Lods[i].GetData());
+    MutexGuard lock(m_TileMutex);
+
+    size_t memory = 0;
+    for (Lod const& lod : m_Lods)
+        for (Tile const& tile : lod.Tiles)
+            memory += tile.Data.Size();
+    return memory;
 }
 
 float TerrainResource::Sample(float x, float z) const
@@ -213,10 +737,12 @@ float TerrainResource::Sample(float x, float z) const
 
     */
 
-    const float* data = (const float*)m_Lods[0].GetData();
+    float h01[2], h32[2];
+    ReadRowResident(0, quadX, quadZ, 2, h01);
+    ReadRowResident(0, quadX, quadZ + 1, 2, h32);
 
-    float h1 = data[quadZ * m_Resolution + quadX + 1];
-    float h3 = data[(quadZ + 1) * m_Resolution + quadX];
+    float h1 = h01[1];
+    float h3 = h32[0];
 
     if (h1 == FLT_MAX || h3 == FLT_MAX)
         return 0;
@@ -227,7 +753,7 @@ float TerrainResource::Sample(float x, float z) const
     fz = 1.0f - fz;
     if (fx >= fz)
     {
-        float h2 = data[(quadZ + 1) * m_Resolution + quadX + 1];
+        float h2 = h32[1];
         if (h2 == FLT_MAX)
             return 0;
         float u = fz;
@@ -237,7 +763,7 @@ float TerrainResource::Sample(float x, float z) const
     }
     else
     {
-        float h0 = data[quadZ * m_Resolution + quadX];
+        float h0 = h01[0];
         if (h0 == FLT_MAX)
             return 0;
         float u = fz - fx;
@@ -257,9 +783,9 @@ float TerrainResource::Fetch(int x, int z, int lod) const
 
     int lodResoultion = 1 << (m_NumLods - lod - 1);
 
-    sampleX = Math::Clamp(sampleX + (lodResoultion >> 1), 0, (lodResoultion - 1));
-    sampleY = Math::Clamp(sampleY + (lodResoultion >> 1), 0, (lodResoultion - 1));
-    return ((const float*)m_Lods[lod].GetData())[sampleY * lodResoultion + sampleX];
+    float h;
+    ReadRowResident(lod, sampleX + (lodResoultion >> 1), sampleY + (lodResoultion >> 1), 1, &h);
+    return h;
 }
 
 bool TerrainResource::GetTriangleVertices(float x, float z, Float3& outV0, Float3& outV1, Float3& outV2) const
@@ -288,12 +814,14 @@ bool TerrainResource::GetTriangleVertices(float x, float z, Float3& outV0, Float
 
     */
 
-    const float* data = (const float*)m_Lods[0].GetData();
+    float h01[2], h32[2];
+    ReadRowResident(0, quadX, quadZ, 2, h01);
+    ReadRowResident(0, quadX, quadZ + 1, 2, h32);
 
-    float h0 = data[quadZ * m_Resolution + quadX];
-    float h1 = data[quadZ * m_Resolution + quadX + 1];
-    float h2 = data[(quadZ + 1) * m_Resolution + quadX + 1];
-    float h3 = data[(quadZ + 1) * m_Resolution + quadX];
+    float h0 = h01[0];
+    float h1 = h01[1];
+    float h2 = h32[1];
+    float h3 = h32[0];
 
     float maxX = minX + 1.0f;
     float maxZ = minZ + 1.0f;
@@ -376,16 +904,28 @@ void TerrainResource::GatherGeometry(BvAxisAlignedBox const& inLocalBounds, Vect
     maxQuadX = Math::Min(maxQuadX, (int)m_Resolution - 1);
     maxQuadZ = Math::Min(maxQuadZ, (int)m_Resolution - 1);
 
+    if (minQuadX >= maxQuadX || minQuadZ >= maxQuadZ)
+        return;
+
     int n = outVertices.Size();
 
-    const float* data = (const float*)m_Lods[0].GetData();
+    int rowSize = maxQuadX - minQuadX + 1;
+
+    Vector<float> rows;
+    rows.Resize(rowSize * 2);
+
+    float* row0 = rows.ToPtr();
+    float* row1 = row0 + rowSize;
 
     for (int qz = minQuadZ; qz < maxQuadZ; qz++)
     {
         float z = qz - halfResolution;
 
-        float h0 = data[qz * m_Resolution + minQuadX];
-        float h3 = data[(qz + 1) * m_Resolution + minQuadX];
+        ReadRowResident(0, minQuadX, qz, rowSize, row0);
+        ReadRowResident(0, minQuadX, qz + 1, rowSize, row1);
+
+        float h0 = row0[0];
+        float h3 = row1[0];
 
         for (int qx = minQuadX; qx < maxQuadX; qx++)
         {
@@ -403,8 +943,8 @@ void TerrainResource::GatherGeometry(BvAxisAlignedBox const& inLocalBounds, Vect
 
             */
 
-            float h1 = data[qz * m_Resolution + qx + 1];
-            float h2 = data[(qz + 1) * m_Resolution + qx + 1];
+            float h1 = row0[qx - minQuadX + 1];
+            float h2 = row1[qx - minQuadX + 1];
 
             // Check shared vertices
             if (h1 != FLT_MAX && h3 != FLT_MAX)
@@ -467,4 +1007,169 @@ void TerrainResource::GatherGeometry(BvAxisAlignedBox const& inLocalBounds, Vect
     }
 }
 
+TerrainStreamer::~TerrainStreamer()
+{
+    HK_ASSERT(m_Terrains.IsEmpty());
+
+    {
+        MutexGuard lock(m_QueueMutex);
+        m_bStopLoader = true;
+    }
+    m_LoaderEvent.Signal();
+    m_Loader.Join();
+}
+
+void TerrainStreamer::Register(TerrainResource const* terrain)
+{
+    MutexGuard lock(m_TerrainsMutex);
+
+    m_Terrains.Add(terrain);
+
+    // The loader is shared by all terrains and started with the first streamed one
+    if (!m_bLoaderStarted)
+    {
+        m_bLoaderStarted = true;
+        m_Loader.Start([this]()
+        {
+            LoaderThread();
+        });
+    }
+}
+
+void TerrainStreamer::Unregister(TerrainResource const* terrain)
+{
+    // Wait for the requests being loaded and drop the queued ones
+    {
+        MutexGuard loadLock(m_LoadMutex);
+        MutexGuard lock(m_QueueMutex);
+
+        uint32_t numKept = 0;
+        for (Request const& request : m_Queue)
+        {
+            if (request.Terrain != terrain)
+                m_Queue[numKept++] = request;
+        }
+        m_Queue.Resize(numKept);
+    }
+
+    MutexGuard lock(m_TerrainsMutex);
+    auto index = m_Terrains.IndexOf(terrain);
+    if (index != Core::NPOS)
+        m_Terrains.RemoveUnsorted(index);
+}
+
+void TerrainStreamer::Enqueue(TerrainResource const* terrain, int lod, TerrainResource::Tile* tile)
+{
+    {
+        MutexGuard lock(m_QueueMutex);
+        m_Queue.Add({terrain, tile, lod});
+    }
+    m_LoaderEvent.Signal();
+}
+
+void TerrainStreamer::LoaderThread()
+{
+    Vector<Request> requests;
+    for (;;)
+    {
+        {
+            MutexGuard loadLock(m_LoadMutex);
+            {
+                MutexGuard lock(m_QueueMutex);
+                if (m_bStopLoader)
+                    break;
+
+                requests.Clear();
+                requests.Swap(m_Queue);
+            }
+
+            for (Request const& request : requests)
+                request.Terrain->LoadQueuedTile(request.Lod, *request.Target);
+        }
+
+        if (requests.IsEmpty())
+            m_LoaderEvent.Wait();
+    }
+}
+
+void TerrainStreamer::Update(size_t budgetInBytes)
+{
+    MutexGuard lock(m_TerrainsMutex);
+
+    uint32_t frame = GetFrame();
+
+    size_t streamedMemory = 0;
+    for (TerrainResource const* terrain : m_Terrains)
+    {
+        MutexGuard tileLock(terrain->m_TileMutex);
+        streamedMemory += terrain->m_StreamedMemory;
+    }
+
+    if (streamedMemory > budgetInBytes)
+    {
+        // Tiles used since the previous update and pinned tiles can be in use
+        m_Candidates.Clear();
+        for (TerrainResource const* terrain : m_Terrains)
+        {
+            MutexGuard tileLock(terrain->m_TileMutex);
+            for (TerrainResource::Tile* tile : terrain->m_StreamedTiles)
+            {
+                if (tile->LastUsed != frame && !tile->PinCount)
+                    m_Candidates.Add({terrain, tile, tile->LastUsed});
+            }
+        }
+
+        std::sort(m_Candidates.Begin(), m_Candidates.End(), [](EvictionCandidate const& a, EvictionCandidate const& b)
+        {
+            return a.LastUsed < b.LastUsed;
+        });
+
+        for (EvictionCandidate const& candidate : m_Candidates)
+        {
+            if (streamedMemory <= budgetInBytes)
+                break;
+
+            TerrainResource const* terrain = candidate.Terrain;
+            MutexGuard tileLock(terrain->m_TileMutex);
+
+            // The tile can be used by the readers since it was collected
+            TerrainResource::Tile* tile = candidate.Target;
+            if (tile->LastUsed != frame && !tile->PinCount && tile->Data)
+            {
+                streamedMemory -= tile->Data.Size();
+                terrain->m_StreamedMemory -= tile->Data.Size();
+                tile->Data.Reset();
+            }
+        }
+
+        for (TerrainResource const* terrain : m_Terrains)
+        {
+            MutexGuard tileLock(terrain->m_TileMutex);
+
+            uint32_t numKept = 0;
+            for (TerrainResource::Tile* tile : terrain->m_StreamedTiles)
+            {
+                if (tile->Data)
+                    terrain->m_StreamedTiles[numKept++] = tile;
+            }
+            terrain->m_StreamedTiles.Resize(numKept);
+        }
+    }
+
+    m_Frame.Increment();
+}
+
+size_t TerrainStreamer::GetStreamedMemory()
+{
+    MutexGuard lock(m_TerrainsMutex);
+
+    size_t streamedMemory = 0;
+    for (TerrainResource const* terrain : m_Terrains)
+    {
+        MutexGuard tileLock(terrain->m_TileMutex);
+        streamedMemory += terrain->m_StreamedMemory;
+    }
+    return streamedMemory;
+}
+
 HK_NAMESPACE_END
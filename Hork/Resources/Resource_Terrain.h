@@ -35,23 +35,46 @@ SOFTWARE.
 
 #include <Hork/Core/BinaryStream.h>
 #include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/IO.h>
+#include <Hork/Core/Atomic.h>
+#include <Hork/Core/Thread.h>
 #include <Hork/Geometry/BV/BvAxisAlignedBox.h>
 
 HK_NAMESPACE_BEGIN
 
+enum class TerrainTileFormat : uint8_t
+{
+    /// Heights are stored as is
+    Float32,
+    /// Heights are quantized to 16 bits relative to the tile height range
+    UInt16
+};
+
+class TerrainStreamer;
+
 class TerrainResource : public ResourceBase
 {
 public:
     static const uint8_t        Type = RESOURCE_TERRAIN;
-    static const uint8_t        Version = 1;
+    static const uint8_t        Version = 2;
+
+    /// Default width and height of the lod tiles in samples
+    static constexpr uint32_t   DefaultTileSize = 64;
 
                                 TerrainResource() = default;
                                 ~TerrainResource();
 
+    /// Load all tiles to memory
     static UniqueRef<TerrainResource> sLoad(IBinaryStreamReadInterface& stream);
 
+    /// Load tile table and the coarsest lods. Other tiles are read from the file on demand by the streamer.
+    static UniqueRef<TerrainResource> sLoad(File&& file, TerrainStreamer& streamer);
+
     bool                        Read(IBinaryStreamReadInterface& stream);
 
+    /// Write tiled height map. All tiles must be resident.
+    void                        Write(IBinaryStreamWriteInterface& stream, TerrainTileFormat format = TerrainTileFormat::UInt16) const;
+
     void                        Upload(RHI::IDevice* device) override;
 
     /// Allocate empty height map
@@ -60,10 +83,39 @@ public:
     /// Fill height map data.
     bool                        WriteData(uint32_t locationX, uint32_t locationY, uint32_t width, uint32_t height, const void* pData);
 
+    /// Height at the point. Tiles that are not resident are read on the calling thread.
     float                       Sample(float x, float z) const;
 
+    /// Height of the lod sample. Tiles that are not resident are read on the calling thread.
     float                       Fetch(int x, int z, int lod) const;
 
+    int                         GetLodCount() const { return m_NumLods; }
+
+    /// Width and height of the lod height map
+    int                         GetLodResolution(int lod) const { return 1 << (m_NumLods - lod - 1); }
+
+    /// Copy count samples of the lod row y starting at column x. Sample (GetLodResolution(lod)/2, GetLodResolution(lod)/2)
+    /// is at the origin. Samples outside the lod are clamped to the border. Tiles that are not resident are queued for
+    /// loading and sampled from the nearest coarser resident lod until they arrive.
+    void                        ReadRow(int lod, int x, int y, int count, float* outSamples) const;
+
+    /// Queue loading of the tiles covering the lod samples [minX, maxX] x [minY, maxY] and mark them as used.
+    void                        RequestTiles(int lod, int minX, int minY, int maxX, int maxY) const;
+
+    /// Read the tiles covering the lod samples [minX, maxX] x [minY, maxY] on the calling thread. Used by the readers
+    /// that need exact heights rather than the coarser fallback. The tiles stay resident until the next streamer update.
+    void                        LoadTiles(int lod, int minX, int minY, int maxX, int maxY) const;
+
+    /// Incremented when a streamed tile of the lod becomes resident. Data sampled from the coarser lod can be refreshed on change.
+    uint32_t                    GetLodVersion(int lod) const;
+
+    /// Memory used by resident tiles
+    size_t                      GetResidentMemory() const;
+
+    /// Tiles are read from the file on demand
+    bool                        IsStreamed() const { return m_TileFile.IsOpened(); }
+
+    /// Triangle at the point. Tiles that are not resident are read on the calling thread.
     bool                        GetTriangleVertices(float x, float z, Float3& outV0, Float3& outV1, Float3& outV2) const;
     bool                        GetNormal(float x, float z, Float3& outNormal) const;
     bool                        GetTexcoord(float x, float z, Float2& outTexcoord) const;
@@ -75,17 +127,114 @@ public:
     BvAxisAlignedBox const&     GetBoundingBox() const { return m_BoundingBox; }
 
 private:
-    void                        GenerateLods();
+    friend class TerrainStreamer;
+
+    struct Tile
+    {
+        /// Samples in the tile format. Empty if the tile is not resident.
+        HeapBlob                Data;
+        uint64_t                FileOffset = 0;
+        float                   HeightMin = 0;
+        float                   HeightScale = 0;
+        uint32_t                LastUsed = 0;
+        /// Number of readers decoding the tile outside of the lock. Pinned tiles are not evicted.
+        uint32_t                PinCount = 0;
+        bool                    bQueued = false;
+    };
+
+    struct Lod
+    {
+        uint32_t                Resolution = 0;
+        uint32_t                TileShift = 0;
+        uint32_t                NumTilesX = 0;
+        uint32_t                Version = 0;
+        Vector<Tile>            Tiles;
+    };
+
+    void                        AllocateLods(uint32_t resolution, uint32_t tileSize);
+    void                        UpdateBounds(float minHeight, float maxHeight);
+    bool                        ReadHeader(IBinaryStreamReadInterface& stream);
+    bool                        ReadTile(IBinaryStreamReadInterface& stream, uint64_t fileOffset, size_t sizeInBytes, HeapBlob& outData) const;
+    bool                        LoadTile(int lod, Tile& tile) const;
+    void                        LoadQueuedTile(int lod, Tile& tile) const;
+    void                        ReadRowResident(int lod, int x, int y, int count, float* outSamples) const;
+    Tile&                       RequestTileLocked(int lod, uint32_t tileX, uint32_t tileY) const;
+    Tile const*                 AcquireTileLocked(int lod, uint32_t tileX, uint32_t tileY, int& outLod) const;
+    size_t                      GetTileSizeInBytes(int lod) const;
+    uint32_t                    GetStreamerFrame() const;
+    void                        DetachStreamer();
 
     uint32_t                    m_Resolution = 0;
+    uint32_t                    m_TileSize = DefaultTileSize;
+    TerrainTileFormat           m_TileFormat = TerrainTileFormat::Float32;
     int                         m_NumLods{};
     Int2                        m_ClipMin{};
     Int2                        m_ClipMax{};
     BvAxisAlignedBox            m_BoundingBox;
 
-    // TODO: store heightmap in blocks m*m for cache friendly sampling
-    // TODO: проверить, можем ли мы обойтись без лодов без потери в качетсве отображения.
-    Vector<HeapBlob>            m_Lods;
+    // Tile cache. Lods and tiles are allocated once, only tile data is loaded and evicted.
+    mutable Vector<Lod>         m_Lods;
+    mutable Vector<Tile*>       m_StreamedTiles;
+    mutable size_t              m_StreamedMemory = 0;
+    mutable File                m_TileFile;
+    mutable Mutex               m_FileMutex;
+    mutable Mutex               m_TileMutex;
+    TerrainStreamer*            m_Streamer = nullptr;
+};
+
+/// Reads the tiles of the streamed terrains on a single loader thread and keeps the streamed tiles of all terrains
+/// within the memory budget. Must outlive the terrains.
+class TerrainStreamer final : public Noncopyable
+{
+public:
+                                TerrainStreamer() = default;
+                                ~TerrainStreamer();
+
+    /// Evict least recently used tiles that were not used since the previous update until the streamed tiles
+    /// of all terrains fit the budget. Tiles being read by other threads are kept.
+    void                        Update(size_t budgetInBytes);
+
+    /// Memory used by the streamed tiles of all terrains
+    size_t                      GetStreamedMemory();
+
+private:
+    friend class TerrainResource;
+
+    struct Request
+    {
+        TerrainResource const*  Terrain;
+        TerrainResource::Tile*  Target;
+        int                     Lod;
+    };
+
+    struct EvictionCandidate
+    {
+        TerrainResource const*  Terrain;
+        TerrainResource::Tile*  Target;
+        uint32_t                LastUsed;
+    };
+
+    void                        Register(TerrainResource const* terrain);
+    void                        Unregister(TerrainResource const* terrain);
+    void                        Enqueue(TerrainResource const* terrain, int lod, TerrainResource::Tile* tile);
+    uint32_t                    GetFrame() const { return m_Frame.LoadRelaxed(); }
+    void                        LoaderThread();
+
+    // Registered terrains. Held during the update, so the terrains are not destroyed meanwhile.
+    Vector<TerrainResource const*> m_Terrains;
+    Mutex                       m_TerrainsMutex;
+
+    Vector<Request>             m_Queue;
+    Mutex                       m_QueueMutex;
+    // Held while the requests are loaded, so a terrain is not destroyed in the middle of loading
+    Mutex                       m_LoadMutex;
+    SyncEvent                   m_LoaderEvent;
+    Thread                      m_Loader;
+    bool                        m_bLoaderStarted = false;
+    bool                        m_bStopLoader = false;
+
+    Atomic<uint32_t>            m_Frame{1};
+    Vector<EvictionCandidate>   m_Candidates;
 };
 
 using TerrainHandle = ResourceHandle<TerrainResource>;
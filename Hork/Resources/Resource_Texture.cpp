@@ -55,15 +55,15 @@ TextureResource::TextureResource(ImageStorage image) :
 {
 }
 
-UniqueRef<TextureResource> TextureResource::sLoad(IBinaryStreamReadInterface& stream)
+UniqueRef<TextureResource> TextureResource::sLoad(IBinaryStreamReadInterface& stream, uint32_t mipTailSize)
 {
     UniqueRef<TextureResource> resource = MakeUnique<TextureResource>();
-    if (!resource->Read(stream))
+    if (!resource->Read(stream, mipTailSize))
         return {};
     return resource;
 }
 
-bool TextureResource::Read(IBinaryStreamReadInterface& stream)
+bool TextureResource::Read(IBinaryStreamReadInterface& stream, uint32_t mipTailSize)
 {
     if (GetImageFileFormat(stream.GetName()) != IMAGE_FILE_FORMAT_UNKNOWN)
     {
@@ -80,14 +80,53 @@ bool TextureResource::Read(IBinaryStreamReadInterface& stream)
 
     uint32_t fileMagic = stream.ReadUInt32();
 
+    // Version 1 stores the image storage as is. It is always loaded entirely.
+    if (fileMagic == MakeResourceMagic(Type, 1))
+    {
+        stream.ReadObject(m_Image);
+        return true;
+    }
+
     if (fileMagic != MakeResourceMagic(Type, Version))
     {
         LOG("Unexpected file format\n");
         return false;
     }
 
-    stream.ReadObject(m_Image);
+    m_Type = (TEXTURE_TYPE)stream.ReadUInt8();
+    m_Format = (TEXTURE_FORMAT)stream.ReadUInt8();
+    m_Width = stream.ReadUInt32();
+    m_Height = stream.ReadUInt32();
+    m_Depth = stream.ReadUInt32();
+    m_NumMipmaps = stream.ReadUInt32();
+
+    if (m_Type > TEXTURE_CUBE_ARRAY || !m_Width || !m_Height || !m_Depth || !m_NumMipmaps || m_NumMipmaps > 32)
+    {
+        LOG("TextureResource::Read: invalid texture header\n");
+        return false;
+    }
+
+    m_MipSizes.Resize(m_NumMipmaps);
+    for (uint32_t& size : m_MipSizes)
+        size = stream.ReadUInt32();
+
+    m_MipDataOffset = stream.GetOffset();
+
+    // Keep only the mip tail, the larger levels are loaded on demand
+    uint32_t firstMip = 0;
+    if (mipTailSize > 0)
+    {
+        while (firstMip + 1 < m_NumMipmaps && Math::Max(m_Width >> firstMip, m_Height >> firstMip) > mipTailSize)
+            ++firstMip;
+    }
+
+    m_MipTail = firstMip;
+    m_ResidentMip = firstMip;
+
+    size_t offset, sizeInBytes;
+    GetMipChainRange(firstMip, offset, sizeInBytes);
 
+    m_MipData = stream.ReadBlob(sizeInBytes);
     return true;
 }
 
@@ -103,15 +142,59 @@ namespace AssetUtils
 
 bool CreateTexture(IBinaryStreamWriteInterface& stream, ImageStorage const& storage)
 {
+    if (!storage)
+        return false;
+
+    ImageStorageDesc const& desc = storage.GetDesc();
+
+    uint32_t depth = desc.Depth;
+    if (desc.Type == TEXTURE_CUBE)
+        depth = 1;
+    else if (desc.Type == TEXTURE_CUBE_ARRAY)
+        depth = desc.SliceCount / 6;
+
     stream.WriteUInt32(MakeResourceMagic(TextureResource::Type, TextureResource::Version));
-    stream.WriteObject(storage);
-    return true;    
+    stream.WriteUInt8(desc.Type);
+    stream.WriteUInt8(desc.Format);
+    stream.WriteUInt32(desc.Width);
+    stream.WriteUInt32(desc.Height);
+    stream.WriteUInt32(depth);
+    stream.WriteUInt32(desc.NumMipmaps);
+
+    // Each mip level is written with all its slices
+    Vector<ImageSubresource> levels(desc.NumMipmaps);
+    Vector<uint32_t> levelSizes(desc.NumMipmaps);
+    for (uint32_t mip = 0; mip < desc.NumMipmaps; ++mip)
+    {
+        ImageSubresourceDesc subresDesc;
+        subresDesc.MipmapIndex = mip;
+
+        levels[mip] = storage.GetSubresource(subresDesc);
+        levelSizes[mip] = levels[mip].GetSizeInBytes() * (desc.Type == TEXTURE_3D ? Math::Max(1u, desc.Depth >> mip) : desc.SliceCount);
+
+        stream.WriteUInt32(levelSizes[mip]);
+    }
+
+    // Store the levels from the smallest one so that any mip chain can be read by a single read
+    for (uint32_t mip = desc.NumMipmaps; mip-- > 0;)
+        stream.Write(levels[mip].GetData(), levelSizes[mip]);
+
+    return true;
 }
 
 }
 
 void TextureResource::Upload(RHI::IDevice* device)
 {
+    if (m_MipData)
+    {
+        SetResidentMips(device, m_ResidentMip, m_MipData);
+
+        // Free mip data
+        m_MipData.Reset();
+        return;
+    }
+
     if (!m_Image)
     {
         LOG("TextureResource::Upload: empty image data\n");
@@ -475,6 +558,130 @@ bool TextureResource::WriteDataCubemapArray(uint32_t locationX, uint32_t locatio
     return WriteData(locationX, locationY, arrayLayer * 6 + faceIndex, width, height, 1, mipLevel, pData);
 }
 
+uint32_t TextureResource::GetSliceCount() const
+{
+    switch (m_Type)
+    {
+        case TEXTURE_1D_ARRAY:
+        case TEXTURE_2D_ARRAY:
+            return m_Depth;
+        case TEXTURE_CUBE:
+            return 6;
+        case TEXTURE_CUBE_ARRAY:
+            return m_Depth * 6;
+        default:
+            return 1;
+    }
+}
+
+size_t TextureResource::GetMipChainSize(uint32_t firstMip) const
+{
+    size_t sizeInBytes = 0;
+    for (uint32_t mip = firstMip; mip < m_MipSizes.Size(); ++mip)
+        sizeInBytes += m_MipSizes[mip];
+    return sizeInBytes;
+}
+
+void TextureResource::GetMipChainRange(uint32_t firstMip, size_t& offset, size_t& sizeInBytes) const
+{
+    // The smallest level is stored first, so every mip chain starts at the beginning of mip data
+    offset = m_MipDataOffset;
+    sizeInBytes = GetMipChainSize(firstMip);
+}
+
+bool TextureResource::SetResidentMips(RHI::IDevice* device, uint32_t firstMip, BlobRef data)
+{
+    if (firstMip >= m_MipSizes.Size())
+    {
+        LOG("TextureResource::SetResidentMips: invalid mip level\n");
+        return false;
+    }
+
+    if (data.Size() != GetMipChainSize(firstMip))
+    {
+        LOG("TextureResource::SetResidentMips: unexpected data size\n");
+        return false;
+    }
+
+    uint32_t width = Math::Max(1u, m_Width >> firstMip);
+    uint32_t height = Math::Max(1u, m_Height >> firstMip);
+
+    RHI::TextureDesc textureDesc;
+    switch (m_Type)
+    {
+        case TEXTURE_1D:
+            textureDesc.SetResolution(RHI::TextureResolution1D(width));
+            break;
+        case TEXTURE_1D_ARRAY:
+            textureDesc.SetResolution(RHI::TextureResolution1DArray(width, m_Depth));
+            break;
+        case TEXTURE_2D:
+            textureDesc.SetResolution(RHI::TextureResolution2D(width, height));
+            break;
+        case TEXTURE_2D_ARRAY:
+            textureDesc.SetResolution(RHI::TextureResolution2DArray(width, height, m_Depth));
+            break;
+        case TEXTURE_3D:
+            textureDesc.SetResolution(RHI::TextureResolution3D(width, height, Math::Max(1u, m_Depth >> firstMip)));
+            break;
+        case TEXTURE_CUBE:
+            textureDesc.SetResolution(RHI::TextureResolutionCubemap(width));
+            break;
+        case TEXTURE_CUBE_ARRAY:
+            textureDesc.SetResolution(RHI::TextureResolutionCubemapArray(width, m_Depth));
+            break;
+        default:
+            HK_ASSERT(0);
+            return false;
+    }
+    textureDesc.SetFormat(m_Format);
+    textureDesc.SetMipLevels(m_NumMipmaps - firstMip);
+    textureDesc.SetBindFlags(RHI::BIND_SHADER_RESOURCE);
+
+    SetTextureSwizzle(m_Format, textureDesc.Swizzle);
+
+    Ref<RHI::ITexture> texture;
+    device->CreateTexture(textureDesc, &texture);
+    if (!texture)
+        return false;
+
+    // Materials pick up the new texture on the next frame
+    m_TextureGPU = texture;
+    m_ResidentMip = firstMip;
+
+    TextureFormatInfo const& info = GetTextureFormatInfo(m_Format);
+    uint32_t blockSize = info.BlockSize;
+    uint32_t sliceCount = GetSliceCount();
+
+    uint8_t const* pData = static_cast<uint8_t const*>(data.GetData());
+    for (uint32_t mip = m_NumMipmaps; mip-- > firstMip;)
+    {
+        uint32_t w = Math::Max(blockSize, m_Width >> mip);
+        uint32_t h = Math::Max(blockSize, m_Height >> mip);
+
+        if (m_Type == TEXTURE_3D)
+        {
+            WriteData(0, 0, 0, w, h, Math::Max(1u, m_Depth >> mip), mip - firstMip, pData);
+        }
+        else
+        {
+            size_t sliceSize = m_MipSizes[mip] / sliceCount;
+            for (uint32_t slice = 0; slice < sliceCount; ++slice)
+                WriteData(0, 0, slice, w, h, 1, mip - firstMip, pData + slice * sliceSize);
+        }
+
+        pData += m_MipSizes[mip];
+    }
+    return true;
+}
+
+float TextureResource::ConsumeRequestedScreenSize()
+{
+    float pixels = m_RequestedScreenSize;
+    m_RequestedScreenSize = 0;
+    return pixels;
+}
+
 void TextureResource::SetTextureGPU(RHI::ITexture* texture)
 {
     m_TextureGPU = texture;
@@ -43,16 +43,18 @@ class TextureResource : public ResourceBase
 {
 public:
     static const uint8_t        Type = RESOURCE_TEXTURE;
-    static const uint8_t        Version = 1;
+    static const uint8_t        Version = 2;
 
                                 TextureResource() = default;
     explicit                    TextureResource(ImageStorage image);
                                 ~TextureResource();
 
-    static UniqueRef<TextureResource> sLoad(IBinaryStreamReadInterface& stream);
+    static UniqueRef<TextureResource> sLoad(IBinaryStreamReadInterface& stream, uint32_t mipTailSize = 0);
     //static bool                 Write(IBinaryStreamWriteInterface& stream, ImageStorage const& storage);
 
-    bool                        Read(IBinaryStreamReadInterface& stream);
+    /// Read the texture. If mipTailSize is not zero, only the mip levels not larger than mipTailSize are read
+    /// from streamable files. The remaining levels are left to the texture streamer.
+    bool                        Read(IBinaryStreamReadInterface& stream, uint32_t mipTailSize = 0);
 
     void                        Upload(RHI::IDevice* device) override;
 
@@ -111,9 +113,45 @@ public:
     uint32_t                    GetDepth() const { return m_Depth; }
     uint32_t                    GetNumMipmaps() const { return m_NumMipmaps; }
 
+    /// Texture was read from a file that allows loading mip levels on demand
+    bool                        IsStreamable() const { return m_MipTail > 0; }
+
+    /// First mip level resident on GPU
+    uint32_t                    GetResidentMip() const { return m_ResidentMip; }
+
+    /// First mip level of the mip tail that is always resident
+    uint32_t                    GetMipTail() const { return m_MipTail; }
+
+    /// GPU memory required for the mip levels starting from firstMip
+    size_t                      GetMipChainSize(uint32_t firstMip) const;
+
+    /// File range that holds the mip levels starting from firstMip
+    void                        GetMipChainRange(uint32_t firstMip, size_t& offset, size_t& sizeInBytes) const;
+
+    /// Recreate the GPU texture with the mip levels starting from firstMip. The data is read from the range
+    /// returned by GetMipChainRange.
+    bool                        SetResidentMips(RHI::IDevice* device, uint32_t firstMip, BlobRef data);
+
+    /// Request the texture to be resident for the given on-screen size in pixels. Called by the renderer.
+    void                        RequestScreenSize(float pixels) { m_RequestedScreenSize = Math::Max(m_RequestedScreenSize, pixels); }
+
+    /// Returns the largest on-screen size requested since the last call and resets it
+    float                       ConsumeRequestedScreenSize();
+
 private:
+    uint32_t                    GetSliceCount() const;
+
     ImageStorage                m_Image;
 
+    /// Sizes of mip levels in a streamable file. The levels are stored from the smallest one,
+    /// so any resident mip chain is a contiguous range of the file.
+    Vector<uint32_t>            m_MipSizes;
+    size_t                      m_MipDataOffset = 0;
+    HeapBlob                    m_MipData;
+    uint32_t                    m_ResidentMip = 0;
+    uint32_t                    m_MipTail = 0;
+    float                       m_RequestedScreenSize = 0;
+
     Ref<RHI::ITexture>          m_TextureGPU;
     TEXTURE_TYPE                m_Type = TEXTURE_2D;
     TEXTURE_FORMAT              m_Format = TEXTURE_FORMAT_BGRA8_UNORM;
@@ -974,7 +974,12 @@ void Canvas::ConvertPaint(CanvasUniforms* frag, CanvasPaint* paint, VGScissor co
 
 RHI::ITexture* Canvas::GetTexture(CanvasPaint const* paint)
 {
-    auto* textureResource = GameApplication::sGetResourceManager().TryGet(paint->TexHandle);
+    auto& resourceManager = GameApplication::sGetResourceManager();
+
+    // Canvas does not report the on-screen size of images, keep the full mip chain
+    resourceManager.DisableTextureStreaming(paint->TexHandle.ID);
+
+    auto* textureResource = resourceManager.TryGet(paint->TexHandle);
     if (!textureResource)
     {
         return nullptr;
@@ -40,12 +40,19 @@ SOFTWARE.
 
 #include <SDL3/SDL.h>
 
+#if defined HK_OS_LINUX && !defined HK_OS_ANDROID
+#    include <execinfo.h> // backtrace_symbols
+#endif
+
 HK_NAMESPACE_BEGIN
 
 ConsoleVar com_SyncGPU("com_SyncGPU"_s, "0"_s);
 ConsoleVar com_MaxFPS("com_MaxFPS"_s, "120"_s);
 ConsoleVar com_FrameSleep("com_FrameSleep"_s, "0"_s);
 ConsoleVar in_StickDeadZone("in_StickDeadZone"_s, "0.23"_s);
+ConsoleVar com_MemoryTracker("com_MemoryTracker"_s, "0"_s, 0, "Record every Nth allocation and log the callstacks allocating most often. 0 disables the tracker"_s);
+ConsoleVar com_MemoryTrackerReportFrames("com_MemoryTrackerReportFrames"_s, "300"_s, 0, "Number of frames between the allocation tracker reports"_s);
+ConsoleVar com_MemoryTrackerReportSites("com_MemoryTrackerReportSites"_s, "10"_s, 0, "Number of callstacks in the allocation tracker report"_s);
 
 FrameLoop::FrameLoop(RHI::IDevice* renderDevice) :
     m_FrameMemory(Allocators::FrameMemoryAllocator::sGetAllocator()),
@@ -114,6 +121,8 @@ void FrameLoop::NewFrame(ArrayView<RHI::ISwapChain*> swapChains, int swapInterva
 
     MemoryHeap::sMemoryNewFrame();
 
+    UpdateMemoryTracker();
+
     m_GPUSync->SetEvent();
 
     // Swap buffers for streamed memory
@@ -180,6 +189,87 @@ void FrameLoop::NewFrame(ArrayView<RHI::ISwapChain*> swapChains, int swapInterva
     m_FrameMemory.ResetAndMerge();
 }
 
+void FrameLoop::UpdateMemoryTracker()
+{
+    uint32_t sampleInterval = Math::Max(0, com_MemoryTracker.GetInteger());
+    if (m_TrackerSampleInterval != sampleInterval)
+    {
+        m_TrackerSampleInterval = sampleInterval;
+        m_TrackerFrames = 0;
+        m_AllocationSites.Clear();
+
+        MemoryTracker::sDisable();
+        if (sampleInterval)
+            MemoryTracker::sEnable(sampleInterval);
+    }
+
+    if (!m_TrackerSampleInterval)
+        return;
+
+    // Drain the ring every frame so it does not overflow
+    MemoryTrackerRecord records[64];
+    size_t count;
+    while ((count = MemoryTracker::sRead(records, HK_ARRAY_SIZE(records))) > 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            MemoryTrackerRecord const& record = records[i];
+
+            uint32_t hash = record.Heap;
+            for (uint32_t n = 0; n < record.CallstackDepth; n++)
+                hash = HashTraits::Murmur3Hash64(uint64_t(record.Callstack[n]), hash);
+
+            AllocationSite& site = m_AllocationSites[hash];
+            if (site.Count == 0)
+            {
+                site.CallstackDepth = record.CallstackDepth;
+                Core::Memcpy(site.Callstack, record.Callstack, record.CallstackDepth * sizeof(void*));
+            }
+            site.Count++;
+            site.SizeInBytes += record.Size;
+        }
+    }
+
+    if (++m_TrackerFrames < Math::Max(1, com_MemoryTrackerReportFrames.GetInteger()))
+        return;
+
+    Vector<AllocationSite const*> sites;
+    sites.Reserve(m_AllocationSites.Size());
+    for (auto& it : m_AllocationSites)
+        sites.Add(&it.second);
+
+    std::sort(sites.Begin(), sites.End(), [](AllocationSite const* a, AllocationSite const* b)
+    {
+        return a->Count > b->Count;
+    });
+
+    LOG("Allocation tracker: {} frames, sample interval {}, {} records dropped\n", m_TrackerFrames, m_TrackerSampleInterval, MemoryTracker::sGetDroppedCount());
+
+    int numSites = Math::Min<int>(sites.Size(), Math::Max(0, com_MemoryTrackerReportSites.GetInteger()));
+    for (int i = 0; i < numSites; i++)
+    {
+        AllocationSite const* site = sites[i];
+
+        LOG("{} allocations, {} bytes:\n", site->Count, site->SizeInBytes);
+
+#if defined HK_OS_LINUX && !defined HK_OS_ANDROID
+        if (char** symbols = backtrace_symbols(site->Callstack, site->CallstackDepth))
+        {
+            for (uint32_t n = 0; n < site->CallstackDepth; n++)
+                LOG("    {}\n", symbols[n]);
+            free(symbols);
+            continue;
+        }
+#endif
+        // Addresses are resolved offline with the debug symbols of the executable
+        for (uint32_t n = 0; n < site->CallstackDepth; n++)
+            LOG("    {}\n", site->Callstack[n]);
+    }
+
+    m_TrackerFrames = 0;
+    m_AllocationSites.Clear();
+}
+
 static const VirtualKey InvalidKey = VirtualKey(0xffff);
 
 struct KeyMappingsSDL : public Array<VirtualKey, SDL_NUM_SCANCODES>
@@ -906,11 +996,11 @@ void FrameLoop::PollEvents(IEventListener* listener)
 
             // A new audio device is available
             case SDL_EVENT_AUDIO_DEVICE_ADDED:
-                LOG("Audio {} device added: {}\n", event.adevice.recording ? "recording" : "playback", SDL_GetAudioDeviceName(event.adevice.which));
+                LOG(LogChannel::Audio, "Audio {} device added: {}\n", event.adevice.recording ? "recording" : "playback", SDL_GetAudioDeviceName(event.adevice.which));
                 break;
             // An audio device has been removed
             case SDL_EVENT_AUDIO_DEVICE_REMOVED:
-                LOG("Audio {} device removed: {}\n", event.adevice.recording ? "recording" : "playback", SDL_GetAudioDeviceName(event.adevice.which));
+                LOG(LogChannel::Audio, "Audio {} device removed: {}\n", event.adevice.recording ? "recording" : "playback", SDL_GetAudioDeviceName(event.adevice.which));
                 break;
 
             // A sensor was updated
@@ -166,6 +166,17 @@ public:
     StreamedMemoryGPU* GetStreamedMemoryGPU() { return m_StreamedMemoryGPU.RawPtr(); }
 
 private:
+    /// Applies com_MemoryTracker and drains the recorded allocations
+    void            UpdateMemoryTracker();
+
+    struct AllocationSite
+    {
+        uint32_t        Count{};
+        size_t          SizeInBytes{};
+        uint32_t        CallstackDepth{};
+        void*           Callstack[MemoryTrackerRecord::MaxCallstackDepth]{};
+    };
+
     int64_t             m_FrameTimeStamp;
     int64_t             m_FrameDuration;
     int                 m_FrameNumber;
@@ -180,6 +191,10 @@ private:
 
     HashMap<int, int>   m_GamepadIDToPlayerIndex;
 
+    HashMap<uint32_t, AllocationSite> m_AllocationSites;
+    uint32_t            m_TrackerSampleInterval = 0;
+    int                 m_TrackerFrames = 0;
+
     bool                m_ShouldGenerateInputEvents{true};
 };
 
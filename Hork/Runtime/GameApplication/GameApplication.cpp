@@ -38,8 +38,10 @@ SOFTWARE.
 #include <Hork/RHI/CreateDevice.h>
 #include <Hork/ShaderUtils/ShaderCompiler.h>
 #include <Hork/Audio/AudioMixer.h>
+#include <Hork/Audio/AudioVoiceManager.h>
 #include <Hork/Runtime/World/World.h>
 #include <Hork/Runtime/World/Modules/Physics/PhysicsModule.h>
+#include <Hork/Runtime/World/Modules/Audio/AudioInterface.h>
 #include <Hork/Runtime/Renderer/WorldRenderer.h>
 #include <Hork/Resources/Resource_Sound.h>
 
@@ -72,6 +74,8 @@ ConsoleVar rt_SwapInterval("rt_SwapInterval"_s, "0"_s, 0, "1 - enable vsync, 0 -
 enum
 {
     RENDER_FRONTEND_JOB_LIST,
+    RENDER_BACKEND_JOB_LIST,
+    AUDIO_MIXER_JOB_LIST,
     MAX_RUNTIME_JOB_LISTS
 };
 
@@ -266,8 +270,10 @@ GameApplication::GameApplication(ArgumentPack const& args, ApplicationDesc const
     m_RenderFrontendJobList = m_AsyncJobManager->GetAsyncJobList(RENDER_FRONTEND_JOB_LIST);
 
     ShaderCompiler::sInitialize();
+    if (!sArgs().Has("-noShaderCache"))
+        ShaderCompiler::sSetCacheDirectory(m_ApplicationLocalData / "ShaderCache");
 
-    CreateLogicalDevice("OpenGL 4.5", &m_RenderDevice);
+    CreateLogicalDevice(sArgs().Has("-nullrhi") ? "Null" : "OpenGL 4.5", &m_RenderDevice);
 
     CreateMainWindowAndSwapChain();
 
@@ -283,10 +289,12 @@ GameApplication::GameApplication(ArgumentPack const& args, ApplicationDesc const
 
     SoundResource::SetDecoderProperties(m_AudioDevice->GetSampleRate(), m_AudioDevice->IsStereo());
 
-    m_AudioMixer = MakeUnique<AudioMixer>(m_AudioDevice);
+    m_AudioMixer = MakeUnique<AudioMixer>(m_AudioDevice, m_AsyncJobManager->GetAsyncJobList(AUDIO_MIXER_JOB_LIST));
     m_AudioMixer->StartAsync();
 
-    m_RenderBackend = MakeUnique<RenderBackend>(m_RenderDevice);
+    m_AudioVoiceManager = MakeUnique<AudioVoiceManager>();
+
+    m_RenderBackend = MakeUnique<RenderBackend>(m_RenderDevice, m_AsyncJobManager->GetAsyncJobList(RENDER_BACKEND_JOB_LIST));
 
     m_Renderer = MakeUnique<WorldRenderer>();
 
@@ -328,6 +336,7 @@ GameApplication::~GameApplication()
 
     m_RenderBackend.Reset();
 
+    m_AudioVoiceManager.Reset();
     m_AudioMixer.Reset();
     m_AudioDevice.Reset();
     
@@ -398,10 +407,19 @@ void GameApplication::RunMainLoop()
         // Tick state
         m_StateMachine.Update(m_FrameDurationInSeconds);
 
-        // Tick worlds
+        // Tick worlds. Each world adds its playing tracks to the shared voice budget.
+        m_AudioVoiceManager->Clear();
         for (auto* world : m_Worlds)
             world->Tick(m_FrameDurationInSeconds);
 
+        // Cull the voices over the budget before the new tracks are submitted
+        m_AudioVoiceManager->Update();
+        for (auto* world : m_Worlds)
+        {
+            if (AudioInterface* audio = world->TryGetInterface<AudioInterface>())
+                audio->SubmitTracks();
+        }
+
         // Update audio
         if (!m_AudioMixer->IsAsync())
             m_AudioMixer->Update();
@@ -446,7 +464,7 @@ void GameApplication::ShowStats()
         StreamedMemoryGPU* streamedMemory = m_FrameLoop->GetStreamedMemoryGPU();
 
         const float y_step = 14;
-        const int numLines = 13;
+        const int numLines = 15;
 
         Float2 pos(8, 8);
 
@@ -495,6 +513,11 @@ void GameApplication::ShowStats()
         m_Canvas->DrawText(fontStyle, pos, Color4::sWhite(), sb.Sprintf("Frontend time: %d msec", stat.FrontendTime), true);
         pos.Y += y_step;
         m_Canvas->DrawText(fontStyle, pos, Color4::sWhite(), sb.Sprintf("Audio channels: %d active, %d virtual", m_AudioMixer->GetNumActiveTracks(), m_AudioMixer->GetNumVirtualTracks()), true);
+        pos.Y += y_step;
+
+        m_Canvas->DrawText(fontStyle, pos, Color4::sWhite(), sb.Sprintf("Audio voices: %d real, %d virtual (limit %d)", m_AudioVoiceManager->GetNumRealVoices(), m_AudioVoiceManager->GetNumVirtualVoices(), Snd_MaxVoices.GetInteger()), true);
+        pos.Y += y_step;
+        m_Canvas->DrawText(fontStyle, pos, Color4::sWhite(), sb.Sprintf("Audio streams: %d, underruns %d", m_AudioMixer->GetNumStreams(), m_AudioMixer->GetNumStreamUnderruns()), true);
     }
 
     if (com_ShowFPS)
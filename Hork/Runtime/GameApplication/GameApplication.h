@@ -49,6 +49,7 @@ class AsyncJobManager;
 class AsyncJobList;
 class AudioDevice;
 class AudioMixer;
+class AudioVoiceManager;
 class WorldRenderer;
 
 class ApplicationDesc
@@ -180,6 +181,12 @@ public:
         return static_cast<GameApplication*>(sInstance())->m_AudioMixer.RawPtr();
     }
 
+    /// Voice budget shared by all worlds
+    static AudioVoiceManager& sGetAudioVoiceManager()
+    {
+        return *static_cast<GameApplication*>(sInstance())->m_AudioVoiceManager.RawPtr();
+    }
+
     static WorldRenderer& sGetRenderer()
     {
         return *static_cast<GameApplication*>(sInstance())->m_Renderer.RawPtr();
@@ -246,6 +253,7 @@ private:
     UniqueRef<RenderBackend>        m_RenderBackend;
     Ref<AudioDevice>                m_AudioDevice;
     UniqueRef<AudioMixer>           m_AudioMixer;
+    UniqueRef<AudioVoiceManager>    m_AudioVoiceManager;
     InputSystem                     m_InputSystem;
     CommandProcessor                m_CommandProcessor;
     CommandContext                  m_CommandContext;
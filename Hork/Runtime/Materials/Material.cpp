@@ -129,4 +129,16 @@ MaterialFrameData* Material::PreRender(int frameNumber)
     return m_FrameData;
 }
 
+void Material::RequestTextureScreenSize(float pixels)
+{
+    for (TextureHandle texHandle : m_Textures)
+    {
+        if (!texHandle)
+            continue;
+
+        if (TextureResource* texture = GameApplication::sGetResourceManager().TryGet(texHandle))
+            texture->RequestScreenSize(pixels);
+    }
+}
+
 HK_NAMESPACE_END
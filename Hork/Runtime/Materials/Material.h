@@ -93,6 +93,9 @@ public:
 
     MaterialFrameData*      PreRender(int frameNumber);
 
+    /// Pass the on-screen size of a surface using the material to the texture streamer
+    void                    RequestTextureScreenSize(float pixels);
+
 private:
     String                  m_Name;
     MaterialHandle          m_Resource;
@@ -54,6 +54,8 @@ ConsoleVar r_MotionBlur("r_MotionBlur"_s, "1"_s);
 ConsoleVar r_RenderMeshes("r_RenderMeshes"_s, "1"_s, CVAR_CHEAT);
 ConsoleVar r_RenderTerrain("r_RenderTerrain"_s, "1"_s, CVAR_CHEAT);
 ConsoleVar r_Brightness("r_Brightness"_s, "1"_s);
+ConsoleVar r_MeshLodPixelError("r_MeshLodPixelError"_s, "1"_s);
+ConsoleVar r_InstanceBatching("r_InstanceBatching"_s, "1"_s);
 
 extern ConsoleVar r_HBAO;
 extern ConsoleVar r_HBAODeinterleaved;
@@ -104,6 +106,7 @@ void WorldRenderer::Render(FrameLoop* frameLoop)
     }
 
     SortRenderInstances();
+    BatchRenderInstances();
 
     if (m_DebugDraw.CommandsCount() > 0)
     {
@@ -452,6 +455,35 @@ constexpr bool IsPunctualLight<PunctualLightComponent>()
     return true;
 }
 
+float WorldRenderer::CalcMeshLodMaxError(BvAxisAlignedBox const& worldBounds, Float3x4 const& transform) const
+{
+    // Negative error disables LODs
+    if (m_LodErrorScale <= 0)
+        return -1;
+
+    Float3 scale = transform.DecomposeScale();
+    float maxScale = Math::Max3(scale.X, scale.Y, scale.Z);
+    if (maxScale <= 0)
+        return -1;
+
+    float distance = 1;
+    if (m_View->bPerspective)
+        distance = Math::Max(worldBounds.Center().Dist(m_View->ViewPosition) - worldBounds.Radius(), m_View->ViewZNear);
+
+    return distance / (maxScale * m_LodErrorScale);
+}
+
+float WorldRenderer::CalcScreenSize(BvAxisAlignedBox const& worldBounds) const
+{
+    float radius = worldBounds.Radius();
+
+    float distance = 1;
+    if (m_View->bPerspective)
+        distance = Math::Max(worldBounds.Center().Dist(m_View->ViewPosition) - radius, m_View->ViewZNear);
+
+    return 2 * radius * m_ScreenSizeScale / distance;
+}
+
 template <typename MeshComponentType>
 void WorldRenderer::AddMeshes()
 {
@@ -484,6 +516,9 @@ void WorldRenderer::AddMeshes()
 
         if (auto* meshResource = GameApplication::sGetResourceManager().TryGet(mesh.GetMesh()))
         {
+            float lodMaxError = CalcMeshLodMaxError(mesh.GetWorldBoundingBox(), mesh.GetRenderTransform());
+            float screenSize = CalcScreenSize(mesh.GetWorldBoundingBox());
+
             int surfaceCount = meshResource->GetSurfaceCount();
             for (int surfaceIndex = 0; surfaceIndex < surfaceCount; ++surfaceIndex)
             {
@@ -498,6 +533,8 @@ void WorldRenderer::AddMeshes()
                 MaterialFrameData* materialInstanceFrameData = materialInstance->PreRender(m_FrameNumber);
                 if (!materialInstanceFrameData)
                     continue;
+
+                materialInstance->RequestTextureScreenSize(screenSize);
             
                 // Add render instance
                 RenderInstance* instance = (RenderInstance*)m_FrameLoop->AllocFrameMem(sizeof(RenderInstance));
@@ -589,14 +626,24 @@ void WorldRenderer::AddMeshes()
                     }
                 }
 
-                instance->IndexCount = surface.IndexCount;
-                instance->StartIndexLocation = surface.FirstIndex;
+                if (auto* lod = surface.SelectLod(lodMaxError))
+                {
+                    instance->IndexCount = lod->IndexCount;
+                    instance->StartIndexLocation = lod->FirstIndex;
+                }
+                else
+                {
+                    instance->IndexCount = surface.IndexCount;
+                    instance->StartIndexLocation = surface.FirstIndex;
+                }
                 instance->BaseVertexLocation = surface.BaseVertex; // + mesh.SurfaceBaseVertexOffset;
                 instance->SkeletonOffset = skeletonOffset;
                 instance->SkeletonOffsetMB = skeletonOffsetMB;
                 instance->SkeletonSize = skeletonSize;
 
                 instance->bPerObjectMotionBlur = IsDynamicMesh<MeshComponentType>();
+                instance->BatchInstanceCount = 1;
+                instance->BatchStreamHandle = 0;
 
                 uint8_t priority = material->GetRenderingPriority();
                 if constexpr (IsDynamicMesh<MeshComponentType>())
@@ -625,6 +672,8 @@ void WorldRenderer::AddMeshes()
             if (!materialInstanceFrameData)
                 continue;
 
+            materialInstance->RequestTextureScreenSize(CalcScreenSize(mesh.GetWorldBoundingBox()));
+
             // Add render instance
             RenderInstance* instance = (RenderInstance*)m_FrameLoop->AllocFrameMem(sizeof(RenderInstance));
 
@@ -668,6 +717,8 @@ void WorldRenderer::AddMeshes()
             instance->ModelNormalToViewSpace = modelNormalToViewSpace;
 
             instance->bPerObjectMotionBlur = IsDynamicMesh<MeshComponentType>();
+            instance->BatchInstanceCount = 1;
+            instance->BatchStreamHandle = 0;
 
             uint8_t priority = material->GetRenderingPriority();
             if constexpr (IsDynamicMesh<MeshComponentType>())
@@ -715,6 +766,9 @@ void WorldRenderer::AddMeshesShadow(LightShadowmap* shadowMap, BvAxisAlignedBox
         auto* meshResource = GameApplication::sGetResourceManager().TryGet(mesh.GetMesh());
         if (meshResource)
         {
+            // LODs are selected by the camera view so that shadows match the visible geometry
+            float lodMaxError = CalcMeshLodMaxError(mesh.GetWorldBoundingBox(), instanceMatrix);
+
             int surfaceCount = meshResource->GetSurfaceCount();
             for (int surfaceIndex = 0; surfaceIndex < surfaceCount; ++surfaceIndex)
             {
@@ -772,12 +826,22 @@ void WorldRenderer::AddMeshesShadow(LightShadowmap* shadowMap, BvAxisAlignedBox
                     }
                 }
 
-                instance->IndexCount = surface.IndexCount;
-                instance->StartIndexLocation = surface.FirstIndex;
+                if (auto* lod = surface.SelectLod(lodMaxError))
+                {
+                    instance->IndexCount = lod->IndexCount;
+                    instance->StartIndexLocation = lod->FirstIndex;
+                }
+                else
+                {
+                    instance->IndexCount = surface.IndexCount;
+                    instance->StartIndexLocation = surface.FirstIndex;
+                }
                 instance->BaseVertexLocation = surface.BaseVertex; // + mesh.SurfaceBaseVertexOffset;
                 instance->SkeletonOffset = skeletonOffset;
                 instance->SkeletonSize = skeletonSize;
                 instance->CascadeMask = 0xffff;//mesh.m_CascadeMask; // TODO
+                instance->BatchInstanceCount = 1;
+                instance->BatchStreamHandle = 0;
 
                 uint8_t priority = material->GetRenderingPriority();
 
@@ -828,6 +892,8 @@ void WorldRenderer::AddMeshesShadow(LightShadowmap* shadowMap, BvAxisAlignedBox
             instance->SkeletonSize = 0;
             instance->WorldTransformMatrix = instanceMatrix;
             instance->CascadeMask = 0xffff; //mesh.m_CascadeMask; // TODO
+            instance->BatchInstanceCount = 1;
+            instance->BatchStreamHandle = 0;
 
             uint8_t priority = material->GetRenderingPriority();
 
@@ -977,6 +1043,13 @@ void WorldRenderer::RenderView(WorldRenderView* worldRenderView, RenderViewData*
     worldRenderView->m_ViewMatrix = view->ViewMatrix;
     worldRenderView->m_ProjectionMatrix = view->ProjectionMatrix;
 
+    // Pixels covered by a unit of mesh LOD error at unit distance (perspective) or at any distance (ortho)
+    float lodPixelError = r_MeshLodPixelError.GetFloat();
+    m_LodErrorScale = lodPixelError > 0 ? view->ProjectionMatrix[1][1] * 0.5f * view->Height / lodPixelError : 0;
+
+    // Pixels covered by a unit of length at unit distance (perspective) or at any distance (ortho)
+    m_ScreenSizeScale = view->ProjectionMatrix[1][1] * 0.5f * view->Height;
+
     view->ViewProjection        = view->ProjectionMatrix * view->ViewMatrix;
     view->ViewProjectionP       = view->ProjectionMatrixP * view->ViewMatrixP;
     view->ViewSpaceToWorldSpace = view->ViewMatrix.ViewInverseFast();
@@ -1305,6 +1378,7 @@ void WorldRenderer::RenderView(WorldRenderView* worldRenderView, RenderViewData*
 
         AddDirectionalLightShadows(&shadowMap, lightDef);
         SortShadowInstances(&shadowMap);
+        BatchShadowInstances(&shadowMap);
     }
 
     m_LightVoxelizer.Reset();
@@ -1469,6 +1543,135 @@ void WorldRenderer::SortShadowInstances(LightShadowmap const* shadowMap)
               shadowInstanceSortFunction);
 }
 
+namespace
+{
+
+    bool CanBatch(RenderInstance const* instance)
+    {
+        return instance->Material->SupportsInstancing &&
+            instance->SkeletonSize == 0 &&
+            !instance->bPerObjectMotionBlur &&
+            !instance->Lightmap &&
+            !instance->LightmapUVChannel &&
+            !instance->VertexLightChannel;
+    }
+
+    bool CanBatch(ShadowRenderInstance const* instance)
+    {
+        return instance->Material &&
+            instance->Material->SupportsInstancing &&
+            instance->SkeletonSize == 0;
+    }
+
+    template <typename T>
+    bool IsSameSurface(T const* a, T const* b)
+    {
+        return a->Material == b->Material &&
+            a->MaterialInstance == b->MaterialInstance &&
+            a->VertexBuffer == b->VertexBuffer &&
+            a->VertexBufferOffset == b->VertexBufferOffset &&
+            a->IndexBuffer == b->IndexBuffer &&
+            a->IndexBufferOffset == b->IndexBufferOffset &&
+            a->IndexCount == b->IndexCount &&
+            a->StartIndexLocation == b->StartIndexLocation &&
+            a->BaseVertexLocation == b->BaseVertexLocation;
+    }
+
+}
+
+void WorldRenderer::BatchRenderInstances()
+{
+    if (!r_InstanceBatching)
+        return;
+
+    StreamedMemoryGPU* streamedMemory = m_FrameLoop->GetStreamedMemoryGPU();
+
+    for (RenderViewData* view = m_FrameData.RenderViews; view < &m_FrameData.RenderViews[m_FrameData.NumViews]; view++)
+    {
+        RenderInstance** instances = m_FrameData.Instances.ToPtr() + view->FirstInstance;
+
+        int i = 0;
+        while (i < view->InstanceCount)
+        {
+            RenderInstance* first = instances[i];
+
+            int count = 1;
+            if (CanBatch(first))
+            {
+                while (i + count < view->InstanceCount && IsSameSurface(first, instances[i + count]) && CanBatch(instances[i + count]))
+                    count++;
+            }
+
+            if (count > 1)
+            {
+                first->BatchInstanceCount = count;
+                first->BatchStreamHandle = streamedMemory->AllocateStorage(sizeof(InstanceTransform) * count);
+
+                InstanceTransform* transforms = (InstanceTransform*)streamedMemory->Map(first->BatchStreamHandle);
+                for (int n = 0; n < count; n++)
+                {
+                    RenderInstance* instance = instances[i + n];
+
+                    Float3x3 normalToViewSpace = instance->ModelNormalToViewSpace.Transposed();
+
+                    transforms[n].TransformMatrix = instance->Matrix;
+                    transforms[n].TransformMatrixP = instance->MatrixP;
+                    transforms[n].ModelNormalToViewSpace = Float3x4(Float4(normalToViewSpace[0], 0.0f),
+                                                                    Float4(normalToViewSpace[1], 0.0f),
+                                                                    Float4(normalToViewSpace[2], 0.0f));
+                    if (n > 0)
+                        instance->BatchInstanceCount = 0;
+                }
+            }
+
+            i += count;
+        }
+    }
+}
+
+void WorldRenderer::BatchShadowInstances(LightShadowmap const* shadowMap)
+{
+    if (!r_InstanceBatching)
+        return;
+
+    StreamedMemoryGPU* streamedMemory = m_FrameLoop->GetStreamedMemoryGPU();
+
+    ShadowRenderInstance** instances = m_FrameData.ShadowInstances.ToPtr() + shadowMap->FirstShadowInstance;
+
+    int i = 0;
+    while (i < shadowMap->ShadowInstanceCount)
+    {
+        ShadowRenderInstance* first = instances[i];
+
+        int count = 1;
+        if (CanBatch(first))
+        {
+            while (i + count < shadowMap->ShadowInstanceCount && IsSameSurface(first, instances[i + count]) && CanBatch(instances[i + count]) &&
+                   instances[i + count]->CascadeMask == first->CascadeMask)
+                count++;
+        }
+
+        if (count > 1)
+        {
+            first->BatchInstanceCount = count;
+            first->BatchStreamHandle = streamedMemory->AllocateStorage(sizeof(Float4x4) * count);
+
+            Float4x4* transforms = (Float4x4*)streamedMemory->Map(first->BatchStreamHandle);
+            for (int n = 0; n < count; n++)
+            {
+                ShadowRenderInstance* instance = instances[i + n];
+
+                transforms[n] = Float4x4(instance->WorldTransformMatrix).Transposed();
+
+                if (n > 0)
+                    instance->BatchInstanceCount = 0;
+            }
+        }
+
+        i += count;
+    }
+}
+
 void WorldRenderer::QueryVisiblePrimitives(World* world)
 {
     VisibilityQuery query;
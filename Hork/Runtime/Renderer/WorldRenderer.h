@@ -66,6 +66,10 @@ private:
     void                        RenderView(WorldRenderView* worldRenderView, RenderViewData* view);
     void                        SortRenderInstances();
     void                        SortShadowInstances(LightShadowmap const* shadowMap);
+    /// Merge adjacent opaque instances of the same surface and material into instanced draw calls
+    void                        BatchRenderInstances();
+    /// Merge adjacent shadow casters of the same surface and material into instanced draw calls
+    void                        BatchShadowInstances(LightShadowmap const* shadowMap);
     void                        QueryVisiblePrimitives(World* world);
     void                        QueryShadowCasters(World* world, Float4x4 const& lightViewProjection, Float3 const& lightPosition, Float3x3 const& lightBasis, Vector<PrimitiveDef*>& primitives);
     void                        AddShadowmapCascades(class DirectionalLightComponent const& light, Float3x3 const& rotationMat, StreamedMemoryGPU* streamedMemory, RenderViewData* view, size_t* viewProjStreamHandle, int* pFirstCascade, int* pNumCascades);
@@ -76,6 +80,10 @@ private:
     template <typename MeshComponentType, typename LightComponentType>
     void                        AddMeshesShadow(LightShadowmap* shadowMap, BvAxisAlignedBox const& lightBounds={});
     bool                        AddLightShadowmap(class PunctualLightComponent* light, float radius);
+    /// Allowed mesh LOD error in mesh units for the current view
+    float                       CalcMeshLodMaxError(BvAxisAlignedBox const& worldBounds, Float3x4 const& transform) const;
+    /// Approximate on-screen diameter of the bounds in pixels
+    float                       CalcScreenSize(BvAxisAlignedBox const& worldBounds) const;
 
     Vector<Ref<WorldRenderView>>m_RenderViews;
     FrameLoop*                  m_FrameLoop;
@@ -94,6 +102,8 @@ private:
     //struct alignas(16) CullResult { int32_t Result[4]; };
     //Vector<CullResult>          m_ShadowCasterCullResult;
     LightVoxelizer              m_LightVoxelizer;
+    float                       m_LodErrorScale = 0;
+    float                       m_ScreenSizeScale = 0;
 };
 
 HK_NAMESPACE_END
@@ -31,6 +31,7 @@ SOFTWARE.
 #include "ResourceManager.h"
 
 #include <Hork/Resources/Resource_Animation.h>
+#include <Hork/Resources/Resource_Collision.h>
 #include <Hork/Resources/Resource_Mesh.h>
 #include <Hork/Resources/Resource_Material.h>
 #include <Hork/Resources/Resource_Texture.h>
@@ -40,11 +41,16 @@ SOFTWARE.
 #include <Hork/Runtime/GameApplication/GameApplication.h>
 
 #include <Hork/Core/CoreApplication.h>
+#include <Hork/Core/ConsoleVar.h>
 #include <Hork/Core/Platform.h>
 #include <Hork/Core/Profiler.h>
 
 HK_NAMESPACE_BEGIN
 
+ConsoleVar r_TextureStreamingMipTail("r_TextureStreamingMipTail"_s, "256"_s, 0, "Largest mip level loaded with a streamable texture. 0 disables texture streaming"_s);
+ConsoleVar com_TerrainTileCacheSize("com_TerrainTileCacheSize"_s, "64"_s, 0, "Memory budget of streamed terrain tiles in megabytes"_s);
+ConsoleVar r_TextureStreamingBudget("r_TextureStreamingBudget"_s, "512"_s, 0, "GPU memory budget for streamable textures in megabytes"_s);
+
 struct ResourceArea
 {
     ResourceAreaID      m_Id{};
@@ -197,7 +203,7 @@ ResourceProxy* ResourceManager::FindResource(StringView resourcePath)
     return &GetProxy(resource);
 }
 
-UniqueRef<ResourceBase> ResourceManager::LoadResourceAsync(RESOURCE_TYPE type, StringView name)
+UniqueRef<ResourceBase> ResourceManager::LoadResourceAsync(RESOURCE_TYPE type, StringView name, uint32_t mipTail)
 {
     auto n = name.FindCharacter('#');
     if (n != -1)
@@ -214,13 +220,15 @@ UniqueRef<ResourceBase> ResourceManager::LoadResourceAsync(RESOURCE_TYPE type, S
         case RESOURCE_ANIMATION:
             return AnimationResource::sLoad(f);
         case RESOURCE_TEXTURE:
-            return TextureResource::sLoad(f);
+            return TextureResource::sLoad(f, mipTail);
         case RESOURCE_MATERIAL:
             return MaterialResource::sLoad(f);
+        case RESOURCE_COLLISION:
+            return CollisionResource::sLoad(f);
         case RESOURCE_SOUND:
             return SoundResource::sLoad(f);
         case RESOURCE_TERRAIN:
-            return TerrainResource::sLoad(f);
+            return TerrainResource::sLoad(std::move(f), m_TerrainStreamer);
         default:
             break;
     }
@@ -228,19 +236,42 @@ UniqueRef<ResourceBase> ResourceManager::LoadResourceAsync(RESOURCE_TYPE type, S
     return {};
 }
 
+ResourceManager::MipStreamResult ResourceManager::LoadMipsAsync(TextureStreamer::Request const& request)
+{
+    MipStreamResult result;
+    result.Request = request;
+
+    StringView name = GetProxy(request.Resource).GetName();
+    auto n = name.FindCharacter('#');
+    if (n != -1)
+        name = name.GetSubstring(0, n);
+
+    File f = OpenFile(name);
+    if (f && f.SeekSet(request.FileOffset) && f.SizeInBytes() >= request.FileOffset + request.SizeInBytes)
+        result.Data = f.ReadBlob(request.SizeInBytes);
+
+    return result;
+}
+
 void ResourceManager::UpdateAsync()
 {
     while (m_RunAsync.Load())
     {
         ResourceID resource = m_StreamQueue.Dequeue();
+        TextureStreamer::Request mipRequest;
         if (resource)
         {
             auto& proxy = GetProxy(resource);
-            proxy.m_Resource = LoadResourceAsync(RESOURCE_TYPE(resource.GetType()), proxy.GetName());
+            proxy.m_Resource = LoadResourceAsync(RESOURCE_TYPE(resource.GetType()), proxy.GetName(), proxy.m_LoadMipTail);
 
             m_ProcessingQueue.Push(resource);
             m_ProcessingQueueEvent.Signal();
         }
+        else if (m_MipStreamQueue.TryPop(mipRequest))
+        {
+            // Mip levels are streamed when there are no resources waiting for loading
+            m_MipStreamResults.Push(LoadMipsAsync(mipRequest));
+        }
         else
         {
             //LOG("Sleep\n");
@@ -272,6 +303,19 @@ void ResourceManager::MainThread_Update(float timeBudget)
 
             // Upload resource to gpu
             proxy.Upload(GameApplication::sGetRenderDevice());
+
+            if (resource.GetType() == RESOURCE_TEXTURE)
+            {
+                auto* texture = static_cast<TextureResource*>(proxy.m_Resource.RawPtr());
+                if (texture->IsStreamable())
+                {
+                    m_TextureStreamer.Register(resource, texture);
+
+                    // Streaming was disabled while the texture was loading
+                    if (proxy.m_bNoTextureStreaming)
+                        m_TextureStreamer.SetPinned(resource, true);
+                }
+            }
         }
         else
         {
@@ -302,6 +346,37 @@ void ResourceManager::MainThread_Update(float timeBudget)
         else
             it++;
     }
+
+    UpdateTextureStreaming();
+
+    m_TerrainStreamer.Update(size_t(Math::Max(0, com_TerrainTileCacheSize.GetInteger())) << 20);
+}
+
+void ResourceManager::UpdateTextureStreaming()
+{
+    HK_PROFILER_EVENT("ResourceManager::UpdateTextureStreaming");
+
+    RHI::IDevice* device = GameApplication::sGetRenderDevice();
+
+    MipStreamResult result;
+    while (m_MipStreamResults.TryPop(result))
+    {
+        if (result.Data)
+            m_TextureStreamer.Complete(device, result.Request, result.Data);
+        else
+            m_TextureStreamer.Cancel(result.Request);
+    }
+
+    m_TextureStreamer.SetBudget(size_t(Math::Max(0, r_TextureStreamingBudget.GetInteger())) << 20);
+
+    m_MipRequests.Clear();
+    m_TextureStreamer.Update(m_MipRequests);
+
+    for (TextureStreamer::Request const& request : m_MipRequests)
+        m_MipStreamQueue.Push(request);
+
+    if (!m_MipRequests.IsEmpty())
+        m_StreamQueueEvent.Signal();
 }
 
 namespace
@@ -439,11 +514,9 @@ void ResourceManager::ExecuteCommands()
                 {
                     if (proxy.m_State != RESOURCE_STATE_LOAD)
                     {
-                        m_StreamQueue.Enqueue(resource);
+                        EnqueueResource(resource, proxy);
                         signal = true;
 
-                        proxy.m_State = RESOURCE_STATE_LOAD;
-
                         //LOG("Enqueued {} {}\n", resource, proxy.GetName());
                     }
                 }
@@ -490,6 +563,7 @@ void ResourceManager::ExecuteCommands()
             case RESOURCE_STATE_READY:
             case RESOURCE_STATE_INVALID:
             {
+                UnregisterStreaming(resource);
                 proxy.Purge();
                 proxy.m_State = RESOURCE_STATE_FREE;
 
@@ -499,11 +573,9 @@ void ResourceManager::ExecuteCommands()
             }
             case RESOURCE_STATE_FREE:
             {
-                m_StreamQueue.Enqueue(resource);
+                EnqueueResource(resource, proxy);
                 signal = true;
 
-                proxy.m_State = RESOURCE_STATE_LOAD;
-
                 break;
             }
         }
@@ -513,12 +585,21 @@ void ResourceManager::ExecuteCommands()
         m_StreamQueueEvent.Signal();
 }
 
+void ResourceManager::EnqueueResource(ResourceID resource, ResourceProxy& proxy)
+{
+    proxy.m_LoadMipTail = proxy.m_bNoTextureStreaming ? 0 : Math::Max(0, r_TextureStreamingMipTail.GetInteger());
+    proxy.m_State = RESOURCE_STATE_LOAD;
+
+    m_StreamQueue.Enqueue(resource);
+}
+
 void ResourceManager::ReleaseResource(ResourceID resource)
 {
     ResourceProxy& proxy = GetProxy(resource);
 
     HK_ASSERT(proxy.m_State != RESOURCE_STATE_LOAD);
 
+    UnregisterStreaming(resource);
     proxy.Purge();
     proxy.m_State = RESOURCE_STATE_FREE;
 
@@ -538,9 +619,31 @@ void ResourceManager::PurgeResourceData(ResourceID resource)
         return;
     }
 
+    UnregisterStreaming(resource);
     proxy.Purge();
 }
 
+void ResourceManager::UnregisterStreaming(ResourceID resource)
+{
+    if (resource.GetType() == RESOURCE_TEXTURE)
+        m_TextureStreamer.Unregister(resource);
+}
+
+void ResourceManager::DisableTextureStreaming(ResourceID resource)
+{
+    if (!resource || resource.GetType() != RESOURCE_TEXTURE)
+        return;
+
+    auto& proxy = GetProxy(resource);
+    if (proxy.m_bNoTextureStreaming)
+        return;
+
+    proxy.m_bNoTextureStreaming = true;
+
+    // The texture already loaded with the mip tail streams in the rest of the chain
+    m_TextureStreamer.SetPinned(resource, true);
+}
+
 void ResourceManager::IncrementAreas(ResourceProxy& proxy)
 {
     for (auto* area : proxy.m_Areas)
@@ -36,7 +36,9 @@ SOFTWARE.
 #include <Hork/Core/Containers/Hash.h>
 
 #include <Hork/Resources/ResourceHandle.h>
+#include <Hork/Resources/Resource_Terrain.h>
 #include "ResourceProxy.h"
+#include "TextureStreamer.h"
 
 #include "ThreadSafeQueue.h"
 
@@ -121,6 +123,12 @@ public:
 
     File                    OpenFile(StringView path);
 
+    TextureStreamer&        GetTextureStreamer() { return m_TextureStreamer; }
+
+    /// Keeps the full mip chain of the texture resident. Must be called by the users that do not report
+    /// the on-screen size of the texture (canvas, color grading). Can be called only from main thread.
+    void                    DisableTextureStreaming(ResourceID resource);
+
 private:
     struct Command
     {
@@ -141,7 +149,20 @@ private:
 
     void                    UpdateAsync();
 
-    UniqueRef<ResourceBase> LoadResourceAsync(RESOURCE_TYPE type, StringView name);
+    UniqueRef<ResourceBase> LoadResourceAsync(RESOURCE_TYPE type, StringView name, uint32_t mipTail);
+
+    /// Marks the resource as being loaded
+    void                    EnqueueResource(ResourceID resource, ResourceProxy& proxy);
+
+    struct MipStreamResult
+    {
+        TextureStreamer::Request Request;
+        HeapBlob            Data;
+    };
+
+    MipStreamResult         LoadMipsAsync(TextureStreamer::Request const& request);
+
+    void                    UpdateTextureStreaming();
 
     /// Find file in resource packs
     bool                    FindFile(StringView fileName, int* pResourcePackIndex, FileHandle* pFileHandle) const;
@@ -156,9 +177,15 @@ private:
 
     void                    ReleaseResource(ResourceID resource);
 
+    /// Stops texture streaming for the resource before its data is purged or replaced
+    void                    UnregisterStreaming(ResourceID resource);
+
     void                    IncrementAreas(ResourceProxy& proxy);
     void                    DecrementAreas(ResourceProxy& proxy);
 
+    // Declared before the resources, so it is destroyed after the terrains
+    TerrainStreamer         m_TerrainStreamer;
+
     using ResourceList = PagedVector<ResourceProxy, 1024, 1024>;
     ResourceList            m_ResourceList;
     StringHashMap<ResourceID> m_ResourceHash;
@@ -189,6 +216,11 @@ private:
     SyncEvent               m_StreamQueueEvent;
     SyncEvent               m_ProcessingQueueEvent;
 
+    TextureStreamer         m_TextureStreamer;
+    ThreadSafeQueue<TextureStreamer::Request> m_MipStreamQueue;
+    ThreadSafeQueue<MipStreamResult> m_MipStreamResults;
+    Vector<TextureStreamer::Request> m_MipRequests;
+
     Vector<ResourceArea*>   m_ResourceAreas;
     Vector<uint32_t>        m_ResourceAreaFreeList;
     Mutex                   m_ResourceAreaAllocMutex;
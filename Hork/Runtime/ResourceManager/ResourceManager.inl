@@ -61,6 +61,8 @@ ResourceHandle<T> ResourceManager::CreateResourceWithData(StringView name, Uniqu
         return {};
     }
 
+    UnregisterStreaming(resource);
+
     proxy.m_Resource = std::move(resourceData);
     proxy.m_State = RESOURCE_STATE_READY;
     proxy.m_Flags = RESOURCE_FLAG_PROCEDURAL;
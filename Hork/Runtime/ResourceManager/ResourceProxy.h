@@ -122,6 +122,12 @@ private:
     RESOURCE_STATE m_State{RESOURCE_STATE_FREE};
 
     RESOURCE_FLAGS m_Flags{};
+
+    // Texture is used outside of materials and must keep the full mip chain. Updated by resource manager in main thread.
+    bool m_bNoTextureStreaming{};
+
+    // Largest mip level loaded with a streamable texture. Set by resource manager in main thread before the resource is queued for loading.
+    uint32_t m_LoadMipTail{};
 };
 
 HK_NAMESPACE_END
@@ -0,0 +1,270 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+#include "TextureStreamer.h"
+
+#include <Hork/Resources/Resource_Texture.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+/// Finest mip level that is not smaller than the on-screen size. Assumes the texture is mapped once across the object.
+uint32_t CalcWantedMip(TextureResource const* texture, float pixels)
+{
+    uint32_t maxDim = Math::Max(texture->GetWidth(), texture->GetHeight());
+    uint32_t mip = 0;
+    while (mip < texture->GetMipTail() && float(maxDim >> (mip + 1)) >= pixels)
+        ++mip;
+    return mip;
+}
+
+} // namespace
+
+void TextureStreamer::Register(ResourceID resource, TextureResource* texture)
+{
+    HK_ASSERT(texture->IsStreamable());
+
+    Entry* entry;
+
+    auto it = m_EntryIndex.Find(resource);
+    if (it != m_EntryIndex.End())
+    {
+        entry = &m_Entries[it->second];
+        m_MemoryUsage -= entry->Texture->GetMipChainSize(entry->TargetMip);
+    }
+    else
+    {
+        m_EntryIndex[resource] = m_Entries.Size();
+        entry = &m_Entries.Add();
+    }
+
+    entry->Resource = resource;
+    entry->Texture = texture;
+    entry->WantedMip = texture->GetMipTail();
+    entry->TargetMip = texture->GetResidentMip();
+    entry->Serial = ++m_Serial;
+    entry->bPending = false;
+    entry->bPinned = false;
+    entry->LastUsedFrame = m_Frame;
+
+    m_MemoryUsage += texture->GetMipChainSize(entry->TargetMip);
+}
+
+void TextureStreamer::Unregister(ResourceID resource)
+{
+    auto it = m_EntryIndex.Find(resource);
+    if (it == m_EntryIndex.End())
+        return;
+
+    uint32_t index = it->second;
+    m_EntryIndex.Erase(it);
+
+    Entry& entry = m_Entries[index];
+    m_MemoryUsage -= entry.Texture->GetMipChainSize(entry.TargetMip);
+
+    if (index != m_Entries.Size() - 1)
+    {
+        entry = m_Entries.Last();
+        m_EntryIndex[entry.Resource] = index;
+    }
+    m_Entries.RemoveLast();
+}
+
+void TextureStreamer::SetPinned(ResourceID resource, bool pinned)
+{
+    auto it = m_EntryIndex.Find(resource);
+    if (it != m_EntryIndex.End())
+        m_Entries[it->second].bPinned = pinned;
+}
+
+bool TextureStreamer::IsPinned(ResourceID resource) const
+{
+    auto it = m_EntryIndex.Find(resource);
+    return it != m_EntryIndex.End() && m_Entries[it->second].bPinned;
+}
+
+TextureStreamer::Entry* TextureStreamer::FindEntry(Request const& request)
+{
+    auto it = m_EntryIndex.Find(request.Resource);
+    if (it == m_EntryIndex.End())
+        return nullptr;
+
+    Entry& entry = m_Entries[it->second];
+    if (!entry.bPending || entry.Serial != request.Serial)
+        return nullptr;
+
+    return &entry;
+}
+
+void TextureStreamer::AddRequest(Entry& entry, uint32_t firstMip, Vector<Request>& requests)
+{
+    m_MemoryUsage -= entry.Texture->GetMipChainSize(entry.TargetMip);
+    m_MemoryUsage += entry.Texture->GetMipChainSize(firstMip);
+
+    entry.TargetMip = firstMip;
+    entry.Serial = ++m_Serial;
+    entry.bPending = true;
+
+    Request& request = requests.Add();
+    request.Resource = entry.Resource;
+    request.FirstMip = firstMip;
+    request.Serial = entry.Serial;
+    entry.Texture->GetMipChainRange(firstMip, request.FileOffset, request.SizeInBytes);
+}
+
+void TextureStreamer::Update(Vector<Request>& requests)
+{
+    ++m_Frame;
+
+    m_StreamIn.Clear();
+    m_StreamOut.Clear();
+
+    for (uint32_t i = 0, count = m_Entries.Size(); i < count; ++i)
+    {
+        Entry& entry = m_Entries[i];
+
+        float pixels = entry.Texture->ConsumeRequestedScreenSize();
+        if (entry.bPinned)
+        {
+            entry.WantedMip = 0;
+            entry.LastUsedFrame = m_Frame;
+        }
+        else if (pixels > 0)
+        {
+            entry.WantedMip = CalcWantedMip(entry.Texture, pixels);
+            entry.LastUsedFrame = m_Frame;
+        }
+
+        if (entry.bPending)
+            continue;
+
+        // Textures drawn this frame keep the wanted detail, the others can drop down to the mip tail
+        bool bUsed = entry.LastUsedFrame == m_Frame;
+        if (bUsed && entry.WantedMip < entry.TargetMip)
+            m_StreamIn.Add(i);
+        else if (entry.TargetMip < (bUsed ? entry.WantedMip : entry.Texture->GetMipTail()))
+            m_StreamOut.Add(i);
+    }
+
+    // Stream in the pinned textures and then the largest detail deficit first
+    std::sort(m_StreamIn.begin(), m_StreamIn.end(), [this](uint32_t a, uint32_t b)
+              {
+                  Entry const& entryA = m_Entries[a];
+                  Entry const& entryB = m_Entries[b];
+                  if (entryA.bPinned != entryB.bPinned)
+                      return entryA.bPinned;
+                  return entryA.TargetMip - entryA.WantedMip > entryB.TargetMip - entryB.WantedMip;
+              });
+
+    // Stream out the least recently used textures first
+    std::sort(m_StreamOut.begin(), m_StreamOut.end(), [this](uint32_t a, uint32_t b)
+              { return m_Entries[a].LastUsedFrame < m_Entries[b].LastUsedFrame; });
+
+    uint32_t numRequests = 0;
+    uint32_t streamOutIndex = 0;
+
+    auto streamOut = [&]()
+    {
+        if (streamOutIndex >= m_StreamOut.Size() || numRequests >= m_MaxRequestsPerUpdate)
+            return false;
+
+        Entry& entry = m_Entries[m_StreamOut[streamOutIndex++]];
+        AddRequest(entry, entry.LastUsedFrame == m_Frame ? entry.WantedMip : entry.Texture->GetMipTail(), requests);
+        ++numRequests;
+        return true;
+    };
+
+    for (uint32_t index : m_StreamIn)
+    {
+        if (numRequests >= m_MaxRequestsPerUpdate)
+            break;
+
+        Entry& entry = m_Entries[index];
+        size_t residentSize = entry.Texture->GetMipChainSize(entry.TargetMip);
+
+        // Make room by streaming out other textures, fall back to coarser levels if the budget is still exceeded
+        uint32_t mip = entry.WantedMip;
+        for (; mip < entry.TargetMip; ++mip)
+        {
+            size_t extraSize = entry.Texture->GetMipChainSize(mip) - residentSize;
+            while (m_MemoryUsage + extraSize > m_Budget && streamOut())
+            {}
+            if (m_MemoryUsage + extraSize <= m_Budget || entry.bPinned)
+                break;
+        }
+
+        if (mip < entry.TargetMip && numRequests < m_MaxRequestsPerUpdate)
+        {
+            AddRequest(entry, mip, requests);
+            ++numRequests;
+        }
+    }
+
+    // Budget can be exceeded by the mip tails or when it was reduced
+    while (m_MemoryUsage > m_Budget && streamOut())
+    {}
+}
+
+bool TextureStreamer::Complete(RHI::IDevice* device, Request const& request, BlobRef data)
+{
+    Entry* entry = FindEntry(request);
+    if (!entry)
+        return false;
+
+    entry->bPending = false;
+
+    if (!entry->Texture->SetResidentMips(device, request.FirstMip, data))
+    {
+        Cancel(request);
+        return false;
+    }
+    return true;
+}
+
+void TextureStreamer::Cancel(Request const& request)
+{
+    auto it = m_EntryIndex.Find(request.Resource);
+    if (it == m_EntryIndex.End())
+        return;
+
+    Entry& entry = m_Entries[it->second];
+    if (entry.Serial != request.Serial)
+        return;
+
+    m_MemoryUsage -= entry.Texture->GetMipChainSize(entry.TargetMip);
+
+    entry.TargetMip = entry.Texture->GetResidentMip();
+    entry.bPending = false;
+
+    m_MemoryUsage += entry.Texture->GetMipChainSize(entry.TargetMip);
+}
+
+HK_NAMESPACE_END
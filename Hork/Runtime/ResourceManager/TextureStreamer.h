@@ -0,0 +1,125 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+#pragma once
+
+#include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/Containers/Hash.h>
+#include <Hork/Core/HeapBlob.h>
+#include <Hork/Resources/ResourceID.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace RHI
+{
+class IDevice;
+}
+
+class TextureResource;
+
+/// Decides which mip levels of streamable textures stay resident on GPU. Textures keep their mip tail
+/// all the time, larger levels are streamed in by the on-screen size requested by the renderer and
+/// streamed out from the least recently used textures when the memory budget is exceeded.
+/// The streamer does not perform IO itself: it returns file ranges to be loaded and applies the loaded data.
+class TextureStreamer final : public Noncopyable
+{
+public:
+    struct Request
+    {
+        ResourceID          Resource;
+        uint32_t            FirstMip = 0;
+        uint32_t            Serial = 0;
+        size_t              FileOffset = 0;
+        size_t              SizeInBytes = 0;
+    };
+
+    /// GPU memory budget for the streamable textures in bytes
+    void                    SetBudget(size_t budget) { m_Budget = budget; }
+    size_t                  GetBudget() const { return m_Budget; }
+
+    /// Limits the number of requests issued per update
+    void                    SetMaxRequestsPerUpdate(uint32_t maxRequests) { m_MaxRequestsPerUpdate = maxRequests; }
+
+    /// Starts tracking a streamable texture. Registering a resource again resets its state.
+    void                    Register(ResourceID resource, TextureResource* texture);
+
+    /// Stops tracking the texture. Must be called before the texture is destroyed.
+    void                    Unregister(ResourceID resource);
+
+    /// Pinned textures stream in the full mip chain regardless of the requested size and budget and are never streamed out.
+    /// Used for textures drawn without reporting the on-screen size.
+    void                    SetPinned(ResourceID resource, bool pinned);
+
+    bool                    IsPinned(ResourceID resource) const;
+
+    /// Gathers the on-screen sizes requested since the last update and plans the residency changes.
+    /// The requests to load the mip chains are added to the list.
+    void                    Update(Vector<Request>& requests);
+
+    /// Applies the loaded mip chain. Returns false if the request is outdated or the data is invalid.
+    bool                    Complete(RHI::IDevice* device, Request const& request, BlobRef data);
+
+    /// Discards the request that could not be loaded
+    void                    Cancel(Request const& request);
+
+    /// GPU memory of the resident and pending mip chains
+    size_t                  GetMemoryUsage() const { return m_MemoryUsage; }
+
+    uint32_t                GetTextureCount() const { return m_Entries.Size(); }
+
+private:
+    struct Entry
+    {
+        ResourceID          Resource;
+        TextureResource*    Texture{};
+        /// Mip level wanted by the renderer
+        uint32_t            WantedMip{};
+        /// Resident mip level or the level being loaded
+        uint32_t            TargetMip{};
+        uint32_t            Serial{};
+        bool                bPending{};
+        bool                bPinned{};
+        uint64_t            LastUsedFrame{};
+    };
+
+    Entry*                  FindEntry(Request const& request);
+    void                    AddRequest(Entry& entry, uint32_t firstMip, Vector<Request>& requests);
+
+    Vector<Entry>           m_Entries;
+    HashMap<ResourceID, uint32_t> m_EntryIndex;
+    Vector<uint32_t>        m_StreamIn;
+    Vector<uint32_t>        m_StreamOut;
+    size_t                  m_Budget = 512u << 20;
+    size_t                  m_MemoryUsage = 0;
+    uint32_t                m_MaxRequestsPerUpdate = 8;
+    uint32_t                m_Serial = 0;
+    uint64_t                m_Frame = 0;
+};
+
+HK_NAMESPACE_END
@@ -46,6 +46,12 @@ public:
         m_Data.push(v);
     }
 
+    void Push(T&& v)
+    {
+        MutexGuard lock(m_Mutex);
+        m_Data.push(std::move(v));
+    }
+
     bool TryPop(T& v)
     {
         MutexGuard lock(m_Mutex);
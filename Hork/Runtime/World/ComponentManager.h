@@ -45,6 +45,7 @@ class DebugRenderer;
 class ComponentManagerBase : public Noncopyable
 {
     friend class World;
+    friend class WorldSnapshot;
 
 public:
     ComponentTypeID         GetComponentTypeID() const;
@@ -59,6 +60,11 @@ public:
     virtual Component*      GetComponent(ComponentHandle handle) = 0;
     virtual Component*      GetComponentUnsafe(ComponentHandle handle) = 0;
 
+    /// Component state serialization used by prefabs and world snapshots.
+    /// Forwards to ComponentType::Read / ComponentType::Write.
+    virtual void            ReadComponent(Component* component, IBinaryStreamReadInterface& stream) = 0;
+    virtual void            WriteComponent(Component const* component, IBinaryStreamWriteInterface& stream) const = 0;
+
     World*                  GetWorld();
     World const*            GetWorld() const;
 
@@ -72,6 +78,7 @@ protected:
     void                    RegisterDebugDrawFunction(Delegate<void(DebugRenderer& renderer)> const& function);
 
     virtual ComponentHandle ConstructComponent(Component*& component) = 0;
+    virtual void            ReserveComponents(uint32_t count) = 0;
     virtual void            DestructComponent(ComponentHandle handle, Component*& movedComponent) = 0;
 
     void                    InitializeComponent(Component* component);
@@ -111,6 +118,9 @@ public:
     virtual Component*      GetComponent(ComponentHandle handle) override;
     virtual Component*      GetComponentUnsafe(ComponentHandle handle) override;
 
+    virtual void            ReadComponent(Component* component, IBinaryStreamReadInterface& stream) override;
+    virtual void            WriteComponent(Component const* component, IBinaryStreamWriteInterface& stream) const override;
+
     ComponentType*          GetComponent(Handle32<ComponentType> handle);
 
     ComponentType*          GetComponentUnsafe(Handle32<ComponentType> handle);
@@ -133,6 +143,7 @@ private:
     explicit                ComponentManager(World* world);
 
     virtual ComponentHandle ConstructComponent(Component*& component) override;
+    virtual void            ReserveComponents(uint32_t count) override;
     virtual void            DestructComponent(ComponentHandle handle, Component*& movedComponent) override;
 
     virtual void            SubscribeEvents(Component* component) override;
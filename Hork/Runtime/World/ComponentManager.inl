@@ -83,6 +83,8 @@ HK_FIND_METHOD(OnEndOverlap)
 HK_FIND_METHOD(OnBeginContact)
 HK_FIND_METHOD(OnUpdateContact)
 HK_FIND_METHOD(OnEndContact)
+HK_FIND_METHOD(Read)
+HK_FIND_METHOD(Write)
 
 template <typename ComponentType>
 HK_FORCEINLINE ComponentManager<ComponentType>::ComponentManager(World* world) :
@@ -221,6 +223,24 @@ HK_FORCEINLINE Component* ComponentManager<ComponentType>::GetComponentUnsafe(Co
     return GetComponentUnsafe(Handle32<ComponentType>(handle));
 }
 
+template <typename ComponentType>
+HK_FORCEINLINE void ComponentManager<ComponentType>::ReadComponent(Component* component, IBinaryStreamReadInterface& stream)
+{
+    if constexpr (HK_HAS_METHOD(ComponentType, Read))
+        static_cast<ComponentType*>(component)->Read(stream);
+    else
+        HK_ASSERT_(0, "Component does not implement Read");
+}
+
+template <typename ComponentType>
+HK_FORCEINLINE void ComponentManager<ComponentType>::WriteComponent(Component const* component, IBinaryStreamWriteInterface& stream) const
+{
+    if constexpr (HK_HAS_METHOD(ComponentType, Write))
+        static_cast<ComponentType const*>(component)->Write(stream);
+    else
+        HK_ASSERT_(0, "Component does not implement Write");
+}
+
 template <typename ComponentType>
 HK_FORCEINLINE ComponentType* ComponentManager<ComponentType>::GetComponent(Handle32<ComponentType> handle)
 {
@@ -274,6 +294,12 @@ HK_FORCEINLINE ComponentHandle ComponentManager<ComponentType>::ConstructCompone
     return static_cast<ComponentHandle>(handle);
 }
 
+template <typename ComponentType>
+HK_FORCEINLINE void ComponentManager<ComponentType>::ReserveComponents(uint32_t count)
+{
+    m_ComponentStorage.Reserve(m_ComponentStorage.Size() + count);
+}
+
 template <typename ComponentType>
 HK_FORCEINLINE void ComponentManager<ComponentType>::DestructComponent(ComponentHandle handle, Component*& movedComponent)
 {
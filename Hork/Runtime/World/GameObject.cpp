@@ -74,7 +74,8 @@ void GameObject::SetDynamic(bool dynamic)
 
 void GameObject::SetLockWorldPositionAndRotation(bool lock)
 {
-    m_TransformData->LockWorldPositionAndRotation = lock;
+    uint8_t& flags = m_TransformLevel->Flags[m_TransformIndex];
+    flags = lock ? (flags | TransformHierarchyLevel::LOCK_WORLD_POSITION_AND_ROTATION) : (flags & ~TransformHierarchyLevel::LOCK_WORLD_POSITION_AND_ROTATION);
 }
 
 void GameObject::AddComponent(Component* component)
@@ -164,7 +165,8 @@ void GameObject::LinkToParent()
         parent->m_LastChild = m_Handle;
         parent->m_ChildCount++;
 
-        m_TransformData->Parent = parent->m_TransformData;
+        m_TransformLevel->Parent[m_TransformIndex] = parent->GetTransformRef();
+        MarkTransformDirty();
     }
 }
 
@@ -187,7 +189,8 @@ void GameObject::UnlinkFromParent()
         parent->m_ChildCount--;
         m_Parent = {};
 
-        m_TransformData->Parent = nullptr;
+        m_TransformLevel->Parent[m_TransformIndex] = TransformHierarchyLevel::NoParent;
+        MarkTransformDirty();
     }
 }
 
@@ -210,14 +213,17 @@ void GameObject::ChildIterator::operator++()
 
 void GameObject::UpdateWorldTransform()
 {
-    m_TransformData->UpdateWorldTransform_r();
+    if (GameObject* parent = GetParent())
+        parent->UpdateWorldTransform();
+
+    ComputeWorldTransform();
 }
 
 void GameObject::UpdateChildrenWorldTransform()
 {
     for (auto it = GetChildren(); it.IsValid(); ++it)
     {
-        it->m_TransformData->UpdateWorldTransform();
+        it->ComputeWorldTransform();
         it->UpdateChildrenWorldTransform();
     }
 }
@@ -35,6 +35,7 @@ SOFTWARE.
 
 #include "Component.h"
 #include "ComponentManager.h"
+#include "TransformHierarchy.h"
 
 HK_NAMESPACE_BEGIN
 
@@ -58,6 +59,7 @@ class GameObject final
 {
     friend class World;
     friend class ComponentManagerBase;
+    friend class WorldSnapshot;
     friend class ObjectStorage<GameObject, 64, ObjectStorageType::Compact, HEAP_WORLD_OBJECTS>;
 
 public:
@@ -240,6 +242,15 @@ private:
     void                    LinkToParent();
     void                    UnlinkFromParent();
 
+    void                    MarkTransformDirty();
+    void                    UpdateWorldTransformMatrix();
+
+    /// Update the world transform from the parent world transform. The parent must be up to date.
+    void                    ComputeWorldTransform();
+
+    /// Parent reference in the transform hierarchy stream
+    uint32_t                GetTransformRef() const;
+
     GameObjectHandle        m_Handle;
 
     union
@@ -262,32 +273,8 @@ private:
     uint16_t                m_ChildCount = 0;
     uint16_t                m_HierarchyLevel = 0;
 
-    struct TransformData
-    {
-        GameObject*         Owner{};
-        TransformData*      Parent{};
-        bool                LockWorldPositionAndRotation{};
-        bool                AbsolutePosition{};
-        bool                AbsoluteRotation{};
-        bool                AbsoluteScale{};
-
-        Float3              Position;
-        Quat                Rotation;
-        Float3              Scale = Float3(1.0f);
-
-        Float3              WorldPosition;
-        Quat                WorldRotation;
-        Float3              WorldScale = Float3(1.0f);
-        Float3x4            WorldTransform;
-
-        void                UpdateWorldTransformMatrix();
-
-        void                UpdateWorldTransform_r();
-
-        void                UpdateWorldTransform();
-    };
-
-    TransformData*          m_TransformData{};
+    TransformHierarchyLevel* m_TransformLevel{};
+    uint32_t                m_TransformIndex{};
 
     ComponentVector         m_Components;
 
@@ -41,7 +41,8 @@ HK_FORCEINLINE GameObject::GameObject(GameObject&& rhs) :
     m_PrevSibling(rhs.m_PrevSibling),
     m_ChildCount(rhs.m_ChildCount),
     m_HierarchyLevel(rhs.m_HierarchyLevel),
-    m_TransformData(rhs.m_TransformData),
+    m_TransformLevel(rhs.m_TransformLevel),
+    m_TransformIndex(rhs.m_TransformIndex),
     m_Components(std::move(rhs.m_Components)),
     m_Name(rhs.m_Name)
 {
@@ -52,7 +53,9 @@ HK_FORCEINLINE GameObject::GameObject(GameObject&& rhs) :
     for (auto component : m_Components)
         component->m_Owner = this;
 
-    m_TransformData->Owner = this;
+    // Transform is released before the object is destroyed
+    if (m_TransformLevel)
+        m_TransformLevel->Owner[m_TransformIndex] = this;
 }
 
 HK_FORCEINLINE GameObjectHandle GameObject::GetHandle() const
@@ -166,42 +169,45 @@ HK_FORCEINLINE bool GameObject::ConstChildIterator::IsValid() const
 
 HK_FORCEINLINE void GameObject::SetPosition(Float3 const& position)
 {
-    m_TransformData->Position = position;
+    m_TransformLevel->Position[m_TransformIndex] = position;
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetRotation(Quat const& rotation)
 {
-    m_TransformData->Rotation = rotation;
+    m_TransformLevel->Rotation[m_TransformIndex] = rotation;
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetScale(Float3 const& scale)
 {
-    m_TransformData->Scale = scale;
+    m_TransformLevel->Scale[m_TransformIndex] = scale;
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetPositionAndRotation(Float3 const& position, Quat const& rotation)
 {
-    m_TransformData->Position = position;
-    m_TransformData->Rotation = rotation;
+    m_TransformLevel->Position[m_TransformIndex] = position;
+    m_TransformLevel->Rotation[m_TransformIndex] = rotation;
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetTransform(Float3 const& position, Quat const& rotation, Float3 const& scale)
 {
-    m_TransformData->Position = position;
-    m_TransformData->Rotation = rotation;
-    m_TransformData->Scale = scale;
+    m_TransformLevel->Position[m_TransformIndex] = position;
+    m_TransformLevel->Rotation[m_TransformIndex] = rotation;
+    m_TransformLevel->Scale[m_TransformIndex] = scale;
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetTransform(Transform const& transform)
 {
-    m_TransformData->Position = transform.Position;
-    m_TransformData->Rotation = transform.Rotation;
-    m_TransformData->Scale = transform.Scale;
+    SetTransform(transform.Position, transform.Rotation, transform.Scale);
 }
 
 HK_FORCEINLINE void GameObject::SetAngles(Angl const& angles)
 {
-    m_TransformData->Rotation = angles.ToQuat();
+    SetRotation(angles.ToQuat());
 }
 
 HK_FORCEINLINE void GameObject::SetDirection(Float3 const& direction)
@@ -211,86 +217,118 @@ HK_FORCEINLINE void GameObject::SetDirection(Float3 const& direction)
 
 HK_FORCEINLINE void GameObject::SetWorldPosition(Float3 const& position)
 {
-    m_TransformData->WorldPosition = position;
-    m_TransformData->UpdateWorldTransformMatrix();
+    auto& transform = *m_TransformLevel;
+    uint32_t index = m_TransformIndex;
 
-    if (m_TransformData->Parent && !m_TransformData->AbsolutePosition)
+    transform.WorldPosition[index] = position;
+    transform.UpdateWorldTransformMatrix(index);
+
+    GameObject* parent = GetParent();
+    if (parent && !(transform.Flags[index] & TransformHierarchyLevel::ABSOLUTE_POSITION))
     {
-        m_TransformData->Position = m_TransformData->Parent->WorldTransform.Inversed() * position;
+        transform.Position[index] = parent->GetWorldTransformMatrix().Inversed() * position;
     }
     else
     {
-        m_TransformData->Position = position;
+        transform.Position[index] = position;
     }
+
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetWorldRotation(Quat const& rotation)
 {
-    m_TransformData->WorldRotation = rotation;
-    m_TransformData->UpdateWorldTransformMatrix();
+    auto& transform = *m_TransformLevel;
+    uint32_t index = m_TransformIndex;
+
+    transform.WorldRotation[index] = rotation;
+    transform.UpdateWorldTransformMatrix(index);
 
-    if (m_TransformData->Parent && !m_TransformData->AbsoluteRotation)
+    GameObject* parent = GetParent();
+    if (parent && !(transform.Flags[index] & TransformHierarchyLevel::ABSOLUTE_ROTATION))
     {
-        m_TransformData->Rotation = m_TransformData->Parent->WorldRotation.Inversed() * rotation;
+        transform.Rotation[index] = parent->GetWorldRotation().Inversed() * rotation;
     }
     else
     {
-        m_TransformData->Rotation = rotation;
+        transform.Rotation[index] = rotation;
     }
+
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetWorldScale(Float3 const& scale)
 {
-    m_TransformData->WorldScale = scale;
-    m_TransformData->UpdateWorldTransformMatrix();
+    auto& transform = *m_TransformLevel;
+    uint32_t index = m_TransformIndex;
+
+    transform.WorldScale[index] = scale;
+    transform.UpdateWorldTransformMatrix(index);
 
-    if (m_TransformData->Parent && !m_TransformData->AbsoluteScale)
+    GameObject* parent = GetParent();
+    if (parent && !(transform.Flags[index] & TransformHierarchyLevel::ABSOLUTE_SCALE))
     {
-        m_TransformData->Scale = scale / m_TransformData->Parent->WorldScale;
+        transform.Scale[index] = scale / parent->GetWorldScale();
     }
     else
     {
-        m_TransformData->Scale = scale;
+        transform.Scale[index] = scale;
     }
+
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetWorldPositionAndRotation(Float3 const& position, Quat const& rotation)
 {
-    m_TransformData->WorldPosition = position;
-    m_TransformData->WorldRotation = rotation;
-    m_TransformData->UpdateWorldTransformMatrix();
+    auto& transform = *m_TransformLevel;
+    uint32_t index = m_TransformIndex;
 
-    if (m_TransformData->Parent)
+    transform.WorldPosition[index] = position;
+    transform.WorldRotation[index] = rotation;
+    transform.UpdateWorldTransformMatrix(index);
+
+    if (GameObject* parent = GetParent())
     {
-        m_TransformData->Position = m_TransformData->AbsolutePosition ? position : m_TransformData->Parent->WorldTransform.Inversed() * position;
-        m_TransformData->Rotation = m_TransformData->AbsoluteRotation ? rotation : m_TransformData->Parent->WorldRotation.Inversed() * rotation;
+        uint8_t flags = transform.Flags[index];
+
+        transform.Position[index] = (flags & TransformHierarchyLevel::ABSOLUTE_POSITION) ? position : parent->GetWorldTransformMatrix().Inversed() * position;
+        transform.Rotation[index] = (flags & TransformHierarchyLevel::ABSOLUTE_ROTATION) ? rotation : parent->GetWorldRotation().Inversed() * rotation;
     }
     else
     {
-        m_TransformData->Position = position;
-        m_TransformData->Rotation = rotation;
+        transform.Position[index] = position;
+        transform.Rotation[index] = rotation;
     }
+
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetWorldTransform(Float3 const& position, Quat const& rotation, Float3 const& scale)
 {
-    m_TransformData->WorldPosition = position;
-    m_TransformData->WorldRotation = rotation;
-    m_TransformData->WorldScale    = scale;
-    m_TransformData->UpdateWorldTransformMatrix();
+    auto& transform = *m_TransformLevel;
+    uint32_t index = m_TransformIndex;
 
-    if (m_TransformData->Parent)
+    transform.WorldPosition[index] = position;
+    transform.WorldRotation[index] = rotation;
+    transform.WorldScale[index]    = scale;
+    transform.UpdateWorldTransformMatrix(index);
+
+    if (GameObject* parent = GetParent())
     {
-        m_TransformData->Position = m_TransformData->AbsolutePosition ? position : m_TransformData->Parent->WorldTransform.Inversed() * position;
-        m_TransformData->Rotation = m_TransformData->AbsoluteRotation ? rotation : m_TransformData->Parent->WorldRotation.Inversed() * rotation;
-        m_TransformData->Scale    = m_TransformData->AbsoluteScale    ? scale    : scale / m_TransformData->Parent->WorldScale;
+        uint8_t flags = transform.Flags[index];
+
+        transform.Position[index] = (flags & TransformHierarchyLevel::ABSOLUTE_POSITION) ? position : parent->GetWorldTransformMatrix().Inversed() * position;
+        transform.Rotation[index] = (flags & TransformHierarchyLevel::ABSOLUTE_ROTATION) ? rotation : parent->GetWorldRotation().Inversed() * rotation;
+        transform.Scale[index]    = (flags & TransformHierarchyLevel::ABSOLUTE_SCALE)    ? scale    : scale / parent->GetWorldScale();
     }
     else
     {
-        m_TransformData->Position = position;
-        m_TransformData->Rotation = rotation;
-        m_TransformData->Scale    = scale;
+        transform.Position[index] = position;
+        transform.Rotation[index] = rotation;
+        transform.Scale[index]    = scale;
     }
+
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::SetWorldTransform(Transform const& transform)
@@ -310,77 +348,83 @@ HK_FORCEINLINE void GameObject::SetWorldDirection(Float3 const& direction)
 
 HK_FORCEINLINE void GameObject::SetAbsolutePosition(bool absolutePosition)
 {
-    m_TransformData->AbsolutePosition = absolutePosition;
+    uint8_t& flags = m_TransformLevel->Flags[m_TransformIndex];
+    flags = absolutePosition ? (flags | TransformHierarchyLevel::ABSOLUTE_POSITION) : (flags & ~TransformHierarchyLevel::ABSOLUTE_POSITION);
+    flags |= TransformHierarchyLevel::DIRTY;
 }
 
 HK_FORCEINLINE void GameObject::SetAbsoluteRotation(bool absoluteRotation)
 {
-    m_TransformData->AbsoluteRotation = absoluteRotation;
+    uint8_t& flags = m_TransformLevel->Flags[m_TransformIndex];
+    flags = absoluteRotation ? (flags | TransformHierarchyLevel::ABSOLUTE_ROTATION) : (flags & ~TransformHierarchyLevel::ABSOLUTE_ROTATION);
+    flags |= TransformHierarchyLevel::DIRTY;
 }
 
 HK_FORCEINLINE void GameObject::SetAbsoluteScale(bool absoluteScale)
 {
-    m_TransformData->AbsoluteScale = absoluteScale;
+    uint8_t& flags = m_TransformLevel->Flags[m_TransformIndex];
+    flags = absoluteScale ? (flags | TransformHierarchyLevel::ABSOLUTE_SCALE) : (flags & ~TransformHierarchyLevel::ABSOLUTE_SCALE);
+    flags |= TransformHierarchyLevel::DIRTY;
 }
 
 HK_FORCEINLINE bool GameObject::HasAbsolutePosition() const
 {
-    return m_TransformData->AbsolutePosition;
+    return (m_TransformLevel->Flags[m_TransformIndex] & TransformHierarchyLevel::ABSOLUTE_POSITION) != 0;
 }
 
 HK_FORCEINLINE bool GameObject::HasAbsoluteRotation() const
 {
-    return m_TransformData->AbsoluteRotation;
+    return (m_TransformLevel->Flags[m_TransformIndex] & TransformHierarchyLevel::ABSOLUTE_ROTATION) != 0;
 }
 
 HK_FORCEINLINE bool GameObject::HasAbsoluteScale() const
 {
-    return m_TransformData->AbsoluteScale;
+    return (m_TransformLevel->Flags[m_TransformIndex] & TransformHierarchyLevel::ABSOLUTE_SCALE) != 0;
 }
 
 HK_FORCEINLINE Float3 const& GameObject::GetPosition() const
 {
-    return m_TransformData->Position;
+    return m_TransformLevel->Position[m_TransformIndex];
 }
 
 HK_FORCEINLINE Quat const& GameObject::GetRotation() const
 {
-    return m_TransformData->Rotation;
+    return m_TransformLevel->Rotation[m_TransformIndex];
 }
 
 HK_FORCEINLINE Float3 const& GameObject::GetScale() const
 {
-    return m_TransformData->Scale;
+    return m_TransformLevel->Scale[m_TransformIndex];
 }
 
 HK_FORCEINLINE Float3 GameObject::GetRightVector() const
 {
-    return m_TransformData->Rotation.XAxis();
+    return m_TransformLevel->Rotation[m_TransformIndex].XAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetLeftVector() const
 {
-    return -m_TransformData->Rotation.XAxis();
+    return -m_TransformLevel->Rotation[m_TransformIndex].XAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetUpVector() const
 {
-    return m_TransformData->Rotation.YAxis();
+    return m_TransformLevel->Rotation[m_TransformIndex].YAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetDownVector() const
 {
-    return -m_TransformData->Rotation.YAxis();
+    return -m_TransformLevel->Rotation[m_TransformIndex].YAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetBackVector() const
 {
-    return m_TransformData->Rotation.ZAxis();
+    return m_TransformLevel->Rotation[m_TransformIndex].ZAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetForwardVector() const
 {
-    return -m_TransformData->Rotation.ZAxis();
+    return -m_TransformLevel->Rotation[m_TransformIndex].ZAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetDirection() const
@@ -390,57 +434,57 @@ HK_FORCEINLINE Float3 GameObject::GetDirection() const
 
 HK_FORCEINLINE void GameObject::GetVectors(Float3* right, Float3* up, Float3* back) const
 {
-    Math::GetTransformVectors(m_TransformData->Rotation, right, up, back);
+    Math::GetTransformVectors(m_TransformLevel->Rotation[m_TransformIndex], right, up, back);
 }
 
 HK_FORCEINLINE Float3 const& GameObject::GetWorldPosition() const
 {
-    return m_TransformData->WorldPosition;
+    return m_TransformLevel->WorldPosition[m_TransformIndex];
 }
 
 HK_FORCEINLINE Quat const& GameObject::GetWorldRotation() const
 {
-    return m_TransformData->WorldRotation;
+    return m_TransformLevel->WorldRotation[m_TransformIndex];
 }
 
 HK_FORCEINLINE Float3 const& GameObject::GetWorldScale() const
 {
-    return m_TransformData->WorldScale;
+    return m_TransformLevel->WorldScale[m_TransformIndex];
 }
 
 HK_FORCEINLINE Float3x4 const& GameObject::GetWorldTransformMatrix() const
 {
-    return m_TransformData->WorldTransform;
+    return m_TransformLevel->WorldTransform[m_TransformIndex];
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldRightVector() const
 {
-    return m_TransformData->WorldRotation.XAxis();
+    return m_TransformLevel->WorldRotation[m_TransformIndex].XAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldLeftVector() const
 {
-    return -m_TransformData->WorldRotation.XAxis();
+    return -m_TransformLevel->WorldRotation[m_TransformIndex].XAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldUpVector() const
 {
-    return m_TransformData->WorldRotation.YAxis();
+    return m_TransformLevel->WorldRotation[m_TransformIndex].YAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldDownVector() const
 {
-    return -m_TransformData->WorldRotation.YAxis();
+    return -m_TransformLevel->WorldRotation[m_TransformIndex].YAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldBackVector() const
 {
-    return m_TransformData->WorldRotation.ZAxis();
+    return m_TransformLevel->WorldRotation[m_TransformIndex].ZAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldForwardVector() const
 {
-    return -m_TransformData->WorldRotation.ZAxis();
+    return -m_TransformLevel->WorldRotation[m_TransformIndex].ZAxis();
 }
 
 HK_FORCEINLINE Float3 GameObject::GetWorldDirection() const
@@ -450,7 +494,7 @@ HK_FORCEINLINE Float3 GameObject::GetWorldDirection() const
 
 HK_FORCEINLINE void GameObject::GetWorldVectors(Float3* right, Float3* up, Float3* back) const
 {
-    Math::GetTransformVectors(m_TransformData->WorldRotation, right, up, back);
+    Math::GetTransformVectors(m_TransformLevel->WorldRotation[m_TransformIndex], right, up, back);
 }
 
 HK_FORCEINLINE void GameObject::Rotate(float degrees, Float3 const& normalizedAxis)
@@ -459,56 +503,57 @@ HK_FORCEINLINE void GameObject::Rotate(float degrees, Float3 const& normalizedAx
 
     Math::DegSinCos(degrees * 0.5f, s, c);
 
-    m_TransformData->Rotation = Quat(c, s * normalizedAxis.X, s * normalizedAxis.Y, s * normalizedAxis.Z) * m_TransformData->Rotation;
-    m_TransformData->Rotation.NormalizeSelf();
+    Quat& rotation = m_TransformLevel->Rotation[m_TransformIndex];
+    rotation = Quat(c, s * normalizedAxis.X, s * normalizedAxis.Y, s * normalizedAxis.Z) * rotation;
+    rotation.NormalizeSelf();
+    MarkTransformDirty();
 }
 
 HK_FORCEINLINE void GameObject::Move(Float3 const& dir)
 {
-    m_TransformData->Position += dir;
+    m_TransformLevel->Position[m_TransformIndex] += dir;
+    MarkTransformDirty();
 }
 
-HK_FORCEINLINE void GameObject::TransformData::UpdateWorldTransformMatrix()
+HK_FORCEINLINE void GameObject::MarkTransformDirty()
 {
-    WorldTransform.Compose(WorldPosition, WorldRotation.ToMatrix3x3(), WorldScale);
+    m_TransformLevel->Flags[m_TransformIndex] |= TransformHierarchyLevel::DIRTY;
 }
 
-HK_INLINE void GameObject::TransformData::UpdateWorldTransform_r()
+HK_FORCEINLINE void GameObject::UpdateWorldTransformMatrix()
 {
-    if (Parent)
-    {
-        Parent->UpdateWorldTransform_r();
-
-        WorldPosition = AbsolutePosition ? Position : Parent->WorldTransform * Position;
-        WorldRotation = AbsoluteRotation ? Rotation : Parent->WorldRotation * Rotation;
-        WorldScale    = AbsoluteScale    ? Scale    : Parent->WorldScale * Scale;
-    }
-    else
-    {
-        WorldPosition = Position;
-        WorldRotation = Rotation;
-        WorldScale    = Scale;
-    }
+    m_TransformLevel->UpdateWorldTransformMatrix(m_TransformIndex);
+}
 
-    UpdateWorldTransformMatrix();
+HK_FORCEINLINE uint32_t GameObject::GetTransformRef() const
+{
+    return m_TransformIndex | (IsDynamic() ? TransformHierarchyLevel::DynamicParentBit : 0);
 }
 
-HK_FORCEINLINE void GameObject::TransformData::UpdateWorldTransform()
+HK_FORCEINLINE void GameObject::ComputeWorldTransform()
 {
-    if (Parent)
+    auto& transform = *m_TransformLevel;
+    uint32_t index = m_TransformIndex;
+
+    if (GameObject* parent = GetParent())
     {
-        WorldPosition = AbsolutePosition ? Position : Parent->WorldTransform * Position;
-        WorldRotation = AbsoluteRotation ? Rotation : Parent->WorldRotation * Rotation;
-        WorldScale    = AbsoluteScale    ? Scale    : Parent->WorldScale * Scale;
+        uint8_t flags = transform.Flags[index];
+
+        transform.WorldPosition[index] = (flags & TransformHierarchyLevel::ABSOLUTE_POSITION) ? transform.Position[index] : parent->GetWorldTransformMatrix() * transform.Position[index];
+        transform.WorldRotation[index] = (flags & TransformHierarchyLevel::ABSOLUTE_ROTATION) ? transform.Rotation[index] : parent->GetWorldRotation() * transform.Rotation[index];
+        transform.WorldScale[index]    = (flags & TransformHierarchyLevel::ABSOLUTE_SCALE)    ? transform.Scale[index]    : parent->GetWorldScale() * transform.Scale[index];
     }
     else
     {
-        WorldPosition = Position;
-        WorldRotation = Rotation;
-        WorldScale    = Scale;
+        transform.WorldPosition[index] = transform.Position[index];
+        transform.WorldRotation[index] = transform.Rotation[index];
+        transform.WorldScale[index]    = transform.Scale[index];
     }
 
     UpdateWorldTransformMatrix();
+
+    // Dynamic children of a static object are updated by the next hierarchy pass only if the parent is dirty
+    MarkTransformDirty();
 }
 
 HK_NAMESPACE_END
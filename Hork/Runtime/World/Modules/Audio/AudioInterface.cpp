@@ -33,6 +33,7 @@ SOFTWARE.
 #include <Hork/Core/Logger.h>
 
 #include <Hork/Audio/AudioDevice.h>
+#include <Hork/Audio/AudioVoiceManager.h>
 
 #include <Hork/Runtime/World/World.h>
 #include <Hork/Runtime/GameApplication/GameApplication.h>
@@ -318,6 +319,9 @@ void AudioInterface::UpdateOneShotSound()
 
         it->Track->SetPlaybackParameters(chan_vol, local_dir, spatialized_stereo, paused);
 
+        if (!paused)
+            GameApplication::sGetAudioVoiceManager().AddVoice(it->Track, uint8_t(AudioChannelPriority::OneShot), chan_vol);
+
         if (it->NeedToSubmit)
         {
             it->NeedToSubmit = false;
@@ -360,25 +364,29 @@ void AudioInterface::Update()
     {
         AudioListener& m_Listener;
         AudioMixerSubmitQueue& m_SubmitQueue;
+        AudioVoiceManager& m_VoiceManager;
         bool m_IsPaused;
 
-        Visitor(AudioListener& listener, AudioMixerSubmitQueue& submitQueue, bool isPaused) :
-            m_Listener(listener), m_SubmitQueue(submitQueue), m_IsPaused(isPaused)
+        Visitor(AudioListener& listener, AudioMixerSubmitQueue& submitQueue, AudioVoiceManager& voiceManager, bool isPaused) :
+            m_Listener(listener), m_SubmitQueue(submitQueue), m_VoiceManager(voiceManager), m_IsPaused(isPaused)
         {
         }
 
         HK_FORCEINLINE void Visit(SoundSource& soundSource)
         {
             soundSource.Spatialize(m_Listener);
-            soundSource.UpdateTrack(m_SubmitQueue, m_IsPaused);
+            soundSource.UpdateTrack(m_SubmitQueue, m_VoiceManager, m_IsPaused);
         }
     };
 
-    Visitor visitor(m_Listener, m_SubmitQueue, GetWorld()->GetTick().IsPaused);
+    Visitor visitor(m_Listener, m_SubmitQueue, GameApplication::sGetAudioVoiceManager(), GetWorld()->GetTick().IsPaused);
     soundSourceManager.IterateComponents(visitor);
 
     UpdateOneShotSound();
+}
 
+void AudioInterface::SubmitTracks()
+{
     GameApplication::sGetAudioMixer()->SubmitTracks(m_SubmitQueue);
 }
 
@@ -52,8 +52,8 @@ enum class AudioDistanceModel
     ExponentClamped  = 5
 };
 
-/// Priority to play the sound.
-/// NOTE: Not used now. Reserved for future to pick a free channel.
+/// Priority to play the sound. Voices with higher priority are mixed first when the number
+/// of playing sounds exceeds Snd_MaxVoices.
 enum class AudioChannelPriority : uint8_t
 {
     OneShot  = 0,
@@ -133,6 +133,10 @@ public:
     /// Plays a sound at background.
     void                    PlaySoundBackground(SoundHandle inSound, SoundGroup* inGroup = nullptr, float inVolume = 1.0f, int inStartFrame = 0);
 
+    /// Submit the tracks started this frame to the mixer. Called by the application after
+    /// the voices of all worlds are ranked against the shared budget.
+    void                    SubmitTracks();
+
 protected:
     virtual void            Initialize() override;
     virtual void            Deinitialize() override;
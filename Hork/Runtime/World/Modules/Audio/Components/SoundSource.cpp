@@ -31,6 +31,7 @@ SOFTWARE.
 #include "SoundSource.h"
 
 #include <Hork/Audio/AudioMixer.h>
+#include <Hork/Audio/AudioVoiceManager.h>
 #include <Hork/Runtime/GameApplication/GameApplication.h>
 
 HK_NAMESPACE_BEGIN
@@ -276,6 +277,11 @@ void SoundSource::SetVirtualizeWhenSilent(bool inVirtualizeWhenSilent)
     m_VirtualizeWhenSilent = inVirtualizeWhenSilent;
 }
 
+void SoundSource::SetPriority(AudioChannelPriority inPriority)
+{
+    m_Priority = inPriority;
+}
+
 void SoundSource::SetVolume(float inVolume)
 {
     m_Volume = Math::Saturate(inVolume);
@@ -326,6 +332,36 @@ bool SoundSource::IsSilent() const
     return !m_SoundHandle.IsValid();
 }
 
+void SoundSource::Read(IBinaryStreamReadInterface& stream)
+{
+    m_ListenerMask = stream.ReadUInt32();
+    m_SourceType = SoundSourceType(stream.ReadUInt8());
+    m_Priority = AudioChannelPriority(stream.ReadUInt8());
+    m_Volume = stream.ReadFloat();
+    m_ReferenceDistance = stream.ReadFloat();
+    m_MaxDistance = stream.ReadFloat();
+    m_RolloffRate = stream.ReadFloat();
+    m_ConeInnerAngle = stream.ReadFloat();
+    m_ConeOuterAngle = stream.ReadFloat();
+    m_VirtualizeWhenSilent = stream.ReadBool();
+    m_IsMuted = stream.ReadBool();
+}
+
+void SoundSource::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteUInt32(m_ListenerMask);
+    stream.WriteUInt8(uint8_t(m_SourceType));
+    stream.WriteUInt8(uint8_t(m_Priority));
+    stream.WriteFloat(m_Volume);
+    stream.WriteFloat(m_ReferenceDistance);
+    stream.WriteFloat(m_MaxDistance);
+    stream.WriteFloat(m_RolloffRate);
+    stream.WriteFloat(m_ConeInnerAngle);
+    stream.WriteFloat(m_ConeOuterAngle);
+    stream.WriteBool(m_VirtualizeWhenSilent);
+    stream.WriteBool(m_IsMuted);
+}
+
 HK_FORCEINLINE float FalloffDistance(float inMaxDistance)
 {
     return inMaxDistance * 1.3f;
@@ -504,7 +540,7 @@ void SoundSource::Spatialize(AudioListener const& inListener)
     }
 }
 
-void SoundSource::UpdateTrack(AudioMixerSubmitQueue& submitQueue, bool inPaused)
+void SoundSource::UpdateTrack(AudioMixerSubmitQueue& submitQueue, AudioVoiceManager& voiceManager, bool inPaused)
 {
     bool paused = m_IsPaused;
     bool playEvenWhenPaused = m_Group ? m_Group->ShouldPlayEvenWhenPaused() : false;
@@ -533,6 +569,9 @@ void SoundSource::UpdateTrack(AudioMixerSubmitQueue& submitQueue, bool inPaused)
 
         it->Track->SetPlaybackParameters(chanVol, m_LocalDir, m_SpatializedStereo, paused);
 
+        if (!paused)
+            voiceManager.AddVoice(it->Track, uint8_t(m_Priority), chanVol);
+
         if (it->NeedToSubmit)
         {
             it->NeedToSubmit = false;
@@ -565,6 +604,9 @@ void SoundSource::UpdateTrack(AudioMixerSubmitQueue& submitQueue, bool inPaused)
 
     m_Track->SetPlaybackParameters(m_ChanVolume, m_LocalDir, m_SpatializedStereo, paused);
 
+    if (!paused)
+        voiceManager.AddVoice(m_Track, uint8_t(m_Priority), m_ChanVolume);
+
     if (m_NeedToSubmit)
     {
         m_NeedToSubmit = false;
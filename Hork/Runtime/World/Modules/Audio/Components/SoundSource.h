@@ -128,6 +128,12 @@ public:
     /// Virtualize sound when silent. Looped sounds has this by default.
     bool                    ShouldVirtualizeWhenSilent() const { return m_VirtualizeWhenSilent; }
 
+    /// Priority to keep the sound mixed when the voice budget is exceeded. See AudioChannelPriority
+    void                    SetPriority(AudioChannelPriority inPriority);
+
+    /// Priority to keep the sound mixed when the voice budget is exceeded. See AudioChannelPriority
+    AudioChannelPriority    GetPriority() const { return m_Priority; }
+
     /// Audio volume scale
     void                    SetVolume(float inVolume);
 
@@ -185,9 +191,13 @@ public:
     /// Return true if no sound plays
     bool                    IsSilent() const;
 
+    /// Only the source settings are stored. Playback, the sound queue, the sound group and the target listener are runtime state.
+    void                    Read(IBinaryStreamReadInterface& stream);
+    void                    Write(IBinaryStreamWriteInterface& stream) const;
+
     void                    Spatialize(AudioListener const& inListener);
 
-    void                    UpdateTrack(class AudioMixerSubmitQueue& submitQueue, bool inPaused);
+    void                    UpdateTrack(class AudioMixerSubmitQueue& submitQueue, class AudioVoiceManager& voiceManager, bool inPaused);
 
 private:
     bool                    StartPlay(SoundHandle inSound, int inStartFrame, int inLoopStart);
@@ -199,6 +209,7 @@ private:
     GameObjectHandle        m_TargetListener;
     uint32_t                m_ListenerMask = ~0u;
     SoundSourceType         m_SourceType = SoundSourceType::Point;
+    AudioChannelPriority    m_Priority = AudioChannelPriority::Ambient;
     SoundHandle             m_SoundHandle;
     Ref<AudioTrack>         m_Track;
     float                   m_Volume = 1.0f;
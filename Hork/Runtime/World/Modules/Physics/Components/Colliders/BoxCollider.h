@@ -43,6 +43,20 @@ public:
     Float3  OffsetPosition;
     Quat    OffsetRotation;
     Float3  HalfExtents = Float3(0.5f);
+
+    void    Read(IBinaryStreamReadInterface& stream)
+    {
+        stream.ReadObject(OffsetPosition);
+        stream.ReadObject(OffsetRotation);
+        stream.ReadObject(HalfExtents);
+    }
+
+    void    Write(IBinaryStreamWriteInterface& stream) const
+    {
+        stream.WriteObject(OffsetPosition);
+        stream.WriteObject(OffsetRotation);
+        stream.WriteObject(HalfExtents);
+    }
 };
 
 namespace ComponentMeta
@@ -44,6 +44,22 @@ public:
     Quat    OffsetRotation;
     float   Radius = 0.5f;
     float   Height = 1.0f;
+
+    void    Read(IBinaryStreamReadInterface& stream)
+    {
+        stream.ReadObject(OffsetPosition);
+        stream.ReadObject(OffsetRotation);
+        Radius = stream.ReadFloat();
+        Height = stream.ReadFloat();
+    }
+
+    void    Write(IBinaryStreamWriteInterface& stream) const
+    {
+        stream.WriteObject(OffsetPosition);
+        stream.WriteObject(OffsetRotation);
+        stream.WriteFloat(Radius);
+        stream.WriteFloat(Height);
+    }
 };
 
 namespace ComponentMeta
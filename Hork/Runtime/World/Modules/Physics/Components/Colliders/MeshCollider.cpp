@@ -35,6 +35,7 @@ SOFTWARE.
 #include <Jolt/Physics/Collision/Shape/MeshShape.h>
 
 #include <Hork/Geometry/ConvexDecomposition.h>
+#include <Hork/Runtime/GameApplication/GameApplication.h>
 
 HK_NAMESPACE_BEGIN
 
@@ -120,6 +121,47 @@ void MeshCollisionData::CreateTriangleSoup(Float3 const* vertices, size_t vertex
     m_Data->m_Shape = new JPH::MeshShape(meshSettings, result);
 }
 
+void MeshCollisionData::CreateFromResource(CollisionResource const& resource, int partIndex)
+{
+    m_IsConvex = resource.GetPart(partIndex).IsConvex;
+    m_Data->m_Shape = resource.GetShape(partIndex);
+}
+
+void MeshCollider::Read(IBinaryStreamReadInterface& stream)
+{
+    auto& resourceMngr = GameApplication::sGetResourceManager();
+
+    stream.ReadObject(OffsetPosition);
+    stream.ReadObject(OffsetRotation);
+
+    String resourceName = stream.ReadString();
+    PartIndex = stream.ReadInt32();
+
+    Resource = !resourceName.IsEmpty() ? resourceMngr.GetResource<CollisionResource>(resourceName) : CollisionHandle{};
+    Data.Reset();
+
+    if (!Resource)
+        return;
+
+    CollisionResource* resource = resourceMngr.TryGet(Resource);
+    if (!resource || PartIndex < 0 || PartIndex >= resource->GetPartCount())
+    {
+        LOG("MeshCollider::Read: Collision {} is not loaded\n", resourceName);
+        return;
+    }
+
+    Data = MakeRef<MeshCollisionData>();
+    Data->CreateFromResource(*resource, PartIndex);
+}
+
+void MeshCollider::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteObject(OffsetPosition);
+    stream.WriteObject(OffsetRotation);
+    stream.WriteString(Resource ? GameApplication::sGetResourceManager().GetResourceName(Resource) : StringView{});
+    stream.WriteInt32(PartIndex);
+}
+
 bool CreateConvexDecomposition(GameObject* object, Float3 const* inVertices, int inVertexCount, int inVertexStride, unsigned int const* inIndices, int inIndexCount)
 {
     Vector<Float3> hullVertices;
@@ -185,4 +227,30 @@ bool CreateConvexDecompositionVHACD(GameObject* object, Float3 const* inVertices
     return true;
 }
 
+bool CreateCollidersFromResource(GameObject* object, CollisionHandle inCollision)
+{
+    CollisionResource* resource = GameApplication::sGetResourceManager().TryGet(inCollision);
+    if (!resource)
+    {
+        LOG("CreateCollidersFromResource: Collision is not loaded\n");
+        return false;
+    }
+
+    for (int partIndex = 0; partIndex < resource->GetPartCount(); ++partIndex)
+    {
+        MeshCollider* collider;
+        object->CreateComponent(collider);
+
+        CollisionResource::Part const& part = resource->GetPart(partIndex);
+        collider->OffsetPosition = part.OffsetPosition;
+        collider->OffsetRotation = part.OffsetRotation;
+        collider->Data = MakeRef<MeshCollisionData>();
+        collider->Data->CreateFromResource(*resource, partIndex);
+        collider->Resource = inCollision;
+        collider->PartIndex = partIndex;
+    }
+
+    return resource->GetPartCount() > 0;
+}
+
 HK_NAMESPACE_END
@@ -33,6 +33,7 @@ SOFTWARE.
 #include <Hork/Core/Containers/ArrayView.h>
 #include <Hork/Math/Quat.h>
 #include <Hork/Runtime/World/Component.h>
+#include <Hork/Resources/Resource_Collision.h>
 
 HK_NAMESPACE_BEGIN
 
@@ -47,6 +48,15 @@ public:
     Quat                    OffsetRotation;
 
     Ref<MeshCollisionData>  Data;
+
+    /// Resource part the collision data was created from. Only the resource reference is serialized,
+    /// so colliders with procedurally built data are restored without a shape.
+    CollisionHandle         Resource;
+    int                     PartIndex = 0;
+
+    /// The collision resource must be loaded before the collider is read.
+    void                    Read(IBinaryStreamReadInterface& stream);
+    void                    Write(IBinaryStreamWriteInterface& stream) const;
 };
 
 namespace ComponentMeta
@@ -70,6 +80,9 @@ public:
     void                    CreateTriangleSoup(ArrayView<Float3> vertices, ArrayView<uint32_t> indices);
     void                    CreateTriangleSoup(Float3 const* vertices, size_t vertexStride, size_t vertexCount, uint32_t const* indices, size_t indexCount);
 
+    /// Use the cooked shape of the resource part. The shape is shared, not copied.
+    void                    CreateFromResource(CollisionResource const& resource, int partIndex);
+
     bool                    IsEmpty() const;
     bool                    IsConvex() const { return m_IsConvex; }    
 
@@ -82,4 +95,7 @@ private:
 bool CreateConvexDecomposition(GameObject* object, Float3 const* inVertices, int inVertexCount, int inVertexStride, unsigned int const* inIndices, int inIndexCount);
 bool CreateConvexDecompositionVHACD(GameObject* object, Float3 const* inVertices, int inVertexCount, int inVertexStride, unsigned int const* inIndices, int inIndexCount);
 
+/// Creates a mesh collider for each part of the cooked collision. The resource must be loaded.
+bool CreateCollidersFromResource(GameObject* object, CollisionHandle inCollision);
+
 HK_NAMESPACE_END
@@ -42,6 +42,18 @@ public:
 
     Float3  OffsetPosition;
     float   Radius = 0.5f;
+
+    void    Read(IBinaryStreamReadInterface& stream)
+    {
+        stream.ReadObject(OffsetPosition);
+        Radius = stream.ReadFloat();
+    }
+
+    void    Write(IBinaryStreamWriteInterface& stream) const
+    {
+        stream.WriteObject(OffsetPosition);
+        stream.WriteFloat(Radius);
+    }
 };
 
 namespace ComponentMeta
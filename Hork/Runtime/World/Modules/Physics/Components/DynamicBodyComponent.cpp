@@ -33,6 +33,56 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+void DynamicBodyComponent::Read(IBinaryStreamReadInterface& stream)
+{
+    CollisionLayer = stream.ReadUInt8();
+    stream.ReadObject(CenterOfMassOverride);
+    stream.ReadObject(LinearVelocity);
+    stream.ReadObject(AngularVelocity);
+    LinearDamping = stream.ReadHalf();
+    AngularDamping = stream.ReadHalf();
+    MaxLinearVelocity = stream.ReadHalf();
+    MaxAngularVelocity = stream.ReadHalf();
+    Mass = stream.ReadHalf();
+    InertiaMultiplier = stream.ReadHalf();
+    AllowSleeping = stream.ReadBool();
+    StartAsSleeping = stream.ReadBool();
+    UseCCD = stream.ReadBool();
+    Material.Restitution = stream.ReadFloat();
+    Material.Friction = stream.ReadFloat();
+    DispatchContactEvents = stream.ReadBool();
+    CanPushCharacter = stream.ReadBool();
+    m_GravityFactor = stream.ReadFloat();
+    m_IsKinematic = stream.ReadBool();
+    m_IsDynamicScaling = stream.ReadBool();
+}
+
+void DynamicBodyComponent::Write(IBinaryStreamWriteInterface& stream) const
+{
+    bool hasBody = !JPH::BodyID(m_BodyID.ID).IsInvalid();
+
+    stream.WriteUInt8(CollisionLayer);
+    stream.WriteObject(CenterOfMassOverride);
+    stream.WriteObject(hasBody ? GetLinearVelocity() : LinearVelocity);
+    stream.WriteObject(hasBody ? GetAngularVelocity() : AngularVelocity);
+    stream.WriteHalf(LinearDamping);
+    stream.WriteHalf(AngularDamping);
+    stream.WriteHalf(MaxLinearVelocity);
+    stream.WriteHalf(MaxAngularVelocity);
+    stream.WriteHalf(Mass);
+    stream.WriteHalf(InertiaMultiplier);
+    stream.WriteBool(AllowSleeping);
+    stream.WriteBool(hasBody ? IsSleeping() : StartAsSleeping);
+    stream.WriteBool(UseCCD);
+    stream.WriteFloat(Material.Restitution);
+    stream.WriteFloat(Material.Friction);
+    stream.WriteBool(DispatchContactEvents);
+    stream.WriteBool(CanPushCharacter);
+    stream.WriteFloat(m_GravityFactor);
+    stream.WriteBool(m_IsKinematic);
+    stream.WriteBool(m_IsDynamicScaling);
+}
+
 void DynamicBodyComponent::BeginPlay()
 {
     PhysicsInterfaceImpl* physics = GetWorld()->GetInterface<PhysicsInterface>().GetImpl();
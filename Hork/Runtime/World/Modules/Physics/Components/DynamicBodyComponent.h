@@ -168,6 +168,10 @@ public:
     // Utilites
     void                    GatherGeometry(Vector<Float3>& vertices, Vector<uint32_t>& indices);
 
+    /// A body that is already simulated writes its current velocities as the initial ones.
+    void                    Read(IBinaryStreamReadInterface& stream);
+    void                    Write(IBinaryStreamWriteInterface& stream) const;
+
     // Internal
 
     void                    BeginPlay();
@@ -30,6 +30,7 @@ SOFTWARE.
 
 #include "HeightFieldComponent.h"
 #include <Hork/Runtime/World/Modules/Physics/PhysicsInterfaceImpl.h>
+#include <Hork/Resources/Resource_Terrain.h>
 
 #include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
 
@@ -118,16 +119,41 @@ TerrainCollisionData::TerrainCollisionData() :
 {}
 
 void TerrainCollisionData::Create(const float* inSamples, uint32_t inSampleCount/*, const uint8_t* inMaterialIndices, const JPH::PhysicsMaterialList& inMaterialList*/)
+{
+    const float CELL_SIZE = 1;
+
+    CreateShape(inSamples, inSampleCount, Float3(-0.5f * CELL_SIZE * inSampleCount, 0, -0.5f * CELL_SIZE * inSampleCount), CELL_SIZE);
+}
+
+void TerrainCollisionData::Create(TerrainResource const& inTerrain, int inLod, Int2 const& inOrigin, uint32_t inSampleCount)
+{
+    HK_ASSERT(inLod >= 0 && inLod < inTerrain.GetLodCount());
+
+    HeapBlob samples(size_t(inSampleCount) * inSampleCount * sizeof(float));
+
+    // Collision needs the exact heights rather than the coarser fallback of the streamed tiles
+    inTerrain.LoadTiles(inLod, inOrigin.X, inOrigin.Y, inOrigin.X + inSampleCount - 1, inOrigin.Y + inSampleCount - 1);
+
+    float* heightmap = reinterpret_cast<float*>(samples.GetData());
+    for (uint32_t y = 0; y < inSampleCount; y++)
+        inTerrain.ReadRow(inLod, inOrigin.X, inOrigin.Y + y, inSampleCount, heightmap + y * inSampleCount);
+
+    // Lod sample (GetLodResolution(lod)/2, GetLodResolution(lod)/2) is at the origin
+    const float cellSize = float(1 << inLod);
+    const int halfResolution = inTerrain.GetLodResolution(inLod) >> 1;
+
+    CreateShape(heightmap, inSampleCount, Float3((inOrigin.X - halfResolution) * cellSize, 0, (inOrigin.Y - halfResolution) * cellSize), cellSize);
+}
+
+void TerrainCollisionData::CreateShape(const float* inSamples, uint32_t inSampleCount, Float3 const& inOffset, float inCellSize)
 {
     const int BLOCK_SIZE_SHIFT = 2;
     const int BITS_PER_SAMPLE = 8;
 
     HK_ASSERT(IsPowerOfTwo(inSampleCount) && (inSampleCount % (1 << BLOCK_SIZE_SHIFT)) == 0);
 
-    const float CELL_SIZE = 1;
-
-    JPH::Vec3 terrainOffset = JPH::Vec3(-0.5f * CELL_SIZE * inSampleCount, 0, -0.5f * CELL_SIZE * inSampleCount);
-    JPH::Vec3 terrainScale = JPH::Vec3(CELL_SIZE, 1.0f, CELL_SIZE);
+    JPH::Vec3 terrainOffset = ConvertVector(inOffset);
+    JPH::Vec3 terrainScale = JPH::Vec3(inCellSize, 1.0f, inCellSize);
 
     JPH::HeightFieldShapeSettings settings(inSamples, terrainOffset, terrainScale, inSampleCount, /*inMaterialIndices*/nullptr, /*inMaterialList*/{});
     settings.mBlockSize = 1 << BLOCK_SIZE_SHIFT;
@@ -38,6 +38,7 @@ SOFTWARE.
 HK_NAMESPACE_BEGIN
 
 class TerrainCollisionData;
+class TerrainResource;
 
 class HeightFieldComponent final : public BodyComponent
 {
@@ -95,6 +96,10 @@ public:
 
     void                            Create(const float* inSamples, uint32_t inSampleCount/*, const uint8_t* inMaterialIndices = nullptr, const JPH::PhysicsMaterialList& inMaterialList = JPH::PhysicsMaterialList()*/);
 
+    /// Create height field from the terrain tiles. The patch of inSampleCount x inSampleCount samples of the lod starts at
+    /// sample inOrigin. Large terrains can be split into several patches so that only the tiles of the patch are loaded.
+    void                            Create(TerrainResource const& inTerrain, int inLod, Int2 const& inOrigin, uint32_t inSampleCount);
+
     /// Get height field position at sampled location (inX, inY).
     /// where inX and inY are integers in the range inX e [0, mSampleCount - 1] and inY e [0, mSampleCount - 1].
     Float3                          GetPosition(uint32_t inX, uint32_t inY) const;
@@ -114,6 +119,8 @@ public:
     MeshCollisionDataInternal const* GetData() { return m_Data.RawPtr(); }
 
 private:
+    void                            CreateShape(const float* inSamples, uint32_t inSampleCount, Float3 const& inOffset, float inCellSize);
+
     UniqueRef<MeshCollisionDataInternal> m_Data;
 };
 
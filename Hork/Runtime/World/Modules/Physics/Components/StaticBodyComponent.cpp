@@ -33,6 +33,22 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+void StaticBodyComponent::Read(IBinaryStreamReadInterface& stream)
+{
+    CollisionLayer = stream.ReadUInt8();
+    Material.Restitution = stream.ReadFloat();
+    Material.Friction = stream.ReadFloat();
+    DispatchContactEvents = stream.ReadBool();
+}
+
+void StaticBodyComponent::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteUInt8(CollisionLayer);
+    stream.WriteFloat(Material.Restitution);
+    stream.WriteFloat(Material.Friction);
+    stream.WriteBool(DispatchContactEvents);
+}
+
 void StaticBodyComponent::BeginPlay()
 {
     PhysicsInterfaceImpl* physics = GetWorld()->GetInterface<PhysicsInterface>().GetImpl();
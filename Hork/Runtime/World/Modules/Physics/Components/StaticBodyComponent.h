@@ -69,6 +69,9 @@ public:
     // Utilites
     void                    GatherGeometry(Vector<Float3>& vertices, Vector<uint32_t>& indices);
 
+    void                    Read(IBinaryStreamReadInterface& stream);
+    void                    Write(IBinaryStreamWriteInterface& stream) const;
+
     // Internal
     void                    BeginPlay();
     void                    EndPlay();
@@ -33,6 +33,16 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+void TriggerComponent::Read(IBinaryStreamReadInterface& stream)
+{
+    CollisionLayer = stream.ReadUInt8();
+}
+
+void TriggerComponent::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteUInt8(CollisionLayer);
+}
+
 void TriggerComponent::BeginPlay()
 {
     PhysicsInterfaceImpl* physics = GetWorld()->GetInterface<PhysicsInterface>().GetImpl();
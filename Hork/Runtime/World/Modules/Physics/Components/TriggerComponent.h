@@ -59,6 +59,9 @@ public:
     /// The collision layer this body belongs to (determines if two objects can collide)
     uint8_t                 CollisionLayer = 0;
 
+    void                    Read(IBinaryStreamReadInterface& stream);
+    void                    Write(IBinaryStreamWriteInterface& stream) const;
+
     void                    BeginPlay();
     void                    EndPlay();
 
@@ -50,6 +50,32 @@ void DirectionalLightComponent::UpdateEffectiveColor()
     m_EffectiveColor[2] = ColorUtils::LinearFromSRGB_Fast(m_Color[2] * temperatureColor[2]) * energy;
 }
 
+void DirectionalLightComponent::Read(IBinaryStreamReadInterface& stream)
+{
+    stream.ReadFloats(m_Color.ToPtr(), 3);
+    m_Temperature = stream.ReadFloat();
+    m_IlluminanceInLux = stream.ReadFloat();
+    m_CastShadow = stream.ReadBool();
+    m_ShadowMaxDistance = stream.ReadFloat();
+    m_ShadowCascadeOffset = stream.ReadFloat();
+    SetMaxShadowCascades(stream.ReadInt32());
+    SetShadowCascadeResolution(stream.ReadInt32());
+    m_ShadowCascadeSplitLambda = stream.ReadFloat();
+}
+
+void DirectionalLightComponent::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteFloats(m_Color.ToPtr(), 3);
+    stream.WriteFloat(m_Temperature);
+    stream.WriteFloat(m_IlluminanceInLux);
+    stream.WriteBool(m_CastShadow);
+    stream.WriteFloat(m_ShadowMaxDistance);
+    stream.WriteFloat(m_ShadowCascadeOffset);
+    stream.WriteInt32(m_MaxShadowCascades);
+    stream.WriteInt32(m_ShadowCascadeResolution);
+    stream.WriteFloat(m_ShadowCascadeSplitLambda);
+}
+
 void DirectionalLightComponent::DrawDebug(DebugRenderer& renderer)
 {
     if (com_DrawDirectionalLights)
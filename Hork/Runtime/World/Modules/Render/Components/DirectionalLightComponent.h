@@ -86,6 +86,9 @@ public:
 
     void                        DrawDebug(DebugRenderer& renderer);
 
+    void                        Read(IBinaryStreamReadInterface& stream);
+    void                        Write(IBinaryStreamWriteInterface& stream) const;
+
 private:
     Color3                      m_Color;
     float                       m_Temperature = 6590.0f;
@@ -83,6 +83,47 @@ void MeshComponent::UpdateWorldBoundingBox()
     m_WorldBoundingBox = m_LocalBoundingBox.Transform(GetOwner()->GetWorldTransformMatrix());
 }
 
+void MeshComponent::Read(IBinaryStreamReadInterface& stream)
+{
+    auto& resourceMngr = GameApplication::sGetResourceManager();
+    auto& materialMngr = GameApplication::sGetMaterialManager();
+
+    String meshName = stream.ReadString();
+    m_Resource = !meshName.IsEmpty() ? resourceMngr.GetResource<MeshResource>(meshName) : MeshHandle{};
+
+    uint32_t materialCount = stream.ReadUInt32();
+    m_Materials.Clear();
+    m_Materials.Reserve(materialCount);
+    for (uint32_t i = 0; i < materialCount; ++i)
+    {
+        String materialName = stream.ReadString();
+        m_Materials.Add(!materialName.IsEmpty() ? materialMngr.TryGet(materialName) : Ref<Material>{});
+    }
+
+    m_VisibilityLayer = stream.ReadUInt8();
+    m_Outline = stream.ReadBool();
+    m_CastShadow = stream.ReadBool();
+    m_CascadeMask = stream.ReadUInt32();
+    stream.ReadObject(m_LocalBoundingBox);
+}
+
+void MeshComponent::Write(IBinaryStreamWriteInterface& stream) const
+{
+    auto& resourceMngr = GameApplication::sGetResourceManager();
+
+    stream.WriteString(m_Resource ? resourceMngr.GetResourceName(m_Resource) : StringView{});
+
+    stream.WriteUInt32(m_Materials.Size());
+    for (auto& material : m_Materials)
+        stream.WriteString(material ? material->GetName() : StringView{});
+
+    stream.WriteUInt8(m_VisibilityLayer);
+    stream.WriteBool(m_Outline);
+    stream.WriteBool(m_CastShadow);
+    stream.WriteUInt32(m_CascadeMask);
+    stream.WriteObject(m_LocalBoundingBox);
+}
+
 void MeshComponent::DrawDebug(DebugRenderer& renderer)
 {
     if (com_DrawMeshDebug)
@@ -80,6 +80,10 @@ public:
 
     void                        DrawDebug(DebugRenderer& renderer);
 
+    /// The mesh and materials are stored by name. The procedural mesh is runtime data and is not stored.
+    void                        Read(IBinaryStreamReadInterface& stream);
+    void                        Write(IBinaryStreamWriteInterface& stream) const;
+
 protected:
     MeshHandle                  m_Resource;
     Vector<Ref<Material>>       m_Materials; // NOTE: pointers will be replaced by handles!
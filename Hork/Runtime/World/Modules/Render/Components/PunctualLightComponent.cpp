@@ -58,6 +58,36 @@ void PunctualLightComponent::SetOuterConeAngle(float angle)
     m_CosHalfOuterConeAngle = Math::Cos(Math::Radians(m_OuterConeAngle * 0.5f));
 }
 
+void PunctualLightComponent::Read(IBinaryStreamReadInterface& stream)
+{
+    stream.ReadFloats(m_Color.ToPtr(), 3);
+    m_Temperature = stream.ReadFloat();
+    m_Lumens = stream.ReadFloat();
+    m_PhotometricIntensity = stream.ReadFloat();
+    m_PhotometricProfileID = stream.ReadUInt16();
+    m_PhotometricAsMask = stream.ReadBool();
+    m_CastShadow = stream.ReadBool();
+    m_SpotExponent = stream.ReadFloat();
+    SetRadius(stream.ReadFloat());
+    SetInnerConeAngle(stream.ReadFloat());
+    SetOuterConeAngle(stream.ReadFloat());
+}
+
+void PunctualLightComponent::Write(IBinaryStreamWriteInterface& stream) const
+{
+    stream.WriteFloats(m_Color.ToPtr(), 3);
+    stream.WriteFloat(m_Temperature);
+    stream.WriteFloat(m_Lumens);
+    stream.WriteFloat(m_PhotometricIntensity);
+    stream.WriteUInt16(m_PhotometricProfileID);
+    stream.WriteBool(m_PhotometricAsMask);
+    stream.WriteBool(m_CastShadow);
+    stream.WriteFloat(m_SpotExponent);
+    stream.WriteFloat(m_Radius);
+    stream.WriteFloat(m_InnerConeAngle);
+    stream.WriteFloat(m_OuterConeAngle);
+}
+
 void PunctualLightComponent::BeginPlay()
 {
     m_Transform[0].Position = m_Transform[1].Position = GetOwner()->GetWorldPosition();
@@ -111,6 +111,9 @@ public:
 
     Float3 const&               GetRenderPosition() const { return m_RenderTransform.Position; }
 
+    void                        Read(IBinaryStreamReadInterface& stream);
+    void                        Write(IBinaryStreamWriteInterface& stream) const;
+
     // Internal
 
     void                        BeginPlay();
@@ -33,6 +33,7 @@ SOFTWARE.
 #include <Hork/Runtime/World/DebugRenderer.h>
 #include <Hork/Runtime/GameApplication/GameApplication.h>
 
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/Core/ConsoleVar.h>
 #include <Hork/Geometry/BV/BvIntersect.h>
 
@@ -77,6 +78,7 @@ TerrainView::TerrainView(TerrainHandle resource)
         m_LodInfo[i].PrevTextureOffset.Y = 0;
 
         m_LodInfo[i].bForceUpdateTexture = true;
+        m_LodInfo[i].TileVersion = 0;
     }
 
     auto textureFormat = RHI::TextureDesc()
@@ -128,6 +130,17 @@ void TerrainView::Update(Float3 const& ViewPosition, BvFrustum const& ViewFrustu
     m_TerrainBoundingBox = resource->GetBoundingBox();
     if (!ViewFrustum.IsBoxVisible(m_TerrainBoundingBox))
         return;
+
+    // Texels sampled from a coarser lod are refreshed when the streamed tiles arrive
+    for (int i = 0; i < MAX_TERRAIN_LODS; i++)
+    {
+        uint32_t tileVersion = resource->GetLodVersion(m_LodInfo[i].LodIndex);
+        if (m_LodInfo[i].TileVersion != tileVersion)
+        {
+            m_LodInfo[i].TileVersion = tileVersion;
+            m_LodInfo[i].bForceUpdateTexture = true;
+        }
+    }
  
     MakeView(ViewPosition, ViewFrustum);
 
@@ -847,106 +860,258 @@ void TerrainView::AddPatches(BvFrustum const& ViewFrustum)
 #endif
 }
 
-void TerrainView::UpdateRect(TerrainLodInfo const& Lod, TerrainLodInfo const& CoarserLod, int MinX, int MaxX, int MinY, int MaxY)
+namespace
 {
-    auto& resourceMngr = GameApplication::sGetResourceManager();
 
-    Int2 texelWorldPos;
-    float h[4];
-    Float3 n;
+constexpr int CLIPMAP_UPDATE_ROWS_PER_JOB = 32;
+
+/// Smaller rects are updated on the calling thread
+constexpr int CLIPMAP_PARALLEL_UPDATE_TEXELS = 4096;
+
+struct ClipmapUpdateJob
+{
+    TerrainResource const*  Resource;
+    TerrainLodInfo const*   Lod;
+    TerrainLodInfo const*   CoarserLod;
+    int                     MinX;
+    int                     MaxX;
+    int                     MinY;
+    int                     MaxY;
+};
+
+void UpdateClipmapRows(ClipmapUpdateJob const& job)
+{
+    TerrainLodInfo const& Lod = *job.Lod;
+    TerrainLodInfo const& CoarserLod = *job.CoarserLod;
+
+    const int sampleLod = Lod.LodIndex;
+    const int texelStep = Lod.GridScale;
+    const int width = job.MaxX - job.MinX;
+
+    HK_ASSERT(width <= TERRAIN_CLIPMAP_SIZE);
 
     const float InvGridSizeCoarse = 1.0f / CoarserLod.GridScale;
 
-    auto resource = resourceMngr.TryGet(m_Terrain); // TODO: ѕереместить куда-нибудь выше
-    if (!resource)
-        return;
+    // The coarsest lod is blended with itself
+    const bool bSelfBlend = &Lod == &CoarserLod;
 
-    // TODO: Move this to GPU
-    for (int y = MinY; y < MaxY; y++)
+    const bool bHasLod = sampleLod >= 0 && sampleLod < job.Resource->GetLodCount();
+    const int lodResolution = bHasLod ? job.Resource->GetLodResolution(sampleLod) : 0;
+
+    // Sliding window of three lod rows with one sample of padding on both sides
+    alignas(16) float rowData[3][TERRAIN_CLIPMAP_SIZE + 4];
+    float* rowUp = rowData[0];
+    float* row = rowData[1];
+    float* rowDown = rowData[2];
+    int prevSampleY = 0;
+
+    alignas(16) float heights[TERRAIN_CLIPMAP_SIZE];
+    alignas(16) int32_t normalsX[TERRAIN_CLIPMAP_SIZE];
+    alignas(16) int32_t normalsZ[TERRAIN_CLIPMAP_SIZE];
+
+    const __m128 maxHeight = _mm_set1_ps(32768.0f);
+    const __m128 normalYSqr = _mm_set1_ps(4.0f * texelStep * texelStep);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 threeHalfs = _mm_set1_ps(1.5f);
+    const __m128 normalScale = _mm_set1_ps(127.5f);
+
+    for (int y = job.MinY; y < job.MaxY; y++)
     {
-        for (int x = MinX; x < MaxX; x++)
+        // from texture space to world space
+        int texelWorldY = (y - Lod.TextureOffset.Y) * Lod.GridScale + Lod.Offset.Y;
+        int texelWorldX = (job.MinX - Lod.TextureOffset.X) * Lod.GridScale + Lod.Offset.X;
+
+        if (bHasLod)
         {
-            int wrapX = x & CLIPMAP_WRAP_MASK;
-            int wrapY = y & CLIPMAP_WRAP_MASK;
+            // Same addressing as TerrainResource::Fetch. Neighbour texels are one lod texel apart.
+            int sampleX = (texelWorldX >> sampleLod) + (lodResolution >> 1);
+            int sampleY = (texelWorldY >> sampleLod) + (lodResolution >> 1);
 
-            // from texture space to world space
-            texelWorldPos.X = (x - Lod.TextureOffset.X) * Lod.GridScale + Lod.Offset.X;
-            texelWorldPos.Y = (y - Lod.TextureOffset.Y) * Lod.GridScale + Lod.Offset.Y;
+            // Rows are clamped to the terrain border by the resource
+            if (y == job.MinY || sampleY != prevSampleY + 1)
+            {
+                job.Resource->ReadRow(sampleLod, sampleX - 1, sampleY - 1, width + 2, rowUp);
+                job.Resource->ReadRow(sampleLod, sampleX - 1, sampleY, width + 2, row);
+            }
+            else
+            {
+                std::swap(rowUp, row);
+                std::swap(row, rowDown);
+            }
+            job.Resource->ReadRow(sampleLod, sampleX - 1, sampleY + 1, width + 2, rowDown);
+            prevSampleY = sampleY;
 
-            HK_ASSERT(wrapX >= 0 && wrapY >= 0);
-            HK_ASSERT(wrapX <= TERRAIN_CLIPMAP_SIZE - 1 && wrapY <= TERRAIN_CLIPMAP_SIZE - 1);
+            int i = 0;
+            for (; i + 4 <= width; i += 4)
+            {
+                // Sample i is at index i + 1 of the padded rows
+                __m128 h = _mm_loadu_ps(row + i + 1);
+                __m128 h0 = _mm_loadu_ps(rowUp + i + 1);
+                __m128 h1 = _mm_loadu_ps(row + i);
+                __m128 h2 = _mm_loadu_ps(row + i + 2);
+                __m128 h3 = _mm_loadu_ps(rowDown + i + 1);
 
-            int sampleLod = Lod.LodIndex;
+                _mm_storeu_ps(heights + i, _mm_min_ps(h, maxHeight));
 
-            Float2& heightMap = Lod.HeightMap[wrapY * TERRAIN_CLIPMAP_SIZE + wrapX];
+                __m128 nx = _mm_sub_ps(h1, h2);
+                __m128 nz = _mm_sub_ps(h0, h3);
 
-            heightMap.X = resource->Fetch(texelWorldPos.X, texelWorldPos.Y, sampleLod);
+                // 1/sqrt with one Newton-Raphson step
+                __m128 lengthSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(nz, nz)), normalYSqr);
+                __m128 invLength = _mm_rsqrt_ps(lengthSqr);
+                invLength = _mm_mul_ps(invLength, _mm_sub_ps(threeHalfs, _mm_mul_ps(_mm_mul_ps(half, lengthSqr), _mm_mul_ps(invLength, invLength))));
 
-            if (heightMap.X > 32768)
-                heightMap.X = 32768;
+                nx = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(nx, invLength), normalScale), normalScale);
+                nz = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(nz, invLength), normalScale), normalScale);
 
-            const int texelStep = Lod.GridScale;
-            h[0] = resource->Fetch(texelWorldPos.X, texelWorldPos.Y - texelStep, sampleLod);
-            h[1] = resource->Fetch(texelWorldPos.X - texelStep, texelWorldPos.Y, sampleLod);
-            h[2] = resource->Fetch(texelWorldPos.X + texelStep, texelWorldPos.Y, sampleLod);
-            h[3] = resource->Fetch(texelWorldPos.X, texelWorldPos.Y + texelStep, sampleLod);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(normalsX + i), _mm_cvttps_epi32(nx));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(normalsZ + i), _mm_cvttps_epi32(nz));
+            }
 
-            // normal = tangent ^ binormal
-            // correct tangent t = cross( binormal, normal );
-            //Float3 n = Math::Cross( Float3( 0.0, h[3] - h[0], 2.0f * texelStep ),
-            //                        Float3( 2.0f * texelStep, h[2] - h[1], 0.0 ) );
+            for (; i < width; i++)
+            {
+                float h = row[i + 1];
+                float h0 = rowUp[i + 1];
+                float h1 = row[i];
+                float h2 = row[i + 2];
+                float h3 = rowDown[i + 1];
 
-            n.X = h[1] - h[2];
-            n.Y = 2 * texelStep;
-            n.Z = h[0] - h[3];
-            //n.NormalizeSelf();
-            float invLength = Math::RSqrt(n.X * n.X + n.Y * n.Y + n.Z * n.Z);
-            n.X *= invLength;
-            n.Z *= invLength;
+                heights[i] = Math::Min(h, 32768.0f);
 
-            byte* normal = &Lod.NormalMap[(wrapY * TERRAIN_CLIPMAP_SIZE + wrapX) * 4];
-            normal[0] = n.X * 127.5f + 127.5f;
-            normal[1] = n.Z * 127.5f + 127.5f;
+                float nx = h1 - h2;
+                float nz = h0 - h3;
+                float invLength = Math::RSqrt(nx * nx + 4.0f * texelStep * texelStep + nz * nz);
 
-            int ofsX = texelWorldPos.X - CoarserLod.Offset.X;
-            int ofsY = texelWorldPos.Y - CoarserLod.Offset.Y;
+                normalsX[i] = int32_t(nx * invLength * 127.5f + 127.5f);
+                normalsZ[i] = int32_t(nz * invLength * 127.5f + 127.5f);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < width; i++)
+            {
+                heights[i] = 0;
+                normalsX[i] = 127;
+                normalsZ[i] = 127;
+            }
+        }
 
-            // from world space to texture space of coarser level
-            wrapX = ofsX / CoarserLod.GridScale + CoarserLod.TextureOffset.X;
-            wrapY = ofsY / CoarserLod.GridScale + CoarserLod.TextureOffset.Y;
+        int wrapY = y & CLIPMAP_WRAP_MASK;
 
-            // wrap coordinates
-            wrapX &= CLIPMAP_WRAP_MASK;
-            wrapY &= CLIPMAP_WRAP_MASK;
-            int wrapX2 = (wrapX + 1) & CLIPMAP_WRAP_MASK;
-            int wrapY2 = (wrapY + 1) & CLIPMAP_WRAP_MASK;
+        HK_ASSERT(wrapY >= 0 && wrapY <= TERRAIN_CLIPMAP_SIZE - 1);
 
-            float fx = Math::Fract(float(ofsX) * InvGridSizeCoarse);
-            float fy = Math::Fract(float(ofsY) * InvGridSizeCoarse);
+        // from world space to texture space of coarser level
+        int ofsY = texelWorldY - CoarserLod.Offset.Y;
+        int coarseY = (ofsY / CoarserLod.GridScale + CoarserLod.TextureOffset.Y) & CLIPMAP_WRAP_MASK;
+        int coarseY2 = (coarseY + 1) & CLIPMAP_WRAP_MASK;
+        float fy = Math::Fract(float(ofsY) * InvGridSizeCoarse);
 
-            h[0] = CoarserLod.HeightMap[wrapY * TERRAIN_CLIPMAP_SIZE + wrapX].X;
-            h[1] = CoarserLod.HeightMap[wrapY * TERRAIN_CLIPMAP_SIZE + wrapX2].X;
-            h[2] = CoarserLod.HeightMap[wrapY2 * TERRAIN_CLIPMAP_SIZE + wrapX2].X;
-            h[3] = CoarserLod.HeightMap[wrapY2 * TERRAIN_CLIPMAP_SIZE + wrapX].X;
+        Float2* heightMapRow = Lod.HeightMap + wrapY * TERRAIN_CLIPMAP_SIZE;
+        byte* normalMapRow = Lod.NormalMap + wrapY * TERRAIN_CLIPMAP_SIZE * 4;
 
-            heightMap.Y = Math::Bilerp(h[0], h[1], h[3], h[2], Float2(fx, fy));
+        Float2 const* coarseHeightRow = CoarserLod.HeightMap + coarseY * TERRAIN_CLIPMAP_SIZE;
+        Float2 const* coarseHeightRow2 = CoarserLod.HeightMap + coarseY2 * TERRAIN_CLIPMAP_SIZE;
+        byte const* coarseNormalRow = CoarserLod.NormalMap + coarseY * TERRAIN_CLIPMAP_SIZE * 4;
+        byte const* coarseNormalRow2 = CoarserLod.NormalMap + coarseY2 * TERRAIN_CLIPMAP_SIZE * 4;
 
-            //float zf = floor( zf_zd );
-            //float zd = zf_zd / 512 + 256;
+        for (int i = 0; i < width; i++)
+        {
+            int wrapX = (job.MinX + i) & CLIPMAP_WRAP_MASK;
+
+            Float2& heightMap = heightMapRow[wrapX];
+            byte* normal = &normalMapRow[wrapX * 4];
+
+            heightMap.X = heights[i];
+            normal[0] = normalsX[i];
+            normal[1] = normalsZ[i];
+
+            if (bSelfBlend)
+            {
+                heightMap.Y = heightMap.X;
+                normal[2] = normal[0];
+                normal[3] = normal[1];
+                continue;
+            }
+
+            int ofsX = texelWorldX + i * texelStep - CoarserLod.Offset.X;
+
+            int coarseX = (ofsX / CoarserLod.GridScale + CoarserLod.TextureOffset.X) & CLIPMAP_WRAP_MASK;
+            int coarseX2 = (coarseX + 1) & CLIPMAP_WRAP_MASK;
 
-            byte* n0 = &CoarserLod.NormalMap[(wrapY * TERRAIN_CLIPMAP_SIZE + wrapX) * 4];
-            byte* n1 = &CoarserLod.NormalMap[(wrapY * TERRAIN_CLIPMAP_SIZE + wrapX2) * 4];
-            byte* n2 = &CoarserLod.NormalMap[(wrapY2 * TERRAIN_CLIPMAP_SIZE + wrapX2) * 4];
-            byte* n3 = &CoarserLod.NormalMap[(wrapY2 * TERRAIN_CLIPMAP_SIZE + wrapX) * 4];
+            Float2 f(Math::Fract(float(ofsX) * InvGridSizeCoarse), fy);
 
-            normal[2] = Math::Clamp(Math::Bilerp(float(n0[0]), float(n1[0]), float(n3[0]), float(n2[0]), Float2(fx, fy)), 0.0f, 255.0f);
-            normal[3] = Math::Clamp(Math::Bilerp(float(n0[1]), float(n1[1]), float(n3[1]), float(n2[1]), Float2(fx, fy)), 0.0f, 255.0f);
+            heightMap.Y = Math::Bilerp(coarseHeightRow[coarseX].X, coarseHeightRow[coarseX2].X, coarseHeightRow2[coarseX].X, coarseHeightRow2[coarseX2].X, f);
 
-            //heightMap.Y = CoarserLod.HeightMap[wrapY * TextureSize + wrapX].X;
+            byte const* n0 = &coarseNormalRow[coarseX * 4];
+            byte const* n1 = &coarseNormalRow[coarseX2 * 4];
+            byte const* n2 = &coarseNormalRow2[coarseX2 * 4];
+            byte const* n3 = &coarseNormalRow2[coarseX * 4];
+
+            normal[2] = Math::Clamp(Math::Bilerp(float(n0[0]), float(n1[0]), float(n3[0]), float(n2[0]), f), 0.0f, 255.0f);
+            normal[3] = Math::Clamp(Math::Bilerp(float(n0[1]), float(n1[1]), float(n3[1]), float(n2[1]), f), 0.0f, 255.0f);
         }
     }
 }
 
+void UpdateClipmapRowsJob(void* data)
+{
+    UpdateClipmapRows(*static_cast<ClipmapUpdateJob const*>(data));
+}
+
+} // namespace
+
+void TerrainView::UpdateRect(TerrainLodInfo const& Lod, TerrainLodInfo const& CoarserLod, int MinX, int MaxX, int MinY, int MaxY)
+{
+    auto& resourceMngr = GameApplication::sGetResourceManager();
+
+    auto resource = resourceMngr.TryGet(m_Terrain); // TODO: ѕереместить куда-нибудь выше
+    if (!resource)
+        return;
+
+    // Queue the tiles under the updated texels and their neighbours. The jobs sample the coarser lods until they arrive.
+    int lodResolution = resource->GetLodResolution(Lod.LodIndex);
+    int minSampleX = (((MinX - Lod.TextureOffset.X) * Lod.GridScale + Lod.Offset.X) >> Lod.LodIndex) + (lodResolution >> 1);
+    int minSampleY = (((MinY - Lod.TextureOffset.Y) * Lod.GridScale + Lod.Offset.Y) >> Lod.LodIndex) + (lodResolution >> 1);
+    resource->RequestTiles(Lod.LodIndex, minSampleX - 1, minSampleY - 1, minSampleX + (MaxX - MinX), minSampleY + (MaxY - MinY));
+
+    ClipmapUpdateJob job;
+    job.Resource = resource;
+    job.Lod = &Lod;
+    job.CoarserLod = &CoarserLod;
+    job.MinX = MinX;
+    job.MaxX = MaxX;
+
+    int numRows = MaxY - MinY;
+
+    HK_ASSERT(numRows <= TERRAIN_CLIPMAP_SIZE);
+
+    if ((MaxX - MinX) * numRows < CLIPMAP_PARALLEL_UPDATE_TEXELS)
+    {
+        job.MinY = MinY;
+        job.MaxY = MaxY;
+        UpdateClipmapRows(job);
+        return;
+    }
+
+    // TODO: Move this to GPU
+    ClipmapUpdateJob jobs[TERRAIN_CLIPMAP_SIZE / CLIPMAP_UPDATE_ROWS_PER_JOB];
+
+    auto* jobList = GameApplication::sGetRenderFrontendJobList();
+
+    int numJobs = 0;
+    for (int y = MinY; y < MaxY; y += CLIPMAP_UPDATE_ROWS_PER_JOB)
+    {
+        ClipmapUpdateJob& rowsJob = jobs[numJobs++];
+        rowsJob = job;
+        rowsJob.MinY = y;
+        rowsJob.MaxY = Math::Min(y + CLIPMAP_UPDATE_ROWS_PER_JOB, MaxY);
+
+        jobList->AddJob(UpdateClipmapRowsJob, &rowsJob);
+    }
+
+    jobList->SubmitAndWait();
+}
+
 void TerrainView::UpdateTextures()
 {
     const int count = TERRAIN_CLIPMAP_SIZE * TERRAIN_CLIPMAP_SIZE;
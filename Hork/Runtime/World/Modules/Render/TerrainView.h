@@ -57,6 +57,8 @@ struct TerrainLodInfo
     int LodIndex;
     /// Fource update flag
     bool bForceUpdateTexture : 1;
+    /// Version of the resource lod the texture was updated from
+    uint32_t TileVersion;
     /// Elevation minimum height
     float MinH;
     /// Elevation maximum height
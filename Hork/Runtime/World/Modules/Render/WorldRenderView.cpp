@@ -43,6 +43,9 @@ ColorGradingParameters::ColorGradingParameters()
 void ColorGradingParameters::SetLUT(TextureHandle Texture)
 {
     m_LUT = Texture;
+
+    // LUT is sampled as a whole and must not lose its mip levels
+    GameApplication::sGetResourceManager().DisableTextureStreaming(Texture.ID);
 }
 
 void ColorGradingParameters::SetGrain(Float3 const& grain)
@@ -0,0 +1,62 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "Prefab.h"
+
+HK_NAMESPACE_BEGIN
+
+uint32_t Prefab::AddObject(GameObjectDesc const& desc, uint32_t parentIndex)
+{
+    if (m_Objects.IsEmpty())
+    {
+        HK_ASSERT(parentIndex == InvalidIndex);
+        parentIndex = InvalidIndex;
+    }
+    else
+    {
+        HK_IF_NOT_ASSERT(parentIndex < m_Objects.Size()) { parentIndex = 0; }
+    }
+
+    auto& object = m_Objects.Add();
+    object.Desc = desc;
+    object.Desc.Parent = {};
+    object.Parent = parentIndex;
+    object.HierarchyLevel = parentIndex != InvalidIndex ? m_Objects[parentIndex].HierarchyLevel + 1 : 0;
+
+    return m_Objects.Size() - 1;
+}
+
+void Prefab::Clear()
+{
+    m_Objects.Clear();
+    m_Components.Clear();
+}
+
+HK_NAMESPACE_END
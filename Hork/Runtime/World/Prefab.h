@@ -0,0 +1,115 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "World.h"
+
+#include <Hork/Core/Ref.h>
+
+HK_NAMESPACE_BEGIN
+
+/// Template of an object hierarchy with preconfigured components.
+/// Instances are spawned in batches with World::CreateObjects.
+class Prefab final : public RefCounted
+{
+    friend class World;
+
+public:
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    /// Add an object to the hierarchy. The first object is the root, other objects must be attached to
+    /// an object added earlier. desc.Parent is ignored. Returns the object index.
+    uint32_t                AddObject(GameObjectDesc const& desc, uint32_t parentIndex = InvalidIndex);
+
+    /// Add a component to the object. The returned prototype is configured like an ordinary component
+    /// before BeginPlay. Instances receive its state through the same Read/Write methods that
+    /// WorldSnapshot uses: the prototype is written once per CreateObjects call and read into every instance.
+    template <typename ComponentType>
+    ComponentType*          AddComponent(uint32_t objectIndex);
+
+    uint32_t                GetObjectCount() const { return m_Objects.Size(); }
+    uint32_t                GetComponentCount() const { return m_Components.Size(); }
+
+    void                    Clear();
+
+private:
+    struct Object
+    {
+        GameObjectDesc      Desc;
+        uint32_t            Parent;
+        uint32_t            HierarchyLevel;
+    };
+
+    struct ComponentPrototype
+    {
+        uint32_t            ObjectIndex;
+        ComponentMode       Mode;
+
+        virtual             ~ComponentPrototype() = default;
+
+        virtual Component const* GetPrototype() const = 0;
+        virtual ComponentManagerBase* GetManager(World* world) const = 0;
+    };
+
+    template <typename ComponentType>
+    struct ComponentPrototypeImpl final : ComponentPrototype
+    {
+        ComponentType       Prototype;
+
+        Component const*    GetPrototype() const override { return &Prototype; }
+        ComponentManagerBase* GetManager(World* world) const override { return &world->GetComponentManager<ComponentType>(); }
+    };
+
+    Vector<Object>          m_Objects;
+    Vector<UniqueRef<ComponentPrototype>> m_Components;
+};
+
+template <typename ComponentType>
+HK_INLINE ComponentType* Prefab::AddComponent(uint32_t objectIndex)
+{
+    static_assert(HK_HAS_METHOD(ComponentType, Read) && HK_HAS_METHOD(ComponentType, Write), "Prefab components must implement Read and Write");
+
+    HK_IF_NOT_ASSERT(objectIndex < m_Objects.Size()) { return nullptr; }
+
+    auto prototype = MakeUnique<ComponentPrototypeImpl<ComponentType>>();
+    prototype->ObjectIndex = objectIndex;
+    prototype->Mode = ComponentType::Mode;
+
+    // Mark the object dynamic up front so instances are not moved to the dynamic hierarchy on creation
+    if (ComponentType::Mode == ComponentMode::Dynamic)
+        m_Objects[objectIndex].Desc.IsDynamic = true;
+
+    ComponentType* component = &prototype->Prototype;
+    m_Components.Add(std::move(prototype));
+    return component;
+}
+
+HK_NAMESPACE_END
@@ -0,0 +1,162 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "TransformHierarchy.h"
+
+HK_NAMESPACE_BEGIN
+
+void TransformHierarchyLevel::Reserve(uint32_t capacity)
+{
+    if (capacity == 0)
+        return;
+
+    Owner.Reserve(capacity);
+    Parent.Reserve(capacity);
+    Flags.Reserve(capacity);
+    Position.Reserve(capacity);
+    Rotation.Reserve(capacity);
+    Scale.Reserve(capacity);
+    WorldPosition.Reserve(capacity);
+    WorldRotation.Reserve(capacity);
+    WorldScale.Reserve(capacity);
+    WorldTransform.Reserve(capacity);
+}
+
+uint32_t TransformHierarchyLevel::Add(GameObject* owner)
+{
+    uint32_t index = Owner.Size();
+
+    Owner.EmplaceBack(owner);
+    Parent.EmplaceBack(NoParent);
+    Flags.EmplaceBack(uint8_t(DIRTY));
+    Position.EmplaceBack();
+    Rotation.EmplaceBack();
+    Scale.EmplaceBack(1.0f);
+    WorldPosition.EmplaceBack();
+    WorldRotation.EmplaceBack();
+    WorldScale.EmplaceBack(1.0f);
+    WorldTransform.EmplaceBack();
+
+    return index;
+}
+
+void TransformHierarchyLevel::Copy(uint32_t index, TransformHierarchyLevel const& source, uint32_t sourceIndex)
+{
+    Flags[index] = source.Flags[sourceIndex];
+    Position[index] = source.Position[sourceIndex];
+    Rotation[index] = source.Rotation[sourceIndex];
+    Scale[index] = source.Scale[sourceIndex];
+    WorldPosition[index] = source.WorldPosition[sourceIndex];
+    WorldRotation[index] = source.WorldRotation[sourceIndex];
+    WorldScale[index] = source.WorldScale[sourceIndex];
+    WorldTransform[index] = source.WorldTransform[sourceIndex];
+}
+
+GameObject* TransformHierarchyLevel::RemoveSwap(uint32_t index)
+{
+    uint32_t last = Owner.Size() - 1;
+
+    GameObject* moved = nullptr;
+    if (index != last)
+    {
+        moved = Owner[last];
+
+        Owner[index] = moved;
+        Parent[index] = Parent[last];
+        Copy(index, *this, last);
+    }
+
+    Owner.PopBack();
+    Parent.PopBack();
+    Flags.PopBack();
+    Position.PopBack();
+    Rotation.PopBack();
+    Scale.PopBack();
+    WorldPosition.PopBack();
+    WorldRotation.PopBack();
+    WorldScale.PopBack();
+    WorldTransform.PopBack();
+
+    // Release memory only after most of the level is gone, so removals don't reallocate every stream
+    if (Owner.Size() < Owner.Capacity() / 4)
+        ShrinkToFit();
+
+    return moved;
+}
+
+void TransformHierarchyLevel::ShrinkToFit()
+{
+    Owner.ShrinkToFit();
+    Parent.ShrinkToFit();
+    Flags.ShrinkToFit();
+    Position.ShrinkToFit();
+    Rotation.ShrinkToFit();
+    Scale.ShrinkToFit();
+    WorldPosition.ShrinkToFit();
+    WorldRotation.ShrinkToFit();
+    WorldScale.ShrinkToFit();
+    WorldTransform.ShrinkToFit();
+}
+
+void TransformHierarchyLevel::Clear()
+{
+    Owner.Clear();
+    Parent.Clear();
+    Flags.Clear();
+    Position.Clear();
+    Rotation.Clear();
+    Scale.Clear();
+    WorldPosition.Clear();
+    WorldRotation.Clear();
+    WorldScale.Clear();
+    WorldTransform.Clear();
+}
+
+void TransformHierarchyLevel::ClearDirty()
+{
+    uint32_t count = Flags.Size();
+    for (uint32_t pageIndex = 0; pageIndex < Flags.GetPageCount() && count; ++pageIndex)
+    {
+        uint8_t* flags = Flags.GetPageData(pageIndex);
+        uint32_t batchSize = Math::Min<uint32_t>(count, PageSize);
+
+        for (uint32_t i = 0; i < batchSize; ++i)
+            flags[i] &= ~DIRTY;
+
+        count -= batchSize;
+    }
+}
+
+void TransformHierarchyLevel::UpdateWorldTransformMatrix(uint32_t index)
+{
+    WorldTransform[index].Compose(WorldPosition[index], WorldRotation[index].ToMatrix3x3(), WorldScale[index]);
+}
+
+HK_NAMESPACE_END
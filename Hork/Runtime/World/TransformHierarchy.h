@@ -0,0 +1,99 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/Core/Containers/PageStorage.h>
+#include <Hork/Math/Transform.h>
+
+HK_NAMESPACE_BEGIN
+
+class GameObject;
+
+/// One level of the world transform hierarchy stored as structure of arrays. Hierarchy passes touch
+/// only the streams they need. All streams share the page size, so the same page of every stream
+/// holds the same transforms.
+class TransformHierarchyLevel final : public Noncopyable
+{
+public:
+    static constexpr size_t PageSize = 64;
+
+    /// Parent references point to the previous level. The high bit selects the dynamic hierarchy.
+    static constexpr uint32_t NoParent = ~0u;
+    static constexpr uint32_t DynamicParentBit = HK_BIT(31);
+
+    enum FLAGS : uint8_t
+    {
+        ABSOLUTE_POSITION = HK_BIT(0),
+        ABSOLUTE_ROTATION = HK_BIT(1),
+        ABSOLUTE_SCALE = HK_BIT(2),
+        LOCK_WORLD_POSITION_AND_ROTATION = HK_BIT(3),
+        /// Transform changed since the last hierarchy update
+        DIRTY = HK_BIT(4)
+    };
+
+    template <typename T>
+    using Stream = PageStorage<T, PageSize>;
+
+    Stream<GameObject*>     Owner;
+    Stream<uint32_t>        Parent;
+    Stream<uint8_t>         Flags;
+    Stream<Float3>          Position;
+    Stream<Quat>            Rotation;
+    Stream<Float3>          Scale;
+    Stream<Float3>          WorldPosition;
+    Stream<Quat>            WorldRotation;
+    Stream<Float3>          WorldScale;
+    Stream<Float3x4>        WorldTransform;
+
+    uint32_t                Size() const { return Owner.Size(); }
+
+    void                    Reserve(uint32_t capacity);
+
+    /// Add a transform with identity local and world state. Returns the transform index.
+    uint32_t                Add(GameObject* owner);
+
+    /// Copy the transform state from another level. Owner and parent are not copied.
+    void                    Copy(uint32_t index, TransformHierarchyLevel const& source, uint32_t sourceIndex);
+
+    /// Remove the transform by moving the last one to its place. Returns the owner of the moved transform.
+    /// Memory is released when the level drops below a quarter of its capacity.
+    GameObject*             RemoveSwap(uint32_t index);
+
+    void                    ShrinkToFit();
+
+    void                    Clear();
+
+    void                    ClearDirty();
+
+    void                    UpdateWorldTransformMatrix(uint32_t index);
+};
+
+HK_NAMESPACE_END
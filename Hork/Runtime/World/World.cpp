@@ -30,8 +30,10 @@ SOFTWARE.
 
 #include "World.h"
 #include "Component.h"
+#include "Prefab.h"
 
 #include <Hork/Runtime/World/DebugRenderer.h>
+#include <Hork/Core/IO.h>
 
 HK_NAMESPACE_BEGIN
 
@@ -126,24 +128,144 @@ GameObjectHandle World::CreateObject(GameObjectDesc const& desc, GameObject*& ga
     gameObject->m_Flags.IsDynamic = dynamic;
     gameObject->m_Parent = desc.Parent;
     gameObject->m_HierarchyLevel = hierarchyLevel;
-    gameObject->m_TransformData = AllocateTransformData(dynamic ? HierarchyType::Dynamic : HierarchyType::Static, hierarchyLevel);
-    gameObject->m_TransformData->Owner = gameObject;
-    gameObject->m_TransformData->LockWorldPositionAndRotation = false;
-    gameObject->m_TransformData->AbsolutePosition = desc.AbsolutePosition;
-    gameObject->m_TransformData->AbsoluteRotation = desc.AbsoluteRotation;
-    gameObject->m_TransformData->AbsoluteScale    = desc.AbsoluteScale;
-    gameObject->m_TransformData->Position = desc.Position;
-    gameObject->m_TransformData->Rotation = desc.Rotation;
-    gameObject->m_TransformData->Scale    = desc.Scale;
+    AllocateTransformData(gameObject, dynamic ? HierarchyType::Dynamic : HierarchyType::Static, hierarchyLevel);
+
+    auto& transform = *gameObject->m_TransformLevel;
+    uint32_t transformIndex = gameObject->m_TransformIndex;
+
+    uint8_t flags = TransformHierarchyLevel::DIRTY;
+    if (desc.AbsolutePosition)
+        flags |= TransformHierarchyLevel::ABSOLUTE_POSITION;
+    if (desc.AbsoluteRotation)
+        flags |= TransformHierarchyLevel::ABSOLUTE_ROTATION;
+    if (desc.AbsoluteScale)
+        flags |= TransformHierarchyLevel::ABSOLUTE_SCALE;
+
+    transform.Flags[transformIndex]    = flags;
+    transform.Position[transformIndex] = desc.Position;
+    transform.Rotation[transformIndex] = desc.Rotation;
+    transform.Scale[transformIndex]    = desc.Scale;
 
     gameObject->LinkToParent();
-    gameObject->m_TransformData->UpdateWorldTransform();
+    gameObject->ComputeWorldTransform();
 
     gameObject->m_Name = desc.Name;
 
     return handle;
 }
 
+void World::CreateObjects(Prefab const& prefab, ArrayView<Transform> transforms, GameObjectHandle parent, Vector<GameObjectHandle>* rootObjects)
+{
+    uint32_t objectCount = prefab.m_Objects.Size();
+    uint32_t componentCount = prefab.m_Components.Size();
+    uint32_t instanceCount = transforms.Size();
+
+    if (!objectCount || !instanceCount)
+        return;
+
+    GameObject* parentObject = GetObject(parent);
+    uint32_t baseLevel = parentObject ? parentObject->m_HierarchyLevel + 1 : 0;
+
+    // Count transforms per hierarchy level. Dynamic parents make the whole subtree dynamic.
+    Vector<bool> isDynamic(objectCount);
+    Vector<uint32_t> levelCount[2];
+    for (uint32_t i = 0; i < objectCount; ++i)
+    {
+        auto& object = prefab.m_Objects[i];
+
+        if (object.Parent == Prefab::InvalidIndex)
+            isDynamic[i] = object.Desc.IsDynamic || (parentObject && parentObject->IsDynamic());
+        else
+            isDynamic[i] = object.Desc.IsDynamic || isDynamic[object.Parent];
+
+        auto& counts = levelCount[isDynamic[i] ? 1 : 0];
+        uint32_t level = baseLevel + object.HierarchyLevel;
+        if (counts.Size() <= level)
+            counts.Resize(level + 1);
+        counts[level] += instanceCount;
+    }
+
+    for (uint32_t level = 0; level < levelCount[0].Size(); ++level)
+        ReserveTransformData(HierarchyType::Static, level, levelCount[0][level]);
+    for (uint32_t level = 0; level < levelCount[1].Size(); ++level)
+        ReserveTransformData(HierarchyType::Dynamic, level, levelCount[1][level]);
+
+    m_ObjectStorage.Reserve(m_ObjectStorage.Size() + objectCount * instanceCount);
+
+    // Resolve component managers once per batch
+    Vector<ComponentManagerBase*> managers(componentCount);
+    for (uint32_t i = 0; i < componentCount; ++i)
+        managers[i] = prefab.m_Components[i]->GetManager(this);
+
+    for (uint32_t i = 0; i < componentCount; ++i)
+    {
+        bool first = true;
+        for (uint32_t j = 0; j < i && first; ++j)
+            first = managers[j] != managers[i];
+        if (!first)
+            continue;
+
+        uint32_t count = 0;
+        for (uint32_t j = i; j < componentCount; ++j)
+            count += managers[j] == managers[i];
+        managers[i]->ReserveComponents(count * instanceCount);
+    }
+
+    m_ComponentsToInitialize.Reserve(m_ComponentsToInitialize.Size() + componentCount * instanceCount);
+
+    // Serialize the prototypes once, every instance reads its component state from the same buffer
+    File prototypeData = File::sOpenWriteToMemory("Prefab");
+    for (uint32_t i = 0; i < componentCount; ++i)
+        managers[i]->WriteComponent(prefab.m_Components[i]->GetPrototype(), prototypeData);
+
+    File prototypeStream = File::sOpenRead("Prefab", prototypeData.GetHeapPtr(), prototypeData.GetOffset());
+
+    if (rootObjects)
+        rootObjects->Reserve(rootObjects->Size() + instanceCount);
+
+    Vector<GameObject*> objects(objectCount);
+    for (Transform const& transform : transforms)
+    {
+        for (uint32_t i = 0; i < objectCount; ++i)
+        {
+            auto& object = prefab.m_Objects[i];
+
+            GameObjectDesc desc = object.Desc;
+            desc.IsDynamic = isDynamic[i];
+
+            if (object.Parent == Prefab::InvalidIndex)
+            {
+                desc.Parent = parent;
+                desc.Position = transform.Position;
+                desc.Rotation = transform.Rotation;
+                desc.Scale = transform.Scale;
+            }
+            else
+                desc.Parent = objects[object.Parent]->m_Handle;
+
+            auto handle = CreateObject(desc, objects[i]);
+
+            if (rootObjects && i == 0)
+                rootObjects->Add(handle);
+        }
+
+        prototypeStream.SeekSet(0);
+        for (uint32_t i = 0; i < componentCount; ++i)
+        {
+            auto& prototype = prefab.m_Components[i];
+            Component* component = managers[i]->CreateComponentInternal(objects[prototype->ObjectIndex], prototype->Mode);
+            managers[i]->ReadComponent(component, prototypeStream);
+        }
+    }
+}
+
+GameObjectHandle World::CreateObject(Prefab const& prefab, Transform const& transform, GameObjectHandle parent)
+{
+    Vector<GameObjectHandle> rootObjects;
+    CreateObjects(prefab, {&transform, 1}, parent, &rootObjects);
+    return !rootObjects.IsEmpty() ? rootObjects[0] : GameObjectHandle{};
+}
+
 void World::SetParent(GameObject* object, GameObject* parent, GameObject::TransformRule transformRule)
 {
     if (object == parent)
@@ -177,17 +299,18 @@ void World::UpdateHierarchy(GameObject* object, GameObject::TransformRule transf
 
     UpdateHierarchyData(object, object->IsDynamic());
 
-    object->m_TransformData->Parent = parent ? parent->m_TransformData : nullptr;
+    object->m_TransformLevel->Parent[object->m_TransformIndex] = parent ? parent->GetTransformRef() : TransformHierarchyLevel::NoParent;
 
     switch (transformRule)
     {
     case GameObject::TransformRule::KeepRelative:
-        object->m_TransformData->UpdateWorldTransform();
+        object->ComputeWorldTransform();
+        object->MarkTransformDirty();
         break;
     case GameObject::TransformRule::KeepWorld:
-        object->SetWorldTransform(object->m_TransformData->WorldPosition,
-                                  object->m_TransformData->WorldRotation,
-                                  object->m_TransformData->WorldScale);
+        object->SetWorldTransform(object->GetWorldPosition(),
+                                  object->GetWorldRotation(),
+                                  object->GetWorldScale());
         break;
     }
 
@@ -208,21 +331,24 @@ void World::UpdateHierarchyData(GameObject* object, bool wasDynamic)
 
     if (newLevel != oldLevel || isDynamic != wasDynamic)
     {
-        GameObject::TransformData* oldData = object->m_TransformData;
-        GameObject::TransformData* newData = AllocateTransformData(isDynamic ? HierarchyType::Dynamic : HierarchyType::Static, newLevel);
+        TransformHierarchyLevel* oldTransformLevel = object->m_TransformLevel;
+        uint32_t oldTransformIndex = object->m_TransformIndex;
+
+        AllocateTransformData(object, isDynamic ? HierarchyType::Dynamic : HierarchyType::Static, newLevel);
 
-        *newData = std::move(*oldData);
+        object->m_TransformLevel->Copy(object->m_TransformIndex, *oldTransformLevel, oldTransformIndex);
+        object->m_TransformLevel->Parent[object->m_TransformIndex] = oldTransformLevel->Parent[oldTransformIndex];
+        object->MarkTransformDirty();
 
         object->m_HierarchyLevel = newLevel;
-        object->m_TransformData = newData;
 
+        uint32_t transformRef = object->GetTransformRef();
         for (auto it = object->GetChildren(); it.IsValid(); ++it)
         {
-            GameObject::TransformData* transformData = it->m_TransformData;
-            transformData->Parent = newData;
+            it->m_TransformLevel->Parent[it->m_TransformIndex] = transformRef;
         }
 
-        FreeTransformData(wasDynamic ? HierarchyType::Dynamic : HierarchyType::Static, oldLevel, oldData);
+        FreeTransformData(oldTransformLevel, oldTransformIndex);
     }
 }
 
@@ -305,8 +431,8 @@ void World::DestroyObjectNow(GameObject* gameObject)
 
     // TODO: Where to free transform data?
 
-    auto hierarchyType = gameObject->IsDynamic() ? HierarchyType::Dynamic : HierarchyType::Static;
-    FreeTransformData(hierarchyType, gameObject->m_HierarchyLevel, gameObject->m_TransformData);
+    FreeTransformData(gameObject->m_TransformLevel, gameObject->m_TransformIndex);
+    gameObject->m_TransformLevel = nullptr;
 
     m_ObjectsToDelete.Add(gameObject->GetHandle());
 }
@@ -509,95 +635,165 @@ void World::DrawDebug(DebugRenderer& renderer)
         function.Invoke(renderer);
 }
 
-Vector<PageStorage<GameObject::TransformData>>& World::GetTransformHierarchy(HierarchyType hierarchyType)
+World::TransformHierarchy& World::GetTransformHierarchy(HierarchyType hierarchyType)
 {
     return m_TransformHierarchy[static_cast<int>(hierarchyType)];
 }
 
-GameObject::TransformData* World::AllocateTransformData(HierarchyType hierarchyType, uint32_t hierarchyLevel)
+void World::AllocateTransformData(GameObject* object, HierarchyType hierarchyType, uint32_t hierarchyLevel)
 {
     auto& transformHierarchy = GetTransformHierarchy(hierarchyType);
 
     while (transformHierarchy.Size() <= hierarchyLevel)
-        transformHierarchy.Add();
+        transformHierarchy.Add(MakeUnique<TransformHierarchyLevel>());
 
-    return transformHierarchy[hierarchyLevel].EmplaceBack();
+    object->m_TransformLevel = transformHierarchy[hierarchyLevel].RawPtr();
+    object->m_TransformIndex = object->m_TransformLevel->Add(object);
 }
 
-void World::FreeTransformData(HierarchyType hierarchyType, uint32_t hierarchyLevel, GameObject::TransformData* transformData)
+void World::ReserveTransformData(HierarchyType hierarchyType, uint32_t hierarchyLevel, uint32_t count)
 {
     auto& transformHierarchy = GetTransformHierarchy(hierarchyType);
-    auto& storage = transformHierarchy[hierarchyLevel];
 
-    auto* last = &storage[storage.Size() - 1];
+    while (transformHierarchy.Size() <= hierarchyLevel)
+        transformHierarchy.Add(MakeUnique<TransformHierarchyLevel>());
+
+    auto& level = *transformHierarchy[hierarchyLevel];
+    level.Reserve(level.Size() + count);
+}
 
-    if (transformData != last)
+void World::FreeTransformData(TransformHierarchyLevel* level, uint32_t index)
+{
+    if (GameObject* moved = level->RemoveSwap(index))
     {
-        *transformData = std::move(*last);
-        transformData->Owner->m_TransformData = transformData;
+        moved->m_TransformIndex = index;
 
-        for (auto childIt = transformData->Owner->GetChildren(); childIt.IsValid(); ++childIt)
+        uint32_t transformRef = moved->GetTransformRef();
+        for (auto childIt = moved->GetChildren(); childIt.IsValid(); ++childIt)
         {
-            childIt->m_TransformData->Parent = transformData;
+            childIt->m_TransformLevel->Parent[childIt->m_TransformIndex] = transformRef;
         }
     }
-
-    storage.PopBack();
-    storage.ShrinkToFit();
 }
 
-void World::UpdateWorldTransforms()
+namespace
 {
-    DestroyObjectsAndComponents();
 
-    struct UpdateRoot
+void UpdateRootTransforms(TransformHierarchyLevel& transforms)
+{
+    constexpr uint32_t PageSize = TransformHierarchyLevel::PageSize;
+
+    uint32_t count = transforms.Size();
+    for (uint32_t pageIndex = 0, first = 0; first < count; ++pageIndex, first += PageSize)
     {
-        HK_FORCEINLINE void Visit(GameObject::TransformData& transform)
+        uint32_t batchSize = Math::Min(count - first, PageSize);
+
+        uint8_t const* flags          = transforms.Flags.GetPageData(pageIndex);
+        Float3 const*  position       = transforms.Position.GetPageData(pageIndex);
+        Quat const*    rotation       = transforms.Rotation.GetPageData(pageIndex);
+        Float3 const*  scale          = transforms.Scale.GetPageData(pageIndex);
+        Float3*        worldPosition  = transforms.WorldPosition.GetPageData(pageIndex);
+        Quat*          worldRotation  = transforms.WorldRotation.GetPageData(pageIndex);
+        Float3*        worldScale     = transforms.WorldScale.GetPageData(pageIndex);
+        Float3x4*      worldTransform = transforms.WorldTransform.GetPageData(pageIndex);
+
+        for (uint32_t i = 0; i < batchSize; ++i)
         {
-            transform.WorldPosition = transform.Position;
-            transform.WorldRotation = transform.Rotation;
-            transform.WorldScale    = transform.Scale;
+            if (!(flags[i] & TransformHierarchyLevel::DIRTY))
+                continue;
 
-            transform.UpdateWorldTransformMatrix();
+            worldPosition[i] = position[i];
+            worldRotation[i] = rotation[i];
+            worldScale[i]    = scale[i];
+
+            worldTransform[i].Compose(worldPosition[i], worldRotation[i].ToMatrix3x3(), worldScale[i]);
         }
-    };
+    }
+}
+
+void UpdateChildTransforms(TransformHierarchyLevel& transforms, TransformHierarchyLevel const* staticParents, TransformHierarchyLevel const& dynamicParents)
+{
+    constexpr uint32_t PageSize = TransformHierarchyLevel::PageSize;
 
-    struct UpdateWithParent
+    uint32_t count = transforms.Size();
+    for (uint32_t pageIndex = 0, first = 0; first < count; ++pageIndex, first += PageSize)
     {
-        HK_FORCEINLINE void Visit(GameObject::TransformData& transform)
+        uint32_t batchSize = Math::Min(count - first, PageSize);
+
+        uint32_t const* parent         = transforms.Parent.GetPageData(pageIndex);
+        uint8_t*        flags          = transforms.Flags.GetPageData(pageIndex);
+        Float3*         position       = transforms.Position.GetPageData(pageIndex);
+        Quat*           rotation       = transforms.Rotation.GetPageData(pageIndex);
+        Float3 const*   scale          = transforms.Scale.GetPageData(pageIndex);
+        Float3*         worldPosition  = transforms.WorldPosition.GetPageData(pageIndex);
+        Quat*           worldRotation  = transforms.WorldRotation.GetPageData(pageIndex);
+        Float3*         worldScale     = transforms.WorldScale.GetPageData(pageIndex);
+        Float3x4*       worldTransform = transforms.WorldTransform.GetPageData(pageIndex);
+
+        for (uint32_t i = 0; i < batchSize; ++i)
         {
-            if (transform.LockWorldPositionAndRotation)
+            HK_ASSERT(parent[i] != TransformHierarchyLevel::NoParent);
+
+            TransformHierarchyLevel const& parentLevel = (parent[i] & TransformHierarchyLevel::DynamicParentBit) ? dynamicParents : *staticParents;
+            uint32_t parentIndex = parent[i] & ~TransformHierarchyLevel::DynamicParentBit;
+
+            if (!((flags[i] | parentLevel.Flags[parentIndex]) & TransformHierarchyLevel::DIRTY))
+                continue;
+
+            // Children of this transform must be updated too
+            flags[i] |= TransformHierarchyLevel::DIRTY;
+
+            Float3x4 const& parentTransform = parentLevel.WorldTransform[parentIndex];
+            Quat const& parentRotation = parentLevel.WorldRotation[parentIndex];
+
+            if (flags[i] & TransformHierarchyLevel::LOCK_WORLD_POSITION_AND_ROTATION)
             {
                 // Пересчитать локальную позицию и поворот относительно родителя так, чтобы мировая позиция
                 // оставалась неизменной.
-                transform.Position = transform.Parent->WorldTransform.Inversed() * transform.WorldPosition;
-                transform.Rotation = transform.Parent->WorldRotation.Inversed() * transform.WorldRotation;
+                position[i] = parentTransform.Inversed() * worldPosition[i];
+                rotation[i] = parentRotation.Inversed() * worldRotation[i];
             }
             else
             {
-                transform.WorldPosition = transform.AbsolutePosition ? transform.Position : transform.Parent->WorldTransform * transform.Position;
-                transform.WorldRotation = transform.AbsoluteRotation ? transform.Rotation : transform.Parent->WorldRotation * transform.Rotation;
+                worldPosition[i] = (flags[i] & TransformHierarchyLevel::ABSOLUTE_POSITION) ? position[i] : parentTransform * position[i];
+                worldRotation[i] = (flags[i] & TransformHierarchyLevel::ABSOLUTE_ROTATION) ? rotation[i] : parentRotation * rotation[i];
             }
 
-            transform.WorldScale = transform.AbsoluteScale    ? transform.Scale    : transform.Parent->WorldScale * transform.Scale;
+            worldScale[i] = (flags[i] & TransformHierarchyLevel::ABSOLUTE_SCALE) ? scale[i] : parentLevel.WorldScale[parentIndex] * scale[i];
 
-            transform.UpdateWorldTransformMatrix();
+            worldTransform[i].Compose(worldPosition[i], worldRotation[i].ToMatrix3x3(), worldScale[i]);
         }
-    };
+    }
+}
 
-    auto& transformHierarchy = GetTransformHierarchy(HierarchyType::Dynamic);
+} // namespace
 
-    if (!transformHierarchy.IsEmpty())
-    {
-        UpdateRoot updateRoot;
-        UpdateWithParent updateWithParent;
+void World::UpdateWorldTransforms()
+{
+    DestroyObjectsAndComponents();
+
+    auto& staticHierarchy = GetTransformHierarchy(HierarchyType::Static);
+    auto& dynamicHierarchy = GetTransformHierarchy(HierarchyType::Dynamic);
 
-        transformHierarchy[0].Iterate(updateRoot);
-        for (uint32_t hierarchyLevel = 1; hierarchyLevel < transformHierarchy.Size(); ++hierarchyLevel)
+    // Levels are updated in order, so parents are always up to date. Clean subtrees are skipped.
+    for (uint32_t hierarchyLevel = 0; hierarchyLevel < dynamicHierarchy.Size(); ++hierarchyLevel)
+    {
+        if (hierarchyLevel == 0)
         {
-            transformHierarchy[hierarchyLevel].Iterate(updateWithParent);
+            UpdateRootTransforms(*dynamicHierarchy[0]);
+        }
+        else
+        {
+            TransformHierarchyLevel const* staticParents = hierarchyLevel <= staticHierarchy.Size() ? staticHierarchy[hierarchyLevel - 1].RawPtr() : nullptr;
+
+            UpdateChildTransforms(*dynamicHierarchy[hierarchyLevel], staticParents, *dynamicHierarchy[hierarchyLevel - 1]);
         }
     }
+
+    for (auto& level : staticHierarchy)
+        level->ClearDirty();
+    for (auto& level : dynamicHierarchy)
+        level->ClearDirty();
 }
 
 HK_NAMESPACE_END
@@ -37,17 +37,20 @@ SOFTWARE.
 #include "TickingGroup.h"
 #include "GameObject.h"
 
+#include <Hork/Core/Containers/ArrayView.h>
 #include <Hork/Core/Containers/PageStorage.h>
 
 HK_NAMESPACE_BEGIN
 
 class DebugRenderer;
+class Prefab;
 
 class World final : public Noncopyable
 {
     friend class WorldInterfaceBase;
     friend class ComponentManagerBase;
     friend class GameObject;
+    friend class WorldSnapshot;
 
 public:
                         World();
@@ -67,11 +70,21 @@ public:
     template <typename Interface>
     Interface&          GetInterface();
 
+    /// Get interface without creating it. Returns null if the interface is not used by the world.
+    template <typename Interface>
+    Interface*          TryGetInterface();
+
     void                Purge();
 
     GameObjectHandle    CreateObject(GameObjectDesc const& desc = {});
     GameObjectHandle    CreateObject(GameObjectDesc const& desc, GameObject*& gameObject);
 
+    /// Instantiate the prefab once per transform. The transform replaces the local transform of the prefab root.
+    /// Object, transform and component storage is reserved for the whole batch up front.
+    /// Root objects of the instances are appended to rootObjects if specified.
+    void                CreateObjects(Prefab const& prefab, ArrayView<Transform> transforms, GameObjectHandle parent = {}, Vector<GameObjectHandle>* rootObjects = nullptr);
+    GameObjectHandle    CreateObject(Prefab const& prefab, Transform const& transform, GameObjectHandle parent = {});
+
     GameObject*         GetObjectUnsafe(GameObjectHandle handle);
     GameObject const*   GetObjectUnsafe(GameObjectHandle handle) const;
 
@@ -126,8 +139,11 @@ private:
         Dynamic
     };
 
-    GameObject::TransformData*  AllocateTransformData(HierarchyType hierarchyType, uint32_t hierarchyLevel);
-    void                        FreeTransformData(HierarchyType hierarchyType, uint32_t hierarchyLevel, GameObject::TransformData* transformData);
+    using TransformHierarchy = Vector<UniqueRef<TransformHierarchyLevel>>;
+
+    void                ReserveTransformData(HierarchyType hierarchyType, uint32_t hierarchyLevel, uint32_t count);
+    void                AllocateTransformData(GameObject* object, HierarchyType hierarchyType, uint32_t hierarchyLevel);
+    void                FreeTransformData(TransformHierarchyLevel* level, uint32_t index);
 
 
     void                UpdateWorldTransforms();
@@ -135,7 +151,7 @@ private:
     void                UpdateHierarchy(GameObject* object, GameObject::TransformRule transformRule);
     void                UpdateHierarchyData(GameObject* object, bool wasDynamic);
 
-    Vector<PageStorage<GameObject::TransformData>>& GetTransformHierarchy(HierarchyType hierarchyType);
+    TransformHierarchy& GetTransformHierarchy(HierarchyType hierarchyType);
 
     enum Command
     {
@@ -163,7 +179,7 @@ private:
     Vector<Command>             m_CommandBuffer;
     WorldTick                   m_Tick;
     float                       m_TimeAccumulator = 0.0f;
-    Vector<PageStorage<GameObject::TransformData>> m_TransformHierarchy[2];
+    TransformHierarchy          m_TransformHierarchy[2];
 };
 
 HK_NAMESPACE_END
@@ -75,6 +75,12 @@ HK_INLINE Interface& World::GetInterface()
     return *static_cast<Interface*>(m_Interfaces[id]);
 }
 
+template <typename Interface>
+HK_INLINE Interface* World::TryGetInterface()
+{
+    return static_cast<Interface*>(m_Interfaces[InterfaceRTTR::TypeID<Interface>]);
+}
+
 template <typename Event>
 HK_INLINE void World::sSubscribeEvent(GameObject* eventSender, Component* receiver, typename Event::Holder::DelegateType delegate)
 {
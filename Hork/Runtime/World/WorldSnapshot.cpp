@@ -0,0 +1,424 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "WorldSnapshot.h"
+
+#include <Hork/Core/Logger.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+constexpr uint32_t SnapshotMagic = 'H' | ('k' << 8) | ('W' << 16) | ('S' << 24);
+constexpr uint32_t SnapshotVersion = 1;
+
+// Raw blocks are aligned in the file, so they can be used in place from a memory mapping
+constexpr size_t SnapshotAlignment = 16;
+
+enum SNAPSHOT_OBJECT_FLAGS : uint32_t
+{
+    SNAPSHOT_OBJECT_DYNAMIC = HK_BIT(0),
+    SNAPSHOT_OBJECT_ABSOLUTE_POSITION = HK_BIT(1),
+    SNAPSHOT_OBJECT_ABSOLUTE_ROTATION = HK_BIT(2),
+    SNAPSHOT_OBJECT_ABSOLUTE_SCALE = HK_BIT(3),
+    SNAPSHOT_OBJECT_LOCK_WORLD_POSITION_AND_ROTATION = HK_BIT(4)
+};
+
+struct SnapshotObject
+{
+    uint32_t    Parent;
+    uint32_t    Flags;
+    Float3      Position;
+    Quat        Rotation;
+    Float3      Scale;
+};
+
+constexpr uint32_t InvalidIndex = ~0u;
+
+void WritePadding(IBinaryStreamWriteInterface& stream)
+{
+    static const uint8_t zeros[SnapshotAlignment] = {};
+
+    size_t offset = stream.GetOffset();
+    size_t padding = Align(offset, SnapshotAlignment) - offset;
+    if (padding)
+        stream.Write(zeros, padding);
+}
+
+// Reads the snapshot in place without copying raw blocks
+class SnapshotReader
+{
+public:
+    SnapshotReader(const void* data, size_t sizeInBytes) :
+        m_Start(static_cast<const uint8_t*>(data)),
+        m_Ptr(m_Start),
+        m_End(m_Start + sizeInBytes)
+    {}
+
+    template <typename T>
+    T const* Read(size_t count)
+    {
+        size_t size = sizeof(T) * count;
+        if (size > size_t(m_End - m_Ptr))
+        {
+            m_Ptr = m_End;
+            m_IsFailed = true;
+            return nullptr;
+        }
+        T const* data = reinterpret_cast<T const*>(m_Ptr);
+        m_Ptr += size;
+        return data;
+    }
+
+    uint32_t ReadUInt32()
+    {
+        uint32_t value = 0;
+        if (auto data = Read<uint8_t>(sizeof(value)))
+            Core::Memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    StringView ReadString()
+    {
+        uint32_t length = ReadUInt32();
+        auto data = Read<char>(length);
+        return data ? StringView(data, length) : StringView();
+    }
+
+    void AlignBlock()
+    {
+        size_t offset = m_Ptr - m_Start;
+        Read<uint8_t>(Align(offset, SnapshotAlignment) - offset);
+    }
+
+    bool IsFailed() const { return m_IsFailed; }
+
+private:
+    const uint8_t*  m_Start;
+    const uint8_t*  m_Ptr;
+    const uint8_t*  m_End;
+    bool            m_IsFailed{};
+};
+
+} // namespace
+
+WorldSnapshot::ComponentType const* WorldSnapshot::FindComponentType(StringView name) const
+{
+    for (ComponentType const& type : m_ComponentTypes)
+    {
+        if (type.Name == name)
+            return &type;
+    }
+    return nullptr;
+}
+
+void WorldSnapshot::Save(World& world, IBinaryStreamWriteInterface& stream) const
+{
+    auto& objectStorage = world.m_ObjectStorage;
+
+    Vector<GameObject*> objects;
+    objects.Reserve(objectStorage.Size());
+    for (auto it = objectStorage.GetObjects(); it.IsValid(); ++it)
+    {
+        if (!it->m_Flags.IsDestroyed)
+            objects.Add(it);
+    }
+
+    // Parents must be restored before their children
+    std::stable_sort(objects.Begin(), objects.End(),
+                     [](GameObject const* a, GameObject const* b)
+                     {
+                         return a->m_HierarchyLevel < b->m_HierarchyLevel;
+                     });
+
+    Vector<uint32_t> objectIndex(objectStorage.GetRandomAccessTable().Size(), InvalidIndex);
+    for (uint32_t i = 0; i < objects.Size(); ++i)
+        objectIndex[objects[i]->m_Handle.GetID()] = i;
+
+    stream.WriteUInt32(SnapshotMagic);
+    stream.WriteUInt32(SnapshotVersion);
+    stream.WriteUInt32(sizeof(SnapshotObject));
+
+    stream.WriteUInt32(objects.Size());
+    for (GameObject const* object : objects)
+        stream.WriteString(object->m_Name.GetStringView());
+
+    Vector<SnapshotObject> records(objects.Size());
+    for (uint32_t i = 0; i < objects.Size(); ++i)
+    {
+        GameObject const* object = objects[i];
+        TransformHierarchyLevel const& transform = *object->m_TransformLevel;
+        uint32_t transformIndex = object->m_TransformIndex;
+        uint8_t transformFlags = transform.Flags[transformIndex];
+        SnapshotObject& record = records[i];
+
+        record.Parent = object->m_Parent ? objectIndex[object->m_Parent.GetID()] : InvalidIndex;
+        record.Flags = 0;
+        if (object->IsDynamic())
+            record.Flags |= SNAPSHOT_OBJECT_DYNAMIC;
+        if (transformFlags & TransformHierarchyLevel::ABSOLUTE_POSITION)
+            record.Flags |= SNAPSHOT_OBJECT_ABSOLUTE_POSITION;
+        if (transformFlags & TransformHierarchyLevel::ABSOLUTE_ROTATION)
+            record.Flags |= SNAPSHOT_OBJECT_ABSOLUTE_ROTATION;
+        if (transformFlags & TransformHierarchyLevel::ABSOLUTE_SCALE)
+            record.Flags |= SNAPSHOT_OBJECT_ABSOLUTE_SCALE;
+        if (transformFlags & TransformHierarchyLevel::LOCK_WORLD_POSITION_AND_ROTATION)
+            record.Flags |= SNAPSHOT_OBJECT_LOCK_WORLD_POSITION_AND_ROTATION;
+        record.Position = transform.Position[transformIndex];
+        record.Rotation = transform.Rotation[transformIndex];
+        record.Scale = transform.Scale[transformIndex];
+    }
+
+    WritePadding(stream);
+    stream.Write(records.ToPtr(), records.Size() * sizeof(SnapshotObject));
+
+    stream.WriteUInt32(m_ComponentTypes.Size());
+
+    Vector<Component*> components;
+    Vector<uint32_t> owners;
+    for (ComponentType const& type : m_ComponentTypes)
+    {
+        ComponentManagerBase const* manager = type.GetManager(world);
+
+        components.Clear();
+        type.GetComponents(world, components);
+
+        File componentData = File::sOpenWriteToMemory(type.Name);
+
+        owners.Clear();
+        for (Component const* component : components)
+        {
+            GameObject const* owner = component->GetOwner();
+            if (!owner || owner->m_Flags.IsDestroyed)
+                continue;
+
+            owners.Add(objectIndex[owner->m_Handle.GetID()]);
+            manager->WriteComponent(component, componentData);
+        }
+
+        uint32_t componentDataSize = componentData.GetOffset();
+
+        stream.WriteString(type.Name);
+        stream.WriteUInt32(owners.Size());
+        // The size allows to skip component types that are not registered on load
+        stream.WriteUInt32(componentDataSize);
+
+        WritePadding(stream);
+        stream.Write(owners.ToPtr(), owners.Size() * sizeof(uint32_t));
+        stream.Write(componentData.GetHeapPtr(), componentDataSize);
+    }
+}
+
+bool WorldSnapshot::Save(World& world, StringView fileName) const
+{
+    File file = File::sOpenWrite(fileName);
+    if (!file)
+        return false;
+
+    Save(world, file);
+    return true;
+}
+
+bool WorldSnapshot::Load(World& world, const void* data, size_t sizeInBytes) const
+{
+    SnapshotReader reader(data, sizeInBytes);
+
+    if (reader.ReadUInt32() != SnapshotMagic || reader.ReadUInt32() != SnapshotVersion || reader.ReadUInt32() != sizeof(SnapshotObject))
+    {
+        LOG("WorldSnapshot::Load: Unexpected snapshot format\n");
+        return false;
+    }
+
+    uint32_t objectCount = reader.ReadUInt32();
+
+    Vector<StringView> names;
+    names.Reserve(objectCount);
+    for (uint32_t i = 0; i < objectCount && !reader.IsFailed(); ++i)
+        names.Add(reader.ReadString());
+
+    reader.AlignBlock();
+    SnapshotObject const* records = reader.Read<SnapshotObject>(objectCount);
+
+    if (reader.IsFailed())
+    {
+        LOG("WorldSnapshot::Load: Unexpected end of snapshot\n");
+        return false;
+    }
+
+    // Count transforms per hierarchy level and reserve storage for all objects up front.
+    // Dynamic parents make the whole subtree dynamic, as in World::CreateObject.
+    Vector<uint32_t> levels(objectCount);
+    Vector<bool> isDynamic(objectCount);
+    Vector<uint32_t> levelCount[2];
+    for (uint32_t i = 0; i < objectCount; ++i)
+    {
+        uint32_t parent = records[i].Parent;
+        if (parent != InvalidIndex && parent >= i)
+        {
+            LOG("WorldSnapshot::Load: Invalid object hierarchy\n");
+            return false;
+        }
+
+        levels[i] = parent != InvalidIndex ? levels[parent] + 1 : 0;
+        isDynamic[i] = (records[i].Flags & SNAPSHOT_OBJECT_DYNAMIC) || (parent != InvalidIndex && isDynamic[parent]);
+
+        auto& counts = levelCount[isDynamic[i] ? 1 : 0];
+        if (counts.Size() <= levels[i])
+            counts.Resize(levels[i] + 1);
+        counts[levels[i]]++;
+    }
+
+    // Validate the component blocks before anything is created, so a broken snapshot leaves the world untouched
+    struct ComponentBlock
+    {
+        ComponentType const*    Type;
+        uint32_t                Count;
+        uint32_t const*         Owners;
+        uint8_t const*          Data;
+        uint32_t                DataSize;
+    };
+    Vector<ComponentBlock> blocks;
+
+    uint32_t typeCount = reader.ReadUInt32();
+    for (uint32_t typeIndex = 0; typeIndex < typeCount; ++typeIndex)
+    {
+        StringView typeName = reader.ReadString();
+        uint32_t componentCount = reader.ReadUInt32();
+        uint32_t componentDataSize = reader.ReadUInt32();
+
+        reader.AlignBlock();
+        uint32_t const* owners = reader.Read<uint32_t>(componentCount);
+        uint8_t const* componentData = reader.Read<uint8_t>(componentDataSize);
+
+        if (reader.IsFailed())
+        {
+            LOG("WorldSnapshot::Load: Unexpected end of snapshot\n");
+            return false;
+        }
+
+        if (!componentCount)
+            continue;
+
+        ComponentType const* type = FindComponentType(typeName);
+        if (!type)
+        {
+            LOG("WorldSnapshot::Load: Skipping unknown component type {}\n", typeName);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < componentCount; ++i)
+        {
+            if (owners[i] >= objectCount)
+            {
+                LOG("WorldSnapshot::Load: Invalid component owner\n");
+                return false;
+            }
+        }
+
+        ComponentBlock& block = blocks.Add();
+        block.Type = type;
+        block.Count = componentCount;
+        block.Owners = owners;
+        block.Data = componentData;
+        block.DataSize = componentDataSize;
+    }
+
+    for (uint32_t level = 0; level < levelCount[0].Size(); ++level)
+        world.ReserveTransformData(World::HierarchyType::Static, level, levelCount[0][level]);
+    for (uint32_t level = 0; level < levelCount[1].Size(); ++level)
+        world.ReserveTransformData(World::HierarchyType::Dynamic, level, levelCount[1][level]);
+
+    world.m_ObjectStorage.Reserve(world.m_ObjectStorage.Size() + objectCount);
+
+    Vector<GameObject*> objects(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i)
+    {
+        SnapshotObject const& record = records[i];
+
+        GameObjectDesc desc;
+        desc.Name = StringID(names[i]);
+        desc.Parent = record.Parent != InvalidIndex ? objects[record.Parent]->m_Handle : GameObjectHandle{};
+        desc.Position = record.Position;
+        desc.Rotation = record.Rotation;
+        desc.Scale = record.Scale;
+        desc.AbsolutePosition = !!(record.Flags & SNAPSHOT_OBJECT_ABSOLUTE_POSITION);
+        desc.AbsoluteRotation = !!(record.Flags & SNAPSHOT_OBJECT_ABSOLUTE_ROTATION);
+        desc.AbsoluteScale = !!(record.Flags & SNAPSHOT_OBJECT_ABSOLUTE_SCALE);
+        desc.IsDynamic = isDynamic[i];
+
+        world.CreateObject(desc, objects[i]);
+
+        if (record.Flags & SNAPSHOT_OBJECT_LOCK_WORLD_POSITION_AND_ROTATION)
+            objects[i]->SetLockWorldPositionAndRotation(true);
+    }
+
+    for (ComponentBlock const& block : blocks)
+    {
+        ComponentManagerBase* manager = block.Type->GetManager(world);
+
+        manager->ReserveComponents(block.Count);
+        world.m_ComponentsToInitialize.Reserve(world.m_ComponentsToInitialize.Size() + block.Count);
+
+        File stream = File::sOpenRead(block.Type->Name, block.Data, block.DataSize);
+
+        for (uint32_t i = 0; i < block.Count; ++i)
+        {
+            Component* component = manager->CreateComponentInternal(objects[block.Owners[i]], block.Type->Mode);
+            manager->ReadComponent(component, stream);
+        }
+
+        // Component data does not match the registered type. Nothing was initialized yet, so the loaded objects are discarded.
+        if (stream.GetOffset() != block.DataSize)
+        {
+            LOG("WorldSnapshot::Load: Invalid component data {}\n", block.Type->Name);
+
+            for (uint32_t i = 0; i < objectCount; ++i)
+            {
+                if (records[i].Parent == InvalidIndex)
+                    world.DestroyObject(objects[i]);
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool WorldSnapshot::Load(World& world, StringView fileName) const
+{
+    MappedFile file = MappedFile::sOpen(fileName);
+    if (!file)
+        return false;
+
+    return Load(world, file.GetData(), file.GetSize());
+}
+
+HK_NAMESPACE_END
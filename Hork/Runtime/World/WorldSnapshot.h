@@ -0,0 +1,99 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "World.h"
+
+#include <Hork/Core/IO.h>
+
+HK_NAMESPACE_BEGIN
+
+/// Binary snapshot of world objects, transform hierarchy and component state.
+/// Only registered component types are saved. Component types provide
+/// Read(IBinaryStreamReadInterface&) and Write(IBinaryStreamWriteInterface&) const methods,
+/// the same methods prefabs use to copy their prototypes.
+class WorldSnapshot
+{
+public:
+    /// Register component type. The name identifies the type in snapshot files.
+    template <typename ComponentType>
+    void                    RegisterComponent(StringView name);
+
+    /// Save all objects of the world.
+    void                    Save(World& world, IBinaryStreamWriteInterface& stream) const;
+    bool                    Save(World& world, StringView fileName) const;
+
+    /// Add objects from the snapshot to the world. Component types missing from the registry are skipped.
+    bool                    Load(World& world, const void* data, size_t sizeInBytes) const;
+
+    /// Map the snapshot file to memory and load it.
+    bool                    Load(World& world, StringView fileName) const;
+
+private:
+    struct ComponentType
+    {
+        String              Name;
+        ComponentTypeID     TypeID;
+        ComponentMode       Mode;
+        ComponentManagerBase* (*GetManager)(World& world);
+        void                (*GetComponents)(World& world, Vector<Component*>& components);
+    };
+
+    ComponentType const*    FindComponentType(StringView name) const;
+
+    Vector<ComponentType>   m_ComponentTypes;
+};
+
+template <typename ComponentType>
+HK_INLINE void WorldSnapshot::RegisterComponent(StringView name)
+{
+    static_assert(HK_HAS_METHOD(ComponentType, Read) && HK_HAS_METHOD(ComponentType, Write), "Snapshot components must implement Read and Write");
+
+    HK_IF_NOT_ASSERT(!FindComponentType(name)) { return; }
+
+    auto& type = m_ComponentTypes.Add();
+    type.Name = name;
+    type.TypeID = ComponentRTTR::TypeID<ComponentType>;
+    type.Mode = ComponentType::Mode;
+    type.GetManager = [](World& world) -> ComponentManagerBase*
+    {
+        return &world.GetComponentManager<ComponentType>();
+    };
+    type.GetComponents = [](World& world, Vector<Component*>& components)
+    {
+        auto& manager = world.GetComponentManager<ComponentType>();
+        components.Reserve(manager.GetComponentCount());
+        for (auto it = manager.GetComponents(); it.IsValid(); ++it)
+            components.Add(it);
+    };
+}
+
+HK_NAMESPACE_END
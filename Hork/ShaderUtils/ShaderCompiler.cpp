@@ -30,6 +30,9 @@ SOFTWARE.
 
 #include "ShaderCompiler.h"
 #include <Hork/Core/Logger.h>
+#include <Hork/Core/IO.h>
+#include <Hork/Core/HashFunc.h>
+#include <Hork/Core/Thread.h>
 
 #include <glslang/SPIRV/GlslangToSpv.h>
 #include <glslang/Public/ShaderLang.h>
@@ -37,6 +40,131 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+String    ShaderCompiler::s_CacheDirectory;
+AtomicInt ShaderCompiler::s_NumCacheHits;
+AtomicInt ShaderCompiler::s_NumCacheMisses;
+AtomicInt ShaderCompiler::s_NumCacheStores;
+AtomicInt ShaderCompiler::s_NumCacheRejected;
+
+namespace
+{
+    constexpr uint32_t SpirVCacheMagic = 0x43565053; // "SPVC"
+
+    /// Increment when the preamble, glslang or SPIR-V generation options change.
+    constexpr uint32_t SpirVCacheVersion = 1;
+
+    /// Content address of the shader. Includes the full source list (preamble, stage defines,
+    /// vertex attributes and user defines all end up in it), so the stage is part of the key too.
+    struct SpirVCacheKey
+    {
+        uint64_t Hash;
+        uint32_t Check;
+        uint32_t Length;
+
+        bool operator==(SpirVCacheKey const& rhs) const
+        {
+            return Hash == rhs.Hash && Check == rhs.Check && Length == rhs.Length;
+        }
+    };
+
+    struct SpirVCacheHeader
+    {
+        uint32_t      Magic;
+        uint32_t      Version;
+        SpirVCacheKey Key;
+        uint32_t      SpirVSize;
+        uint32_t      SpirVHash;
+    };
+
+    SpirVCacheKey MakeSpirVCacheKey(ShaderCompiler::SourceList const& sources)
+    {
+        // FNV-1a 64 over the sources with a terminator between strings, plus an independent
+        // Murmur3 for verification.
+        SpirVCacheKey key = {0xcbf29ce484222325ull, SpirVCacheVersion, 0};
+        for (const char* source : sources)
+        {
+            size_t length = strlen(source);
+            for (size_t i = 0; i <= length; ++i)
+            {
+                key.Hash ^= static_cast<uint8_t>(source[i]);
+                key.Hash *= 0x100000001b3ull;
+            }
+            key.Check = HashTraits::Murmur3Hash(source, length, key.Check);
+            key.Length += static_cast<uint32_t>(length);
+        }
+        return key;
+    }
+
+    String SpirVCacheFileName(StringView directory, SpirVCacheKey const& key)
+    {
+        return String(HK_FORMAT("{}/{:016x}{:08x}.spv", directory, key.Hash, key.Check));
+    }
+
+    bool ReadSpirVCache(StringView fileName, SpirVCacheKey const& key, HeapBlob& spirv, bool& outdated)
+    {
+        outdated = false;
+
+        File file = File::sOpenRead(fileName);
+        if (!file)
+            return false;
+
+        SpirVCacheHeader header;
+        if (file.Read(&header, sizeof(header)) != sizeof(header) ||
+            header.Magic != SpirVCacheMagic ||
+            header.Version != SpirVCacheVersion ||
+            !(header.Key == key) ||
+            header.SpirVSize == 0 ||
+            header.SpirVSize != file.SizeInBytes() - sizeof(header))
+        {
+            outdated = true;
+            return false;
+        }
+
+        spirv = file.ReadBlob(header.SpirVSize);
+        if (spirv.Size() != header.SpirVSize || HashTraits::Murmur3Hash((const char*)spirv.GetData(), spirv.Size()) != header.SpirVHash)
+        {
+            spirv.Reset();
+            outdated = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool WriteSpirVCache(StringView fileName, SpirVCacheKey const& key, HeapBlob const& spirv)
+    {
+        // Write to a temporary file first, so concurrent readers never see a partial entry
+        String tempFileName(HK_FORMAT("{}.{}.tmp", fileName, Thread::sThisThreadId()));
+        {
+            File file = File::sOpenWrite(tempFileName);
+            if (!file)
+                return false;
+
+            SpirVCacheHeader header;
+            header.Magic     = SpirVCacheMagic;
+            header.Version   = SpirVCacheVersion;
+            header.Key       = key;
+            header.SpirVSize = static_cast<uint32_t>(spirv.Size());
+            header.SpirVHash = HashTraits::Murmur3Hash((const char*)spirv.GetData(), spirv.Size());
+
+            if (file.Write(&header, sizeof(header)) != sizeof(header) ||
+                file.Write(spirv.GetData(), spirv.Size()) != spirv.Size())
+            {
+                file.Close();
+                Core::RemoveFile(tempFileName);
+                return false;
+            }
+        }
+
+        if (std::rename(tempFileName.CStr(), String(fileName).CStr()) != 0)
+        {
+            // Another thread or process stored the same entry first
+            Core::RemoveFile(tempFileName);
+            return false;
+        }
+        return true;
+    }
+}
+
 void ShaderCompiler::sInitialize()
 {
     glslang::InitializeProcess();
@@ -44,9 +172,45 @@ void ShaderCompiler::sInitialize()
 
 void ShaderCompiler::sDeinitialize()
 {
+    if (!s_CacheDirectory.IsEmpty())
+    {
+        CacheStats stats = sGetCacheStats();
+        LOG("SPIR-V cache: {} hits, {} misses, {} stored, {} rejected\n", stats.NumHits, stats.NumMisses, stats.NumStores, stats.NumRejected);
+    }
+
     glslang::FinalizeProcess();
 }
 
+void ShaderCompiler::sSetCacheDirectory(StringView directory)
+{
+    s_CacheDirectory = directory;
+    if (!s_CacheDirectory.IsEmpty())
+    {
+        PathUtils::sFixSeparatorInplace(s_CacheDirectory);
+        if (s_CacheDirectory[s_CacheDirectory.Length() - 1] == '/')
+            s_CacheDirectory.Resize(s_CacheDirectory.Length() - 1);
+        Core::CreateDirectory(s_CacheDirectory, false);
+    }
+}
+
+ShaderCompiler::CacheStats ShaderCompiler::sGetCacheStats()
+{
+    CacheStats stats;
+    stats.NumHits     = s_NumCacheHits.Load();
+    stats.NumMisses   = s_NumCacheMisses.Load();
+    stats.NumStores   = s_NumCacheStores.Load();
+    stats.NumRejected = s_NumCacheRejected.Load();
+    return stats;
+}
+
+void ShaderCompiler::sResetCacheStats()
+{
+    s_NumCacheHits.Store(0);
+    s_NumCacheMisses.Store(0);
+    s_NumCacheStores.Store(0);
+    s_NumCacheRejected.Store(0);
+}
+
 bool ShaderCompiler::sCreateSpirV(RHI::SHADER_TYPE shaderType, SourceList const& sources, HeapBlob& spirv)
 {
     const char* shaderTypeMacro[] =
@@ -69,6 +233,34 @@ bool ShaderCompiler::sCreateSpirV(RHI::SHADER_TYPE shaderType, SourceList const&
     _sources.Add(shaderTypeMacro[shaderType]);
     _sources.Add(sources);
 
+    if (s_CacheDirectory.IsEmpty())
+        return sCompileSpirV(shaderType, _sources, spirv);
+
+    SpirVCacheKey key = MakeSpirVCacheKey(_sources);
+    String fileName = SpirVCacheFileName(s_CacheDirectory, key);
+
+    bool outdated;
+    if (ReadSpirVCache(fileName, key, spirv, outdated))
+    {
+        s_NumCacheHits.Increment();
+        return true;
+    }
+    if (outdated)
+        s_NumCacheRejected.Increment();
+
+    s_NumCacheMisses.Increment();
+
+    if (!sCompileSpirV(shaderType, _sources, spirv))
+        return false;
+
+    if (WriteSpirVCache(fileName, key, spirv))
+        s_NumCacheStores.Increment();
+
+    return true;
+}
+
+bool ShaderCompiler::sCompileSpirV(RHI::SHADER_TYPE shaderType, SourceList const& _sources, HeapBlob& spirv)
+{
     using namespace glslang;
 
     EShLanguage stage;
@@ -39,11 +39,42 @@ class ShaderCompiler
 public:
     using SourceList = SmallVector<const char*, 64>;
 
+    struct CacheStats
+    {
+        /// SPIR-V loaded from the cache
+        uint32_t NumHits;
+        /// Shaders compiled by glslang
+        uint32_t NumMisses;
+        /// Cache entries written
+        uint32_t NumStores;
+        /// Cache entries rejected as outdated or corrupted
+        uint32_t NumRejected;
+    };
+
     static void sInitialize();
     static void sDeinitialize();
 
+    /// Set directory of the persistent SPIR-V cache. An empty path disables the cache.
+    /// Must be called before shaders are compiled.
+    static void sSetCacheDirectory(StringView directory);
+
+    static StringView sGetCacheDirectory() { return s_CacheDirectory; }
+
+    static CacheStats sGetCacheStats();
+
+    static void sResetCacheStats();
+
     static bool sCreateSpirV(RHI::SHADER_TYPE shaderType, SourceList const& sources, HeapBlob& spirv);
     static bool sCreateSpirV_VertexShader(ArrayView<RHI::VertexAttribInfo> vertexAttribs, SourceList const& sources, HeapBlob& spirv);
+
+private:
+    static bool sCompileSpirV(RHI::SHADER_TYPE shaderType, SourceList const& sources, HeapBlob& spirv);
+
+    static String    s_CacheDirectory;
+    static AtomicInt s_NumCacheHits;
+    static AtomicInt s_NumCacheMisses;
+    static AtomicInt s_NumCacheStores;
+    static AtomicInt s_NumCacheRejected;
 };
 
 HK_NAMESPACE_END
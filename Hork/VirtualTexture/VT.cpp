@@ -89,6 +89,29 @@ bool VTFileHandle::OpenWrite(StringView fileName)
     return Handle != INVALID_HANDLE_VALUE;
 }
 
+bool VTFileHandle::OpenUpdate(StringView fileName)
+{
+    int n = MultiByteToWideChar(CP_UTF8, 0, fileName.ToPtr(), fileName.Size(), NULL, 0);
+    if (0 == n)
+    {
+        return false;
+    }
+
+    wchar_t* wFilename = (wchar_t*)HkStackAlloc(n * sizeof(wchar_t));
+
+    MultiByteToWideChar(CP_UTF8, 0, fileName.ToPtr(), fileName.Size(), wFilename, n);
+
+    Handle = CreateFileW(wFilename,
+                         GENERIC_WRITE,
+                         0,
+                         NULL,
+                         OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+                         NULL);
+
+    return Handle != INVALID_HANDLE_VALUE;
+}
+
 void VTFileHandle::Seek(uint64_t _offset)
 {
     // FILE_BEGIN - seek set
@@ -119,14 +142,17 @@ void VTFileHandle::Read(void* data, unsigned int size, uint64_t offset)
 {
     DWORD numberOfBytesRead;
 
-    Seek(offset);
+    // Pass the offset with the request so that the file can be read from several threads
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
 
     BOOL r = ReadFile(
         Handle,
         data,
         size,
         &numberOfBytesRead,
-        NULL);
+        &overlapped);
 
     HK_ASSERT(r != FALSE);
     HK_ASSERT(numberOfBytesRead == size);
@@ -137,14 +163,17 @@ void VTFileHandle::Write(const void* data, unsigned int size, uint64_t offset)
 {
     DWORD numberOfBytesWritten;
 
-    Seek(offset);
+    // Pass the offset with the request so that the file can be written from several threads
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
 
     BOOL r = WriteFile(
         Handle,
         data,
         size,
         &numberOfBytesWritten,
-        NULL);
+        &overlapped);
 
     HK_ASSERT(r != FALSE);
     HK_ASSERT(numberOfBytesWritten == size);
@@ -171,6 +200,12 @@ bool VTFileHandle::OpenWrite(StringView fileName)
     return iHandle >= 0;
 }
 
+bool VTFileHandle::OpenUpdate(StringView fileName)
+{
+    iHandle = open(fileName.IsNullTerminated() ? fileName.Begin() : String(fileName).CStr(), O_LARGEFILE | O_WRONLY);
+    return iHandle >= 0;
+}
+
 void VTFileHandle::Close()
 {
     if (iHandle >= 0)
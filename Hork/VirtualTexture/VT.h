@@ -82,6 +82,8 @@ struct VTFileHandle final
 
     bool OpenRead(StringView fileName);
     bool OpenWrite(StringView fileName);
+    /// Open existing file for writing without truncation
+    bool OpenUpdate(StringView fileName);
     void Close();
     void Seek(uint64_t offset);
     void Read(void* data, unsigned int size, uint64_t offset);
@@ -32,35 +32,46 @@ SOFTWARE.
 #include "QuadTree.h"
 
 #include <Hork/RHI/Common/VertexMemoryGPU.h>
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/Core/ScopedTimer.h>
 
 HK_NAMESPACE_BEGIN
 
-VirtualTextureFeedbackAnalyzer::VirtualTextureFeedbackAnalyzer(RHI::IDevice* device) :
-    m_Device(device), m_SwapIndex(0), m_Bindings(nullptr), m_NumBindings(0), m_QueueLoadPos(0), m_StopStreamThread(false)
+VirtualTextureFeedbackAnalyzer::VirtualTextureFeedbackAnalyzer(RHI::IDevice* device, AsyncJobList* jobList) :
+    m_Device(device), m_JobList(jobList), m_SwapIndex(0), m_Bindings(nullptr), m_NumBindings(0), m_QueueLoadPos(0), m_StopStreamThread(false)
 
 {
     Core::ZeroMem(m_Textures, sizeof(m_Textures));
-    Core::ZeroMem(m_QuedPages, sizeof(m_QuedPages));
 
-    m_StreamThread = Thread(
-        [this]()
-        {
-            StreamThreadMain();
-        });
+    int numThreads = Math::Clamp(Thread::NumHardwareThreads / 2, 1, (int)MAX_STREAM_THREADS);
+
+    m_StreamThreads.Resize(numThreads);
+    for (Thread& thread : m_StreamThreads)
+    {
+        thread = Thread(
+            [this]()
+            {
+                StreamThreadMain();
+            });
+    }
 }
 
 VirtualTextureFeedbackAnalyzer::~VirtualTextureFeedbackAnalyzer()
 {
     m_StopStreamThread.Store(true);
 
-    // Awake stream thread
+    // Awake stream threads. Each thread wakes up the next one on exit.
     m_PageSubmitEvent.Signal();
 
-    m_StreamThreadStopped.Wait();
+    for (Thread& thread : m_StreamThreads)
+        thread.Join();
 
     ClearQueue();
 
+    for (VirtualTexture* texture : m_SkippedPageTextures)
+        texture->RemoveRef();
+    m_SkippedPageTextures.Clear();
+
     for (int i = 0; i < VT_MAX_TEXTURE_UNITS; i++)
     {
         for (int j = 0; j < 2; j++)
@@ -79,129 +90,183 @@ void VirtualTextureFeedbackAnalyzer::WaitForNewPages()
     m_PageSubmitEvent.Wait();
 }
 
-void VirtualTextureFeedbackAnalyzer::StreamThreadMain()
+bool VirtualTextureFeedbackAnalyzer::ShouldLoadPage(VTPageDesc const& page, int64_t time)
 {
-    VTPageDesc quedPage;
+    HashMap<uint32_t, int64_t>& streamedPages = page.pTexture->m_StreamedPages;
+    auto it = streamedPages.Find(page.PageIndex);
+    if (it != streamedPages.End())
+    {
+        // Page was loaded recently
+        if (it->second + 1000 >= time)
+            return false;
 
-    while (!m_StopStreamThread.Load())
+        it->second = time;
+    }
+    else
     {
-        // Fetch page
-        {
-            MutexGuard criticalSection(m_EnqueLock);
+        streamedPages[page.PageIndex] = time;
+    }
+    return true;
+}
+
+bool VirtualTextureFeedbackAnalyzer::FetchPages(PageBatch& batch)
+{
+    MutexGuard criticalSection(m_EnqueLock);
 
-            //LOG("Fetch page\n");
+    batch.NumPages = 0;
 
-            m_QueueLoadPos = m_QueueLoadPos & (MAX_QUEUE_LENGTH - 1);
-            quedPage = m_QuedPages[m_QueueLoadPos];
+    int64_t time = Core::SysMilliseconds();
 
-            Core::ZeroMem(&m_QuedPages[m_QueueLoadPos], sizeof(VTPageDesc));
+    while (m_QueueLoadPos < m_QueuedPages.Size() && batch.NumPages == 0)
+    {
+        VTPageDesc& page = m_QueuedPages[m_QueueLoadPos++];
 
-            m_QueueLoadPos++;
-        }
+        // Page was taken with a previous batch
+        if (!page.pTexture)
+            continue;
 
-        VirtualTexture* pTexture = quedPage.pTexture;
+        VirtualTexture* pTexture = page.pTexture;
 
-        if (!pTexture)
+        if (!ShouldLoadPage(page, time))
         {
-            // Reached end of queue
-            //LOG("WaitForNewPages\n");
-            WaitForNewPages();
+            m_SkippedPageTextures.Add(pTexture);
+            page.pTexture = nullptr;
             continue;
         }
 
-        //if ( pTexture->IsPendingRemove() ) {
-        //    pTexture->RemoveRef();
-        //    continue;
-        //}
+        size_t pageSize = pTexture->GetPageSizeInBytes();
+        VTFileOffset physAddress = pTexture->GetPhysAddress(page.PageIndex);
+        HK_ASSERT(physAddress != 0);
 
-        int64_t time = Core::SysMilliseconds();
+        batch.Pages[0] = page;
+        batch.Addresses[0] = physAddress;
+        batch.Start = physAddress;
+        batch.End = physAddress + pageSize;
+        batch.NumPages = 1;
+        page.pTexture = nullptr;
 
-        HashMap<uint32_t, int64_t>& streamedPages = pTexture->m_StreamedPages;
-        auto it = streamedPages.Find(quedPage.PageIndex);
-        if (it != streamedPages.End())
+        // Read neighbor pages of the same texture with a single request
+        int lookaheadEnd = Math::Min<int>(m_QueuedPages.Size(), m_QueueLoadPos + BATCH_LOOKAHEAD);
+        for (int i = m_QueueLoadPos; i < lookaheadEnd && batch.NumPages < MAX_BATCH_PAGES; i++)
         {
-            if (it->second + 1000 < time)
-            {
-                LOG("Re-load page\n");
-                it->second = time;
-            }
-            else
+            VTPageDesc& next = m_QueuedPages[i];
+            if (next.pTexture != pTexture)
+                continue;
+
+            VTFileOffset nextAddress = pTexture->GetPhysAddress(next.PageIndex);
+            if (nextAddress != batch.End && nextAddress + pageSize != batch.Start)
+                continue;
+
+            if (!ShouldLoadPage(next, time))
             {
-                // Page already loaded. Fetch next page
-                LOG("Page already loaded\n");
+                m_SkippedPageTextures.Add(pTexture);
+                next.pTexture = nullptr;
                 continue;
             }
+
+            if (nextAddress == batch.End)
+                batch.End += pageSize;
+            else
+                batch.Start = nextAddress;
+
+            batch.Pages[batch.NumPages] = next;
+            batch.Addresses[batch.NumPages] = nextAddress;
+            batch.NumPages++;
+            next.pTexture = nullptr;
         }
-        else
-        {
-            streamedPages[quedPage.PageIndex] = time;
-        }
+    }
 
-        LOG("Load\n");
+    // Wake up another thread if there are more pages to load
+    if (batch.NumPages > 0 && m_QueueLoadPos < m_QueuedPages.Size())
+        m_PageSubmitEvent.Signal();
 
-        VTFileOffset physAddress = pTexture->GetPhysAddress(quedPage.PageIndex);
+    return batch.NumPages > 0;
+}
 
-        HK_ASSERT(physAddress != 0);
+void VirtualTextureFeedbackAnalyzer::LoadPages(PageBatch const& batch, HeapBlob& readBuffer)
+{
+    VirtualTexture* pTexture = batch.Pages[0].pTexture;
 
-        VirtualTextureCache::PageTransfer* transfer = pTexture->m_Cache->CreatePageTransfer();
+    size_t readSize = batch.End - batch.Start;
+    if (readBuffer.Size() < readSize)
+        readBuffer.Reset(readSize);
 
-        transfer->PageIndex = quedPage.PageIndex;
-        transfer->pTexture = quedPage.pTexture;
+    byte* data = (byte*)readBuffer.GetData();
 
-        pTexture->ReadPage(physAddress, transfer->Layers);
+    pTexture->ReadPages(batch.Start, batch.NumPages, data);
 
-        //int32_t pagePayLoad = Core::SysMilliseconds() - time;
+    for (int i = 0; i < batch.NumPages; i++)
+    {
+        VirtualTextureCache::PageTransfer* transfer = pTexture->m_Cache->CreatePageTransfer();
 
-        //LOG( "pagePayLoad {} msec\n", pagePayLoad );
+        transfer->PageIndex = batch.Pages[i].PageIndex;
+        transfer->pTexture = pTexture;
 
-        // Wait for test
-        //Thread::WaitSeconds( 1 );
-        //Thread::WaitMilliseconds(500);
+        pTexture->UnpackPage(data + (batch.Addresses[i] - batch.Start), transfer->Layers);
 
         pTexture->m_Cache->MakePageTransferVisible(transfer);
     }
+}
+
+void VirtualTextureFeedbackAnalyzer::StreamThreadMain()
+{
+    PageBatch batch;
+    HeapBlob readBuffer;
+
+    while (!m_StopStreamThread.Load())
+    {
+        if (!FetchPages(batch))
+        {
+            // Reached end of queue
+            WaitForNewPages();
+            continue;
+        }
+
+        LoadPages(batch, readBuffer);
+    }
 
-    m_StreamThreadStopped.Signal();
+    // Wake up the next thread to stop
+    m_PageSubmitEvent.Signal();
 }
 
 void VirtualTextureFeedbackAnalyzer::ClearQueue()
 {
-    for (int i = 0; i < MAX_QUEUE_LENGTH; i++)
+    for (int i = m_QueueLoadPos; i < m_QueuedPages.Size(); i++)
     {
-        int p = (m_QueueLoadPos + i) & (MAX_QUEUE_LENGTH - 1);
-        VTPageDesc* quedPage = &m_QuedPages[p];
+        VTPageDesc& quedPage = m_QueuedPages[i];
 
-        if (!quedPage->pTexture)
+        // Remove outdated page from queue
+        if (quedPage.pTexture)
         {
-            // end of queue
-            break;
+            quedPage.pTexture->RemoveRef();
+            quedPage.pTexture = nullptr;
         }
-
-        // Remove outdated page from queue
-        quedPage->pTexture->RemoveRef();
-        quedPage->pTexture = nullptr;
     }
 
+    m_QueuedPages.Clear();
     m_QueueLoadPos = 0;
 }
 
 void VirtualTextureFeedbackAnalyzer::SubmitPages(Vector<VTPageDesc> const& pages)
 {
-    HK_ASSERT(pages.Size() < MAX_QUEUE_LENGTH);
+    HK_ASSERT(pages.Size() <= MAX_QUEUE_LENGTH);
 
     MutexGuard criticalSection(m_EnqueLock);
 
     ClearQueue();
 
+    for (VirtualTexture* texture : m_SkippedPageTextures)
+        texture->RemoveRef();
+    m_SkippedPageTextures.Clear();
+
     // Refresh queue
-    Core::Memcpy(m_QuedPages, pages.ToPtr(), pages.Size() * sizeof(m_QuedPages[0]));
-    for (int i = 0; i < pages.Size(); i++)
+    m_QueuedPages = pages;
+    for (VTPageDesc& quedPage : m_QueuedPages)
     {
-        VTPageDesc* quedPage = &m_QuedPages[i];
-        quedPage->pTexture->AddRef();
+        quedPage.pTexture->AddRef();
     }
 
-    if (pages.Size() > 0)
+    if (!m_QueuedPages.IsEmpty())
     {
         m_PageSubmitEvent.Signal();
     }
@@ -263,204 +328,240 @@ void VirtualTextureFeedbackAnalyzer::End()
     m_Feedbacks.Clear();
 }
 
-void VirtualTextureFeedbackAnalyzer::DecodePages()
+void VirtualTextureFeedbackAnalyzer::DecodePage(DecodeJob& job, int x, int y, int lod, int unit, uint32_t refs) const
 {
-    // TODO:
-    // 1. Wait for analyzer thread from previous frame
-    // 2. Copy texture bindings and feedback data pointers
-    // 3. Run analyzer thread
-    // FIXME: This is so fast. Do we really need to separate this for several threads?
+    VirtualTexture* pTexture = m_Textures[m_SwapIndex][unit];
+    if (!pTexture)
+    {
+        // No texture binded to unit
+        return;
+    }
 
-    //#define WITH_PENDING_FLAG
+    if (lod >= pTexture->GetStoredLods())
+    {
+        return;
+    }
 
-    m_PendingPages.Clear();
-#if 1
-    if (m_NumBindings == 0)
+    // Calculate page index
+    uint32_t relIndex = QuadTreeGetRelativeFromXY(x, y, lod);
+    uint32_t absIndex = QuadTreeRelativeToAbsoluteIndex(relIndex, lod);
+
+    if (!QuadTreeIsIndexValid(absIndex, lod))
     {
+        // Index is invalid. Something wrong with decoding.
         return;
     }
 
-    VirtualTexture** pTextureBindings = m_Textures[m_SwapIndex];
+    // Correct mip level
+    int maxLod = pTexture->m_PIT[absIndex] >> 4;
+    if (maxLod < lod)
+    {
+        int diff = lod - maxLod;
+        x >>= diff;
+        y >>= diff;
+        relIndex = QuadTreeGetRelativeFromXY(x, y, maxLod);
+        absIndex = QuadTreeRelativeToAbsoluteIndex(relIndex, maxLod);
+        lod = maxLod;
+    }
 
-    ScopedTimer timecheck("VirtualTextureFeedbackAnalyzer::DecodePage");
+    if (pTexture->m_PIT[absIndex] & PF_CACHED)
+    {
+        auto& cachedPage = job.CachedPages.Add();
+        cachedPage.pTexture = pTexture;
+        cachedPage.PageIndex = absIndex;
+        return;
+    }
+
+    // check parent cached
+    while (lod > 0)
+    {
+        unsigned int parentAbsolute = QuadTreeGetParentFromRelative(relIndex, lod);
+        if (pTexture->m_PIT[parentAbsolute] & PF_CACHED)
+        {
+            // Parent already in cache
+            break;
+        }
+        --lod;
+        absIndex = parentAbsolute;
+        relIndex = QuadTreeAbsoluteToRelativeIndex(parentAbsolute, lod);
+    }
 
-    int numIterations = 0; // for debug
-    int feedbackSize = 0;  // for debug
+    // Create list of unique not cached pages
+    uint64_t key = (uint64_t(unit) << 32) | absIndex;
 
-    for (VTFeedbackChain& feedback : m_Feedbacks)
+    auto it = job.PageSet.Find(key);
+    if (it != job.PageSet.End())
     {
-        const VTFeedbackData* pData = (const VTFeedbackData*)feedback.Data;
-        const VTFeedbackData* pEnd = (const VTFeedbackData*)feedback.Data + feedback.Size;
+        job.Pages[it->second].Refs += refs;
+    }
+    else
+    {
+        job.PageSet[key] = job.Pages.Size();
+
+        auto& pageDesc = job.Pages.Add();
+        pageDesc.pTexture = pTexture;
+        pageDesc.Key = key;
+        pageDesc.Refs = refs;
+        pageDesc.PageIndex = absIndex;
+        pageDesc.Lod = lod;
+    }
+}
 
-        int x, y, lod, unit;
-        int duplicates = 0;
+void VirtualTextureFeedbackAnalyzer::DecodeFeedback(DecodeJob& job) const
+{
+    job.Pages.Clear();
+    job.PageSet.Clear();
+    job.CachedPages.Clear();
 
-        feedbackSize += feedback.Size;
+    uint32_t const* pData = job.Data;
+    int size = job.Size;
 
-        for (; pData < pEnd; ++pData)
-        {
-            if (((const uint32_t*)pData)[0] == ((const uint32_t*)pData)[1] && pData + 1 < pEnd)
-            {
-                // skip duplicates
-                duplicates++;
-                continue;
-            }
+    alignas(16) int32_t x[4], y[4], lod[4], unit[4];
 
-            numIterations++;
+    const __m128i mask2 = _mm_set1_epi32(3);
+    const __m128i mask4 = _mm_set1_epi32(12);
+    const __m128i mask8 = _mm_set1_epi32(0xff);
 
-            int refs = duplicates + 1;
+    uint32_t refs = 1;
 
-            duplicates = 0;
+    for (int i = 0; i < size; i += 4)
+    {
+        int count = Math::Min(4, size - i);
 
-            // Decode page
-            VT_FeedbackUnpack_RGBA8_11LODS_256UNITS(pData, x, y, lod, unit);
+        if (count == 4)
+        {
+            // Unpack four texels at once, see VT_FeedbackUnpack_RGBA8_11LODS_256UNITS
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pData + i));
+            __m128i byte1 = _mm_and_si128(v, mask8);
+
+            _mm_store_si128(reinterpret_cast<__m128i*>(x), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 16), mask8), _mm_slli_epi32(_mm_and_si128(v, mask2), 8)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(y), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 8), mask8), _mm_slli_epi32(_mm_and_si128(v, mask4), 6)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(lod), _mm_srli_epi32(byte1, 4));
+            _mm_store_si128(reinterpret_cast<__m128i*>(unit), _mm_srli_epi32(v, 24));
+        }
+        else
+        {
+            for (int k = 0; k < count; k++)
+                VT_FeedbackUnpack_RGBA8_11LODS_256UNITS(reinterpret_cast<VTFeedbackData const*>(pData + i + k), x[k], y[k], lod[k], unit[k]);
+        }
 
-            VirtualTexture* pTexture = pTextureBindings[unit];
-            if (!pTexture)
-            {
-                // No texture binded to unit
-                continue;
-            }
+        for (int k = 0; k < count; k++)
+        {
+            int n = i + k;
 
-            if (lod >= pTexture->GetStoredLods())
+            // Skip duplicates, they are counted with the last texel of the sequence
+            if (n + 1 < size && pData[n] == pData[n + 1])
             {
+                refs++;
                 continue;
             }
 
-            // Calculate page index
-            uint32_t relIndex = QuadTreeGetRelativeFromXY(x, y, lod);
-            uint32_t absIndex = QuadTreeRelativeToAbsoluteIndex(relIndex, lod);
+            DecodePage(job, x[k], y[k], lod[k], unit[k], refs);
+            refs = 1;
+        }
+    }
+}
 
-            if (!QuadTreeIsIndexValid(absIndex, lod))
-            {
-                // Index is invalid. Something wrong with decoding.
-                continue;
-            }
+void VirtualTextureFeedbackAnalyzer::sDecodeJob(void* data)
+{
+    DecodeJob* job = static_cast<DecodeJob*>(data);
+    job->Self->DecodeFeedback(*job);
+}
 
-            // Correct mip level
-            int maxLod = pTexture->m_PIT[absIndex] >> 4;
-            if (maxLod < lod)
-            {
-                int diff = lod - maxLod;
-                x >>= diff;
-                y >>= diff;
-                relIndex = QuadTreeGetRelativeFromXY(x, y, maxLod);
-                absIndex = QuadTreeRelativeToAbsoluteIndex(relIndex, maxLod);
-                lod = maxLod;
-            }
+void VirtualTextureFeedbackAnalyzer::DecodePages()
+{
+    m_PendingPages.Clear();
 
-            byte* pageInfo = &pTexture->m_PIT[absIndex];
+    if (m_NumBindings == 0)
+    {
+        return;
+    }
 
-            if (*pageInfo & PF_CACHED)
-            {
-                pTexture->UpdateLRU(absIndex);
-                continue;
-            }
+    ScopedTimer timecheck("VirtualTextureFeedbackAnalyzer::DecodePage");
 
-            // check parent cached
-            while (lod > 0)
-            {
-                unsigned int parentAbsolute = QuadTreeGetParentFromRelative(relIndex, lod);
-                byte* parentInfo = &pTexture->m_PIT[parentAbsolute];
-                if (*parentInfo & PF_CACHED)
-                {
-                    // Parent already in cache
-                    break;
-                }
-                --lod;
-                pageInfo = parentInfo;
-                absIndex = parentAbsolute;
-                relIndex = QuadTreeAbsoluteToRelativeIndex(parentAbsolute, lod);
-            }
+    // Split the feedback into ranges
+    const int DECODE_CHUNK_SIZE = 32768;
 
-#    if 1
-            uint32_t hash = *reinterpret_cast<const uint32_t*>(pData);
-#    else
-            // Pack textureUnit, lod, x, y to uint32
-            pageX = QuadTreeGetXFromRelative(relIndex, pageLod);
-            pageY = QuadTreeGetYFromRelative(relIndex, pageLod);
-            uint32_t hash = (textureUnit << 24) | (pageLod << 20) | (pageX & 0x300) << 10 | (pageY & 0x300) << 8 | (pageX & 0xff) << 8 | (pageY & 0xff);
-#    endif
+    int numJobs = 0;
+    for (VTFeedbackChain& feedback : m_Feedbacks)
+        numJobs += (feedback.Size + DECODE_CHUNK_SIZE - 1) / DECODE_CHUNK_SIZE;
 
-            // Create list of unique not cached pages
+    if (m_DecodeJobs.Size() < (size_t)numJobs)
+        m_DecodeJobs.Resize(numJobs);
 
-#    ifdef WITH_PENDING_FLAG
-            if (!(*pageInfo & PF_PENDING))
-            {
-                *pageInfo |= PF_PENDING;
+    int jobIndex = 0;
+    for (VTFeedbackChain& feedback : m_Feedbacks)
+    {
+        for (int offset = 0; offset < feedback.Size; offset += DECODE_CHUNK_SIZE)
+        {
+            DecodeJob& job = m_DecodeJobs[jobIndex++];
+            job.Self = this;
+            job.Data = static_cast<uint32_t const*>(feedback.Data) + offset;
+            job.Size = Math::Min(DECODE_CHUNK_SIZE, feedback.Size - offset);
+        }
+    }
 
-                auto& pageDesc = m_PendingPages.Add();
-                pageDesc.pTexture = pTexture;
-                pageDesc.Hash = hash;
-                pageDesc.Refs = 1;
-                pageDesc.PageIndex = absIndex;
-                pageDesc.Lod = pageLod;
+    if (m_JobList && numJobs > 1)
+    {
+        for (int i = 0; i < numJobs; i++)
+            m_JobList->AddJob(sDecodeJob, &m_DecodeJobs[i]);
 
-                PendingPagesHash.Insert(hash, m_PendingPages.Size() - 1);
-            }
-            else
-            {
-                for (int i = PendingPagesHash.First(hash); i != -1; i = PendingPagesHash.Next(i))
-                {
-                    if (m_PendingPages[i].Hash == hash)
-                    {
-                        m_PendingPages[i].Refs++;
-                        break;
-                    }
-                }
-            }
-#    else
-            auto it = m_PendingPageSet.Find(hash);
+        m_JobList->SubmitAndWait();
+    }
+    else
+    {
+        for (int i = 0; i < numJobs; i++)
+            DecodeFeedback(m_DecodeJobs[i]);
+    }
+
+    // Merge the results
+    for (int i = 0; i < numJobs; i++)
+    {
+        DecodeJob& job = m_DecodeJobs[i];
+
+        for (VTPageDesc const& cachedPage : job.CachedPages)
+            cachedPage.pTexture->UpdateLRU(cachedPage.PageIndex);
+
+        for (VTPageDesc const& page : job.Pages)
+        {
+            auto it = m_PendingPageSet.Find(page.Key);
             if (it != m_PendingPageSet.End())
             {
-                auto n = it->second;
-                m_PendingPages[n].Refs += refs;
+                m_PendingPages[it->second].Refs += page.Refs;
             }
             else
             {
-                auto& pageDesc = m_PendingPages.Add();
-                pageDesc.pTexture = pTexture;
-                pageDesc.Hash = hash;
-                pageDesc.Refs = refs;
-                pageDesc.PageIndex = absIndex;
-                //pageDesc.Lod = lod;
-
-                m_PendingPageSet[hash] = m_PendingPages.Size() - 1;
+                m_PendingPageSet[page.Key] = m_PendingPages.Size();
+                m_PendingPages.Add(page);
             }
-#    endif
         }
     }
 
-    //LOG( "Num iterations: {}, uniqe pages {}, buffer size {}\n", numIterations, m_PendingPages.Size(), feedbackSize );
+    //LOG( "Unique pages {}\n", m_PendingPages.Size() );
 
     if (!m_PendingPages.IsEmpty())
     {
         m_PendingPageSet.Clear();
 
-#    ifdef WITH_PENDING_FLAG
-        // Unset pending flag
-        for (VTPageDesc& page : m_PendingPages)
-        {
-            page.pTexture->m_PIT[page.PageIndex] &= ~PF_PENDING;
-        }
-#    endif
-
+        // Coarse pages cover larger areas and replace missing detail sooner, so they are loaded first.
+        // Pages of the same LOD are ordered by feedback frequency.
         struct
         {
             bool operator()(VTPageDesc const& a, VTPageDesc const& b)
             {
+                if (a.Lod != b.Lod)
+                    return a.Lod < b.Lod;
                 return a.Refs > b.Refs;
             }
-        } SortByRefs;
+        } SortByPriority;
 
-        std::sort(m_PendingPages.Begin(), m_PendingPages.End(), SortByRefs);
+        std::sort(m_PendingPages.Begin(), m_PendingPages.End(), SortByPriority);
 
         const int MAX_PENDING_PAGES = 100; // TODO: Set from console variable
 
         int numPendingPages = Math::Min3<int>(MAX_PENDING_PAGES, MAX_QUEUE_LENGTH, m_PendingPages.Size());
         m_PendingPages.Resize(numPendingPages);
     }
-#endif
 }
 
 void VirtualTextureFeedbackAnalyzer::AddFeedbackData(int feedbackSize, const void* feedbackData)
@@ -33,6 +33,7 @@ SOFTWARE.
 #include "VirtualTexture.h"
 
 #include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/HeapBlob.h>
 
 HK_NAMESPACE_BEGIN
 
@@ -55,10 +56,11 @@ struct VTFeedbackData
 struct VTPageDesc
 {
     VirtualTexture* pTexture;
-    uint32_t Hash;
+    /// Texture unit and absolute page index
+    uint64_t Key;
     uint32_t Refs;
     uint32_t PageIndex;
-    //uint8_t  Lod;
+    uint8_t  Lod;
 };
 
 struct VTUnit
@@ -67,10 +69,13 @@ struct VTUnit
     float Log2Size;
 };
 
+class AsyncJobList;
+
 class VirtualTextureFeedbackAnalyzer : public RefCounted
 {
 public:
-                                VirtualTextureFeedbackAnalyzer(RHI::IDevice* device);
+    /// Feedback is decoded by the jobs of the list if specified
+                                VirtualTextureFeedbackAnalyzer(RHI::IDevice* device, AsyncJobList* jobList = nullptr);
     virtual                     ~VirtualTextureFeedbackAnalyzer();
 
     void                        AddFeedbackData(int feedbackSize, const void* feedbackData);
@@ -87,13 +92,51 @@ public:
     bool                        HasBindings() const { return m_NumBindings > 0; }
 
 private:
+    enum
+    {
+        /// Max pages read from the file at once
+        MAX_BATCH_PAGES = 8,
+        /// How far the queue is scanned for pages that can be read with the first one
+        BATCH_LOOKAHEAD = 32
+    };
+
+    /// Pages of a texture stored next to each other in the file
+    struct PageBatch
+    {
+        VTPageDesc              Pages[MAX_BATCH_PAGES];
+        VTFileOffset            Addresses[MAX_BATCH_PAGES];
+        VTFileOffset            Start;
+        VTFileOffset            End;
+        int                     NumPages;
+    };
+
+    /// Feedback texels decoded by a single job
+    struct DecodeJob
+    {
+        VirtualTextureFeedbackAnalyzer const* Self;
+        uint32_t const*         Data;
+        int                     Size;
+        /// Unique not cached pages
+        Vector<VTPageDesc>      Pages;
+        HashMap<uint64_t, uint32_t> PageSet;
+        /// Cached pages to update LRU
+        Vector<VTPageDesc>      CachedPages;
+    };
+
+    static void                 sDecodeJob(void* data);
+    void                        DecodeFeedback(DecodeJob& job) const;
+    void                        DecodePage(DecodeJob& job, int x, int y, int lod, int unit, uint32_t refs) const;
     void                        DecodePages();
     void                        ClearQueue();
     void                        SubmitPages(Vector<VTPageDesc> const& pages);
     void                        WaitForNewPages();
     void                        StreamThreadMain();
+    bool                        FetchPages(PageBatch& batch);
+    bool                        ShouldLoadPage(VTPageDesc const& page, int64_t time);
+    void                        LoadPages(PageBatch const& batch, HeapBlob& readBuffer);
 
     Ref<RHI::IDevice>           m_Device;
+    AsyncJobList*               m_JobList;
 
     // Per-frame texture bindings
     VirtualTexture*             m_Textures[2][VT_MAX_TEXTURE_UNITS];
@@ -106,22 +149,28 @@ private:
     // Actually feedback data is from previous frame
     Vector<VTFeedbackChain>     m_Feedbacks;
 
+    // Feedback split into ranges decoded in parallel
+    Vector<DecodeJob>           m_DecodeJobs;
+
     // Unique pages from feedback
-    HashMap<uint32_t, uint32_t> m_PendingPageSet;
+    HashMap<uint64_t, uint32_t> m_PendingPageSet;
     Vector<VTPageDesc>          m_PendingPages;
 
-    // Page queue for async loading
+    // Page queue for async loading ordered by priority
     enum
     {
-        MAX_QUEUE_LENGTH = 256
+        MAX_QUEUE_LENGTH = 256,
+        MAX_STREAM_THREADS = 4
     };
-    VTPageDesc                  m_QuedPages[MAX_QUEUE_LENGTH];
+    Vector<VTPageDesc>          m_QueuedPages;
     int                         m_QueueLoadPos; // pointer to a page that will be loaded first
 
-    Thread                      m_StreamThread;
+    // Textures of the pages skipped by stream threads. Released on the main thread.
+    Vector<VirtualTexture*>     m_SkippedPageTextures;
+
+    Vector<Thread>              m_StreamThreads;
     Mutex                       m_EnqueLock;
     SyncEvent                   m_PageSubmitEvent;
-    SyncEvent                   m_StreamThreadStopped;
     AtomicBool                  m_StopStreamThread;
 };
 
@@ -166,6 +166,26 @@ VTFileOffset VirtualTextureFile::ReadPage(VTFileOffset physAddress, byte* pageDa
     return physAddress;
 }
 
+void VirtualTextureFile::ReadPages(VTFileOffset physAddress, int numPages, byte* data) const
+{
+    if (m_FileHandle.IsInvalid())
+    {
+        return;
+    }
+    m_FileHandle.Read(data, m_PageSizeInBytes * numPages, physAddress);
+}
+
+void VirtualTextureFile::UnpackPage(byte const* pageData, byte* layers[]) const
+{
+    for (int Layer = 0; Layer < m_Layers.Size(); Layer++)
+    {
+        if (layers[Layer])
+        {
+            Core::Memcpy(layers[Layer], pageData + m_Layers[Layer].Offset, m_Layers[Layer].SizeInBytes);
+        }
+    }
+}
+
 #if 0
 void VirtualTextureFile::ReadPageEx( VTFileOffset physAddress, byte * pageData[], int Lod, EVirtualTexturePageDebug Debug ) const
 {
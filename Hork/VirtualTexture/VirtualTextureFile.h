@@ -61,6 +61,12 @@ public:
     /// Read page from file. Can be used from stream thread
     VTFileOffset                ReadPage(uint64_t physAddress, byte* pageData[]) const;
 
+    /// Read pages stored next to each other in the file at once. Can be used from stream threads
+    void                        ReadPages(VTFileOffset physAddress, int numPages, byte* data) const;
+
+    /// Copy page layers from the data read by ReadPages. Can be used from stream threads
+    void                        UnpackPage(byte const* pageData, byte* layers[]) const;
+
     /// Read page physical address. Can be used from stream thread
     VTFileOffset                GetPhysAddress(uint32_t pageIndex) const;
 
@@ -219,6 +219,9 @@ VirtualTextureCache::PageTransfer* VirtualTextureCache::CreatePageTransfer()
 {
     HK_ASSERT(m_LayerInfo.Size() > 0);
 
+    // Transfers are allocated by several stream threads
+    MutexGuard criticalSection(m_TransferAllocMutex);
+
     // TODO: break if thread was stopped
     do {
         int freePoint = m_TransferFreePoint.Load();
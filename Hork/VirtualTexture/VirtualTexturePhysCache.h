@@ -102,7 +102,7 @@ public:
         byte*                   Layers[VT_MAX_LAYERS];
     };
 
-    /// Called by async thread to create new page transfer
+    /// Called by stream threads to create new page transfer
     PageTransfer*               CreatePageTransfer();
 
     /// Called by async thread when page was streamed
@@ -180,6 +180,7 @@ private:
     byte*                       m_pTransferData;
     size_t                      m_TransferDataOffset;
     int                         m_TransferAllocPoint;
+    Mutex                       m_TransferAllocMutex;
     AtomicInt                   m_TransferFreePoint;
     PageTransfer                m_PageTransfer[MAX_UPLOADS_PER_FRAME];
     SyncEvent                   m_PageTransferEvent;
@@ -31,6 +31,8 @@ SOFTWARE.
 #include "VirtualTextureTools.h"
 #include "QuadTree.h"
 
+#include <Hork/Core/AsyncJobManager.h>
+#include <Hork/Core/IO.h>
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/WindowsDefs.h>
 #include <Hork/Math/VectorMath.h>
@@ -46,6 +48,65 @@ SOFTWARE.
 
 HK_NAMESPACE_BEGIN
 
+namespace
+{
+    // Максимальное количество задач на один проход. Каждая задача обрабатывает непрерывный диапазон элементов.
+    const int MAX_BUILD_JOBS = 64;
+
+    template <typename Func>
+    struct BuildJob
+    {
+        Func const* Callback;
+        int         First;
+        int         Last;
+
+        static void sExecute(void* data)
+        {
+            BuildJob* job = static_cast<BuildJob*>(data);
+            for (int i = job->First; i < job->Last; i++)
+                (*job->Callback)(i);
+        }
+    };
+
+    // Вызывает func(i) для i из [0, count). Если задан jobList, то элементы распределяются между задачами.
+    template <typename Func>
+    void ParallelFor(AsyncJobList* jobList, int count, Func const& func)
+    {
+        if (!jobList || count < 2)
+        {
+            for (int i = 0; i < count; i++)
+                func(i);
+            return;
+        }
+
+        // Пул задач списка настраивает вызывающая сторона, поэтому задач не больше, чем помещается в пул
+        int numJobs = Math::Max(1, Math::Min(Math::Min(count, MAX_BUILD_JOBS), jobList->GetMaxParallelJobs()));
+
+        BuildJob<Func> jobs[MAX_BUILD_JOBS];
+        for (int n = 0; n < numJobs; n++)
+        {
+            jobs[n].Callback = &func;
+            jobs[n].First = int((int64_t)count * n / numJobs);
+            jobs[n].Last = int((int64_t)count * (n + 1) / numJobs);
+
+            jobList->AddJob(BuildJob<Func>::sExecute, &jobs[n]);
+        }
+
+        jobList->SubmitAndWait();
+    }
+
+    void MarkRectPages(VTPageBitfield& bitField, int lod, int pageX, int pageY, int numPagesX, int numPagesY)
+    {
+        for (int y = pageY; y < pageY + numPagesY; y++)
+        {
+            for (int x = pageX; x < pageX + numPagesX; x++)
+            {
+                bitField.Mark(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y, lod), lod));
+            }
+        }
+    }
+} // namespace
+
 VirtualTextureImage::~VirtualTextureImage()
 {
     Core::GetHeapAllocator<HEAP_TEMP>().Free(m_Data);
@@ -214,7 +275,7 @@ bool VT_DumpPageToDisk(const char* path, unsigned int absoluteIndex, const Virtu
     return image.WriteImage(fn.CStr());
 }
 
-void VT_FitPageData(VirtualTextureLayer& layer, bool forceFit)
+static void VT_FitPageDataLocked(VirtualTextureLayer& layer, bool forceFit)
 {
     if ((!forceFit && layer.NumCachedPages < layer.MaxCachedPages) || layer.MaxCachedPages < 0)
     {
@@ -230,7 +291,7 @@ void VT_FitPageData(VirtualTextureLayer& layer, bool forceFit)
     {
         VirtualTextureLayer::CachedPage* cachedPage = it->second;
 
-        if (cachedPage->Used > 0)
+        if (cachedPage->Used.Load() > 0)
         {
             // now page in use, so keep it in memory
             it++;
@@ -257,6 +318,13 @@ void VT_FitPageData(VirtualTextureLayer& layer, bool forceFit)
     LOG("Total dumped pages: {} from {}\n", totalDumped, totalCachedPages);
 }
 
+void VT_FitPageData(VirtualTextureLayer& layer, bool forceFit)
+{
+    MutexGuard criticalSection(layer.CacheMutex);
+
+    VT_FitPageDataLocked(layer, forceFit);
+}
+
 VirtualTextureLayer::CachedPage* VT_OpenCachedPage(const VirtualTextureStructure& _struct, VirtualTextureLayer& layer, unsigned int absoluteIndex, VirtualTextureLayer::OpenMode openMode, bool needToSave)
 {
     int lod;
@@ -264,6 +332,8 @@ VirtualTextureLayer::CachedPage* VT_OpenCachedPage(const VirtualTextureStructure
     String fn;
     VirtualTextureLayer::CachedPage* cachedPage;
 
+    MutexGuard criticalSection(layer.CacheMutex);
+
     cachedPage = VT_FindInCache(layer, absoluteIndex);
     if (cachedPage)
     {
@@ -271,11 +341,11 @@ VirtualTextureLayer::CachedPage* VT_OpenCachedPage(const VirtualTextureStructure
         {
             cachedPage->bNeedToSave = true;
         }
-        cachedPage->Used++;
+        cachedPage->Used.Increment();
         return cachedPage;
     }
 
-    VT_FitPageData(layer);
+    VT_FitPageDataLocked(layer, false);
 
     cachedPage = new VirtualTextureLayer::CachedPage;
 
@@ -308,7 +378,7 @@ VirtualTextureLayer::CachedPage* VT_OpenCachedPage(const VirtualTextureStructure
         return NULL;
     }
 
-    cachedPage->Used = 1;
+    cachedPage->Used.Store(1);
     cachedPage->bNeedToSave = needToSave;
     layer.Pages[absoluteIndex] = cachedPage;
     layer.NumCachedPages++;
@@ -322,8 +392,7 @@ void VT_CloseCachedPage(VirtualTextureLayer::CachedPage* cachedPage)
     {
         return;
     }
-    cachedPage->Used--;
-    if (cachedPage->Used < 0)
+    if (cachedPage->Used.Decrement() < 0)
     {
         LOG("Warning: VT_CloseCachedPage: trying to close closed page\n");
     }
@@ -368,11 +437,8 @@ namespace
     }
 } // namespace
 
-void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, const RectangleBinBack_RectNode& rect, const byte* layerData)
+void VT_PutTileIntoPages(const VirtualTextureStructure& _struct, VirtualTextureLayer& layer, int pageX, int pageY, int numPagesX, int numPagesY, const byte* tileData)
 {
-    int numPagesX = rect.width;
-    int numPagesY = rect.height;
-
     PageRect pageRect;
 
     pageRect.width = _struct.PageResolution;
@@ -384,19 +450,19 @@ void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer&
     int lod = _struct.NumLods - 1;
     int numVtPages = 1 << lod;
 
-    int LayerWidth = rect.width * _struct.PageResolution;
-    int LayerHeight = rect.height * _struct.PageResolution;
+    int tileWidth = numPagesX * _struct.PageResolution;
+    int tileHeight = numPagesY * _struct.PageResolution;
 
     for (int x = 0; x < numPagesX; x++)
     {
         for (int y = 0; y < numPagesY; y++)
         {
 
-            int pageIndexX = rect.x + x;
-            int pageIndexY = rect.y + y;
+            int pageIndexX = pageX + x;
+            int pageIndexY = pageY + y;
 
-            HK_ASSERT_(pageIndexX < numVtPages, "VT_PutImageIntoPages");
-            HK_ASSERT_(pageIndexY < numVtPages, "VT_PutImageIntoPages");
+            HK_ASSERT_(pageIndexX < numVtPages, "VT_PutTileIntoPages");
+            HK_ASSERT_(pageIndexY < numVtPages, "VT_PutTileIntoPages");
             HK_UNUSED(numVtPages);
 
             unsigned int relativeIndex = QuadTreeGetRelativeFromXY(pageIndexX, pageIndexY, lod);
@@ -412,9 +478,9 @@ void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer&
             pageRect.y = y * _struct.PageResolution;
 
             CopyRect(pageRect,
-                     layerData,
-                     LayerWidth,
-                     LayerHeight,
+                     tileData,
+                     tileWidth,
+                     tileHeight,
                      copyOffsetX,
                      copyOffsetY,
                      cachedPage->Image.GetData(),
@@ -422,8 +488,6 @@ void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer&
                      _struct.PageResolutionB,
                      layer.NumChannels);
 
-            _struct.PageBitfield.Mark(absoluteIndex);
-
             //WriteImage( HK_FORMAT("page_{}_{}.bmp",x,y), _struct.PageResolutionB, _struct.PageResolutionB, layer.NumChannels, cachedPage->Image.GetData() );
 
             VT_CloseCachedPage(cachedPage);
@@ -431,6 +495,13 @@ void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer&
     }
 }
 
+void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, const RectangleBinBack_RectNode& rect, const byte* layerData)
+{
+    VT_PutTileIntoPages(_struct, layer, rect.x, rect.y, rect.width, rect.height, layerData);
+
+    MarkRectPages(_struct.PageBitfield, _struct.NumLods - 1, rect.x, rect.y, rect.width, rect.height);
+}
+
 bool VT_LoadQuad(const VirtualTextureStructure& _struct,
                  VirtualTextureLayer& layer,
                  unsigned int src00,
@@ -610,9 +681,9 @@ void VT_Downsample(const VirtualTextureStructure& _struct, VirtualTextureLayer&
     }
 }
 
-void VT_MakeLods(VirtualTextureStructure& _struct, VirtualTextureLayer& layer)
+void VT_MakeLods(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, VTPageBitfield const* dirtyPages, AsyncJobList* jobList)
 {
-    VirtualTextureLayer::CachedPage* pages[4];
+    Vector<unsigned int> destPages;
 
     for (int sourceLod = _struct.NumLods - 1; sourceLod > 0; sourceLod--)
     {
@@ -621,17 +692,17 @@ void VT_MakeLods(VirtualTextureStructure& _struct, VirtualTextureLayer& layer)
 
         int destLod = sourceLod - 1;
 
+        // Отмечаем страницы лода и собираем страницы, которые нужно пересоздать
+        destPages.Clear();
+
         for (unsigned int y = 0; y < numLodPages; y += 2)
         {
             for (unsigned int x = 0; x < numLodPages; x += 2)
             {
-
-                unsigned int src00 = QuadTreeGetRelativeFromXY(x, y, sourceLod);
-                unsigned int src10 = QuadTreeGetRelativeFromXY(x + 1, y, sourceLod);
-                unsigned int src01 = QuadTreeGetRelativeFromXY(x, y + 1, sourceLod);
-                unsigned int src11 = QuadTreeGetRelativeFromXY(x + 1, y + 1, sourceLod);
-
-                if (!VT_LoadQuad(_struct, layer, src00, src10, src01, src11, sourceLod, pages))
+                if (!_struct.PageBitfield.IsMarked(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y, sourceLod), sourceLod)) &&
+                    !_struct.PageBitfield.IsMarked(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x + 1, y, sourceLod), sourceLod)) &&
+                    !_struct.PageBitfield.IsMarked(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y + 1, sourceLod), sourceLod)) &&
+                    !_struct.PageBitfield.IsMarked(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x + 1, y + 1, sourceLod), sourceLod)))
                 {
                     continue;
                 }
@@ -639,25 +710,51 @@ void VT_MakeLods(VirtualTextureStructure& _struct, VirtualTextureLayer& layer)
                 unsigned int dst = QuadTreeGetRelativeFromXY(x >> 1, y >> 1, destLod);
                 unsigned int absoluteIndex = QuadTreeRelativeToAbsoluteIndex(dst, destLod);
 
-                VirtualTextureLayer::CachedPage* cachedPage = VT_OpenCachedPage(_struct, layer, absoluteIndex, VirtualTextureLayer::OpenEmpty, true);
-                if (!cachedPage)
+                _struct.PageBitfield.Mark(absoluteIndex);
+
+                if (dirtyPages && !dirtyPages->IsMarked(absoluteIndex))
                 {
                     continue;
                 }
 
+                destPages.Add(dst);
+            }
+        }
+
+        ParallelFor(jobList, destPages.Size(), [&](int i)
+        {
+            unsigned int dst = destPages[i];
+
+            unsigned int x = QuadTreeGetXFromRelative(dst, destLod) << 1;
+            unsigned int y = QuadTreeGetYFromRelative(dst, destLod) << 1;
+
+            unsigned int src00 = QuadTreeGetRelativeFromXY(x, y, sourceLod);
+            unsigned int src10 = QuadTreeGetRelativeFromXY(x + 1, y, sourceLod);
+            unsigned int src01 = QuadTreeGetRelativeFromXY(x, y + 1, sourceLod);
+            unsigned int src11 = QuadTreeGetRelativeFromXY(x + 1, y + 1, sourceLod);
+
+            VirtualTextureLayer::CachedPage* pages[4];
+
+            if (!VT_LoadQuad(_struct, layer, src00, src10, src01, src11, sourceLod, pages))
+            {
+                return;
+            }
+
+            VirtualTextureLayer::CachedPage* cachedPage = VT_OpenCachedPage(_struct, layer, QuadTreeRelativeToAbsoluteIndex(dst, destLod), VirtualTextureLayer::OpenEmpty, true);
+            if (cachedPage)
+            {
                 VT_Downsample(_struct, layer, pages, cachedPage->Image.GetData());
-                _struct.PageBitfield.Mark(absoluteIndex);
 
                 //WriteImage( HK_FORMAT("page_{}.bmp", absoluteIndex), _struct.PageResolutionB, _struct.PageResolutionB, layer.NumChannels, cachedPage->Image.GetData() );
 
                 VT_CloseCachedPage(cachedPage);
+            }
 
-                for (int i = 0; i < 4; i++)
-                {
-                    VT_CloseCachedPage(pages[i]);
-                }
+            for (int k = 0; k < 4; k++)
+            {
+                VT_CloseCachedPage(pages[k]);
             }
-        }
+        });
     }
 }
 
@@ -1236,24 +1333,30 @@ void VT_GenerateBorder_DR(VirtualTextureStructure& _struct, VirtualTextureLayer&
     VT_CloseCachedPage(cachedPage);
 }
 
-void VT_GenerateBordersLod(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, int lod)
+void VT_GenerateBordersLod(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, int lod, VTPageBitfield const* dirtyPages, AsyncJobList* jobList)
 {
     int numLodPages = QuadTreeCalcLodNodes(lod);
     unsigned int absoluteIndex = QuadTreeRelativeToAbsoluteIndex(0, lod);
 
-    for (int i = 0; i < numLodPages; i++)
+    // Каждая задача пишет только бордеры своей страницы и читает внутреннюю область соседних
+    ParallelFor(jobList, numLodPages, [&](int i)
     {
         unsigned int pageIndex = absoluteIndex + i;
 
         if (!_struct.PageBitfield.IsMarked(pageIndex))
         {
-            continue;
+            return;
+        }
+
+        if (dirtyPages && !dirtyPages->IsMarked(pageIndex))
+        {
+            return;
         }
 
         VirtualTextureLayer::CachedPage* cachedPage = VT_OpenCachedPage(_struct, layer, pageIndex, VirtualTextureLayer::OpenActual, true);
         if (!cachedPage)
         {
-            continue;
+            return;
         }
 
         byte* ImageData = cachedPage->Image.GetData();
@@ -1273,14 +1376,14 @@ void VT_GenerateBordersLod(VirtualTextureStructure& _struct, VirtualTextureLayer
         //WriteImage( HK_FORMAT("page_{}.bmp", pageIndex), _struct.PageResolutionB, _struct.PageResolutionB, layer.NumChannels, cachedPage->Image.GetData() );
 
         VT_CloseCachedPage(cachedPage);
-    }
+    });
 }
 
-void VT_GenerateBorders(VirtualTextureStructure& _struct, VirtualTextureLayer& layer)
+void VT_GenerateBorders(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, VTPageBitfield const* dirtyPages, AsyncJobList* jobList)
 {
     for (int i = 0; i < _struct.NumLods; i++)
     {
-        VT_GenerateBordersLod(_struct, layer, i);
+        VT_GenerateBordersLod(_struct, layer, i, dirtyPages, jobList);
     }
 }
 
@@ -1337,7 +1440,7 @@ VTFileOffset VT_WritePage(VTFileHandle* file, VTFileOffset offset, const Virtual
     return offset;
 }
 
-bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTextureLayer* layers, int numLayers, StringView fileName)
+bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTextureLayer* layers, int numLayers, StringView fileName, VTPageBitfield const* dirtyPages, AsyncJobList* jobList)
 {
     VTFileHandle fileHandle;
     VTFileOffset fileOffset;
@@ -1349,7 +1452,13 @@ bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTe
 
     Core::CreateDirectory(fileName, true);
 
-    if (!fileHandle.OpenWrite(fileName))
+    if (dirtyPages && !fileHandle.OpenUpdate(fileName))
+    {
+        // Нечего обновлять, пишем файл целиком
+        dirtyPages = nullptr;
+    }
+
+    if (!dirtyPages && !fileHandle.OpenWrite(fileName))
     {
         LOG("VT_WriteFile: couldn't write {}\n", fileName);
         return false;
@@ -1411,21 +1520,24 @@ bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTe
     // write page address tables
     fileOffset += addressTable.Write(&fileHandle, fileOffset);
 
+    // Порядок страниц в файле
+    Vector<unsigned int> pages;
+
     // Кол-во страниц в LOD'ах от 0 до 4
     unsigned int numFirstPages = Math::Min<unsigned int>(85, addressTable.TotalPages);
 
-    // Записываем страницы LOD'ов 0-4
+    // Страницы LOD'ов 0-4
     for (unsigned int i = 0; i < numFirstPages; i++)
     {
         if (_struct.PageBitfield.IsMarked(i))
         {
-            fileOffset = VT_WritePage(&fileHandle, fileOffset, _struct, layers, numLayers, i);
+            pages.Add(i);
         }
     }
 
     if (addressTable.TableSize)
     {
-        // Записываем остальные страницы
+        // Остальные страницы
         for (int lodNum = 4; lodNum < addressTable.NumLods; lodNum++)
         {
             int addrTableLod = lodNum - 4;
@@ -1445,13 +1557,30 @@ bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTe
 
                     if (_struct.PageBitfield.IsMarked(absoluteIndex))
                     {
-                        fileOffset = VT_WritePage(&fileHandle, fileOffset, _struct, layers, numLayers, absoluteIndex);
+                        pages.Add(absoluteIndex);
                     }
                 }
             }
         }
     }
 
+    // Размер страницы в файле не зависит от ее содержимого, поэтому страницы можно сжимать и записывать параллельно
+    VTFileOffset pageStride = 0;
+    for (int layer = 0; layer < numLayers; layer++)
+    {
+        pageStride += layers[layer].SizeInBytes;
+    }
+
+    ParallelFor(jobList, pages.Size(), [&](int i)
+    {
+        if (dirtyPages && !dirtyPages->IsMarked(pages[i]))
+        {
+            return;
+        }
+
+        VT_WritePage(&fileHandle, fileOffset + pageStride * i, _struct, layers, numLayers, pages[i]);
+    });
+
     return true;
 }
 
@@ -1636,6 +1765,168 @@ void VT_RemoveHDDData(VirtualTextureStructure& _struct, VirtualTextureLayer& lay
 //    }
 //}
 
+namespace
+{
+    const uint32_t BUILD_MANIFEST_ID = 0x4d425456; // 'VTBM'
+    const uint32_t BUILD_MANIFEST_VERSION = 1;
+
+    // Размер фрагмента изображения в страницах при загрузке через LoadLayerTile
+    const int BUILD_TILE_PAGES = 8;
+
+    // Описание последней сборки, хранится в tempDir вместе со страницами
+    struct BuildManifest
+    {
+        int                 PageResolutionB = 0;
+        int                 NumLods = 0;
+        int                 NumLayers = 0;
+        Vector<RectangleBinBack_RectNode> Rects;
+        Vector<uint64_t>    Hashes; // numRects x numLayers
+        VTPageBitfield      PageBitfield;
+
+        static size_t sGetBitfieldSize(int numLods)
+        {
+            return (QuadTreeCalcQuadTreeNodes(numLods) + VTPageBitfield::BitCount - 1) / VTPageBitfield::BitCount * sizeof(VTPageBitfield::T);
+        }
+
+        bool Read(StringView fileName)
+        {
+            File f = File::sOpenRead(fileName);
+            if (!f)
+                return false;
+
+            if (f.ReadUInt32() != BUILD_MANIFEST_ID || f.ReadUInt32() != BUILD_MANIFEST_VERSION)
+                return false;
+
+            PageResolutionB = f.ReadUInt32();
+            NumLods = f.ReadUInt32();
+            NumLayers = f.ReadUInt32();
+
+            uint32_t numRects = f.ReadUInt32();
+            Rects.Resize(numRects);
+            for (RectangleBinBack_RectNode& rect : Rects)
+            {
+                rect.x = f.ReadUInt32();
+                rect.y = f.ReadUInt32();
+                rect.width = f.ReadUInt32();
+                rect.height = f.ReadUInt32();
+            }
+
+            Hashes.Resize(numRects * NumLayers);
+            for (uint64_t& hash : Hashes)
+                hash = f.ReadUInt64();
+
+            size_t bitfieldSize = sGetBitfieldSize(NumLods);
+            PageBitfield.ResizeInvalidate(QuadTreeCalcQuadTreeNodes(NumLods));
+            return f.Read(PageBitfield.ToPtr(), bitfieldSize) == bitfieldSize;
+        }
+
+        void Write(StringView fileName) const
+        {
+            File f = File::sOpenWrite(fileName);
+            if (!f)
+            {
+                LOG("VT_CreateVirtualTexture: couldn't write {}\n", fileName);
+                return;
+            }
+
+            f.WriteUInt32(BUILD_MANIFEST_ID);
+            f.WriteUInt32(BUILD_MANIFEST_VERSION);
+            f.WriteUInt32(PageResolutionB);
+            f.WriteUInt32(NumLods);
+            f.WriteUInt32(NumLayers);
+            f.WriteUInt32(Rects.Size());
+            for (RectangleBinBack_RectNode const& rect : Rects)
+            {
+                f.WriteUInt32(rect.x);
+                f.WriteUInt32(rect.y);
+                f.WriteUInt32(rect.width);
+                f.WriteUInt32(rect.height);
+            }
+            for (uint64_t hash : Hashes)
+                f.WriteUInt64(hash);
+            f.Write(PageBitfield.ToPtr(), sGetBitfieldSize(NumLods));
+        }
+
+        // Совпадает ли расположение страниц
+        bool IsCompatible(BuildManifest const& rhs) const
+        {
+            if (PageResolutionB != rhs.PageResolutionB || NumLods != rhs.NumLods || NumLayers != rhs.NumLayers || Rects.Size() != rhs.Rects.Size())
+                return false;
+
+            for (size_t i = 0; i < Rects.Size(); i++)
+            {
+                if (Rects[i].x != rhs.Rects[i].x || Rects[i].y != rhs.Rects[i].y || Rects[i].width != rhs.Rects[i].width || Rects[i].height != rhs.Rects[i].height)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    // Фрагмент прямоугольника, загружаемый одной задачей
+    struct BuildTile
+    {
+        int                 RectIndex;
+        int                 PageX;
+        int                 PageY;
+        int                 NumPagesX;
+        int                 NumPagesY;
+        // Фрагмент загружен во всех слоях
+        bool                bLoaded;
+    };
+
+    // Родительская страница изменена, если изменена хотя бы одна дочерняя
+    void PropagateDirtyPages(VirtualTextureStructure const& _struct, VTPageBitfield& dirtyPages)
+    {
+        for (int lod = _struct.NumLods - 1; lod > 0; lod--)
+        {
+            int numLodPages = 1 << lod;
+            for (int y = 0; y < numLodPages; y++)
+            {
+                for (int x = 0; x < numLodPages; x++)
+                {
+                    if (dirtyPages.IsMarked(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y, lod), lod)))
+                    {
+                        dirtyPages.Mark(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x >> 1, y >> 1, lod - 1), lod - 1));
+                    }
+                }
+            }
+        }
+    }
+
+    // Бордеры страницы зависят от соседних страниц, поэтому соседние страницы тоже считаются измененными
+    void ExpandDirtyPages(VirtualTextureStructure const& _struct, VTPageBitfield& dirtyPages)
+    {
+        VTPageBitfield expanded;
+        expanded.ResizeInvalidate(_struct.NumQuadTreeNodes);
+        expanded.UnmarkAll();
+
+        for (int lod = 0; lod < _struct.NumLods; lod++)
+        {
+            int numLodPages = 1 << lod;
+            for (int y = 0; y < numLodPages; y++)
+            {
+                for (int x = 0; x < numLodPages; x++)
+                {
+                    if (!dirtyPages.IsMarked(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y, lod), lod)))
+                    {
+                        continue;
+                    }
+
+                    for (int ny = Math::Max(y - 1, 0); ny <= Math::Min(y + 1, numLodPages - 1); ny++)
+                    {
+                        for (int nx = Math::Max(x - 1, 0); nx <= Math::Min(x + 1, numLodPages - 1); nx++)
+                        {
+                            expanded.Mark(QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(nx, ny, lod), lod));
+                        }
+                    }
+                }
+            }
+        }
+
+        dirtyPages = std::move(expanded);
+    }
+} // namespace
+
 bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
                              int numLayers,
                              const char* outputFileName,
@@ -1646,7 +1937,9 @@ bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
                              std::vector<RectangleBinBack_RectNode>& binRects,
                              unsigned int& binWidth,
                              unsigned int& binHeight,
-                             int maxCachedPages)
+                             int maxCachedPages,
+                             AsyncJobList* jobList,
+                             bool incremental)
 {
     //maxCachedPages=1;// FIXME: for debug
     Core::CreateDirectory(outputFileName, true);
@@ -1655,6 +1948,9 @@ bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
 
     int pageDataNumPixelsB = (1 << pageWidthLog2) * (1 << pageWidthLog2);
 
+    bool bLoadTiles = true;
+    int maxChannels = 0;
+
     for (int LayerIndex = 0; LayerIndex < numLayers; LayerIndex++)
     {
         String layerPath(HK_FORMAT("{}/layer{}/", tempDir, LayerIndex));
@@ -1681,6 +1977,19 @@ bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
         }
 
         vtLayers[LayerIndex].PageDataFormat = layers[LayerIndex].PageDataFormat;
+
+        if (!layers[LayerIndex].LoadLayerTile)
+        {
+            bLoadTiles = false;
+        }
+
+        if (incremental && !layers[LayerIndex].GetLayerImageHash)
+        {
+            LOG("VT_CreateVirtualTexture: incremental build requires GetLayerImageHash\n");
+            incremental = false;
+        }
+
+        maxChannels = Math::Max(maxChannels, layers[LayerIndex].NumChannels);
     }
 
     VirtualTextureStructure vtStruct;
@@ -1690,41 +1999,216 @@ bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
     }
 
     int numRects = binRects.size();
+    int finestLod = vtStruct.NumLods - 1;
+
+    String manifestFileName(HK_FORMAT("{}/manifest", tempDir));
+    String vtFileName(HK_FORMAT("{}.vt3", outputFileName));
 
+    BuildManifest manifest;
+    manifest.PageResolutionB = vtStruct.PageResolutionB;
+    manifest.NumLods = vtStruct.NumLods;
+    manifest.NumLayers = numLayers;
+    manifest.Rects.Resize(numRects);
     for (int rectIndex = 0; rectIndex < numRects; rectIndex++)
     {
-        RectangleBinBack_RectNode& rect = binRects[rectIndex];
+        manifest.Rects[rectIndex] = binRects[rectIndex];
+    }
 
-        for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+    // Прямоугольники, изображения которых нужно загрузить
+    Vector<uint8_t> dirtyRects(numRects, 1);
+
+    // Страницы, которые нужно пересоздать при инкрементальной сборке
+    VTPageBitfield dirtyPages;
+
+    BuildManifest prevManifest;
+    bool bUpdate = false;
+
+    if (incremental)
+    {
+        manifest.Hashes.Resize(numRects * numLayers);
+        for (int rectIndex = 0; rectIndex < numRects; rectIndex++)
         {
+            for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+            {
+                manifest.Hashes[rectIndex * numLayers + layerIndex] = layers[layerIndex].GetLayerImageHash(binRects[rectIndex].userdata);
+            }
+        }
 
-            void* imageData = layers[layerIndex].LoadLayerImage(rect.userdata, rect.width * vtStruct.PageResolution, rect.height * vtStruct.PageResolution);
+        if (prevManifest.Read(manifestFileName) && prevManifest.IsCompatible(manifest) && Core::IsFileExists(vtFileName))
+        {
+            bUpdate = true;
 
-            if (imageData)
+            for (int rectIndex = 0; rectIndex < numRects; rectIndex++)
             {
+                if (std::memcmp(&manifest.Hashes[rectIndex * numLayers], &prevManifest.Hashes[rectIndex * numLayers], sizeof(uint64_t) * numLayers))
+                {
+                    continue;
+                }
 
-                VT_PutImageIntoPages(vtStruct, vtLayers[layerIndex], rect, (const byte*)imageData);
+                // Страницы неизменившегося прямоугольника остались в tempDir от прошлой сборки
+                dirtyRects[rectIndex] = 0;
 
-                layers[layerIndex].FreeLayerImage(imageData);
+                RectangleBinBack_RectNode const& rect = binRects[rectIndex];
+                for (int y = rect.y; y < rect.y + rect.height; y++)
+                {
+                    for (int x = rect.x; x < rect.x + rect.width; x++)
+                    {
+                        unsigned int absoluteIndex = QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y, finestLod), finestLod);
+                        if (prevManifest.PageBitfield.IsMarked(absoluteIndex))
+                        {
+                            vtStruct.PageBitfield.Mark(absoluteIndex);
+                        }
+                    }
+                }
             }
+
+            dirtyPages.ResizeInvalidate(vtStruct.NumQuadTreeNodes);
+            dirtyPages.UnmarkAll();
         }
     }
+
+    // Страницы в tempDir будут изменены, манифест снова станет актуальным только после окончания инкрементальной сборки
+    Core::RemoveFile(manifestFileName);
+
+    // Изображения загружаются фрагментами, если это поддерживают все слои, что ограничивает объем используемой памяти
+    Vector<BuildTile> tiles;
+    for (int rectIndex = 0; rectIndex < numRects; rectIndex++)
+    {
+        if (!dirtyRects[rectIndex])
+        {
+            continue;
+        }
+
+        RectangleBinBack_RectNode const& rect = binRects[rectIndex];
+        int tileSize = bLoadTiles ? BUILD_TILE_PAGES : Math::Max(rect.width, rect.height);
+
+        for (int y = 0; y < rect.height; y += tileSize)
+        {
+            for (int x = 0; x < rect.width; x += tileSize)
+            {
+                BuildTile& tile = tiles.Add();
+                tile.RectIndex = rectIndex;
+                tile.PageX = x;
+                tile.PageY = y;
+                tile.NumPagesX = Math::Min(tileSize, rect.width - x);
+                tile.NumPagesY = Math::Min(tileSize, rect.height - y);
+                tile.bLoaded = false;
+            }
+        }
+    }
+
+    ParallelFor(jobList, tiles.Size(), [&](int i)
+    {
+        BuildTile& tile = tiles[i];
+        RectangleBinBack_RectNode const& rect = binRects[tile.RectIndex];
+
+        int imageWidth = rect.width * vtStruct.PageResolution;
+        int imageHeight = rect.height * vtStruct.PageResolution;
+
+        if (bLoadTiles)
+        {
+            int tileWidth = tile.NumPagesX * vtStruct.PageResolution;
+            int tileHeight = tile.NumPagesY * vtStruct.PageResolution;
+
+            void* tileData = Core::GetHeapAllocator<HEAP_TEMP>().Alloc(tileWidth * tileHeight * maxChannels);
+
+            int numLoadedLayers = 0;
+            for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+            {
+                if (layers[layerIndex].LoadLayerTile(rect.userdata, imageWidth, imageHeight, tile.PageX * vtStruct.PageResolution, tile.PageY * vtStruct.PageResolution, tileWidth, tileHeight, tileData))
+                {
+                    VT_PutTileIntoPages(vtStruct, vtLayers[layerIndex], rect.x + tile.PageX, rect.y + tile.PageY, tile.NumPagesX, tile.NumPagesY, (const byte*)tileData);
+                    numLoadedLayers++;
+                }
+            }
+            tile.bLoaded = numLoadedLayers == numLayers;
+
+            Core::GetHeapAllocator<HEAP_TEMP>().Free(tileData);
+        }
+        else
+        {
+            int numLoadedLayers = 0;
+            for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+            {
+                void* imageData = layers[layerIndex].LoadLayerImage(rect.userdata, imageWidth, imageHeight);
+
+                if (imageData)
+                {
+                    VT_PutTileIntoPages(vtStruct, vtLayers[layerIndex], rect.x, rect.y, rect.width, rect.height, (const byte*)imageData);
+
+                    layers[layerIndex].FreeLayerImage(imageData);
+                    numLoadedLayers++;
+                }
+            }
+            tile.bLoaded = numLoadedLayers == numLayers;
+        }
+    });
+
+    for (BuildTile const& tile : tiles)
+    {
+        if (!tile.bLoaded)
+        {
+            continue;
+        }
+
+        RectangleBinBack_RectNode const& rect = binRects[tile.RectIndex];
+
+        MarkRectPages(vtStruct.PageBitfield, finestLod, rect.x + tile.PageX, rect.y + tile.PageY, tile.NumPagesX, tile.NumPagesY);
+
+        if (bUpdate)
+        {
+            MarkRectPages(dirtyPages, finestLod, rect.x + tile.PageX, rect.y + tile.PageY, tile.NumPagesX, tile.NumPagesY);
+        }
+    }
+
+    if (bUpdate)
+    {
+        // Файл можно обновить на месте, только если набор страниц не изменился
+        for (int rectIndex = 0; rectIndex < numRects && bUpdate; rectIndex++)
+        {
+            RectangleBinBack_RectNode const& rect = binRects[rectIndex];
+            for (int y = rect.y; y < rect.y + rect.height && bUpdate; y++)
+            {
+                for (int x = rect.x; x < rect.x + rect.width; x++)
+                {
+                    unsigned int absoluteIndex = QuadTreeRelativeToAbsoluteIndex(QuadTreeGetRelativeFromXY(x, y, finestLod), finestLod);
+                    if (vtStruct.PageBitfield.IsMarked(absoluteIndex) != prevManifest.PageBitfield.IsMarked(absoluteIndex))
+                    {
+                        LOG("VT_CreateVirtualTexture: page set changed, rebuilding all pages\n");
+                        bUpdate = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    if (bUpdate)
+    {
+        PropagateDirtyPages(vtStruct, dirtyPages);
+    }
+
     //VT_FitPageData( vtLayers[ 0],true);// FIXME: for debug
     for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
     {
-        VT_MakeLods(vtStruct, vtLayers[layerIndex]);
+        VT_MakeLods(vtStruct, vtLayers[layerIndex], bUpdate ? &dirtyPages : nullptr, jobList);
 
         //VT_FitPageData( vtLayers[ layerIndex],true);// FIXME: for debug
     }
 
+    if (bUpdate)
+    {
+        ExpandDirtyPages(vtStruct, dirtyPages);
+    }
+
     for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
     {
-        VT_GenerateBorders(vtStruct, vtLayers[layerIndex]);
+        VT_GenerateBorders(vtStruct, vtLayers[layerIndex], bUpdate ? &dirtyPages : nullptr, jobList);
 
         //VT_FitPageData( vtLayers[ layerIndex],true);// FIXME: for debug
     }
 
-    if (!VT_WriteFile(vtStruct, maxLods, &vtLayers[0], vtLayers.size(), HK_FORMAT("{}.vt3", outputFileName)))
+    if (!VT_WriteFile(vtStruct, maxLods, &vtLayers[0], vtLayers.size(), vtFileName, bUpdate ? &dirtyPages : nullptr, jobList))
     {
         return false;
     }
@@ -1734,6 +2218,20 @@ bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
     CreateMinImage( vtCache1, (String( _outputFileName ) + "_1.png").CStr() );
 #endif
 
+    if (incremental)
+    {
+        // Сохраняем все страницы на диск для следующей сборки
+        for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
+        {
+            VT_FitPageData(vtLayers[layerIndex], true);
+        }
+
+        manifest.PageBitfield = vtStruct.PageBitfield;
+        manifest.Write(manifestFileName);
+
+        return true;
+    }
+
     for (int layerIndex = 0; layerIndex < numLayers; layerIndex++)
     {
         // Запрещаем дамп страниц кеша, которые еще находятся в оперативной памяти
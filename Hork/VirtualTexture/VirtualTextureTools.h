@@ -34,9 +34,12 @@ SOFTWARE.
 #include "RectangleBinPack.h"
 
 #include <Hork/Core/Containers/Hash.h>
+#include <Hork/Core/Thread.h>
 
 HK_NAMESPACE_BEGIN
 
+class AsyncJobList;
+
 struct VirtualTextureStructure
 {
     int                         PageResolutionB;
@@ -88,7 +91,7 @@ public:
 
         VirtualTextureImage     Image;
         bool                    bNeedToSave;
-        int                     Used;
+        AtomicInt               Used;
     };
 
     String                      Path;
@@ -107,6 +110,9 @@ public:
     void                        (*PageCompressionMethod)(const void* inputData, void* outputData);
 
     HashMap<unsigned int, CachedPage*> Pages;
+
+    // Защищает кеш страниц, позволяя открывать страницы из нескольких потоков
+    Mutex                       CacheMutex;
 };
 
 // Создает структуру виртуальной текстуры, на выходе _struct и binRects
@@ -135,6 +141,11 @@ bool VT_DumpPageToDisk(const char* path, unsigned int absoluteIndex, const Virtu
 // Режет входное изображение (layerData) на страницы и сохраняет в кеше
 void VT_PutImageIntoPages(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, const RectangleBinBack_RectNode& rect, const byte* layerData);
 
+// Режет фрагмент изображения (tileData) размером numPagesX x numPagesY страниц на страницы начиная с pageX, pageY
+// самого детального лода и сохраняет в кеше. Страницы не отмечаются в PageBitfield, поэтому функцию можно
+// вызывать из нескольких потоков.
+void VT_PutTileIntoPages(const VirtualTextureStructure& _struct, VirtualTextureLayer& layer, int pageX, int pageY, int numPagesX, int numPagesY, const byte* tileData);
+
 // Загружает заданные четыре страницы для последующего лодирования
 bool VT_LoadQuad(const VirtualTextureStructure& _struct, VirtualTextureLayer& layer, unsigned int src00, unsigned int src10, unsigned int src01, unsigned int src11, int sourceLod, VirtualTextureLayer::CachedPage* page[4]);
 
@@ -142,7 +153,9 @@ bool VT_LoadQuad(const VirtualTextureStructure& _struct, VirtualTextureLayer& la
 void VT_Downsample(const VirtualTextureStructure& _struct, VirtualTextureLayer::CachedPage* pages[4], byte* downsample);
 
 // Создает лоды VT
-void VT_MakeLods(VirtualTextureStructure& _struct, VirtualTextureLayer& layer);
+// Если задан dirtyPages, то пересоздаются только отмеченные в нем страницы.
+// Если задан jobList, то страницы лода создаются параллельно.
+void VT_MakeLods(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, VTPageBitfield const* dirtyPages = nullptr, AsyncJobList* jobList = nullptr);
 
 // Синхронизирует page bitfield с жестким диском (заново заполняет pageBitfield на основе страниц,
 // хранящихся на диске
@@ -163,14 +176,16 @@ void VT_GenerateBorder_UL(VirtualTextureStructure& _struct, VirtualTextureLayer&
 void VT_GenerateBorder_UR(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, unsigned int relativeIndex, int lod, byte* pageData);
 void VT_GenerateBorder_DL(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, unsigned int relativeIndex, int lod, byte* pageData);
 void VT_GenerateBorder_DR(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, unsigned int relativeIndex, int lod, byte* pageData);
-void VT_GenerateBordersLod(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, int lod);
-void VT_GenerateBorders(VirtualTextureStructure& _struct, VirtualTextureLayer& layer);
+void VT_GenerateBordersLod(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, int lod, VTPageBitfield const* dirtyPages = nullptr, AsyncJobList* jobList = nullptr);
+void VT_GenerateBorders(VirtualTextureStructure& _struct, VirtualTextureLayer& layer, VTPageBitfield const* dirtyPages = nullptr, AsyncJobList* jobList = nullptr);
 
 // Пишет страницу в файл VT
 VTFileOffset VT_WritePage(VTFileHandle* file, VTFileOffset offset, const VirtualTextureStructure& _struct, VirtualTextureLayer* layers, int c, unsigned int pageIndex);
 
 // Пишет файл VT
-bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTextureLayer* layers, int pageData, StringView fileName);
+// Если задан dirtyPages, то в существующем файле перезаписываются только отмеченные страницы. Структура
+// виртуальной текстуры при этом должна совпадать со структурой, с которой был записан файл.
+bool VT_WriteFile(const VirtualTextureStructure& _struct, int maxLods, VirtualTextureLayer* layers, int pageData, StringView fileName, VTPageBitfield const* dirtyPages = nullptr, AsyncJobList* jobList = nullptr);
 
 struct VirtualTextureLayerDesc
 {
@@ -182,8 +197,21 @@ struct VirtualTextureLayerDesc
     void*                       (*LoadLayerImage)(void* rectUserData, int width, int height);
     void                        (*FreeLayerImage)(void* imageData);
     void                        (*PageCompressionMethod)(const void* inputData, void* outputData);
+
+    // Необязательно. Загружает фрагмент изображения (tileX, tileY, tileWidth, tileHeight) в tileData.
+    // width, height - размер всего изображения. Если задан для всех слоев, то изображения загружаются по
+    // фрагментам вместо целых изображений.
+    bool                        (*LoadLayerTile)(void* rectUserData, int width, int height, int tileX, int tileY, int tileWidth, int tileHeight, void* tileData) = nullptr;
+
+    // Необязательно. Возвращает хеш исходного изображения. Необходим для инкрементальной сборки.
+    uint64_t                    (*GetLayerImageHash)(void* rectUserData) = nullptr;
 };
 
+// Создает виртуальную текстуру.
+// Если задан jobList, то страницы обрабатываются параллельно, колбэки слоев должны быть потокобезопасными.
+// Список задач не перенастраивается: за один проход отправляется не больше jobList->GetMaxParallelJobs() задач.
+// Если incremental = true, то промежуточные страницы остаются в tempDir, и при следующей сборке пересоздаются
+// только страницы прямоугольников, хеш изображений которых изменился (см. GetLayerImageHash).
 bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
                              int numLayers,
                              const char* outputFileName,
@@ -194,7 +222,9 @@ bool VT_CreateVirtualTexture(const VirtualTextureLayerDesc* layers,
                              std::vector<RectangleBinBack_RectNode>& binRects,
                              unsigned int& binWidth,
                              unsigned int& binHeight,
-                             int maxCachedPages = 32768);
+                             int maxCachedPages = 32768,
+                             AsyncJobList* jobList = nullptr,
+                             bool incremental = false);
 
 void VT_TransformTextureCoords(float* texCoord,
                                unsigned int numVerts,
@@ -356,6 +356,10 @@ void SampleApplication::CreateScene()
         UniqueRef<TerrainResource> terrainResource = MakeUnique<TerrainResource>();
         terrainResource->Allocate(resolution, heightmap);
 
+        // Collision is built from the terrain tiles
+        Ref<TerrainCollisionData> collisionData = MakeRef<TerrainCollisionData>();
+        collisionData->Create(*terrainResource, 0, Int2(0, 0), resolution);
+
         auto terrainHandle = sGetResourceManager().CreateResourceWithData("terrain_surface", std::move(terrainResource));
 
         TerrainComponent* terrain;
@@ -365,10 +369,7 @@ void SampleApplication::CreateScene()
         HeightFieldComponent* heightfield;
         object->CreateComponent(heightfield);
 
-        
-
-        heightfield->Data = MakeRef<TerrainCollisionData>();
-        heightfield->Data->Create(heightmap, resolution);
+        heightfield->Data = collisionData;
     }
 
     // Room
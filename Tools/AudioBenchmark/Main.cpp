@@ -0,0 +1,687 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <Hork/Core/CoreApplication.h>
+#include <Hork/Core/IO.h>
+
+#include <Hork/Core/Parse.h>
+#include <Hork/Core/Logger.h>
+#include <Hork/Core/Platform.h>
+#include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/AsyncJobManager.h>
+#include <Hork/Core/Thread.h>
+#include <Hork/Audio/AudioMix.h>
+#include <Hork/Audio/HRTF.h>
+#include <Hork/Audio/AudioMixer.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+const int SampleRate = 44100;
+
+enum VoiceLayout
+{
+    VOICE_MONO_16,
+    VOICE_MONO_8,
+    VOICE_STEREO_16,
+    VOICE_SPATIALIZED_STEREO_16,
+    VOICE_LAYOUT_COUNT
+};
+
+struct BenchmarkVoice
+{
+    VoiceLayout     Layout;
+    Vector<uint8_t> Frames;
+    int             FrameCount;
+    int             Position = 0;
+    int             Volume[2];
+    int             NewVolume[2];
+};
+
+void CreateVoice(BenchmarkVoice& voice, VoiceLayout layout, int index)
+{
+    const int clipFrames = SampleRate;
+
+    int channels = layout == VOICE_MONO_16 || layout == VOICE_MONO_8 ? 1 : 2;
+    int sampleBytes = layout == VOICE_MONO_8 ? 1 : 2;
+
+    voice.Layout = layout;
+    voice.FrameCount = clipFrames;
+    voice.Position = (index * 997) % clipFrames;
+    voice.Volume[0] = voice.NewVolume[0] = 8000 + index * 31 % 20000;
+    voice.Volume[1] = voice.NewVolume[1] = 8000 + index * 57 % 20000;
+    voice.Frames.Resize(clipFrames * channels * sampleBytes);
+
+    float frequency = 110.0f + index * 3.0f;
+    for (int i = 0; i < clipFrames * channels; i++)
+    {
+        float s = Math::Sin(Math::_2PI * frequency * (i / channels) / SampleRate);
+        if (sampleBytes == 1)
+            voice.Frames[i] = uint8_t(s * 127 + 128);
+        else
+            reinterpret_cast<int16_t*>(voice.Frames.ToPtr())[i] = int16_t(s * 32767);
+    }
+}
+
+int GetChannels(VoiceLayout layout)
+{
+    return layout == VOICE_MONO_16 || layout == VOICE_MONO_8 ? 1 : 2;
+}
+
+int GetSampleBits(VoiceLayout layout)
+{
+    return layout == VOICE_MONO_8 ? 8 : 16;
+}
+
+// Straightforward scalar mixing, the baseline for the SIMD kernels
+void MixVoiceReference(BenchmarkVoice const& voice, void const* frames, int frameCount, int rampFrames, float* bus)
+{
+    int channels = GetChannels(voice.Layout);
+    int sampleBits = GetSampleBits(voice.Layout);
+
+    for (int i = 0; i < frameCount; i++)
+    {
+        float gain[2];
+        for (int c = 0; c < 2; c++)
+        {
+            float from = voice.Volume[c] / 65536.0f;
+            float to = voice.NewVolume[c] / 65536.0f;
+            gain[c] = i < rampFrames ? from + (to - from) * (i + 1) / rampFrames : to;
+        }
+
+        float s[2];
+        for (int c = 0; c < channels; c++)
+        {
+            int n = i * channels + c;
+            s[c] = sampleBits == 8 ? (int(static_cast<uint8_t const*>(frames)[n]) - 128) * (255.0f / 32767) : static_cast<int16_t const*>(frames)[n] * (1.0f / 32767);
+        }
+
+        if (channels == 1)
+            s[1] = s[0];
+        else if (voice.Layout == VOICE_SPATIALIZED_STEREO_16)
+            s[0] = s[1] = (s[0] + s[1]) * 0.5f;
+
+        bus[i * 2] += s[0] * gain[0];
+        bus[i * 2 + 1] += s[1] * gain[1];
+    }
+}
+
+void MixVoice(BenchmarkVoice const& voice, void const* frames, int frameCount, int rampFrames, Vector<float>& temp, float* bus)
+{
+    int channels = GetChannels(voice.Layout);
+
+    AudioMix::Gain gain;
+    for (int c = 0; c < 2; c++)
+    {
+        gain.From[c] = voice.Volume[c] / 65536.0f;
+        gain.To[c] = voice.NewVolume[c] / 65536.0f;
+    }
+    gain.RampFrames = rampFrames;
+
+    temp.ResizeInvalidate(frameCount * channels);
+    AudioMix::ConvertToF32(frames, GetSampleBits(voice.Layout), frameCount * channels, temp.ToPtr());
+
+    if (channels == 1)
+    {
+        AudioMix::MixMono(temp.ToPtr(), frameCount, gain, bus);
+    }
+    else if (voice.Layout == VOICE_SPATIALIZED_STEREO_16)
+    {
+        AudioMix::DownmixStereo(temp.ToPtr(), frameCount, temp.ToPtr());
+        AudioMix::MixMono(temp.ToPtr(), frameCount, gain, bus);
+    }
+    else
+    {
+        AudioMix::MixStereo(temp.ToPtr(), frameCount, gain, bus);
+    }
+}
+
+double RunMixer(Vector<BenchmarkVoice>& voices, int blockFrames, int totalFrames, bool reference, Vector<int16_t>& output)
+{
+    Vector<float> bus;
+    Vector<float> temp;
+    bus.Resize(blockFrames * 2);
+    output.Resize(blockFrames * 2);
+
+    for (int v = 0; v < voices.Size(); v++)
+        voices[v].Position = (v * 997) % voices[v].FrameCount;
+
+    double startTime = Core::SysMicroseconds_d();
+
+    for (int frame = 0, block = 0; frame < totalFrames; frame += blockFrames, block++)
+    {
+        Core::ZeroMem(bus.ToPtr(), bus.Size() * sizeof(float));
+
+        for (int v = 0; v < voices.Size(); v++)
+        {
+            BenchmarkVoice& voice = voices[v];
+
+            // Every fourth voice changes its volume each block, which exercises the ramp
+            bool ramp = ((v + block) & 3) == 0;
+            voice.NewVolume[0] = ramp ? (voice.Volume[0] + 4096) & 0x7fff : voice.Volume[0];
+            voice.NewVolume[1] = ramp ? (voice.Volume[1] + 2048) & 0x7fff : voice.Volume[1];
+
+            int rampFrames = ramp ? 16 : 0;
+            int stride = GetChannels(voice.Layout) * GetSampleBits(voice.Layout) / 8;
+
+            for (int mixed = 0; mixed < blockFrames;)
+            {
+                int count = Math::Min(blockFrames - mixed, voice.FrameCount - voice.Position);
+                void const* frames = voice.Frames.ToPtr() + voice.Position * stride;
+
+                if (reference)
+                    MixVoiceReference(voice, frames, count, rampFrames, bus.ToPtr() + mixed * 2);
+                else
+                    MixVoice(voice, frames, count, rampFrames, temp, bus.ToPtr() + mixed * 2);
+
+                rampFrames = 0;
+                voice.Volume[0] = voice.NewVolume[0];
+                voice.Volume[1] = voice.NewVolume[1];
+
+                mixed += count;
+                voice.Position = (voice.Position + count) % voice.FrameCount;
+            }
+        }
+
+        AudioMix::WriteInt16(bus.ToPtr(), blockFrames, 2, output.ToPtr());
+    }
+
+    return Core::SysMicroseconds_d() - startTime;
+}
+
+Float3 GetVoiceDirection(int voice, int block)
+{
+    float yaw = voice * 0.37f + block * 0.05f;
+    float pitch = Math::Sin(voice * 0.71f + block * 0.02f) * 1.2f;
+    return Float3(Math::Cos(pitch) * Math::Sin(yaw), Math::Sin(pitch), Math::Cos(pitch) * Math::Cos(yaw));
+}
+
+void BenchmarkHRTFLookup(AudioHRTF const& hrtf)
+{
+    const int numQueries = 100000;
+
+    Vector<Float3> dirs;
+    dirs.Resize(numQueries);
+    for (int i = 0; i < numQueries; i++)
+        dirs[i] = GetVoiceDirection(i, i * 7);
+
+    Vector<int> triangles;
+    triangles.Resize(numQueries);
+
+    float u, v;
+
+    double startTime = Core::SysMicroseconds_d();
+    for (int i = 0; i < numQueries; i++)
+        triangles[i] = hrtf.FindTriangle(dirs[i], u, v);
+    double lookupTime = Core::SysMicroseconds_d() - startTime;
+
+    int numMatches = 0;
+
+    startTime = Core::SysMicroseconds_d();
+    for (int i = 0; i < numQueries; i++)
+        numMatches += hrtf.FindTriangleBruteForce(dirs[i], u, v) == triangles[i];
+    double bruteForceTime = Core::SysMicroseconds_d() - startTime;
+
+    LOG("HRTF lookup: {} triangles, {:.1f} ns/query\n", hrtf.GetIndices().Size() / 3, lookupTime * 1000.0 / numQueries);
+    LOG("HRTF brute force: {:.1f} ns/query, speedup {:.1f}x, same triangle {}/{}\n", bruteForceTime * 1000.0 / numQueries, bruteForceTime / lookupTime, numMatches, numQueries);
+}
+
+struct HRTFBenchmarkVoice
+{
+    Vector<float>   Frames;
+    Vector<float>   Stream;
+    Float3          Dir;
+    Float3          NewDir;
+};
+
+struct HRTFBenchmarkJob
+{
+    AudioHRTF const*            Hrtf;
+    HRTFWorkspace*              Workspace;
+    Vector<HRTFBenchmarkVoice>* Voices;
+    int                         BlockFrames;
+    int                         First;
+    int                         Stride;
+};
+
+void ProcessHRTFVoices(HRTFBenchmarkJob const& job)
+{
+    for (int v = job.First; v < job.Voices->Size(); v += job.Stride)
+    {
+        HRTFBenchmarkVoice& voice = (*job.Voices)[v];
+        Float3 dir;
+        job.Hrtf->ApplyHRTF(*job.Workspace, voice.Dir, voice.NewDir, voice.Frames.ToPtr(), job.BlockFrames, voice.Stream.ToPtr(), dir);
+        voice.Dir = dir;
+    }
+}
+
+// Spatialize the voices in the same way as the mixer: convolution per voice, then reduction to the bus
+double RunHRTFMixer(AudioHRTF const& hrtf, Vector<HRTFBenchmarkVoice>& voices, Vector<UniqueRef<HRTFWorkspace>>& workspaces, AsyncJobList* jobList, int blockFrames, int totalFrames)
+{
+    Vector<float> bus;
+    bus.Resize(blockFrames * 2);
+
+    AudioMix::Gain gain;
+    gain.From[0] = gain.From[1] = gain.To[0] = gain.To[1] = 0.5f / (hrtf.GetFilterSize() * 32767.0f);
+
+    int numJobs = jobList ? Math::Min(workspaces.Size(), voices.Size()) : 1;
+
+    Vector<HRTFBenchmarkJob> jobs;
+    jobs.Resize(numJobs);
+    for (int i = 0; i < numJobs; i++)
+    {
+        jobs[i].Hrtf = &hrtf;
+        jobs[i].Workspace = workspaces[i].RawPtr();
+        jobs[i].Voices = &voices;
+        jobs[i].BlockFrames = blockFrames;
+        jobs[i].First = i;
+        jobs[i].Stride = numJobs;
+    }
+
+    for (int v = 0; v < voices.Size(); v++)
+        voices[v].Dir = Float3(0.0f);
+
+    double startTime = Core::SysMicroseconds_d();
+
+    for (int frame = 0, block = 0; frame < totalFrames; frame += blockFrames, block++)
+    {
+        Core::ZeroMem(bus.ToPtr(), bus.Size() * sizeof(float));
+
+        for (int v = 0; v < voices.Size(); v++)
+            voices[v].NewDir = GetVoiceDirection(v, block);
+
+        if (jobList)
+        {
+            for (HRTFBenchmarkJob& job : jobs)
+                jobList->AddJob([](void* data) { ProcessHRTFVoices(*static_cast<HRTFBenchmarkJob*>(data)); }, &job);
+            jobList->SubmitAndWait();
+        }
+        else
+        {
+            ProcessHRTFVoices(jobs[0]);
+        }
+
+        for (HRTFBenchmarkVoice& voice : voices)
+            AudioMix::MixStereo(voice.Stream.ToPtr(), blockFrames, gain, bus.ToPtr());
+    }
+
+    return Core::SysMicroseconds_d() - startTime;
+}
+
+void BenchmarkHRTFMixer(AudioHRTF const& hrtf, int maxVoices, int blockFrames, int totalFrames, bool bReference)
+{
+    int numThreads = Thread::NumHardwareThreads ? Math::Min(Thread::NumHardwareThreads, AsyncJobManager::MAX_WORKER_THREADS) : AsyncJobManager::MAX_WORKER_THREADS;
+
+    AsyncJobManager jobManager(numThreads, 1);
+    AsyncJobList* jobList = jobManager.GetAsyncJobList(0);
+
+    Vector<UniqueRef<HRTFWorkspace>> workspaces;
+    for (int i = 0; i < numThreads; i++)
+        workspaces.Add(MakeUnique<HRTFWorkspace>(hrtf.GetFilterSize()));
+    jobList->SetMaxParallelJobs(numThreads);
+
+    int historyFrames = hrtf.GetFrameCount() - 1;
+    double blockTime = blockFrames * 1e6 / SampleRate;
+
+    LOG("HRTF mixing in blocks of {} frames ({:.1f} ms), {} jobs\n", blockFrames, blockTime / 1000.0, numThreads);
+
+    for (int numVoices = 1;; numVoices = Math::Min(numVoices * 4, maxVoices))
+    {
+        Vector<HRTFBenchmarkVoice> voices;
+        voices.Resize(numVoices);
+        for (int v = 0; v < numVoices; v++)
+        {
+            voices[v].Frames.Resize(historyFrames + blockFrames);
+            for (int i = 0; i < voices[v].Frames.Size(); i++)
+                voices[v].Frames[i] = Math::Sin(Math::_2PI * (110.0f + v * 3.0f) * i / SampleRate) * 32767;
+            voices[v].Stream.Resize(blockFrames * 2);
+        }
+
+        auto report = [&](const char* name, double microseconds)
+        {
+            double perBlock = microseconds * blockFrames / totalFrames;
+            LOG("{} voices, {}: {:.3f} ms/block, {:.2f} us/voice-block, {:.1f}% of real time budget\n",
+                numVoices,
+                name,
+                perBlock / 1000.0,
+                perBlock / numVoices,
+                perBlock / blockTime * 100.0);
+        };
+
+        double parallelTime = RunHRTFMixer(hrtf, voices, workspaces, jobList, blockFrames, totalFrames);
+        report("jobs", parallelTime);
+
+        if (bReference)
+        {
+            double serialTime = RunHRTFMixer(hrtf, voices, workspaces, nullptr, blockFrames, totalFrames);
+            report("serial", serialTime);
+            LOG("{} voices, speedup: {:.2f}x\n", numVoices, serialTime / parallelTime);
+        }
+
+        if (numVoices == maxVoices)
+            break;
+    }
+}
+
+void WriteWave(StringView fileName, void const* frames, int frameCount, int channels, AudioTransferFormat format)
+{
+    File f = File::sOpenWrite(fileName);
+    if (!f)
+    {
+        LOG("Failed to open {}\n", fileName);
+        return;
+    }
+
+    int sampleBytes = format == AudioTransferFormat::FLOAT32 ? 4 : 2;
+    uint32_t dataSize = frameCount * channels * sampleBytes;
+
+    f.Write("RIFF", 4);
+    f.WriteUInt32(36 + dataSize);
+    f.Write("WAVE", 4);
+
+    f.Write("fmt ", 4);
+    f.WriteUInt32(16);
+    f.WriteUInt16(format == AudioTransferFormat::FLOAT32 ? 3 : 1); // IEEE float or PCM
+    f.WriteUInt16(channels);
+    f.WriteUInt32(SampleRate);
+    f.WriteUInt32(SampleRate * channels * sampleBytes);
+    f.WriteUInt16(channels * sampleBytes);
+    f.WriteUInt16(sampleBytes * 8);
+
+    f.Write("data", 4);
+    f.WriteUInt32(dataSize);
+    f.Write(frames, dataSize);
+}
+
+struct MixerBenchmarkConfig
+{
+    const char* Name;
+    bool        bHRTF;
+    int         HRTFJobs;
+    bool        bReverb;
+};
+
+// Renders the tracks with the offline device as fast as possible. Returns time spent in the mixer.
+double RunOfflineMixer(AudioDevice* device, AudioMixer& mixer, Vector<AudioTrack*> const& tracks, int blockFrames, int totalFrames, Vector<uint8_t>& output)
+{
+    int frameSize = device->GetChannels() * (device->GetTransferFormat() == AudioTransferFormat::FLOAT32 ? sizeof(float) : sizeof(int16_t));
+
+    output.ResizeInvalidate(size_t(totalFrames) * frameSize);
+
+    double mixerTime = 0;
+
+    for (int frame = 0, block = 0; frame < totalFrames; frame += blockFrames, block++)
+    {
+        for (int v = 0; v < tracks.Size(); v++)
+        {
+            AudioTrack* track = tracks[v];
+            int volume[2] = {track->Volume_LOCK[0], track->Volume_LOCK[1]};
+            track->SetPlaybackParameters(volume, GetVoiceDirection(v, block), track->bSpatializedStereo_LOCK, false);
+        }
+
+        double startTime = Core::SysMicroseconds_d();
+        mixer.Update();
+        mixerTime += Core::SysMicroseconds_d() - startTime;
+
+        // The device clock advances only here, so the result does not depend on the timing
+        device->RenderOffline(output.ToPtr() + size_t(frame) * frameSize, Math::Min(blockFrames, totalFrames - frame));
+    }
+
+    return mixerTime;
+}
+
+void BenchmarkOfflineMixer(int maxVoices, int blockFrames, int totalFrames, StringView waveFile)
+{
+    const MixerBenchmarkConfig configs[] = {
+        {"dry", false, 0, false},
+        {"reverb", false, 0, true},
+        {"hrtf", true, 0, false},
+        {"hrtf jobs", true, AsyncJobManager::MAX_WORKER_THREADS, false},
+        {"hrtf jobs + reverb", true, AsyncJobManager::MAX_WORKER_THREADS, true}};
+
+    int numThreads = Thread::NumHardwareThreads ? Math::Min(Thread::NumHardwareThreads, AsyncJobManager::MAX_WORKER_THREADS) : AsyncJobManager::MAX_WORKER_THREADS;
+
+    AsyncJobManager jobManager(numThreads, 1);
+
+    Vector<BenchmarkVoice> voices;
+    voices.Resize(maxVoices);
+
+    Vector<Ref<AudioSource>> sources;
+    sources.Resize(maxVoices);
+    for (int v = 0; v < maxVoices; v++)
+    {
+        VoiceLayout layout = VoiceLayout(v % VOICE_LAYOUT_COUNT);
+        CreateVoice(voices[v], layout, v);
+        sources[v] = MakeRef<AudioSource>(voices[v].FrameCount, SampleRate, GetSampleBits(layout), GetChannels(layout), voices[v].Frames.ToPtr());
+    }
+
+    AudioOfflineDesc deviceDesc;
+    deviceDesc.SampleRate = SampleRate;
+
+    Vector<uint8_t> output;
+
+    for (int numVoices = 1;; numVoices = Math::Min(numVoices * 4, maxVoices))
+    {
+        Ref<AudioDevice> device = MakeRef<AudioDevice>(deviceDesc);
+
+        UniqueRef<AudioMixer> mixer = MakeUnique<AudioMixer>(device, jobManager.GetAsyncJobList(0));
+
+        AudioMixerSubmitQueue submitQueue;
+        Vector<AudioTrack*> tracks;
+        for (int v = 0; v < numVoices; v++)
+        {
+            // Music is not spatialized, other voices are 3D sounds
+            bool bSpatialized = voices[v].Layout != VOICE_STEREO_16;
+
+            AudioTrack* track = new AudioTrack(sources[v], voices[v].Position, 0, 0, false);
+            track->SetPlaybackParameters(voices[v].Volume, GetVoiceDirection(v, 0), bSpatialized, false);
+
+            submitQueue.Add(track);
+            tracks.Add(track);
+        }
+        mixer->SubmitTracks(submitQueue);
+
+        for (MixerBenchmarkConfig const& config : configs)
+        {
+            Snd_HRTF = config.bHRTF;
+            Snd_HRTFJobs = config.HRTFJobs;
+            Snd_Reverb = config.bReverb;
+
+            double microseconds = RunOfflineMixer(device, *mixer, tracks, blockFrames, totalFrames, output);
+
+            // Output checksum (FNV-1a) to catch changes of the mixing result
+            uint32_t checksum = 2166136261u;
+            for (uint8_t b : output)
+                checksum = (checksum ^ b) * 16777619u;
+
+            double nsPerFrame = microseconds * 1000.0 / totalFrames;
+            LOG("{} voices, {}: {:.1f} ns/frame, {:.2f} ns/voice-frame, {:.1f}x real time, checksum {:08x}\n",
+                numVoices,
+                config.Name,
+                nsPerFrame,
+                nsPerFrame / numVoices,
+                (double(totalFrames) / SampleRate) / (microseconds * 1e-6),
+                checksum);
+        }
+
+        for (AudioTrack* track : tracks)
+            track->RemoveRef();
+
+        mixer.Reset();
+
+        if (numVoices == maxVoices)
+        {
+            if (!waveFile.IsEmpty())
+                WriteWave(waveFile, output.ToPtr(), totalFrames, device->GetChannels(), device->GetTransferFormat());
+            break;
+        }
+    }
+}
+
+}
+
+int RunApplication()
+{
+    Core::SetEnableConsoleOutput(true);
+
+    const char* help = R"(
+    -voices <count>           -- Number of simultaneous voices. Default: 256
+    -block <frames>           -- Mixer block size in frames. Default: 1024
+    -seconds <value>          -- Length of mixed audio in seconds. Default: 10
+    -noref                    -- Skip the scalar reference mixer
+    -hrtf                     -- Benchmark HRTF lookup and spatialization instead of mixing
+    -mixer                    -- Benchmark the audio mixer with an offline device instead of mixing kernels
+    -wav <file>               -- Save the output of the last mixer configuration
+    )";
+
+    auto& args = CoreApplication::sArgs();
+    int i;
+
+    if (args.Find("-h") != -1)
+    {
+        LOG(help);
+        return 0;
+    }
+
+    int numVoices = 256;
+    int blockFrames = 1024;
+    float seconds = 10;
+
+    i = args.Find("-voices");
+    if (i != -1 && i + 1 < args.Count())
+        numVoices = Math::Max(1u, Core::ParseUInt32(args.At(i + 1)));
+
+    i = args.Find("-block");
+    if (i != -1 && i + 1 < args.Count())
+        blockFrames = Math::Max(16u, Core::ParseUInt32(args.At(i + 1)));
+
+    i = args.Find("-seconds");
+    if (i != -1 && i + 1 < args.Count())
+        seconds = Math::Max(0.1f, Core::ParseFloat(args.At(i + 1)));
+
+    bool bReference = args.Find("-noref") == -1;
+
+    if (args.Find("-mixer") != -1)
+    {
+        // The mixer renders 0.1 sec ahead of the playback (Snd_MixAhead), the device must not play more per block
+        blockFrames = Math::Min(blockFrames, 4096);
+
+        int totalFrames = seconds * SampleRate;
+        totalFrames = (totalFrames + blockFrames - 1) / blockFrames * blockFrames;
+
+        StringView waveFile;
+        i = args.Find("-wav");
+        if (i != -1 && i + 1 < args.Count())
+            waveFile = args.At(i + 1);
+
+        LOG("Mixing {} frames with offline device in blocks of {}\n", totalFrames, blockFrames);
+
+        BenchmarkOfflineMixer(numVoices, blockFrames, totalFrames, waveFile);
+        return 0;
+    }
+
+    if (args.Find("-hrtf") != -1)
+    {
+        blockFrames = (blockFrames + HRTF_BLOCK_LENGTH - 1) / HRTF_BLOCK_LENGTH * HRTF_BLOCK_LENGTH;
+
+        int totalFrames = seconds * SampleRate;
+        totalFrames = (totalFrames + blockFrames - 1) / blockFrames * blockFrames;
+
+        AudioHRTF hrtf(SampleRate);
+
+        BenchmarkHRTFLookup(hrtf);
+        BenchmarkHRTFMixer(hrtf, numVoices, blockFrames, totalFrames, bReference);
+        return 0;
+    }
+
+    Vector<BenchmarkVoice> voices;
+    voices.Resize(numVoices);
+    for (int v = 0; v < numVoices; v++)
+        CreateVoice(voices[v], VoiceLayout(v % VOICE_LAYOUT_COUNT), v);
+
+    int totalFrames = seconds * SampleRate;
+    totalFrames = (totalFrames + blockFrames - 1) / blockFrames * blockFrames;
+
+    Vector<int16_t> output;
+
+    LOG("Mixing {} voices, {} frames in blocks of {}\n", numVoices, totalFrames, blockFrames);
+
+    auto report = [&](const char* name, double microseconds)
+    {
+        double nsPerFrame = microseconds * 1000.0 / totalFrames;
+        LOG("{}: {:.1f} ms, {:.1f} ns/frame, {:.2f} ns/voice-frame, {:.1f}x real time\n",
+            name,
+            microseconds / 1000.0,
+            nsPerFrame,
+            nsPerFrame / numVoices,
+            (double(totalFrames) / SampleRate) / (microseconds * 1e-6));
+    };
+
+    double simdTime = RunMixer(voices, blockFrames, totalFrames, false, output);
+    report("SIMD", simdTime);
+
+    if (bReference)
+    {
+        double referenceTime = RunMixer(voices, blockFrames, totalFrames, true, output);
+        report("Scalar", referenceTime);
+        LOG("Speedup: {:.2f}x\n", referenceTime / simdTime);
+    }
+
+    return 0;
+}
+
+HK_NAMESPACE_END
+
+
+using ApplicationClass = Hk::CoreApplication;
+
+alignas(alignof(ApplicationClass)) static char AppData[sizeof(ApplicationClass)];
+
+int main(int argc, char* argv[])
+{
+    using namespace Hk;
+
+#if defined(HK_DEBUG) && defined(HK_COMPILER_MSVC)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+#ifdef HK_OS_WIN32
+    ArgumentPack args;
+#else
+    ArgumentPack args(argc, argv);
+#endif
+
+    ApplicationClass* app = new (AppData) ApplicationClass(args);
+    int exitCode = RunApplication();
+    app->~ApplicationClass();
+    return exitCode;
+}
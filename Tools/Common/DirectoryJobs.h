@@ -0,0 +1,117 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <Hork/Core/IO.h>
+#include <Hork/Core/Logger.h>
+#include <Hork/Core/AsyncJobManager.h>
+#include <Hork/Core/Containers/Vector.h>
+
+HK_NAMESPACE_BEGIN
+
+struct DirectoryJobsResult
+{
+    int NumFiles = 0;
+    int NumFailed = 0;
+};
+
+namespace DirectoryJobsImpl
+{
+
+template <typename Process>
+struct FileJob
+{
+    String         Input;
+    String         Output;
+    Process const* Func;
+    bool           bSucceeded;
+
+    static void sExecute(void* data)
+    {
+        FileJob& job = *static_cast<FileJob*>(data);
+        job.bSucceeded = (*job.Func)(job.Input, job.Output);
+    }
+};
+
+} // namespace DirectoryJobsImpl
+
+/// Runs process(input, output) as one job per file of inputDir and its subdirectories accepted by filter(fileName).
+/// The output file keeps the relative path of the input under outputDir, with the extension replaced by outputExt.
+/// Files are the unit of parallelism: process runs on a worker and must not submit its own jobs to jobList.
+template <typename Filter, typename Process>
+DirectoryJobsResult RunDirectoryJobs(StringView inputDir, StringView outputDir, StringView outputExt, Filter const& filter, Process const& process, AsyncJobList* jobList)
+{
+    using FileJob = DirectoryJobsImpl::FileJob<Process>;
+
+    Vector<FileJob> jobs;
+
+    Core::TraverseDirectory(inputDir, true,
+                            [&](StringView fileName, bool isDirectory)
+                            {
+                                if (isDirectory || !filter(fileName))
+                                    return;
+
+                                StringView relativePath = fileName.TruncateHead(inputDir.Length());
+                                while (!relativePath.IsEmpty() && relativePath[0] == '/')
+                                    relativePath = relativePath.TruncateHead(1);
+
+                                FileJob& job = jobs.EmplaceBack();
+                                job.Input      = fileName;
+                                job.Output     = PathUtils::sSetExtension(outputDir / relativePath, outputExt, true);
+                                job.Func       = &process;
+                                job.bSucceeded = false;
+                            });
+
+    DirectoryJobsResult result;
+    result.NumFiles = jobs.Size();
+    if (jobs.IsEmpty())
+        return result;
+
+    for (FileJob& job : jobs)
+        Core::CreateDirectory(job.Output, true);
+
+    jobList->SetMaxParallelJobs(jobs.Size());
+    for (FileJob& job : jobs)
+        jobList->AddJob(FileJob::sExecute, &job);
+    jobList->SubmitAndWait();
+
+    for (FileJob const& job : jobs)
+    {
+        if (!job.bSucceeded)
+        {
+            LOG("Failed: {}\n", job.Input);
+            ++result.NumFailed;
+        }
+    }
+    return result;
+}
+
+HK_NAMESPACE_END
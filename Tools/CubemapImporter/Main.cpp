@@ -34,6 +34,7 @@ SOFTWARE.
 #include <Hork/Core/Parse.h>
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/Platform.h>
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/Image/RawImage.h>
 #include <Hork/Image/Image.h>
 #include <Hork/Resources/Resource_Texture.h>
@@ -66,6 +67,7 @@ int RunApplication()
     -format                 -- Output texture format (SRGBA8_UNORM (default), SBGRA8_UNORM, R11G11B10_FLOAT, BC1_UNORM_SRGB, BC6H_UFLOAT)
     -hdri_scale <value>     -- Change the original color using the following formula: result = pow(color * hdri_scale, hdri_pow)
     -hdri_pow <value>       -- Change the original color using the following formula: result = pow(color * hdri_scale, hdri_pow)
+    -j <count>              -- Number of worker threads for compression
     )";
 
     auto& args = CoreApplication::sArgs();
@@ -131,6 +133,15 @@ int RunApplication()
         importSettings.Faces[faceNum] = args.At(i + faceNum);
     }
 
+    int numWorkerThreads = Thread::NumHardwareThreads;
+    i = args.Find("-j");
+    if (i != -1 && i + 1 < args.Count())
+        numWorkerThreads = Core::ParseInt32(args.At(i + 1));
+    numWorkerThreads = Math::Clamp(numWorkerThreads, 1, AsyncJobManager::MAX_WORKER_THREADS);
+
+    AsyncJobManager jobManager(numWorkerThreads, 1);
+    importSettings.JobList = jobManager.GetAsyncJobList(0);
+
     ImageStorage skybox = LoadSkyboxImages(importSettings);
     if (!skybox)
     {
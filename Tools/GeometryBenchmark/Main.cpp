@@ -0,0 +1,268 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <Hork/Core/CoreApplication.h>
+#include <Hork/Core/IO.h>
+
+#include <Hork/Core/Parse.h>
+#include <Hork/Core/Logger.h>
+#include <Hork/Core/Platform.h>
+#include <Hork/Core/Containers/Vector.h>
+#include <Hork/Core/AsyncJobManager.h>
+#include <Hork/Core/Thread.h>
+#include <Hork/Geometry/ConvexDecomposition.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+struct BenchmarkAsset
+{
+    Vector<Float3>       Vertices;
+    Vector<unsigned int> Indices;
+};
+
+// Concave test asset: a torus with a wavy tube. Every asset has a different shape and tessellation.
+void CreateAsset(BenchmarkAsset& asset, int index)
+{
+    const int ringSegments = 24 + (index % 4) * 8;
+    const int tubeSegments = 12 + (index % 3) * 4;
+    const float majorRadius = 1.0f + (index % 5) * 0.25f;
+    const float minorRadius = 0.25f + (index % 2) * 0.1f;
+    const float waves = float(2 + index % 3);
+
+    asset.Vertices.Clear();
+    asset.Indices.Clear();
+
+    for (int ring = 0; ring < ringSegments; ring++)
+    {
+        float u = Math::_2PI * ring / ringSegments;
+        float radius = minorRadius * (1.0f + 0.3f * std::sin(u * waves));
+
+        for (int tube = 0; tube < tubeSegments; tube++)
+        {
+            float v = Math::_2PI * tube / tubeSegments;
+            float r = majorRadius + radius * std::cos(v);
+            asset.Vertices.Add(Float3(r * std::cos(u), radius * std::sin(v), r * std::sin(u)));
+        }
+    }
+
+    for (int ring = 0; ring < ringSegments; ring++)
+    {
+        int nextRing = (ring + 1) % ringSegments;
+        for (int tube = 0; tube < tubeSegments; tube++)
+        {
+            int nextTube = (tube + 1) % tubeSegments;
+
+            unsigned int i0 = ring * tubeSegments + tube;
+            unsigned int i1 = nextRing * tubeSegments + tube;
+            unsigned int i2 = nextRing * tubeSegments + nextTube;
+            unsigned int i3 = ring * tubeSegments + nextTube;
+
+            asset.Indices.Add(i0);
+            asset.Indices.Add(i1);
+            asset.Indices.Add(i2);
+
+            asset.Indices.Add(i2);
+            asset.Indices.Add(i3);
+            asset.Indices.Add(i0);
+        }
+    }
+}
+
+void ClearCache(StringView cacheDirectory)
+{
+    Vector<String> files;
+    Core::TraverseDirectory(cacheDirectory, false,
+                            [&files](StringView fileName, bool isDirectory)
+                            {
+                                if (!isDirectory && PathUtils::sCompareExt(fileName, ".hulls"))
+                                    files.Add(String(fileName));
+                            });
+    for (String const& fileName : files)
+        Core::RemoveFile(fileName);
+}
+
+double RunBatch(Vector<ConvexDecompositionSource> const& sources, ConvexDecompositionBatchSettings const& settings, Vector<ConvexDecompositionResult>& results)
+{
+    double startTime = Core::SysMicroseconds_d();
+    Geometry::PerformConvexDecompositionBatch(sources, results, settings);
+    return Core::SysMicroseconds_d() - startTime;
+}
+
+} // namespace
+
+int RunApplication()
+{
+    Core::SetEnableConsoleOutput(true);
+
+    const char* help = R"(
+    -assets <count>           -- Number of meshes in the import set. Default: 16
+    -method <hacd/vhacd>      -- Decomposition method. Default: vhacd
+    -cache <path>             -- Hull cache directory. Default: ConvexDecompositionCache
+    -noserial                 -- Skip the decomposition on the calling thread
+    )";
+
+    auto& args = CoreApplication::sArgs();
+    int i;
+
+    if (args.Find("-h") != -1)
+    {
+        LOG(help);
+        return 0;
+    }
+
+    int numAssets = 16;
+    ConvexDecompositionMethod method = ConvexDecompositionMethod::VHACD;
+    StringView cacheDirectory = "ConvexDecompositionCache";
+
+    i = args.Find("-assets");
+    if (i != -1 && i + 1 < args.Count())
+        numAssets = Math::Max(1u, Core::ParseUInt32(args.At(i + 1)));
+
+    i = args.Find("-method");
+    if (i != -1 && i + 1 < args.Count())
+    {
+        if (!Core::Stricmp(args.At(i + 1), "hacd"))
+            method = ConvexDecompositionMethod::HACD;
+        else if (!Core::Stricmp(args.At(i + 1), "vhacd"))
+            method = ConvexDecompositionMethod::VHACD;
+        else
+        {
+            LOG("Expected -method <hacd/vhacd>\n");
+            return -1;
+        }
+    }
+
+    i = args.Find("-cache");
+    if (i != -1 && i + 1 < args.Count())
+        cacheDirectory = args.At(i + 1);
+
+    bool bSerial = args.Find("-noserial") == -1;
+
+    Vector<BenchmarkAsset> assets;
+    assets.Resize(numAssets);
+
+    Vector<ConvexDecompositionSource> sources;
+    sources.Resize(numAssets);
+
+    int totalTriangles = 0;
+    for (int n = 0; n < numAssets; n++)
+    {
+        CreateAsset(assets[n], n);
+
+        sources[n].Vertices = assets[n].Vertices.ToPtr();
+        sources[n].VertexCount = assets[n].Vertices.Size();
+        sources[n].Indices = assets[n].Indices.ToPtr();
+        sources[n].IndexCount = assets[n].Indices.Size();
+
+        totalTriangles += assets[n].Indices.Size() / 3;
+    }
+
+    int numThreads = Thread::NumHardwareThreads ? Math::Min(Thread::NumHardwareThreads, AsyncJobManager::MAX_WORKER_THREADS) : AsyncJobManager::MAX_WORKER_THREADS;
+
+    AsyncJobManager jobManager(numThreads, 1);
+
+    LOG("Decomposing {} meshes ({} triangles) with {}, {} worker threads\n", numAssets, totalTriangles, method == ConvexDecompositionMethod::HACD ? "HACD" : "V-HACD", numThreads);
+
+    Vector<ConvexDecompositionResult> results;
+
+    auto report = [&](const char* name, double microseconds)
+    {
+        int numHulls = 0;
+        int numCached = 0;
+        for (ConvexDecompositionResult const& result : results)
+        {
+            numHulls += result.Hulls.Size();
+            numCached += result.IsCached;
+        }
+        LOG("{}: {:.1f} ms, {:.2f} ms/mesh, {} hulls, {} meshes from cache\n", name, microseconds / 1000.0, microseconds / 1000.0 / numAssets, numHulls, numCached);
+    };
+
+    ConvexDecompositionBatchSettings settings;
+    settings.Method = method;
+
+    double serialTime = 0;
+    if (bSerial)
+    {
+        serialTime = RunBatch(sources, settings, results);
+        report("Serial", serialTime);
+    }
+
+    settings.JobList = jobManager.GetAsyncJobList(0);
+
+    double jobsTime = RunBatch(sources, settings, results);
+    report("Jobs", jobsTime);
+
+    settings.CacheDirectory = cacheDirectory;
+
+    Core::CreateDirectory(cacheDirectory, false);
+    ClearCache(cacheDirectory);
+
+    double coldTime = RunBatch(sources, settings, results);
+    report("Jobs, cold cache", coldTime);
+
+    double warmTime = RunBatch(sources, settings, results);
+    report("Jobs, warm cache", warmTime);
+
+    if (bSerial)
+        LOG("Jobs speedup: {:.2f}x\n", serialTime / jobsTime);
+    LOG("Warm cache speedup: {:.2f}x\n", jobsTime / warmTime);
+
+    return 0;
+}
+
+HK_NAMESPACE_END
+
+
+using ApplicationClass = Hk::CoreApplication;
+
+alignas(alignof(ApplicationClass)) static char AppData[sizeof(ApplicationClass)];
+
+int main(int argc, char* argv[])
+{
+    using namespace Hk;
+
+#if defined(HK_DEBUG) && defined(HK_COMPILER_MSVC)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+#ifdef HK_OS_WIN32
+    ArgumentPack args;
+#else
+    ArgumentPack args(argc, argv);
+#endif
+
+    ApplicationClass* app = new (AppData) ApplicationClass(args);
+    int exitCode = RunApplication();
+    app->~ApplicationClass();
+    return exitCode;
+}
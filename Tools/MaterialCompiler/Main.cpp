@@ -34,14 +34,17 @@ SOFTWARE.
 #include <Hork/Core/Parse.h>
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/Platform.h>
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/MaterialGraph/MaterialCompiler.h>
 #include <Hork/MaterialGraph/MaterialGraph.h>
 #include <Hork/ShaderUtils/ShaderCompiler.h>
 #include <Hork/Resources/Resource_Material.h>
 
+#include "../Common/DirectoryJobs.h"
+
 HK_NAMESPACE_BEGIN
 
-bool CompileMaterial(StringView input, StringView output, bool debugMode)
+bool CompileMaterial(StringView input, StringView output, bool debugMode, AsyncJobList* jobList)
 {
     LOG("Loading {}\n", input);
     auto file = File::sOpenRead(input);
@@ -60,7 +63,7 @@ bool CompileMaterial(StringView input, StringView output, bool debugMode)
 
     LOG("Compiling {}\n", input);
     MaterialResourceBuilder builder;
-    auto material = builder.Build(*graph, debugMode);
+    auto material = builder.Build(*graph, debugMode, jobList);
     if (!material)
     {
         LOG("Failed to build material graph {}\n", input);
@@ -79,6 +82,29 @@ bool CompileMaterial(StringView input, StringView output, bool debugMode)
     return true;
 }
 
+bool CompileMaterialLibrary(StringView inputDir, StringView outputDir, bool debugMode, AsyncJobList* jobList)
+{
+    auto isMaterialGraph = [](StringView fileName)
+    {
+        return PathUtils::sCompareExt(fileName, ".mg");
+    };
+
+    auto compile = [debugMode](StringView input, StringView output)
+    {
+        return CompileMaterial(input, output, debugMode, nullptr);
+    };
+
+    DirectoryJobsResult result = RunDirectoryJobs(inputDir, outputDir, ".mat", isMaterialGraph, compile, jobList);
+    if (!result.NumFiles)
+    {
+        LOG("No material graphs found in {}\n", inputDir);
+        return false;
+    }
+
+    LOG("Compiled {} of {} materials\n", result.NumFiles - result.NumFailed, result.NumFiles);
+    return result.NumFailed == 0;
+}
+
 int RunApplication()
 {
     Core::SetEnableConsoleOutput(true);
@@ -87,7 +113,11 @@ int RunApplication()
     -h                      -- Help
     -s <filename>           -- Source filename (material graph)
     -o <filename>           -- Output filename
+    -dir <directory>        -- Compile all material graphs (*.mg) of the directory and its subdirectories
+    -outdir <directory>     -- Output directory for -dir, relative paths are kept
+    -j <count>              -- Number of worker threads
     -debug                  -- Compile material in debug mode
+    -shaderCache <dir>      -- Persistent SPIR-V cache directory
     )";
 
     auto& args = CoreApplication::sArgs();
@@ -95,6 +125,8 @@ int RunApplication()
 
     const char* inputFile = nullptr;
     const char* outputFile = nullptr;
+    const char* inputDir = nullptr;
+    const char* outputDir = nullptr;
 
     i = args.Find("-h");
     if (i != -1)
@@ -103,29 +135,64 @@ int RunApplication()
         return 0;
     }
 
-    i = args.Find("-s");
-    if (i == -1 || i + 1 >= args.Count())
+    i = args.Find("-dir");
+    if (i != -1 && i + 1 < args.Count())
     {
-        LOG("Source file is not specified. Use -s <filename>\n");
-        return -1;
-    }
+        inputDir = args.At(i + 1);
 
-    inputFile = args.At(i + 1);
+        i = args.Find("-outdir");
+        if (i == -1 || i + 1 >= args.Count())
+        {
+            LOG("Output directory is not specified. Use -outdir <directory>\n");
+            return -1;
+        }
 
-    i = args.Find("-o");
-    if (i == -1 || i + 1 >= args.Count())
+        outputDir = args.At(i + 1);
+    }
+    else
     {
-        LOG("Output file is not specified. Use -o <filename>\n");
-        return -1;
+        i = args.Find("-s");
+        if (i == -1 || i + 1 >= args.Count())
+        {
+            LOG("Source file is not specified. Use -s <filename>\n");
+            return -1;
+        }
+
+        inputFile = args.At(i + 1);
+
+        i = args.Find("-o");
+        if (i == -1 || i + 1 >= args.Count())
+        {
+            LOG("Output file is not specified. Use -o <filename>\n");
+            return -1;
+        }
+
+        outputFile = args.At(i + 1);
     }
 
-    outputFile = args.At(i + 1);
-
     bool debugMode = args.Find("-debug") != -1;
 
+    int numWorkerThreads = Thread::NumHardwareThreads;
+    i = args.Find("-j");
+    if (i != -1 && i + 1 < args.Count())
+        numWorkerThreads = Core::ParseInt32(args.At(i + 1));
+    numWorkerThreads = Math::Clamp(numWorkerThreads, 1, AsyncJobManager::MAX_WORKER_THREADS);
+
     ShaderCompiler::sInitialize();
 
-    bool result = CompileMaterial(inputFile, outputFile, debugMode);
+    i = args.Find("-shaderCache");
+    if (i != -1 && i + 1 < args.Count())
+        ShaderCompiler::sSetCacheDirectory(args.At(i + 1));
+
+    bool result;
+    {
+        AsyncJobManager jobManager(numWorkerThreads, 1);
+
+        if (inputDir)
+            result = CompileMaterialLibrary(inputDir, outputDir, debugMode, jobManager.GetAsyncJobList(0));
+        else
+            result = CompileMaterial(inputFile, outputFile, debugMode, jobManager.GetAsyncJobList(0));
+    }
 
     ShaderCompiler::sDeinitialize();
 
@@ -35,18 +35,85 @@ SOFTWARE.
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/Platform.h>
 #include <Hork/Geometry/RawMesh.h>
+#include <Hork/Geometry/MeshOptimizer.h>
 #include <Hork/Resources/Resource_Mesh.h>
 #include <Hork/Resources/Resource_Animation.h>
+#include <Hork/Resources/Resource_Collision.h>
+#include <Hork/Runtime/World/Modules/Physics/PhysicsModule.h>
 
 HK_NAMESPACE_BEGIN
 
-bool ImportMesh(RawMesh const& rawMesh, StringView outputFile)
+float CalcMeshACMR(RawMesh const& rawMesh)
+{
+    uint32_t triangleCount = 0;
+    float misses = 0;
+    for (auto& surface : rawMesh.Surfaces)
+    {
+        uint32_t surfaceTriangles = surface->Indices.Size() / 3;
+        misses += Geometry::CalcACMR(surface->Indices.ToPtr(), surface->Indices.Size(), surface->Positions.Size()) * surfaceTriangles;
+        triangleCount += surfaceTriangles;
+    }
+    return triangleCount ? misses / triangleCount : 0.0f;
+}
+
+float CalcMeshACMR(MeshResource const& resource)
+{
+    uint32_t triangleCount = 0;
+    float misses = 0;
+    for (int surfaceIndex = 0; surfaceIndex < resource.GetSurfaceCount(); ++surfaceIndex)
+    {
+        MeshSurface const& surface = resource.GetSurfaces()[surfaceIndex];
+        uint32_t surfaceTriangles = surface.IndexCount / 3;
+        misses += Geometry::CalcACMR(resource.GetIndices() + surface.FirstIndex, surface.IndexCount, surface.VertexCount) * surfaceTriangles;
+        triangleCount += surfaceTriangles;
+    }
+    return triangleCount ? misses / triangleCount : 0.0f;
+}
+
+bool ImportCollision(MeshResource const& meshResource, StringView outputFile, CollisionCookMode mode)
+{
+    String fileName = PathUtils::sGetFilenameNoExt(outputFile) + ".collision";
+
+    LOG("Cooking collision {}...\n", fileName);
+
+    // Jolt types are registered by the physics module
+    PhysicsModule::sInitialize();
+
+    CollisionResourceBuilder builder;
+    builder.Mode = mode;
+    auto collisionResource = builder.Build(meshResource);
+
+    bool result = false;
+    if (collisionResource)
+    {
+        LOG("Collision parts: {}\n", collisionResource->GetPartCount());
+
+        File file = File::sOpenWrite(fileName);
+        if (file)
+        {
+            collisionResource->Write(file);
+            result = true;
+        }
+        else
+            LOG("Failed to open \"{}\"\n", fileName);
+    }
+    else
+        LOG("Failed to build collision\n");
+
+    collisionResource.Reset();
+    PhysicsModule::sDeinitialize();
+    return result;
+}
+
+bool ImportMesh(RawMesh const& rawMesh, StringView outputFile, MeshOptimizationFlags optimization, uint32_t lodCount, CollisionCookMode const* collisionMode)
 {
     String fileName = PathUtils::sGetFilenameNoExt(outputFile) + ".mesh";
 
     LOG("Importing mesh {}...\n", fileName);
 
     MeshResourceBuilder builder;
+    builder.Optimization = optimization;
+    builder.LodCount = lodCount;
     auto meshResource = builder.Build(rawMesh);
     if (!meshResource)
     {
@@ -54,6 +121,16 @@ bool ImportMesh(RawMesh const& rawMesh, StringView outputFile)
         return false;
     }
 
+    if (optimization != MeshOptimizationFlags::None)
+        LOG("ACMR {:.3f} -> {:.3f}\n", CalcMeshACMR(rawMesh), CalcMeshACMR(*meshResource));
+
+    for (int surfaceIndex = 0; surfaceIndex < meshResource->GetSurfaceCount(); ++surfaceIndex)
+    {
+        MeshSurface const& surface = meshResource->GetSurfaces()[surfaceIndex];
+        for (uint32_t lodIndex = 0; lodIndex < surface.Lods.Size(); ++lodIndex)
+            LOG("Surface {} LOD {}: {} triangles, error {:.4f}\n", surfaceIndex, lodIndex + 1, surface.Lods[lodIndex].IndexCount / 3, surface.Lods[lodIndex].Error);
+    }
+
 
     File file = File::sOpenWrite(fileName);
     if (!file)
@@ -63,6 +140,9 @@ bool ImportMesh(RawMesh const& rawMesh, StringView outputFile)
     }
 
     meshResource->Write(file);
+
+    if (collisionMode)
+        return ImportCollision(*meshResource, outputFile, *collisionMode);
     return true;
 }
 
@@ -279,6 +359,9 @@ int RunApplication()
     -m                        -- Tag to import mesh
     -a <index/all>            -- Tag to import animation(s)
     -d <path>                 -- Tag for creating default meshes such as box, cylinder, sphere, etc
+    -lods <count>             -- Number of simplified LODs generated per surface. Default: 0
+    -opt <all/cache/none>     -- Mesh optimization: vertex cache, overdraw and vertex fetch (all) or vertex cache only (cache). Default: all
+    -collision <soup/hull/hacd/vhacd> -- Cook collision shapes of the mesh to <filename>.collision
     )";
 
     auto& args = CoreApplication::sArgs();
@@ -355,10 +438,62 @@ int RunApplication()
         }
     }
 
+    MeshOptimizationFlags optimization = MeshOptimizationFlags::All;
+    i = args.Find("-opt");
+    if (i != -1)
+    {
+        const char* value = i + 1 < args.Count() ? args.At(i + 1) : "";
+        if (!Core::Stricmp(value, "all"))
+            optimization = MeshOptimizationFlags::All;
+        else if (!Core::Stricmp(value, "cache"))
+            optimization = MeshOptimizationFlags::VertexCache;
+        else if (!Core::Stricmp(value, "none"))
+            optimization = MeshOptimizationFlags::None;
+        else
+        {
+            LOG("Expected -opt <all/cache/none>\n");
+            return -1;
+        }
+    }
+
+    uint32_t lodCount = 0;
+    i = args.Find("-lods");
+    if (i != -1)
+    {
+        if (i + 1 >= args.Count())
+        {
+            LOG("Expected -lods <count>\n");
+            return -1;
+        }
+        lodCount = Core::ParseUInt32(args.At(i + 1));
+    }
+
+    CollisionCookMode collisionMode;
+    bool cookCollision = false;
+    i = args.Find("-collision");
+    if (i != -1)
+    {
+        const char* value = i + 1 < args.Count() ? args.At(i + 1) : "";
+        if (!Core::Stricmp(value, "soup"))
+            collisionMode = CollisionCookMode::TriangleSoup;
+        else if (!Core::Stricmp(value, "hull"))
+            collisionMode = CollisionCookMode::ConvexHull;
+        else if (!Core::Stricmp(value, "hacd"))
+            collisionMode = CollisionCookMode::ConvexDecomposition;
+        else if (!Core::Stricmp(value, "vhacd"))
+            collisionMode = CollisionCookMode::ConvexDecompositionVHACD;
+        else
+        {
+            LOG("Expected -collision <soup/hull/hacd/vhacd>\n");
+            return -1;
+        }
+        cookCollision = true;
+    }
+
     i = args.Find("-m");
     if (i != -1)
     {
-        if (!ImportMesh(mesh, outputFile))
+        if (!ImportMesh(mesh, outputFile, optimization, lodCount, cookCollision ? &collisionMode : nullptr))
             return -1;
     }
 
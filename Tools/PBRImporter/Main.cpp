@@ -34,6 +34,7 @@ SOFTWARE.
 #include <Hork/Core/Parse.h>
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/Platform.h>
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/Image/RawImage.h>
 #include <Hork/Image/Image.h>
 #include <Hork/Image/ImageEncoders.h>
@@ -79,6 +80,8 @@ RawImageResampleParams resampleParams;
 bool resample = false;
 const char* outputPBRMap = nullptr;
 const char* outputNormalMap = nullptr;
+BC7CompressionSettings bc7Settings;
+int numWorkerThreads = Thread::NumHardwareThreads;
 
 RawImage CreateORMX()
 {
@@ -327,6 +330,12 @@ int RunApplication()
                                 ORMX_BC7 (R - occlusion, G - roughness, B - metallic, A - optional map)
                                     Output format BC7_UNORM
 
+    -j <count>              -- Number of worker threads for mipmap generation and compression
+
+    BC7 compression (ORMX_BC7 preset):
+        -bc7_level <level>  -- Encoder quality level 0..4 (default 4)
+        -bc7_rdo <lambda>   -- Rate-distortion optimization for better packing, 0.1..10 (default 0 - disabled)
+
     Notes about emission:
             To convert the emission in full RGB color use TextureImporter.
             BC1 compression is preferred because it requires less memory.
@@ -565,6 +574,18 @@ int RunApplication()
         resampleParams.VerticalFilter = GetResampleFilter(args.At(i + 2));
     }
 
+    i = args.Find("-bc7_level");
+    if (i != -1 && i + 1 < args.Count())
+        bc7Settings.Level = Math::Min(Core::ParseUInt32(args.At(i + 1)), 4u);
+    i = args.Find("-bc7_rdo");
+    if (i != -1 && i + 1 < args.Count())
+        bc7Settings.RDOLambda = Math::Max(Core::ParseFloat(args.At(i + 1)), 0.0f);
+
+    i = args.Find("-j");
+    if (i != -1 && i + 1 < args.Count())
+        numWorkerThreads = Core::ParseInt32(args.At(i + 1));
+    numWorkerThreads = Math::Clamp(numWorkerThreads, 1, AsyncJobManager::MAX_WORKER_THREADS);
+
     RawImage ormx;
     RawImage normalmap;
 
@@ -708,6 +729,9 @@ int RunApplication()
 
             ImageStorage compressedORMX = ImageStorage(desc);
 
+            TextureBlockCompression::BlockCompressionBatch batch;
+            batch.BC7 = bc7Settings;
+
             for (uint32_t level = 0; level < desc.NumMipmaps; ++level)
             {
                 ImageSubresource src = uncompressedORMX.GetSubresource({0, level});
@@ -715,23 +739,12 @@ int RunApplication()
 
                 HK_ASSERT(src.GetWidth() == dst.GetWidth() && src.GetHeight() == dst.GetHeight());
 
-                switch (pbrPreset)
-                {
-                case ORMX_BC1:
-                    TextureBlockCompression::CompressBC1(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
-                    break;
-                case ORMX_BC3:
-                    TextureBlockCompression::CompressBC3(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
-                    break;
-                case ORMX_BC7:
-                    TextureBlockCompression::CompressBC7(src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
-                    break;
-                default:
-                    HK_ASSERT(0);
-                    return -1;
-                }            
+                batch.Add(desc.Format, src.GetData(), dst.GetData(), dst.GetWidth(), dst.GetHeight());
             }
 
+            AsyncJobManager jobManager(numWorkerThreads, 1);
+            batch.Compress(jobManager.GetAsyncJobList(0));
+
             if (!ImportImage(compressedORMX, outputPBRMap))
                 return -1;
         }
@@ -34,10 +34,13 @@ SOFTWARE.
 #include <Hork/Core/Parse.h>
 #include <Hork/Core/Logger.h>
 #include <Hork/Core/Platform.h>
+#include <Hork/Core/AsyncJobManager.h>
 #include <Hork/Image/RawImage.h>
 #include <Hork/Image/Image.h>
 #include <Hork/Resources/Resource_Texture.h>
 
+#include "../Common/DirectoryJobs.h"
+
 HK_NAMESPACE_BEGIN
 
 bool ImportImage(ImageStorage& storage, StringView fileName)
@@ -55,6 +58,95 @@ bool ImportImage(ImageStorage& storage, StringView fileName)
     return true;
 }
 
+struct TextureCookParams
+{
+    IMAGE_STORAGE_FLAGS    Flags = IMAGE_STORAGE_FLAGS_DEFAULT;
+    TEXTURE_FORMAT         Format = TEXTURE_FORMAT_UNDEFINED;
+    ImageMipmapConfig      MipmapConfig;
+    bool                   bGenerateMipmaps = false;
+    RawImageResampleParams ResampleParams;
+    bool                   bResample = false;
+    BC7CompressionSettings BC7;
+};
+
+bool CookTexture(StringView input, StringView output, TextureCookParams const& params, AsyncJobList* jobList)
+{
+    String filename(input);
+
+    LOG("Loading {}...\n", filename);
+
+    if (params.bResample)
+    {
+        RawImage image = CreateRawImage(filename);
+        if (!image)
+        {
+            LOG("Failed to load {}\n", filename);
+            return false;
+        }
+
+        RawImage resampled = ResampleRawImage(image, params.ResampleParams);
+        if (!resampled)
+        {
+            LOG("Failed to resample {}\n", filename);
+            return false;
+        }
+
+        // Keep the resampled image next to the output, so it never lands in a scanned source directory
+        filename = PathUtils::sSetExtension(output, ".resample.png", true);
+        if (!WriteImage(filename, resampled))
+        {
+            LOG("Failed to write resampled image\n");
+            return false;
+        }
+    }
+
+    ImageCookSettings cookSettings;
+    cookSettings.JobList = jobList;
+    cookSettings.BC7     = params.BC7;
+
+    ImageStorage source = CreateImage(filename, params.bGenerateMipmaps ? &params.MipmapConfig : nullptr, params.Flags, params.Format, &cookSettings);
+    if (!source)
+    {
+        LOG("Failed to load {}\n", filename);
+        return false;
+    }
+
+    return ImportImage(source, output);
+}
+
+bool IsSourceImage(StringView fileName)
+{
+    // Resampled images left by older versions of the importer
+    if (fileName.FindSubstringIcmp(".resample.") != Core::NPOS)
+        return false;
+
+    const char* extensions[] = {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif", ".hdr", ".exr", ".webp"};
+    for (const char* ext : extensions)
+    {
+        if (PathUtils::sCompareExt(fileName, ext))
+            return true;
+    }
+    return false;
+}
+
+bool CookTextureDirectory(StringView inputDir, StringView outputDir, TextureCookParams const& params, AsyncJobList* jobList)
+{
+    auto cook = [&params](StringView input, StringView output)
+    {
+        return CookTexture(input, output, params, nullptr);
+    };
+
+    DirectoryJobsResult result = RunDirectoryJobs(inputDir, outputDir, ".tex", IsSourceImage, cook, jobList);
+    if (!result.NumFiles)
+    {
+        LOG("No images found in {}\n", inputDir);
+        return false;
+    }
+
+    LOG("Cooked {} of {} textures\n", result.NumFiles - result.NumFailed, result.NumFiles);
+    return result.NumFailed == 0;
+}
+
 int RunApplication()
 {
     Core::SetEnableConsoleOutput(true);
@@ -63,6 +155,9 @@ int RunApplication()
     -h                      -- Help
     -s <filename>           -- Source filename
     -o <filename>           -- Output filename
+    -dir <directory>        -- Cook all images of the directory and its subdirectories
+    -outdir <directory>     -- Output directory for -dir, relative paths are kept
+    -j <count>              -- Number of worker threads
     -no_alpha               -- Don't aware about alpha channel or ignore it
     -alpha_premult          -- Set this flag if your texture has premultiplied alpha
     -format                 -- Output texture format (See Image.cpp, TexFormat)
@@ -71,6 +166,11 @@ int RunApplication()
     -resample_edge_mode <mode_h> <mode_v>       -- Use edge mode for resampling (clamp/reflect/wrap/zero)
     -resample_filter <filter_h> <filter_v>      -- Use filter for resampling (box/triangle/cubicspline/catmullrom/mitchell)
 
+    BC7 compression:
+        -bc7_level <level>      -- Encoder quality level 0..4 (default 4)
+        -bc7_perceptual         -- Use perceptual error metric
+        -bc7_rdo <lambda>       -- Rate-distortion optimization for better packing, 0.1..10 (default 0 - disabled)
+
     Mipmap generation:
         Don't specify if you don't want to generate mipmaps
 
@@ -96,15 +196,12 @@ int RunApplication()
     auto& args = CoreApplication::sArgs();
     int i;
 
-    ImageStorage source;
+    const char* inputFile = nullptr;
     const char* outputFile = nullptr;
+    const char* inputDir = nullptr;
+    const char* outputDir = nullptr;
 
-    IMAGE_STORAGE_FLAGS flags = IMAGE_STORAGE_FLAGS_DEFAULT;
-    TEXTURE_FORMAT format = TEXTURE_FORMAT_UNDEFINED;
-    ImageMipmapConfig mipmapConfig;
-    bool generateMipmaps = false;
-    RawImageResampleParams resampleParams;
-    bool resample = false;
+    TextureCookParams params;
 
     i = args.Find("-h");
     if (i != -1)
@@ -115,37 +212,49 @@ int RunApplication()
 
     i = args.Find("-no_alpha");
     if (i != -1)
-        flags |= IMAGE_STORAGE_NO_ALPHA;
+        params.Flags |= IMAGE_STORAGE_NO_ALPHA;
     i = args.Find("-alpha_premult");
     if (i != -1)
-        flags |= IMAGE_STORAGE_ALPHA_PREMULTIPLIED;
+        params.Flags |= IMAGE_STORAGE_ALPHA_PREMULTIPLIED;
     i = args.Find("-format");
     if (i != -1 && i + 1 < args.Count())
-        format = FindTextureFormat(args.At(i + 1));
+        params.Format = FindTextureFormat(args.At(i + 1));
+
+    i = args.Find("-bc7_level");
+    if (i != -1 && i + 1 < args.Count())
+        params.BC7.Level = Math::Min(Core::ParseUInt32(args.At(i + 1)), 4u);
+    i = args.Find("-bc7_perceptual");
+    if (i != -1)
+        params.BC7.bPerceptual = true;
+    i = args.Find("-bc7_rdo");
+    if (i != -1 && i + 1 < args.Count())
+        params.BC7.RDOLambda = Math::Max(Core::ParseFloat(args.At(i + 1)), 0.0f);
 
     i = args.Find("-mip_edge_mode");
     if (i != -1 && i + 1 < args.Count())
     {
-        mipmapConfig.EdgeMode = GetResampleEdgeMode(args.At(i + 1));
-        generateMipmaps = true;
+        params.MipmapConfig.EdgeMode = GetResampleEdgeMode(args.At(i + 1));
+        params.bGenerateMipmaps = true;
     }
     i = args.Find("-mip_filter");
     if (i != -1 && i + 1 < args.Count())
     {
-        mipmapConfig.Filter = GetResampleFilter(args.At(i + 1));
-        generateMipmaps = true;
+        params.MipmapConfig.Filter = GetResampleFilter(args.At(i + 1));
+        params.bGenerateMipmaps = true;
     }
     i = args.Find("-mip_filter_3d");
     if (i != -1 && i + 1 < args.Count())
     {
-        mipmapConfig.Filter3D = GetResampleFilter3D(args.At(i + 1));
-        generateMipmaps = true;
+        params.MipmapConfig.Filter3D = GetResampleFilter3D(args.At(i + 1));
+        params.bGenerateMipmaps = true;
     }
 
+    RawImageResampleParams& resampleParams = params.ResampleParams;
+
     i = args.Find("-resample");
     if (i != -1 && i + 2 < args.Count())
     {
-        resample = true;
+        params.bResample = true;
 
         resampleParams.ScaledWidth = Core::ParseUInt32(args.At(i + 1));
         resampleParams.ScaledHeight = Core::ParseUInt32(args.At(i + 2));
@@ -160,17 +269,17 @@ int RunApplication()
             return -1;
         }
 
-        auto const& texFormat = GetTextureFormatInfo(format);
+        auto const& texFormat = GetTextureFormatInfo(params.Format);
         const uint32_t blockSize = texFormat.BlockSize;
 
-        resampleParams.ScaledWidth  = generateMipmaps ? Math::Max<uint32_t>(Math::ToClosestPowerOfTwo(resampleParams.ScaledWidth), blockSize) : Align(resampleParams.ScaledWidth, blockSize);
-        resampleParams.ScaledHeight = generateMipmaps ? Math::Max<uint32_t>(Math::ToClosestPowerOfTwo(resampleParams.ScaledHeight), blockSize) : Align(resampleParams.ScaledHeight, blockSize);
+        resampleParams.ScaledWidth  = params.bGenerateMipmaps ? Math::Max<uint32_t>(Math::ToClosestPowerOfTwo(resampleParams.ScaledWidth), blockSize) : Align(resampleParams.ScaledWidth, blockSize);
+        resampleParams.ScaledHeight = params.bGenerateMipmaps ? Math::Max<uint32_t>(Math::ToClosestPowerOfTwo(resampleParams.ScaledHeight), blockSize) : Align(resampleParams.ScaledHeight, blockSize);
 
         resampleParams.Flags = RAW_IMAGE_RESAMPLE_FLAG_DEFAULT;
-        if (texFormat.bHasAlpha && !(flags & IMAGE_STORAGE_NO_ALPHA))
+        if (texFormat.bHasAlpha && !(params.Flags & IMAGE_STORAGE_NO_ALPHA))
         {
             resampleParams.Flags |= RAW_IMAGE_RESAMPLE_HAS_ALPHA;
-            if (flags & IMAGE_STORAGE_ALPHA_PREMULTIPLIED)
+            if (params.Flags & IMAGE_STORAGE_ALPHA_PREMULTIPLIED)
                 resampleParams.Flags |= RAW_IMAGE_RESAMPLE_ALPHA_PREMULTIPLIED;
         }
         if (texFormat.bSRGB)
@@ -191,65 +300,58 @@ int RunApplication()
         resampleParams.VerticalFilter = GetResampleFilter(args.At(i + 2));
     }
 
-    i = args.Find("-o");
+    i = args.Find("-dir");
     if (i != -1 && i + 1 < args.Count())
     {
-        outputFile = args.At(i + 1);
+        inputDir = args.At(i + 1);
+
+        i = args.Find("-outdir");
+        if (i == -1 || i + 1 >= args.Count())
+        {
+            LOG("Output directory is not specified. Use -outdir <directory>\n");
+            return -1;
+        }
+
+        outputDir = args.At(i + 1);
     }
     else
     {
-        LOG("Output file is not specified. Use -o <filename>\n");
-        return -1;
-    }
-
-    i = args.Find("-s");
-    if (i != -1 && i + 1 < args.Count())
-    {
-        String filename = args.At(i + 1);
-
-        LOG("Loading {}...\n", filename);
-
-        if (resample)
+        i = args.Find("-o");
+        if (i == -1 || i + 1 >= args.Count())
         {
-            RawImage image = CreateRawImage(filename);
-            if (!image)
-            {
-                LOG("Failed to load {}\n", filename);
-                return -1;
-            }
-
-            RawImage resampled = ResampleRawImage(image, resampleParams);
-            if (!resampled)
-            {
-                LOG("Failed to resample {}\n", filename);
-                return -1;
-            }
-
-            filename += ".resample.png";
-            if (!WriteImage(filename, resampled))
-            {
-                LOG("Failed to write resampled image\n");
-                return -1;
-            }
+            LOG("Output file is not specified. Use -o <filename>\n");
+            return -1;
         }
 
-        source = CreateImage(filename, generateMipmaps ? &mipmapConfig : nullptr, flags, format);
-        if (!source)
+        outputFile = args.At(i + 1);
+
+        i = args.Find("-s");
+        if (i == -1 || i + 1 >= args.Count())
         {
-            LOG("Failed to load {}\n", filename);
+            LOG("Source file is not specified. Use -s <filename>\n");
             return -1;
         }
 
-        if (!ImportImage(source, outputFile))
-            return -1;
+        inputFile = args.At(i + 1);
     }
-    else
+
+    int numWorkerThreads = Thread::NumHardwareThreads;
+    i = args.Find("-j");
+    if (i != -1 && i + 1 < args.Count())
+        numWorkerThreads = Core::ParseInt32(args.At(i + 1));
+    numWorkerThreads = Math::Clamp(numWorkerThreads, 1, AsyncJobManager::MAX_WORKER_THREADS);
+
+    bool result;
     {
-        LOG("Source file is not specified. Use -s <filename>\n");
-        return -1;
+        AsyncJobManager jobManager(numWorkerThreads, 1);
+
+        if (inputDir)
+            result = CookTextureDirectory(inputDir, outputDir, params, jobManager.GetAsyncJobList(0));
+        else
+            result = CookTexture(inputFile, outputFile, params, jobManager.GetAsyncJobList(0));
     }
 
-    return 0;
+    return result ? 0 : -1;
 }
 
 HK_NAMESPACE_END
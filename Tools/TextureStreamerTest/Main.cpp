@@ -0,0 +1,326 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <Hork/Core/CoreApplication.h>
+#include <Hork/Core/ReadWriteBuffer.h>
+#include <Hork/Core/Logger.h>
+#include <Hork/Core/Platform.h>
+#include <Hork/RHI/CreateDevice.h>
+#include <Hork/Resources/Resource_Texture.h>
+#include <Hork/Runtime/ResourceManager/TextureStreamer.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+constexpr uint32_t TextureSize = 1024;
+constexpr uint32_t MipTailSize = 256;
+
+int NumFailures = 0;
+
+void Check(bool condition, StringView description)
+{
+    if (!condition)
+    {
+        LOG("FAILED: {}\n", description);
+        ++NumFailures;
+    }
+}
+
+/// Streamable texture read from the synthetic texture file. Only the mip tail is resident after the upload.
+UniqueRef<TextureResource> CreateStreamableTexture(RHI::IDevice* device)
+{
+    ImageStorageDesc desc;
+    desc.Type = TEXTURE_2D;
+    desc.Width = TextureSize;
+    desc.Height = TextureSize;
+    desc.NumMipmaps = CalcNumMips(TEXTURE_FORMAT_RGBA8_UNORM, TextureSize, TextureSize);
+    desc.Format = TEXTURE_FORMAT_RGBA8_UNORM;
+
+    ReadWriteBuffer buffer;
+    buffer.SetName("Synthetic");
+    AssetUtils::CreateTexture(buffer, ImageStorage(desc));
+    buffer.SeekSet(0);
+
+    auto texture = TextureResource::sLoad(buffer, MipTailSize);
+    if (texture)
+        texture->Upload(device);
+    return texture;
+}
+
+ResourceID MakeResourceID(uint32_t index)
+{
+    return ResourceID(RESOURCE_TEXTURE, index + 1);
+}
+
+/// Loads the requested mip chains. The content is not checked by the streamer, only the size.
+void CompleteRequests(RHI::IDevice* device, TextureStreamer& streamer, Vector<TextureStreamer::Request> const& requests)
+{
+    for (TextureStreamer::Request const& request : requests)
+    {
+        HeapBlob data(request.SizeInBytes);
+        data.ZeroMem();
+        Check(streamer.Complete(device, request, data), "request completed");
+    }
+}
+
+struct StreamerTest
+{
+    RHI::IDevice*                       Device;
+    TextureStreamer                     Streamer;
+    Vector<UniqueRef<TextureResource>>  Textures;
+    Vector<TextureStreamer::Request>    Requests;
+
+    explicit StreamerTest(RHI::IDevice* device, uint32_t textureCount) :
+        Device(device)
+    {
+        for (uint32_t i = 0; i < textureCount; ++i)
+        {
+            Textures.Add(CreateStreamableTexture(device));
+            Streamer.Register(MakeResourceID(i), Textures.Last().RawPtr());
+        }
+    }
+
+    ~StreamerTest()
+    {
+        for (uint32_t i = 0; i < Textures.Size(); ++i)
+            Streamer.Unregister(MakeResourceID(i));
+    }
+
+    size_t ChainSize(uint32_t firstMip) const
+    {
+        return Textures[0]->GetMipChainSize(firstMip);
+    }
+
+    uint32_t MipTail() const
+    {
+        return Textures[0]->GetMipTail();
+    }
+
+    /// Requests the full resolution for the listed textures and plans one frame
+    void Update(std::initializer_list<uint32_t> visible)
+    {
+        for (uint32_t i : visible)
+            Textures[i]->RequestScreenSize(TextureSize);
+
+        Requests.Clear();
+        Streamer.Update(Requests);
+    }
+
+    void Complete()
+    {
+        CompleteRequests(Device, Streamer, Requests);
+    }
+
+    bool HasRequest(uint32_t requestIndex, uint32_t textureIndex, uint32_t firstMip) const
+    {
+        return requestIndex < Requests.Size() &&
+            Requests[requestIndex].Resource == MakeResourceID(textureIndex) &&
+            Requests[requestIndex].FirstMip == firstMip;
+    }
+};
+
+void TestMipTailFallback(RHI::IDevice* device)
+{
+    LOG("Mip tail fallback\n");
+
+    StreamerTest test(device, 1);
+    TextureResource* texture = test.Textures[0].RawPtr();
+
+    Check(texture->IsStreamable() && texture->GetResidentMip() == texture->GetMipTail(), "texture is loaded with the mip tail");
+    Check(test.Streamer.GetMemoryUsage() == test.ChainSize(test.MipTail()), "mip tail is counted");
+
+    // The full chain does not fit, the next coarser level is loaded instead
+    test.Streamer.SetBudget(test.ChainSize(1));
+    test.Update({0});
+    Check(test.Requests.Size() == 1 && test.HasRequest(0, 0, 1), "coarser level is requested when the wanted one exceeds the budget");
+    test.Complete();
+    Check(texture->GetResidentMip() == 1, "coarser level is resident");
+
+    // Nothing else fits
+    test.Streamer.SetBudget(test.ChainSize(test.MipTail()));
+    test.Update({});
+    Check(test.Requests.Size() == 1 && test.HasRequest(0, 0, test.MipTail()), "unused texture falls back to the mip tail");
+    test.Complete();
+    Check(texture->GetResidentMip() == texture->GetMipTail(), "mip tail is resident");
+
+    test.Update({0});
+    Check(test.Requests.IsEmpty(), "no levels are requested above the budget");
+    Check(test.Streamer.GetMemoryUsage() <= test.Streamer.GetBudget(), "budget is kept");
+}
+
+void TestBudget(RHI::IDevice* device)
+{
+    LOG("Budget enforcement\n");
+
+    StreamerTest test(device, 4);
+
+    // Room for two full chains, the other textures have to stay coarser
+    test.Streamer.SetBudget(test.ChainSize(0) * 2 + test.ChainSize(test.MipTail()) * 2);
+    test.Streamer.SetMaxRequestsPerUpdate(2);
+
+    for (int frame = 0; frame < 8; ++frame)
+    {
+        test.Update({0, 1, 2, 3});
+        Check(test.Streamer.GetMemoryUsage() <= test.Streamer.GetBudget(), "memory usage is within the budget");
+        Check(test.Requests.Size() <= 2, "request count is limited");
+        test.Complete();
+    }
+
+    uint32_t fullChains = 0;
+    size_t residentSize = 0;
+    for (auto& texture : test.Textures)
+    {
+        if (texture->GetResidentMip() == 0)
+            ++fullChains;
+        residentSize += texture->GetMipChainSize(texture->GetResidentMip());
+    }
+    Check(fullChains == 2, "two textures have the full mip chain");
+    Check(residentSize == test.Streamer.GetMemoryUsage(), "memory usage matches the resident levels");
+
+    // Reducing the budget streams out the textures that are no longer drawn
+    test.Streamer.SetBudget(test.ChainSize(test.MipTail()) * 4);
+    test.Streamer.SetMaxRequestsPerUpdate(8);
+    test.Update({});
+    Check(test.Streamer.GetMemoryUsage() <= test.Streamer.GetBudget(), "reduced budget is applied");
+    test.Complete();
+}
+
+void TestEvictionOrder(RHI::IDevice* device)
+{
+    LOG("LRU eviction order\n");
+
+    StreamerTest test(device, 4);
+
+    size_t extraSize = test.ChainSize(0) - test.ChainSize(test.MipTail());
+
+    // Textures 0, 1, 2 get the full chain, texture 3 keeps the mip tail
+    test.Streamer.SetBudget(test.ChainSize(test.MipTail()) * 4 + extraSize * 3);
+    test.Update({0, 1, 2});
+    Check(test.Requests.Size() == 3, "visible textures are streamed in");
+    test.Complete();
+
+    // Last used: texture 0 - frame 1, texture 1 - frame 2, texture 2 - frame 3
+    test.Update({1, 2});
+    test.Update({2});
+    Check(test.Requests.IsEmpty(), "nothing is streamed out without memory pressure");
+
+    // Streaming in texture 3 evicts the least recently used texture only
+    test.Update({3});
+    Check(test.Requests.Size() == 2 && test.HasRequest(0, 0, test.MipTail()) && test.HasRequest(1, 3, 0), "least recently used texture is evicted first");
+    test.Complete();
+
+    // Texture 1 is the next one
+    test.Streamer.SetBudget(test.Streamer.GetBudget() - extraSize);
+    test.Update({3});
+    Check(test.Requests.Size() == 1 && test.HasRequest(0, 1, test.MipTail()), "eviction follows the last use");
+    test.Complete();
+
+    Check(test.Textures[2]->GetResidentMip() == 0 && test.Textures[3]->GetResidentMip() == 0, "recently used textures stay resident");
+}
+
+void TestPinned(RHI::IDevice* device)
+{
+    LOG("Pinned textures\n");
+
+    StreamerTest test(device, 2);
+
+    // Only the mip tails fit
+    test.Streamer.SetBudget(test.ChainSize(test.MipTail()) * 2);
+    test.Streamer.SetPinned(MakeResourceID(0), true);
+
+    test.Update({1});
+    Check(test.Requests.Size() == 1 && test.HasRequest(0, 0, 0), "pinned texture gets the full chain without a size request");
+    test.Complete();
+
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        test.Update({1});
+        Check(test.Requests.IsEmpty(), "pinned texture is not streamed out");
+    }
+    Check(test.Textures[0]->GetResidentMip() == 0, "pinned texture keeps the full chain");
+}
+
+} // namespace
+
+int RunApplication()
+{
+    Core::SetEnableConsoleOutput(true);
+
+    Ref<RHI::IDevice> device;
+    RHI::CreateLogicalDevice("Null", &device);
+    if (!device)
+    {
+        LOG("Failed to create the device\n");
+        return -1;
+    }
+
+    TestMipTailFallback(device);
+    TestBudget(device);
+    TestEvictionOrder(device);
+    TestPinned(device);
+
+    if (NumFailures)
+    {
+        LOG("{} checks failed\n", NumFailures);
+        return -1;
+    }
+
+    LOG("All checks passed\n");
+    return 0;
+}
+
+HK_NAMESPACE_END
+
+
+using ApplicationClass = Hk::CoreApplication;
+
+alignas(alignof(ApplicationClass)) static char AppData[sizeof(ApplicationClass)];
+
+int main(int argc, char* argv[])
+{
+    using namespace Hk;
+
+#if defined(HK_DEBUG) && defined(HK_COMPILER_MSVC)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+#ifdef HK_OS_WIN32
+    ArgumentPack args;
+#else
+    ArgumentPack args(argc, argv);
+#endif
+
+    ApplicationClass* app = new (AppData) ApplicationClass(args);
+    int exitCode = RunApplication();
+    app->~ApplicationClass();
+    return exitCode;
+}
@@ -0,0 +1,251 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <Hork/Core/CoreApplication.h>
+#include <Hork/Core/IO.h>
+#include <Hork/Core/Logger.h>
+#include <Hork/Core/Platform.h>
+#include <Hork/Core/HashFunc.h>
+#include <Hork/Core/AsyncJobManager.h>
+#include <Hork/VirtualTexture/VirtualTextureTools.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+constexpr int PageSizeLog2 = 7;
+constexpr int MaxLods = 11;
+
+int NumFailures = 0;
+
+void Check(bool condition, StringView description)
+{
+    if (!condition)
+    {
+        LOG("FAILED: {}\n", description);
+        ++NumFailures;
+    }
+}
+
+/// Procedural source image of a rectangle. The pixels depend only on the seed, so the hash is the seed itself.
+struct TestImage
+{
+    int         Width;
+    int         Height;
+    uint32_t    Seed;
+};
+
+uint8_t GetPixel(TestImage const* image, int x, int y, int channel, int numChannels)
+{
+    return uint8_t(HashTraits::Murmur3Hash32(uint32_t(x) | (uint32_t(y) << 16), image->Seed * numChannels + channel));
+}
+
+void FillTile(TestImage const* image, int numChannels, int tileX, int tileY, int tileWidth, int tileHeight, void* tileData)
+{
+    uint8_t* dst = (uint8_t*)tileData;
+    for (int y = 0; y < tileHeight; y++)
+    {
+        for (int x = 0; x < tileWidth; x++)
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+                *dst++ = GetPixel(image, tileX + x, tileY + y, channel, numChannels);
+        }
+    }
+}
+
+template <int NumChannels>
+void* LoadImage(void* rectUserData, int width, int height)
+{
+    void* imageData = Core::GetHeapAllocator<HEAP_TEMP>().Alloc(width * height * NumChannels);
+    FillTile((TestImage const*)rectUserData, NumChannels, 0, 0, width, height, imageData);
+    return imageData;
+}
+
+template <int NumChannels>
+bool LoadTile(void* rectUserData, int width, int height, int tileX, int tileY, int tileWidth, int tileHeight, void* tileData)
+{
+    FillTile((TestImage const*)rectUserData, NumChannels, tileX, tileY, tileWidth, tileHeight, tileData);
+    return true;
+}
+
+void FreeImage(void* imageData)
+{
+    Core::GetHeapAllocator<HEAP_TEMP>().Free(imageData);
+}
+
+uint64_t GetImageHash(void* rectUserData)
+{
+    return ((TestImage const*)rectUserData)->Seed;
+}
+
+struct VirtualTextureTest
+{
+    TestImage                               Images[3] = {{300, 200, 1}, {500, 500, 2}, {120, 700, 3}};
+    VirtualTextureLayerDesc                 Layers[2];
+
+    explicit VirtualTextureTest(bool loadTiles)
+    {
+        Layers[0] = {};
+        Layers[0].NumChannels = 4;
+        Layers[0].LoadLayerImage = LoadImage<4>;
+        Layers[0].FreeLayerImage = FreeImage;
+        Layers[0].LoadLayerTile = loadTiles ? LoadTile<4> : nullptr;
+        Layers[0].GetLayerImageHash = GetImageHash;
+
+        Layers[1] = {};
+        Layers[1].NumChannels = 1;
+        Layers[1].LoadLayerImage = LoadImage<1>;
+        Layers[1].FreeLayerImage = FreeImage;
+        Layers[1].LoadLayerTile = loadTiles ? LoadTile<1> : nullptr;
+        Layers[1].GetLayerImageHash = GetImageHash;
+    }
+
+    /// Builds the virtual texture to <directory>/Test.vt3 using <directory>/Temp for the intermediate pages
+    bool Build(StringView directory, AsyncJobList* jobList, bool incremental)
+    {
+        std::vector<RectangleBinPack::RectSize> textureRects(HK_ARRAY_SIZE(Images));
+        for (size_t i = 0; i < textureRects.size(); i++)
+        {
+            textureRects[i].width = Images[i].Width;
+            textureRects[i].height = Images[i].Height;
+            textureRects[i].userdata = &Images[i];
+        }
+
+        String outputFileName(HK_FORMAT("{}/Test", directory));
+        String tempDir(HK_FORMAT("{}/Temp", directory));
+
+        std::vector<RectangleBinBack_RectNode> binRects;
+        unsigned int binWidth, binHeight;
+        return VT_CreateVirtualTexture(Layers, HK_ARRAY_SIZE(Layers), outputFileName.CStr(), tempDir.CStr(), MaxLods, PageSizeLog2,
+                                       textureRects, binRects, binWidth, binHeight, 32768, jobList, incremental);
+    }
+};
+
+HeapBlob ReadVirtualTexture(StringView directory)
+{
+    File file = File::sOpenRead(HK_FORMAT("{}/Test.vt3", directory));
+    if (!file)
+        return {};
+    return file.AsBlob();
+}
+
+bool IsSameVirtualTexture(StringView directory, StringView otherDirectory)
+{
+    HeapBlob blob = ReadVirtualTexture(directory);
+    HeapBlob otherBlob = ReadVirtualTexture(otherDirectory);
+    return !blob.IsEmpty() && blob.Size() == otherBlob.Size() && !std::memcmp(blob.GetData(), otherBlob.GetData(), blob.Size());
+}
+
+void TestParallelBuild(AsyncJobList* jobList)
+{
+    LOG("Parallel build\n");
+
+    Check(VirtualTextureTest(false).Build("VirtualTextureTest/Serial", nullptr, false), "serial build");
+
+    Check(VirtualTextureTest(false).Build("VirtualTextureTest/Parallel", jobList, false), "parallel build");
+    Check(IsSameVirtualTexture("VirtualTextureTest/Serial", "VirtualTextureTest/Parallel"), "parallel build matches the serial build");
+
+    Check(VirtualTextureTest(true).Build("VirtualTextureTest/Tiles", jobList, false), "build from tiles");
+    Check(IsSameVirtualTexture("VirtualTextureTest/Serial", "VirtualTextureTest/Tiles"), "build from tiles matches the build from images");
+}
+
+void TestIncrementalBuild(AsyncJobList* jobList)
+{
+    LOG("Incremental build\n");
+
+    VirtualTextureTest test(true);
+
+    Check(test.Build("VirtualTextureTest/Incremental", jobList, true), "initial incremental build");
+    Check(IsSameVirtualTexture("VirtualTextureTest/Serial", "VirtualTextureTest/Incremental"), "initial incremental build matches the full build");
+
+    Check(test.Build("VirtualTextureTest/Incremental", jobList, true), "incremental build without changes");
+    Check(IsSameVirtualTexture("VirtualTextureTest/Serial", "VirtualTextureTest/Incremental"), "unchanged sources keep the file");
+
+    // Only the pages of the second rectangle and their coarser levels are rebuilt
+    test.Images[1].Seed = 4;
+    Check(test.Build("VirtualTextureTest/Incremental", jobList, true), "incremental build with a changed image");
+
+    VirtualTextureTest reference(false);
+    reference.Images[1].Seed = 4;
+    Check(reference.Build("VirtualTextureTest/Full", nullptr, false), "full rebuild");
+
+    Check(IsSameVirtualTexture("VirtualTextureTest/Full", "VirtualTextureTest/Incremental"), "incremental build matches the full rebuild");
+    Check(!IsSameVirtualTexture("VirtualTextureTest/Serial", "VirtualTextureTest/Incremental"), "changed image is written");
+}
+
+} // namespace
+
+int RunApplication()
+{
+    Core::SetEnableConsoleOutput(true);
+
+    AsyncJobManager jobManager(AsyncJobManager::MAX_WORKER_THREADS, 1);
+    AsyncJobList* jobList = jobManager.GetAsyncJobList(0);
+
+    TestParallelBuild(jobList);
+    TestIncrementalBuild(jobList);
+
+    if (NumFailures)
+    {
+        LOG("{} checks failed\n", NumFailures);
+        return -1;
+    }
+
+    LOG("All checks passed\n");
+    return 0;
+}
+
+HK_NAMESPACE_END
+
+
+using ApplicationClass = Hk::CoreApplication;
+
+alignas(alignof(ApplicationClass)) static char AppData[sizeof(ApplicationClass)];
+
+int main(int argc, char* argv[])
+{
+    using namespace Hk;
+
+#if defined(HK_DEBUG) && defined(HK_COMPILER_MSVC)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+#ifdef HK_OS_WIN32
+    ArgumentPack args;
+#else
+    ArgumentPack args(argc, argv);
+#endif
+
+    ApplicationClass* app = new (AppData) ApplicationClass(args);
+    int exitCode = RunApplication();
+    app->~ApplicationClass();
+    return exitCode;
+}
@@ -0,0 +1,348 @@
+/*
+
+Hork Engine Source Code
+
+MIT License
+
+Copyright (C) 2017-2025 Alexander Samusev.
+
+This file is part of the Hork Engine Source Code.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <Hork/Core/CoreApplication.h>
+#include <Hork/Core/Parse.h>
+#include <Hork/Core/Logger.h>
+#include <Hork/Core/Platform.h>
+#include <Hork/Core/Color.h>
+#include <Hork/Runtime/World/Prefab.h>
+#include <Hork/Runtime/World/WorldSnapshot.h>
+
+HK_NAMESPACE_BEGIN
+
+namespace
+{
+
+class ProjectileComponent : public Component
+{
+public:
+    static constexpr ComponentMode Mode = ComponentMode::Dynamic;
+
+    Float3 Velocity;
+    float  Damage = 0;
+    float  LifeSpan = 0;
+    int    Team = 0;
+
+    void   Read(IBinaryStreamReadInterface& stream)
+    {
+        stream.ReadObject(Velocity);
+        Damage = stream.ReadFloat();
+        LifeSpan = stream.ReadFloat();
+        Team = stream.ReadInt32();
+    }
+
+    void   Write(IBinaryStreamWriteInterface& stream) const
+    {
+        stream.WriteObject(Velocity);
+        stream.WriteFloat(Damage);
+        stream.WriteFloat(LifeSpan);
+        stream.WriteInt32(Team);
+    }
+};
+
+class TrailComponent : public Component
+{
+public:
+    static constexpr ComponentMode Mode = ComponentMode::Static;
+
+    Color4 TrailColor;
+    float  Width = 0;
+    int    MaxSegments = 0;
+
+    void   Read(IBinaryStreamReadInterface& stream)
+    {
+        stream.ReadFloats(TrailColor.ToPtr(), 4);
+        Width = stream.ReadFloat();
+        MaxSegments = stream.ReadInt32();
+    }
+
+    void   Write(IBinaryStreamWriteInterface& stream) const
+    {
+        stream.WriteFloats(TrailColor.ToPtr(), 4);
+        stream.WriteFloat(Width);
+        stream.WriteInt32(MaxSegments);
+    }
+};
+
+// Projectile with a trail and two child emitters
+void CreatePrefab(Prefab& prefab)
+{
+    GameObjectDesc desc;
+
+    desc.Name = StringID("Projectile");
+    desc.IsDynamic = true;
+    uint32_t root = prefab.AddObject(desc);
+
+    auto projectile = prefab.AddComponent<ProjectileComponent>(root);
+    projectile->Velocity = Float3(0, 0, -100);
+    projectile->Damage = 25;
+    projectile->LifeSpan = 5;
+    projectile->Team = 1;
+
+    for (int n = 0; n < 2; n++)
+    {
+        desc.Name = StringID("Emitter");
+        desc.Position = Float3(n ? 0.1f : -0.1f, 0, 0);
+        uint32_t emitter = prefab.AddObject(desc, root);
+
+        auto trail = prefab.AddComponent<TrailComponent>(emitter);
+        trail->TrailColor = Color4(1, 0.5f, 0);
+        trail->Width = 0.05f;
+        trail->MaxSegments = 32;
+    }
+}
+
+// Reference path: objects and components are created one by one
+void SpawnPerObject(World& world, ArrayView<Transform> transforms)
+{
+    for (Transform const& transform : transforms)
+    {
+        GameObjectDesc desc;
+        desc.Name = StringID("Projectile");
+        desc.Position = transform.Position;
+        desc.Rotation = transform.Rotation;
+        desc.Scale = transform.Scale;
+        desc.IsDynamic = true;
+
+        GameObject* root;
+        world.CreateObject(desc, root);
+
+        ProjectileComponent* projectile;
+        root->CreateComponent(projectile);
+        projectile->Velocity = Float3(0, 0, -100);
+        projectile->Damage = 25;
+        projectile->LifeSpan = 5;
+        projectile->Team = 1;
+
+        for (int n = 0; n < 2; n++)
+        {
+            desc = {};
+            desc.Name = StringID("Emitter");
+            desc.Parent = root->GetHandle();
+            desc.Position = Float3(n ? 0.1f : -0.1f, 0, 0);
+
+            GameObject* emitter;
+            world.CreateObject(desc, emitter);
+
+            TrailComponent* trail;
+            emitter->CreateComponent(trail);
+            trail->TrailColor = Color4(1, 0.5f, 0);
+            trail->Width = 0.05f;
+            trail->MaxSegments = 32;
+        }
+    }
+}
+
+} // namespace
+
+int RunApplication()
+{
+    Core::SetEnableConsoleOutput(true);
+
+    const char* help = R"(
+    -count <count>            -- Number of prefab instances per spawn. Default: 10000
+    -iterations <count>       -- Number of spawns per path. Default: 10
+    -snapshot <path>          -- Temporary world snapshot file. Default: WorldBenchmark.snapshot
+    -hierarchy <count>        -- Number of prefab instances for the transform update. Default: 40000
+    )";
+
+    auto& args = CoreApplication::sArgs();
+    int i;
+
+    if (args.Find("-h") != -1)
+    {
+        LOG(help);
+        return 0;
+    }
+
+    uint32_t count = 10000;
+    uint32_t iterations = 10;
+
+    i = args.Find("-count");
+    if (i != -1 && i + 1 < args.Count())
+        count = Math::Max(1u, Core::ParseUInt32(args.At(i + 1)));
+
+    i = args.Find("-iterations");
+    if (i != -1 && i + 1 < args.Count())
+        iterations = Math::Max(1u, Core::ParseUInt32(args.At(i + 1)));
+
+    uint32_t hierarchyCount = 40000;
+
+    i = args.Find("-hierarchy");
+    if (i != -1 && i + 1 < args.Count())
+        hierarchyCount = Math::Max(1u, Core::ParseUInt32(args.At(i + 1)));
+
+    StringView snapshotFile = "WorldBenchmark.snapshot";
+
+    i = args.Find("-snapshot");
+    if (i != -1 && i + 1 < args.Count())
+        snapshotFile = args.At(i + 1);
+
+    Prefab prefab;
+    CreatePrefab(prefab);
+
+    Vector<Transform> transforms(count);
+    for (uint32_t n = 0; n < count; n++)
+        transforms[n].Position = Float3(float(n % 100), 1.0f, float(n / 100));
+
+    LOG("Spawning {} instances ({} objects, {} components) x {} iterations\n", count, count * prefab.GetObjectCount(), count * prefab.GetComponentCount(), iterations);
+
+    WorldSnapshot snapshot;
+    snapshot.RegisterComponent<ProjectileComponent>("ProjectileComponent");
+    snapshot.RegisterComponent<TrailComponent>("TrailComponent");
+
+    {
+        World world;
+        world.CreateObjects(prefab, transforms);
+        if (!snapshot.Save(world, snapshotFile))
+            return -1;
+    }
+
+    enum class SpawnPath
+    {
+        PerObject,
+        Batch,
+        Snapshot
+    };
+
+    auto run = [&](const char* name, SpawnPath path)
+    {
+        double totalTime = 0;
+
+        // Spawn into a fresh world every iteration, so neither path benefits from storage left by the previous one
+        for (uint32_t n = 0; n < iterations; n++)
+        {
+            World world;
+
+            double startTime = Core::SysMicroseconds_d();
+            switch (path)
+            {
+            case SpawnPath::PerObject:
+                SpawnPerObject(world, transforms);
+                break;
+            case SpawnPath::Batch:
+                world.CreateObjects(prefab, transforms);
+                break;
+            case SpawnPath::Snapshot:
+                if (!snapshot.Load(world, snapshotFile))
+                {
+                    LOG("Failed to load snapshot {}\n", snapshotFile);
+                    return -1.0;
+                }
+                break;
+            }
+            totalTime += Core::SysMicroseconds_d() - startTime;
+        }
+
+        double averageTime = totalTime / iterations;
+        LOG("{}: {:.2f} ms, {:.0f} instances/s\n", name, averageTime / 1000.0, count / (averageTime / 1000000.0));
+        return averageTime;
+    };
+
+    double perObjectTime = run("Per object", SpawnPath::PerObject);
+    double batchTime = run("Prefab batch", SpawnPath::Batch);
+    double snapshotTime = run("Mapped snapshot", SpawnPath::Snapshot);
+    if (snapshotTime < 0)
+    {
+        Core::RemoveFile(snapshotFile);
+        return -1;
+    }
+
+    LOG("Batch speedup: {:.2f}x\n", perObjectTime / batchTime);
+    LOG("Snapshot speedup: {:.2f}x\n", perObjectTime / snapshotTime);
+
+    Core::RemoveFile(snapshotFile);
+
+    // Transform hierarchy update. Roots are moved every frame, so their children have to follow.
+    {
+        Vector<Transform> hierarchyTransforms(hierarchyCount);
+        for (uint32_t n = 0; n < hierarchyCount; n++)
+            hierarchyTransforms[n].Position = Float3(float(n % 200), 1.0f, float(n / 200));
+
+        World world;
+        Vector<GameObjectHandle> roots;
+        world.CreateObjects(prefab, hierarchyTransforms, {}, &roots);
+
+        LOG("Updating transforms of {} objects x {} iterations\n", hierarchyCount * prefab.GetObjectCount(), iterations);
+
+        auto update = [&](const char* name, uint32_t moveStride)
+        {
+            double totalTime = 0;
+
+            for (uint32_t n = 0; n < iterations; n++)
+            {
+                for (uint32_t r = 0; r < roots.Size(); r += moveStride)
+                    world.GetObject(roots[r])->Move(Float3(0, 0, 0.01f));
+
+                // One fixed step per tick
+                double startTime = Core::SysMicroseconds_d();
+                world.Tick(1.0f / 60.0f);
+                totalTime += Core::SysMicroseconds_d() - startTime;
+            }
+
+            double averageTime = totalTime / iterations;
+            LOG("{}: {:.2f} ms\n", name, averageTime / 1000.0);
+        };
+
+        update("All moved", 1);
+        update("1% moved", 100);
+        update("One moved", roots.Size());
+    }
+
+    return 0;
+}
+
+HK_NAMESPACE_END
+
+
+using ApplicationClass = Hk::CoreApplication;
+
+alignas(alignof(ApplicationClass)) static char AppData[sizeof(ApplicationClass)];
+
+int main(int argc, char* argv[])
+{
+    using namespace Hk;
+
+#if defined(HK_DEBUG) && defined(HK_COMPILER_MSVC)
+    _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+#endif
+
+#ifdef HK_OS_WIN32
+    ArgumentPack args;
+#else
+    ArgumentPack args(argc, argv);
+#endif
+
+    ApplicationClass* app = new (AppData) ApplicationClass(args);
+    int exitCode = RunApplication();
+    app->~ApplicationClass();
+    return exitCode;
+}